@@ -0,0 +1,399 @@
+//! # Access Profile
+//!
+//! Records every hierarchical path a run resolves through
+//! `complex_handle_by_name` (which is where `dut.<path>`, `CallableHDL`,
+//! `Bundle` and `AliasBundle` end up). The profile is the input of
+//! `tools/vl-gen-vlt`, which turns it into a Verilator control file with one
+//! `public_flat_rw` line per accessed signal. With that file the model can be
+//! built by `vl-verilator-p` without `--public-flat-rw`, which keeps every
+//! other signal open to Verilator's optimizations.
+//!
+//! Recording is enabled with `VL_ACCESS_PROFILE=<file>`. The file is written
+//! when the simulation finishes and is merged with what it already holds, so
+//! several tests can share one profile.
+//!
+//! ## File format
+//!
+//! ```text
+//!   # comment
+//!   tb_top.u_core.valid<TAB>Core     resolved path, <TAB> + defining module of its scope if known
+//!   tb_top.u_core.ready              resolved path, module unknown
+//!   ?tb_top.u_core.debug_bus         requested but not found
+//! ```
+//!
+//! Lines may also be added by hand (or by `SignalDB:record_access_profile`),
+//! a path without `?` is always treated as a signal to make public.
+
+use libc::c_char;
+use std::cell::UnsafeCell;
+use std::collections::BTreeMap;
+use std::ffi::CString;
+use std::path::{Path, PathBuf};
+
+use crate::utils;
+use crate::vpi_user::*;
+
+/// Name of the control file `vl-verilator-p --access-profile` writes next to
+/// the model executable.
+const GENERATED_VLT: &str = "verilua_access_profile.vlt";
+
+/// Header line of the generated control file naming the profile it came from.
+const GENERATED_VLT_PROFILE_TAG: &str = "// profile: ";
+
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct AccessEntry {
+    pub resolved: bool,
+    pub module: Option<String>,
+}
+
+impl AccessEntry {
+    /// A resolved entry wins over an unresolved one, a known module over an unknown one.
+    fn merge(&mut self, other: AccessEntry) {
+        self.resolved |= other.resolved;
+        if self.module.is_none() {
+            self.module = other.module;
+        }
+    }
+}
+
+#[derive(Debug, Default)]
+pub struct AccessProfile {
+    file: PathBuf,
+    entries: BTreeMap<String, AccessEntry>,
+}
+
+impl AccessProfile {
+    pub fn new(file: impl Into<PathBuf>) -> Self {
+        Self {
+            file: file.into(),
+            entries: BTreeMap::new(),
+        }
+    }
+
+    fn from_env() -> Option<Self> {
+        match std::env::var("VL_ACCESS_PROFILE") {
+            Ok(file) if !file.is_empty() => {
+                log::info!("[access_profile] recording accessed signals into `{file}`");
+                Some(Self::new(file))
+            }
+            _ => None,
+        }
+    }
+
+    pub fn record(&mut self, path: &str, entry: AccessEntry) {
+        match self.entries.get_mut(path) {
+            Some(e) => e.merge(entry),
+            None => {
+                self.entries.insert(path.to_owned(), entry);
+            }
+        }
+    }
+
+    pub fn parse(content: &str) -> BTreeMap<String, AccessEntry> {
+        let mut entries: BTreeMap<String, AccessEntry> = BTreeMap::new();
+        for line in content.lines() {
+            let line = line.trim();
+            if line.is_empty() || line.starts_with('#') {
+                continue;
+            }
+
+            let (path, resolved) = match line.strip_prefix('?') {
+                Some(path) => (path, false),
+                None => (line, true),
+            };
+            let (path, module) = match path.split_once('\t') {
+                Some((path, module)) if !module.trim().is_empty() => {
+                    (path, Some(module.trim().to_owned()))
+                }
+                Some((path, _)) => (path, None),
+                None => (path, None),
+            };
+
+            let entry = AccessEntry { resolved, module };
+            match entries.get_mut(path.trim()) {
+                Some(e) => e.merge(entry),
+                None => {
+                    entries.insert(path.trim().to_owned(), entry);
+                }
+            }
+        }
+        entries
+    }
+
+    pub fn render(&self) -> String {
+        let mut out = String::from(
+            "# verilua access profile (VL_ACCESS_PROFILE), see `vl-gen-vlt --help`\n\
+             # <path>[<TAB><module>], `?` marks paths that were requested but not found\n",
+        );
+        for (path, entry) in &self.entries {
+            if !entry.resolved {
+                out.push('?');
+            }
+            out.push_str(path);
+            if let Some(module) = &entry.module {
+                out.push('\t');
+                out.push_str(module);
+            }
+            out.push('\n');
+        }
+        out
+    }
+
+    /// Merge with the profile already on disk and write it back.
+    pub fn write(&mut self) -> std::io::Result<()> {
+        if let Ok(content) = std::fs::read_to_string(&self.file) {
+            for (path, entry) in Self::parse(&content) {
+                self.record(&path, entry);
+            }
+        }
+
+        // Write to a temporary file first so that a concurrent reader never sees a partial profile
+        let tmp = self
+            .file
+            .with_extension(format!("tmp.{}", std::process::id()));
+        std::fs::write(&tmp, self.render())?;
+        std::fs::rename(&tmp, &self.file)
+    }
+}
+
+thread_local! {
+    static ACCESS_PROFILE: UnsafeCell<Option<AccessProfile>> = UnsafeCell::new(AccessProfile::from_env());
+    static HINT_BUF: UnsafeCell<CString> = UnsafeCell::new(CString::default());
+}
+
+#[inline(always)]
+pub fn enabled() -> bool {
+    ACCESS_PROFILE.with(|p| unsafe { (*p.get()).is_some() })
+}
+
+fn with_profile(f: impl FnOnce(&mut AccessProfile)) {
+    ACCESS_PROFILE.with(|p| {
+        if let Some(profile) = unsafe { &mut *p.get() } {
+            f(profile)
+        }
+    });
+}
+
+/// Defining module of the scope `handle` lives in, if the simulator reports it.
+fn scope_def_name(handle: vpiHandle) -> Option<String> {
+    unsafe {
+        let mut scope = vpi_handle(vpiScope as _, handle);
+        if scope.is_null() {
+            scope = vpi_handle(vpiModule as _, handle);
+        }
+        if scope.is_null() {
+            return None;
+        }
+
+        // Copy the name out before releasing the scope handle, the string may live in it
+        let def_name = vpi_get_str(vpiDefName as _, scope);
+        let def_name = (!def_name.is_null()).then(|| utils::c_char_to_string(def_name));
+        vpi_release_handle(scope);
+        def_name.filter(|name| !name.is_empty())
+    }
+}
+
+/// Record the result of resolving `path`, `handle` is null if it was not found.
+pub fn record_handle(path: &str, handle: vpiHandle) {
+    let entry = if handle.is_null() {
+        AccessEntry::default()
+    } else {
+        AccessEntry {
+            resolved: true,
+            module: scope_def_name(handle),
+        }
+    };
+    with_profile(|profile| profile.record(path, entry));
+}
+
+/// Write the profile, called once from `VeriluaEnv::finalize`.
+pub fn flush() {
+    with_profile(|profile| match profile.write() {
+        Ok(()) => log::info!(
+            "[access_profile] wrote {} paths to `{}`",
+            profile.entries.len(),
+            profile.file.display()
+        ),
+        Err(e) => log::error!(
+            "[access_profile] failed to write `{}`: {e}",
+            profile.file.display()
+        ),
+    });
+}
+
+/// Profile named by the control file `vl-verilator-p --access-profile`
+/// generated in `model_dir` (the directory of the model executable).
+fn generated_vlt_profile(model_dir: &Path) -> Option<(PathBuf, String)> {
+    let vlt = model_dir.join(GENERATED_VLT);
+    let content = std::fs::read_to_string(&vlt).ok()?;
+    let profile = content
+        .lines()
+        .find_map(|l| l.strip_prefix(GENERATED_VLT_PROFILE_TAG))?;
+    Some((vlt, profile.trim().to_owned()))
+}
+
+fn generated_vlt_hint(path: &str, vlt: &Path, profile: &str) -> String {
+    format!(
+        "`{path}` may not be public: this model was built with `{}` generated from the access profile `{profile}`. \
+         Add the path to the profile (append a line `{path}`, or rerun with VL_ACCESS_PROFILE={profile} on a \
+         `--public-flat-rw` build) and rebuild with `vl-verilator-p --access-profile {profile}`.",
+        vlt.display()
+    )
+}
+
+/// Explanation appended to "no handle found" errors, empty if the model was
+/// not built from an access profile and no profile is being recorded.
+pub fn unknown_signal_hint(path: &str) -> String {
+    let recording =
+        ACCESS_PROFILE.with(|p| unsafe { (*p.get()).as_ref().map(|profile| profile.file.clone()) });
+
+    let model_dir = std::env::current_exe()
+        .ok()
+        .and_then(|exe| exe.parent().map(Path::to_path_buf));
+
+    if let Some((vlt, profile)) = model_dir.and_then(|dir| generated_vlt_profile(&dir)) {
+        generated_vlt_hint(path, &vlt, &profile)
+    } else if let Some(file) = recording {
+        format!(
+            "`{path}` is recorded as not found (`?{path}`) in the access profile `{}`.",
+            file.display()
+        )
+    } else {
+        String::new()
+    }
+}
+
+/// Add `path` to the profile as a signal to make public (e.g. a `SignalDB`
+/// query result the run itself never touched). No-op when not recording.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_access_profile_add(path: *const c_char) {
+    let path = unsafe { utils::c_char_to_str(path) };
+    with_profile(|profile| {
+        profile.record(
+            path,
+            AccessEntry {
+                resolved: true,
+                module: None,
+            },
+        )
+    });
+}
+
+/// See [`unknown_signal_hint`]. The returned string is valid until the next call.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_access_profile_hint(path: *const c_char) -> *const c_char {
+    let hint = unknown_signal_hint(unsafe { utils::c_char_to_str(path) });
+    HINT_BUF.with(|buf| unsafe {
+        *buf.get() = CString::new(hint).unwrap_or_default();
+        (*buf.get()).as_ptr()
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn resolved(module: Option<&str>) -> AccessEntry {
+        AccessEntry {
+            resolved: true,
+            module: module.map(str::to_owned),
+        }
+    }
+
+    #[test]
+    fn test_access_profile_record_merges_entries() {
+        let mut profile = AccessProfile::new("unused");
+        profile.record("tb_top.u_core.debug", AccessEntry::default());
+        profile.record("tb_top.u_core.valid", resolved(None));
+        profile.record("tb_top.u_core.valid", resolved(Some("Core")));
+        profile.record("tb_top.u_core.valid", AccessEntry::default());
+
+        assert_eq!(
+            profile.entries["tb_top.u_core.valid"],
+            resolved(Some("Core"))
+        );
+        assert!(!profile.entries["tb_top.u_core.debug"].resolved);
+
+        profile.record("tb_top.u_core.debug", resolved(None));
+        assert!(profile.entries["tb_top.u_core.debug"].resolved);
+    }
+
+    #[test]
+    fn test_access_profile_render_parse_roundtrip() {
+        let mut profile = AccessProfile::new("unused");
+        profile.record("tb_top.clock", resolved(Some("tb_top")));
+        profile.record("tb_top.u_core.mem[3]", resolved(None));
+        profile.record("tb_top.u_core.missing", AccessEntry::default());
+
+        let text = profile.render();
+        assert!(text.contains("tb_top.clock\ttb_top\n"));
+        assert!(text.contains("?tb_top.u_core.missing\n"));
+        assert_eq!(AccessProfile::parse(&text), profile.entries);
+
+        // Hand-written lines: blanks, comments, trailing spaces, duplicates
+        let parsed =
+            AccessProfile::parse("# c\n\n  tb_top.a  \n?tb_top.b\ntb_top.b\tTop\n?tb_top.a\n");
+        assert_eq!(parsed.len(), 2);
+        assert_eq!(parsed["tb_top.a"], resolved(None));
+        assert_eq!(parsed["tb_top.b"], resolved(Some("Top")));
+    }
+
+    #[test]
+    fn test_access_profile_write_merges_with_file() {
+        let file = std::env::temp_dir().join(format!(
+            "verilua_access_profile_test_{}.txt",
+            std::process::id()
+        ));
+        std::fs::write(&file, "tb_top.a\tTop\n?tb_top.b\n").unwrap();
+
+        let mut profile = AccessProfile::new(&file);
+        profile.record("tb_top.b", resolved(None));
+        profile.record("tb_top.c", AccessEntry::default());
+        profile.write().unwrap();
+
+        let parsed = AccessProfile::parse(&std::fs::read_to_string(&file).unwrap());
+        std::fs::remove_file(&file).unwrap();
+        assert_eq!(parsed["tb_top.a"], resolved(Some("Top")));
+        assert_eq!(parsed["tb_top.b"], resolved(None));
+        assert!(!parsed["tb_top.c"].resolved);
+    }
+
+    #[test]
+    fn test_generated_vlt_hint_names_the_profile() {
+        // Control file written by tools/vl-gen-vlt, as `vl-verilator-p --access-profile` does
+        let dir =
+            std::env::temp_dir().join(format!("verilua_access_profile_vlt_{}", std::process::id()));
+        std::fs::create_dir_all(&dir).unwrap();
+        let profile = dir.join("access.prof");
+        std::fs::write(&profile, "tb_top.u_core.valid\tCore\n").unwrap();
+
+        let gen_vlt = Path::new(env!("CARGO_MANIFEST_DIR")).join("../tools/vl-gen-vlt");
+        let Ok(status) = std::process::Command::new("python3")
+            .arg(&gen_vlt)
+            .arg(&profile)
+            .arg("-o")
+            .arg(dir.join(GENERATED_VLT))
+            .stdout(std::process::Stdio::null())
+            .status()
+        else {
+            std::fs::remove_dir_all(&dir).unwrap();
+            eprintln!("python3 is not available, skipped");
+            return;
+        };
+        assert!(status.success());
+
+        let (vlt, named) = generated_vlt_profile(&dir).unwrap();
+        assert_eq!(vlt, dir.join(GENERATED_VLT));
+        assert_eq!(Path::new(&named), profile);
+
+        let hint = generated_vlt_hint("tb_top.u_core.ready", &vlt, &named);
+        assert!(hint.starts_with("`tb_top.u_core.ready` may not be public"));
+        assert!(hint.contains(&format!(
+            "rebuild with `vl-verilator-p --access-profile {}`",
+            profile.display()
+        )));
+
+        std::fs::remove_dir_all(&dir).unwrap();
+        assert!(generated_vlt_profile(&dir).is_none());
+    }
+}
@@ -26,6 +26,8 @@
 use hashbrown::HashMap;
 use std::fmt::{self, Debug};
 
+use crate::direct_access::DirectSignal;
+use crate::edge_waiter::EdgeWaiterList;
 use crate::utils;
 use crate::verilua_env::VeriluaEnv;
 use crate::vpi_user::*;
@@ -36,9 +38,9 @@ use crate::TaskID;
 /// Raw handle type for FFI boundary - a pointer cast to i64 for Lua compatibility
 pub type ComplexHandleRaw = libc::c_longlong;
 
-/// Maximum number of 32-bit words supported for vector values.
-/// Signals wider than 32 * MAX_VECTOR_SIZE bits will cause a panic.
-const MAX_VECTOR_SIZE: usize = 32;
+/// Number of 32-bit words of `put_value_vectors` kept inline, covers signals
+/// up to 64 bits. Wider signals get a heap buffer sized to their `beat_num`.
+const INLINE_VECTOR_SIZE: usize = 2;
 
 /// Container for pre-shuffled random values.
 ///
@@ -116,16 +118,26 @@ pub struct ComplexHandle {
     /// Integer value for single-beat signals
     pub put_value_integer: u32,
 
-    /// String value for string-format writes
-    pub put_value_str: String,
+    /// NUL-terminated string for string-format writes that cannot be decoded
+    /// into `put_value_vectors` (e.g. `x` / `z` digits), reused across puts
+    pub put_value_str: Vec<u8>,
 
     /// Reusable buffer for string-format reads to avoid per-call CString allocation.
     /// `ComplexHandle::new()` reserves 128 bytes as a heuristic for the common short
     /// string case while still allowing wider values to grow the buffer on demand.
     pub get_value_str_buf: Vec<u8>,
 
-    /// Vector value buffer using SmallVec to avoid heap for common cases
-    pub put_value_vectors: smallvec::SmallVec<[t_vpi_vecval; MAX_VECTOR_SIZE]>,
+    /// Vector value buffer, `max(beat_num, 2)` words (64-bit setters always
+    /// write two words). Also holds decoded string-format writes.
+    pub put_value_vectors: smallvec::SmallVec<[t_vpi_vecval; INLINE_VECTOR_SIZE]>,
+
+    /// Raw Verilator storage of the signal, if registered (see `direct_access`).
+    /// When set, plain reads and `vpiNoDelay` writes bypass VerilatedVpi.
+    pub direct: Option<DirectSignal>,
+
+    /// Persistent waiter lists indexed by `EdgeType` (feature = "edge_waiter"),
+    /// null until the signal is first awaited with that edge type
+    pub edge_waiters: [*mut EdgeWaiterList; 3],
 
     // ──────────────────────────────────────────────────────────────────────
     // Callback Merge Tracking (feature = "merge_cb")
@@ -152,14 +164,7 @@ pub struct ComplexHandle {
 impl ComplexHandle {
     pub fn new(vpi_handle: vpiHandle, name: *mut libc::c_char, width: usize) -> Self {
         let beat_num = (width as f64 / 32.0).ceil() as usize;
-
-        assert!(
-            beat_num <= MAX_VECTOR_SIZE,
-            "beat_num is too large: {}, width: {}, name: {}",
-            beat_num,
-            width,
-            utils::c_char_to_string(name)
-        );
+        let vector_size = beat_num.max(INLINE_VECTOR_SIZE);
 
         #[cfg(feature = "merge_cb")]
         {
@@ -172,12 +177,14 @@ impl ComplexHandle {
                 put_value_format: 0,
                 put_value_flag: None,
                 put_value_integer: 0,
-                put_value_str: String::new(),
+                put_value_str: Vec::new(),
                 get_value_str_buf: Vec::with_capacity(128),
                 put_value_vectors: smallvec::smallvec![t_vpi_vecval {
                     aval: 0,
                     bval: 0,
-                }; MAX_VECTOR_SIZE],
+                }; vector_size],
+                direct: None,
+                edge_waiters: [std::ptr::null_mut(); 3],
                 posedge_cb_count: HashMap::new(),
                 negedge_cb_count: HashMap::new(),
                 edge_cb_count: HashMap::new(),
@@ -208,12 +215,14 @@ impl ComplexHandle {
                 put_value_format: 0,
                 put_value_flag: None,
                 put_value_integer: 0,
-                put_value_str: String::new(),
+                put_value_str: Vec::new(),
                 get_value_str_buf: Vec::with_capacity(128),
                 put_value_vectors: smallvec::smallvec![t_vpi_vecval {
                     aval: 0,
                     bval: 0,
-                }; MAX_VECTOR_SIZE],
+                }; vector_size],
+                direct: None,
+                edge_waiters: [std::ptr::null_mut(); 3],
                 random_value_vec_type: ShuffledValueVecType::None,
                 random_value_u32_vec: ShuffledValueVec {
                     vec: Vec::new(),
@@ -246,6 +255,42 @@ impl ComplexHandle {
         utils::c_char_to_string(self.name)
     }
 
+    /// Apply `v` to the signal now: a direct store when the handle has
+    /// Verilator storage attached, `vpi_put_value` otherwise.
+    #[inline(always)]
+    pub fn put_value_now(&mut self, v: &mut s_vpi_value, flag: u32) {
+        if cfg!(feature = "verilator") && self.try_put_value_direct(v, flag) {
+            return;
+        }
+        unsafe {
+            vpi_put_value(
+                self.vpi_handle,
+                v as *mut _,
+                std::ptr::null_mut(),
+                flag as _,
+            )
+        };
+    }
+
+    /// Stage a string-format put (`s` without `0x` / `0b` prefix). Plain
+    /// 2-state numbers are decoded into `put_value_vectors` right away and
+    /// flushed as `vpiVectorVal`; anything else is kept as a string in `format`.
+    #[inline(always)]
+    pub fn set_put_value_str(&mut self, format: u32, s: &[u8]) {
+        if utils::str_to_vec::decode_str_to_vecval(
+            format,
+            s,
+            &mut self.put_value_vectors[..self.beat_num],
+        ) {
+            self.put_value_format = vpiVectorVal;
+        } else {
+            self.put_value_format = format;
+            self.put_value_str.clear();
+            self.put_value_str.extend_from_slice(s);
+            self.put_value_str.push(0);
+        }
+    }
+
     #[inline(always)]
     pub fn try_put_value(&mut self, env: &mut VeriluaEnv, flag: &u32, format: &u32) -> bool {
         match self.put_value_flag {
@@ -0,0 +1,795 @@
+//! # Asynchronous Database Writer (`LuaDataBaseV2` async mode)
+//!
+//! In its default mode `LuaDataBaseV2:commit()` binds and steps every cached
+//! row on the simulation thread. With `async = true` the rows are instead
+//! written into preallocated batch buffers and handed to a worker thread that
+//! owns the database connection from then on:
+//!
+//! ```text
+//!   simulation thread                          worker thread
+//!   ┌───────────────────────────┐  pending   ┌──────────────────────────────┐
+//!   │ save(v1, v2, ...)         │ ─────────> │ bind + step every row with   │
+//!   │  -> store row in batch    │  batches   │ one prepared statement,      │
+//!   │ batch full / commit()     │            │ COMMIT every `txn_rows` rows │
+//!   │  -> submit, acquire next  │ <───────── │ (duckdb: appender + flush)   │
+//!   └───────────────────────────┘    free    └──────────────────────────────┘
+//! ```
+//!
+//! Memory is bounded by `batch_num` batches. When all of them are pending the
+//! producer blocks in `acquire` until the worker returns one (backpressure),
+//! so no row is ever dropped.
+//!
+//! The writer does not link against any database library: the Lua side passes
+//! the function pointers of the backend it already loaded (`libsqlite3`,
+//! `libturso_ffi` or `libduckdb`), see `DbApi`.
+//!
+//! ## Batch layout
+//!
+//! `values` holds `row_cap * col_num` `i64` slots, row major. An INTEGER column
+//! stores its value, a TEXT column the byte offset of its string in `text`:
+//!
+//! ```text
+//!   text := (len:u32 bytes NUL pad_to_4)*
+//! ```
+
+use libc::{c_char, c_int, c_void};
+use std::collections::VecDeque;
+use std::ffi::{CStr, CString};
+use std::sync::{Arc, Condvar, Mutex};
+use std::thread::JoinHandle;
+
+const SQLITE_OK: c_int = 0;
+const SQLITE_DONE: c_int = 101;
+const DUCKDB_SUCCESS: c_int = 0;
+
+const COL_INTEGER: u8 = 0;
+const COL_TEXT: u8 = 1;
+
+/// Backend ids, must match `ASYNC_BACKENDS` in LuaDataBaseV2.lua
+const BACKEND_SQLITE3: u32 = 0;
+const BACKEND_TURSO: u32 = 1;
+const BACKEND_DUCKDB: u32 = 2;
+
+type StmtFn = unsafe extern "C" fn(*mut c_void) -> c_int;
+type BindInt64Fn = unsafe extern "C" fn(*mut c_void, c_int, i64) -> c_int;
+type ErrmsgFn = unsafe extern "C" fn(*mut c_void) -> *const c_char;
+type AppendInt64Fn = unsafe extern "C" fn(*mut c_void, i64) -> c_int;
+
+/// Function pointers of the backend, passed in this order by the Lua side.
+#[derive(Clone, Copy)]
+enum DbApi {
+    /// `sqlite3_exec`, `sqlite3_prepare_v2`, `sqlite3_bind_int64`,
+    /// `sqlite3_bind_text`, `sqlite3_step`, `sqlite3_reset`, `sqlite3_finalize`,
+    /// `sqlite3_errmsg`
+    Sqlite3 {
+        exec: unsafe extern "C" fn(
+            *mut c_void,
+            *const c_char,
+            *mut c_void,
+            *mut c_void,
+            *mut *mut c_char,
+        ) -> c_int,
+        prepare: unsafe extern "C" fn(
+            *mut c_void,
+            *const c_char,
+            c_int,
+            *mut *mut c_void,
+            *mut *const c_char,
+        ) -> c_int,
+        bind_int64: BindInt64Fn,
+        bind_text:
+            unsafe extern "C" fn(*mut c_void, c_int, *const c_char, c_int, *mut c_void) -> c_int,
+        step: StmtFn,
+        reset: StmtFn,
+        finalize: StmtFn,
+        errmsg: ErrmsgFn,
+    },
+    /// `turso_ffi_exec`, `turso_ffi_prepare`, `turso_ffi_bind_int`,
+    /// `turso_ffi_bind_text`, `turso_ffi_step`, `turso_ffi_reset`,
+    /// `turso_ffi_finalize`, `turso_ffi_errmsg`
+    Turso {
+        exec: unsafe extern "C" fn(*mut c_void, *const c_char) -> c_int,
+        prepare: unsafe extern "C" fn(*mut c_void, *const c_char, *mut *mut c_void) -> c_int,
+        bind_int64: BindInt64Fn,
+        bind_text: unsafe extern "C" fn(*mut c_void, c_int, *const c_char, c_int) -> c_int,
+        step: StmtFn,
+        reset: StmtFn,
+        finalize: StmtFn,
+        errmsg: ErrmsgFn,
+    },
+    /// `duckdb_append_int64`, `duckdb_append_varchar`,
+    /// `duckdb_appender_end_row`, `duckdb_appender_flush`
+    DuckDb {
+        append_int64: AppendInt64Fn,
+        append_varchar: unsafe extern "C" fn(*mut c_void, *const c_char) -> c_int,
+        end_row: StmtFn,
+        flush: StmtFn,
+    },
+}
+
+impl DbApi {
+    const fn func_num(backend: u32) -> usize {
+        match backend {
+            BACKEND_SQLITE3 | BACKEND_TURSO => 8,
+            BACKEND_DUCKDB => 4,
+            _ => 0,
+        }
+    }
+
+    /// # Safety
+    /// `funcs` must hold `func_num(backend)` functions with the signatures
+    /// listed on the variants.
+    unsafe fn from_funcs(backend: u32, funcs: &[*const c_void]) -> Option<Self> {
+        if funcs.len() != Self::func_num(backend) || funcs.iter().any(|f| f.is_null()) {
+            return None;
+        }
+        unsafe {
+            use std::mem::transmute as t;
+            match backend {
+                BACKEND_SQLITE3 => Some(Self::Sqlite3 {
+                    exec: t(funcs[0]),
+                    prepare: t(funcs[1]),
+                    bind_int64: t(funcs[2]),
+                    bind_text: t(funcs[3]),
+                    step: t(funcs[4]),
+                    reset: t(funcs[5]),
+                    finalize: t(funcs[6]),
+                    errmsg: t(funcs[7]),
+                }),
+                BACKEND_TURSO => Some(Self::Turso {
+                    exec: t(funcs[0]),
+                    prepare: t(funcs[1]),
+                    bind_int64: t(funcs[2]),
+                    bind_text: t(funcs[3]),
+                    step: t(funcs[4]),
+                    reset: t(funcs[5]),
+                    finalize: t(funcs[6]),
+                    errmsg: t(funcs[7]),
+                }),
+                BACKEND_DUCKDB => Some(Self::DuckDb {
+                    append_int64: t(funcs[0]),
+                    append_varchar: t(funcs[1]),
+                    end_row: t(funcs[2]),
+                    flush: t(funcs[3]),
+                }),
+                _ => None,
+            }
+        }
+    }
+}
+
+/// Batch header shared with Lua (`verilua_db_batch`).
+#[repr(C)]
+pub struct DbBatch {
+    values: *mut i64,
+    text: *mut u8,
+    row_num: u32,
+    text_len: u32,
+    row_cap: u32,
+    text_cap: u32,
+}
+
+/// Owns the storage the `DbBatch` header points to.
+struct BatchStorage {
+    header: Box<DbBatch>,
+    _values: Box<[i64]>,
+    _text: Box<[u8]>,
+}
+
+impl BatchStorage {
+    fn new(row_cap: u32, col_num: u32, text_cap: u32) -> Self {
+        let mut values = vec![0i64; row_cap as usize * col_num as usize].into_boxed_slice();
+        let mut text = vec![0u8; text_cap as usize].into_boxed_slice();
+        let header = Box::new(DbBatch {
+            values: values.as_mut_ptr(),
+            text: text.as_mut_ptr(),
+            row_num: 0,
+            text_len: 0,
+            row_cap,
+            text_cap,
+        });
+        Self {
+            header,
+            _values: values,
+            _text: text,
+        }
+    }
+}
+
+/// Raw pointer handed between threads. Ownership of the pointee follows the
+/// `free` / `pending` queues, only one side touches a batch at a time.
+#[derive(Clone, Copy, PartialEq, Eq)]
+struct BatchPtr(*mut DbBatch);
+unsafe impl Send for BatchPtr {}
+
+#[derive(Default)]
+struct Queues {
+    free: Vec<BatchPtr>,
+    pending: VecDeque<BatchPtr>,
+    closing: bool,
+    /// First error of the worker, later batches are discarded
+    error: Option<String>,
+}
+
+struct Shared {
+    queues: Mutex<Queues>,
+    free_cv: Condvar,
+    pending_cv: Condvar,
+}
+
+/// Everything the worker thread owns: the connection (or appender) and the
+/// prepared insert statement.
+struct Sink {
+    api: DbApi,
+    conn: *mut c_void,
+    stmt: *mut c_void,
+    col_types: Vec<u8>,
+    txn_rows: u64,
+    rows_in_txn: u64,
+    in_txn: bool,
+    rows: u64,
+}
+
+unsafe impl Send for Sink {}
+
+impl Sink {
+    fn errmsg(&self) -> String {
+        let msg = match self.api {
+            DbApi::Sqlite3 { errmsg, .. } | DbApi::Turso { errmsg, .. } => unsafe {
+                errmsg(self.conn)
+            },
+            DbApi::DuckDb { .. } => return "duckdb appender error".to_string(),
+        };
+        if msg.is_null() {
+            return "unknown error".to_string();
+        }
+        unsafe { CStr::from_ptr(msg) }
+            .to_string_lossy()
+            .into_owned()
+    }
+
+    fn exec(&self, sql: &CStr) -> Result<(), String> {
+        let code = match self.api {
+            DbApi::Sqlite3 { exec, .. } => unsafe {
+                exec(
+                    self.conn,
+                    sql.as_ptr(),
+                    std::ptr::null_mut(),
+                    std::ptr::null_mut(),
+                    std::ptr::null_mut(),
+                )
+            },
+            DbApi::Turso { exec, .. } => unsafe { exec(self.conn, sql.as_ptr()) },
+            DbApi::DuckDb { .. } => SQLITE_OK,
+        };
+        if code != SQLITE_OK {
+            return Err(format!(
+                "{} failed: {}",
+                sql.to_string_lossy(),
+                self.errmsg()
+            ));
+        }
+        Ok(())
+    }
+
+    fn prepare(&mut self, sql: &CStr) -> Result<(), String> {
+        let mut stmt = std::ptr::null_mut();
+        let code = match self.api {
+            DbApi::Sqlite3 { prepare, .. } => unsafe {
+                prepare(self.conn, sql.as_ptr(), -1, &mut stmt, std::ptr::null_mut())
+            },
+            DbApi::Turso { prepare, .. } => unsafe { prepare(self.conn, sql.as_ptr(), &mut stmt) },
+            DbApi::DuckDb { .. } => return Ok(()),
+        };
+        if code != SQLITE_OK || stmt.is_null() {
+            return Err(format!(
+                "cannot prepare `{}`: {}",
+                sql.to_string_lossy(),
+                self.errmsg()
+            ));
+        }
+        self.stmt = stmt;
+        Ok(())
+    }
+
+    /// # Safety
+    /// `batch` must follow the layout described in the module docs.
+    unsafe fn write_batch(&mut self, batch: &DbBatch) -> Result<(), String> {
+        let col_num = self.col_types.len();
+        if !self.in_txn {
+            self.exec(c"BEGIN TRANSACTION")?;
+            self.in_txn = true;
+        }
+
+        for row in 0..batch.row_num as usize {
+            let values = unsafe { batch.values.add(row * col_num) };
+            for (col, &col_type) in self.col_types.iter().enumerate() {
+                let value = unsafe { *values.add(col) };
+                let code = if col_type == COL_TEXT {
+                    let slot = unsafe { batch.text.add(value as usize) };
+                    let len = unsafe { (slot as *const u32).read_unaligned() };
+                    let ptr = unsafe { slot.add(4) } as *const c_char;
+                    match self.api {
+                        // SQLITE_STATIC: the batch outlives the step of this row
+                        DbApi::Sqlite3 { bind_text, .. } => unsafe {
+                            bind_text(
+                                self.stmt,
+                                col as c_int + 1,
+                                ptr,
+                                len as c_int,
+                                std::ptr::null_mut(),
+                            )
+                        },
+                        DbApi::Turso { bind_text, .. } => unsafe {
+                            bind_text(self.stmt, col as c_int + 1, ptr, len as c_int)
+                        },
+                        DbApi::DuckDb { append_varchar, .. } => unsafe {
+                            append_varchar(self.conn, ptr)
+                        },
+                    }
+                } else {
+                    match self.api {
+                        DbApi::Sqlite3 { bind_int64, .. } | DbApi::Turso { bind_int64, .. } => unsafe {
+                            bind_int64(self.stmt, col as c_int + 1, value)
+                        },
+                        DbApi::DuckDb { append_int64, .. } => unsafe {
+                            append_int64(self.conn, value)
+                        },
+                    }
+                };
+                if code != SQLITE_OK {
+                    return Err(format!("cannot bind column {}: {}", col + 1, self.errmsg()));
+                }
+            }
+
+            match self.api {
+                DbApi::Sqlite3 { step, reset, .. } | DbApi::Turso { step, reset, .. } => unsafe {
+                    if step(self.stmt) != SQLITE_DONE {
+                        return Err(format!("cannot insert row: {}", self.errmsg()));
+                    }
+                    reset(self.stmt);
+                },
+                DbApi::DuckDb { end_row, .. } => unsafe {
+                    if end_row(self.conn) != DUCKDB_SUCCESS {
+                        return Err("duckdb_appender_end_row failed".to_string());
+                    }
+                },
+            }
+        }
+
+        self.rows += batch.row_num as u64;
+        self.rows_in_txn += batch.row_num as u64;
+        if self.rows_in_txn >= self.txn_rows {
+            self.commit()?;
+        }
+        Ok(())
+    }
+
+    fn commit(&mut self) -> Result<(), String> {
+        self.rows_in_txn = 0;
+        if let DbApi::DuckDb { flush, .. } = self.api {
+            if unsafe { flush(self.conn) } != DUCKDB_SUCCESS {
+                return Err("duckdb_appender_flush failed".to_string());
+            }
+            return Ok(());
+        }
+        if self.in_txn {
+            self.in_txn = false;
+            self.exec(c"COMMIT")?;
+        }
+        Ok(())
+    }
+
+    fn finish(&mut self) -> Result<(), String> {
+        let ret = self.commit();
+        if !self.stmt.is_null() {
+            match self.api {
+                DbApi::Sqlite3 { finalize, .. } | DbApi::Turso { finalize, .. } => unsafe {
+                    finalize(self.stmt);
+                },
+                DbApi::DuckDb { .. } => {}
+            }
+            self.stmt = std::ptr::null_mut();
+        }
+        ret
+    }
+}
+
+fn worker_loop(shared: Arc<Shared>, mut sink: Sink) -> Sink {
+    loop {
+        let (batch, failed) = {
+            let mut queues = shared.queues.lock().unwrap();
+            loop {
+                if let Some(batch) = queues.pending.pop_front() {
+                    break (Some(batch), queues.error.is_some());
+                }
+                if queues.closing {
+                    break (None, queues.error.is_some());
+                }
+                queues = shared.pending_cv.wait(queues).unwrap();
+            }
+        };
+
+        let Some(batch) = batch else {
+            if !failed {
+                if let Err(e) = sink.finish() {
+                    shared.queues.lock().unwrap().error.get_or_insert(e);
+                }
+            }
+            return sink;
+        };
+
+        let ret = if failed {
+            Ok(())
+        } else {
+            unsafe { sink.write_batch(&*batch.0) }
+        };
+
+        let mut queues = shared.queues.lock().unwrap();
+        if let Err(e) = ret {
+            queues.error.get_or_insert(e);
+        }
+        unsafe {
+            (*batch.0).row_num = 0;
+            (*batch.0).text_len = 0;
+        }
+        queues.free.push(batch);
+        shared.free_cv.notify_one();
+    }
+}
+
+pub struct DbWriter {
+    shared: Arc<Shared>,
+    storage: Vec<BatchStorage>,
+    worker: Option<JoinHandle<Sink>>,
+    /// Filled when the worker fails, returned by `verilua_db_writer_error`
+    error_cstr: Option<CString>,
+    stalls: u64,
+    /// The worker only exists in the process that opened the writer (not in
+    /// a `LightSSS` fork)
+    pid: libc::pid_t,
+}
+
+impl DbWriter {
+    fn acquire(&mut self) -> Option<*mut DbBatch> {
+        let mut queues = self.shared.queues.lock().unwrap();
+        let mut stalled = false;
+        loop {
+            if queues.error.is_some() || queues.closing {
+                return None;
+            }
+            if let Some(batch) = queues.free.pop() {
+                if stalled {
+                    self.stalls += 1;
+                }
+                return Some(batch.0);
+            }
+            stalled = true;
+            queues = self.shared.free_cv.wait(queues).unwrap();
+        }
+    }
+
+    fn submit(&self, batch: *mut DbBatch) -> bool {
+        let mut queues = self.shared.queues.lock().unwrap();
+        if queues.error.is_some() || queues.closing {
+            return false;
+        }
+        queues.pending.push_back(BatchPtr(batch));
+        self.shared.pending_cv.notify_one();
+        true
+    }
+
+    fn close(&mut self) -> Result<u64, String> {
+        let Some(worker) = self.worker.take() else {
+            return self.error();
+        };
+        if unsafe { libc::getpid() } != self.pid {
+            // Forked child: there is no worker to join, leave the batches to the parent
+            std::mem::forget(worker);
+            return Ok(0);
+        }
+        {
+            let mut queues = self.shared.queues.lock().unwrap();
+            queues.closing = true;
+            self.shared.pending_cv.notify_one();
+        }
+        let rows = match worker.join() {
+            Ok(sink) => sink.rows,
+            Err(_) => {
+                let mut queues = self.shared.queues.lock().unwrap();
+                queues
+                    .error
+                    .get_or_insert("worker thread panicked".to_string());
+                0
+            }
+        };
+        self.error().map(|_| rows)
+    }
+
+    fn error(&self) -> Result<u64, String> {
+        match &self.shared.queues.lock().unwrap().error {
+            Some(e) => Err(e.clone()),
+            None => Ok(0),
+        }
+    }
+}
+
+impl Drop for DbWriter {
+    fn drop(&mut self) {
+        let _ = self.close();
+    }
+}
+
+/// Start an async writer on an opened connection (sqlite3 / turso) or
+/// appender (duckdb). The connection must not be used by the caller until
+/// `verilua_db_writer_close` returns. Returns null if the backend / functions
+/// are invalid or the insert statement cannot be prepared.
+///
+/// - `col_types[i]`: 0 = INTEGER, 1 = TEXT
+/// - `batch_rows` / `text_bytes`: capacity of every batch
+/// - `batch_num`: number of batches, bounds the memory in flight
+/// - `txn_rows`: rows per transaction (duckdb: per appender flush)
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_db_writer_open(
+    backend: u32,
+    conn: *mut c_void,
+    funcs: *const *const c_void,
+    func_num: u32,
+    insert_sql: *const c_char,
+    col_types: *const u8,
+    col_num: u32,
+    batch_rows: u32,
+    text_bytes: u32,
+    batch_num: u32,
+    txn_rows: u64,
+) -> *mut DbWriter {
+    if conn.is_null() || funcs.is_null() || col_types.is_null() || col_num == 0 || batch_rows == 0 {
+        log::error!("[verilua_db_writer_open] invalid arguments");
+        return std::ptr::null_mut();
+    }
+
+    let funcs = unsafe { std::slice::from_raw_parts(funcs, func_num as usize) };
+    let Some(api) = (unsafe { DbApi::from_funcs(backend, funcs) }) else {
+        log::error!(
+            "[verilua_db_writer_open] invalid backend {} or functions",
+            backend
+        );
+        return std::ptr::null_mut();
+    };
+
+    let col_types = unsafe { std::slice::from_raw_parts(col_types, col_num as usize) }.to_vec();
+    if col_types.iter().any(|&t| t != COL_INTEGER && t != COL_TEXT) {
+        log::error!("[verilua_db_writer_open] invalid column type");
+        return std::ptr::null_mut();
+    }
+
+    let mut sink = Sink {
+        api,
+        conn,
+        stmt: std::ptr::null_mut(),
+        col_types,
+        txn_rows: txn_rows.max(1),
+        rows_in_txn: 0,
+        in_txn: false,
+        rows: 0,
+    };
+    if !insert_sql.is_null() {
+        let sql = unsafe { CStr::from_ptr(insert_sql) };
+        if let Err(e) = sink.prepare(sql) {
+            log::error!("[verilua_db_writer_open] {}", e);
+            return std::ptr::null_mut();
+        }
+    }
+
+    let storage: Vec<_> = (0..batch_num.max(2))
+        .map(|_| BatchStorage::new(batch_rows, col_num, text_bytes))
+        .collect();
+    let shared = Arc::new(Shared {
+        queues: Mutex::new(Queues {
+            free: storage
+                .iter()
+                .map(|s| BatchPtr(&*s.header as *const DbBatch as *mut DbBatch))
+                .collect(),
+            ..Default::default()
+        }),
+        free_cv: Condvar::new(),
+        pending_cv: Condvar::new(),
+    });
+
+    let worker_shared = shared.clone();
+    let worker = std::thread::Builder::new()
+        .name("verilua-db-writer".to_string())
+        .spawn(move || worker_loop(worker_shared, sink))
+        .expect("[verilua_db_writer_open] cannot spawn worker thread");
+
+    Box::into_raw(Box::new(DbWriter {
+        shared,
+        storage,
+        worker: Some(worker),
+        error_cstr: None,
+        stalls: 0,
+        pid: unsafe { libc::getpid() },
+    }))
+}
+
+/// Take a free batch (empty), blocking while all batches are pending.
+/// Returns null once the worker failed or the writer is closed.
+#[unsafe(no_mangle)]
+pub extern "C" fn verilua_db_writer_acquire(writer: *mut DbWriter) -> *mut DbBatch {
+    assert!(
+        !writer.is_null(),
+        "[verilua_db_writer_acquire] invalid DbWriter"
+    );
+    let writer = unsafe { &mut *writer };
+    writer.acquire().unwrap_or(std::ptr::null_mut())
+}
+
+/// Hand a batch taken by `acquire` to the worker. Returns false (and keeps
+/// the batch with the caller) once the worker failed or the writer is closed.
+#[unsafe(no_mangle)]
+pub extern "C" fn verilua_db_writer_submit(writer: *mut DbWriter, batch: *mut DbBatch) -> bool {
+    assert!(
+        !writer.is_null(),
+        "[verilua_db_writer_submit] invalid DbWriter"
+    );
+    let writer = unsafe { &*writer };
+    debug_assert!(
+        writer
+            .storage
+            .iter()
+            .any(|s| std::ptr::eq(&*s.header, batch))
+    );
+    writer.submit(batch)
+}
+
+/// Write all pending batches, commit and stop the worker. The connection is
+/// handed back to the caller. Returns false if any batch failed, see
+/// `verilua_db_writer_error`. Calling it again is a no-op.
+#[unsafe(no_mangle)]
+pub extern "C" fn verilua_db_writer_close(writer: *mut DbWriter) -> bool {
+    if writer.is_null() {
+        return true;
+    }
+    let writer = unsafe { &mut *writer };
+    let was_open = writer.worker.is_some();
+    match writer.close() {
+        Ok(rows) => {
+            if was_open {
+                log::info!(
+                    "[verilua_db_writer_close] {} rows, {} producer stalls",
+                    rows,
+                    writer.stalls
+                );
+            }
+            true
+        }
+        Err(e) => {
+            log::error!("[verilua_db_writer_close] {}", e);
+            false
+        }
+    }
+}
+
+/// First error of the worker, null if there is none.
+#[unsafe(no_mangle)]
+pub extern "C" fn verilua_db_writer_error(writer: *mut DbWriter) -> *const c_char {
+    if writer.is_null() {
+        return std::ptr::null();
+    }
+    let writer = unsafe { &mut *writer };
+    match writer.error() {
+        Ok(_) => std::ptr::null(),
+        Err(e) => writer
+            .error_cstr
+            .insert(CString::new(e).unwrap_or_default())
+            .as_ptr(),
+    }
+}
+
+/// Close (if needed) and free a writer. Batches must not be used afterwards.
+#[unsafe(no_mangle)]
+pub extern "C" fn verilua_db_writer_free(writer: *mut DbWriter) {
+    if !writer.is_null() {
+        drop(unsafe { Box::from_raw(writer) });
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::atomic::{AtomicI64, AtomicU64, Ordering};
+
+    static SUM: AtomicI64 = AtomicI64::new(0);
+    static TEXT_BYTES: AtomicU64 = AtomicU64::new(0);
+    static ROWS: AtomicU64 = AtomicU64::new(0);
+    static FLUSHES: AtomicU64 = AtomicU64::new(0);
+
+    unsafe extern "C" fn append_int64(_: *mut c_void, v: i64) -> c_int {
+        SUM.fetch_add(v, Ordering::Relaxed);
+        0
+    }
+
+    unsafe extern "C" fn append_varchar(_: *mut c_void, s: *const c_char) -> c_int {
+        let len = unsafe { CStr::from_ptr(s) }.to_bytes().len();
+        TEXT_BYTES.fetch_add(len as u64, Ordering::Relaxed);
+        0
+    }
+
+    unsafe extern "C" fn end_row(_: *mut c_void) -> c_int {
+        ROWS.fetch_add(1, Ordering::Relaxed);
+        0
+    }
+
+    unsafe extern "C" fn flush(_: *mut c_void) -> c_int {
+        FLUSHES.fetch_add(1, Ordering::Relaxed);
+        0
+    }
+
+    fn push_row(batch: &mut DbBatch, value: i64, text: &str) {
+        let row = batch.row_num as usize;
+        let off = batch.text_len as usize;
+        unsafe {
+            *batch.values.add(row * 2) = value;
+            *batch.values.add(row * 2 + 1) = off as i64;
+            (batch.text.add(off) as *mut u32).write_unaligned(text.len() as u32);
+            std::ptr::copy_nonoverlapping(text.as_ptr(), batch.text.add(off + 4), text.len());
+            *batch.text.add(off + 4 + text.len()) = 0;
+        }
+        batch.text_len = ((off + text.len() + 8) & !3) as u32;
+        batch.row_num += 1;
+    }
+
+    #[test]
+    fn test_duckdb_round_trip() {
+        let funcs: [*const c_void; 4] = [
+            append_int64 as *const c_void,
+            append_varchar as *const c_void,
+            end_row as *const c_void,
+            flush as *const c_void,
+        ];
+        let col_types = [COL_INTEGER, COL_TEXT];
+        let mut conn = 0u8;
+        let writer = unsafe {
+            verilua_db_writer_open(
+                BACKEND_DUCKDB,
+                &mut conn as *mut u8 as *mut c_void,
+                funcs.as_ptr(),
+                funcs.len() as u32,
+                std::ptr::null(),
+                col_types.as_ptr(),
+                2,
+                16,
+                1024,
+                2,
+                100,
+            )
+        };
+        assert!(!writer.is_null());
+
+        let mut expected_sum = 0;
+        let mut expected_text = 0;
+        let mut batch = unsafe { &mut *verilua_db_writer_acquire(writer) };
+        for i in 0..1000i64 {
+            let text = format!("row-{}", i);
+            push_row(batch, i, &text);
+            expected_sum += i;
+            expected_text += text.len() as u64;
+            if batch.row_num == batch.row_cap {
+                assert!(verilua_db_writer_submit(writer, batch));
+                batch = unsafe { &mut *verilua_db_writer_acquire(writer) };
+                assert_eq!(batch.row_num, 0);
+            }
+        }
+        assert!(verilua_db_writer_submit(writer, batch));
+        assert!(verilua_db_writer_close(writer));
+        assert!(verilua_db_writer_error(writer).is_null());
+        assert!(verilua_db_writer_acquire(writer).is_null());
+        verilua_db_writer_free(writer);
+
+        assert_eq!(ROWS.load(Ordering::Relaxed), 1000);
+        assert_eq!(SUM.load(Ordering::Relaxed), expected_sum);
+        assert_eq!(TEXT_BYTES.load(Ordering::Relaxed), expected_text);
+        // At least one flush per `txn_rows` (100) rows
+        assert!(FLUSHES.load(Ordering::Relaxed) >= 10);
+    }
+}
@@ -0,0 +1,275 @@
+//! # Direct Signal Access (Verilator)
+//!
+//! Under Verilator every public signal lives in plain C++ storage inside the
+//! Verilated model. When that storage is registered here (see
+//! `verilua_register_direct_signal`), `complex_handle_by_name` attaches it to
+//! the `ComplexHandle` and the value getters/setters turn into inline loads and
+//! stores instead of `vpi_get_value` / `vpi_put_value` round-trips through
+//! VerilatedVpi.
+//!
+//! Storage is found in two ways:
+//!
+//! - Registrations from the `<tb_top>_port_access.cpp` side-table generated by
+//!   `testbench_gen --port-access`, which is compiled together with the
+//!   Verilated model.
+//! - For every other path, the resolver installed by `verilator_main.cpp`
+//!   (`verilua_set_direct_resolver`), which looks the signal up once through
+//!   `VerilatedScope::varFind`. This covers any public signal (e.g. internal
+//!   signals under `--public-flat-rw`), not only testbench ports. The result is
+//!   cached like a registration. Set `VL_DIRECT_ACCESS=0` to keep every handle
+//!   that is not registered up front on the VPI path.
+//!
+//! Signals that are public but not writable (`public_flat_rd`) are resolved
+//! `read_only`: reads are direct, writes keep going through `vpi_put_value`,
+//! which rejects them.
+//!
+//! ## Storage layout
+//!
+//! ```text
+//!   width        C++ type     Rust view
+//!   1  ..= 8     CData        u8
+//!   9  ..= 16    SData        u16
+//!   17 ..= 32    IData        u32
+//!   33 ..= 64    QData        u64
+//!   > 64         VlWide<N>    [u32; ceil(width / 32)], word 0 = LSB
+//! ```
+//!
+//! Verilator expects the bits above `width` to be zero, so every store masks
+//! the most significant word.
+//!
+//! ## Settling
+//!
+//! A direct store is invisible to `VerilatedVpi::evalNeeded()`. Every store
+//! therefore raises `DIRECT_EVAL_NEEDED`, which `verilator_main.cpp` consumes
+//! through `verilator_take_direct_eval_needed()` in its eval loops so that the
+//! design still converges within the same timestep.
+
+use hashbrown::HashMap;
+use libc::{c_char, c_void};
+use std::cell::UnsafeCell;
+
+use crate::complex_handle::ComplexHandle;
+use crate::utils;
+use crate::vpi_user::*;
+
+/// Raw storage of one Verilated signal.
+#[derive(Debug, Clone, Copy)]
+pub struct DirectSignal {
+    pub datap: *mut c_void,
+    pub width: u32,
+    /// Not public_rw in the Verilated model, never stored into directly
+    pub read_only: bool,
+}
+
+/// Looks up the storage of `path`, returns false if the signal has no
+/// (public, packed) storage. `read_only` is set for signals that may not be
+/// written (not public_rw).
+pub type DirectResolver = unsafe extern "C" fn(
+    path: *const c_char,
+    datap: *mut *mut c_void,
+    width: *mut u32,
+    read_only: *mut bool,
+) -> bool;
+
+thread_local! {
+    static DIRECT_SIGNALS: UnsafeCell<HashMap<String, DirectSignal>> = UnsafeCell::new(HashMap::new());
+    static DIRECT_RESOLVER: UnsafeCell<Option<DirectResolver>> = const { UnsafeCell::new(None) };
+    static DIRECT_EVAL_NEEDED: UnsafeCell<bool> = const { UnsafeCell::new(false) };
+}
+
+/// Register the storage of a Verilated signal under its hierarchical path
+/// (e.g. `tb_top.valid`), as used by `dut.<path>` on the Lua side.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_register_direct_signal(
+    path: *const c_char,
+    datap: *mut c_void,
+    width: u32,
+) {
+    if path.is_null() || datap.is_null() || width == 0 {
+        return;
+    }
+
+    let path = unsafe { utils::c_char_to_str(path) }.to_owned();
+
+    #[cfg(feature = "debug")]
+    log::debug!("verilua_register_direct_signal: {} width: {}", path, width);
+
+    DIRECT_SIGNALS.with(|m| unsafe {
+        (*m.get()).insert(
+            path,
+            DirectSignal {
+                datap,
+                width,
+                read_only: false,
+            },
+        )
+    });
+}
+
+/// Install the fallback used for paths that were not registered through
+/// `verilua_register_direct_signal`. Ignored when `VL_DIRECT_ACCESS` is `0` or
+/// `false`.
+#[unsafe(no_mangle)]
+pub extern "C" fn verilua_set_direct_resolver(resolver: Option<DirectResolver>) {
+    if std::env::var("VL_DIRECT_ACCESS").is_ok_and(|v| v == "0" || v == "false") {
+        return;
+    }
+
+    DIRECT_RESOLVER.with(|r| unsafe { *r.get() = resolver });
+}
+
+/// Returns true (once) if a direct store happened since the last call.
+#[unsafe(no_mangle)]
+pub extern "C" fn verilator_take_direct_eval_needed() -> bool {
+    DIRECT_EVAL_NEEDED.with(|f| unsafe { std::mem::replace(&mut *f.get(), false) })
+}
+
+/// Storage of `path`, asking the resolver (once per path) if it was not
+/// registered. Only called when a `ComplexHandle` is created.
+pub fn lookup(path: &str) -> Option<DirectSignal> {
+    if let Some(direct) = DIRECT_SIGNALS.with(|m| unsafe { (*m.get()).get(path).copied() }) {
+        return Some(direct);
+    }
+
+    let resolver = DIRECT_RESOLVER.with(|r| unsafe { *r.get() })?;
+    let path_cstr = std::ffi::CString::new(path).ok()?;
+    let mut datap: *mut c_void = std::ptr::null_mut();
+    let mut width: u32 = 0;
+    let mut read_only = false;
+    if !unsafe { resolver(path_cstr.as_ptr(), &mut datap, &mut width, &mut read_only) }
+        || datap.is_null()
+        || width == 0
+    {
+        return None;
+    }
+
+    #[cfg(feature = "debug")]
+    log::debug!(
+        "[direct_access::lookup] resolved {} width: {} read_only: {}",
+        path,
+        width,
+        read_only
+    );
+
+    let direct = DirectSignal {
+        datap,
+        width,
+        read_only,
+    };
+    DIRECT_SIGNALS.with(|m| unsafe { (*m.get()).insert(path.to_owned(), direct) });
+    Some(direct)
+}
+
+#[inline(always)]
+fn mark_eval_needed() {
+    DIRECT_EVAL_NEEDED.with(|f| unsafe { *f.get() = true });
+}
+
+#[inline(always)]
+fn top_word_mask(width: u32) -> u32 {
+    match width % 32 {
+        0 => u32::MAX,
+        n => (1u32 << n) - 1,
+    }
+}
+
+impl DirectSignal {
+    #[inline(always)]
+    pub fn word_num(&self) -> usize {
+        self.width.div_ceil(32) as usize
+    }
+
+    /// Word `idx` (LSB first) of the current value.
+    #[inline(always)]
+    pub fn read_word(&self, idx: usize) -> u32 {
+        unsafe {
+            match self.width {
+                1..=8 if idx == 0 => *(self.datap as *const u8) as u32,
+                9..=16 if idx == 0 => *(self.datap as *const u16) as u32,
+                17..=32 if idx == 0 => *(self.datap as *const u32),
+                33..=64 if idx < 2 => (*(self.datap as *const u64) >> (32 * idx)) as u32,
+                65.. if idx < self.word_num() => *(self.datap as *const u32).add(idx),
+                _ => 0,
+            }
+        }
+    }
+
+    #[inline(always)]
+    pub fn read_u64(&self) -> u64 {
+        unsafe {
+            match self.width {
+                1..=8 => *(self.datap as *const u8) as u64,
+                9..=16 => *(self.datap as *const u16) as u64,
+                17..=32 => *(self.datap as *const u32) as u64,
+                33..=64 => *(self.datap as *const u64),
+                _ => {
+                    let p = self.datap as *const u32;
+                    ((*p.add(1) as u64) << 32) | *p as u64
+                }
+            }
+        }
+    }
+
+    /// Store `words` (LSB first, missing words are zero) and mask the bits
+    /// above `width`.
+    #[inline(always)]
+    pub fn write_words(&self, words: impl Fn(usize) -> u32) {
+        let mask = top_word_mask(self.width);
+        unsafe {
+            match self.width {
+                1..=8 => *(self.datap as *mut u8) = (words(0) & mask) as u8,
+                9..=16 => *(self.datap as *mut u16) = (words(0) & mask) as u16,
+                17..=32 => *(self.datap as *mut u32) = words(0) & mask,
+                33..=64 => {
+                    *(self.datap as *mut u64) = (((words(1) & mask) as u64) << 32) | words(0) as u64
+                }
+                _ => {
+                    let n = self.word_num();
+                    let p = self.datap as *mut u32;
+                    for i in 0..n - 1 {
+                        *p.add(i) = words(i);
+                    }
+                    *p.add(n - 1) = words(n - 1) & mask;
+                }
+            }
+        }
+        mark_eval_needed();
+    }
+}
+
+impl ComplexHandle {
+    /// Store `v` immediately without going through VerilatedVpi. Only plain
+    /// (`vpiNoDelay`) integer / vector writes are handled here, everything else
+    /// (force/release, string formats, read-only signals, ...) returns false and
+    /// takes the VPI path.
+    #[inline(always)]
+    pub fn try_put_value_direct(&self, v: &s_vpi_value, flag: u32) -> bool {
+        let Some(direct) = self.direct else {
+            return false;
+        };
+        if flag != vpiNoDelay || direct.read_only {
+            return false;
+        }
+
+        match v.format as u32 {
+            vpiIntVal => {
+                let value = unsafe { v.value.integer } as u32;
+                direct.write_words(|i| if i == 0 { value } else { 0 });
+                true
+            }
+            vpiVectorVal => {
+                let vector = unsafe { v.value.vector };
+                let beat_num = self.beat_num;
+                direct.write_words(|i| {
+                    if i < beat_num {
+                        unsafe { (*vector.add(i)).aval as u32 }
+                    } else {
+                        0
+                    }
+                });
+                true
+            }
+            _ => false,
+        }
+    }
+}
@@ -0,0 +1,262 @@
+//! # Persistent Edge Waiter Lists (feature = "edge_waiter")
+//!
+//! Without this feature every `await_posedge` / `await_negedge` / `await_edge`
+//! costs one `vpi_register_cb(cbValueChange)` plus one `vpi_remove_cb` when the
+//! edge arrives. With hundreds of coroutines waiting on the same clock that is
+//! hundreds of simulator round-trips per cycle.
+//!
+//! Here every `(signal, edge type)` pair owns one long-lived cbValueChange and
+//! an intrusive list of waiting tasks:
+//!
+//! ```text
+//!   ComplexHandle.edge_waiters[Posedge] ──> EdgeWaiterList
+//!                                           ├─ cb_hdl   : armed cbValueChange (or null)
+//!                                           ├─ waiters  : [task1, task2, ...]
+//!                                           └─ spare    : recycled buffer
+//!
+//!   await_posedge(clock)          push task_id to `waiters`, arm if disarmed
+//!   clock rises                   swap `waiters` <-> `spare`, wake the taken batch
+//!                                 through `sim_event_chunk_N` (16 tasks per call)
+//!   woken task awaits again       pushed to the fresh `waiters`, woken on the next edge
+//! ```
+//!
+//! `NativeCond` waits (see `native_cond.rs`) join the same list as
+//! `cond_waiters`: on every matching edge their predicate is evaluated in
+//! place and only the tasks whose predicate holds (or whose cycle limit is
+//! reached) are added to the woken batch. A task removed by the scheduler
+//! while its wait is pending leaves the list through `cancel_cond_waiter`.
+//!
+//! The callback stays armed while the list is in use, so in steady state the
+//! simulator sees no callback registration at all. A list that stays empty for
+//! `IDLE_CALLS_BEFORE_DISARM` value changes is disarmed (the signal is no
+//! longer awaited, e.g. after a phase of the test ended) and re-armed on the
+//! next wait.
+
+use crate::complex_handle::{ComplexHandle, ComplexHandleRaw};
+use crate::native_cond::{CondWaiter, set_cond_result};
+use crate::verilua_env::VeriluaEnv;
+use crate::vpi_callback::{EdgeType, EdgeValue, edge_type_to_value};
+use crate::vpi_user::*;
+
+use crate::TaskID;
+
+use hashbrown::HashMap;
+use std::cell::UnsafeCell;
+
+/// Number of value changes without any waiter after which the callback is removed.
+const IDLE_CALLS_BEFORE_DISARM: u32 = 4;
+
+thread_local! {
+    /// List holding the pending `NativeCond` wait of each task (a task has at
+    /// most one), used to cancel the wait when the task is removed.
+    static COND_WAIT_LISTS: UnsafeCell<HashMap<TaskID, *mut EdgeWaiterList>> = UnsafeCell::new(HashMap::new());
+}
+
+pub struct EdgeWaiterList {
+    complex_handle_raw: ComplexHandleRaw,
+    edge_type: EdgeType,
+    /// Armed cbValueChange, null while disarmed
+    cb_hdl: vpiHandle,
+    /// Tasks woken by the next matching edge
+    waiters: Vec<TaskID>,
+    /// Buffer swapped in for `waiters` while a batch is being woken, keeps the
+    /// steady state allocation-free
+    spare: Vec<TaskID>,
+    /// Pending `NativeCond` waits, kept across edges until they finish
+    cond_waiters: Vec<CondWaiter>,
+    idle_calls: u32,
+    /// VPI value structure for the callback (required by VPI spec)
+    vpi_value: t_vpi_value,
+    /// VPI time structure for the callback (required by VPI spec)
+    vpi_time: t_vpi_time,
+}
+
+impl EdgeWaiterList {
+    fn new(complex_handle_raw: ComplexHandleRaw, edge_type: EdgeType) -> Self {
+        Self {
+            complex_handle_raw,
+            edge_type,
+            cb_hdl: std::ptr::null_mut(),
+            waiters: Vec::with_capacity(32),
+            spare: Vec::with_capacity(32),
+            cond_waiters: Vec::new(),
+            idle_calls: 0,
+            vpi_value: t_vpi_value {
+                format: vpiIntVal as _,
+                value: t_vpi_value__bindgen_ty_1 { integer: 0 },
+            },
+            vpi_time: t_vpi_time {
+                type_: vpiSuppressTime as _,
+                high: 0,
+                low: 0,
+                real: 0.0,
+            },
+        }
+    }
+
+    unsafe fn arm(this: *mut Self) {
+        let list = unsafe { &mut *this };
+        let complex_handle = ComplexHandle::from_raw(&list.complex_handle_raw);
+
+        let mut cb_data = s_cb_data {
+            reason: cbValueChange as _,
+            cb_rtn: Some(edge_waiter_callback),
+            time: &mut list.vpi_time,
+            obj: complex_handle.vpi_handle,
+            user_data: this as *mut _,
+            value: &mut list.vpi_value,
+            index: 0,
+        };
+
+        list.cb_hdl = unsafe { vpi_register_cb(&mut cb_data) };
+        list.idle_calls = 0;
+    }
+
+    unsafe fn disarm(this: *mut Self) {
+        let list = unsafe { &mut *this };
+        if !list.cb_hdl.is_null() {
+            unsafe { vpi_remove_cb(list.cb_hdl) };
+            list.cb_hdl = std::ptr::null_mut();
+        }
+    }
+}
+
+/// Waiter list of `(complex_handle_raw, edge_type)`, created on first use.
+#[inline(always)]
+fn waiter_list(complex_handle_raw: ComplexHandleRaw, edge_type: EdgeType) -> *mut EdgeWaiterList {
+    let complex_handle = ComplexHandle::from_raw(&complex_handle_raw);
+
+    let slot = &mut complex_handle.edge_waiters[edge_type as usize];
+    if slot.is_null() {
+        // Lives as long as the ComplexHandle (i.e. the whole simulation)
+        *slot = Box::into_raw(Box::new(EdgeWaiterList::new(complex_handle_raw, edge_type)));
+    }
+    *slot
+}
+
+/// Add `task_id` to the waiter list of `(complex_handle_raw, edge_type)`,
+/// arming the list if needed.
+#[inline(always)]
+pub unsafe fn add_edge_waiter(
+    complex_handle_raw: ComplexHandleRaw,
+    edge_type: EdgeType,
+    task_id: TaskID,
+) {
+    let list = waiter_list(complex_handle_raw, edge_type);
+    unsafe {
+        (*list).waiters.push(task_id);
+        (*list).idle_calls = 0;
+        if (*list).cb_hdl.is_null() {
+            EdgeWaiterList::arm(list);
+        }
+    }
+}
+
+/// Add a `NativeCond` wait to the waiter list of `(complex_handle_raw, edge_type)`,
+/// arming the list if needed.
+pub unsafe fn add_cond_waiter(
+    complex_handle_raw: ComplexHandleRaw,
+    edge_type: EdgeType,
+    waiter: CondWaiter,
+) {
+    let list = waiter_list(complex_handle_raw, edge_type);
+    COND_WAIT_LISTS.with(|lists| unsafe { (*lists.get()).insert(waiter.task_id, list) });
+    unsafe {
+        (*list).cond_waiters.push(waiter);
+        (*list).idle_calls = 0;
+        if (*list).cb_hdl.is_null() {
+            EdgeWaiterList::arm(list);
+        }
+    }
+}
+
+/// Drop the pending `NativeCond` wait of `task_id`, if any. Returns true if
+/// one was removed, the task will then not be woken by it anymore.
+pub fn cancel_cond_waiter(task_id: TaskID) -> bool {
+    let Some(list) = COND_WAIT_LISTS.with(|lists| unsafe { (*lists.get()).remove(&task_id) })
+    else {
+        return false;
+    };
+
+    let cond_waiters = unsafe { &mut (*list).cond_waiters };
+    let len = cond_waiters.len();
+    cond_waiters.retain(|waiter| waiter.task_id != task_id);
+    cond_waiters.len() != len
+}
+
+unsafe extern "C" fn edge_waiter_callback(cb_data: *mut t_cb_data) -> PLI_INT32 {
+    let cb_data = unsafe { cb_data.read() };
+    let Ok(new_value) = EdgeValue::try_from(unsafe { cb_data.value.read().value.integer } as u8)
+    else {
+        // Signal is in X/Z state, skip edge detection
+        return 0;
+    };
+
+    // Only accessed through the raw pointer: waking tasks may re-enter this
+    // list (new waiters, nested value changes of the same signal).
+    let list = cb_data.user_data as *mut EdgeWaiterList;
+
+    if unsafe { (*list).waiters.is_empty() && (*list).cond_waiters.is_empty() } {
+        unsafe {
+            (*list).idle_calls += 1;
+            if (*list).idle_calls >= IDLE_CALLS_BEFORE_DISARM {
+                EdgeWaiterList::disarm(list);
+            }
+        }
+        return 0;
+    }
+
+    let expected_edge_value = edge_type_to_value(unsafe { &(*list).edge_type });
+    if new_value != expected_edge_value && expected_edge_value != EdgeValue::DontCare {
+        return 0;
+    }
+
+    // Take the current batch; tasks that wait again while being woken land in
+    // the fresh (recycled) buffer and are woken by the next edge.
+    let spare = std::mem::take(unsafe { &mut (*list).spare });
+    let mut woken = std::mem::replace(unsafe { &mut (*list).waiters }, spare);
+
+    let env = VeriluaEnv::from_complex_handle_raw(unsafe { (*list).complex_handle_raw });
+
+    // Finished `NativeCond` waits leave the list before any task runs and
+    // join the batch; their outcome is read back by `vpiml_native_cond_result`
+    unsafe { &mut (*list).cond_waiters }.retain_mut(|waiter| match waiter.on_edge(env) {
+        Some(result) => {
+            COND_WAIT_LISTS.with(|lists| unsafe { (*lists.get()).remove(&waiter.task_id) });
+            set_cond_result(waiter.task_id, result);
+            woken.push(waiter.task_id);
+            false
+        }
+        None => true,
+    });
+
+    let s = env.acc_lua_time.then(std::time::Instant::now);
+
+    #[cfg(feature = "chunk_task")]
+    let result = woken
+        .chunks(crate::verilua_env::SIM_EVENT_CHUNK_MAX)
+        .try_for_each(|chunk| env.call_sim_event_chunk(chunk.len(), chunk));
+
+    #[cfg(not(feature = "chunk_task"))]
+    let result = woken
+        .iter()
+        .try_for_each(|task_id| env.call_sim_event(*task_id));
+
+    if let Err(e) = result {
+        env.finalize();
+        panic!("{}", e);
+    }
+
+    if let Some(s) = s {
+        env.lua_time += s.elapsed();
+    }
+
+    woken.clear();
+    unsafe {
+        if (*list).spare.capacity() < woken.capacity() {
+            (*list).spare = woken;
+        }
+    }
+
+    0
+}
@@ -0,0 +1,329 @@
+//! # Handle Groups (bulk bundle access)
+//!
+//! `Bundle:get_all()` / `Bundle:set_all()` used to cross the Lua/Rust FFI
+//! boundary once per member signal, each crossing looking up the
+//! `VeriluaEnv` and the `ComplexHandle` again. A bundle with 20 fields sampled
+//! on every cycle pays 20 crossings per cycle.
+//!
+//! A `HandleGroup` registers the member handles once and fixes a packed
+//! layout. `get_all` / `set_all` then move the values of the whole group
+//! through a single caller-owned `uint32_t` buffer in one call:
+//!
+//! ```text
+//!   buffer (u32 words)
+//!   ┌──────────┬────┬────┬──────────┬────┬──────────┬────┬────┬────┬─────
+//!   │ beat_num │ w0 │ w1 │ beat_num │ w0 │ beat_num │ w0 │ w1 │ w2 │ ...
+//!   └──────────┴────┴────┴──────────┴────┴──────────┴────┴────┴────┴─────
+//!    ^ offsets[0]          ^ offsets[1]   ^ offsets[2]
+//! ```
+//!
+//! Every member slot has the same layout as `MultiBeatData` (`[0]` = number of
+//! beats, `[1..]` = words, LSB first), so a wide member can be handed to Lua
+//! as a pointer into the buffer without copying.
+//!
+//! Reads use the direct Verilator storage of a member when it has one (plain
+//! loads, no VerilatedVpi) and `vpi_get_value` otherwise. Writes go through
+//! the regular `set` path of every member, i.e. they are deferred to the
+//! next write phase exactly like `chdl:set(...)`.
+//!
+//! Packed bundles additionally give the group a struct layout (byte offset
+//! and size of every member inside a caller-owned FFI struct generated from
+//! the member widths, see `vpiml_handle_group_set_layout`). `get_struct` /
+//! `set_struct` then move the values straight between the simulator and that
+//! struct, and `fire` evaluates `valid && ready` of two members in one call.
+
+use crate::complex_handle::{ComplexHandle, ComplexHandleRaw};
+use crate::direct_access::DirectSignal;
+use crate::verilua_env::VeriluaEnv;
+
+struct GroupMember {
+    complex_handle_raw: ComplexHandleRaw,
+    /// Offset of the member slot (in words) inside the group buffer
+    offset: u32,
+    beat_num: u32,
+    direct: Option<DirectSignal>,
+    /// Byte offset / size of the member inside the struct layout
+    byte_offset: u32,
+    byte_size: u32,
+}
+
+pub struct HandleGroup {
+    members: Vec<GroupMember>,
+    /// Total number of words of the group buffer
+    word_num: u32,
+    /// Whether `vpiml_handle_group_set_layout` has been called
+    has_layout: bool,
+    /// Member indices of `valid` / `ready` for `fire`, -1 if absent
+    fire_members: [i32; 2],
+    /// One member slot (`1 + beat_num` words) for the struct conversions
+    scratch: Vec<u32>,
+}
+
+pub type HandleGroupHandle = *mut HandleGroup;
+
+impl HandleGroup {
+    fn new(handles: &[ComplexHandleRaw]) -> Self {
+        let mut offset = 0;
+        let members = handles
+            .iter()
+            .map(|&complex_handle_raw| {
+                let complex_handle = ComplexHandle::from_raw(&complex_handle_raw);
+                let beat_num = complex_handle.beat_num as u32;
+                let member = GroupMember {
+                    complex_handle_raw,
+                    offset,
+                    beat_num,
+                    direct: if cfg!(feature = "verilator") {
+                        complex_handle.direct
+                    } else {
+                        None
+                    },
+                    byte_offset: 0,
+                    byte_size: 0,
+                };
+                offset += 1 + beat_num;
+                member
+            })
+            .collect::<Vec<_>>();
+
+        let max_beat_num = members.iter().map(|m| m.beat_num).max().unwrap_or(0);
+        Self {
+            members,
+            word_num: offset,
+            has_layout: false,
+            fire_members: [-1, -1],
+            scratch: vec![0; 1 + max_beat_num as usize],
+        }
+    }
+
+    /// Read member `idx` into `slot` (`MultiBeatData` layout)
+    #[inline(always)]
+    fn read_member(&self, env: &mut VeriluaEnv, idx: usize, slot: *mut u32) {
+        let member = &self.members[idx];
+        match member.direct {
+            Some(direct) => unsafe {
+                slot.write(member.beat_num);
+                for i in 0..member.beat_num as usize {
+                    slot.add(1 + i).write(direct.read_word(i));
+                }
+            },
+            None => env.vpiml_get_value_multi(member.complex_handle_raw, slot, member.beat_num),
+        }
+    }
+
+    fn get_struct(&mut self, env: &mut VeriluaEnv, out: *mut u8) {
+        let slot = self.scratch.as_mut_ptr();
+        for idx in 0..self.members.len() {
+            self.read_member(env, idx, slot);
+
+            // Words are little-endian like the struct fields, copy the low
+            // `byte_size` bytes and zero what the signal does not cover
+            let member = &self.members[idx];
+            let size = member.byte_size as usize;
+            let n = size.min(member.beat_num as usize * 4);
+            unsafe {
+                let dst = out.add(member.byte_offset as usize);
+                std::ptr::copy_nonoverlapping(slot.add(1) as *const u8, dst, n);
+                std::ptr::write_bytes(dst.add(n), 0, size - n);
+            }
+        }
+    }
+
+    fn set_struct(&mut self, env: &mut VeriluaEnv, inp: *const u8) {
+        let slot = self.scratch.as_mut_ptr();
+        for member in &self.members {
+            let words = member.beat_num as usize;
+            let n = (member.byte_size as usize).min(words * 4);
+            unsafe {
+                std::ptr::write_bytes(slot.add(1), 0, words);
+                std::ptr::copy_nonoverlapping(
+                    inp.add(member.byte_offset as usize),
+                    slot.add(1) as *mut u8,
+                    n,
+                );
+                env.vpiml_set_value_multi(member.complex_handle_raw, slot.add(1));
+            }
+        }
+    }
+
+    fn fire(&self, env: &mut VeriluaEnv) -> bool {
+        for &idx in &self.fire_members {
+            if idx < 0 {
+                continue;
+            }
+            let member = &self.members[idx as usize];
+            let value = match member.direct {
+                Some(direct) => direct.read_word(0),
+                None => env.vpiml_get_value(member.complex_handle_raw),
+            };
+            if value != 1 {
+                return false;
+            }
+        }
+        true
+    }
+
+    fn get_all(&self, env: &mut VeriluaEnv, buf: *mut u32) {
+        for (idx, member) in self.members.iter().enumerate() {
+            self.read_member(env, idx, unsafe { buf.add(member.offset as usize) });
+        }
+    }
+
+    fn set_all(&self, env: &mut VeriluaEnv, buf: *const u32) {
+        for member in &self.members {
+            let words = unsafe { buf.add(member.offset as usize + 1) };
+            unsafe { env.vpiml_set_value_multi(member.complex_handle_raw, words) };
+        }
+    }
+}
+
+/// Create a group of `n` handles. The layout (slot offsets) follows the order
+/// of `handles`. Returns null for an empty group.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_handle_group_new(
+    handles: *const ComplexHandleRaw,
+    n: u32,
+) -> HandleGroupHandle {
+    if handles.is_null() || n == 0 {
+        return std::ptr::null_mut();
+    }
+
+    let handles = unsafe { std::slice::from_raw_parts(handles, n as usize) };
+    Box::into_raw(Box::new(HandleGroup::new(handles)))
+}
+
+/// Number of `u32` words of the buffer passed to `get_all` / `set_all`.
+#[unsafe(no_mangle)]
+pub extern "C" fn vpiml_handle_group_word_num(group: HandleGroupHandle) -> u32 {
+    if group.is_null() {
+        return 0;
+    }
+    unsafe { (*group).word_num }
+}
+
+/// Word offset of the slot of member `idx`.
+#[unsafe(no_mangle)]
+pub extern "C" fn vpiml_handle_group_offset(group: HandleGroupHandle, idx: u32) -> u32 {
+    assert!(
+        !group.is_null(),
+        "[vpiml_handle_group_offset] invalid HandleGroup"
+    );
+    let group = unsafe { &*group };
+    group.members[idx as usize].offset
+}
+
+/// Read every member into `buf`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_handle_group_get_all(group: HandleGroupHandle, buf: *mut u32) {
+    assert!(
+        !group.is_null(),
+        "[vpiml_handle_group_get_all] invalid HandleGroup"
+    );
+    let group = unsafe { &*group };
+    let env = VeriluaEnv::from_complex_handle_raw(group.members[0].complex_handle_raw);
+    group.get_all(env, buf);
+}
+
+/// Write every member from `buf` (the `beat_num` word of each slot is ignored).
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_handle_group_set_all(group: HandleGroupHandle, buf: *const u32) {
+    assert!(
+        !group.is_null(),
+        "[vpiml_handle_group_set_all] invalid HandleGroup"
+    );
+    let group = unsafe { &*group };
+    let env = VeriluaEnv::from_complex_handle_raw(group.members[0].complex_handle_raw);
+    if env.rd_phase_active {
+        panic!("Attempting to write an HDL value during the ReadOnly phase: handle group.");
+    }
+    group.set_all(env, buf);
+}
+
+/// Set the struct layout used by `get_struct` / `set_struct`: member `i`
+/// occupies `byte_sizes[i]` bytes at `byte_offsets[i]` (one entry per member).
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_handle_group_set_layout(
+    group: HandleGroupHandle,
+    byte_offsets: *const u32,
+    byte_sizes: *const u32,
+) {
+    assert!(
+        !group.is_null(),
+        "[vpiml_handle_group_set_layout] invalid HandleGroup"
+    );
+    let group = unsafe { &mut *group };
+    for (i, member) in group.members.iter_mut().enumerate() {
+        unsafe {
+            member.byte_offset = byte_offsets.add(i).read();
+            member.byte_size = byte_sizes.add(i).read();
+        }
+    }
+    group.has_layout = true;
+}
+
+/// Read every member into the struct `out` (layout set by `set_layout`).
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_handle_group_get_struct(group: HandleGroupHandle, out: *mut u8) {
+    assert!(
+        !group.is_null() && unsafe { (*group).has_layout },
+        "[vpiml_handle_group_get_struct] invalid HandleGroup or no layout"
+    );
+    let group = unsafe { &mut *group };
+    let env = VeriluaEnv::from_complex_handle_raw(group.members[0].complex_handle_raw);
+    group.get_struct(env, out);
+}
+
+/// Write every member from the struct `inp` (layout set by `set_layout`).
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_handle_group_set_struct(group: HandleGroupHandle, inp: *const u8) {
+    assert!(
+        !group.is_null() && unsafe { (*group).has_layout },
+        "[vpiml_handle_group_set_struct] invalid HandleGroup or no layout"
+    );
+    let group = unsafe { &mut *group };
+    let env = VeriluaEnv::from_complex_handle_raw(group.members[0].complex_handle_raw);
+    if env.rd_phase_active {
+        panic!("Attempting to write an HDL value during the ReadOnly phase: handle group.");
+    }
+    group.set_struct(env, inp);
+}
+
+/// Select the `valid` / `ready` members evaluated by `fire` (-1 if absent).
+#[unsafe(no_mangle)]
+pub extern "C" fn vpiml_handle_group_set_fire(
+    group: HandleGroupHandle,
+    valid_idx: i32,
+    ready_idx: i32,
+) {
+    assert!(
+        !group.is_null(),
+        "[vpiml_handle_group_set_fire] invalid HandleGroup"
+    );
+    let group = unsafe { &mut *group };
+    let n = group.members.len() as i32;
+    assert!(
+        valid_idx < n && ready_idx < n,
+        "[vpiml_handle_group_set_fire] member index out of range"
+    );
+    group.fire_members = [valid_idx, ready_idx];
+}
+
+/// 1 if every member selected by `set_fire` equals 1, 0 otherwise.
+#[unsafe(no_mangle)]
+pub extern "C" fn vpiml_handle_group_fire(group: HandleGroupHandle) -> u8 {
+    assert!(
+        !group.is_null(),
+        "[vpiml_handle_group_fire] invalid HandleGroup"
+    );
+    let group = unsafe { &*group };
+    let env = VeriluaEnv::from_complex_handle_raw(group.members[0].complex_handle_raw);
+    group.fire(env) as u8
+}
+
+/// Free a group created by `vpiml_handle_group_new`.
+#[unsafe(no_mangle)]
+pub extern "C" fn vpiml_handle_group_destroy(group: HandleGroupHandle) {
+    if !group.is_null() {
+        drop(unsafe { Box::from_raw(group) });
+    }
+}
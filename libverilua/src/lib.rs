@@ -36,15 +36,29 @@
 //! - `verilua_env`: Global environment management and Lua integration
 //! - `vpi_access`: Signal value read/write operations
 //! - `vpi_callback`: Event callback registration (edge, time, etc.)
+//! - `edge_waiter`: Persistent per-signal edge waiter lists (one cbValueChange per signal/edge)
 //! - `complex_handle`: Enhanced VPI handle with caching and metadata
+//! - `direct_access`: Direct loads/stores of Verilated signal storage (`--port-access` side-table and resolver)
+//! - `access_profile`: Records resolved signal paths (`VL_ACCESS_PROFILE`) for selective Verilator publicity
+//! - `handle_group`: Bulk read/write of a group of handles (bundles) in one FFI call
 //! - `native_clock`: High-performance native clock driver (toggles without returning to Lua)
+//! - `native_cond`: Native condition wait (predicate evaluated on every clock edge without resuming Lua)
+//! - `db_writer`: Asynchronous batched row writer for `LuaDataBaseV2` (worker thread owns the connection)
+//! - `trace_sink`: Binary transaction trace (SPSC ring + background LZ4 columnar writer) and its reader
 //! - `utils`: FFI utilities and helper functions
 //! - `verilator_helper`: Verilator-specific workarounds and helpers
 //!
 
 #![allow(non_upper_case_globals)]
+mod access_profile;
 mod complex_handle;
+mod db_writer;
+mod direct_access;
+mod edge_waiter;
+mod handle_group;
 mod native_clock;
+mod native_cond;
+mod trace_sink;
 mod utils;
 mod verilator_helper;
 mod verilua_env;
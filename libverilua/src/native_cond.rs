@@ -0,0 +1,328 @@
+//! # Native Condition Wait
+//!
+//! `repeat clock:posedge() until dut.valid:is(1) and dut.ready:is(1)` resumes
+//! a Lua coroutine on every clock edge only to evaluate a trivial condition.
+//! For long idle waits that resume/yield pair is the dominant cost.
+//!
+//! `NativeCond` moves the condition into Rust: Lua compiles the predicate
+//! once into a small stack bytecode, and a wait joins the persistent waiter
+//! list of the clock edge (see `edge_waiter.rs`), which evaluates the
+//! bytecode on every matching edge. The task is woken only when the predicate
+//! holds or when the cycle limit is reached, and no VPI callback is
+//! registered or removed per wait.
+//!
+//! ```text
+//!   Lua (once)                          Rust (every edge, no Lua)
+//!   ┌─────────────────────────────┐     ┌────────────────────────────────┐
+//!   │ NativeCond.all {            │     │ EQ  valid  mask=1 value=1      │
+//!   │   NativeCond.eq(valid, 1),  │ ──> │ EQ  ready  mask=1 value=1      │
+//!   │   NativeCond.eq(ready, 1),  │     │ AND                            │
+//!   │ }                           │     └────────────────────────────────┘
+//!   └─────────────────────────────┘                    │ true / timeout
+//!                                                      ▼
+//!                                        woken with the edge's batch
+//! ```
+//!
+//! ## Bytecode
+//!
+//! Lua passes `4 * op_num` `u64` words, each op is `[opcode, handle, mask, value]`
+//! (`handle` / `mask` / `value` are only used by leaf ops):
+//!
+//! | opcode | op    | effect                                           |
+//! |--------|-------|--------------------------------------------------|
+//! | 0      | `EQ`  | push `(get64(handle) & mask) == value`           |
+//! | 1      | `NE`  | push `(get64(handle) & mask) != value`           |
+//! | 2      | `AND` | pop b, pop a, push `a && b`                      |
+//! | 3      | `OR`  | pop b, pop a, push `a \|\| b`                    |
+//! | 4      | `NOT` | pop a, push `!a`                                 |
+//!
+//! Signal values are read like `CallableHDL:get()` (lower 64 bits, direct
+//! Verilator storage when available), so a condition behaves the same as the
+//! Lua expression it replaces. Only VPI value-change callbacks and reads are
+//! used, so it works on every backend, including wave_vpi replay.
+
+use hashbrown::HashMap;
+use std::cell::UnsafeCell;
+
+use crate::TaskID;
+use crate::complex_handle::ComplexHandleRaw;
+use crate::edge_waiter::{add_cond_waiter, cancel_cond_waiter};
+use crate::verilua_env::VeriluaEnv;
+use crate::vpi_callback::EdgeType;
+
+/// Maximum depth of the evaluation stack.
+const MAX_STACK_DEPTH: usize = 64;
+
+#[derive(Debug, Clone, Copy)]
+enum CondOp {
+    Eq {
+        complex_handle_raw: ComplexHandleRaw,
+        mask: u64,
+        value: u64,
+    },
+    Ne {
+        complex_handle_raw: ComplexHandleRaw,
+        mask: u64,
+        value: u64,
+    },
+    And,
+    Or,
+    Not,
+}
+
+/// A compiled predicate, shared (read-only) by every wait that uses it.
+pub struct NativeCond {
+    ops: Vec<CondOp>,
+}
+
+/// Opaque handle type for FFI
+pub type NativeCondHandle = *mut NativeCond;
+
+impl NativeCond {
+    /// Decode `words` (see module docs). Returns None if an opcode is unknown
+    /// or the program does not leave exactly one value on the stack.
+    fn compile(words: &[u64]) -> Option<Self> {
+        if words.is_empty() || words.len() % 4 != 0 {
+            return None;
+        }
+
+        let mut ops = Vec::with_capacity(words.len() / 4);
+        let mut depth = 0usize;
+        for op in words.chunks_exact(4) {
+            let (complex_handle_raw, mask, value) = (op[1] as ComplexHandleRaw, op[2], op[3]);
+            let (op, pop, push) = match op[0] {
+                0 => (
+                    CondOp::Eq {
+                        complex_handle_raw,
+                        mask,
+                        value,
+                    },
+                    0,
+                    1,
+                ),
+                1 => (
+                    CondOp::Ne {
+                        complex_handle_raw,
+                        mask,
+                        value,
+                    },
+                    0,
+                    1,
+                ),
+                2 => (CondOp::And, 2, 1),
+                3 => (CondOp::Or, 2, 1),
+                4 => (CondOp::Not, 1, 1),
+                _ => return None,
+            };
+
+            if matches!(op, CondOp::Eq { .. } | CondOp::Ne { .. }) && complex_handle_raw == 0 {
+                return None;
+            }
+            if depth < pop {
+                return None;
+            }
+            depth = depth - pop + push;
+            if depth > MAX_STACK_DEPTH {
+                return None;
+            }
+            ops.push(op);
+        }
+
+        (depth == 1).then_some(Self { ops })
+    }
+
+    #[inline(always)]
+    fn eval(&self, env: &mut VeriluaEnv) -> bool {
+        let mut stack = [false; MAX_STACK_DEPTH];
+        let mut sp = 0usize;
+
+        for op in &self.ops {
+            match *op {
+                CondOp::Eq {
+                    complex_handle_raw,
+                    mask,
+                    value,
+                } => {
+                    stack[sp] = (env.vpiml_get_value64(complex_handle_raw) & mask) == value;
+                    sp += 1;
+                }
+                CondOp::Ne {
+                    complex_handle_raw,
+                    mask,
+                    value,
+                } => {
+                    stack[sp] = (env.vpiml_get_value64(complex_handle_raw) & mask) != value;
+                    sp += 1;
+                }
+                CondOp::And => {
+                    sp -= 1;
+                    stack[sp - 1] = stack[sp - 1] && stack[sp];
+                }
+                CondOp::Or => {
+                    sp -= 1;
+                    stack[sp - 1] = stack[sp - 1] || stack[sp];
+                }
+                CondOp::Not => stack[sp - 1] = !stack[sp - 1],
+            }
+        }
+
+        stack[0]
+    }
+}
+
+// ────────────────────────────────────────────────────────────────────────────────
+// Waits
+// ────────────────────────────────────────────────────────────────────────────────
+
+thread_local! {
+    /// Outcome of the last finished wait of each task, taken by
+    /// `vpiml_native_cond_result`.
+    static COND_RESULTS: UnsafeCell<HashMap<TaskID, i64>> = UnsafeCell::new(HashMap::new());
+}
+
+#[inline(always)]
+pub(crate) fn set_cond_result(task_id: TaskID, result: i64) {
+    COND_RESULTS.with(|r| unsafe { (*r.get()).insert(task_id, result) });
+}
+
+/// One pending wait, held by the waiter list of the clock edge until the
+/// predicate holds or `max_cycles` edges have passed.
+pub(crate) struct CondWaiter {
+    cond: *const NativeCond,
+    pub(crate) task_id: TaskID,
+    /// 0 means no limit
+    max_cycles: u64,
+    cycles: u64,
+}
+
+impl CondWaiter {
+    /// Count one matching edge. Returns the outcome once the wait is over:
+    /// the edges waited, negated if `max_cycles` was reached.
+    #[inline(always)]
+    pub(crate) fn on_edge(&mut self, env: &mut VeriluaEnv) -> Option<i64> {
+        self.cycles += 1;
+        if unsafe { (*self.cond).eval(env) } {
+            Some(self.cycles as i64)
+        } else if self.max_cycles != 0 && self.cycles >= self.max_cycles {
+            Some(-(self.cycles as i64))
+        } else {
+            None
+        }
+    }
+}
+
+// ────────────────────────────────────────────────────────────────────────────────
+// FFI Functions
+// ────────────────────────────────────────────────────────────────────────────────
+
+/// Compile a predicate.
+///
+/// # Arguments
+/// * `words` - `4 * op_num` words, see the module docs for the encoding
+/// * `op_num` - Number of ops
+///
+/// # Returns
+/// Opaque handle to the compiled predicate, or null if the program is invalid
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_native_cond_new(words: *const u64, op_num: u32) -> NativeCondHandle {
+    if words.is_null() || op_num == 0 {
+        return std::ptr::null_mut();
+    }
+
+    let words = unsafe { std::slice::from_raw_parts(words, op_num as usize * 4) };
+    match NativeCond::compile(words) {
+        Some(cond) => Box::into_raw(Box::new(cond)),
+        None => std::ptr::null_mut(),
+    }
+}
+
+/// Evaluate a predicate now, returns 1 if it holds.
+#[unsafe(no_mangle)]
+pub extern "C" fn vpiml_native_cond_eval(env: *mut libc::c_void, handle: NativeCondHandle) -> u8 {
+    if handle.is_null() {
+        return 0;
+    }
+    let env = VeriluaEnv::from_void_ptr(env);
+    unsafe { (*handle).eval(env) as u8 }
+}
+
+/// Wake `task_id` at the first `edge_type` edge (0: posedge, 1: negedge,
+/// 2: any edge) of `clock_raw` at which the predicate holds, or after
+/// `max_cycles` edges (0: no limit). The caller must keep `handle` alive
+/// until the task is woken.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vpiml_native_cond_wait(
+    handle: NativeCondHandle,
+    clock_raw: ComplexHandleRaw,
+    edge_type: u8,
+    max_cycles: u64,
+    task_id: TaskID,
+) {
+    assert!(
+        !handle.is_null(),
+        "[vpiml_native_cond_wait] invalid NativeCond handle"
+    );
+    let edge_type = match edge_type {
+        0 => EdgeType::Posedge,
+        1 => EdgeType::Negedge,
+        2 => EdgeType::Edge,
+        _ => panic!("[vpiml_native_cond_wait] invalid edge type: {}", edge_type),
+    };
+
+    unsafe {
+        add_cond_waiter(
+            clock_raw,
+            edge_type,
+            CondWaiter {
+                cond: handle,
+                task_id,
+                max_cycles,
+                cycles: 0,
+            },
+        )
+    };
+}
+
+/// Outcome of the last finished wait of `task_id`: the number of edges
+/// waited if the predicate held, its negation if the cycle limit was reached,
+/// 0 if there is none.
+#[unsafe(no_mangle)]
+pub extern "C" fn vpiml_native_cond_result(task_id: TaskID) -> i64 {
+    COND_RESULTS.with(|r| unsafe { (*r.get()).remove(&task_id) }.unwrap_or(0))
+}
+
+/// Cancel the pending wait of `task_id` (e.g. the task was removed) and drop
+/// any outcome not read yet. Returns 1 if a pending wait was cancelled, the
+/// task is then no longer referenced by any waiter list.
+#[unsafe(no_mangle)]
+pub extern "C" fn vpiml_native_cond_cancel(task_id: TaskID) -> u8 {
+    COND_RESULTS.with(|r| unsafe { (*r.get()).remove(&task_id) });
+    cancel_cond_waiter(task_id) as u8
+}
+
+/// Free a predicate created by `vpiml_native_cond_new`.
+#[unsafe(no_mangle)]
+pub extern "C" fn vpiml_native_cond_destroy(handle: NativeCondHandle) {
+    if !handle.is_null() {
+        drop(unsafe { Box::from_raw(handle) });
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_compile() {
+        // valid == 1 && ready == 1
+        let words = [0, 1, 1, 1, 0, 2, 1, 1, 2, 0, 0, 0];
+        assert_eq!(NativeCond::compile(&words).unwrap().ops.len(), 3);
+
+        // Missing operand / leftover operand / unknown opcode / null handle
+        assert!(NativeCond::compile(&[2, 0, 0, 0]).is_none());
+        assert!(NativeCond::compile(&[0, 1, 1, 1, 0, 2, 1, 1]).is_none());
+        assert!(NativeCond::compile(&[9, 1, 1, 1]).is_none());
+        assert!(NativeCond::compile(&[0, 0, 1, 1]).is_none());
+        assert!(NativeCond::compile(&[0, 1, 1]).is_none());
+    }
+}
@@ -0,0 +1,876 @@
+//! # Binary Transaction Trace Sink
+//!
+//! Scoreboards that log every transaction through `Logger` / `LuaDataBaseV2`
+//! format a string or bind a SQL row per transaction on the simulation thread.
+//! The trace sink keeps that thread down to one `memcpy` per record:
+//!
+//! ```text
+//!   simulation thread                         writer thread
+//!   ┌──────────────────────────┐   SPSC    ┌────────────────────────────────┐
+//!   │ schema:log(addr, id, len)│  ring of  │ split records per schema into  │
+//!   │  -> pack into FFI struct │ ───────>  │ columns, every CHUNK_ROWS rows │
+//!   │  -> verilua_trace_append │  records  │ LZ4-compress each column and   │
+//!   │     (memcpy into ring)   │           │ append a chunk to the file     │
+//!   └──────────────────────────┘           └────────────────────────────────┘
+//! ```
+//!
+//! Every schema is a list of fixed-size fields, so a record is a packed struct
+//! of `record_size` bytes plus a `u64` stamp (usually the cycle). When the ring
+//! is full the producer yields until the writer catches up; nothing is dropped.
+//!
+//! ## File format (little endian)
+//!
+//! ```text
+//!   file    := MAGIC block*
+//!   block   := BLOCK_SCHEMA id:u32 name:str field_num:u16 (name:str type:u8)*
+//!            | BLOCK_CHUNK  id:u32 row_num:u32 column_num:u16 (raw_len:u32 comp_len:u32 lz4_block)*
+//!   str     := len:u16 bytes
+//! ```
+//!
+//! Column 0 of a chunk holds the stamps (`u64`), column `i + 1` the values of
+//! field `i`. A schema block always precedes the first chunk of that schema.
+//! `TraceReader` (and `verilua.utils.TraceReader` on the Lua side) decodes the
+//! file chunk by chunk for offline conversion.
+
+use libc::c_char;
+use std::cell::UnsafeCell;
+use std::ffi::CString;
+use std::fs::File;
+use std::io::{self, BufReader, BufWriter, Read, Write};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex};
+use std::thread::JoinHandle;
+use std::time::Duration;
+
+use crate::utils;
+
+const MAGIC: &[u8; 8] = b"VLTRACE\x01";
+const BLOCK_SCHEMA: u8 = 1;
+const BLOCK_CHUNK: u8 = 2;
+
+/// `schema_id: u32`, `data_len: u32`, `stamp: u64`
+const RECORD_HEADER_SIZE: usize = 16;
+/// Rows per schema collected before a chunk is compressed and written
+const CHUNK_ROWS: usize = 8192;
+const DEFAULT_RING_SIZE: usize = 16 << 20;
+/// Writer thread sleep when the ring is empty
+const IDLE_SLEEP: Duration = Duration::from_micros(200);
+
+#[repr(u8)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum FieldType {
+    U8 = 0,
+    U16 = 1,
+    U32 = 2,
+    U64 = 3,
+    F64 = 4,
+}
+
+impl FieldType {
+    fn from_u8(v: u8) -> Option<Self> {
+        match v {
+            0 => Some(Self::U8),
+            1 => Some(Self::U16),
+            2 => Some(Self::U32),
+            3 => Some(Self::U64),
+            4 => Some(Self::F64),
+            _ => None,
+        }
+    }
+
+    fn size(self) -> usize {
+        match self {
+            Self::U8 => 1,
+            Self::U16 => 2,
+            Self::U32 => 4,
+            Self::U64 | Self::F64 => 8,
+        }
+    }
+}
+
+struct Schema {
+    name: String,
+    fields: Vec<(String, FieldType)>,
+}
+
+impl Schema {
+    fn record_size(&self) -> usize {
+        self.fields.iter().map(|(_, t)| t.size()).sum()
+    }
+}
+
+// ────────────────────────────────────────────────────────────────────────────────
+// SPSC byte ring
+// ────────────────────────────────────────────────────────────────────────────────
+
+struct Ring {
+    buf: UnsafeCell<Box<[u8]>>,
+    mask: usize,
+    /// Bytes published by the producer (monotonic)
+    head: AtomicUsize,
+    /// Bytes consumed by the writer thread (monotonic)
+    tail: AtomicUsize,
+    closed: AtomicBool,
+    /// Set by the writer thread when it stops on an error, nothing drains the ring anymore
+    failed: AtomicBool,
+}
+
+// The producer only writes `[tail + cap - (head - tail) ..)`, the consumer only
+// reads `[tail, head)`, the two regions never overlap.
+unsafe impl Sync for Ring {}
+unsafe impl Send for Ring {}
+
+impl Ring {
+    fn new(size: usize) -> Self {
+        let size = size.max(4096).next_power_of_two();
+        Self {
+            buf: UnsafeCell::new(vec![0u8; size].into_boxed_slice()),
+            mask: size - 1,
+            head: AtomicUsize::new(0),
+            tail: AtomicUsize::new(0),
+            closed: AtomicBool::new(false),
+            failed: AtomicBool::new(false),
+        }
+    }
+
+    #[inline(always)]
+    fn capacity(&self) -> usize {
+        self.mask + 1
+    }
+
+    #[inline(always)]
+    unsafe fn write_at(&self, pos: usize, src: &[u8]) {
+        let buf = unsafe { &mut *self.buf.get() };
+        let start = pos & self.mask;
+        let first = src.len().min(buf.len() - start);
+        buf[start..start + first].copy_from_slice(&src[..first]);
+        buf[..src.len() - first].copy_from_slice(&src[first..]);
+    }
+
+    #[inline(always)]
+    unsafe fn read_at(&self, pos: usize, dst: &mut [u8]) {
+        let buf = unsafe { &*self.buf.get() };
+        let start = pos & self.mask;
+        let first = dst.len().min(buf.len() - start);
+        let len = dst.len();
+        dst[..first].copy_from_slice(&buf[start..start + first]);
+        dst[first..].copy_from_slice(&buf[..len - first]);
+    }
+}
+
+// ────────────────────────────────────────────────────────────────────────────────
+// Writer
+// ────────────────────────────────────────────────────────────────────────────────
+
+fn compress_column(raw: &[u8]) -> Vec<u8> {
+    lz4_flex::block::compress(raw)
+}
+
+fn decompress_column(comp: &[u8], raw: &mut [u8]) -> io::Result<()> {
+    match lz4_flex::block::decompress_into(comp, raw) {
+        Ok(n) if n == raw.len() => Ok(()),
+        _ => Err(io::Error::new(
+            io::ErrorKind::InvalidData,
+            "corrupted trace column",
+        )),
+    }
+}
+
+fn write_str(out: &mut impl Write, s: &str) -> io::Result<()> {
+    out.write_all(&(s.len() as u16).to_le_bytes())?;
+    out.write_all(s.as_bytes())
+}
+
+/// Rows of one schema waiting to be written, one byte vector per column.
+struct ColumnChunk {
+    /// Byte offset of every field inside a record
+    field_offsets: Vec<(usize, usize)>,
+    stamps: Vec<u8>,
+    columns: Vec<Vec<u8>>,
+    rows: usize,
+    schema_written: bool,
+}
+
+impl ColumnChunk {
+    fn new(schema: &Schema) -> Self {
+        let mut offset = 0;
+        let field_offsets = schema
+            .fields
+            .iter()
+            .map(|(_, t)| {
+                let r = (offset, t.size());
+                offset += t.size();
+                r
+            })
+            .collect();
+
+        Self {
+            field_offsets,
+            stamps: Vec::with_capacity(CHUNK_ROWS * 8),
+            columns: schema
+                .fields
+                .iter()
+                .map(|(_, t)| Vec::with_capacity(CHUNK_ROWS * t.size()))
+                .collect(),
+            rows: 0,
+            schema_written: false,
+        }
+    }
+
+    fn push(&mut self, stamp: u64, data: &[u8]) {
+        self.stamps.extend_from_slice(&stamp.to_le_bytes());
+        for (column, &(offset, size)) in self.columns.iter_mut().zip(&self.field_offsets) {
+            column.extend_from_slice(&data[offset..offset + size]);
+        }
+        self.rows += 1;
+    }
+
+    fn write(&mut self, id: u32, schema: &Schema, out: &mut impl Write) -> io::Result<()> {
+        if !self.schema_written {
+            out.write_all(&[BLOCK_SCHEMA])?;
+            out.write_all(&id.to_le_bytes())?;
+            write_str(out, &schema.name)?;
+            out.write_all(&(schema.fields.len() as u16).to_le_bytes())?;
+            for (name, t) in &schema.fields {
+                write_str(out, name)?;
+                out.write_all(&[*t as u8])?;
+            }
+            self.schema_written = true;
+        }
+
+        if self.rows == 0 {
+            return Ok(());
+        }
+
+        out.write_all(&[BLOCK_CHUNK])?;
+        out.write_all(&id.to_le_bytes())?;
+        out.write_all(&(self.rows as u32).to_le_bytes())?;
+        out.write_all(&((self.columns.len() + 1) as u16).to_le_bytes())?;
+        for column in std::iter::once(&mut self.stamps).chain(self.columns.iter_mut()) {
+            let comp = compress_column(column);
+            out.write_all(&(column.len() as u32).to_le_bytes())?;
+            out.write_all(&(comp.len() as u32).to_le_bytes())?;
+            out.write_all(&comp)?;
+            column.clear();
+        }
+        self.rows = 0;
+        Ok(())
+    }
+}
+
+fn writer_loop(
+    ring: Arc<Ring>,
+    schemas: Arc<Mutex<Vec<Schema>>>,
+    mut out: BufWriter<File>,
+) -> io::Result<()> {
+    out.write_all(MAGIC)?;
+
+    let mut chunks: Vec<Option<ColumnChunk>> = Vec::new();
+    let mut header = [0u8; RECORD_HEADER_SIZE];
+    let mut data = Vec::new();
+    let mut tail = ring.tail.load(Ordering::Relaxed);
+
+    loop {
+        let closed = ring.closed.load(Ordering::Acquire);
+        let head = ring.head.load(Ordering::Acquire);
+        if head == tail {
+            if closed {
+                break;
+            }
+            std::thread::sleep(IDLE_SLEEP);
+            continue;
+        }
+
+        while tail != head {
+            unsafe { ring.read_at(tail, &mut header) };
+            let id = u32::from_le_bytes(header[0..4].try_into().unwrap());
+            let len = u32::from_le_bytes(header[4..8].try_into().unwrap()) as usize;
+            let stamp = u64::from_le_bytes(header[8..16].try_into().unwrap());
+
+            data.resize(len, 0);
+            unsafe { ring.read_at(tail + RECORD_HEADER_SIZE, &mut data) };
+            tail += RECORD_HEADER_SIZE + len;
+            ring.tail.store(tail, Ordering::Release);
+
+            let idx = id as usize;
+            if idx >= chunks.len() {
+                chunks.resize_with(idx + 1, || None);
+            }
+            // Schemas are registered before their first record, only looked up once
+            if chunks[idx].is_none() {
+                let schemas = schemas.lock().unwrap();
+                chunks[idx] = Some(ColumnChunk::new(&schemas[idx]));
+            }
+            let chunk = chunks[idx].as_mut().unwrap();
+
+            chunk.push(stamp, &data);
+            if chunk.rows >= CHUNK_ROWS {
+                let schemas = schemas.lock().unwrap();
+                chunk.write(id, &schemas[idx], &mut out)?;
+            }
+        }
+    }
+
+    let schemas = schemas.lock().unwrap();
+    for (idx, chunk) in chunks.iter_mut().enumerate() {
+        if let Some(chunk) = chunk {
+            chunk.write(idx as u32, &schemas[idx], &mut out)?;
+        }
+    }
+    out.flush()
+}
+
+pub struct TraceSink {
+    path: String,
+    ring: Arc<Ring>,
+    schemas: Arc<Mutex<Vec<Schema>>>,
+    /// Record size of every schema, read by the producer without locking
+    record_sizes: Vec<usize>,
+    writer: Option<JoinHandle<io::Result<()>>>,
+    records: u64,
+    /// Number of appends that had to wait for the writer thread
+    stalls: u64,
+}
+
+impl TraceSink {
+    pub fn open(path: &str, ring_size: usize) -> io::Result<Self> {
+        let out = BufWriter::with_capacity(1 << 20, File::create(path)?);
+        let ring = Arc::new(Ring::new(ring_size));
+        let schemas = Arc::new(Mutex::new(Vec::new()));
+
+        let writer = {
+            let ring = ring.clone();
+            let schemas = schemas.clone();
+            std::thread::Builder::new()
+                .name("verilua-trace".into())
+                .spawn(move || {
+                    let ret = writer_loop(ring.clone(), schemas, out);
+                    if ret.is_err() {
+                        ring.failed.store(true, Ordering::Release);
+                    }
+                    ret
+                })?
+        };
+
+        Ok(Self {
+            path: path.to_owned(),
+            ring,
+            schemas,
+            record_sizes: Vec::new(),
+            writer: Some(writer),
+            records: 0,
+            stalls: 0,
+        })
+    }
+
+    /// Register a schema, fails if one of its records (with header) cannot fit in the ring.
+    pub fn add_schema(&mut self, name: &str, fields: Vec<(String, FieldType)>) -> io::Result<u32> {
+        let schema = Schema {
+            name: name.to_owned(),
+            fields,
+        };
+        let record_size = schema.record_size();
+        if RECORD_HEADER_SIZE + record_size > self.ring.capacity() {
+            return Err(io::Error::other(format!(
+                "record of schema `{}` ({} bytes) does not fit in the {} bytes ring",
+                name,
+                record_size,
+                self.ring.capacity()
+            )));
+        }
+        self.record_sizes.push(record_size);
+
+        let mut schemas = self.schemas.lock().unwrap();
+        schemas.push(schema);
+        Ok((schemas.len() - 1) as u32)
+    }
+
+    /// Record size of schema `id`, None if it is not registered.
+    #[inline(always)]
+    pub fn record_size(&self, id: u32) -> Option<usize> {
+        self.record_sizes.get(id as usize).copied()
+    }
+
+    /// Copy one record into the ring, waiting for the writer thread if it is
+    /// full. Fails instead of waiting forever once the writer thread stopped on
+    /// an error. `data` must fit in the ring, which `add_schema` guarantees.
+    #[inline(always)]
+    pub fn append(&mut self, id: u32, stamp: u64, data: &[u8]) -> io::Result<()> {
+        let ring = &*self.ring;
+        let total = RECORD_HEADER_SIZE + data.len();
+        debug_assert!(total <= ring.capacity());
+        let head = ring.head.load(Ordering::Relaxed);
+
+        if ring.capacity() - (head - ring.tail.load(Ordering::Acquire)) < total {
+            self.stalls += 1;
+            while ring.capacity() - (head - ring.tail.load(Ordering::Acquire)) < total {
+                if ring.failed.load(Ordering::Acquire) {
+                    return Err(io::Error::other("trace writer thread stopped on an error"));
+                }
+                std::thread::yield_now();
+            }
+        }
+
+        let mut header = [0u8; RECORD_HEADER_SIZE];
+        header[0..4].copy_from_slice(&id.to_le_bytes());
+        header[4..8].copy_from_slice(&(data.len() as u32).to_le_bytes());
+        header[8..16].copy_from_slice(&stamp.to_le_bytes());
+        unsafe {
+            ring.write_at(head, &header);
+            ring.write_at(head + RECORD_HEADER_SIZE, data);
+        }
+        ring.head.store(head + total, Ordering::Release);
+        self.records += 1;
+        Ok(())
+    }
+
+    /// Drain the ring, write the remaining chunks and wait for the writer thread.
+    pub fn close(&mut self) -> io::Result<()> {
+        let Some(writer) = self.writer.take() else {
+            return Ok(());
+        };
+        self.ring.closed.store(true, Ordering::Release);
+        writer
+            .join()
+            .unwrap_or_else(|_| Err(io::Error::other("trace writer thread panicked")))
+    }
+}
+
+impl Drop for TraceSink {
+    fn drop(&mut self) {
+        let _ = self.close();
+    }
+}
+
+// ────────────────────────────────────────────────────────────────────────────────
+// Reader
+// ────────────────────────────────────────────────────────────────────────────────
+
+struct ReaderSchema {
+    name: CString,
+    fields: Vec<(CString, FieldType)>,
+}
+
+pub struct TraceReader {
+    input: BufReader<File>,
+    schemas: Vec<Option<ReaderSchema>>,
+    /// Rows of the current chunk
+    rows: u32,
+    /// Decompressed columns of the current chunk, column 0 = stamps
+    columns: Vec<Vec<u8>>,
+    comp: Vec<u8>,
+}
+
+fn read_u8(input: &mut impl Read) -> io::Result<u8> {
+    let mut b = [0u8; 1];
+    input.read_exact(&mut b)?;
+    Ok(b[0])
+}
+
+fn read_u16(input: &mut impl Read) -> io::Result<u16> {
+    let mut b = [0u8; 2];
+    input.read_exact(&mut b)?;
+    Ok(u16::from_le_bytes(b))
+}
+
+fn read_u32(input: &mut impl Read) -> io::Result<u32> {
+    let mut b = [0u8; 4];
+    input.read_exact(&mut b)?;
+    Ok(u32::from_le_bytes(b))
+}
+
+fn read_cstring(input: &mut impl Read) -> io::Result<CString> {
+    let mut s = vec![0u8; read_u16(input)? as usize];
+    input.read_exact(&mut s)?;
+    CString::new(s).map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))
+}
+
+impl TraceReader {
+    pub fn open(path: &str) -> io::Result<Self> {
+        let mut input = BufReader::with_capacity(1 << 20, File::open(path)?);
+        let mut magic = [0u8; 8];
+        input.read_exact(&mut magic)?;
+        if &magic != MAGIC {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidData,
+                "not a verilua trace file",
+            ));
+        }
+
+        Ok(Self {
+            input,
+            schemas: Vec::new(),
+            rows: 0,
+            columns: Vec::new(),
+            comp: Vec::new(),
+        })
+    }
+
+    /// Decode the next chunk, returns its schema id or `None` at the end of the file.
+    pub fn next_chunk(&mut self) -> io::Result<Option<u32>> {
+        loop {
+            let kind = match read_u8(&mut self.input) {
+                Ok(kind) => kind,
+                Err(e) if e.kind() == io::ErrorKind::UnexpectedEof => return Ok(None),
+                Err(e) => return Err(e),
+            };
+            let id = read_u32(&mut self.input)?;
+
+            match kind {
+                BLOCK_SCHEMA => {
+                    let name = read_cstring(&mut self.input)?;
+                    let field_num = read_u16(&mut self.input)?;
+                    let mut fields = Vec::with_capacity(field_num as usize);
+                    for _ in 0..field_num {
+                        let field_name = read_cstring(&mut self.input)?;
+                        let t = FieldType::from_u8(read_u8(&mut self.input)?).ok_or_else(|| {
+                            io::Error::new(io::ErrorKind::InvalidData, "unknown field type")
+                        })?;
+                        fields.push((field_name, t));
+                    }
+
+                    let idx = id as usize;
+                    if idx >= self.schemas.len() {
+                        self.schemas.resize_with(idx + 1, || None);
+                    }
+                    self.schemas[idx] = Some(ReaderSchema { name, fields });
+                }
+                BLOCK_CHUNK => {
+                    self.rows = read_u32(&mut self.input)?;
+                    let column_num = read_u16(&mut self.input)? as usize;
+                    self.columns.resize_with(column_num, Vec::new);
+                    for column in self.columns.iter_mut() {
+                        let raw_len = read_u32(&mut self.input)? as usize;
+                        let comp_len = read_u32(&mut self.input)? as usize;
+                        self.comp.resize(comp_len, 0);
+                        self.input.read_exact(&mut self.comp)?;
+                        column.resize(raw_len, 0);
+                        decompress_column(&self.comp, column)?;
+                    }
+                    return Ok(Some(id));
+                }
+                _ => {
+                    return Err(io::Error::new(
+                        io::ErrorKind::InvalidData,
+                        format!("unknown trace block kind: {}", kind),
+                    ));
+                }
+            }
+        }
+    }
+
+    fn schema(&self, id: u32) -> Option<&ReaderSchema> {
+        self.schemas.get(id as usize).and_then(|s| s.as_ref())
+    }
+}
+
+// ────────────────────────────────────────────────────────────────────────────────
+// FFI
+// ────────────────────────────────────────────────────────────────────────────────
+
+/// Create `path` and start the writer thread. `ring_size` is in bytes (0: 16 MiB).
+/// Returns null if the file cannot be created.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_open(path: *const c_char, ring_size: u64) -> *mut TraceSink {
+    let path = unsafe { utils::c_char_to_str(path) };
+    let ring_size = if ring_size == 0 {
+        DEFAULT_RING_SIZE
+    } else {
+        ring_size as usize
+    };
+
+    match TraceSink::open(path, ring_size) {
+        Ok(sink) => Box::into_raw(Box::new(sink)),
+        Err(e) => {
+            log::error!("[verilua_trace_open] cannot open `{}`: {}", path, e);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Register a schema of `field_num` fields, returns its id, or -1 if a field
+/// type is invalid or a record does not fit in the ring.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_add_schema(
+    sink: *mut TraceSink,
+    name: *const c_char,
+    field_names: *const *const c_char,
+    field_types: *const u8,
+    field_num: u32,
+) -> i32 {
+    assert!(
+        !sink.is_null(),
+        "[verilua_trace_add_schema] invalid TraceSink"
+    );
+    let sink = unsafe { &mut *sink };
+    let name = unsafe { utils::c_char_to_str(name) };
+
+    let mut fields = Vec::with_capacity(field_num as usize);
+    for i in 0..field_num as usize {
+        let field_name = unsafe { utils::c_char_to_string(*field_names.add(i)) };
+        let Some(t) = FieldType::from_u8(unsafe { *field_types.add(i) }) else {
+            return -1;
+        };
+        fields.push((field_name, t));
+    }
+
+    match sink.add_schema(name, fields) {
+        Ok(id) => id as i32,
+        Err(e) => {
+            log::error!("[verilua_trace_add_schema] {}: {}", sink.path, e);
+            -1
+        }
+    }
+}
+
+/// Append one record of schema `id`, `data` points to `record_size` bytes.
+/// Returns 0, -1 if `id` is not a registered schema, -2 if the writer thread
+/// stopped on an error (the record is lost, `verilua_trace_close` reports it).
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_append(
+    sink: *mut TraceSink,
+    id: u32,
+    stamp: u64,
+    data: *const u8,
+) -> i32 {
+    let sink = unsafe { &mut *sink };
+    let Some(len) = sink.record_size(id) else {
+        log::error!("[verilua_trace_append] {}: unknown schema id {}", sink.path, id);
+        return -1;
+    };
+    let data = unsafe { std::slice::from_raw_parts(data, len) };
+    match sink.append(id, stamp, data) {
+        Ok(()) => 0,
+        Err(e) => {
+            log::error!("[verilua_trace_append] {}: {}", sink.path, e);
+            -2
+        }
+    }
+}
+
+/// Flush everything, stop the writer thread and free the sink. Returns false
+/// if writing the file failed.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_close(sink: *mut TraceSink) -> bool {
+    if sink.is_null() {
+        return true;
+    }
+    let mut sink = unsafe { Box::from_raw(sink) };
+    match sink.close() {
+        Ok(()) => {
+            log::info!(
+                "[verilua_trace_close] {}: {} records, {} stalls",
+                sink.path,
+                sink.records,
+                sink.stalls
+            );
+            true
+        }
+        Err(e) => {
+            log::error!("[verilua_trace_close] {}: {}", sink.path, e);
+            false
+        }
+    }
+}
+
+/// Open a trace file for reading, returns null if it is not a trace file.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_reader_open(path: *const c_char) -> *mut TraceReader {
+    let path = unsafe { utils::c_char_to_str(path) };
+    match TraceReader::open(path) {
+        Ok(reader) => Box::into_raw(Box::new(reader)),
+        Err(e) => {
+            log::error!("[verilua_trace_reader_open] cannot open `{}`: {}", path, e);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Decode the next chunk, returns its schema id, -1 at the end of the file and
+/// -2 on a corrupted file.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_reader_next_chunk(reader: *mut TraceReader) -> i64 {
+    let reader = unsafe { &mut *reader };
+    match reader.next_chunk() {
+        Ok(Some(id)) => id as i64,
+        Ok(None) => -1,
+        Err(e) => {
+            log::error!("[verilua_trace_reader_next_chunk] {}", e);
+            -2
+        }
+    }
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_reader_schema_name(
+    reader: *mut TraceReader,
+    id: u32,
+) -> *const c_char {
+    let reader = unsafe { &*reader };
+    reader
+        .schema(id)
+        .map_or(std::ptr::null(), |s| s.name.as_ptr())
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_reader_field_num(reader: *mut TraceReader, id: u32) -> u32 {
+    let reader = unsafe { &*reader };
+    reader.schema(id).map_or(0, |s| s.fields.len() as u32)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_reader_field_name(
+    reader: *mut TraceReader,
+    id: u32,
+    idx: u32,
+) -> *const c_char {
+    let reader = unsafe { &*reader };
+    reader
+        .schema(id)
+        .and_then(|s| s.fields.get(idx as usize))
+        .map_or(std::ptr::null(), |(name, _)| name.as_ptr())
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_reader_field_type(
+    reader: *mut TraceReader,
+    id: u32,
+    idx: u32,
+) -> u8 {
+    let reader = unsafe { &*reader };
+    reader
+        .schema(id)
+        .and_then(|s| s.fields.get(idx as usize))
+        .map_or(u8::MAX, |(_, t)| *t as u8)
+}
+
+/// Number of rows of the current chunk.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_reader_row_num(reader: *mut TraceReader) -> u32 {
+    unsafe { (*reader).rows }
+}
+
+/// Column `idx` of the current chunk (0: stamps as `u64`, `i + 1`: field `i`).
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_reader_column(
+    reader: *mut TraceReader,
+    idx: u32,
+) -> *const u8 {
+    let reader = unsafe { &*reader };
+    reader
+        .columns
+        .get(idx as usize)
+        .map_or(std::ptr::null(), |c| c.as_ptr())
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_trace_reader_close(reader: *mut TraceReader) {
+    if !reader.is_null() {
+        drop(unsafe { Box::from_raw(reader) });
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_round_trip() {
+        let path = std::env::temp_dir().join(format!("verilua_trace_{}.vltr", std::process::id()));
+        let path = path.to_str().unwrap();
+
+        // Small ring: forces wrap-around and producer stalls
+        let mut sink = TraceSink::open(path, 4096).unwrap();
+        let a = sink
+            .add_schema(
+                "a",
+                vec![
+                    ("addr".into(), FieldType::U64),
+                    ("id".into(), FieldType::U8),
+                ],
+            )
+            .unwrap();
+        let b = sink
+            .add_schema("b", vec![("data".into(), FieldType::U32)])
+            .unwrap();
+
+        let n = CHUNK_ROWS as u64 * 2 + 17;
+        for i in 0..n {
+            let mut rec = [0u8; 9];
+            rec[..8].copy_from_slice(&(i * 3).to_le_bytes());
+            rec[8] = i as u8;
+            sink.append(a, i, &rec).unwrap();
+            if i % 2 == 0 {
+                sink.append(b, i, &(i as u32).to_le_bytes()).unwrap();
+            }
+        }
+        sink.close().unwrap();
+
+        let mut reader = TraceReader::open(path).unwrap();
+        let (mut rows_a, mut rows_b) = (0u64, 0u64);
+        while let Some(id) = reader.next_chunk().unwrap() {
+            let stamps = &reader.columns[0];
+            for r in 0..reader.rows as usize {
+                let stamp = u64::from_le_bytes(stamps[r * 8..r * 8 + 8].try_into().unwrap());
+                if id == a {
+                    let addr =
+                        u64::from_le_bytes(reader.columns[1][r * 8..r * 8 + 8].try_into().unwrap());
+                    assert_eq!(stamp, rows_a);
+                    assert_eq!(addr, stamp * 3);
+                    assert_eq!(reader.columns[2][r], stamp as u8);
+                    rows_a += 1;
+                } else {
+                    let data =
+                        u32::from_le_bytes(reader.columns[1][r * 4..r * 4 + 4].try_into().unwrap());
+                    assert_eq!(stamp, rows_b * 2);
+                    assert_eq!(data as u64, stamp);
+                    rows_b += 1;
+                }
+            }
+        }
+        assert_eq!(rows_a, n);
+        assert_eq!(rows_b, n.div_ceil(2));
+        assert_eq!(reader.schema(a).unwrap().name.to_str().unwrap(), "a");
+        assert_eq!(reader.schema(b).unwrap().fields.len(), 1);
+
+        std::fs::remove_file(path).unwrap();
+    }
+
+    #[test]
+    fn test_oversized_schema_rejected() {
+        let path = std::env::temp_dir().join(format!("verilua_trace_big_{}.vltr", std::process::id()));
+        let path = path.to_str().unwrap();
+
+        let mut sink = TraceSink::open(path, 4096).unwrap();
+        let fields = (0..600)
+            .map(|i| (format!("f{i}"), FieldType::U64))
+            .collect::<Vec<_>>();
+        assert!(sink.add_schema("big", fields).is_err());
+        assert_eq!(sink.record_size(0), None);
+        sink.close().unwrap();
+
+        std::fs::remove_file(path).unwrap();
+    }
+
+    #[test]
+    fn test_append_fails_after_writer_error() {
+        // Every write to /dev/full fails with ENOSPC: the writer thread stops on
+        // its first flush and the producer must not wait for it forever.
+        let mut sink = TraceSink::open("/dev/full", 4096).unwrap();
+        let a = sink
+            .add_schema("a", vec![("data".into(), FieldType::U64)])
+            .unwrap();
+
+        let mut failed = false;
+        for i in 0..50_000_000u64 {
+            // Not compressible, fills the 1 MiB output buffer quickly
+            let v = i.wrapping_mul(0x9E37_79B9_7F4A_7C15);
+            if sink.append(a, v, &v.to_le_bytes()).is_err() {
+                failed = true;
+                break;
+            }
+        }
+        assert!(failed);
+        assert!(sink.close().is_err());
+    }
+}
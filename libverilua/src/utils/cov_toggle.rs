@@ -0,0 +1,91 @@
+//! DPI sink used by `cov_exporter --packed-toggle` instrumentation.
+//!
+//! Every instrumented module imports `vl_cov_toggle_copy` and calls it from
+//! its exported `getToggleBitmap` / `getToggleCounters` functions with an
+//! open array of 32-bit words. The words are copied verbatim into the caller
+//! buffer (`dst`) handed down from Lua (`CoverageGetter`), so reading the
+//! toggle state of a whole module instance is a single DPI call.
+//!
+//! The `svdpi` accessors are resolved lazily with `dlsym` so that builds that
+//! never run packed instrumentation (wave_vpi, nosim, ...) do not require the
+//! simulator to provide them.
+
+use libc::{c_char, c_int, c_void};
+use once_cell::sync::OnceCell;
+
+type SvGetArrayPtr = unsafe extern "C" fn(*const c_void) -> *mut c_void;
+type SvSize = unsafe extern "C" fn(*const c_void, c_int) -> c_int;
+type SvGetBitArrElem1VecVal = unsafe extern "C" fn(*mut u32, *const c_void, c_int);
+
+struct SvOpenArrayApi {
+    get_array_ptr: Option<SvGetArrayPtr>,
+    size: SvSize,
+    low: SvSize,
+    get_elem: SvGetBitArrElem1VecVal,
+}
+
+static SV_OPEN_ARRAY_API: OnceCell<SvOpenArrayApi> = OnceCell::new();
+
+unsafe fn lookup(name: &'static [u8]) -> *mut c_void {
+    unsafe { libc::dlsym(libc::RTLD_DEFAULT, name.as_ptr() as *const c_char) }
+}
+
+fn sv_open_array_api() -> &'static SvOpenArrayApi {
+    SV_OPEN_ARRAY_API.get_or_init(|| unsafe {
+        let get_array_ptr = lookup(b"svGetArrayPtr\0");
+        let size = lookup(b"svSize\0");
+        let low = lookup(b"svLow\0");
+        let get_elem = lookup(b"svGetBitArrElem1VecVal\0");
+        assert!(
+            !size.is_null() && !low.is_null() && !get_elem.is_null(),
+            "[vl_cov_toggle_copy] svdpi open array functions are not available in this simulator"
+        );
+
+        SvOpenArrayApi {
+            get_array_ptr: if get_array_ptr.is_null() {
+                None
+            } else {
+                Some(std::mem::transmute::<*mut c_void, SvGetArrayPtr>(
+                    get_array_ptr,
+                ))
+            },
+            size: std::mem::transmute::<*mut c_void, SvSize>(size),
+            low: std::mem::transmute::<*mut c_void, SvSize>(low),
+            get_elem: std::mem::transmute::<*mut c_void, SvGetBitArrElem1VecVal>(get_elem),
+        }
+    })
+}
+
+/// Copy an open array of `bit [31:0]` words into `dst`.
+///
+/// # Arguments
+/// * `dst` - Caller buffer with room for at least `svSize(words, 1)` u32 words
+/// * `words` - `svOpenArrayHandle` of `input bit [31:0] words[]`
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn vl_cov_toggle_copy(dst: *mut c_void, words: *const c_void) {
+    if dst.is_null() || words.is_null() {
+        return;
+    }
+
+    let api = sv_open_array_api();
+    let n = unsafe { (api.size)(words, 1) };
+    if n <= 0 {
+        return;
+    }
+
+    let dst = dst as *mut u32;
+
+    // Fast path: the simulator stores the unpacked array contiguously.
+    if let Some(get_array_ptr) = api.get_array_ptr {
+        let src = unsafe { get_array_ptr(words) } as *const u32;
+        if !src.is_null() {
+            unsafe { std::ptr::copy_nonoverlapping(src, dst, n as usize) };
+            return;
+        }
+    }
+
+    let low = unsafe { (api.low)(words, 1) };
+    for i in 0..n {
+        unsafe { (api.get_elem)(dst.add(i as usize), words, low + i) };
+    }
+}
@@ -4,6 +4,8 @@
 //! helper routines used throughout the Verilua codebase.
 
 pub mod bundle_crypto;
+pub mod cov_toggle;
+pub mod str_to_vec;
 
 use fslock::LockFile;
 use goblin::elf::Elf;
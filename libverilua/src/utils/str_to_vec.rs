@@ -0,0 +1,250 @@
+//! Decoding of hex / bin / oct / dec value strings into `t_vpi_vecval` words.
+//!
+//! `set` with a string value decodes the string right away into the handle's
+//! `put_value_vectors`, so the pending put is flushed as a plain `vpiVectorVal`
+//! (no `CString`, no string parsing inside the simulator). Strings that cannot
+//! be represented as 2-state words (`x` / `z` digits, signs, separators) are
+//! rejected and keep going through the string formats.
+//!
+//! Hex and bin digits are converted 8 characters at a time (SWAR on a `u64`),
+//! which is the common case for wide values pushed by drivers.
+//!
+//! Words are filled LSB first. Digits beyond the given words are dropped (same
+//! truncation as `vpi_put_value`), missing high words are zeroed.
+
+use crate::vpi_user::*;
+
+const ONES: u64 = 0x0101_0101_0101_0101;
+const HIGHS: u64 = 0x8080_8080_8080_8080;
+
+/// High bit of every byte of `x` that lies strictly between `lo` and `hi`.
+/// Only valid if every byte of `x` is below 0x80.
+#[inline(always)]
+const fn bytes_between(x: u64, lo: u64, hi: u64) -> u64 {
+    (ONES * (127 + hi) - x) & !x & (x + ONES * (127 - lo)) & HIGHS
+}
+
+/// 8 hex characters (first character = most significant) to their value.
+#[inline(always)]
+fn hex8_to_u32(chunk: [u8; 8]) -> Option<u32> {
+    let x = u64::from_be_bytes(chunk);
+    if x & HIGHS != 0 {
+        return None;
+    }
+
+    let digit = bytes_between(x, b'0' as u64 - 1, b'9' as u64 + 1);
+    let letter = bytes_between(x | (ONES * 0x20), b'a' as u64 - 1, b'f' as u64 + 1);
+    if digit | letter != HIGHS {
+        return None;
+    }
+
+    // '0'..'9' => 0..9, 'a'..'f' / 'A'..'F' => 1..6 + 9
+    let mut v = (x & (ONES * 0x0F)) + (letter >> 7) * 9;
+    v = (v | (v >> 4)) & 0x00FF_00FF_00FF_00FF;
+    v = (v | (v >> 8)) & 0x0000_FFFF_0000_FFFF;
+    v = (v | (v >> 16)) & 0x0000_0000_FFFF_FFFF;
+    Some(v as u32)
+}
+
+/// 8 binary characters (first character = most significant) to their value.
+#[inline(always)]
+fn bin8_to_u8(chunk: [u8; 8]) -> Option<u8> {
+    let x = u64::from_be_bytes(chunk);
+    if x & !ONES != ONES * b'0' as u64 {
+        return None;
+    }
+
+    // Gather the low bit of every byte into the top byte, byte 7 (first
+    // character) ends up as the most significant bit.
+    Some((((x & ONES).wrapping_mul(0x0102_0408_1020_4080)) >> 56) as u8)
+}
+
+#[inline(always)]
+fn hex_digit(c: u8) -> Option<u32> {
+    match c {
+        b'0'..=b'9' => Some((c - b'0') as u32),
+        b'a'..=b'f' => Some((c - b'a' + 10) as u32),
+        b'A'..=b'F' => Some((c - b'A' + 10) as u32),
+        _ => None,
+    }
+}
+
+#[inline(always)]
+fn clear(words: &mut [t_vpi_vecval]) {
+    for w in words.iter_mut() {
+        w.aval = 0;
+        w.bval = 0;
+    }
+}
+
+fn decode_hex(s: &[u8], words: &mut [t_vpi_vecval]) -> bool {
+    clear(words);
+
+    let mut end = s.len();
+    for word in words.iter_mut() {
+        if end == 0 {
+            break;
+        }
+
+        let start = end.saturating_sub(8);
+        let value = if end - start == 8 {
+            hex8_to_u32(s[start..end].try_into().unwrap())
+        } else {
+            s[start..end]
+                .iter()
+                .try_fold(0u32, |acc, c| Some((acc << 4) | hex_digit(*c)?))
+        };
+
+        let Some(value) = value else {
+            return false;
+        };
+        word.aval = value as _;
+        end = start;
+    }
+
+    // Truncated digits must still be valid
+    s[..end].iter().all(|c| hex_digit(*c).is_some())
+}
+
+fn decode_bin(s: &[u8], words: &mut [t_vpi_vecval]) -> bool {
+    clear(words);
+
+    let mut end = s.len();
+    for word in words.iter_mut() {
+        let mut value = 0u32;
+        let mut shift = 0;
+        while shift < 32 && end > 0 {
+            if end >= 8 && shift <= 24 {
+                let Some(byte) = bin8_to_u8(s[end - 8..end].try_into().unwrap()) else {
+                    return false;
+                };
+                value |= (byte as u32) << shift;
+                shift += 8;
+                end -= 8;
+            } else {
+                match s[end - 1] {
+                    b'0' => {}
+                    b'1' => value |= 1 << shift,
+                    _ => return false,
+                }
+                shift += 1;
+                end -= 1;
+            }
+        }
+        word.aval = value as _;
+    }
+
+    s[..end].iter().all(|c| *c == b'0' || *c == b'1')
+}
+
+fn decode_oct(s: &[u8], words: &mut [t_vpi_vecval]) -> bool {
+    clear(words);
+
+    let total_bits = words.len() * 32;
+    for (i, c) in s.iter().rev().enumerate() {
+        let digit = match c {
+            b'0'..=b'7' => (c - b'0') as u32,
+            _ => return false,
+        };
+        for b in 0..3 {
+            let bit = i * 3 + b;
+            if bit < total_bits && (digit >> b) & 1 != 0 {
+                words[bit / 32].aval |= (1 << (bit % 32)) as PLI_INT32;
+            }
+        }
+    }
+    true
+}
+
+fn decode_dec(s: &[u8], words: &mut [t_vpi_vecval]) -> bool {
+    clear(words);
+
+    // value = value * 10^n + chunk, 9 digits (< 2^32) at a time
+    for chunk in s.chunks(9) {
+        let mut mul = 1u64;
+        let mut add = 0u64;
+        for c in chunk {
+            if !c.is_ascii_digit() {
+                return false;
+            }
+            mul *= 10;
+            add = add * 10 + (c - b'0') as u64;
+        }
+
+        let mut carry = add;
+        for word in words.iter_mut() {
+            let v = (word.aval as u32) as u64 * mul + carry;
+            word.aval = v as u32 as _;
+            carry = v >> 32;
+        }
+    }
+    true
+}
+
+/// Decode `s` (without `0x` / `0b` prefix) in `format` into `words`. Returns
+/// false, leaving `words` unspecified, if the string is not a plain 2-state
+/// number in that format.
+pub fn decode_str_to_vecval(format: u32, s: &[u8], words: &mut [t_vpi_vecval]) -> bool {
+    if s.is_empty() || words.is_empty() {
+        return false;
+    }
+
+    match format {
+        vpiHexStrVal => decode_hex(s, words),
+        vpiBinStrVal => decode_bin(s, words),
+        vpiOctStrVal => decode_oct(s, words),
+        vpiDecStrVal => decode_dec(s, words),
+        _ => false,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn decode(format: u32, s: &str, n: usize) -> Option<Vec<u32>> {
+        let mut words = vec![t_vpi_vecval { aval: 0, bval: 0 }; n];
+        decode_str_to_vecval(format, s.as_bytes(), &mut words)
+            .then(|| words.iter().map(|w| w.aval as u32).collect())
+    }
+
+    #[test]
+    fn test_hex() {
+        assert_eq!(decode(vpiHexStrVal, "1", 1), Some(vec![1]));
+        assert_eq!(decode(vpiHexStrVal, "DeadBeef", 1), Some(vec![0xdeadbeef]));
+        assert_eq!(
+            decode(vpiHexStrVal, "123456789abcdef0f", 3),
+            Some(vec![0xabcdef0f, 0x23456789, 0x1])
+        );
+        // Truncated to the available words
+        assert_eq!(decode(vpiHexStrVal, "ff00000001", 1), Some(vec![1]));
+        assert_eq!(decode(vpiHexStrVal, "0123456x", 1), None);
+        assert_eq!(decode(vpiHexStrVal, "x0000000", 2), None);
+        assert_eq!(decode(vpiHexStrVal, "g", 1), None);
+        assert_eq!(decode(vpiHexStrVal, "zz00000001", 1), None);
+    }
+
+    #[test]
+    fn test_bin() {
+        assert_eq!(decode(vpiBinStrVal, "101", 1), Some(vec![5]));
+        assert_eq!(decode(vpiBinStrVal, "10000000", 1), Some(vec![0x80]));
+        assert_eq!(
+            decode(vpiBinStrVal, &format!("11{}", "01".repeat(16)), 2),
+            Some(vec![0x55555555, 3])
+        );
+        assert_eq!(decode(vpiBinStrVal, "1x01", 1), None);
+        assert_eq!(decode(vpiBinStrVal, "0000000z", 1), None);
+    }
+
+    #[test]
+    fn test_oct_dec() {
+        assert_eq!(decode(vpiOctStrVal, "777", 1), Some(vec![0o777]));
+        assert_eq!(decode(vpiOctStrVal, "8", 1), None);
+        assert_eq!(decode(vpiDecStrVal, "4294967295", 1), Some(vec![u32::MAX]));
+        assert_eq!(
+            decode(vpiDecStrVal, "18446744073709551616", 3),
+            Some(vec![0, 0, 1])
+        );
+        assert_eq!(decode(vpiDecStrVal, "-1", 1), None);
+    }
+}
@@ -68,7 +68,7 @@ use hashbrown::HashMap;
 use mlua::ffi;
 use mlua::prelude::*;
 use std::cell::UnsafeCell;
-use std::ffi::{CStr, CString};
+use std::ffi::CStr;
 use std::time::{Duration, Instant};
 
 #[allow(unused_imports)]
@@ -256,6 +256,7 @@ impl VeriluaEnv {
         log_feature!("opt_cb_task");
         log_feature!("merge_cb");
         log_feature!("chunk_task");
+        log_feature!("edge_waiter");
 
         #[cfg(feature = "verilator_inner_step_callback")]
         {
@@ -414,6 +415,8 @@ impl VeriluaEnv {
             panic!("Error calling finish_callback: {err}");
         }
 
+        crate::access_profile::flush();
+
         let total_time = self.start_time.elapsed();
 
         use tabled::{
@@ -507,10 +510,6 @@ impl VeriluaEnv {
         hdl_put_value.iter_mut().for_each(|complex_handle_raw| {
             let complex_handle = ComplexHandle::from_raw(complex_handle_raw);
 
-            // Guard: keeps CString alive until after vpi_put_value returns.
-            #[allow(unused_assignments)]
-            let mut cstr_guard: Option<CString> = None;
-
             let mut v = match complex_handle.put_value_format {
                 vpiIntVal => s_vpi_value {
                     format: vpiIntVal as _,
@@ -524,15 +523,14 @@ impl VeriluaEnv {
                         vector: complex_handle.put_value_vectors.as_mut_ptr(),
                     },
                 },
-                vpiHexStrVal | vpiDecStrVal | vpiOctStrVal | vpiBinStrVal => {
-                    cstr_guard = Some(CString::new(complex_handle.put_value_str.as_str()).unwrap());
-                    s_vpi_value {
-                        format: complex_handle.put_value_format as _,
-                        value: t_vpi_value__bindgen_ty_1 {
-                            str_: cstr_guard.as_ref().unwrap().as_ptr() as _,
-                        },
-                    }
-                }
+                // Only strings that `set_put_value_str` could not decode into
+                // `put_value_vectors` (already NUL-terminated)
+                vpiHexStrVal | vpiDecStrVal | vpiOctStrVal | vpiBinStrVal => s_vpi_value {
+                    format: complex_handle.put_value_format as _,
+                    value: t_vpi_value__bindgen_ty_1 {
+                        str_: complex_handle.put_value_str.as_mut_ptr() as _,
+                    },
+                },
                 vpiSuppressVal => s_vpi_value {
                     format: vpiSuppressVal as _,
                     value: t_vpi_value__bindgen_ty_1 {
@@ -551,14 +549,8 @@ impl VeriluaEnv {
                 ),
             };
 
-            unsafe {
-                vpi_put_value(
-                    complex_handle.vpi_handle,
-                    &mut v as *mut _,
-                    std::ptr::null_mut(),
-                    complex_handle.put_value_flag.take().unwrap_unchecked() as _,
-                )
-            };
+            let flag = unsafe { complex_handle.put_value_flag.take().unwrap_unchecked() };
+            complex_handle.put_value_now(&mut v, flag);
         });
 
         hdl_put_value.clear();
@@ -733,3 +725,109 @@ gen_verilua_step_safe!(
     lua_negedge_step,
     "verilua_negedge_step()"
 );
+
+// ----------------------------------------------------------------------------------------------------------
+//  Per clock domain step hooks.
+//  `testbench_gen --clock-domain <clock>:<period>[:<phase>] --domain-step` generates
+//      `always @(posedge <clock>) verilua_domain_step[_safe](<domain_id>, "<clock>");`
+//  in tb_top for every extra clock domain. The clock port name is only handed to Lua the first time a
+//  domain id is seen, so that `verilua.register_domain_step(<clock>, func)` can be bound to the id; every
+//  later edge is a plain `lua_domain_step(domain_id)` call.
+// ----------------------------------------------------------------------------------------------------------
+thread_local! {
+    static LUA_DOMAIN_STEP: UnsafeCell<Option<LuaFunction>> = const { UnsafeCell::new(None) };
+    static DOMAIN_BOUND: UnsafeCell<Vec<bool>> = const { UnsafeCell::new(Vec::new()) };
+}
+
+fn call_lua_domain_step(
+    env: &VeriluaEnv,
+    domain_id: libc::c_int,
+    name: *const libc::c_char,
+) -> LuaResult<()> {
+    let id = domain_id as usize;
+    let first_call = DOMAIN_BOUND.with(|bound| {
+        let bound = unsafe { &mut *bound.get() };
+        if bound.len() <= id {
+            bound.resize(id + 1, false);
+        }
+        !std::mem::replace(&mut bound[id], true)
+    });
+
+    LUA_DOMAIN_STEP.with(|f| {
+        let func = unsafe { &mut *f.get() }.get_or_insert_with(|| {
+            env.lua
+                .globals()
+                .get("lua_domain_step")
+                .expect("Failed to load lua_domain_step")
+        });
+
+        if first_call && !name.is_null() {
+            func.call::<()>((domain_id, unsafe { crate::utils::c_char_to_str(name) }))
+        } else {
+            func.call::<()>(domain_id)
+        }
+    })
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_domain_step(domain_id: libc::c_int, name: *const libc::c_char) {
+    let env = get_verilua_env();
+    assert!(
+        env.initialized,
+        "verilua_domain_step() called before verilua_init()"
+    );
+
+    let s = env.acc_lua_time.then(Instant::now);
+
+    if let Err(e) = call_lua_domain_step(env, domain_id, name) {
+        panic!("Error calling lua_domain_step({domain_id}): {e}");
+    };
+
+    if let Some(s) = s {
+        env.lua_time += s.elapsed();
+    }
+
+    env.apply_pending_put_values();
+}
+
+// Same as verilua_domain_step() while error will not cause the program to crash
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn verilua_domain_step_safe(
+    domain_id: libc::c_int,
+    name: *const libc::c_char,
+) {
+    thread_local! {
+        static HAS_ERROR: UnsafeCell<bool> = const { UnsafeCell::new(false) };
+    }
+
+    if HAS_ERROR.with(|has_error| unsafe { *has_error.get() }) {
+        let env = get_verilua_env();
+        env.finalize();
+
+        log::warn!(
+            "[verilua_domain_step_safe] `has_error` is `true`! Program should be terminated! Nothing will be done in `Verilua`..."
+        );
+        return;
+    }
+
+    let env = get_verilua_env();
+    assert!(
+        env.initialized,
+        "[verilua_domain_step_safe] verilua_domain_step_safe() called before verilua_init()"
+    );
+
+    let s = env.acc_lua_time.then(Instant::now);
+
+    if let Err(e) = call_lua_domain_step(env, domain_id, name) {
+        HAS_ERROR.with(|has_error| unsafe {
+            *has_error.get() = true;
+        });
+        println!("[verilua_domain_step_safe] Error calling lua_domain_step({domain_id}): {e}");
+    };
+
+    if let Some(s) = s {
+        env.lua_time += s.elapsed();
+    }
+
+    env.apply_pending_put_values();
+}
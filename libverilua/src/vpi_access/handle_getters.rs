@@ -18,6 +18,9 @@ impl VeriluaEnv {
             log::debug!("[complex_handle_by_name] miss cache => {}", name_str);
 
             let vpi_handle = unsafe { vpi_handle_by_name(name, scope) };
+            if access_profile::enabled() {
+                access_profile::record_handle(&name_str, vpi_handle);
+            }
             let width = if vpi_handle.is_null() {
                 log::info!(
                     "[complex_handle_by_name] vpiHandle for `{}` is NULL! width => 0",
@@ -31,6 +34,10 @@ impl VeriluaEnv {
             let owned_name = std::ffi::CString::new(name_str.as_str()).unwrap();
             let mut chdl = ComplexHandle::new(vpi_handle, owned_name.into_raw(), width as _);
             chdl.env = self.as_void_ptr();
+            if cfg!(feature = "verilator") && !vpi_handle.is_null() {
+                chdl.direct = crate::direct_access::lookup(&name_str)
+                    .filter(|direct| direct.width as usize == chdl.width);
+            }
 
             let chdl_ptr = chdl.into_raw();
             self.hdl_cache.insert(name_str, chdl_ptr);
@@ -2,6 +2,7 @@
 use libc::{c_char, c_longlong, c_void};
 use std::ffi::{CStr, CString};
 
+use crate::access_profile;
 use crate::complex_handle::{
     ComplexHandle, ComplexHandleRaw, ShuffledValueVec, ShuffledValueVecType,
 };
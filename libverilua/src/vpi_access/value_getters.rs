@@ -56,6 +56,12 @@ impl VeriluaEnv {
     #[inline(always)]
     pub fn vpiml_get_value(&mut self, complex_handle_raw: ComplexHandleRaw) -> u32 {
         let complex_handle = ComplexHandle::from_raw(&complex_handle_raw);
+        if cfg!(feature = "verilator")
+            && let Some(direct) = complex_handle.direct
+        {
+            return direct.read_word(0);
+        }
+
         let mut v = s_vpi_value {
             format: vpiIntVal as _,
             value: t_vpi_value__bindgen_ty_1 { integer: 0 },
@@ -68,6 +74,12 @@ impl VeriluaEnv {
 
     pub fn vpiml_get_value64(&mut self, complex_handle_raw: ComplexHandleRaw) -> u64 {
         let complex_handle = ComplexHandle::from_raw(&complex_handle_raw);
+        if cfg!(feature = "verilator")
+            && let Some(direct) = complex_handle.direct
+        {
+            return direct.read_u64();
+        }
+
         let mut v = s_vpi_value {
             format: vpiVectorVal as _,
             value: t_vpi_value__bindgen_ty_1 { integer: 0 },
@@ -96,6 +108,16 @@ impl VeriluaEnv {
         len: u32,
     ) {
         let complex_handle = ComplexHandle::from_raw(&complex_handle_raw);
+        if cfg!(feature = "verilator")
+            && let Some(direct) = complex_handle.direct
+        {
+            for i in 1..(len + 1) {
+                unsafe { ret.add(i as _).write(direct.read_word((i - 1) as _)) };
+            }
+            unsafe { ret.add(0).write(len) };
+            return;
+        }
+
         let mut v = s_vpi_value {
             format: vpiVectorVal as _,
             value: t_vpi_value__bindgen_ty_1 { integer: 0 },
@@ -53,7 +53,14 @@ macro_rules! impl_gen_set_force_value {
                         };
                     } else {
                         if complex_handle.try_put_value(self, &$flag, &vpiVectorVal) {
-                            complex_handle.put_value_vectors[0].aval = value as _;
+                            let vectors = &mut complex_handle.put_value_vectors;
+                            vectors[0].aval = value as _;
+                            vectors[0].bval = 0;
+                            // Zero out upper words, an earlier (string) put may have filled them
+                            for i in 1..complex_handle.beat_num as usize {
+                                vectors[i].aval = 0;
+                                vectors[i].bval = 0;
+                            }
                             self.do_push_hdl_put_value(complex_handle_raw);
                         }
                     }
@@ -87,14 +94,7 @@ macro_rules! impl_gen_set_force_value {
                         }
                     };
 
-                    unsafe {
-                        vpi_put_value(
-                            complex_handle.vpi_handle,
-                            &mut v as *mut _,
-                            std::ptr::null_mut(),
-                            $flag as _,
-                        )
-                    };
+                    complex_handle.put_value_now(&mut v, $flag);
                 }
 
                 pub fn [<vpiml_ $action _value64>](&mut self, complex_handle_raw: ComplexHandleRaw, value: u64) {
@@ -164,14 +164,7 @@ macro_rules! impl_gen_set_force_value {
                         },
                     };
 
-                    unsafe {
-                        vpi_put_value(
-                            complex_handle.vpi_handle,
-                            &mut v as *mut _,
-                            std::ptr::null_mut(),
-                            $flag as _,
-                        )
-                    };
+                    complex_handle.put_value_now(&mut v, $flag);
                 }
 
                 pub fn [<vpiml_ $action _value64_force_single>](&mut self, complex_handle_raw: ComplexHandleRaw, value: u64) {
@@ -238,14 +231,7 @@ macro_rules! impl_gen_set_force_value {
                         },
                     };
 
-                    unsafe {
-                        vpi_put_value(
-                            complex_handle.vpi_handle,
-                            &mut v as *mut _,
-                            std::ptr::null_mut(),
-                            $flag as _,
-                        )
-                    };
+                    complex_handle.put_value_now(&mut v, $flag);
                 }
 
                 pub unsafe extern "C" fn [<vpiml_ $action _value_multi>](&mut self, complex_handle_raw: ComplexHandleRaw, value: *const u32) {
@@ -304,14 +290,7 @@ macro_rules! impl_gen_set_force_value {
                         },
                     };
 
-                    unsafe {
-                        vpi_put_value(
-                            complex_handle.vpi_handle,
-                            &mut v as *mut _,
-                            std::ptr::null_mut(),
-                            $flag as _,
-                        )
-                    };
+                    complex_handle.put_value_now(&mut v, $flag);
                 }
             }
         }
@@ -346,8 +325,7 @@ macro_rules! impl_gen_set_value_str {
                         };
                     } else {
                         if complex_handle.try_put_value(self, &$flag, &$format as _) {
-                            complex_handle.put_value_str =
-                                unsafe { utils::c_char_to_str(value_str) }.to_string();
+                            complex_handle.set_put_value_str($format, unsafe { CStr::from_ptr(value_str) }.to_bytes());
                             self.do_push_hdl_put_value(complex_handle_raw);
                         }
                     }
@@ -374,7 +352,7 @@ macro_rules! impl_gen_set_value_str {
                         };
                     } else {
                         if complex_handle.try_put_value(self, &$flag, &$format as _) {
-                            complex_handle.put_value_str = value_str;
+                            complex_handle.set_put_value_str($format, value_str.as_bytes());
                             self.do_push_hdl_put_value(complex_handle_raw);
                         }
                     }
@@ -443,8 +421,13 @@ macro_rules! impl_gen_set_force_value_multi_beat {
                         };
                     } else {
                         if complex_handle.try_put_value(self, &$flag, &vpiVectorVal) {
+                            let vectors = &mut complex_handle.put_value_vectors;
+                            for vector in vectors.iter_mut().take(complex_handle.beat_num as usize) {
+                                vector.aval = 0;
+                                vector.bval = 0;
+                            }
                             paste::paste! {
-                                $( complex_handle.put_value_vectors[$i].aval = [<v $i>] as _ );*
+                                $( vectors[$i].aval = [<v $i>] as _ );*
                             }
 
                             self.do_push_hdl_put_value(complex_handle_raw);
@@ -546,7 +529,7 @@ macro_rules! impl_gen_set_force_value_str {
                         };
 
                         if complex_handle.try_put_value(self, &$flag, &format as _) {
-                            complex_handle.put_value_str = unsafe { utils::c_char_to_str(final_value_str) }.to_string();
+                            complex_handle.set_put_value_str(format, unsafe { CStr::from_ptr(final_value_str) }.to_bytes());
                             self.do_push_hdl_put_value(complex_handle_raw);
                         }
                     }
@@ -127,6 +127,12 @@
 //! └─────────────────────────────────────────────────────────────────┘
 //! ```
 //!
+//! ## Persistent Edge Waiters (edge_waiter)
+//!
+//! With the `edge_waiter` feature, `vpiml_register_{posedge,negedge,edge}_callback`
+//! skip the per-wait registration above entirely: each `(signal, edge)` keeps one
+//! armed cbValueChange and a list of waiting tasks (see `edge_waiter.rs`).
+//!
 //! ## Callback Handler Flow
 //!
 //! ```text
@@ -255,7 +261,7 @@ pub struct RwSynchCbData {
 /// - Negedge expects Low (signal went to 0)
 /// - Edge matches DontCare (any transition)
 #[inline(always)]
-fn edge_type_to_value(edge_type: &EdgeType) -> EdgeValue {
+pub(crate) fn edge_type_to_value(edge_type: &EdgeType) -> EdgeValue {
     match edge_type {
         EdgeType::Posedge => EdgeValue::High,
         EdgeType::Negedge => EdgeValue::Low,
@@ -964,6 +970,12 @@ macro_rules! gen_vpiml_register_edge_callback {
             paste::paste! {
                 #[inline(always)]
                 unsafe fn [<vpiml_register_ $edge_type _callback_common>](complex_handle_raw: ComplexHandleRaw, task_id: TaskID) {
+                    // One persistent cbValueChange per (signal, edge), see `edge_waiter`
+                    if cfg!(feature = "edge_waiter") {
+                        unsafe { crate::edge_waiter::add_edge_waiter(complex_handle_raw, $edge_type_enum, task_id) };
+                        return;
+                    }
+
                     let env = VeriluaEnv::from_complex_handle_raw(complex_handle_raw);
 
                     if cfg!(feature = "opt_cb_task") {
@@ -4,8 +4,8 @@ local prj_dir = os.projectdir()
 local shared_dir = path.join(prj_dir, "shared")
 local lua_dir = path.join(prj_dir, "luajit-pro", "luajit2.1")
 
-local common_features = "hierarchy_cache"
--- local common_features = "debug hierarchy_cache"
+local common_features = "hierarchy_cache edge_waiter"
+-- local common_features = "debug hierarchy_cache edge_waiter"
 
 local verilator_features = "chunk_task verilator_inner_step_callback " .. common_features
 local vcs_features = "chunk_task merge_cb " .. common_features
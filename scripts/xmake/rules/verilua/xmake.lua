@@ -572,7 +572,7 @@ rule("verilua", function()
                 "--top-module", tb_top,
                 [[-CFLAGS "-std=c++20"]],
                 [[-LDFLAGS "-flto"]],
-                [[-LDFLAGS "-u coverageCtrl -u getCoverageCount -u getCoverage -u getCondCoverage"]], -- Reserve symbols for coverage(cov_exporter)
+                [[-LDFLAGS "-u coverageCtrl -u getCoverageCount -u getCoverage -u getCondCoverage -u getToggleBitmap -u getToggleCounters"]], -- Reserve symbols for coverage(cov_exporter)
             }
 
             --- Inline Verilator control file via set_values("verilua.verilator_config", [[...]]).
@@ -1161,6 +1161,57 @@ rule("verilua", function()
             if u_tb_gen_flags then
                 tb_gen_flags = table.join2(tb_gen_flags, u_tb_gen_flags)
             end
+
+            --- Verilator only: let `testbench_gen` emit `<tb_top>_port_access.cpp`, a side-table that
+            --- registers the storage of every testbench port with libverilua, so that `dut.<port>:get()/set()`
+            --- are direct loads/stores instead of VPI calls.
+            --- e.g. (in your xmake.lua)
+            --- ```lua
+            ---     set_values("verilua.port_access", "1")
+            --- ```
+            local port_access = get_verilua_value(target, "verilua.port_access")
+            if type(port_access) == "table" then
+                port_access = port_access[1]
+            end
+            port_access = sim == "verilator" and port_access == "1"
+            if port_access then
+                table.insert(tb_gen_flags, "--port-access")
+            end
+
+            --- Extra clock domains driven by the testbench, `<clock>:<period>[:<phase>]` (same time unit as the
+            --- main clock period). Verilator toggles them natively in `verilator_main.cpp` through the generated
+            --- `<tb_top>_clock_domains.cpp`, other simulators use `#` delay generators in `tb_top`.
+            --- `verilua.domain_step` additionally calls the Lua hooks registered with `verilua "domainStep" { ... }`
+            --- on every posedge of each domain.
+            --- e.g. (in your xmake.lua)
+            --- ```lua
+            ---     set_values("verilua.clock_domains", "clk_a:10", "clk_b:7:2")
+            ---     set_values("verilua.domain_step", "1")
+            --- ```
+            local clock_domains = get_verilua_value(target, "verilua.clock_domains")
+            if type(clock_domains) == "string" then
+                clock_domains = { clock_domains }
+            end
+            for _, spec in ipairs(clock_domains or {}) do
+                table.insert(tb_gen_flags, "--clock-domain")
+                table.insert(tb_gen_flags, spec)
+            end
+
+            local domain_step = get_verilua_value(target, "verilua.domain_step")
+            if type(domain_step) == "table" then
+                domain_step = domain_step[1]
+            end
+            if domain_step == "1" then
+                table.insert(tb_gen_flags, "--domain-step")
+            end
+
+            local has_clock_domains = false
+            for _, flag in ipairs(tb_gen_flags) do
+                if flag == "--clock-domain" or flag == "--cd" then
+                    has_clock_domains = true
+                    break
+                end
+            end
             local gen_argv = {}
             table.join2(gen_argv, tb_gen_flags)
 
@@ -1212,6 +1263,12 @@ rule("verilua", function()
 
                 os.execv(gen_cmd, gen_argv)
                 target:add("files", path.join(build_dir, tb_top .. ".sv"), path.join(build_dir, "others.sv"))
+                if port_access then
+                    target:add("files", path.join(build_dir, tb_top .. "_port_access.cpp"))
+                end
+                if sim == "verilator" and has_clock_domains then
+                    target:add("files", path.join(build_dir, tb_top .. "_clock_domains.cpp"))
+                end
             else
                 target:add("files", input_tb_top_file)
             end
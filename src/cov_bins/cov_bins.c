@@ -0,0 +1,1629 @@
+// cov_bins: bin based functional coverage, see cov_bins.h.
+//
+// Range bins of a point are folded into elementary intervals the first time the
+// point is sampled: the sorted bounds of every range split the value space into
+// intervals, each with the list of range bins covering it, so a sample is one
+// binary search no matter how many ranges there are. Wildcard and transition
+// bins are checked one by one (a point rarely has many of them). Cross counters
+// are dense arrays for small crosses and an open addressing hash table for
+// large, sparsely hit ones.
+
+#include "cov_bins.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COV_DB_MAGIC "VLCOVDB1"
+#define COV_DB_BYTE_ORDER 0x01020304u
+#define COV_DB_VERSION 1u
+
+// Crosses with at most this many cells keep a dense counter array
+#define COV_DENSE_MAX_CELLS (1u << 20)
+
+#define NO_INDEX UINT32_MAX
+
+typedef struct {
+    char *name;
+    uint8_t kind;
+    uint8_t type;
+    uint32_t nsteps;
+    uint64_t lo; // range: lo, wildcard: value
+    uint64_t hi; // range: hi, wildcard: mask
+    uint64_t *steps; // transition: nsteps (lo, hi) pairs
+    uint64_t hits;
+    uint32_t nidx; // index among the normal bins of the point, NO_INDEX otherwise
+} cov_bin;
+
+typedef struct {
+    char *name;
+    uint32_t width;
+    cov_bin *bins;
+    uint32_t nbins, cap;
+    uint32_t nnormal;
+    uint64_t samples;
+
+    // Lookup, built on the first sample
+    int built;
+    uint64_t *bounds; // interval k is [bounds[k], bounds[k + 1]), the last one is open ended
+    uint32_t nbounds;
+    uint32_t *ival_off; // CSR: range bins of interval k are ival_bins[ival_off[k] .. ival_off[k + 1])
+    uint32_t *ival_bins;
+    uint32_t *others; // wildcard and transition bins
+    uint32_t nothers;
+    int32_t default_bin;
+
+    // Transition history, a ring of the last `hist_cap` samples
+    uint64_t *hist;
+    uint32_t hist_cap, hist_len, hist_pos;
+
+    // Normal bins hit by the current sample, for crosses
+    uint32_t *cur;
+    uint32_t ncur;
+    int pending; // sampled since the last commit and not ignored
+    int32_t last_illegal;
+} cov_point;
+
+typedef struct {
+    char *name;
+    uint32_t npts;
+    uint32_t *pts;
+    uint64_t ncells;
+    uint64_t *dense;
+    uint64_t *keys; // hash: cell + 1, 0 is empty
+    uint64_t *vals;
+    uint64_t hcap, hcount;
+} cov_cross;
+
+struct cov_db {
+    char *name;
+    cov_point *pts;
+    uint32_t npts, pts_cap;
+    cov_cross *crosses;
+    uint32_t ncross, cross_cap;
+    uint64_t samples;
+    int frozen;
+};
+
+// ─── Errors and helpers ────────────────────────────────────────────────────────
+
+static __thread char g_error[512];
+
+const char *cov_last_error(void) { return g_error; }
+
+static int set_error(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(g_error, sizeof(g_error), fmt, ap);
+    va_end(ap);
+    return -1;
+}
+
+static char *dup_str(const char *s) {
+    const size_t len = strlen(s);
+    char *p          = (char *)malloc(len + 1);
+    if (p) {
+        memcpy(p, s, len + 1);
+    }
+    return p;
+}
+
+static int grow(void **p, uint32_t *cap, uint32_t need, size_t elem) {
+    if (need <= *cap) {
+        return 0;
+    }
+    uint32_t c = *cap ? *cap * 2 : 8;
+    while (c < need) {
+        c *= 2;
+    }
+    void *np = realloc(*p, (size_t)c * elem);
+    if (!np) {
+        return set_error("out of memory");
+    }
+    memset((char *)np + (size_t)*cap * elem, 0, (size_t)(c - *cap) * elem);
+    *p   = np;
+    *cap = c;
+    return 0;
+}
+
+static cov_point *get_point(const cov_db *db, int point) {
+    if (!db || point < 0 || (uint32_t)point >= db->npts) {
+        return NULL;
+    }
+    return &db->pts[point];
+}
+
+static cov_cross *get_cross(const cov_db *db, int cross) {
+    if (!db || cross < 0 || (uint32_t)cross >= db->ncross) {
+        return NULL;
+    }
+    return &db->crosses[cross];
+}
+
+// ─── Structure ─────────────────────────────────────────────────────────────────
+
+cov_db *cov_db_new(const char *name) {
+    cov_db *db = (cov_db *)calloc(1, sizeof(cov_db));
+    if (!db) {
+        set_error("out of memory");
+        return NULL;
+    }
+    db->name = dup_str(name ? name : "");
+    return db;
+}
+
+static void free_point(cov_point *p) {
+    for (uint32_t i = 0; i < p->nbins; i++) {
+        free(p->bins[i].name);
+        free(p->bins[i].steps);
+    }
+    free(p->bins);
+    free(p->name);
+    free(p->bounds);
+    free(p->ival_off);
+    free(p->ival_bins);
+    free(p->others);
+    free(p->hist);
+    free(p->cur);
+}
+
+static void free_cross(cov_cross *c) {
+    free(c->name);
+    free(c->pts);
+    free(c->dense);
+    free(c->keys);
+    free(c->vals);
+}
+
+void cov_db_free(cov_db *db) {
+    if (!db) {
+        return;
+    }
+    for (uint32_t i = 0; i < db->npts; i++) {
+        free_point(&db->pts[i]);
+    }
+    for (uint32_t i = 0; i < db->ncross; i++) {
+        free_cross(&db->crosses[i]);
+    }
+    free(db->pts);
+    free(db->crosses);
+    free(db->name);
+    free(db);
+}
+
+const char *cov_db_name(const cov_db *db) { return db ? db->name : NULL; }
+
+static int check_mutable(const cov_db *db) {
+    if (!db) {
+        return set_error("null cov_db");
+    }
+    if (db->frozen) {
+        return set_error("cover group `%s` has already been sampled, its structure can not change", db->name);
+    }
+    return 0;
+}
+
+int cov_point_add(cov_db *db, const char *name, uint32_t width) {
+    if (check_mutable(db) != 0) {
+        return -1;
+    }
+    if (grow((void **)&db->pts, &db->pts_cap, db->npts + 1, sizeof(cov_point)) != 0) {
+        return -1;
+    }
+    cov_point *p   = &db->pts[db->npts];
+    p->name        = dup_str(name ? name : "");
+    p->width       = width;
+    p->default_bin = -1;
+    p->last_illegal = -1;
+    return (int)db->npts++;
+}
+
+static cov_bin *add_bin(cov_db *db, int point, const char *name, int kind, int type) {
+    if (check_mutable(db) != 0) {
+        return NULL;
+    }
+    cov_point *p = get_point(db, point);
+    if (!p) {
+        set_error("invalid cover point index %d", point);
+        return NULL;
+    }
+    if (kind < COV_BIN_NORMAL || kind > COV_BIN_DEFAULT) {
+        set_error("invalid bin kind %d", kind);
+        return NULL;
+    }
+    if (grow((void **)&p->bins, &p->cap, p->nbins + 1, sizeof(cov_bin)) != 0) {
+        return NULL;
+    }
+    cov_bin *b = &p->bins[p->nbins++];
+    b->name    = dup_str(name ? name : "");
+    b->kind    = (uint8_t)kind;
+    b->type    = (uint8_t)type;
+    b->nidx    = NO_INDEX;
+    if (kind == COV_BIN_NORMAL) {
+        b->nidx = p->nnormal++;
+    }
+    return b;
+}
+
+int cov_bin_add_range(cov_db *db, int point, const char *name, int kind, uint64_t lo, uint64_t hi) {
+    if (lo > hi) {
+        return set_error("bin `%s`: empty range [%llu, %llu]", name, (unsigned long long)lo, (unsigned long long)hi);
+    }
+    if (kind == COV_BIN_DEFAULT) {
+        return set_error("bin `%s`: use cov_bin_add_default for default bins", name);
+    }
+    cov_bin *b = add_bin(db, point, name, kind, COV_BIN_RANGE);
+    if (!b) {
+        return -1;
+    }
+    b->lo = lo;
+    b->hi = hi;
+    return (int)(db->pts[point].nbins - 1);
+}
+
+int cov_bin_add_wildcard(cov_db *db, int point, const char *name, int kind, uint64_t value, uint64_t mask) {
+    if (kind == COV_BIN_DEFAULT) {
+        return set_error("bin `%s`: use cov_bin_add_default for default bins", name);
+    }
+    cov_bin *b = add_bin(db, point, name, kind, COV_BIN_WILDCARD);
+    if (!b) {
+        return -1;
+    }
+    b->lo = value & mask;
+    b->hi = mask;
+    return (int)(db->pts[point].nbins - 1);
+}
+
+int cov_bin_add_transition(cov_db *db, int point, const char *name, int kind, const uint64_t *steps, uint32_t nsteps) {
+    if (nsteps < 2 || nsteps > 1024) {
+        return set_error("bin `%s`: a transition needs 2 to 1024 steps, got %u", name, nsteps);
+    }
+    for (uint32_t i = 0; i < nsteps; i++) {
+        if (steps[2 * i] > steps[2 * i + 1]) {
+            return set_error("bin `%s`: empty range at transition step %u", name, i);
+        }
+    }
+    if (kind == COV_BIN_DEFAULT) {
+        return set_error("bin `%s`: use cov_bin_add_default for default bins", name);
+    }
+    uint64_t *copy = (uint64_t *)malloc(sizeof(uint64_t) * 2 * nsteps);
+    if (!copy) {
+        return set_error("out of memory");
+    }
+    cov_bin *b = add_bin(db, point, name, kind, COV_BIN_TRANSITION);
+    if (!b) {
+        free(copy);
+        return -1;
+    }
+    memcpy(copy, steps, sizeof(uint64_t) * 2 * nsteps);
+    b->steps  = copy;
+    b->nsteps = nsteps;
+    return (int)(db->pts[point].nbins - 1);
+}
+
+int cov_bin_add_default(cov_db *db, int point, const char *name) {
+    cov_point *p = get_point(db, point);
+    if (p && p->default_bin >= 0) {
+        return set_error("cover point `%s` already has a default bin", p->name);
+    }
+    cov_bin *b = add_bin(db, point, name, COV_BIN_DEFAULT, COV_BIN_OTHERS);
+    if (!b) {
+        return -1;
+    }
+    p->default_bin = (int32_t)(p->nbins - 1);
+    return p->default_bin;
+}
+
+int cov_cross_add(cov_db *db, const char *name, const uint32_t *points, uint32_t npoints) {
+    if (check_mutable(db) != 0) {
+        return -1;
+    }
+    if (npoints < 2) {
+        return set_error("cross `%s` needs at least 2 cover points", name);
+    }
+    for (uint32_t i = 0; i < npoints; i++) {
+        if (points[i] >= db->npts) {
+            return set_error("cross `%s`: invalid cover point index %u", name, points[i]);
+        }
+        for (uint32_t j = 0; j < i; j++) {
+            if (points[j] == points[i]) {
+                return set_error("cross `%s`: cover point `%s` appears twice", name, db->pts[points[i]].name);
+            }
+        }
+    }
+    if (grow((void **)&db->crosses, &db->cross_cap, db->ncross + 1, sizeof(cov_cross)) != 0) {
+        return -1;
+    }
+    uint32_t *pts = (uint32_t *)malloc(sizeof(uint32_t) * npoints);
+    if (!pts) {
+        return set_error("out of memory");
+    }
+    memcpy(pts, points, sizeof(uint32_t) * npoints);
+
+    cov_cross *c = &db->crosses[db->ncross];
+    c->name      = dup_str(name ? name : "");
+    c->pts       = pts;
+    c->npts      = npoints;
+    return (int)db->ncross++;
+}
+
+// ─── Lookup build (first sample) ───────────────────────────────────────────────
+
+static int cmp_u64(const void *a, const void *b) {
+    const uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Index of the interval holding `v`, or -1 if `v` is below every bound
+static int64_t find_interval(const cov_point *p, uint64_t v) {
+    uint32_t lo = 0, hi = p->nbounds;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (p->bounds[mid] <= v) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (int64_t)lo - 1;
+}
+
+static int build_point(cov_point *p) {
+    uint32_t nranges = 0, nothers = 0, max_steps = 0;
+    for (uint32_t i = 0; i < p->nbins; i++) {
+        const cov_bin *b = &p->bins[i];
+        if (b->type == COV_BIN_RANGE) {
+            nranges++;
+        } else if (b->type == COV_BIN_WILDCARD || b->type == COV_BIN_TRANSITION) {
+            nothers++;
+            if (b->nsteps > max_steps) {
+                max_steps = b->nsteps;
+            }
+        }
+    }
+
+    // Bounds: every lo and hi + 1, sorted and unique
+    uint64_t *bounds = (uint64_t *)malloc(sizeof(uint64_t) * (2 * (size_t)nranges + 1));
+    uint32_t nb      = 0;
+    for (uint32_t i = 0; i < p->nbins; i++) {
+        const cov_bin *b = &p->bins[i];
+        if (b->type == COV_BIN_RANGE) {
+            bounds[nb++] = b->lo;
+            if (b->hi != UINT64_MAX) {
+                bounds[nb++] = b->hi + 1;
+            }
+        }
+    }
+    qsort(bounds, nb, sizeof(uint64_t), cmp_u64);
+    uint32_t nu = 0;
+    for (uint32_t i = 0; i < nb; i++) {
+        if (nu == 0 || bounds[nu - 1] != bounds[i]) {
+            bounds[nu++] = bounds[i];
+        }
+    }
+    p->bounds  = bounds;
+    p->nbounds = nu;
+
+    // CSR of the range bins covering each interval: count, prefix sum, fill
+    p->ival_off = (uint32_t *)calloc((size_t)nu + 1, sizeof(uint32_t));
+    for (uint32_t i = 0; i < p->nbins; i++) {
+        const cov_bin *b = &p->bins[i];
+        if (b->type == COV_BIN_RANGE) {
+            const int64_t first = find_interval(p, b->lo);
+            const int64_t last  = find_interval(p, b->hi);
+            for (int64_t k = first; k <= last; k++) {
+                p->ival_off[k + 1]++;
+            }
+        }
+    }
+    for (uint32_t k = 0; k < nu; k++) {
+        p->ival_off[k + 1] += p->ival_off[k];
+    }
+    p->ival_bins   = (uint32_t *)malloc(sizeof(uint32_t) * ((size_t)p->ival_off[nu] + 1));
+    uint32_t *fill = (uint32_t *)malloc(sizeof(uint32_t) * ((size_t)nu + 1));
+    memcpy(fill, p->ival_off, sizeof(uint32_t) * ((size_t)nu + 1));
+    for (uint32_t i = 0; i < p->nbins; i++) {
+        const cov_bin *b = &p->bins[i];
+        if (b->type == COV_BIN_RANGE) {
+            const int64_t first = find_interval(p, b->lo);
+            const int64_t last  = find_interval(p, b->hi);
+            for (int64_t k = first; k <= last; k++) {
+                p->ival_bins[fill[k]++] = i;
+            }
+        }
+    }
+    free(fill);
+
+    p->others  = (uint32_t *)malloc(sizeof(uint32_t) * ((size_t)nothers + 1));
+    p->nothers = 0;
+    for (uint32_t i = 0; i < p->nbins; i++) {
+        const uint8_t t = p->bins[i].type;
+        if (t == COV_BIN_WILDCARD || t == COV_BIN_TRANSITION) {
+            p->others[p->nothers++] = i;
+        }
+    }
+
+    p->hist_cap = max_steps;
+    p->hist     = max_steps ? (uint64_t *)calloc(max_steps, sizeof(uint64_t)) : NULL;
+    p->cur      = (uint32_t *)malloc(sizeof(uint32_t) * ((size_t)p->nbins + 1));
+    p->built    = 1;
+
+    if (!p->bounds || !p->ival_off || !p->ival_bins || !p->others || !p->cur || (max_steps && !p->hist)) {
+        return set_error("out of memory");
+    }
+    return 0;
+}
+
+static int alloc_cross(cov_db *db, cov_cross *c) {
+    uint64_t cells = 1;
+    for (uint32_t i = 0; i < c->npts; i++) {
+        const uint64_t n = db->pts[c->pts[i]].nnormal;
+        if (n == 0) {
+            cells = 0;
+            break;
+        }
+        if (cells > UINT64_MAX / n) {
+            return set_error("cross `%s` has too many cells", c->name);
+        }
+        cells *= n;
+    }
+    c->ncells = cells;
+    if (cells == 0) {
+        return 0;
+    }
+    if (cells <= COV_DENSE_MAX_CELLS) {
+        c->dense = (uint64_t *)calloc(cells, sizeof(uint64_t));
+        if (!c->dense) {
+            return set_error("out of memory");
+        }
+    }
+    return 0;
+}
+
+// Drop what a failed `freeze` built, the db stays mutable and a later freeze starts over
+static void unfreeze(cov_db *db) {
+    for (uint32_t i = 0; i < db->npts; i++) {
+        cov_point *p = &db->pts[i];
+        free(p->bounds);
+        free(p->ival_off);
+        free(p->ival_bins);
+        free(p->others);
+        free(p->hist);
+        free(p->cur);
+        p->bounds    = NULL;
+        p->ival_off  = NULL;
+        p->ival_bins = NULL;
+        p->others    = NULL;
+        p->hist      = NULL;
+        p->cur       = NULL;
+        p->nbounds   = 0;
+        p->nothers   = 0;
+        p->hist_cap  = 0;
+        p->built     = 0;
+    }
+    for (uint32_t i = 0; i < db->ncross; i++) {
+        free(db->crosses[i].dense);
+        db->crosses[i].dense  = NULL;
+        db->crosses[i].ncells = 0;
+    }
+}
+
+static int freeze(cov_db *db) {
+    if (db->frozen) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < db->npts; i++) {
+        if (build_point(&db->pts[i]) != 0) {
+            unfreeze(db);
+            return -1;
+        }
+    }
+    for (uint32_t i = 0; i < db->ncross; i++) {
+        if (alloc_cross(db, &db->crosses[i]) != 0) {
+            unfreeze(db);
+            return -1;
+        }
+    }
+    // Only now: a frozen db is assumed to have every lookup built
+    db->frozen = 1;
+    return 0;
+}
+
+// ─── Cross counters ────────────────────────────────────────────────────────────
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static uint64_t *hash_slot(cov_cross *c, uint64_t cell, int insert) {
+    if (insert && (c->hcount + 1) * 10 > c->hcap * 7) {
+        const uint64_t ncap = c->hcap ? c->hcap * 2 : 1024;
+        uint64_t *keys      = (uint64_t *)calloc(ncap, sizeof(uint64_t));
+        uint64_t *vals      = (uint64_t *)calloc(ncap, sizeof(uint64_t));
+        if (!keys || !vals) {
+            free(keys);
+            free(vals);
+            return NULL;
+        }
+        for (uint64_t i = 0; i < c->hcap; i++) {
+            if (c->keys[i]) {
+                uint64_t j = mix64(c->keys[i]) & (ncap - 1);
+                while (keys[j]) {
+                    j = (j + 1) & (ncap - 1);
+                }
+                keys[j] = c->keys[i];
+                vals[j] = c->vals[i];
+            }
+        }
+        free(c->keys);
+        free(c->vals);
+        c->keys = keys;
+        c->vals = vals;
+        c->hcap = ncap;
+    }
+    if (c->hcap == 0) {
+        return NULL;
+    }
+
+    const uint64_t key = cell + 1;
+    uint64_t j         = mix64(key) & (c->hcap - 1);
+    while (c->keys[j]) {
+        if (c->keys[j] == key) {
+            return &c->vals[j];
+        }
+        j = (j + 1) & (c->hcap - 1);
+    }
+    if (!insert) {
+        return NULL;
+    }
+    c->keys[j] = key;
+    c->hcount++;
+    return &c->vals[j];
+}
+
+static int cross_add_hits(cov_cross *c, uint64_t cell, uint64_t hits) {
+    if (c->dense) {
+        c->dense[cell] += hits;
+        return 0;
+    }
+    uint64_t *slot = hash_slot(c, cell, 1);
+    if (!slot) {
+        return set_error("out of memory");
+    }
+    *slot += hits;
+    return 0;
+}
+
+static uint64_t cross_get_hits(const cov_cross *c, uint64_t cell) {
+    if (cell >= c->ncells) {
+        return 0;
+    }
+    if (c->dense) {
+        return c->dense[cell];
+    }
+    const uint64_t *slot = hash_slot((cov_cross *)c, cell, 0);
+    return slot ? *slot : 0;
+}
+
+// Every combination of the normal bins hit by the crossed points
+static void cross_sample(cov_db *db, cov_cross *c) {
+    uint32_t idx[64];
+    const uint32_t n = c->npts;
+    if (c->ncells == 0 || n > 64) {
+        return;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        const cov_point *p = &db->pts[c->pts[i]];
+        if (!p->pending || p->ncur == 0) {
+            return;
+        }
+        idx[i] = 0;
+    }
+
+    for (;;) {
+        uint64_t cell = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            const cov_point *p = &db->pts[c->pts[i]];
+            cell               = cell * p->nnormal + p->bins[p->cur[idx[i]]].nidx;
+        }
+        cross_add_hits(c, cell, 1);
+
+        uint32_t i = n;
+        while (i > 0) {
+            i--;
+            if (++idx[i] < db->pts[c->pts[i]].ncur) {
+                break;
+            }
+            idx[i] = 0;
+            if (i == 0) {
+                return;
+            }
+        }
+    }
+}
+
+// ─── Sampling ──────────────────────────────────────────────────────────────────
+
+static int transition_match(const cov_point *p, const cov_bin *b) {
+    if (p->hist_len < b->nsteps) {
+        return 0;
+    }
+    // Oldest step first, the newest sample is at hist_pos - 1
+    for (uint32_t i = 0; i < b->nsteps; i++) {
+        const uint32_t back = b->nsteps - 1 - i;
+        const uint32_t pos  = (p->hist_pos + p->hist_cap - 1 - back) % p->hist_cap;
+        const uint64_t v    = p->hist[pos];
+        if (v < b->steps[2 * i] || v > b->steps[2 * i + 1]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int sample_point(cov_db *db, cov_point *p, uint64_t v, int wide) {
+    uint32_t matched[64];
+    uint32_t nmatched = 0;
+    int excluded = 0, illegal = 0;
+
+    p->samples++;
+    p->ncur         = 0;
+    p->pending      = 0;
+    p->last_illegal = -1;
+
+    if (p->hist_cap) {
+        if (wide) {
+            p->hist_len = 0; // a wide value breaks every transition
+        } else {
+            p->hist[p->hist_pos] = v;
+            p->hist_pos          = (p->hist_pos + 1) % p->hist_cap;
+            if (p->hist_len < p->hist_cap) {
+                p->hist_len++;
+            }
+        }
+    }
+
+    // Bins are collected in `matched` first so that ignore / illegal bins can
+    // exclude the normal bins hit by the same value. Points with more than 64
+    // matching bins spill the normal ones straight into `cur`.
+    if (!wide) {
+        const int64_t k = find_interval(p, v);
+        if (k >= 0) {
+            for (uint32_t j = p->ival_off[k]; j < p->ival_off[k + 1]; j++) {
+                const uint32_t bi = p->ival_bins[j];
+                if (nmatched < 64) {
+                    matched[nmatched++] = bi;
+                } else if (p->bins[bi].kind == COV_BIN_NORMAL) {
+                    p->cur[p->ncur++] = bi;
+                } else {
+                    excluded = 1;
+                    p->bins[bi].hits++;
+                    if (p->bins[bi].kind == COV_BIN_ILLEGAL) {
+                        illegal++;
+                        p->last_illegal = (int32_t)bi;
+                    }
+                }
+            }
+        }
+        for (uint32_t j = 0; j < p->nothers; j++) {
+            const uint32_t bi = p->others[j];
+            const cov_bin *b  = &p->bins[bi];
+            const int hit     = b->type == COV_BIN_WILDCARD ? (v & b->hi) == b->lo : transition_match(p, b);
+            if (!hit) {
+                continue;
+            }
+            if (nmatched < 64) {
+                matched[nmatched++] = bi;
+            } else if (b->kind == COV_BIN_NORMAL) {
+                p->cur[p->ncur++] = bi;
+            } else {
+                excluded = 1;
+                p->bins[bi].hits++;
+                if (b->kind == COV_BIN_ILLEGAL) {
+                    illegal++;
+                    p->last_illegal = (int32_t)bi;
+                }
+            }
+        }
+    }
+
+    for (uint32_t j = 0; j < nmatched; j++) {
+        cov_bin *b = &p->bins[matched[j]];
+        if (b->kind == COV_BIN_NORMAL) {
+            p->cur[p->ncur++] = matched[j];
+        } else {
+            excluded = 1;
+            b->hits++;
+            if (b->kind == COV_BIN_ILLEGAL) {
+                illegal++;
+                p->last_illegal = (int32_t)matched[j];
+            }
+        }
+    }
+
+    if (excluded) {
+        p->ncur = 0;
+        return illegal;
+    }
+
+    for (uint32_t j = 0; j < p->ncur; j++) {
+        p->bins[p->cur[j]].hits++;
+    }
+    if (p->ncur == 0 && p->default_bin >= 0) {
+        p->bins[p->default_bin].hits++;
+    }
+    p->pending = 1;
+    (void)db;
+    return 0;
+}
+
+int cov_point_sample(cov_db *db, int point, uint64_t value) {
+    cov_point *p = get_point(db, point);
+    if (!p || freeze(db) != 0) {
+        return 0;
+    }
+    return sample_point(db, p, value, 0);
+}
+
+int cov_point_sample_limbs(cov_db *db, int point, const uint64_t *limbs, size_t nlimbs) {
+    cov_point *p = get_point(db, point);
+    if (!p || freeze(db) != 0) {
+        return 0;
+    }
+    int wide = 0;
+    for (size_t i = 1; i < nlimbs; i++) {
+        if (limbs[i]) {
+            wide = 1;
+            break;
+        }
+    }
+    return sample_point(db, p, nlimbs ? limbs[0] : 0, wide);
+}
+
+void cov_group_commit(cov_db *db) {
+    if (!db || freeze(db) != 0) {
+        return;
+    }
+    db->samples++;
+    for (uint32_t i = 0; i < db->ncross; i++) {
+        cross_sample(db, &db->crosses[i]);
+    }
+    for (uint32_t i = 0; i < db->npts; i++) {
+        db->pts[i].pending = 0;
+        db->pts[i].ncur    = 0;
+    }
+}
+
+int cov_group_sample(cov_db *db, const uint64_t *values, size_t n) {
+    if (!db || freeze(db) != 0) {
+        return 0;
+    }
+    int illegal = 0;
+    for (size_t i = 0; i < n && i < db->npts; i++) {
+        illegal += sample_point(db, &db->pts[i], values[i], 0);
+    }
+    cov_group_commit(db);
+    return illegal;
+}
+
+// ─── Queries ───────────────────────────────────────────────────────────────────
+
+uint32_t cov_db_num_points(const cov_db *db) { return db ? db->npts : 0; }
+uint32_t cov_db_num_crosses(const cov_db *db) { return db ? db->ncross : 0; }
+uint64_t cov_db_samples(const cov_db *db) { return db ? db->samples : 0; }
+
+const char *cov_point_name(const cov_db *db, int point) {
+    const cov_point *p = get_point(db, point);
+    return p ? p->name : NULL;
+}
+
+uint32_t cov_point_num_bins(const cov_db *db, int point) {
+    const cov_point *p = get_point(db, point);
+    return p ? p->nbins : 0;
+}
+
+uint64_t cov_point_samples(const cov_db *db, int point) {
+    const cov_point *p = get_point(db, point);
+    return p ? p->samples : 0;
+}
+
+int cov_point_last_illegal(const cov_db *db, int point) {
+    const cov_point *p = get_point(db, point);
+    return p ? p->last_illegal : -1;
+}
+
+static const cov_bin *get_bin(const cov_db *db, int point, int bin) {
+    const cov_point *p = get_point(db, point);
+    if (!p || bin < 0 || (uint32_t)bin >= p->nbins) {
+        return NULL;
+    }
+    return &p->bins[bin];
+}
+
+const char *cov_bin_name(const cov_db *db, int point, int bin) {
+    const cov_bin *b = get_bin(db, point, bin);
+    return b ? b->name : NULL;
+}
+
+int cov_bin_kind(const cov_db *db, int point, int bin) {
+    const cov_bin *b = get_bin(db, point, bin);
+    return b ? b->kind : -1;
+}
+
+uint64_t cov_bin_hits(const cov_db *db, int point, int bin) {
+    const cov_bin *b = get_bin(db, point, bin);
+    return b ? b->hits : 0;
+}
+
+const char *cov_cross_name(const cov_db *db, int cross) {
+    const cov_cross *c = get_cross(db, cross);
+    return c ? c->name : NULL;
+}
+
+static uint64_t cross_num_cells(const cov_db *db, const cov_cross *c) {
+    if (c->ncells || db->frozen) {
+        return c->ncells;
+    }
+    uint64_t cells = 1;
+    for (uint32_t i = 0; i < c->npts; i++) {
+        cells *= db->pts[c->pts[i]].nnormal;
+    }
+    return cells;
+}
+
+uint64_t cov_cross_hits(const cov_db *db, int cross, const uint32_t *bins) {
+    const cov_cross *c = get_cross(db, cross);
+    if (!c) {
+        return 0;
+    }
+    uint64_t cell = 0;
+    for (uint32_t i = 0; i < c->npts; i++) {
+        const cov_point *p = &db->pts[c->pts[i]];
+        if (bins[i] >= p->nbins || p->bins[bins[i]].nidx == NO_INDEX) {
+            return 0;
+        }
+        cell = cell * p->nnormal + p->bins[bins[i]].nidx;
+    }
+    return cross_get_hits(c, cell);
+}
+
+uint64_t cov_cross_num_cells(const cov_db *db, int cross) {
+    const cov_cross *c = get_cross(db, cross);
+    return c ? cross_num_cells(db, c) : 0;
+}
+
+uint64_t cov_cross_covered_cells(const cov_db *db, int cross) {
+    const cov_cross *c = get_cross(db, cross);
+    if (!c) {
+        return 0;
+    }
+    uint64_t covered = 0;
+    if (c->dense) {
+        for (uint64_t i = 0; i < c->ncells; i++) {
+            covered += c->dense[i] != 0;
+        }
+    } else {
+        for (uint64_t i = 0; i < c->hcap; i++) {
+            covered += c->keys[i] && c->vals[i];
+        }
+    }
+    return covered;
+}
+
+double cov_point_coverage(const cov_db *db, int point) {
+    const cov_point *p = get_point(db, point);
+    if (!p || p->nnormal == 0) {
+        return 0.0;
+    }
+    uint32_t covered = 0;
+    for (uint32_t i = 0; i < p->nbins; i++) {
+        covered += p->bins[i].kind == COV_BIN_NORMAL && p->bins[i].hits;
+    }
+    return 100.0 * covered / p->nnormal;
+}
+
+double cov_cross_coverage(const cov_db *db, int cross) {
+    const uint64_t cells = cov_cross_num_cells(db, cross);
+    if (cells == 0) {
+        return 0.0;
+    }
+    return 100.0 * (double)cov_cross_covered_cells(db, cross) / (double)cells;
+}
+
+double cov_db_coverage(const cov_db *db) {
+    if (!db || db->npts + db->ncross == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (uint32_t i = 0; i < db->npts; i++) {
+        sum += cov_point_coverage(db, (int)i);
+    }
+    for (uint32_t i = 0; i < db->ncross; i++) {
+        sum += cov_cross_coverage(db, (int)i);
+    }
+    return sum / (db->npts + db->ncross);
+}
+
+// ─── Shape hash and merge ──────────────────────────────────────────────────────
+
+static uint64_t fnv_bytes(uint64_t h, const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static uint64_t fnv_str(uint64_t h, const char *s) { return fnv_bytes(h, s, strlen(s) + 1); }
+
+static uint64_t fnv_u64(uint64_t h, uint64_t v) { return fnv_bytes(h, &v, sizeof(v)); }
+
+uint64_t cov_db_shape_hash(const cov_db *db) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    h          = fnv_str(h, db->name);
+    h          = fnv_u64(h, db->npts);
+    for (uint32_t i = 0; i < db->npts; i++) {
+        const cov_point *p = &db->pts[i];
+        h                  = fnv_str(h, p->name);
+        h                  = fnv_u64(h, p->width);
+        h                  = fnv_u64(h, p->nbins);
+        for (uint32_t j = 0; j < p->nbins; j++) {
+            const cov_bin *b = &p->bins[j];
+            h                = fnv_str(h, b->name);
+            h                = fnv_u64(h, ((uint64_t)b->kind << 8) | b->type);
+            h                = fnv_u64(h, b->lo);
+            h                = fnv_u64(h, b->hi);
+            h                = fnv_u64(h, b->nsteps);
+            h                = fnv_bytes(h, b->steps, sizeof(uint64_t) * 2 * b->nsteps);
+        }
+    }
+    h = fnv_u64(h, db->ncross);
+    for (uint32_t i = 0; i < db->ncross; i++) {
+        const cov_cross *c = &db->crosses[i];
+        h                  = fnv_str(h, c->name);
+        h                  = fnv_u64(h, c->npts);
+        h                  = fnv_bytes(h, c->pts, sizeof(uint32_t) * c->npts);
+    }
+    return h;
+}
+
+int cov_db_merge(cov_db *dst, const cov_db *src) {
+    if (!dst || !src) {
+        return set_error("null cov_db");
+    }
+    if (cov_db_shape_hash(dst) != cov_db_shape_hash(src)) {
+        return set_error("cover group `%s` can not be merged with `%s`: different bins or crosses", dst->name, src->name);
+    }
+    if (freeze(dst) != 0) {
+        return -1;
+    }
+
+    dst->samples += src->samples;
+    for (uint32_t i = 0; i < dst->npts; i++) {
+        dst->pts[i].samples += src->pts[i].samples;
+        for (uint32_t j = 0; j < dst->pts[i].nbins; j++) {
+            dst->pts[i].bins[j].hits += src->pts[i].bins[j].hits;
+        }
+    }
+    for (uint32_t i = 0; i < dst->ncross; i++) {
+        cov_cross *d       = &dst->crosses[i];
+        const cov_cross *s = &src->crosses[i];
+        if (s->dense) {
+            for (uint64_t k = 0; k < s->ncells; k++) {
+                if (s->dense[k] && cross_add_hits(d, k, s->dense[k]) != 0) {
+                    return -1;
+                }
+            }
+        } else {
+            for (uint64_t k = 0; k < s->hcap; k++) {
+                if (s->keys[k] && cross_add_hits(d, s->keys[k] - 1, s->vals[k]) != 0) {
+                    return -1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// ─── Binary database ───────────────────────────────────────────────────────────
+//
+// file:  "VLCOVDB1" | u32 byte order (0x01020304) | u32 version | u32 nr_groups | u32 0 | group*
+// group: str name | u64 shape hash | u64 samples | u32 nr_points | u32 nr_crosses | point* | cross*
+// point: str name | u32 width | u32 nr_bins | u64 samples | bin*
+// bin:   str name | u8 kind | u8 type | u16 0 | u32 nsteps | u64 lo | u64 hi | u64 steps[2 * nsteps] | u64 hits
+// cross: str name | u32 nr_points | u32 points[] | u64 nr_hit_cells | (u64 cell, u64 hits)*
+// str:   u32 length | bytes
+//
+// Integers are stored in host byte order, readers reject a file whose byte
+// order marker does not match.
+
+typedef struct {
+    FILE *fp;
+    int failed;
+} writer;
+
+static void put(writer *w, const void *data, size_t len) {
+    if (!w->failed && len && fwrite(data, 1, len, w->fp) != len) {
+        w->failed = 1;
+    }
+}
+
+static void put_u8(writer *w, uint8_t v) { put(w, &v, 1); }
+static void put_u16(writer *w, uint16_t v) { put(w, &v, 2); }
+static void put_u32(writer *w, uint32_t v) { put(w, &v, 4); }
+static void put_u64(writer *w, uint64_t v) { put(w, &v, 8); }
+
+static void put_str(writer *w, const char *s) {
+    const uint32_t len = (uint32_t)strlen(s);
+    put_u32(w, len);
+    put(w, s, len);
+}
+
+static void write_group(writer *w, const cov_db *db) {
+    put_str(w, db->name);
+    put_u64(w, cov_db_shape_hash(db));
+    put_u64(w, db->samples);
+    put_u32(w, db->npts);
+    put_u32(w, db->ncross);
+    for (uint32_t i = 0; i < db->npts; i++) {
+        const cov_point *p = &db->pts[i];
+        put_str(w, p->name);
+        put_u32(w, p->width);
+        put_u32(w, p->nbins);
+        put_u64(w, p->samples);
+        for (uint32_t j = 0; j < p->nbins; j++) {
+            const cov_bin *b = &p->bins[j];
+            put_str(w, b->name);
+            put_u8(w, b->kind);
+            put_u8(w, b->type);
+            put_u16(w, 0);
+            put_u32(w, b->nsteps);
+            put_u64(w, b->lo);
+            put_u64(w, b->hi);
+            put(w, b->steps, sizeof(uint64_t) * 2 * b->nsteps);
+            put_u64(w, b->hits);
+        }
+    }
+    for (uint32_t i = 0; i < db->ncross; i++) {
+        const cov_cross *c = &db->crosses[i];
+        put_str(w, c->name);
+        put_u32(w, c->npts);
+        put(w, c->pts, sizeof(uint32_t) * c->npts);
+
+        uint64_t nnz = 0;
+        if (c->dense) {
+            for (uint64_t k = 0; k < c->ncells; k++) {
+                nnz += c->dense[k] != 0;
+            }
+        } else {
+            for (uint64_t k = 0; k < c->hcap; k++) {
+                nnz += c->keys[k] && c->vals[k];
+            }
+        }
+        put_u64(w, nnz);
+        if (c->dense) {
+            for (uint64_t k = 0; k < c->ncells; k++) {
+                if (c->dense[k]) {
+                    put_u64(w, k);
+                    put_u64(w, c->dense[k]);
+                }
+            }
+        } else {
+            for (uint64_t k = 0; k < c->hcap; k++) {
+                if (c->keys[k] && c->vals[k]) {
+                    put_u64(w, c->keys[k] - 1);
+                    put_u64(w, c->vals[k]);
+                }
+            }
+        }
+    }
+}
+
+int cov_db_save_many(cov_db *const *dbs, size_t n, const char *path) {
+    // Write to a temporary file first so that readers never see a partial database
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) {
+        return set_error("path too long: %s", path);
+    }
+    writer w = {fopen(tmp, "wb"), 0};
+    if (!w.fp) {
+        return set_error("failed to open `%s` for writing: %s", tmp, strerror(errno));
+    }
+    put(&w, COV_DB_MAGIC, 8);
+    put_u32(&w, COV_DB_BYTE_ORDER);
+    put_u32(&w, COV_DB_VERSION);
+    put_u32(&w, (uint32_t)n);
+    put_u32(&w, 0);
+    for (size_t i = 0; i < n; i++) {
+        write_group(&w, dbs[i]);
+    }
+    if (fclose(w.fp) != 0) {
+        w.failed = 1;
+    }
+    if (w.failed) {
+        remove(tmp);
+        return set_error("failed to write `%s`", path);
+    }
+    if (rename(tmp, path) != 0) {
+        remove(tmp);
+        return set_error("failed to rename `%s` to `%s`: %s", tmp, path, strerror(errno));
+    }
+    return 0;
+}
+
+int cov_db_save(const cov_db *db, const char *path) {
+    cov_db *one = (cov_db *)db;
+    return cov_db_save_many(&one, 1, path);
+}
+
+typedef struct {
+    const unsigned char *p;
+    size_t len, pos;
+    int failed;
+} reader;
+
+static int get(reader *r, void *out, size_t len) {
+    if (r->failed || len > r->len - r->pos) {
+        r->failed = 1;
+        memset(out, 0, len);
+        return 0;
+    }
+    memcpy(out, r->p + r->pos, len);
+    r->pos += len;
+    return 1;
+}
+
+static uint8_t get_u8(reader *r) {
+    uint8_t v;
+    get(r, &v, 1);
+    return v;
+}
+
+static uint16_t get_u16(reader *r) {
+    uint16_t v;
+    get(r, &v, 2);
+    return v;
+}
+
+static uint32_t get_u32(reader *r) {
+    uint32_t v;
+    get(r, &v, 4);
+    return v;
+}
+
+static uint64_t get_u64(reader *r) {
+    uint64_t v;
+    get(r, &v, 8);
+    return v;
+}
+
+static char *get_str(reader *r) {
+    const uint32_t len = get_u32(r);
+    if (r->failed || len > r->len - r->pos) {
+        r->failed = 1;
+        return NULL;
+    }
+    char *s = (char *)malloc((size_t)len + 1);
+    if (!s) {
+        r->failed = 1;
+        return NULL;
+    }
+    memcpy(s, r->p + r->pos, len);
+    s[len] = '\0';
+    r->pos += len;
+    return s;
+}
+
+static cov_db *read_group(reader *r) {
+    char *name = get_str(r);
+    if (!name) {
+        return NULL;
+    }
+    cov_db *db = cov_db_new(name);
+    free(name);
+    if (!db) {
+        return NULL;
+    }
+
+    const uint64_t shape   = get_u64(r);
+    const uint64_t samples = get_u64(r);
+    const uint32_t npts    = get_u32(r);
+    const uint32_t ncross  = get_u32(r);
+
+    for (uint32_t i = 0; i < npts && !r->failed; i++) {
+        char *pname          = get_str(r);
+        const uint32_t width = get_u32(r);
+        const uint32_t nbins = get_u32(r);
+        const uint64_t psamp = get_u64(r);
+        if (r->failed) {
+            free(pname);
+            break;
+        }
+        const int pi = cov_point_add(db, pname, width);
+        free(pname);
+
+        for (uint32_t j = 0; j < nbins && !r->failed; j++) {
+            char *bname          = get_str(r);
+            const int kind       = get_u8(r);
+            const int type       = get_u8(r);
+            (void)get_u16(r);
+            const uint32_t nsteps = get_u32(r);
+            const uint64_t lo     = get_u64(r);
+            const uint64_t hi     = get_u64(r);
+            uint64_t *steps       = NULL;
+            if (!r->failed && nsteps) {
+                if (nsteps > 1024) {
+                    r->failed = 1;
+                } else {
+                    steps = (uint64_t *)malloc(sizeof(uint64_t) * 2 * nsteps);
+                    if (!steps || !get(r, steps, sizeof(uint64_t) * 2 * nsteps)) {
+                        r->failed = 1;
+                    }
+                }
+            }
+            const uint64_t hits = get_u64(r);
+
+            int bi = -1;
+            if (!r->failed) {
+                if (type == COV_BIN_RANGE) {
+                    bi = cov_bin_add_range(db, pi, bname, kind, lo, hi);
+                } else if (type == COV_BIN_WILDCARD) {
+                    bi = cov_bin_add_wildcard(db, pi, bname, kind, lo, hi);
+                } else if (type == COV_BIN_TRANSITION) {
+                    bi = cov_bin_add_transition(db, pi, bname, kind, steps, nsteps);
+                } else if (type == COV_BIN_OTHERS) {
+                    bi = cov_bin_add_default(db, pi, bname);
+                }
+            }
+            free(bname);
+            free(steps);
+            if (bi < 0) {
+                r->failed = 1;
+                break;
+            }
+            db->pts[pi].bins[bi].hits = hits;
+        }
+        if (!r->failed) {
+            db->pts[pi].samples = psamp;
+        }
+    }
+
+    // Crosses: the structure has to be complete before the counters can be allocated
+    uint64_t cross_start = 0;
+    for (uint32_t i = 0; i < ncross && !r->failed; i++) {
+        char *cname        = get_str(r);
+        const uint32_t np  = get_u32(r);
+        uint32_t *pts      = NULL;
+        if (!r->failed) {
+            pts = (uint32_t *)malloc(sizeof(uint32_t) * ((size_t)np + 1));
+            if (!pts || np > 64 || !get(r, pts, sizeof(uint32_t) * np)) {
+                r->failed = 1;
+            }
+        }
+        if (!r->failed && cov_cross_add(db, cname, pts, np) < 0) {
+            r->failed = 1;
+        }
+        free(cname);
+        free(pts);
+
+        // Skip the cells for now, they are read in the second pass below
+        const uint64_t nnz = get_u64(r);
+        if (!r->failed) {
+            if (nnz > (r->len - r->pos) / 16) {
+                r->failed = 1;
+            } else {
+                if (i == 0) {
+                    cross_start = r->pos - 8;
+                }
+                r->pos += (size_t)nnz * 16;
+            }
+        }
+    }
+
+    if (!r->failed && (freeze(db) != 0 || cov_db_shape_hash(db) != shape)) {
+        r->failed = 1;
+    }
+
+    if (!r->failed && ncross) {
+        // Second pass over the crosses for the cells
+        const size_t end = r->pos;
+        r->pos           = (size_t)cross_start;
+        for (uint32_t i = 0; i < ncross && !r->failed; i++) {
+            if (i > 0) {
+                free(get_str(r));
+                const uint32_t np = get_u32(r);
+                r->pos += (size_t)np * 4;
+            }
+            const uint64_t nnz = get_u64(r);
+            cov_cross *c       = &db->crosses[i];
+            for (uint64_t k = 0; k < nnz && !r->failed; k++) {
+                const uint64_t cell = get_u64(r);
+                const uint64_t hits = get_u64(r);
+                if (cell >= c->ncells || cross_add_hits(c, cell, hits) != 0) {
+                    r->failed = 1;
+                }
+            }
+        }
+        if (r->pos != end) {
+            r->failed = 1;
+        }
+    }
+
+    if (r->failed) {
+        cov_db_free(db);
+        return NULL;
+    }
+    db->samples = samples;
+    return db;
+}
+
+static unsigned char *read_file(const char *path, size_t *len) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        set_error("failed to open `%s`: %s", path, strerror(errno));
+        return NULL;
+    }
+    size_t cap = 1 << 16, n = 0;
+    unsigned char *buf = (unsigned char *)malloc(cap);
+    while (buf) {
+        n += fread(buf + n, 1, cap - n, fp);
+        if (n < cap) {
+            break;
+        }
+        cap *= 2;
+        unsigned char *nb = (unsigned char *)realloc(buf, cap);
+        if (!nb) {
+            free(buf);
+            buf = NULL;
+        } else {
+            buf = nb;
+        }
+    }
+    const int err = ferror(fp);
+    fclose(fp);
+    if (!buf || err) {
+        free(buf);
+        set_error("failed to read `%s`", path);
+        return NULL;
+    }
+    *len = n;
+    return buf;
+}
+
+cov_db **cov_db_load_many(const char *path, size_t *n) {
+    size_t len          = 0;
+    unsigned char *data = read_file(path, &len);
+    if (!data) {
+        return NULL;
+    }
+
+    reader r = {data, len, 0, 0};
+    char magic[8];
+    get(&r, magic, 8);
+    const uint32_t order   = get_u32(&r);
+    const uint32_t version = get_u32(&r);
+    const uint32_t ngroups = get_u32(&r);
+    (void)get_u32(&r);
+    if (r.failed || memcmp(magic, COV_DB_MAGIC, 8) != 0) {
+        free(data);
+        set_error("`%s` is not a coverage database", path);
+        return NULL;
+    }
+    if (order != COV_DB_BYTE_ORDER || version != COV_DB_VERSION) {
+        free(data);
+        set_error("`%s`: unsupported byte order or version %u", path, version);
+        return NULL;
+    }
+
+    cov_db **dbs = (cov_db **)calloc((size_t)ngroups + 1, sizeof(cov_db *));
+    size_t count = 0;
+    for (uint32_t i = 0; dbs && i < ngroups; i++) {
+        cov_db *db = read_group(&r);
+        if (!db) {
+            for (size_t j = 0; j < count; j++) {
+                cov_db_free(dbs[j]);
+            }
+            free(dbs);
+            dbs = NULL;
+            set_error("`%s` is corrupted (group %u)", path, i);
+            break;
+        }
+        dbs[count++] = db;
+    }
+    free(data);
+    if (dbs) {
+        *n = count;
+    }
+    return dbs;
+}
+
+cov_db *cov_db_load(const char *path) {
+    size_t n     = 0;
+    cov_db **dbs = cov_db_load_many(path, &n);
+    if (!dbs) {
+        return NULL;
+    }
+    cov_db *first = NULL;
+    if (n == 0) {
+        set_error("`%s` holds no cover group", path);
+    } else {
+        first = dbs[0];
+    }
+    for (size_t i = 1; i < n; i++) {
+        cov_db_free(dbs[i]);
+    }
+    free(dbs);
+    return first;
+}
+
+// ─── JSON ──────────────────────────────────────────────────────────────────────
+
+static void json_str(FILE *fp, const char *s) {
+    fputc('"', fp);
+    for (; *s; s++) {
+        const unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fputc('\\', fp);
+            fputc(c, fp);
+        } else if (c < 0x20) {
+            fprintf(fp, "\\u%04x", c);
+        } else {
+            fputc(c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+static const char *kind_str(int kind) {
+    switch (kind) {
+    case COV_BIN_IGNORE:
+        return "ignore";
+    case COV_BIN_ILLEGAL:
+        return "illegal";
+    case COV_BIN_DEFAULT:
+        return "default";
+    default:
+        return "normal";
+    }
+}
+
+static void json_bin(FILE *fp, const cov_bin *b) {
+    fputs("{ \"name\": ", fp);
+    json_str(fp, b->name);
+    fprintf(fp, ", \"kind\": \"%s\"", kind_str(b->kind));
+    if (b->type == COV_BIN_RANGE) {
+        fprintf(fp, ", \"range\": [%llu, %llu]", (unsigned long long)b->lo, (unsigned long long)b->hi);
+    } else if (b->type == COV_BIN_WILDCARD) {
+        fprintf(fp, ", \"wildcard\": { \"value\": %llu, \"mask\": %llu }", (unsigned long long)b->lo, (unsigned long long)b->hi);
+    } else if (b->type == COV_BIN_TRANSITION) {
+        fputs(", \"transition\": [", fp);
+        for (uint32_t i = 0; i < b->nsteps; i++) {
+            fprintf(fp, "%s[%llu, %llu]", i ? ", " : "", (unsigned long long)b->steps[2 * i], (unsigned long long)b->steps[2 * i + 1]);
+        }
+        fputc(']', fp);
+    }
+    fprintf(fp, ", \"hits\": %llu }", (unsigned long long)b->hits);
+}
+
+// Normal bin of `p` with normal index `nidx`
+static const cov_bin *normal_bin(const cov_point *p, uint32_t nidx) {
+    for (uint32_t i = 0; i < p->nbins; i++) {
+        if (p->bins[i].nidx == nidx) {
+            return &p->bins[i];
+        }
+    }
+    return NULL;
+}
+
+static void json_cell(FILE *fp, const cov_db *db, const cov_cross *c, uint64_t cell, uint64_t hits, int *first) {
+    uint32_t nidx[64];
+    uint64_t rest = cell;
+    for (uint32_t i = c->npts; i > 0; i--) {
+        const uint32_t n = db->pts[c->pts[i - 1]].nnormal;
+        nidx[i - 1]      = (uint32_t)(rest % n);
+        rest /= n;
+    }
+    fputs(*first ? "\n        [" : ",\n        [", fp);
+    *first = 0;
+    for (uint32_t i = 0; i < c->npts; i++) {
+        json_str(fp, normal_bin(&db->pts[c->pts[i]], nidx[i])->name);
+        fputs(", ", fp);
+    }
+    fprintf(fp, "%llu]", (unsigned long long)hits);
+}
+
+static int cmp_cell(const void *a, const void *b) { return cmp_u64(a, b); }
+
+static void json_group(FILE *fp, const cov_db *db) {
+    fputs("{\n    \"name\": ", fp);
+    json_str(fp, db->name);
+    fprintf(fp, ",\n    \"coverage\": %.4f,\n    \"samples\": %llu,\n    \"points\": [", cov_db_coverage(db), (unsigned long long)db->samples);
+    for (uint32_t i = 0; i < db->npts; i++) {
+        const cov_point *p = &db->pts[i];
+        fputs(i ? ",\n      { \"name\": " : "\n      { \"name\": ", fp);
+        json_str(fp, p->name);
+        fprintf(fp, ", \"width\": %u, \"coverage\": %.4f, \"samples\": %llu, \"bins\": [", p->width, cov_point_coverage(db, (int)i), (unsigned long long)p->samples);
+        for (uint32_t j = 0; j < p->nbins; j++) {
+            fputs(j ? ",\n        " : "\n        ", fp);
+            json_bin(fp, &p->bins[j]);
+        }
+        fputs(" ] }", fp);
+    }
+    fputs(" ],\n    \"crosses\": [", fp);
+    for (uint32_t i = 0; i < db->ncross; i++) {
+        const cov_cross *c = &db->crosses[i];
+        fputs(i ? ",\n      { \"name\": " : "\n      { \"name\": ", fp);
+        json_str(fp, c->name);
+        fputs(", \"points\": [", fp);
+        for (uint32_t j = 0; j < c->npts; j++) {
+            if (j) {
+                fputs(", ", fp);
+            }
+            json_str(fp, db->pts[c->pts[j]].name);
+        }
+        fprintf(fp, "], \"coverage\": %.4f, \"cells\": %llu, \"covered_cells\": %llu, \"hits\": [", cov_cross_coverage(db, (int)i),
+                (unsigned long long)cross_num_cells(db, c), (unsigned long long)cov_cross_covered_cells(db, (int)i));
+
+        int first = 1;
+        if (c->dense) {
+            for (uint64_t k = 0; k < c->ncells; k++) {
+                if (c->dense[k]) {
+                    json_cell(fp, db, c, k, c->dense[k], &first);
+                }
+            }
+        } else if (c->hcount) {
+            // Hash order is arbitrary, sort the hit cells for a stable output
+            uint64_t *cells = (uint64_t *)malloc(sizeof(uint64_t) * c->hcount);
+            uint64_t n      = 0;
+            for (uint64_t k = 0; cells && k < c->hcap; k++) {
+                if (c->keys[k] && c->vals[k]) {
+                    cells[n++] = c->keys[k] - 1;
+                }
+            }
+            if (cells) {
+                qsort(cells, n, sizeof(uint64_t), cmp_cell);
+                for (uint64_t k = 0; k < n; k++) {
+                    json_cell(fp, db, c, cells[k], cross_get_hits(c, cells[k]), &first);
+                }
+            }
+            free(cells);
+        }
+        fputs(" ] }", fp);
+    }
+    fputs(" ]\n  }", fp);
+}
+
+int cov_db_write_json_many(cov_db *const *dbs, size_t n, const char *path, const char *meta) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        return set_error("failed to open `%s` for writing: %s", path, strerror(errno));
+    }
+    fputs("{\n", fp);
+    if (meta && *meta) {
+        fprintf(fp, "  %s,\n", meta);
+    }
+    fputs("  \"groups\": [\n  ", fp);
+    for (size_t i = 0; i < n; i++) {
+        if (i) {
+            fputs(",\n  ", fp);
+        }
+        json_group(fp, dbs[i]);
+    }
+    fputs("\n  ]\n}\n", fp);
+    if (ferror(fp) | fclose(fp)) {
+        return set_error("failed to write `%s`", path);
+    }
+    return 0;
+}
+
+int cov_db_write_json(const cov_db *db, const char *path, const char *meta) {
+    cov_db *one = (cov_db *)db;
+    return cov_db_write_json_many(&one, 1, path, meta);
+}
@@ -0,0 +1,101 @@
+// cov_bins: bin based functional coverage behind `verilua.coverage.BinCoverPoint`.
+//
+// A `cov_db` holds one cover group: cover points with declarative bins (value
+// ranges, wildcards, transitions, ignore / illegal / default bins) and crosses
+// of two or more points. Samples are plain integers or little-endian uint64_t
+// limb arrays, bins are matched natively and the whole group is saved as a
+// compact binary database (`.covdb`) or as JSON. `cov_merge` (cov_merge.c)
+// merges any number of databases.
+//
+// The declarations below are mirrored by the `ffi.cdef` in
+// `src/lua/verilua/coverage/CovBinsNative.lua`, keep them in sync.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct cov_db cov_db;
+
+// Bin kinds. Values hitting an ignore or illegal bin are excluded from the
+// other bins of the point and from crosses. A default bin is hit when no other
+// bin of its point is.
+enum { COV_BIN_NORMAL = 0, COV_BIN_IGNORE = 1, COV_BIN_ILLEGAL = 2, COV_BIN_DEFAULT = 3 };
+
+// Bin types
+enum { COV_BIN_RANGE = 0, COV_BIN_WILDCARD = 1, COV_BIN_TRANSITION = 2, COV_BIN_OTHERS = 3 };
+
+// Message of the last failed call on this thread
+const char *cov_last_error(void);
+
+cov_db *cov_db_new(const char *name);
+void cov_db_free(cov_db *db);
+const char *cov_db_name(const cov_db *db);
+
+// Structure. Every adder returns the new index, or -1 once the group has been
+// sampled (the structure is frozen by the first sample) or on invalid input.
+int cov_point_add(cov_db *db, const char *name, uint32_t width);
+// [lo, hi], both inclusive
+int cov_bin_add_range(cov_db *db, int point, const char *name, int kind, uint64_t lo, uint64_t hi);
+// (v & mask) == (value & mask)
+int cov_bin_add_wildcard(cov_db *db, int point, const char *name, int kind, uint64_t value, uint64_t mask);
+// `nsteps` consecutive samples, sample i within [steps[2i], steps[2i + 1]]
+int cov_bin_add_transition(cov_db *db, int point, const char *name, int kind, const uint64_t *steps, uint32_t nsteps);
+int cov_bin_add_default(cov_db *db, int point, const char *name);
+int cov_cross_add(cov_db *db, const char *name, const uint32_t *points, uint32_t npoints);
+
+// Sampling. A point sample returns the number of illegal bins it hit (see
+// `cov_point_last_illegal`). Crosses are updated by `cov_group_commit` from the
+// points sampled since the previous commit. `cov_group_sample` samples points
+// 0..n-1 with `values` and commits, returning the total illegal hits.
+int cov_point_sample(cov_db *db, int point, uint64_t value);
+// Wide values: any set bit above bit 63 only matches the default bin
+int cov_point_sample_limbs(cov_db *db, int point, const uint64_t *limbs, size_t nlimbs);
+void cov_group_commit(cov_db *db);
+int cov_group_sample(cov_db *db, const uint64_t *values, size_t n);
+
+// Queries
+uint32_t cov_db_num_points(const cov_db *db);
+uint32_t cov_db_num_crosses(const cov_db *db);
+uint64_t cov_db_samples(const cov_db *db);
+const char *cov_point_name(const cov_db *db, int point);
+uint32_t cov_point_num_bins(const cov_db *db, int point);
+uint64_t cov_point_samples(const cov_db *db, int point);
+int cov_point_last_illegal(const cov_db *db, int point);
+const char *cov_bin_name(const cov_db *db, int point, int bin);
+int cov_bin_kind(const cov_db *db, int point, int bin);
+uint64_t cov_bin_hits(const cov_db *db, int point, int bin);
+const char *cov_cross_name(const cov_db *db, int cross);
+// Hits of one cross cell, `bins` holds one normal bin index per crossed point
+uint64_t cov_cross_hits(const cov_db *db, int cross, const uint32_t *bins);
+uint64_t cov_cross_num_cells(const cov_db *db, int cross);
+uint64_t cov_cross_covered_cells(const cov_db *db, int cross);
+// Coverage in percent: covered / total normal bins (cells for a cross), the
+// group coverage is the mean over its points and crosses.
+double cov_point_coverage(const cov_db *db, int point);
+double cov_cross_coverage(const cov_db *db, int cross);
+double cov_db_coverage(const cov_db *db);
+
+// Databases. A `.covdb` file holds one or more groups. Merging requires the
+// same structure (`cov_db_shape_hash`), the counters are summed. All return 0 on
+// success, -1 on failure.
+uint64_t cov_db_shape_hash(const cov_db *db);
+int cov_db_merge(cov_db *dst, const cov_db *src);
+int cov_db_save(const cov_db *db, const char *path);
+int cov_db_save_many(cov_db *const *dbs, size_t n, const char *path);
+// First group of the file, NULL on failure
+cov_db *cov_db_load(const char *path);
+// Every group of the file (free each with `cov_db_free`, then the array with
+// `free`), NULL on failure
+cov_db **cov_db_load_many(const char *path, size_t *n);
+// `meta` is inserted as is at the top of the JSON object (e.g. `"date": "..."`), may be NULL
+int cov_db_write_json(const cov_db *db, const char *path, const char *meta);
+int cov_db_write_json_many(cov_db *const *dbs, size_t n, const char *path, const char *meta);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
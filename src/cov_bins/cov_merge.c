@@ -0,0 +1,280 @@
+// cov_merge: merges coverage databases (`.covdb`, see cov_bins.h) written by
+// `CoverGroup:save()` into one database, optionally also as JSON.
+//
+//   cov_merge -o merged.covdb [-j threads] [--json merged.json] [-l list_file] a.covdb b.covdb ...
+//
+// Every worker thread loads files taken from a shared counter and folds them
+// into its own accumulator, the accumulators are merged at the end. Groups are
+// matched by name, a group whose bins or crosses differ from the one already
+// seen under the same name is an error.
+
+#define _GNU_SOURCE
+
+#include "cov_bins.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    cov_db **groups;
+    size_t ngroups, cap;
+} accumulator;
+
+typedef struct {
+    char **files;
+    size_t nfiles;
+    size_t next;
+    pthread_mutex_t lock;
+    int failed;
+    char error[1024];
+} job;
+
+typedef struct {
+    job *job;
+    accumulator acc;
+    size_t nloaded;
+} worker;
+
+static void fail(job *j, const char *msg) {
+    pthread_mutex_lock(&j->lock);
+    if (!j->failed) {
+        j->failed = 1;
+        snprintf(j->error, sizeof(j->error), "%s", msg);
+    }
+    pthread_mutex_unlock(&j->lock);
+}
+
+// Takes ownership of `db`
+static int accumulate(accumulator *acc, cov_db *db) {
+    for (size_t i = 0; i < acc->ngroups; i++) {
+        if (strcmp(cov_db_name(acc->groups[i]), cov_db_name(db)) == 0) {
+            const int ret = cov_db_merge(acc->groups[i], db);
+            cov_db_free(db);
+            return ret;
+        }
+    }
+    if (acc->ngroups == acc->cap) {
+        const size_t cap = acc->cap ? acc->cap * 2 : 16;
+        cov_db **groups  = (cov_db **)realloc(acc->groups, cap * sizeof(cov_db *));
+        if (!groups) {
+            cov_db_free(db);
+            return -1;
+        }
+        acc->groups = groups;
+        acc->cap    = cap;
+    }
+    acc->groups[acc->ngroups++] = db;
+    return 0;
+}
+
+static int cmp_group_name(const void *a, const void *b) {
+    return strcmp(cov_db_name(*(cov_db *const *)a), cov_db_name(*(cov_db *const *)b));
+}
+
+static void free_accumulator(accumulator *acc) {
+    for (size_t i = 0; i < acc->ngroups; i++) {
+        cov_db_free(acc->groups[i]);
+    }
+    free(acc->groups);
+}
+
+static void *worker_main(void *arg) {
+    worker *w = (worker *)arg;
+    job *j    = w->job;
+    char msg[1024];
+
+    for (;;) {
+        pthread_mutex_lock(&j->lock);
+        const size_t idx = j->next++;
+        const int stop   = j->failed || idx >= j->nfiles;
+        pthread_mutex_unlock(&j->lock);
+        if (stop) {
+            break;
+        }
+
+        size_t n     = 0;
+        cov_db **dbs = cov_db_load_many(j->files[idx], &n);
+        if (!dbs) {
+            fail(j, cov_last_error());
+            break;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (accumulate(&w->acc, dbs[i]) != 0) {
+                snprintf(msg, sizeof(msg), "%s: %s", j->files[idx], cov_last_error());
+                fail(j, msg);
+                for (size_t k = i + 1; k < n; k++) {
+                    cov_db_free(dbs[k]);
+                }
+                break;
+            }
+        }
+        free(dbs);
+        w->nloaded++;
+    }
+    return NULL;
+}
+
+static int read_list(const char *path, char ***files, size_t *nfiles, size_t *cap) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "[cov_merge] failed to open list file `%s`\n", path);
+        return -1;
+    }
+    char *line = NULL;
+    size_t len = 0;
+    ssize_t n;
+    while ((n = getline(&line, &len, fp)) >= 0) {
+        while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r' || line[n - 1] == ' ')) {
+            line[--n] = '\0';
+        }
+        if (n == 0 || line[0] == '#') {
+            continue;
+        }
+        if (*nfiles == *cap) {
+            *cap  = *cap ? *cap * 2 : 64;
+            *files = (char **)realloc(*files, *cap * sizeof(char *));
+        }
+        (*files)[(*nfiles)++] = strdup(line);
+    }
+    free(line);
+    fclose(fp);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s -o <out.covdb> [options] <input.covdb>...\n"
+            "Merge coverage databases written by CoverGroup:save().\n\n"
+            "Options:\n"
+            "  -o, --output <file>  merged database\n"
+            "  --json <file>        also write the merged result as JSON\n"
+            "  -l, --list <file>    read input paths from <file>, one per line\n"
+            "  -j, --jobs <n>       worker threads (default: number of CPUs)\n"
+            "  -q, --quiet          do not print the summary\n"
+            "  -h, --help           show this help\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    const char *output = NULL, *json = NULL;
+    long nthreads      = sysconf(_SC_NPROCESSORS_ONLN);
+    int quiet          = 0;
+    char **files       = NULL;
+    size_t nfiles = 0, cap = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const int has_value = i + 1 < argc;
+        if ((!strcmp(a, "-o") || !strcmp(a, "--output")) && has_value) {
+            output = argv[++i];
+        } else if (!strcmp(a, "--json") && has_value) {
+            json = argv[++i];
+        } else if ((!strcmp(a, "-l") || !strcmp(a, "--list")) && has_value) {
+            if (read_list(argv[++i], &files, &nfiles, &cap) != 0) {
+                return 1;
+            }
+        } else if ((!strcmp(a, "-j") || !strcmp(a, "--jobs")) && has_value) {
+            nthreads = strtol(argv[++i], NULL, 10);
+        } else if (!strcmp(a, "-q") || !strcmp(a, "--quiet")) {
+            quiet = 1;
+        } else if (!strcmp(a, "-h") || !strcmp(a, "--help")) {
+            usage(argv[0]);
+            return 0;
+        } else if (a[0] == '-') {
+            fprintf(stderr, "[cov_merge] unknown or incomplete option `%s`\n", a);
+            usage(argv[0]);
+            return 1;
+        } else {
+            if (nfiles == cap) {
+                cap   = cap ? cap * 2 : 64;
+                files = (char **)realloc(files, cap * sizeof(char *));
+            }
+            files[nfiles++] = strdup(a);
+        }
+    }
+
+    if (!output && !json) {
+        fprintf(stderr, "[cov_merge] no output, use -o and/or --json\n");
+        usage(argv[0]);
+        return 1;
+    }
+    if (nfiles == 0) {
+        fprintf(stderr, "[cov_merge] no input database\n");
+        return 1;
+    }
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
+    if ((size_t)nthreads > nfiles) {
+        nthreads = (long)nfiles;
+    }
+
+    job j = {files, nfiles, 0, PTHREAD_MUTEX_INITIALIZER, 0, {0}};
+    worker *workers = (worker *)calloc((size_t)nthreads, sizeof(worker));
+    pthread_t *tids = (pthread_t *)calloc((size_t)nthreads, sizeof(pthread_t));
+    for (long t = 0; t < nthreads; t++) {
+        workers[t].job = &j;
+        if (pthread_create(&tids[t], NULL, worker_main, &workers[t]) != 0) {
+            fail(&j, "failed to start a worker thread");
+            nthreads = t;
+            break;
+        }
+    }
+    for (long t = 0; t < nthreads; t++) {
+        pthread_join(tids[t], NULL);
+    }
+
+    // Reduce into the first worker's accumulator. Moved groups leave a NULL
+    // slot, the ones left after a failure are freed with their accumulator.
+    accumulator *acc = &workers[0].acc;
+    for (long t = 1; t < nthreads && !j.failed; t++) {
+        accumulator *other = &workers[t].acc;
+        for (size_t i = 0; i < other->ngroups; i++) {
+            cov_db *db       = other->groups[i];
+            other->groups[i] = NULL;
+            if (accumulate(acc, db) != 0) {
+                fail(&j, cov_last_error());
+                break;
+            }
+        }
+    }
+
+    // Which worker saw a group first depends on thread timing, order the output by name
+    qsort(acc->groups, acc->ngroups, sizeof(cov_db *), cmp_group_name);
+
+    int ret = 0;
+    if (j.failed) {
+        fprintf(stderr, "[cov_merge] %s\n", j.error);
+        ret = 1;
+    } else {
+        if (output && cov_db_save_many(acc->groups, acc->ngroups, output) != 0) {
+            fprintf(stderr, "[cov_merge] %s\n", cov_last_error());
+            ret = 1;
+        }
+        if (ret == 0 && json && cov_db_write_json_many(acc->groups, acc->ngroups, json, NULL) != 0) {
+            fprintf(stderr, "[cov_merge] %s\n", cov_last_error());
+            ret = 1;
+        }
+        if (ret == 0 && !quiet) {
+            printf("[cov_merge] merged %zu database(s) with %ld thread(s)\n", nfiles, nthreads);
+            for (size_t i = 0; i < acc->ngroups; i++) {
+                printf("  %-32s %7.2f%%  %llu samples\n", cov_db_name(acc->groups[i]), cov_db_coverage(acc->groups[i]),
+                       (unsigned long long)cov_db_samples(acc->groups[i]));
+            }
+        }
+    }
+
+    for (long t = 0; t < nthreads; t++) {
+        free_accumulator(&workers[t].acc);
+    }
+    free(workers);
+    free(tids);
+    for (size_t i = 0; i < nfiles; i++) {
+        free(files[i]);
+    }
+    free(files);
+    return ret;
+}
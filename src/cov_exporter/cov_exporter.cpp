@@ -13,39 +13,187 @@ using json = nlohmann::json;
 json metaInfoJson;
 std::string metaInfoFilePath;
 
-struct InstanceVisitor : public slang::ast::ASTVisitor<InstanceVisitor, false, false> {
-    int targetDepth;
-    std::string moduleName;
-    std::set<std::string> subModuleSet;
+// Definition name -> names of every definition instantiated (transitively)
+// below any instance of it. Built by a single walk of the hierarchy instead of
+// one full-design walk per recursive module / submodule.
+struct SubModuleCollector : public slang::ast::ASTVisitor<SubModuleCollector, false, false> {
+    std::unordered_map<std::string, std::set<std::string>> subModuleMap;
+    std::unordered_map<const slang::ast::InstanceBodySymbol *, std::set<std::string>> bodyCache;
+
+    const std::set<std::string> &descendants(const slang::ast::InstanceSymbol &instance) {
+        if (auto it = bodyCache.find(&instance.body); it != bodyCache.end()) {
+            return it->second;
+        }
 
-    InstanceVisitor(std::string moduleName, int targetDepth) : moduleName(moduleName), targetDepth(targetDepth) {}
+        std::set<std::string> result;
+        for (auto &inst : instance.body.membersOfType<slang::ast::InstanceSymbol>()) {
+            result.insert(std::string(inst.getDefinition().name));
+            auto &sub = descendants(inst);
+            result.insert(sub.begin(), sub.end());
+        }
+        return bodyCache.emplace(&instance.body, std::move(result)).first->second;
+    }
 
-    void iterInstance(const slang::ast::InstanceSymbol &instance, int depth) {
-        depth++;
+    void handle(const slang::ast::InstanceSymbol &instance) {
+        auto &sub = descendants(instance);
+        subModuleMap[std::string(instance.getDefinition().name)].insert(sub.begin(), sub.end());
+        visitDefault(instance);
+    }
+};
 
-        if (targetDepth != -1 && depth > targetDepth) {
-            return;
-        }
+// Module name -> hierarchical paths of its instances, for all target modules
+// in one walk (same DFS order as `slang_common::getHierPaths`).
+struct HierPathCollector : public slang::ast::ASTVisitor<HierPathCollector, false, false> {
+    const std::unordered_map<std::string, ModuleOption> &moduleOptionMap;
+    std::unordered_map<std::string, std::vector<std::string>> hierPathMap;
 
-        auto instIter = instance.body.membersOfType<slang::ast::InstanceSymbol>();
-        if (instIter.empty()) {
-            return;
-        }
-        for (auto &inst : instIter) {
-            subModuleSet.insert(std::string(inst.getDefinition().name));
-            this->iterInstance(inst, depth);
+    HierPathCollector(const std::unordered_map<std::string, ModuleOption> &moduleOptionMap) : moduleOptionMap(moduleOptionMap) {}
+
+    void handle(const slang::ast::InstanceSymbol &instance) {
+        auto name = std::string(instance.getDefinition().name);
+        if (moduleOptionMap.find(name) != moduleOptionMap.end()) {
+            hierPathMap[name].emplace_back(instance.getHierarchicalPath());
         }
+        visitDefault(instance);
     }
+};
+
+// Forces every lazily elaborated part of a default instance body so that the
+// coverage getters can later read it from several threads without mutating
+// the compilation. What the getters read, and what is forced here:
+//
+//   - the body members (`membersOfType`)   -> elaborated by visiting the body
+//   - net / variable types (`getType`)     -> ValueSymbol::getType
+//   - continuous assigns (`visitExprs`)    -> ContinuousAssignSymbol::getAssignment
+//   - procedural bodies (`getBody`)        -> ProceduralBlockSymbol::getBody,
+//     whose statements and expressions are visited too
+//
+// Child instances are not entered, the getters only look at the members of the
+// module itself. `assertWarmed` checks that no such member was missed.
+struct ElaborationWarmer : public slang::ast::ASTVisitor<ElaborationWarmer, true, true> {
+    const slang::ast::InstanceSymbol *root;
+    std::unordered_set<const slang::ast::Symbol *> warmed;
+
+    ElaborationWarmer(const slang::ast::InstanceSymbol *root) : root(root) {}
 
     void handle(const slang::ast::InstanceSymbol &instance) {
-        if (instance.getDefinition().name == moduleName) {
-            this->iterInstance(instance, 1);
+        if (&instance == root) {
+            visitDefault(instance);
         }
+    }
 
-        visitDefault(instance);
+    void handle(const slang::ast::ValueSymbol &symbol) {
+        (void)symbol.getType();
+        warmed.insert(&symbol);
+        visitDefault(symbol);
+    }
+
+    void handle(const slang::ast::ContinuousAssignSymbol &symbol) {
+        (void)symbol.getAssignment();
+        warmed.insert(&symbol);
+        visitDefault(symbol);
+    }
+
+    void handle(const slang::ast::ProceduralBlockSymbol &symbol) {
+        (void)symbol.getBody();
+        warmed.insert(&symbol);
+        visitDefault(symbol);
+    }
+
+    // Every member kind read by CoverageInfoGetter must have been forced. The
+    // body is elaborated at this point, iterating it does not mutate anything.
+    void assertWarmed() const {
+        using slang::ast::SymbolKind;
+        for (auto &member : root->body.members()) {
+            if (member.kind == SymbolKind::Net || member.kind == SymbolKind::Variable || member.kind == SymbolKind::ContinuousAssign || member.kind == SymbolKind::ProceduralBlock) {
+                ASSERT(warmed.count(&member), "Member not elaborated before the parallel collection", root->name, member.name, toString(member.kind));
+            }
+        }
     }
 };
 
+struct ModuleSyntaxCollector : public slang::syntax::SyntaxVisitor<ModuleSyntaxCollector> {
+    std::unordered_map<std::string, const slang::syntax::ModuleDeclarationSyntax *> moduleSyntaxMap;
+
+    void handle(const slang::syntax::ModuleDeclarationSyntax &syntax) {
+        moduleSyntaxMap.emplace(std::string(syntax.header->name.rawText()), &syntax);
+        visitDefault(syntax);
+    }
+};
+
+struct OutputFileRecord {
+    std::string path;   // <outdir>/<file>
+    std::string source; // Original input file (from the //BEGIN: marker)
+    std::string contentHash;
+    bool written = false;
+};
+
+// Split the printed tree (with //BEGIN: / //END: markers, see
+// `slang_common::file_manage::backupFile`) and write the files on `jobs`
+// threads. Produces the same bytes as `file_manage::generateNewFile`.
+// A file whose current content is already identical is left untouched so its
+// mtime does not change and downstream builds are not invalidated.
+static std::vector<OutputFileRecord> writeOutputFiles(const std::string &content, const std::string &outdir, size_t jobs) {
+    struct OutputFile {
+        std::string path;
+        std::string source;
+        std::vector<std::string_view> lines;
+    };
+    std::vector<OutputFile> outputFiles;
+
+    std::string_view view(content);
+    OutputFile *current = nullptr;
+    size_t pos          = 0;
+    while (pos < view.size()) {
+        auto end  = view.find('\n', pos);
+        auto line = view.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        pos       = end == std::string_view::npos ? view.size() : end + 1;
+
+        if (line.starts_with("//BEGIN:")) {
+            std::string source(line.substr(8));
+            std::filesystem::path path(source);
+            outputFiles.emplace_back(OutputFile{outdir + "/" + path.filename().string(), source, {}});
+            current = &outputFiles.back();
+        } else if (line.starts_with("//END:")) {
+            current = nullptr;
+        } else if (current != nullptr) {
+            current->lines.emplace_back(line);
+        }
+    }
+
+    std::vector<OutputFileRecord> records(outputFiles.size());
+    parallelFor(outputFiles.size(), jobs, [&](size_t i) {
+        auto &f = outputFiles[i];
+        std::string data;
+        for (auto &l : f.lines) {
+            data.append(l);
+            data.push_back('\n');
+        }
+
+        auto &record       = records[i];
+        record.path        = f.path;
+        record.source      = f.source;
+        record.contentHash = hashToString(hashBytes(data));
+
+        {
+            std::ifstream in(f.path, std::ios::in | std::ios::binary);
+            if (in.is_open()) {
+                std::string old((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+                if (old == data) {
+                    return;
+                }
+            }
+        }
+
+        std::ofstream out(f.path, std::ios::out | std::ios::trunc | std::ios::binary);
+        ASSERT(out.is_open(), "Failed to open output file", f.path);
+        out << data;
+        record.written = true;
+    });
+
+    return records;
+}
+
 struct CovExporter {
     std::vector<std::string> moduleNames;
     std::vector<std::string> recursiveModules;
@@ -54,15 +202,20 @@ struct CovExporter {
     std::vector<std::string> globalDisableSignalPatterns;
     std::vector<std::string> clockSignals;
     std::optional<bool> noSepAlwaysBlock;
+    std::optional<bool> packedToggle;
+    std::optional<uint32_t> packedCounterWidth;
     std::optional<bool> errPrintTree;
     std::optional<bool> quiet;
     std::optional<bool> relativeFilePath;
+    std::optional<uint32_t> numJobs;
+    std::optional<bool> nocache;
     std::optional<std::string> defaultClockName;
     std::optional<std::string> altClockName;
     std::optional<std::string> _workdir;
     std::optional<std::string> _outdir;
     std::string workdir;
     std::string outdir;
+    std::string cmdLineStr;
 
     std::unordered_map<std::string, ModuleOption> moduleOptionMap;
     std::vector<std::string> tmpFiles;
@@ -84,10 +237,74 @@ struct CovExporter {
         driver.cmdLine.add("--dc,--default-clock", defaultClockName, "Default clock signal name(default: `clock`)", "<signal name>");
         driver.cmdLine.add("--ac,--alt-clock", altClockName, "Alternative clock signal name(default: `tb_top.clock`), available when defaultClock cannot be found in the module", "<signal name>");
         driver.cmdLine.add("--ns,--no-sep-always-block", noSepAlwaysBlock, "Disable seperating always block");
+        driver.cmdLine.add("--pt,--packed-toggle", packedToggle, "Pack toggle coverage of each module into one bitmap updated by a single always block(readable in bulk via `getToggleBitmap`)");
+        driver.cmdLine.add("--pcw,--packed-counter-width", packedCounterWidth, "Width of the optional saturating toggle counters in packed toggle mode(default: 0, no counters, max: 32)", "<bits>");
         driver.cmdLine.add("--rfp,--relative-file-path", relativeFilePath, "use relative path for meta info file path in generated code");
+        driver.cmdLine.add("--nj,--num-jobs", numJobs, "Number of threads used to collect, render and write coverage info(default: hardware concurrency)", "<n>");
+        driver.cmdLine.add("--nc,--no-cache", nocache, "Do not use cache files, always regenerate and rewrite every output file");
         driver.cmdLine.add("-q,--quiet", quiet, "Quiet mode, print only necessary info");
     }
 
+    // The whole run is skipped only if nothing it depends on has changed: the
+    // tool version, the command line, every input / included file and every
+    // output file as we left it. A per-file skip is not possible before
+    // elaboration because hierPaths and recursive module sets make an output
+    // depend on other input files.
+    bool checkForRegenerate() {
+        if (nocache.value_or(false)) {
+            return true;
+        }
+
+        if (!std::filesystem::exists(metaInfoFilePath)) {
+            fmt::println("[cov_exporter] meta info file not found, regenerating...");
+            return true;
+        }
+
+        std::ifstream metaInfoFile(metaInfoFilePath);
+        if (!metaInfoFile.is_open()) {
+            fmt::println("[cov_exporter] failed to open meta info file, regenerating...");
+            return true;
+        }
+        auto oldMetaInfoJson = json::parse(metaInfoFile, nullptr, false);
+        metaInfoFile.close();
+        if (oldMetaInfoJson.is_discarded() || !oldMetaInfoJson.contains("cache")) {
+            fmt::println("[cov_exporter] no cache info in meta info file, regenerating...");
+            return true;
+        }
+
+        auto &cache = oldMetaInfoJson["cache"];
+        if (cache.value("version", "") != VERILUA_VERSION) {
+            fmt::println("[cov_exporter] tool version changed, regenerating...");
+            return true;
+        }
+
+        if (cache.value("cmdLine", "") != cmdLineStr) {
+            fmt::println("[cov_exporter] cmdLine changed, regenerating...");
+            return true;
+        }
+
+        if (cache.value("filelist", std::vector<std::string>{}) != driver.getFiles()) {
+            fmt::println("[cov_exporter] filelist changed, regenerating...");
+            return true;
+        }
+
+        for (auto &[file, hash] : cache["dependencies"].items()) {
+            if (hashFile(file) != hash.get<std::string>()) {
+                fmt::println("[cov_exporter] `{}` changed, regenerating...", file);
+                return true;
+            }
+        }
+
+        for (auto &[file, output] : cache["outputs"].items()) {
+            if (hashFile(file) != output.value("contentHash", "")) {
+                fmt::println("[cov_exporter] output file `{}` is missing or modified, regenerating...", file);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     ~CovExporter() {
         for (auto &file : tmpFiles) {
             DELETE_FILE(file);
@@ -100,12 +317,31 @@ struct CovExporter {
 
         Config::getInstance().quietEnabled   = quiet.value_or(false);
         Config::getInstance().sepAlwaysBlock = !noSepAlwaysBlock.value_or(false);
+        Config::getInstance().packedToggle   = packedToggle.value_or(false);
+
+        if (packedCounterWidth.has_value()) {
+            ASSERT(packedToggle.value_or(false), "`--packed-counter-width` requires `--packed-toggle`");
+            ASSERT(packedCounterWidth.value() <= 32, "`--packed-counter-width` should be in range [0, 32]", packedCounterWidth.value());
+            Config::getInstance().packedCounterWidth = packedCounterWidth.value();
+        }
 
         workdir = _workdir.value_or("./.cov_exporter");
         outdir  = _outdir.value_or(workdir);
 
         metaInfoFilePath = outdir + "/cov_exporter.meta.json";
 
+        // `--nc` only decides whether the cache is used, a run with it must
+        // still leave a cache that a later run without it can reuse
+        cmdLineStr.clear();
+        for (int i = 0; i < argc; i++) {
+            std::string_view arg = argv[i];
+            if (arg == "--nc" || arg == "--no-cache" || arg.starts_with("--nc=") || arg.starts_with("--no-cache=")) {
+                continue;
+            }
+            cmdLineStr += arg;
+            cmdLineStr += " ";
+        }
+
         for (const auto &moduleName : moduleNames) {
             ModuleOption moduleOption(moduleName, defaultClockName.value_or(DEFAULT_CLOCK_NAME), altClockName.value_or(ALTERNATIVE_CLOCK_NAME));
             moduleOptionMap.emplace(moduleName, moduleOption);
@@ -135,7 +371,11 @@ struct CovExporter {
             fmt::println("[cov_exporter] Clock signal name, moduleName: <{}>, signalName: <{}>", moduleOption->moduleName, signalName);
         }
 
-        // TODO: Check for regenerate
+        if (!this->checkForRegenerate()) {
+            fmt::println("[cov_exporter] No need to regenerate, using cache files");
+            return;
+        }
+
         if (!std::filesystem::exists(workdir)) {
             std::filesystem::create_directories(workdir);
         }
@@ -161,6 +401,19 @@ struct CovExporter {
         auto endTime = std::chrono::high_resolution_clock::now();
         fmt::println("[cov_exporter] Parse time: {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count());
 
+        size_t jobs = numJobs.value_or(std::max(1u, std::thread::hardware_concurrency()));
+
+        std::unordered_map<std::string, std::set<std::string>> subModuleMap;
+        if (!recursiveModules.empty()) {
+            SubModuleCollector collector;
+            compilation->getRoot().visit(collector);
+            subModuleMap = std::move(collector.subModuleMap);
+        }
+        auto getSubModules = [&](const std::string &moduleName) {
+            auto it = subModuleMap.find(moduleName);
+            return it == subModuleMap.end() ? std::set<std::string>{} : it->second;
+        };
+
         for (auto &recursiveModule : recursiveModules) {
             auto it = moduleOptionMap.find(recursiveModule);
             if (it == moduleOptionMap.end()) {
@@ -169,11 +422,9 @@ struct CovExporter {
             auto &moduleOption = it->second;
 
             // Get submodules of the target recursive module
-            auto v = InstanceVisitor(recursiveModule, -1); // TODO: Configurable depth
-            compilation->getRoot().visit(v);
-            moduleOption.subModuleSet = v.subModuleSet;
+            moduleOption.subModuleSet = getSubModules(recursiveModule);
 
-            for (auto &subModule : v.subModuleSet) {
+            for (auto &subModule : getSubModules(recursiveModule)) {
                 if (moduleOptionMap.find(std::string(subModule)) != moduleOptionMap.end()) {
                     continue;
                 }
@@ -193,11 +444,9 @@ struct CovExporter {
                 }
 
                 ModuleOption moduleOption1(std::string(subModule), defaultClockName.value_or(DEFAULT_CLOCK_NAME), altClockName.value_or(ALTERNATIVE_CLOCK_NAME));
-                auto v1 = InstanceVisitor(subModule, -1); // TODO: Configurable depth
-                compilation->getRoot().visit(v1);
-                moduleOption1.subModuleSet = v1.subModuleSet;
+                moduleOption1.subModuleSet = getSubModules(subModule);
                 // Also need to check disable module patterns for submodules
-                for (auto &subModule1 : v1.subModuleSet) {
+                for (auto &subModule1 : getSubModules(subModule)) {
                     for (auto &disableModulePattern : disableModulePatterns) {
                         std::regex re(disableModulePattern);
                         if (std::regex_match(std::string(subModule1), re)) {
@@ -225,7 +474,11 @@ struct CovExporter {
         //   compilation = driver.createAndReportCompilation()
         //       |
         //       v
-        //   for each target module:
+        //   prepare (serial): module syntax index, hierPaths of all modules
+        //   in one walk, default instance per module + ElaborationWarmer
+        //       |
+        //       v
+        //   for each target module:                (thread pool, --num-jobs)
         //       +-------------------------------------+
         //       |  CoverageInfoGetter (visit syntax)  |
         //       |   -> collect netMap / varMap        |
@@ -233,6 +486,9 @@ struct CovExporter {
         //       +-------------------------------------+
         //       |
         //       v
+        //   CoverageInfoWritter(...)   render instrumentation text per
+        //       |                      module (thread pool)
+        //       v
         //   CoverageInfoWritter::transform(tree)  (single pass, all modules)
         //       +-------------------------------------+
         //       | Step 1: replace top-level if-trees  |  (cond-path)
@@ -242,21 +498,69 @@ struct CovExporter {
         //       +-------------------------------------+
         //       |
         //       v
-        //   SyntaxPrinter::printFile(tree)  +  generateNewFile()
+        //   SyntaxPrinter::printFile(tree)  +  writeOutputFiles() (thread pool)
         //       |
         //       v
         //   <outdir>/<file>.sv  (instrumented RTL ready for simulation)
         //
         // ==================================================================
 
+        // Modules are processed in name order and every result lands in its
+        // own slot, so the output does not depend on thread scheduling.
+        std::vector<std::string> sortedModuleNames;
+        for (auto &[moduleName, _] : moduleOptionMap) {
+            sortedModuleNames.emplace_back(moduleName);
+        }
+        std::sort(sortedModuleNames.begin(), sortedModuleNames.end());
+
+        // Prepare (serial): everything that may mutate the compilation.
+        ModuleSyntaxCollector syntaxCollector;
+        tree->root().visit(syntaxCollector);
+
+        HierPathCollector hierPathCollector(moduleOptionMap);
+        compilation->getRoot().visit(hierPathCollector);
+
+        std::vector<const slang::syntax::ModuleDeclarationSyntax *> moduleSyntaxes(sortedModuleNames.size(), nullptr);
+        std::vector<const slang::ast::InstanceSymbol *> moduleInsts(sortedModuleNames.size(), nullptr);
+        for (size_t i = 0; i < sortedModuleNames.size(); i++) {
+            auto it = syntaxCollector.moduleSyntaxMap.find(sortedModuleNames[i]);
+            if (it == syntaxCollector.moduleSyntaxMap.end()) {
+                continue;
+            }
+            moduleSyntaxes[i] = it->second;
+
+            auto def       = compilation->getDefinition(static_cast<const Scope &>(compilation->getRoot()), *it->second);
+            moduleInsts[i] = &InstanceSymbol::createDefault(*compilation, *def);
+
+            ElaborationWarmer warmer(moduleInsts[i]);
+            moduleInsts[i]->visit(warmer);
+            warmer.assertWarmed();
+        }
+
+        // Collect (parallel): the getters only read the compilation now.
+        static const std::vector<std::string> emptyHierPaths;
+        std::vector<std::unique_ptr<CoverageInfoGetter>> getters(sortedModuleNames.size());
+        parallelFor(sortedModuleNames.size(), jobs, [&](size_t i) {
+            auto &moduleOption = moduleOptionMap.at(sortedModuleNames[i]);
+            getters[i]         = std::make_unique<CoverageInfoGetter>(moduleOption, globalDisableSignalPatterns, compilation.get());
+            if (moduleSyntaxes[i] == nullptr) {
+                return;
+            }
+
+            auto hierIt                   = hierPathCollector.hierPathMap.find(sortedModuleNames[i]);
+            getters[i]->preparedInst      = moduleInsts[i];
+            getters[i]->preparedHierPaths = hierIt == hierPathCollector.hierPathMap.end() ? &emptyHierPaths : &hierIt->second;
+            moduleSyntaxes[i]->visit(*getters[i]);
+        });
+
         // Get coverage signal info
         std::vector<CoverageInfo> coverageInfos;
-        for (auto [moduleName, moduleOption] : moduleOptionMap) {
+        for (size_t i = 0; i < sortedModuleNames.size(); i++) {
+            auto &moduleName   = sortedModuleNames[i];
+            auto &moduleOption = moduleOptionMap.at(moduleName);
+            auto &getter       = *getters[i];
             fmt::println("[cov_exporter] Processing module: `{}`", moduleName);
 
-            CoverageInfoGetter getter(moduleOption, globalDisableSignalPatterns, compilation.get());
-            tree->root().visit(getter);
-
             ASSERT(getter.findModule, "Module not found", moduleOption.moduleName, moduleOption.disablePatterns);
 
             auto findClock = [&]() {
@@ -290,15 +594,25 @@ struct CovExporter {
                 }
             }
 
-            auto coverageInfo = getter.coverageInfo;
-            coverageInfos.emplace_back(coverageInfo);
+            coverageInfos.emplace_back(std::move(getter.coverageInfo));
+        }
+
+        // Included files are dependencies of the cache too. Must be collected
+        // before the rewrite replaces `tree`.
+        auto &sourceManager = driver.driver.sourceManager;
+        std::vector<std::string> includeFiles;
+        for (auto &include : tree->getIncludeDirectives()) {
+            auto includePath = sourceManager.getFullPath(include.buffer.id).string();
+            if (!includePath.empty()) {
+                includeFiles.emplace_back(std::move(includePath));
+            }
         }
 
         // Write coverage signal info. We use a single rewriter pass over the
         // original tree so all body-replacement pointers (which were captured
         // against this very tree) stay valid.
         if (!coverageInfos.empty()) {
-            CoverageInfoWritter writter(coverageInfos, relativeFilePath.value_or(false));
+            CoverageInfoWritter writter(coverageInfos, relativeFilePath.value_or(false), jobs);
             tree = writter.transform(tree);
         }
 
@@ -316,13 +630,43 @@ struct CovExporter {
             metaInfoJson["exportedModules"][coverageInfo.moduleName]["statistics"]["varCount"]     = coverageInfo.statistic.varCount;
             metaInfoJson["exportedModules"][coverageInfo.moduleName]["statistics"]["binExprCount"] = coverageInfo.statistic.binExprCount;
             metaInfoJson["exportedModules"][coverageInfo.moduleName]["subModules"]                 = coverageInfo.subModuleSet;
+            if (Config::getInstance().packedToggle) {
+                metaInfoJson["exportedModules"][coverageInfo.moduleName]["packedToggle"]["signals"]      = coverageInfo.packedToggleSignals;
+                metaInfoJson["exportedModules"][coverageInfo.moduleName]["packedToggle"]["counterWidth"] = Config::getInstance().packedCounterWidth;
+            }
+        }
+
+        auto records = writeOutputFiles(SyntaxPrinter::printFile(*tree), outdir, jobs);
+
+        size_t writtenCount = 0;
+        json cacheJson;
+        cacheJson["version"]  = VERILUA_VERSION;
+        cacheJson["cmdLine"]  = cmdLineStr;
+        cacheJson["filelist"] = driver.getFiles();
+        for (auto &file : driver.getFiles()) {
+            cacheJson["dependencies"][file] = hashFile(file);
+        }
+        for (auto &includePath : includeFiles) {
+            cacheJson["dependencies"][includePath] = hashFile(includePath);
+        }
+        for (auto &record : records) {
+            cacheJson["outputs"][record.path]["source"]      = record.source;
+            cacheJson["outputs"][record.path]["contentHash"] = record.contentHash;
+            writtenCount += record.written ? 1 : 0;
+        }
+        metaInfoJson["cache"] = cacheJson;
+
+        // Rewrite the meta info file only if it changed, it is also an input
+        // of the simulation build (`CoverageGetter` reads it at runtime).
+        auto metaInfoStr = metaInfoJson.dump(4) + "\n";
+        if (hashFile(metaInfoFilePath) != hashToString(hashBytes(metaInfoStr))) {
+            std::ofstream o(metaInfoFilePath, std::ios::out | std::ios::trunc | std::ios::binary);
+            ASSERT(o.is_open(), "Failed to open meta info file", metaInfoFilePath);
+            o << metaInfoStr;
+            o.close();
         }
-        std::ofstream o(metaInfoFilePath);
-        ASSERT(o.is_open(), "Failed to open meta info file", metaInfoFilePath);
-        o << metaInfoJson.dump(4) << std::endl;
-        o.close();
 
-        slang_common::file_manage::generateNewFile(SyntaxPrinter::printFile(*tree), outdir);
+        fmt::println("[cov_exporter] Output files: {} rewritten, {} unchanged, outdir: {}", writtenCount, records.size() - writtenCount, outdir);
     }
 };
 
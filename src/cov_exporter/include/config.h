@@ -1,9 +1,13 @@
 #pragma once
 
+#include <cstdint>
+
 class Config {
   public:
     bool quietEnabled{false};
     bool sepAlwaysBlock{true};
+    bool packedToggle{false};
+    uint32_t packedCounterWidth{0};
 
     Config() = default;
 
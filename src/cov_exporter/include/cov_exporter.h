@@ -3,6 +3,7 @@
 #include "SlangCommon.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
+#include "fmt/ranges.h"
 #include "nlohmann/json.hpp"
 #include "slang/ast/ASTVisitor.h"
 #include "slang/ast/symbols/CompilationUnitSymbols.h"
@@ -10,14 +11,18 @@
 #include "slang/ast/symbols/VariableSymbols.h"
 #include "slang/ast/types/AllTypes.h"
 #include "vl_assert.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <optional>
 #include <regex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -79,6 +84,56 @@ inline std::string replaceString(std::string str, const char *pattern, const cha
 
 inline std::string replaceString(std::string str, std::string pattern, std::string replacement) { return replaceString(str, pattern.c_str(), replacement.c_str()); };
 
+// Run `fn(i)` for every i in [0, n) on up to `jobs` threads. Indices are
+// handed out through an atomic cursor, so callers must write results into
+// per-index slots to keep the output independent of thread scheduling.
+template <typename Fn> void parallelFor(size_t n, size_t jobs, Fn &&fn) {
+    jobs = std::max<size_t>(1, std::min(jobs, n));
+    if (jobs == 1) {
+        for (size_t i = 0; i < n; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> cursor{0};
+    std::vector<std::thread> workers;
+    workers.reserve(jobs);
+    for (size_t t = 0; t < jobs; t++) {
+        workers.emplace_back([&]() {
+            for (size_t i = cursor.fetch_add(1); i < n; i = cursor.fetch_add(1)) {
+                fn(i);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+}
+
+// 64-bit FNV-1a, used for the output cache in `cov_exporter.meta.json`. Not
+// cryptographic, only needs to be stable across runs and platforms.
+inline uint64_t hashBytes(std::string_view data, uint64_t seed = 0xcbf29ce484222325ULL) {
+    uint64_t h = seed;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+inline std::string hashToString(uint64_t h) { return fmt::format("{:016x}", h); }
+
+// Hash of a file's content, or an empty string if it cannot be read.
+inline std::string hashFile(const std::string &path) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        return "";
+    }
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return hashToString(hashBytes(content));
+}
+
 // =====================================================================
 // Coverage data model (per module)
 // =====================================================================
@@ -112,6 +167,8 @@ struct SignalInfo {
     std::string typeStr;
     size_t line;
     std::string file;
+    // Packed bit width, only used by the packed toggle layout.
+    uint64_t bitWidth = 0;
 };
 
 // One control-flow path entry. Identified uniquely by its `guard` string
@@ -152,6 +209,10 @@ struct CoverageInfo {
     std::unordered_map<std::string, size_t> condPathIndex;
     // Top-level conditional statements scheduled for source rewriting.
     std::vector<CondPathTopRewrite> condRewrites;
+    // Packed toggle layout only: signal name for each bit of the toggle
+    // bitmap (bit i <-> packedToggleSignals[i]). Filled by the writer and
+    // saved into the meta file so readers can decode the bitmap.
+    std::vector<std::string> packedToggleSignals;
 
     struct Statistic {
         uint64_t netCount;
@@ -44,6 +44,13 @@ struct CoverageInfoGetter : public slang::syntax::SyntaxVisitor<CoverageInfoGett
 
     CoverageInfo coverageInfo;
 
+    // Optional state prepared serially by CovExporter (see `prepareModules`).
+    // When both are set the getter neither creates the default instance nor
+    // walks the hierarchy itself, it only reads the already elaborated
+    // compilation, which makes it safe to run getters on several threads.
+    const slang::ast::InstanceSymbol *preparedInst    = nullptr;
+    const std::vector<std::string> *preparedHierPaths = nullptr;
+
     CoverageInfoGetter(ModuleOption moduleOption, std::vector<std::string> globalDisableSignalPatterns, slang::ast::Compilation *compilation) : moduleOption(moduleOption), globalDisableSignalPatterns(globalDisableSignalPatterns), compilation(compilation) {
         coverageInfo.moduleName = moduleOption.moduleName;
         coverageInfo.clockName  = moduleOption.clockName;
@@ -65,12 +72,15 @@ struct CoverageInfoGetter : public slang::syntax::SyntaxVisitor<CoverageInfoGett
     void handle(const slang::syntax::ModuleDeclarationSyntax &syntax) {
         if (syntax.header->name.rawText() == moduleOption.moduleName) {
             findModule = true;
-            auto def   = compilation->getDefinition(static_cast<const Scope &>(compilation->getRoot()), syntax);
-            auto inst  = &InstanceSymbol::createDefault(*compilation, *def);
+            auto inst  = preparedInst;
+            if (inst == nullptr) {
+                auto def = compilation->getDefinition(static_cast<const Scope &>(compilation->getRoot()), syntax);
+                inst     = &InstanceSymbol::createDefault(*compilation, *def);
+            }
 
             INFO_PRINT("[cov_info_getter] moduleName: {}", moduleOption.moduleName);
 
-            std::vector<std::string> hierPaths = slang_common::getHierPaths(compilation, moduleOption.moduleName);
+            std::vector<std::string> hierPaths = preparedHierPaths != nullptr ? *preparedHierPaths : slang_common::getHierPaths(compilation, moduleOption.moduleName);
             for (auto &hierPath : hierPaths) {
                 INFO_PRINT("\thierPath: {}", hierPath);
                 coverageInfo.hierPaths.emplace_back(hierPath);
@@ -213,7 +223,7 @@ struct CoverageInfoGetter : public slang::syntax::SyntaxVisitor<CoverageInfoGett
 
                 // TODO: wire a = c | d; ??
 
-                coverageInfo.netMap.emplace(net.name, SignalInfo{std::string(toString(net.getType().kind)), std::string(net.getType().toString()), line, file});
+                coverageInfo.netMap.emplace(net.name, SignalInfo{std::string(toString(net.getType().kind)), std::string(net.getType().toString()), line, file, net.getType().getBitWidth()});
             }
 
             count = 0;
@@ -243,7 +253,7 @@ struct CoverageInfoGetter : public slang::syntax::SyntaxVisitor<CoverageInfoGett
                     continue;
                 }
 
-                coverageInfo.varMap.emplace(var.name, SignalInfo{std::string(toString(var.getType().kind)), std::string(var.getType().toString()), line, file});
+                coverageInfo.varMap.emplace(var.name, SignalInfo{std::string(toString(var.getType().kind)), std::string(var.getType().toString()), line, file, var.getType().getBitWidth()});
             }
 
             // TODO: Optimize some simple expr? (e.g. assign a = c & d;)
@@ -31,8 +31,15 @@
 //     |                 `endif
 //     endmodule
 //
+//   With `--packed-toggle` the per-signal toggle counters in step 3
+//   are replaced by one toggled-ever bitmap per module (plus optional
+//   saturating counters) updated by a single always block, and the
+//   bitmap can be bulk-copied out via `getToggleBitmap`.
+//
 //   Single transform pass: all modules share one rewriter so the
 //   cond-path body pointers (anchored in the original tree) stay valid.
+//   The text of steps 2/3 is rendered per module beforehand (in
+//   parallel), the pass only parses and splices it in.
 //   Defining NO_COVERAGE strips every guarded region -> clean RTL.
 //
 //   NOTE: The front insert is skipped when condPaths is empty because a
@@ -47,10 +54,25 @@ struct CoverageInfoWritter : public slang::syntax::SyntaxRewriter<CoverageInfoWr
     // Lookup: module name -> coverageInfos index. Built once on construction.
     std::unordered_map<std::string, size_t> moduleIndex;
 
-    CoverageInfoWritter(std::vector<CoverageInfo> &coverageInfos, bool relativeFilePath) : coverageInfos(coverageInfos), relativeFilePath(relativeFilePath) {
+    // Instrumentation text of one module, rendered ahead of the rewrite.
+    struct RenderedModule {
+        std::string frontText; // empty when the front insert is skipped
+        std::string backText;
+    };
+    // Parallel to `coverageInfos`.
+    std::vector<RenderedModule> renderedModules;
+
+    // Rendering the instrumentation text only reads the module's own
+    // CoverageInfo, so it is done for all modules up front on `jobs` threads.
+    // The rewrite itself (parse + replace/insert) stays a single pass because
+    // the rewriter's allocator and the anchored body pointers are shared.
+    CoverageInfoWritter(std::vector<CoverageInfo> &coverageInfos, bool relativeFilePath, size_t jobs = 1) : coverageInfos(coverageInfos), relativeFilePath(relativeFilePath) {
         for (size_t i = 0; i < coverageInfos.size(); i++) {
             moduleIndex.emplace(coverageInfos[i].moduleName, i);
         }
+
+        renderedModules.resize(coverageInfos.size());
+        parallelFor(coverageInfos.size(), jobs, [&](size_t i) { renderedModules[i] = render(coverageInfos[i]); });
     }
 
     void handle(const slang::syntax::ModuleDeclarationSyntax &syntax) {
@@ -93,6 +115,7 @@ struct CoverageInfoWritter : public slang::syntax::SyntaxRewriter<CoverageInfoWr
             return;
         }
         auto &coverageInfo = coverageInfos[it->second];
+        auto &rendered     = renderedModules[it->second];
 
         // Counter ids are assigned by the getter (in collection order); the
         // writer trusts those ids and only emits matching declarations and
@@ -117,6 +140,19 @@ struct CoverageInfoWritter : public slang::syntax::SyntaxRewriter<CoverageInfoWr
             replace(*topPtr, newNode);
         }
 
+        // -----------------------------------------------------------------
+        // Step 2/3: splice in the pre-rendered declarations and helpers
+        // (see render()).
+        // -----------------------------------------------------------------
+        if (!rendered.frontText.empty()) {
+            insertAtFront(syntax.members, parse(rendered.frontText));
+        }
+        insertAtBack(syntax.members, parse(rendered.backText));
+    }
+
+    RenderedModule render(CoverageInfo &coverageInfo) const {
+        RenderedModule rendered;
+
         // -----------------------------------------------------------------
         // Step 2: append module-level declarations and helpers.
         // -----------------------------------------------------------------
@@ -154,7 +190,7 @@ struct CoverageInfoWritter : public slang::syntax::SyntaxRewriter<CoverageInfoWr
                 allBinExprCntSignalVec.emplace_back(cnt);
             }
             frontDeclLines.emplace_back("`endif // NO_COVERAGE");
-            insertAtFront(syntax.members, parse("\n" + fmt::to_string(fmt::join(frontDeclLines, "\n")) + "\n"));
+            rendered.frontText = "\n" + fmt::to_string(fmt::join(frontDeclLines, "\n")) + "\n";
             frontInserted = true;
         } else {
             // No cond-path points: _COV_EN will be emitted in the back block.
@@ -217,9 +253,93 @@ end
             }
         };
 
+        // Packed toggle layout (`--packed-toggle`): every covered signal of the
+        // module shares one toggled-ever bitmap instead of owning an `int`
+        // counter, a `_LAST` register and an always block.
+        //
+        //   wire [W-1:0] _COV_TOGGLE_CUR  = {sN, ..., s1, s0};
+        //   bit  [W-1:0] _COV_TOGGLE_LAST;
+        //   wire [W-1:0] _COV_TOGGLE_DIFF = _COV_TOGGLE_CUR ^ _COV_TOGGLE_LAST;
+        //   wire [N-1:0] _COV_TOGGLE_HIT  = {|DIFF[sN], ..., |DIFF[s0]};
+        //   bit  [32*ceil(N/32)-1:0] _COV_TOGGLE_MAP;  <-- bit i: signal i toggled
+        //   bit  [C-1:0] _COV_TOGGLE_CNT [N];          <-- optional, saturating
+        //   always @(posedge clk) if(_COV_EN) MAP |= HIT; LAST <= CUR; ...
+        //
+        // Bit order is the sorted signal name order and is recorded in
+        // `coverageInfo.packedToggleSignals` (saved into the meta file).
+        const bool packedToggle = Config::getInstance().packedToggle;
+        const auto counterWidth = Config::getInstance().packedCounterWidth;
+        size_t packedToggleCount = 0;
+        if (packedToggle) {
+            struct PackedEntry {
+                std::string name;
+                const SignalInfo *info;
+            };
+            std::vector<PackedEntry> entries;
+            for (const auto &pair : coverageInfo.netMap) {
+                entries.emplace_back(PackedEntry{pair.first, &pair.second});
+            }
+            for (const auto &pair : coverageInfo.varMap) {
+                entries.emplace_back(PackedEntry{pair.first, &pair.second});
+            }
+            std::sort(entries.begin(), entries.end(), [](const PackedEntry &a, const PackedEntry &b) { return a.name < b.name; });
+
+            coverageInfo.packedToggleSignals.clear();
+            std::vector<std::string> curItems; // MSB first
+            std::vector<std::string> hitItems; // MSB first
+            uint64_t offset = 0;
+            for (const auto &e : entries) {
+                ASSERT(e.info->type == "PackedArrayType" || e.info->type == "ScalarType", "TODO: Other type", e.info->type, e.info->typeStr);
+                ASSERT(e.info->bitWidth > 0, "Invalid bit width", e.name, e.info->typeStr);
+                auto lo = offset;
+                auto hi = offset + e.info->bitWidth - 1;
+                curItems.insert(curItems.begin(), e.name);
+                hitItems.insert(hitItems.begin(), lo == hi ? fmt::format("_COV_TOGGLE_DIFF[{}]", lo) : fmt::format("|_COV_TOGGLE_DIFF[{}:{}]", hi, lo));
+                offset += e.info->bitWidth;
+                coverageInfo.packedToggleSignals.emplace_back(e.name);
+            }
+            packedToggleCount = entries.size();
+
+            if (packedToggleCount != 0) {
+                auto totalWidth = offset;
+                auto mapWords   = (packedToggleCount + 31) / 32;
+
+                std::vector<std::string> lines;
+                lines.emplace_back(fmt::format("// packed toggle coverage: {} signals, {} bits", packedToggleCount, totalWidth));
+                lines.emplace_back(fmt::format("wire [{}:0] _COV_TOGGLE_CUR = {{{}}};", totalWidth - 1, fmt::join(curItems, ", ")));
+                lines.emplace_back(fmt::format("bit [{}:0] _COV_TOGGLE_LAST;", totalWidth - 1));
+                lines.emplace_back(fmt::format("wire [{}:0] _COV_TOGGLE_DIFF = _COV_TOGGLE_CUR ^ _COV_TOGGLE_LAST;", totalWidth - 1));
+                lines.emplace_back(fmt::format("wire [{}:0] _COV_TOGGLE_HIT = {{{}}};", packedToggleCount - 1, fmt::join(hitItems, ", ")));
+                lines.emplace_back(fmt::format("bit [{}:0] _COV_TOGGLE_MAP;", mapWords * 32 - 1));
+                lines.emplace_back(fmt::format("bit [31:0] _COV_TOGGLE_WORDS [{}];", mapWords));
+                if (counterWidth != 0) {
+                    lines.emplace_back(fmt::format("bit [{}:0] _COV_TOGGLE_CNT [{}];", counterWidth - 1, packedToggleCount));
+                    lines.emplace_back(fmt::format("bit [31:0] _COV_TOGGLE_CNT_WORDS [{}];", packedToggleCount));
+                }
+
+                // clang-format off
+                lines.emplace_back(fmt::format(R"(
+always @(posedge {0}) begin
+if(_COV_EN) begin
+_COV_TOGGLE_MAP[{1}:0] <= _COV_TOGGLE_MAP[{1}:0] | _COV_TOGGLE_HIT;
+_COV_TOGGLE_LAST <= _COV_TOGGLE_CUR;{2}
+end
+end)",
+                    coverageInfo.clockName,
+                    packedToggleCount - 1,
+                    counterWidth == 0 ? "" : fmt::format("\nfor (int i = 0; i < {}; i++) if (_COV_TOGGLE_HIT[i] && _COV_TOGGLE_CNT[i] != '1) _COV_TOGGLE_CNT[i] <= _COV_TOGGLE_CNT[i] + 1'b1;", packedToggleCount)
+                ));
+                // clang-format on
+
+                infoVec.emplace_back(fmt::to_string(fmt::join(lines, "\n")));
+            }
+        }
+
         // Net-toggle counters.
         reset();
         for (const auto &pair : coverageInfo.netMap) {
+            if (packedToggle)
+                break;
             auto &net  = pair.first;
             auto &info = pair.second;
             ASSERT(info.type == "PackedArrayType" || info.type == "ScalarType", "TODO: Other type", info.type, info.typeStr);
@@ -235,6 +355,8 @@ end
         // Var-toggle counters.
         reset();
         for (const auto &pair : coverageInfo.varMap) {
+            if (packedToggle)
+                break;
             auto var  = pair.first;
             auto info = pair.second;
             ASSERT(info.type == "PackedArrayType" || info.type == "ScalarType", "TODO: Other type", info.type, info.typeStr);
@@ -258,6 +380,10 @@ end
         for (const auto &signal : allBinExprCntSignalVec) {
             wrappedBinExprCntVec.emplace_back(fmt::format("({} >= 1 ? 1 : 0)", signal));
         }
+        if (packedToggleCount != 0) {
+            wrappedSignalVec.emplace_back("$countones(_COV_TOGGLE_MAP)");
+        }
+        const size_t totalCoverPointCount = allCoverSignalVec.size() + packedToggleCount;
 
         // Renders the module's hierarchical scope paths as a compact `//`
         // comment placed above the coverage DPI functions. Empty -> no comment.
@@ -292,7 +418,7 @@ export "DPI-C" function getCoverageCount;
         ));
         // clang-format on
 
-        if (allCoverSignalVec.empty()) {
+        if (totalCoverPointCount == 0) {
             // clang-format off
             infoVec.push_back(fmt::format(R"(
 {0}function void getCoverage(output real value);
@@ -315,7 +441,7 @@ export "DPI-C" function getCoverage;
 )",
                 scopeComment(),
                 fmt::to_string(fmt::join(wrappedSignalVec, " + ")),
-                allCoverSignalVec.size()
+                totalCoverPointCount
             ));
             // clang-format on
         }
@@ -334,11 +460,61 @@ export "DPI-C" function getCondCoverage;
         ));
         // clang-format on
 
+        // Bulk readback of the packed toggle state. Both functions are always
+        // emitted in packed mode (even for modules without toggle points) so
+        // every instrumented scope exports the same DPI signature. The words are
+        // copied into the caller buffer by `vl_cov_toggle_copy` (libverilua).
+        if (packedToggle) {
+            auto mapWords = (packedToggleCount + 31) / 32;
+            std::string bitmapBody;
+            std::string counterBody;
+            if (packedToggleCount != 0) {
+                bitmapBody = fmt::format("for (int i = 0; i < {0}; i++) _COV_TOGGLE_WORDS[i] = _COV_TOGGLE_MAP[i*32 +: 32];\nvl_cov_toggle_copy(dst, _COV_TOGGLE_WORDS);", mapWords);
+                if (counterWidth != 0) {
+                    counterBody = fmt::format("for (int i = 0; i < {0}; i++) _COV_TOGGLE_CNT_WORDS[i] = 32'(_COV_TOGGLE_CNT[i]);\nvl_cov_toggle_copy(dst, _COV_TOGGLE_CNT_WORDS);", packedToggleCount);
+                }
+            }
+
+            // clang-format off
+            infoVec.push_back(fmt::format(R"(
+import "DPI-C" function void vl_cov_toggle_copy(input chandle dst, input bit [31:0] words[]);
+
+// Copy the toggled-ever bitmap ({0} bits, {1} words) into `dst`.
+function void getToggleBitmap(input chandle dst, output int nbits);
+    nbits = {0};
+{2}
+endfunction
+
+export "DPI-C" function getToggleBitmap;
+
+// Copy the saturating toggle counters (one 32-bit word per signal) into `dst`.
+function void getToggleCounters(input chandle dst, output int ncounters);
+    ncounters = {3};
+{4}
+endfunction
+
+export "DPI-C" function getToggleCounters;
+)",
+                packedToggleCount,
+                mapWords,
+                bitmapBody,
+                counterWidth == 0 ? 0 : packedToggleCount,
+                counterBody
+            ));
+            // clang-format on
+        }
+
         // resetCoverage clears every counter we know about.
         std::vector<std::string> resetCovVec;
         for (const auto &signal : allCoverSignalVec) {
             resetCovVec.emplace_back(fmt::format("{} = 0;", signal));
         }
+        if (packedToggleCount != 0) {
+            resetCovVec.emplace_back("_COV_TOGGLE_MAP = '0;");
+            if (counterWidth != 0) {
+                resetCovVec.emplace_back("foreach (_COV_TOGGLE_CNT[i]) _COV_TOGGLE_CNT[i] = '0;");
+            }
+        }
         // clang-format off
         infoVec.push_back(fmt::format(R"(
 function void resetCoverage();
@@ -357,7 +533,10 @@ export "DPI-C" function resetCoverage;
             std::string display_str;
         };
         std::vector<CovEntry> covEntries;
+        // Packed toggle mode has no `_<sig>__COV_CNT`, its rows come from `packedToggleSignals` below.
         for (const auto &pair : coverageInfo.netMap) {
+            if (packedToggle)
+                break;
             const auto &net  = pair.first;
             const auto &info = pair.second;
             std::string file = info.file;
@@ -369,6 +548,8 @@ export "DPI-C" function resetCoverage;
             covEntries.emplace_back(CovEntry{(int)info.line, fmt::format("$display(\"[{0}] {1:6d}: %6d\\t`Net`\\t%s\t{3}:{1}\", _{2}__COV_CNT, _{2}__COV_CNT > 0 ? \"\\x1b[32mCOVERED\\x1b[0m\" : \"\\x1b[31mMISSED\\x1b[0m\");", coverageInfo.moduleName, info.line, net, file)});
         }
         for (const auto &pair : coverageInfo.varMap) {
+            if (packedToggle)
+                break;
             const auto &var  = pair.first;
             const auto &info = pair.second;
             std::string file = info.file;
@@ -379,6 +560,20 @@ export "DPI-C" function resetCoverage;
             }
             covEntries.emplace_back(CovEntry{(int)info.line, fmt::format("$display(\"[{0}] {1:6d}: %6d\\t`Var`\\t%s\t{3}:{1}\", _{2}__COV_CNT, _{2}__COV_CNT > 0 ? \"\\x1b[32mCOVERED\\x1b[0m\" : \"\\x1b[31mMISSED\\x1b[0m\");", coverageInfo.moduleName, info.line, var, file)});
         }
+        for (size_t i = 0; i < coverageInfo.packedToggleSignals.size(); i++) {
+            const auto &name = coverageInfo.packedToggleSignals[i];
+            auto netIt       = coverageInfo.netMap.find(name);
+            bool isNet       = netIt != coverageInfo.netMap.end();
+            const auto &info = isNet ? netIt->second : coverageInfo.varMap.at(name);
+            std::string file = info.file;
+            if (relativeFilePath) {
+                auto cwd         = std::filesystem::current_path();
+                auto absFilePath = std::filesystem::absolute(info.file);
+                file             = std::filesystem::relative(absFilePath, cwd).string();
+            }
+            std::string cnt = counterWidth != 0 ? fmt::format("_COV_TOGGLE_CNT[{}]", i) : fmt::format("_COV_TOGGLE_MAP[{}]", i);
+            covEntries.emplace_back(CovEntry{(int)info.line, fmt::format("$display(\"[{0}] {1:6d}: %6d\\t`{2}`\\t%s\t{3}:{1}\", {4}, _COV_TOGGLE_MAP[{5}] ? \"\\x1b[32mCOVERED\\x1b[0m\" : \"\\x1b[31mMISSED\\x1b[0m\");", coverageInfo.moduleName, info.line, isNet ? "Net" : "Var", file, cnt, i)});
+        }
         for (const auto &path : coverageInfo.condPaths) {
             // Each location associated with the same path counter shares the
             // same `cnt` signal, but we still want one $display row per
@@ -468,6 +663,7 @@ export "DPI-C" function showCoverageCount;
         }
 
         infoVec.push_back("`endif // NO_COVERAGE");
-        insertAtBack(syntax.members, parse(fmt::to_string(fmt::join(infoVec, "\n\n"))));
+        rendered.backText = fmt::to_string(fmt::join(infoVec, "\n\n"));
+        return rendered;
     }
 };
@@ -18,9 +18,9 @@ local function gen_multi_set_dispatch(vpi_prefix, hdl_expr)
     end
 
     return string.format([[
-        if t ~= "table" then assert(false, "set() expects number, uint64_t, or table; got " .. t .. ", fullpath => " .. this.fullpath) end
+        if t ~= "table" and t ~= "cdata" then assert(false, "set() expects number, uint64_t, table, or BitVec.u32_vec; got " .. t .. ", fullpath => " .. this.fullpath) end
         local beat_num = this.beat_num
-        if #value ~= beat_num then assert(false, "len: " .. #value .. " =/= " .. this.beat_num) end
+        if t == "table" and #value ~= beat_num then assert(false, "len: " .. #value .. " =/= " .. this.beat_num) end
 
 %s
         else
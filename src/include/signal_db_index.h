@@ -0,0 +1,180 @@
+// signal_db_index.h — binary lookup index written next to a signal DB.
+//
+// signal_db_gen writes `<outfile>.idx` together with the `.ldb` signal DB,
+// nosim memory-maps it to resolve `vpi_handle_by_name` without decoding the
+// DB into Lua tables.
+//
+// Layout (little endian, every offset from the start of the file):
+//   Header                        (32 bytes)
+//   Entry[count]                  (24 bytes each, sorted by name, bytewise)
+//   string table                  (NUL-terminated hierarchical paths)
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace signal_db_index {
+
+constexpr char MAGIC[8]     = {'V', 'L', 'S', 'D', 'B', 'I', 'X', '1'};
+constexpr uint32_t VERSION  = 1;
+constexpr uint32_t TYPE_NET = 36; // vpiNet
+constexpr uint32_t TYPE_REG = 48; // vpiReg
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint64_t strtabOffset;
+    uint64_t strtabSize;
+};
+
+struct Entry {
+    uint64_t nameOffset; // into the string table
+    uint32_t nameLen;
+    uint32_t width;
+    uint32_t type; // TYPE_NET / TYPE_REG (a VPI object type)
+    uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 32);
+static_assert(sizeof(Entry) == 24);
+
+struct Signal {
+    std::string hierPath;
+    uint32_t width;
+    uint32_t type;
+};
+
+/// Write `signals` (any order) to `path`. Returns false if the file cannot be written.
+inline bool write(const std::string &path, std::vector<Signal> signals) {
+    std::sort(signals.begin(), signals.end(), [](const Signal &a, const Signal &b) { return a.hierPath < b.hierPath; });
+    signals.erase(std::unique(signals.begin(), signals.end(), [](const Signal &a, const Signal &b) { return a.hierPath == b.hierPath; }), signals.end());
+
+    std::vector<Entry> entries;
+    entries.reserve(signals.size());
+    std::string strtab;
+    for (auto &sig : signals) {
+        entries.push_back({strtab.size(), static_cast<uint32_t>(sig.hierPath.size()), sig.width, sig.type, 0});
+        strtab += sig.hierPath;
+        strtab += '\0';
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version      = VERSION;
+    header.count        = static_cast<uint32_t>(entries.size());
+    header.strtabOffset = sizeof(Header) + entries.size() * sizeof(Entry);
+    header.strtabSize   = strtab.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(Entry));
+    out.write(strtab.data(), strtab.size());
+    return static_cast<bool>(out);
+}
+
+/// Read-only view of an index file, mapped once and looked up by binary search.
+class Reader {
+  public:
+    Reader() = default;
+    ~Reader() { close(); }
+
+    Reader(const Reader &)            = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    /// Map `path`. Returns false (and stays closed) if it is missing or malformed.
+    bool open(const std::string &path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+            ::close(fd);
+            return false;
+        }
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        base_ = static_cast<const uint8_t *>(addr);
+        size_ = st.st_size;
+
+        auto header = reinterpret_cast<const Header *>(base_);
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION || header->strtabOffset != sizeof(Header) + uint64_t(header->count) * sizeof(Entry) || header->strtabOffset > size_ || header->strtabSize > size_ - header->strtabOffset) {
+            close();
+            return false;
+        }
+        entries_ = reinterpret_cast<const Entry *>(base_ + sizeof(Header));
+        count_   = header->count;
+        strtab_  = reinterpret_cast<const char *>(base_ + header->strtabOffset);
+
+        // Every name must lie inside the string table, NUL-terminated (`cname`)
+        for (auto &entry : *this) {
+            if (entry.nameOffset >= header->strtabSize || entry.nameLen >= header->strtabSize - entry.nameOffset || strtab_[entry.nameOffset + entry.nameLen] != '\0') {
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void close() {
+        if (base_) {
+            munmap(const_cast<uint8_t *>(base_), size_);
+        }
+        base_    = nullptr;
+        size_    = 0;
+        entries_ = nullptr;
+        count_   = 0;
+        strtab_  = nullptr;
+    }
+
+    bool isOpen() const { return base_ != nullptr; }
+    uint32_t count() const { return count_; }
+    const Entry *begin() const { return entries_; }
+    const Entry *end() const { return entries_ + count_; }
+
+    std::string_view name(const Entry &entry) const { return {strtab_ + entry.nameOffset, entry.nameLen}; }
+    const char *cname(const Entry &entry) const { return strtab_ + entry.nameOffset; }
+
+    /// Entry of the signal with hierarchical path `hierPath`, nullptr if there is none.
+    const Entry *find(std::string_view hierPath) const {
+        auto it = std::lower_bound(begin(), end(), hierPath, [this](const Entry &entry, std::string_view key) { return name(entry) < key; });
+        if (it != end() && name(*it) == hierPath) {
+            return it;
+        }
+        return nullptr;
+    }
+
+    /// Whether `handle` points at an entry of this index.
+    bool owns(const void *handle) const {
+        auto entry = static_cast<const Entry *>(handle);
+        return entry >= begin() && entry < end();
+    }
+
+  private:
+    const uint8_t *base_  = nullptr;
+    size_t size_          = 0;
+    const Entry *entries_ = nullptr;
+    uint32_t count_       = 0;
+    const char *strtab_   = nullptr;
+};
+
+} // namespace signal_db_index
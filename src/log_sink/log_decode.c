@@ -0,0 +1,69 @@
+// log_decode: renders a binary log written by the native Logger sink
+// (log_sink.h) as text.
+//
+//   log_decode [-s|--sort] [-o out.txt] <log.vllog>
+//
+// Records are printed in file order. A streaming log of several threads is
+// written ring by ring, `--sort` orders it by timestamp instead. Flight
+// recorder dumps are already sorted.
+
+#include "log_sink.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static void print_usage(void) { fprintf(stderr, "Usage: log_decode [-s|--sort] [-o <out.txt>] <log.vllog>\n"); }
+
+int main(int argc, char **argv) {
+    const char *in_path  = NULL;
+    const char *out_path = NULL;
+    int sort             = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--sort") == 0) {
+            sort = 1;
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--out") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s requires an argument\n", argv[i]);
+                return 2;
+            }
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage();
+            return 0;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Error: unknown argument '%s'\n", argv[i]);
+            print_usage();
+            return 2;
+        } else if (in_path) {
+            fprintf(stderr, "Error: only one input file is supported\n");
+            return 2;
+        } else {
+            in_path = argv[i];
+        }
+    }
+
+    if (!in_path) {
+        print_usage();
+        return 2;
+    }
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            fprintf(stderr, "Error: cannot open '%s' for writing\n", out_path);
+            return 2;
+        }
+    }
+
+    long n = log_sink_decode(in_path, out, sort);
+    if (out != stdout) {
+        fclose(out);
+    }
+    if (n < 0) {
+        fprintf(stderr, "Error: %s\n", log_sink_last_error());
+        return 1;
+    }
+    return 0;
+}
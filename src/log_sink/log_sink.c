@@ -0,0 +1,1328 @@
+// log_sink: per-thread rings, background writer, flight recorder and the
+// binary log decoder. See log_sink.h.
+
+#define _GNU_SOURCE
+
+#include "log_sink.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_MAGIC "VLLOG001"
+#define LOG_MAGIC_LEN 8
+
+#define DEFAULT_RING_BYTES (4u << 20)
+#define MIN_RING_BYTES (64u << 10)
+#define MAX_STR_ARG (16u << 10) // longer string arguments are cut
+#define MAX_ARGS 0xffffu
+#define MAX_RECORD (1u << 30)
+
+enum { REC_MSG = 1, REC_STR = 2 };
+enum { ARG_NIL = 0, ARG_NUM = 1, ARG_INT = 2, ARG_UINT = 3, ARG_STR = 4, ARG_STRID = 5, ARG_BOOL = 6 };
+
+// Record layout, in the rings and in binary files (host byte order): the
+// header, then `nargs` arguments, each a tag byte and its payload (8 bytes
+// for numbers, a uint32_t id, one byte for booleans, a uint32_t length and
+// the bytes for strings). A REC_STR record carries the interned string with
+// id `fmt_id` as payload. Binary files start with LOG_MAGIC.
+typedef struct {
+    uint32_t len; // whole record, header included
+    uint8_t kind;
+    uint8_t level;
+    uint16_t nargs;
+    uint64_t time_ns; // CLOCK_REALTIME
+    uint32_t logger_id;
+    uint32_t fmt_id;
+    uint32_t thread; // 1-based ring index
+    uint32_t reserved;
+} rec_header;
+
+// Single producer byte ring. `head` / `tail` count bytes ever written /
+// consumed, positions are taken modulo `cap`.
+typedef struct ring {
+    uint8_t *buf;
+    uint64_t cap;
+    uint64_t head; // producer only
+    uint64_t tail; // writer thread (streaming) or producer under `lock` (flight recorder)
+    uint64_t snap; // writer thread: head seen at the start of a drain
+    uint32_t thread;
+    pthread_mutex_t lock; // flight recorder: eviction against dump
+    struct ring *next;
+} ring;
+
+typedef struct {
+    char *str;
+    uint32_t len;
+} interned;
+
+typedef struct {
+    char *buf;
+    size_t len, cap;
+} strbuf;
+
+typedef struct {
+    uint8_t tag;
+    double num;
+    int64_t i;
+    uint64_t u;
+    const char *str;
+    uint32_t len;
+} arg_view;
+
+// Output side: strings known to this output, scratch buffers
+typedef struct {
+    interned *strs;
+    uint32_t nstrs, cap_strs;
+    uint8_t *rec;
+    size_t cap_rec;
+    arg_view *args;
+    size_t cap_args;
+    strbuf line, tmp;
+} out_state;
+
+static struct {
+    int open;
+    uint64_t generation;
+    char *path;
+    FILE *file;
+    int format;
+    uint64_t ring_bytes;
+    int flight;
+    uint64_t dropped;
+    uint32_t producers; // threads inside log_sink_end, close waits for them
+    int write_error;    // sticky: the writer failed, every later record is dropped
+
+    pthread_mutex_t control; // open / close / dump
+    pthread_mutex_t lock;    // rings list, strings
+    ring *rings;
+    uint32_t nrings;
+    interned *strs;
+    uint32_t nstrs, cap_strs;
+
+    pthread_t writer;
+    int writer_running;
+    int stop;
+    pthread_mutex_t wake_lock;
+    pthread_cond_t wake;
+    pthread_mutex_t file_lock;
+    out_state out; // writer thread
+
+    int atexit_registered;
+} g = {
+    .control   = PTHREAD_MUTEX_INITIALIZER,
+    .lock      = PTHREAD_MUTEX_INITIALIZER,
+    .wake_lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake      = PTHREAD_COND_INITIALIZER,
+    .file_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// Record being built by this thread
+static __thread struct {
+    uint64_t generation;
+    ring *ring;
+    uint8_t *rec;
+    size_t len, cap;
+    int active;
+} tls;
+
+static __thread char last_error[512];
+
+static void set_error(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(last_error, sizeof(last_error), fmt, ap);
+    va_end(ap);
+}
+
+const char *log_sink_last_error(void) { return last_error; }
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_us(long us) {
+    struct timespec ts = {0, us * 1000};
+    nanosleep(&ts, NULL);
+}
+
+//------------------------------------------------------------------------------
+// String buffers and text rendering (writer thread, dump, decoder)
+//------------------------------------------------------------------------------
+
+static int sb_reserve(strbuf *sb, size_t n) {
+    if (sb->len + n + 1 <= sb->cap) {
+        return 1;
+    }
+    size_t cap = sb->cap ? sb->cap : 256;
+    while (cap < sb->len + n + 1) {
+        cap *= 2;
+    }
+    char *buf = realloc(sb->buf, cap);
+    if (!buf) {
+        return 0;
+    }
+    sb->buf = buf;
+    sb->cap = cap;
+    return 1;
+}
+
+static void sb_putn(strbuf *sb, const char *s, size_t n) {
+    if (!sb_reserve(sb, n)) {
+        return;
+    }
+    memcpy(sb->buf + sb->len, s, n);
+    sb->len += n;
+    sb->buf[sb->len] = '\0';
+}
+
+static void sb_puts(strbuf *sb, const char *s) { sb_putn(sb, s, strlen(s)); }
+
+static void sb_printf(strbuf *sb, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    char small[128];
+    int n = vsnprintf(small, sizeof(small), fmt, ap);
+    va_end(ap);
+    if (n < 0) {
+        return;
+    }
+    if ((size_t)n < sizeof(small)) {
+        sb_putn(sb, small, (size_t)n);
+        return;
+    }
+    if (!sb_reserve(sb, (size_t)n)) {
+        return;
+    }
+    va_start(ap, fmt);
+    vsnprintf(sb->buf + sb->len, (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    sb->len += (size_t)n;
+}
+
+static void sb_free(strbuf *sb) {
+    free(sb->buf);
+    sb->buf = NULL;
+    sb->len = sb->cap = 0;
+}
+
+static void out_state_free(out_state *st) {
+    free(st->strs);
+    free(st->rec);
+    free(st->args);
+    sb_free(&st->line);
+    sb_free(&st->tmp);
+    memset(st, 0, sizeof(*st));
+}
+
+static int out_state_add_string(out_state *st, uint32_t id, const char *str, uint32_t len) {
+    if (id >= st->cap_strs) {
+        uint32_t cap = st->cap_strs ? st->cap_strs : 64;
+        while (cap <= id) {
+            cap *= 2;
+        }
+        interned *strs = realloc(st->strs, cap * sizeof(interned));
+        if (!strs) {
+            return 0;
+        }
+        memset(strs + st->cap_strs, 0, (cap - st->cap_strs) * sizeof(interned));
+        st->strs     = strs;
+        st->cap_strs = cap;
+    }
+    st->strs[id].str = (char *)str;
+    st->strs[id].len = len;
+    if (id >= st->nstrs) {
+        st->nstrs = id + 1;
+    }
+    return 1;
+}
+
+static const char *LEVEL_NAMES[] = {"DEBUG", "INFO", "SUCCESS", "WARNING", "ERROR"};
+
+// Arguments of a REC_MSG record, 0 if the record is malformed
+static int parse_args(out_state *st, const uint8_t *rec, const rec_header *h) {
+    if (h->nargs > st->cap_args) {
+        arg_view *args = realloc(st->args, h->nargs * sizeof(arg_view));
+        if (!args) {
+            return 0;
+        }
+        st->args     = args;
+        st->cap_args = h->nargs;
+    }
+
+    const uint8_t *p   = rec + sizeof(rec_header);
+    const uint8_t *end = rec + h->len;
+    for (uint16_t i = 0; i < h->nargs; i++) {
+        arg_view *a = &st->args[i];
+        memset(a, 0, sizeof(*a));
+        if (p >= end) {
+            return 0;
+        }
+        a->tag = *p++;
+        switch (a->tag) {
+        case ARG_NIL:
+            break;
+        case ARG_NUM:
+        case ARG_INT:
+        case ARG_UINT:
+            if (end - p < 8) {
+                return 0;
+            }
+            if (a->tag == ARG_NUM) {
+                memcpy(&a->num, p, 8);
+            } else if (a->tag == ARG_INT) {
+                memcpy(&a->i, p, 8);
+            } else {
+                memcpy(&a->u, p, 8);
+            }
+            p += 8;
+            break;
+        case ARG_STR:
+            if (end - p < 4) {
+                return 0;
+            }
+            memcpy(&a->len, p, 4);
+            p += 4;
+            if ((size_t)(end - p) < a->len) {
+                return 0;
+            }
+            a->str = (const char *)p;
+            p += a->len;
+            break;
+        case ARG_STRID: {
+            uint32_t id;
+            if (end - p < 4) {
+                return 0;
+            }
+            memcpy(&id, p, 4);
+            p += 4;
+            if (id < st->nstrs && st->strs[id].str) {
+                a->str = st->strs[id].str;
+                a->len = st->strs[id].len;
+            } else {
+                a->str = "<unknown string>";
+                a->len = 16;
+            }
+            a->tag = ARG_STR;
+            break;
+        }
+        case ARG_BOOL:
+            if (end - p < 1) {
+                return 0;
+            }
+            a->i = *p++;
+            break;
+        default:
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// `tostring` of an argument, as LuaJIT renders it
+static void put_tostring(strbuf *sb, const arg_view *a) {
+    if (!a) {
+        sb_puts(sb, "nil");
+        return;
+    }
+    switch (a->tag) {
+    case ARG_NUM:
+        sb_printf(sb, "%.14g", a->num);
+        break;
+    case ARG_INT:
+        sb_printf(sb, "%lldLL", (long long)a->i);
+        break;
+    case ARG_UINT:
+        sb_printf(sb, "%lluULL", (unsigned long long)a->u);
+        break;
+    case ARG_STR:
+        sb_putn(sb, a->str, a->len);
+        break;
+    case ARG_BOOL:
+        sb_puts(sb, a->i ? "true" : "false");
+        break;
+    default:
+        sb_puts(sb, "nil");
+        break;
+    }
+}
+
+// Lua coerces numeric strings in `%d` / `%f`
+static double str_to_num(const arg_view *a) {
+    char tmp[64];
+    size_t n = a->len < sizeof(tmp) - 1 ? a->len : sizeof(tmp) - 1;
+    memcpy(tmp, a->str, n);
+    tmp[n] = '\0';
+    return strtod(tmp, NULL);
+}
+
+static long long arg_as_int(const arg_view *a) {
+    if (!a) {
+        return 0;
+    }
+    switch (a->tag) {
+    case ARG_NUM:
+        return (long long)a->num;
+    case ARG_INT:
+    case ARG_BOOL:
+        return (long long)a->i;
+    case ARG_UINT:
+        return (long long)a->u;
+    case ARG_STR:
+        return (long long)str_to_num(a);
+    default:
+        return 0;
+    }
+}
+
+static double arg_as_num(const arg_view *a) {
+    if (!a) {
+        return 0;
+    }
+    switch (a->tag) {
+    case ARG_NUM:
+        return a->num;
+    case ARG_INT:
+    case ARG_BOOL:
+        return (double)a->i;
+    case ARG_UINT:
+        return (double)a->u;
+    case ARG_STR:
+        return str_to_num(a);
+    default:
+        return 0;
+    }
+}
+
+// `string.format(fmt, args...)` for the conversions Lua supports
+static void put_formatted(strbuf *sb, strbuf *tmp, const char *fmt, size_t flen, const arg_view *args, uint16_t nargs) {
+    uint16_t ai = 0;
+    for (size_t i = 0; i < flen; i++) {
+        if (fmt[i] != '%') {
+            size_t j = i;
+            while (j < flen && fmt[j] != '%') {
+                j++;
+            }
+            sb_putn(sb, fmt + i, j - i);
+            i = j - 1;
+            continue;
+        }
+        if (i + 1 < flen && fmt[i + 1] == '%') {
+            sb_putn(sb, "%", 1);
+            i++;
+            continue;
+        }
+
+        size_t start = i++;
+        while (i < flen && strchr("-+ #0", fmt[i])) {
+            i++;
+        }
+        while (i < flen && isdigit((unsigned char)fmt[i])) {
+            i++;
+        }
+        if (i < flen && fmt[i] == '.') {
+            i++;
+            while (i < flen && isdigit((unsigned char)fmt[i])) {
+                i++;
+            }
+        }
+        if (i >= flen || i - start > 16) {
+            sb_putn(sb, fmt + start, (i < flen ? i + 1 : flen) - start);
+            continue;
+        }
+
+        char spec[32];
+        size_t slen = i - start;
+        memcpy(spec, fmt + start, slen);
+        const arg_view *a = ai < nargs ? &args[ai++] : NULL;
+        char conv         = fmt[i];
+        switch (conv) {
+        case 'd':
+        case 'i':
+            memcpy(spec + slen, "lld", 4);
+            sb_printf(sb, spec, arg_as_int(a));
+            break;
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            spec[slen]     = 'l';
+            spec[slen + 1] = 'l';
+            spec[slen + 2] = conv;
+            spec[slen + 3] = '\0';
+            sb_printf(sb, spec, (unsigned long long)arg_as_int(a));
+            break;
+        case 'c':
+            memcpy(spec + slen, "c", 2);
+            sb_printf(sb, spec, (int)arg_as_int(a));
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            spec[slen]     = conv;
+            spec[slen + 1] = '\0';
+            sb_printf(sb, spec, arg_as_num(a));
+            break;
+        case 's':
+            tmp->len = 0;
+            put_tostring(tmp, a);
+            memcpy(spec + slen, "s", 2);
+            sb_printf(sb, spec, tmp->buf ? tmp->buf : "");
+            break;
+        case 'q':
+            tmp->len = 0;
+            put_tostring(tmp, a);
+            sb_putn(sb, "\"", 1);
+            for (size_t k = 0; k < tmp->len; k++) {
+                char c = tmp->buf[k];
+                if (c == '"' || c == '\\' || c == '\n') {
+                    sb_putn(sb, "\\", 1);
+                }
+                sb_putn(sb, &c, 1);
+            }
+            sb_putn(sb, "\"", 1);
+            break;
+        default:
+            sb_putn(sb, fmt + start, i + 1 - start);
+            break;
+        }
+    }
+}
+
+// One text line for a REC_MSG record:
+// `<date> <time>.<us> T<thread> <LEVEL> [<logger>] <message>`
+static void render_record(out_state *st, const uint8_t *rec, const rec_header *h) {
+    strbuf *sb = &st->line;
+    sb->len    = 0;
+
+    time_t sec = (time_t)(h->time_ns / 1000000000u);
+    struct tm tm;
+    localtime_r(&sec, &tm);
+    char when[32];
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm);
+    const char *level = h->level < sizeof(LEVEL_NAMES) / sizeof(LEVEL_NAMES[0]) ? LEVEL_NAMES[h->level] : "?";
+    sb_printf(sb, "%s.%06u T%u %-7s ", when, (unsigned)(h->time_ns % 1000000000u / 1000u), h->thread, level);
+
+    if (h->logger_id < st->nstrs && st->strs[h->logger_id].str) {
+        sb_putn(sb, "[", 1);
+        sb_putn(sb, st->strs[h->logger_id].str, st->strs[h->logger_id].len);
+        sb_putn(sb, "] ", 2);
+    }
+
+    if (!parse_args(st, rec, h)) {
+        sb_puts(sb, "<malformed record>\n");
+        return;
+    }
+
+    if (h->fmt_id != LOG_SINK_NO_FMT && h->fmt_id < st->nstrs && st->strs[h->fmt_id].str) {
+        put_formatted(sb, &st->tmp, st->strs[h->fmt_id].str, st->strs[h->fmt_id].len, st->args, h->nargs);
+    } else {
+        for (uint16_t i = 0; i < h->nargs; i++) {
+            if (i > 0) {
+                sb_putn(sb, " ", 1);
+            }
+            put_tostring(sb, &st->args[i]);
+        }
+    }
+    sb_putn(sb, "\n", 1);
+}
+
+// Write one record (already validated) to `out`
+static int emit_record(FILE *out, int format, out_state *st, const uint8_t *rec) {
+    rec_header h;
+    memcpy(&h, rec, sizeof(h));
+    if (format == LOG_SINK_BINARY) {
+        return fwrite(rec, 1, h.len, out) == h.len;
+    }
+    render_record(st, rec, &h);
+    return fwrite(st->line.buf, 1, st->line.len, out) == st->line.len;
+}
+
+static int emit_string(FILE *out, int format, uint32_t id, const interned *s) {
+    if (format != LOG_SINK_BINARY) {
+        return 1;
+    }
+    rec_header h = {0};
+    h.len        = (uint32_t)(sizeof(h) + s->len);
+    h.kind       = REC_STR;
+    h.fmt_id     = id;
+    return fwrite(&h, sizeof(h), 1, out) == 1 && fwrite(s->str, 1, s->len, out) == s->len;
+}
+
+// Make the strings interned so far known to `st`, writing the new ones to `out`.
+// Returns 0 if a string could not be written.
+static int sync_strings(out_state *st, FILE *out, int format) {
+    pthread_mutex_lock(&g.lock);
+    uint32_t from = st->nstrs, to = g.nstrs;
+    for (uint32_t id = from; id < to; id++) {
+        out_state_add_string(st, id, g.strs[id].str, g.strs[id].len);
+    }
+    pthread_mutex_unlock(&g.lock);
+
+    // The copies are never freed, so they can be used without the lock
+    int ok = 1;
+    for (uint32_t id = from; id < to && ok; id++) {
+        ok = emit_string(out, format, id, &st->strs[id]);
+    }
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+// Rings
+//------------------------------------------------------------------------------
+
+static void ring_write(ring *r, uint64_t pos, const void *src, size_t n) {
+    size_t off   = (size_t)(pos % r->cap);
+    size_t first = n < r->cap - off ? n : (size_t)(r->cap - off);
+    memcpy(r->buf + off, src, first);
+    memcpy(r->buf, (const uint8_t *)src + first, n - first);
+}
+
+static void ring_read(const ring *r, uint64_t pos, void *dst, size_t n) {
+    size_t off   = (size_t)(pos % r->cap);
+    size_t first = n < r->cap - off ? n : (size_t)(r->cap - off);
+    memcpy(dst, r->buf + off, first);
+    memcpy((uint8_t *)dst + first, r->buf, n - first);
+}
+
+static ring *producer_ring(void) {
+    uint64_t generation = __atomic_load_n(&g.generation, __ATOMIC_ACQUIRE);
+    if (tls.ring && tls.generation == generation) {
+        return tls.ring;
+    }
+
+    ring *r = calloc(1, sizeof(ring));
+    if (!r) {
+        return NULL;
+    }
+    r->cap = g.ring_bytes;
+    r->buf = malloc(r->cap);
+    if (!r->buf) {
+        free(r);
+        return NULL;
+    }
+    pthread_mutex_init(&r->lock, NULL);
+
+    pthread_mutex_lock(&g.lock);
+    r->thread = ++g.nrings;
+    r->next   = g.rings;
+    g.rings   = r;
+    pthread_mutex_unlock(&g.lock);
+
+    tls.ring       = r;
+    tls.generation = generation;
+    return r;
+}
+
+static void wake_writer(void) {
+    pthread_mutex_lock(&g.wake_lock);
+    pthread_cond_signal(&g.wake);
+    pthread_mutex_unlock(&g.wake_lock);
+}
+
+//------------------------------------------------------------------------------
+// Producer API
+//------------------------------------------------------------------------------
+
+// Frees the record buffer of an exiting thread
+static pthread_key_t tls_key;
+static pthread_once_t tls_key_once = PTHREAD_ONCE_INIT;
+
+static void free_tls(void *arg) {
+    (void)arg;
+    free(tls.rec);
+    tls.rec = NULL;
+    tls.cap = tls.len = 0;
+}
+
+static void make_tls_key(void) { pthread_key_create(&tls_key, free_tls); }
+
+static int rec_reserve(size_t n) {
+    if (tls.len + n <= tls.cap) {
+        return 1;
+    }
+    if (!tls.rec) {
+        pthread_once(&tls_key_once, make_tls_key);
+        pthread_setspecific(tls_key, &tls);
+    }
+    size_t cap = tls.cap ? tls.cap : 256;
+    while (cap < tls.len + n) {
+        cap *= 2;
+    }
+    uint8_t *rec = realloc(tls.rec, cap);
+    if (!rec) {
+        return 0;
+    }
+    tls.rec = rec;
+    tls.cap = cap;
+    return 1;
+}
+
+void log_sink_begin(int level, uint32_t logger_id, uint32_t fmt_id) {
+    tls.active = __atomic_load_n(&g.open, __ATOMIC_ACQUIRE);
+    if (!tls.active) {
+        return;
+    }
+    tls.len = 0;
+    if (!rec_reserve(sizeof(rec_header))) {
+        tls.active = 0;
+        return;
+    }
+    rec_header h = {0};
+    h.kind       = REC_MSG;
+    h.level      = (uint8_t)level;
+    h.time_ns    = now_ns();
+    h.logger_id  = logger_id;
+    h.fmt_id     = fmt_id;
+    memcpy(tls.rec, &h, sizeof(h));
+    tls.len = sizeof(h);
+}
+
+static void push_arg(uint8_t tag, const void *a, size_t na, const void *b, size_t nb) {
+    if (!tls.active) {
+        return;
+    }
+    rec_header *h = (rec_header *)tls.rec;
+    if (h->nargs == MAX_ARGS || tls.len + 1 + na + nb > MAX_RECORD || !rec_reserve(1 + na + nb)) {
+        __atomic_add_fetch(&g.dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    h = (rec_header *)tls.rec;
+    tls.rec[tls.len++] = tag;
+    if (na) {
+        memcpy(tls.rec + tls.len, a, na);
+        tls.len += na;
+    }
+    if (nb) {
+        memcpy(tls.rec + tls.len, b, nb);
+        tls.len += nb;
+    }
+    h->nargs++;
+}
+
+void log_sink_arg_num(double v) { push_arg(ARG_NUM, &v, 8, NULL, 0); }
+
+void log_sink_arg_int(int64_t v) { push_arg(ARG_INT, &v, 8, NULL, 0); }
+
+void log_sink_arg_uint(uint64_t v) { push_arg(ARG_UINT, &v, 8, NULL, 0); }
+
+void log_sink_arg_str(const char *str, size_t len) {
+    if (len > MAX_STR_ARG) {
+        len = MAX_STR_ARG;
+        __atomic_add_fetch(&g.dropped, 1, __ATOMIC_RELAXED);
+    }
+    uint32_t n = (uint32_t)len;
+    push_arg(ARG_STR, &n, 4, str, len);
+}
+
+void log_sink_arg_strid(uint32_t id) { push_arg(ARG_STRID, &id, 4, NULL, 0); }
+
+void log_sink_arg_bool(int v) {
+    uint8_t b = v ? 1 : 0;
+    push_arg(ARG_BOOL, &b, 1, NULL, 0);
+}
+
+void log_sink_arg_nil(void) { push_arg(ARG_NIL, NULL, 0, NULL, 0); }
+
+// Called once the record is in the ring (or dropped)
+static void producer_leave(void) { __atomic_sub_fetch(&g.producers, 1, __ATOMIC_RELEASE); }
+
+void log_sink_end(void) {
+    if (!tls.active) {
+        return;
+    }
+    tls.active = 0;
+
+    // Announce this thread before touching the rings, then check again that
+    // the sink is open: log_sink_close clears `open` before waiting for
+    // `producers` to drop to zero, so either it sees this thread or this
+    // thread sees the sink closed (both accesses are sequentially consistent).
+    __atomic_add_fetch(&g.producers, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&g.open, __ATOMIC_SEQ_CST) || __atomic_load_n(&g.write_error, __ATOMIC_ACQUIRE)) {
+        producer_leave();
+        __atomic_add_fetch(&g.dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    ring *r = producer_ring();
+    if (!r || tls.len > r->cap) {
+        producer_leave();
+        __atomic_add_fetch(&g.dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    rec_header *h = (rec_header *)tls.rec;
+    h->len        = (uint32_t)tls.len;
+    h->thread     = r->thread;
+
+    if (g.flight) {
+        // Evict the oldest records until this one fits
+        pthread_mutex_lock(&r->lock);
+        uint64_t tail = r->tail;
+        while (r->cap - (r->head - tail) < tls.len) {
+            uint32_t len;
+            ring_read(r, tail, &len, sizeof(len));
+            tail += len;
+        }
+        ring_write(r, r->head, tls.rec, tls.len);
+        r->tail = tail;
+        r->head += tls.len;
+        pthread_mutex_unlock(&r->lock);
+        producer_leave();
+        return;
+    }
+
+    uint64_t head = r->head;
+    uint64_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    while (r->cap - (head - tail) < tls.len) {
+        // Full: wait for the writer instead of losing records, unless the
+        // sink is being closed by another thread or the writer failed
+        if (!__atomic_load_n(&g.open, __ATOMIC_ACQUIRE) || __atomic_load_n(&g.write_error, __ATOMIC_ACQUIRE)) {
+            producer_leave();
+            __atomic_add_fetch(&g.dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        wake_writer();
+        sleep_us(50);
+        tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    }
+    ring_write(r, head, tls.rec, tls.len);
+    __atomic_store_n(&r->head, head + tls.len, __ATOMIC_RELEASE);
+
+    if (head + tls.len - tail > r->cap / 2) {
+        wake_writer();
+    }
+    producer_leave();
+}
+
+uint32_t log_sink_intern(const char *str, size_t len) {
+    char *copy = malloc(len + 1);
+    if (!copy) {
+        return LOG_SINK_NO_FMT;
+    }
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    pthread_mutex_lock(&g.lock);
+    if (g.nstrs == g.cap_strs) {
+        uint32_t cap   = g.cap_strs ? g.cap_strs * 2 : 256;
+        interned *strs = realloc(g.strs, cap * sizeof(interned));
+        if (!strs) {
+            pthread_mutex_unlock(&g.lock);
+            free(copy);
+            return LOG_SINK_NO_FMT;
+        }
+        g.strs     = strs;
+        g.cap_strs = cap;
+    }
+    uint32_t id = g.nstrs++;
+    g.strs[id]  = (interned){copy, (uint32_t)len};
+    pthread_mutex_unlock(&g.lock);
+    return id;
+}
+
+uint64_t log_sink_dropped(void) { return __atomic_load_n(&g.dropped, __ATOMIC_RELAXED); }
+
+int log_sink_is_open(void) { return __atomic_load_n(&g.open, __ATOMIC_ACQUIRE); }
+
+//------------------------------------------------------------------------------
+// Writer thread
+//------------------------------------------------------------------------------
+
+// Write every record ended before the call, returns how many
+static size_t drain(void) {
+    pthread_mutex_lock(&g.lock);
+    ring *rings = g.rings;
+    pthread_mutex_unlock(&g.lock);
+
+    for (ring *r = rings; r; r = r->next) {
+        r->snap = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    }
+
+    pthread_mutex_lock(&g.file_lock);
+    // After the heads: every string a snapshotted record uses is interned by now
+    int ok = !__atomic_load_n(&g.write_error, __ATOMIC_ACQUIRE) && sync_strings(&g.out, g.file, g.format);
+
+    // Records are always consumed, so that producers waiting on a full ring
+    // move on. After a write error they are only counted as dropped.
+    size_t n = 0;
+    for (ring *r = rings; r; r = r->next) {
+        uint64_t tail = r->tail;
+        while (tail < r->snap) {
+            uint32_t len;
+            ring_read(r, tail, &len, sizeof(len));
+            if (ok && len > g.out.cap_rec) {
+                uint8_t *rec = realloc(g.out.rec, len);
+                if (rec) {
+                    g.out.rec     = rec;
+                    g.out.cap_rec = len;
+                } else {
+                    ok = 0;
+                }
+            }
+            if (ok) {
+                ring_read(r, tail, g.out.rec, len);
+                ok = emit_record(g.file, g.format, &g.out, g.out.rec);
+            }
+            if (!ok) {
+                __atomic_add_fetch(&g.dropped, 1, __ATOMIC_RELAXED);
+            }
+            tail += len;
+            __atomic_store_n(&r->tail, tail, __ATOMIC_RELEASE);
+            n++;
+        }
+    }
+    if (ok && n == 0 && fflush(g.file) != 0) {
+        ok = 0;
+    }
+    if (!ok || ferror(g.file)) {
+        __atomic_store_n(&g.write_error, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&g.file_lock);
+    return n;
+}
+
+static void *writer_main(void *arg) {
+    (void)arg;
+    for (;;) {
+        int stop = __atomic_load_n(&g.stop, __ATOMIC_ACQUIRE);
+        size_t n = drain();
+        if (stop) {
+            break;
+        }
+        if (n == 0) {
+            pthread_mutex_lock(&g.wake_lock);
+            if (!__atomic_load_n(&g.stop, __ATOMIC_ACQUIRE)) {
+                struct timespec ts;
+                clock_gettime(CLOCK_REALTIME, &ts);
+                ts.tv_nsec += 1000000;
+                if (ts.tv_nsec >= 1000000000) {
+                    ts.tv_sec++;
+                    ts.tv_nsec -= 1000000000;
+                }
+                pthread_cond_timedwait(&g.wake, &g.wake_lock, &ts);
+            }
+            pthread_mutex_unlock(&g.wake_lock);
+        }
+    }
+    return NULL;
+}
+
+int log_sink_flush(void) {
+    // Held so that a concurrent close cannot free the rings and the file
+    pthread_mutex_lock(&g.control);
+    if (!log_sink_is_open()) {
+        pthread_mutex_unlock(&g.control);
+        set_error("log sink is not open");
+        return -1;
+    }
+    if (g.flight) {
+        pthread_mutex_unlock(&g.control);
+        return 0;
+    }
+    for (;;) {
+        int pending = 0;
+        pthread_mutex_lock(&g.lock);
+        for (ring *r = g.rings; r; r = r->next) {
+            if (__atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) < __atomic_load_n(&r->head, __ATOMIC_ACQUIRE)) {
+                pending = 1;
+                break;
+            }
+        }
+        pthread_mutex_unlock(&g.lock);
+        if (!pending) {
+            break;
+        }
+        wake_writer();
+        sleep_us(100);
+    }
+    pthread_mutex_lock(&g.file_lock);
+    int ret = 0;
+    if (__atomic_load_n(&g.write_error, __ATOMIC_ACQUIRE) || fflush(g.file) != 0) {
+        __atomic_store_n(&g.write_error, 1, __ATOMIC_RELEASE);
+        set_error("failed to write `%s`", g.path);
+        ret = -1;
+    }
+    pthread_mutex_unlock(&g.file_lock);
+    pthread_mutex_unlock(&g.control);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// Flight recorder dump
+//------------------------------------------------------------------------------
+
+typedef struct {
+    uint64_t time_ns;
+    uint32_t thread;
+    size_t offset; // into the copied records
+} rec_key;
+
+static int compare_keys(const void *a, const void *b) {
+    const rec_key *x = a, *y = b;
+    if (x->time_ns != y->time_ns) {
+        return x->time_ns < y->time_ns ? -1 : 1;
+    }
+    if (x->thread != y->thread) {
+        return x->thread < y->thread ? -1 : 1;
+    }
+    return x->offset < y->offset ? -1 : (x->offset > y->offset);
+}
+
+// Copy of the retained records of every ring, and their keys in time order
+static int snapshot_flight(uint8_t **out_buf, rec_key **out_keys, size_t *out_n) {
+    pthread_mutex_lock(&g.lock);
+    ring *rings = g.rings;
+    pthread_mutex_unlock(&g.lock);
+
+    uint8_t *buf  = NULL;
+    size_t size   = 0;
+    rec_key *keys = NULL;
+    size_t n = 0, cap_keys = 0;
+    for (ring *r = rings; r; r = r->next) {
+        pthread_mutex_lock(&r->lock);
+        uint64_t tail = r->tail, used = r->head - r->tail;
+        uint8_t *grown = realloc(buf, size + used + 1);
+        if (!grown) {
+            pthread_mutex_unlock(&r->lock);
+            free(buf);
+            free(keys);
+            return 0;
+        }
+        buf = grown;
+        ring_read(r, tail, buf + size, used);
+        pthread_mutex_unlock(&r->lock);
+
+        for (size_t off = size; off < size + used;) {
+            rec_header h;
+            memcpy(&h, buf + off, sizeof(h));
+            if (n == cap_keys) {
+                cap_keys        = cap_keys ? cap_keys * 2 : 1024;
+                rec_key *grownk = realloc(keys, cap_keys * sizeof(rec_key));
+                if (!grownk) {
+                    free(buf);
+                    free(keys);
+                    return 0;
+                }
+                keys = grownk;
+            }
+            keys[n++] = (rec_key){h.time_ns, h.thread, off};
+            off += h.len;
+        }
+        size += used;
+    }
+    qsort(keys, n, sizeof(rec_key), compare_keys);
+    *out_buf  = buf;
+    *out_keys = keys;
+    *out_n    = n;
+    return 1;
+}
+
+static int dump_locked(void) {
+    uint8_t *buf  = NULL;
+    rec_key *keys = NULL;
+    size_t n      = 0;
+    if (!snapshot_flight(&buf, &keys, &n)) {
+        set_error("out of memory while dumping the flight recorder");
+        return -1;
+    }
+
+    FILE *out = fopen(g.path, "wb");
+    if (!out) {
+        set_error("cannot open `%s` for writing", g.path);
+        free(buf);
+        free(keys);
+        return -1;
+    }
+
+    out_state st = {0};
+    if (g.format == LOG_SINK_BINARY) {
+        fwrite(LOG_MAGIC, 1, LOG_MAGIC_LEN, out);
+    }
+    sync_strings(&st, out, g.format);
+    for (size_t i = 0; i < n; i++) {
+        emit_record(out, g.format, &st, buf + keys[i].offset);
+    }
+    out_state_free(&st);
+    free(buf);
+    free(keys);
+
+    int failed = ferror(out);
+    if (fclose(out) != 0 || failed) {
+        set_error("failed to write `%s`", g.path);
+        return -1;
+    }
+    return (int)n;
+}
+
+int log_sink_dump(void) {
+    pthread_mutex_lock(&g.control);
+    int ret;
+    if (!log_sink_is_open()) {
+        set_error("log sink is not open");
+        ret = -1;
+    } else if (!g.flight) {
+        set_error("log sink is not a flight recorder");
+        ret = -1;
+    } else {
+        ret = dump_locked();
+    }
+    pthread_mutex_unlock(&g.control);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// Open / close
+//------------------------------------------------------------------------------
+
+static void close_at_exit(void) { log_sink_close(); }
+
+int log_sink_open(const char *path, int format, size_t ring_bytes, size_t flight_bytes) {
+    if (!path || (format != LOG_SINK_BINARY && format != LOG_SINK_TEXT)) {
+        set_error("invalid arguments");
+        return -1;
+    }
+
+    pthread_mutex_lock(&g.control);
+    if (log_sink_is_open()) {
+        pthread_mutex_unlock(&g.control);
+        set_error("log sink is already open (writing `%s`)", g.path);
+        return -1;
+    }
+
+    // The flight recorder only writes on dump, still fail early on a bad path
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        pthread_mutex_unlock(&g.control);
+        set_error("cannot open `%s` for writing", path);
+        return -1;
+    }
+    if (flight_bytes > 0) {
+        fclose(file);
+        file = NULL;
+    } else {
+        setvbuf(file, NULL, _IOFBF, 1 << 20);
+        if (format == LOG_SINK_BINARY) {
+            fwrite(LOG_MAGIC, 1, LOG_MAGIC_LEN, file);
+        }
+    }
+
+    size_t bytes = flight_bytes > 0 ? flight_bytes : (ring_bytes ? ring_bytes : DEFAULT_RING_BYTES);
+    g.ring_bytes = bytes < MIN_RING_BYTES ? MIN_RING_BYTES : bytes;
+    g.path       = strdup(path);
+    g.file       = file;
+    g.format     = format;
+    g.flight     = flight_bytes > 0;
+    g.stop       = 0;
+    __atomic_store_n(&g.dropped, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g.write_error, 0, __ATOMIC_RELAXED);
+    out_state_free(&g.out);
+
+    // Threads still holding a ring of a previous sink allocate a new one
+    __atomic_add_fetch(&g.generation, 1, __ATOMIC_RELEASE);
+
+    if (!g.flight) {
+        if (pthread_create(&g.writer, NULL, writer_main, NULL) != 0) {
+            fclose(g.file);
+            g.file = NULL;
+            free(g.path);
+            g.path = NULL;
+            pthread_mutex_unlock(&g.control);
+            set_error("cannot start the writer thread");
+            return -1;
+        }
+        g.writer_running = 1;
+    }
+
+    if (!g.atexit_registered) {
+        g.atexit_registered = 1;
+        atexit(close_at_exit);
+    }
+
+    __atomic_store_n(&g.open, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g.control);
+    return 0;
+}
+
+int log_sink_close(void) {
+    pthread_mutex_lock(&g.control);
+    if (!log_sink_is_open()) {
+        pthread_mutex_unlock(&g.control);
+        return 0;
+    }
+
+    // New records are refused from here on. Records already past the check in
+    // log_sink_end are still written (the writer keeps draining), then the
+    // rings can be freed once no producer holds one.
+    __atomic_store_n(&g.open, 0, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&g.producers, __ATOMIC_SEQ_CST) != 0) {
+        sleep_us(50);
+    }
+
+    int ret = 0;
+    if (g.flight && dump_locked() < 0) {
+        ret = -1;
+    }
+
+    if (g.writer_running) {
+        __atomic_store_n(&g.stop, 1, __ATOMIC_RELEASE);
+        wake_writer();
+        pthread_join(g.writer, NULL);
+        g.writer_running = 0;
+    }
+    if (g.file) {
+        if (fflush(g.file) != 0 || ferror(g.file) || g.write_error) {
+            set_error("failed to write `%s`", g.path);
+            ret = -1;
+        }
+        fclose(g.file);
+        g.file = NULL;
+    }
+
+    pthread_mutex_lock(&g.lock);
+    ring *r = g.rings;
+    g.rings  = NULL;
+    g.nrings = 0;
+    pthread_mutex_unlock(&g.lock);
+    while (r) {
+        ring *next = r->next;
+        pthread_mutex_destroy(&r->lock);
+        free(r->buf);
+        free(r);
+        r = next;
+    }
+    out_state_free(&g.out);
+    free(g.path);
+    g.path = NULL;
+
+    pthread_mutex_unlock(&g.control);
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// Decoder
+//------------------------------------------------------------------------------
+
+long log_sink_decode(const char *in_path, FILE *out, int sort) {
+    FILE *in = fopen(in_path, "rb");
+    if (!in) {
+        set_error("cannot open `%s`", in_path);
+        return -1;
+    }
+    char magic[LOG_MAGIC_LEN];
+    if (fread(magic, 1, LOG_MAGIC_LEN, in) != LOG_MAGIC_LEN || memcmp(magic, LOG_MAGIC, LOG_MAGIC_LEN) != 0) {
+        fclose(in);
+        set_error("`%s` is not a binary verilua log", in_path);
+        return -1;
+    }
+
+    out_state st = {0};
+    uint8_t *all = NULL; // sort: every message record
+    size_t size = 0, cap = 0;
+    rec_key *keys = NULL;
+    size_t n = 0, cap_keys = 0;
+    long ret = 0;
+
+    for (;;) {
+        rec_header h;
+        if (fread(&h, sizeof(h), 1, in) != 1) {
+            break; // end of file, or a record cut by a crash
+        }
+        if (h.len < sizeof(h) || h.len > MAX_RECORD) {
+            set_error("malformed record at offset %ld", ftell(in) - (long)sizeof(h));
+            ret = -1;
+            break;
+        }
+
+        uint8_t *rec;
+        if (sort && h.kind == REC_MSG) {
+            if (size + h.len > cap) {
+                size_t grown_cap = cap ? cap : 1 << 20;
+                while (grown_cap < size + h.len) {
+                    grown_cap *= 2;
+                }
+                uint8_t *grown = realloc(all, grown_cap);
+                if (!grown) {
+                    set_error("out of memory");
+                    ret = -1;
+                    break;
+                }
+                all = grown;
+                cap = grown_cap;
+            }
+            rec = all + size;
+        } else {
+            if (h.len > st.cap_rec) {
+                uint8_t *grown = realloc(st.rec, h.len);
+                if (!grown) {
+                    set_error("out of memory");
+                    ret = -1;
+                    break;
+                }
+                st.rec     = grown;
+                st.cap_rec = h.len;
+            }
+            rec = st.rec;
+        }
+        memcpy(rec, &h, sizeof(h));
+        if (fread(rec + sizeof(h), 1, h.len - sizeof(h), in) != h.len - sizeof(h)) {
+            break;
+        }
+
+        if (h.kind == REC_STR) {
+            uint32_t len = h.len - (uint32_t)sizeof(h);
+            char *copy   = malloc(len + 1);
+            if (!copy) {
+                set_error("out of memory");
+                ret = -1;
+                break;
+            }
+            memcpy(copy, rec + sizeof(h), len);
+            copy[len] = '\0';
+            out_state_add_string(&st, h.fmt_id, copy, len);
+        } else if (h.kind == REC_MSG) {
+            if (sort) {
+                if (n == cap_keys) {
+                    cap_keys       = cap_keys ? cap_keys * 2 : 1024;
+                    rec_key *grown = realloc(keys, cap_keys * sizeof(rec_key));
+                    if (!grown) {
+                        set_error("out of memory");
+                        ret = -1;
+                        break;
+                    }
+                    keys = grown;
+                }
+                keys[n++] = (rec_key){h.time_ns, h.thread, size};
+                size += h.len;
+            } else {
+                emit_record(out, LOG_SINK_TEXT, &st, rec);
+                n++;
+            }
+        }
+    }
+    fclose(in);
+
+    if (ret == 0 && sort) {
+        qsort(keys, n, sizeof(rec_key), compare_keys);
+        for (size_t i = 0; i < n; i++) {
+            emit_record(out, LOG_SINK_TEXT, &st, all + keys[i].offset);
+        }
+    }
+
+    for (uint32_t i = 0; i < st.nstrs; i++) {
+        free(st.strs[i].str);
+    }
+    out_state_free(&st);
+    free(all);
+    free(keys);
+    return ret == 0 ? (long)n : -1;
+}
@@ -0,0 +1,89 @@
+// log_sink: native binary sink behind `verilua.utils.Logger`.
+//
+// A log call records the logger name id, an optional format string id and
+// the raw arguments (numbers, 64-bit integers, strings, booleans) into a
+// lock-free single-producer ring owned by the calling thread. Formatting and
+// file writes happen later:
+//
+// - streaming mode: a background thread drains every ring into the output
+//   file, either as binary records (decoded by `log_decode`) or as text.
+// - flight recorder mode: nothing is written while logging, every ring keeps
+//   only its most recent records and `log_sink_dump` writes them out (on
+//   error, and at close).
+//
+// Strings are interned once (`log_sink_intern`) and referenced by id, the
+// table is written to the output before the first record that uses it.
+//
+// The declarations below are mirrored by the `ffi.cdef` in
+// `src/lua/verilua/utils/LogSinkNative.lua`, keep them in sync.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Levels, rendered as DEBUG / INFO / SUCCESS / WARNING / ERROR
+enum { LOG_SINK_DEBUG = 0, LOG_SINK_INFO = 1, LOG_SINK_SUCCESS = 2, LOG_SINK_WARNING = 3, LOG_SINK_ERROR = 4 };
+
+// Output formats
+enum { LOG_SINK_BINARY = 0, LOG_SINK_TEXT = 1 };
+
+// `fmt_id` of a record without format string: the arguments are joined with
+// spaces, like `Logger:info(a, b, c)`
+#define LOG_SINK_NO_FMT 0xffffffffu
+
+// Message of the last failed call on this thread
+const char *log_sink_last_error(void);
+
+// Open the process wide sink writing to `path` (truncated). `ring_bytes` is the
+// ring size of every logging thread (0: 4 MiB). With `flight_bytes` > 0 the
+// sink is a flight recorder keeping the last `flight_bytes` of records per
+// thread instead of streaming. Returns 0, or -1 if the sink is already open
+// or `path` cannot be written.
+int log_sink_open(const char *path, int format, size_t ring_bytes, size_t flight_bytes);
+int log_sink_is_open(void);
+
+// Id of a copy of `str` (logger names, format strings, repeated messages)
+uint32_t log_sink_intern(const char *str, size_t len);
+
+// One record: begin, any number of arguments, end. Arguments of the same
+// record must be pushed from the thread that called begin.
+void log_sink_begin(int level, uint32_t logger_id, uint32_t fmt_id);
+void log_sink_arg_num(double v);
+void log_sink_arg_int(int64_t v);
+void log_sink_arg_uint(uint64_t v);
+void log_sink_arg_str(const char *str, size_t len);
+void log_sink_arg_strid(uint32_t id);
+void log_sink_arg_bool(int v);
+void log_sink_arg_nil(void);
+void log_sink_end(void);
+
+// Streaming: wait until every record ended so far is written and flushed.
+// Returns -1 once a write failed: from then on records are dropped.
+int log_sink_flush(void);
+// Flight recorder: write the records kept in memory to the output path
+// (replacing a previous dump). Returns the number of records written, -1 on error.
+int log_sink_dump(void);
+// Flush (streaming) or dump (flight recorder), stop the writer and release
+// every ring. Waits for the records being pushed by other threads, later
+// records are dropped. Also runs at exit.
+int log_sink_close(void);
+
+// Records given up on: arguments past the record size limit are cut, a
+// record longer than the ring, logged while closing or after a write error
+// is dropped.
+uint64_t log_sink_dropped(void);
+
+// Render the binary log `in_path` as text into `out`, optionally sorted by
+// timestamp (records of several threads are written ring by ring). Returns
+// the number of records, -1 on error.
+long log_sink_decode(const char *in_path, FILE *out, int sort);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+---@diagnostic disable
+
+local prj_dir = os.projectdir()
+local curr_dir = os.scriptdir()
+local build_dir = path.join(prj_dir, "build")
+
+target("liblog_sink", function()
+    set_kind("shared")
+    set_basename("log_sink")
+
+    set_languages("c99")
+    set_targetdir(path.join(build_dir, "shared"))
+    set_objectdir(path.join(build_dir, "obj"))
+
+    if is_mode("debug") then
+        set_symbols("debug")
+        set_optimize("none")
+    else
+        set_optimize("fastest")
+    end
+
+    add_files(path.join(curr_dir, "log_sink.c"))
+    add_includedirs(curr_dir)
+    add_syslinks("pthread")
+
+    after_build(function(target)
+        local shared_dir = path.join(prj_dir, "shared")
+        if not os.isdir(shared_dir) then
+            os.mkdir(shared_dir)
+        end
+        os.cp(target:targetfile(), shared_dir)
+    end)
+end)
+
+target("log_decode", function()
+    set_kind("binary")
+
+    set_languages("c99")
+    set_targetdir(path.join(build_dir, "bin"))
+    set_objectdir(path.join(build_dir, "obj"))
+
+    if is_mode("debug") then
+        set_symbols("debug")
+        set_optimize("none")
+    else
+        set_optimize("fastest")
+    end
+
+    add_files(path.join(curr_dir, "log_decode.c"), path.join(curr_dir, "log_sink.c"))
+    add_includedirs(curr_dir)
+    add_syslinks("pthread")
+
+    after_build(function(target)
+        local tools_dir = path.join(prj_dir, "tools")
+        if not os.isdir(tools_dir) then
+            os.mkdir(tools_dir)
+        end
+        os.cp(target:targetfile(), tools_dir)
+    end)
+end)
@@ -64,6 +64,14 @@ function await_negedge_hdl(signal_hdl) end
 ---@param signal_hdl verilua.handles.ComplexHandleRaw
 function await_edge_hdl(signal_hdl) end
 
+--- Wait until a native predicate holds at an edge of `clock_hdl` (use `verilua.utils.NativeCond` instead of calling this directly)
+---@param cond_handle ffi.cdata*
+---@param clock_hdl verilua.handles.ComplexHandleRaw
+---@param edge_type integer 0: posedge, 1: negedge, 2: any edge
+---@param max_cycles integer 0 means no limit
+---@return integer result Number of edges waited, negated if `max_cycles` was reached
+function await_native_cond(cond_handle, clock_hdl, edge_type, max_cycles) end
+
 ---@param event_id_integer integer
 function await_event(event_id_integer) end
 
@@ -31,6 +31,7 @@ end
 ---@field append_finish_callback fun(func: fun()|fun(got_error: boolean))
 ---@field register_start_callback fun(func: fun()) Alias of `append_start_callback`
 ---@field register_finish_callback fun(func: fun()|fun(got_error: boolean)) Alias of `append_finish_callback`
+---@field register_domain_step fun(clock_name: string, func: fun()) Run `func` on every posedge of a `testbench_gen --clock-domain` clock (needs `--domain-step`)
 ---@field start_callback fun()
 ---@field finish_callback fun()
 local verilua = {
@@ -48,11 +49,22 @@ verilua.record_error = function()
     verilua.got_error = true
 end
 
+--- Folded stacks file of the sampling profiler, see `verilua.utils.Profiler`
+local prof_output = os.getenv("VL_PROF")
+
 verilua.start_callback = function()
     verilua_hello()
     logger:header("[Verilua] Initialization Start", 56)
     verilua.start_time = os.clock()
 
+    if prof_output and prof_output ~= "" then
+        require("verilua.utils.Profiler").start({
+            output = prof_output,
+            interval_ms = tonumber(os.getenv("VL_PROF_INTERVAL_MS") or "1"),
+        })
+        verilua_info("Sampling profiler started, folded stacks => " .. prof_output)
+    end
+
     -- Call user defined start callbacks
     if #verilua.start_callback_vec == 0 then
         -- verilua_warning("[start_callback] Not implemented!")
@@ -111,8 +123,16 @@ verilua.finish_callback = function()
 
     verilua.end_time = os.clock()
 
+    if prof_output and prof_output ~= "" then
+        local nr_samples = require("verilua.utils.Profiler").stop()
+        logger:info(string.format("Sampling profiler: %d samples written to `%s`", nr_samples, prof_output))
+    end
+
     local elapsed_time = verilua.end_time - verilua.start_time
     logger:sim_summary(elapsed_time)
+
+    -- Write out what is still buffered by the native log sink (`Logger.set_sink` / `VL_LOG_SINK`)
+    Logger.close_sink()
 end
 
 function verilua.register_start_callback(func)
@@ -128,6 +148,29 @@ end
 verilua.append_start_callback = verilua.register_start_callback
 verilua.append_finish_callback = verilua.register_finish_callback
 
+--- Step functions of each clock domain, keyed by clock name. The same table is also
+--- stored in `domain_step_funcs_by_id` once libverilua binds the domain id to its name,
+--- so functions registered later are still picked up.
+---@type table<string, fun()[]>
+local domain_step_funcs_by_name = {}
+---@type table<integer, fun()[]>
+local domain_step_funcs_by_id = {}
+
+local function get_domain_step_funcs(clock_name)
+    local funcs = domain_step_funcs_by_name[clock_name]
+    if not funcs then
+        funcs = {}
+        domain_step_funcs_by_name[clock_name] = funcs
+    end
+    return funcs
+end
+
+function verilua.register_domain_step(clock_name, func)
+    assert(type(clock_name) == "string")
+    assert(type(func) == "function")
+    table_insert(get_domain_step_funcs(clock_name), func)
+end
+
 _G.verilua_init = function()
     verilua.start_callback()
 end
@@ -156,6 +199,23 @@ _G.lua_negedge_step = function()
     scheduler:schedule_negedge_tasks()
 end
 
+--- Called by `verilua_domain_step[_safe](id, name)` (libverilua) on every posedge of an extra clock
+--- domain. `name` is only passed the first time a domain id is seen.
+---@param id integer
+---@param name string?
+_G.lua_domain_step = function(id, name)
+    local funcs = domain_step_funcs_by_id[id]
+    if not funcs then
+        assert(name ~= nil, "[lua_domain_step] unknown clock domain id: " .. tostring(id))
+        funcs = get_domain_step_funcs(name)
+        domain_step_funcs_by_id[id] = funcs
+    end
+
+    for i = 1, #funcs do
+        funcs[i]()
+    end
+end
+
 _G.sim_event_chunk_1 = function(task_id_1)
     scheduler:schedule_task(task_id_1)
 end
@@ -0,0 +1,310 @@
+local ffi = require "ffi"
+local bit = require "bit"
+local class = require "pl.class"
+local texpect = require "verilua.TypeExpect"
+local native = require "verilua.coverage.CovBinsNative"
+
+local type = type
+local pairs = pairs
+local ipairs = ipairs
+local assert = assert
+local printf = printf
+local tostring = tostring
+local tonumber = tonumber
+local f = string.format
+local ffi_new = ffi.new
+local bor = bit.bor
+local lshift = bit.lshift
+local math_min = math.min
+
+local verilua_debug = _G.verilua_debug
+local verilua_warning = _G.verilua_warning
+
+local UINT64_MAX = 0xFFFFFFFFFFFFFFFFULL
+
+-- Number of auto bins of a point declared without `bins` (SystemVerilog `auto_bin_max`)
+local DEFAULT_AUTO_BINS = 64
+
+---@param v integer|ffi.cdata*
+---@return string
+local function u64_str(v)
+    return (tostring(v):gsub("U?LL$", ""))
+end
+
+---@param v any
+---@return boolean
+local function is_value(v)
+    return type(v) == "number" or type(v) == "cdata"
+end
+
+--- `"10??_01x1"` style pattern, MSB first, `?`/`x`/`z` are don't care bits
+---@param pattern string
+---@param width integer
+---@param what string
+---@return ffi.cdata* value, ffi.cdata* mask
+local function parse_wildcard(pattern, width, what)
+    local digits = pattern:gsub("_", "")
+    local n = #digits
+    assert(n > 0 and n <= math_min(width, 64),
+        f("[BinCoverPoint] %s: wildcard `%s` must have 1 to %d digits", what, pattern, math_min(width, 64)))
+
+    local value, mask = 0ULL, 0ULL
+    for i = 1, n do
+        local c = digits:sub(i, i)
+        local b = lshift(1ULL, n - i)
+        if c == "1" then
+            value = bor(value, b)
+            mask = bor(mask, b)
+        elseif c == "0" then
+            mask = bor(mask, b)
+        else
+            assert(c == "?" or c == "x" or c == "X" or c == "z" or c == "Z",
+                f("[BinCoverPoint] %s: invalid wildcard digit `%s` in `%s`", what, c, pattern))
+        end
+    end
+    return value, mask
+end
+
+---@alias verilua.coverage.BinSpec {name: string, value?: integer, range?: integer[], wildcard?: string, transition?: (integer|integer[])[], ignore?: boolean, illegal?: boolean, default?: boolean}
+
+---@class (exact) verilua.coverage.BinCoverPoint
+---@overload fun(name: string, coverage_group: verilua.coverage.CoverGroup, params: {width: integer, bins?: verilua.coverage.BinSpec[], auto_bins?: integer, on_illegal?: "error"|"warn"|"count"}): verilua.coverage.BinCoverPoint
+---@field name string
+---@field __type "BinCoverPoint"
+---@field fullname string
+---@field coverage_group verilua.coverage.CoverGroup
+---@field width integer
+---@field on_illegal "error"|"warn"|"count"
+---@field idx integer Index of the point in the native database of the group
+---@field db ffi.cdata*
+---@field bin_names string[] Bin names, in bin index order (index 0 first)
+---@field bin_idx table<string, integer>
+local BinCoverPoint = class()
+
+--- A cover point with declarative bins, matched natively by libcov_bins. The point is added to
+--- `coverage_group` right away and its bins can not change once the group has been sampled.
+---
+--- Bins (`params.bins`, one table each, `name` is required):
+---   { name = "zero", value = 0 }
+---   { name = "low", range = { 1, 15 } }
+---   { name = "odd", wildcard = "???1" }                  -- MSB first, `?`/`x`/`z` are don't care
+---   { name = "rise", transition = { 0, { 1, 3 }, 4 } }   -- consecutive samples, each a value or a range
+---   { name = "reserved", range = { 0xf0, 0xff }, illegal = true }   -- or `ignore = true`
+---   { name = "others", default = true }                  -- hit when no other bin is
+---
+--- Without `bins`, the value space is split into `auto_bins` (default 64) equal ranges.
+--- `on_illegal` is what a sample hitting an illegal bin does: "error" (default), "warn" or "count".
+---@param name string
+---@param coverage_group verilua.coverage.CoverGroup
+---@param params table
+function BinCoverPoint:_init(name, coverage_group, params)
+    texpect.expect_string(name, "name")
+    texpect.expect_covergroup(coverage_group, "coverage_group")
+    texpect.expect_table(params, "params")
+    texpect.expect_integer(params.width, "params.width")
+    assert(params.width > 0, "[BinCoverPoint] params.width must be positive")
+
+    local on_illegal = params.on_illegal or "error"
+    assert(on_illegal == "error" or on_illegal == "warn" or on_illegal == "count",
+        "[BinCoverPoint] params.on_illegal must be one of `error`, `warn`, `count`, got: " .. tostring(on_illegal))
+
+    self.name = name
+    self.__type = "BinCoverPoint"
+    self.fullname = coverage_group.name .. "__" .. name
+    self.coverage_group = coverage_group
+    self.width = params.width
+    self.on_illegal = on_illegal
+    self.bin_names = {}
+    self.bin_idx = {}
+
+    local lib = native.require_lib("BinCoverPoint")
+    self.db = coverage_group:native_db()
+    self.idx = lib.cov_point_add(self.db, name, self.width)
+    assert(self.idx >= 0, "[BinCoverPoint] " .. native.last_error())
+
+    if params.bins then
+        texpect.expect_table(params.bins, "params.bins")
+        for _, spec in ipairs(params.bins) do
+            self:_add_bin(spec)
+        end
+    else
+        self:_add_auto_bins(params.auto_bins or DEFAULT_AUTO_BINS)
+    end
+
+    coverage_group:add_cover_point(self)
+
+    verilua_debug(f("[BinCoverPoint] Create BinCoverPoint: %s -- CoverGroup: %s -- bins: %d\n", name,
+        coverage_group.name, #self.bin_names))
+end
+
+function BinCoverPoint:_register_bin(bin_name, bin_idx)
+    assert(bin_idx >= 0, f("[BinCoverPoint] %s: %s", self.fullname, native.last_error()))
+    self.bin_names[bin_idx + 1] = bin_name
+    self.bin_idx[bin_name] = bin_idx
+end
+
+---@param spec verilua.coverage.BinSpec
+function BinCoverPoint:_add_bin(spec)
+    texpect.expect_table(spec, "bin")
+    texpect.expect_string(spec.name, "bin.name")
+
+    local lib = native.lib
+    local db, idx, bin_name = self.db, self.idx, spec.name
+    local what = self.fullname .. "." .. bin_name
+    assert(self.bin_idx[bin_name] == nil, f("[BinCoverPoint] %s: duplicate bin name", what))
+
+    local kind = native.NORMAL
+    local nr_kinds = 0
+    for key, k in pairs({ ignore = native.IGNORE, illegal = native.ILLEGAL, default = native.DEFAULT }) do
+        if spec[key] then
+            kind = k
+            nr_kinds = nr_kinds + 1
+        end
+    end
+    assert(nr_kinds <= 1, f("[BinCoverPoint] %s: only one of `ignore`, `illegal`, `default` can be set", what))
+
+    local nr_defs = (spec.value ~= nil and 1 or 0) + (spec.range ~= nil and 1 or 0) +
+        (spec.wildcard ~= nil and 1 or 0) + (spec.transition ~= nil and 1 or 0)
+
+    if kind == native.DEFAULT then
+        assert(nr_defs == 0, f("[BinCoverPoint] %s: a default bin takes no value", what))
+        return self:_register_bin(bin_name, lib.cov_bin_add_default(db, idx, bin_name))
+    end
+    assert(nr_defs == 1,
+        f("[BinCoverPoint] %s: a bin needs exactly one of `value`, `range`, `wildcard`, `transition`", what))
+
+    local bin_idx
+    if spec.value ~= nil then
+        assert(is_value(spec.value), f("[BinCoverPoint] %s: `value` must be an integer", what))
+        bin_idx = lib.cov_bin_add_range(db, idx, bin_name, kind, spec.value, spec.value)
+    elseif spec.range ~= nil then
+        local range = spec.range
+        assert(type(range) == "table" and is_value(range[1]) and is_value(range[2]),
+            f("[BinCoverPoint] %s: `range` must be { lo, hi }", what))
+        bin_idx = lib.cov_bin_add_range(db, idx, bin_name, kind, range[1], range[2])
+    elseif spec.wildcard ~= nil then
+        texpect.expect_string(spec.wildcard, "bin.wildcard")
+        local value, mask = parse_wildcard(spec.wildcard, self.width, what)
+        bin_idx = lib.cov_bin_add_wildcard(db, idx, bin_name, kind, value, mask)
+    else
+        local steps = spec.transition
+        assert(type(steps) == "table" and #steps >= 2,
+            f("[BinCoverPoint] %s: `transition` needs at least 2 steps", what))
+        local c_steps = ffi_new("uint64_t[?]", #steps * 2)
+        for i, step in ipairs(steps) do
+            if type(step) == "table" then
+                assert(is_value(step[1]) and is_value(step[2]),
+                    f("[BinCoverPoint] %s: transition step %d must be a value or { lo, hi }", what, i))
+                c_steps[2 * i - 2], c_steps[2 * i - 1] = step[1], step[2]
+            else
+                assert(is_value(step), f("[BinCoverPoint] %s: transition step %d must be a value or { lo, hi }", what, i))
+                c_steps[2 * i - 2], c_steps[2 * i - 1] = step, step
+            end
+        end
+        bin_idx = lib.cov_bin_add_transition(db, idx, bin_name, kind, c_steps, #steps)
+    end
+    self:_register_bin(bin_name, bin_idx)
+end
+
+--- Split [0, 2^width - 1] (capped at 64 bits) into `nr_bins` equal ranges, the last one takes
+--- the remainder.
+---@param nr_bins integer
+function BinCoverPoint:_add_auto_bins(nr_bins)
+    texpect.expect_integer(nr_bins, "params.auto_bins")
+    assert(nr_bins > 0, "[BinCoverPoint] params.auto_bins must be positive")
+
+    local max = self.width >= 64 and UINT64_MAX or lshift(1ULL, self.width) - 1
+    if self.width < 64 and max + 1 < nr_bins then
+        nr_bins = tonumber(max) + 1
+    end
+
+    -- floor((max + 1) / nr_bins) without overflowing at 64 bits
+    local size = max / nr_bins
+    if max % nr_bins + 1 == nr_bins then
+        size = size + 1
+    end
+
+    local lib = native.lib
+    for i = 0, nr_bins - 1 do
+        local lo = size * i
+        local hi = i == nr_bins - 1 and max or lo + size - 1
+        local bin_name = lo == hi and f("auto[%s]", u64_str(lo)) or f("auto[%s:%s]", u64_str(lo), u64_str(hi))
+        self:_register_bin(bin_name, lib.cov_bin_add_range(self.db, self.idx, bin_name, native.NORMAL, lo, hi))
+    end
+end
+
+function BinCoverPoint:_illegal(value)
+    if self.on_illegal == "count" then
+        return
+    end
+
+    local bin = native.lib.cov_point_last_illegal(self.db, self.idx)
+    local value_str = type(value) == "table" and value.to_hex_str and ("0x" .. value:to_hex_str()) or u64_str(value)
+    local msg = f("[BinCoverPoint] %s: value %s hits illegal bin `%s`", self.fullname, value_str,
+        tostring(self.bin_names[bin + 1]))
+    if self.on_illegal == "error" then
+        assert(false, msg)
+    else
+        verilua_warning(msg)
+    end
+end
+
+--- Sample a value: a number, an integer cdata (e.g. `uint64_t`) or a BitVec. Values wider than
+--- 64 bits with any bit above bit 63 set only hit the default bin. Crosses see the sample on the
+--- next `CoverGroup:commit()` (`CoverGroup:sample()` commits by itself).
+---@param value integer|ffi.cdata*|verilua.utils.BitVec
+function BinCoverPoint:sample(value)
+    local illegal
+    if type(value) == "table" then
+        assert(value.__type == "BitVec", "[BinCoverPoint] sample() takes a number, an integer cdata or a BitVec")
+        illegal = native.lib.cov_point_sample_limbs(self.db, self.idx, value.limbs, value.nr_limbs)
+    else
+        illegal = native.lib.cov_point_sample(self.db, self.idx, value)
+    end
+    if illegal > 0 then
+        self:_illegal(value)
+    end
+end
+
+--- Sample a little-endian `uint64_t` limb array of `nr_limbs` limbs.
+---@param limbs ffi.cdata*
+---@param nr_limbs integer
+function BinCoverPoint:sample_limbs(limbs, nr_limbs)
+    if native.lib.cov_point_sample_limbs(self.db, self.idx, limbs, nr_limbs) > 0 then
+        self:_illegal("<limbs>")
+    end
+end
+
+--- Hit count of a bin.
+---@param bin_name string
+---@return integer
+function BinCoverPoint:hits(bin_name)
+    local bin = self.bin_idx[bin_name]
+    assert(bin, f("[BinCoverPoint] %s: unknown bin `%s`", self.fullname, tostring(bin_name)))
+    return tonumber(native.lib.cov_bin_hits(self.db, self.idx, bin)) --[[@as integer]]
+end
+
+---@return integer
+function BinCoverPoint:samples()
+    return tonumber(native.lib.cov_point_samples(self.db, self.idx)) --[[@as integer]]
+end
+
+--- Covered normal bins over all normal bins, in percent.
+---@return number
+function BinCoverPoint:coverage()
+    return native.lib.cov_point_coverage(self.db, self.idx)
+end
+
+function BinCoverPoint:dump()
+    local lib = native.lib
+    printf("[BinCoverPoint: %s CoverGroup: %s] => %.2f%% (%d samples)\n", self.name, self.coverage_group.name,
+        self:coverage(), self:samples())
+    for i, bin_name in ipairs(self.bin_names) do
+        local kind = lib.cov_bin_kind(self.db, self.idx, i - 1)
+        local tag = kind == native.IGNORE and " (ignore)" or kind == native.ILLEGAL and " (illegal)" or
+            kind == native.DEFAULT and " (default)" or ""
+        printf("    %-24s %d%s\n", bin_name, self:hits(bin_name), tag)
+    end
+end
+
+return BinCoverPoint
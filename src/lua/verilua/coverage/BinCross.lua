@@ -0,0 +1,108 @@
+local ffi = require "ffi"
+local class = require "pl.class"
+local texpect = require "verilua.TypeExpect"
+local native = require "verilua.coverage.CovBinsNative"
+
+local type = type
+local ipairs = ipairs
+local assert = assert
+local printf = printf
+local tostring = tostring
+local tonumber = tonumber
+local f = string.format
+local ffi_new = ffi.new
+
+local verilua_debug = _G.verilua_debug
+
+---@class (exact) verilua.coverage.BinCross
+---@overload fun(name: string, coverage_group: verilua.coverage.CoverGroup, points: (verilua.coverage.BinCoverPoint|string)[]): verilua.coverage.BinCross
+---@field name string
+---@field __type "BinCross"
+---@field fullname string
+---@field coverage_group verilua.coverage.CoverGroup
+---@field points verilua.coverage.BinCoverPoint[]
+---@field idx integer Index of the cross in the native database of the group
+---@field db ffi.cdata*
+---@field c_bins ffi.cdata* Scratch `uint32_t[#points]` for hits()
+local BinCross = class()
+
+--- Cross coverage of two or more BinCoverPoints of the same group: one cell per combination of
+--- their normal bins. A cell is hit when every crossed point hit the bin since the last
+--- `CoverGroup:commit()`. The cross is added to `coverage_group` right away.
+---@param name string
+---@param coverage_group verilua.coverage.CoverGroup
+---@param points (verilua.coverage.BinCoverPoint|string)[] The points, or their names in the group
+function BinCross:_init(name, coverage_group, points)
+    texpect.expect_string(name, "name")
+    texpect.expect_covergroup(coverage_group, "coverage_group")
+    texpect.expect_table(points, "points")
+    assert(#points >= 2, f("[BinCross] %s: a cross needs at least 2 cover points", name))
+
+    self.name = name
+    self.__type = "BinCross"
+    self.fullname = coverage_group.name .. "__" .. name
+    self.coverage_group = coverage_group
+    self.points = {}
+
+    local c_points = ffi_new("uint32_t[?]", #points)
+    for i, point in ipairs(points) do
+        if type(point) == "string" then
+            point = coverage_group.points[point]
+            assert(point, f("[BinCross] %s: no cover point named `%s` in CoverGroup %s", name, points[i],
+                coverage_group.name))
+        end
+        assert(point.__type == "BinCoverPoint" and point.coverage_group == coverage_group,
+            f("[BinCross] %s: point %d is not a BinCoverPoint of CoverGroup %s", name, i, coverage_group.name))
+        self.points[i] = point
+        c_points[i - 1] = point.idx
+    end
+
+    local lib = native.require_lib("BinCross")
+    self.db = coverage_group:native_db()
+    self.idx = lib.cov_cross_add(self.db, name, c_points, #points)
+    assert(self.idx >= 0, "[BinCross] " .. native.last_error())
+    self.c_bins = ffi_new("uint32_t[?]", #points)
+
+    coverage_group:add_cross(self)
+
+    verilua_debug(f("[BinCross] Create BinCross: %s -- CoverGroup: %s -- points: %d\n", name, coverage_group.name,
+        #points))
+end
+
+--- Hit count of one cell, given one bin name per crossed point.
+---@param bin_names string[]
+---@return integer
+function BinCross:hits(bin_names)
+    texpect.expect_table(bin_names, "bin_names")
+    assert(#bin_names == #self.points, f("[BinCross] %s: expected %d bin names", self.fullname, #self.points))
+    for i, point in ipairs(self.points) do
+        local bin = point.bin_idx[bin_names[i]]
+        assert(bin, f("[BinCross] %s: unknown bin `%s` of %s", self.fullname, tostring(bin_names[i]), point.name))
+        self.c_bins[i - 1] = bin
+    end
+    return tonumber(native.lib.cov_cross_hits(self.db, self.idx, self.c_bins)) --[[@as integer]]
+end
+
+--- Number of cells, the product of the normal bin counts of the crossed points.
+---@return integer
+function BinCross:num_cells()
+    return tonumber(native.lib.cov_cross_num_cells(self.db, self.idx)) --[[@as integer]]
+end
+
+---@return integer
+function BinCross:covered_cells()
+    return tonumber(native.lib.cov_cross_covered_cells(self.db, self.idx)) --[[@as integer]]
+end
+
+--- Covered cells over all cells, in percent.
+---@return number
+function BinCross:coverage()
+    return native.lib.cov_cross_coverage(self.db, self.idx)
+end
+
+function BinCross:dump()
+    printf("[BinCross: %s CoverGroup: %s] => %.2f%% (%d / %d cells)\n", self.name, self.coverage_group.name,
+        self:coverage(), self:covered_cells(), self:num_cells())
+end
+
+return BinCross
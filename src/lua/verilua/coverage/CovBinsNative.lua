@@ -0,0 +1,131 @@
+local ffi = require "ffi"
+
+local assert = assert
+local ffi_gc = ffi.gc
+local ffi_string = ffi.string
+local f = string.format
+
+-- Bin based coverage engine behind `verilua.coverage.BinCoverPoint` (`src/cov_bins`, built as
+-- libcov_bins.so). Keep in sync with `src/cov_bins/cov_bins.h`.
+pcall(ffi.cdef, [[
+    typedef struct cov_db cov_db;
+
+    const char *cov_last_error(void);
+
+    cov_db *cov_db_new(const char *name);
+    void cov_db_free(cov_db *db);
+    const char *cov_db_name(const cov_db *db);
+
+    int cov_point_add(cov_db *db, const char *name, uint32_t width);
+    int cov_bin_add_range(cov_db *db, int point, const char *name, int kind, uint64_t lo, uint64_t hi);
+    int cov_bin_add_wildcard(cov_db *db, int point, const char *name, int kind, uint64_t value, uint64_t mask);
+    int cov_bin_add_transition(cov_db *db, int point, const char *name, int kind, const uint64_t *steps, uint32_t nsteps);
+    int cov_bin_add_default(cov_db *db, int point, const char *name);
+    int cov_cross_add(cov_db *db, const char *name, const uint32_t *points, uint32_t npoints);
+
+    int cov_point_sample(cov_db *db, int point, uint64_t value);
+    int cov_point_sample_limbs(cov_db *db, int point, const uint64_t *limbs, size_t nlimbs);
+    void cov_group_commit(cov_db *db);
+    int cov_group_sample(cov_db *db, const uint64_t *values, size_t n);
+
+    uint32_t cov_db_num_points(const cov_db *db);
+    uint32_t cov_db_num_crosses(const cov_db *db);
+    uint64_t cov_db_samples(const cov_db *db);
+    const char *cov_point_name(const cov_db *db, int point);
+    uint32_t cov_point_num_bins(const cov_db *db, int point);
+    uint64_t cov_point_samples(const cov_db *db, int point);
+    int cov_point_last_illegal(const cov_db *db, int point);
+    const char *cov_bin_name(const cov_db *db, int point, int bin);
+    int cov_bin_kind(const cov_db *db, int point, int bin);
+    uint64_t cov_bin_hits(const cov_db *db, int point, int bin);
+    const char *cov_cross_name(const cov_db *db, int cross);
+    uint64_t cov_cross_hits(const cov_db *db, int cross, const uint32_t *bins);
+    uint64_t cov_cross_num_cells(const cov_db *db, int cross);
+    uint64_t cov_cross_covered_cells(const cov_db *db, int cross);
+    double cov_point_coverage(const cov_db *db, int point);
+    double cov_cross_coverage(const cov_db *db, int cross);
+    double cov_db_coverage(const cov_db *db);
+
+    uint64_t cov_db_shape_hash(const cov_db *db);
+    int cov_db_merge(cov_db *dst, const cov_db *src);
+    int cov_db_save(const cov_db *db, const char *path);
+    cov_db *cov_db_load(const char *path);
+    int cov_db_write_json(const cov_db *db, const char *path, const char *meta);
+]])
+
+---@class (exact) verilua.coverage.CovBinsNative
+---@field lib any? The loaded libcov_bins, nil if it is not available
+---@field NORMAL integer
+---@field IGNORE integer
+---@field ILLEGAL integer
+---@field DEFAULT integer
+local M = {
+    lib = nil,
+
+    -- Bin kinds, see `cov_bins.h`
+    NORMAL = 0,
+    IGNORE = 1,
+    ILLEGAL = 2,
+    DEFAULT = 3,
+}
+
+-- Try $VERILUA_HOME/shared/libcov_bins.so first, then the system LD_LIBRARY_PATH.
+-- `VL_COV_BINS_NATIVE=0` behaves as if the library was not built.
+local function load_lib()
+    if os.getenv("VL_COV_BINS_NATIVE") == "0" then
+        return nil
+    end
+
+    local verilua_home = os.getenv("VERILUA_HOME")
+    if verilua_home then
+        local ok, lib = pcall(ffi.load, verilua_home .. "/shared/libcov_bins.so")
+        if ok then
+            return lib
+        end
+    end
+
+    local ok, lib = pcall(ffi.load, "cov_bins")
+    if ok then
+        return lib
+    end
+    return nil
+end
+
+M.lib = load_lib()
+
+--- The loaded library, raises an error naming `who` if it is not available.
+---@param who string
+---@return any
+function M.require_lib(who)
+    local lib = M.lib
+    assert(lib,
+        f("[%s] libcov_bins is not available, build it with `xmake build libcov_bins` (or unset VL_COV_BINS_NATIVE=0)",
+            who))
+    return lib
+end
+
+--- Message of the last failed libcov_bins call.
+---@return string
+function M.last_error()
+    return ffi_string(M.lib.cov_last_error())
+end
+
+--- A new empty database, freed by the garbage collector.
+---@param name string
+---@return ffi.cdata*
+function M.new_db(name)
+    local lib = M.require_lib("CovBinsNative")
+    return ffi_gc(lib.cov_db_new(name), lib.cov_db_free)
+end
+
+--- Load the first cover group of a `.covdb` file, freed by the garbage collector.
+---@param path string
+---@return ffi.cdata*
+function M.load_db(path)
+    local lib = M.require_lib("CovBinsNative")
+    local db = lib.cov_db_load(path)
+    assert(db ~= nil, "[CovBinsNative] " .. M.last_error())
+    return ffi_gc(db, lib.cov_db_free)
+end
+
+return M
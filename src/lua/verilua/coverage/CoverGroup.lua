@@ -4,6 +4,8 @@ local texpect = require "verilua.TypeExpect"
 
 local type = type
 local print = print
+local select = select
+local tostring = tostring
 local ipairs = ipairs
 local assert = assert
 local printf = printf
@@ -27,6 +29,10 @@ function CoverGroup:_init(name)
     -- User can use this table to query the cover points by the cover point name
     self.points = {}
 
+    -- BinCoverPoint / BinCross only: their crosses and the native database (created on demand)
+    self.crosses = {}
+    self.db = nil
+
     verilua_debug(f("[CoverGroup] Create CoverGroup: %s\n", name))
 end
 
@@ -47,11 +53,54 @@ function CoverGroup:add_cover_point(cover_point)
     table_insert(self.cover_points, cover_point)
 end
 
+function CoverGroup:add_cross(cross)
+    assert(cross.__type == "BinCross", "[CoverGroup] only BinCross can be added as a cross")
+    for _, c in ipairs(self.crosses) do
+        assert(c.name ~= cross.name, f("[CoverGroup] %s duplicate cross name: %s", self.name, cross.name))
+    end
+    table_insert(self.crosses, cross)
+end
+
+--- The libcov_bins database holding the bins of the BinCoverPoints of this group
+function CoverGroup:native_db()
+    if not self.db then
+        self.db = require("verilua.coverage.CovBinsNative").new_db(self.name)
+    end
+    return self.db
+end
+
+--- Update the crosses with the points sampled since the previous commit (BinCoverPoint only)
+function CoverGroup:commit()
+    assert(self.db, f("[CoverGroup] %s has no BinCoverPoint", self.name))
+    require("verilua.coverage.CovBinsNative").lib.cov_group_commit(self.db)
+end
+
+--- Sample every BinCoverPoint, in the order they were created, then commit, e.g.
+--- `cg:sample(opcode, size)` for a group with the points `opcode` and `size`
+function CoverGroup:sample(...)
+    local nr_values = select("#", ...)
+    assert(nr_values == #self.cover_points,
+        f("[CoverGroup] %s: sample() expects %d values, got %d", self.name, #self.cover_points, nr_values))
+    for i = 1, nr_values do
+        self.cover_points[i]:sample((select(i, ...)))
+    end
+    self:commit()
+end
+
+--- Mean coverage of the points and crosses in percent (BinCoverPoint only)
+function CoverGroup:coverage()
+    assert(self.db, f("[CoverGroup] %s has no BinCoverPoint", self.name))
+    return require("verilua.coverage.CovBinsNative").lib.cov_db_coverage(self.db)
+end
+
 function CoverGroup:report()
     print("\nCoverageGroup Report: ------------------------------------------- ")
     for i, cover_point in ipairs(self.cover_points) do
         cover_point:dump()
     end
+    for _, cross in ipairs(self.crosses) do
+        cross:dump()
+    end
     print("-----------------------------------------------------------------\n ")
 end
 
@@ -64,6 +113,20 @@ function CoverGroup:save(_filename)
     printf("[CoverGroup] Save coverage group: `%s` into `%s`, cover point type is `%s`\n", self.name, filename,
         self.cover_point_type)
 
+    if self.cover_point_type == "BinCoverPoint" then
+        -- JSON for reading, plus a `.covdb` next to it for `cov_merge`
+        local native = require "verilua.coverage.CovBinsNative"
+        local meta = f("\"date\": \"%s\",\n  \"simulator\": \"%s\",\n  \"nr_cover_point\": %d", os.date(),
+            tostring(cfg.simulator), #self.cover_points)
+        assert(native.lib.cov_db_write_json(self.db, filename, meta) == 0, "[CoverGroup] " .. native.last_error())
+
+        local db_filename = filename:gsub("%.json$", "") .. ".covdb"
+        assert(native.lib.cov_db_save(self.db, db_filename) == 0, "[CoverGroup] " .. native.last_error())
+
+        self.saved = true
+        return
+    end
+
     local file = io.open(filename, 'w')
     assert(file, f("[CoverGroup] Failed to open file `%s` for writing", filename))
     file:write("{\n")
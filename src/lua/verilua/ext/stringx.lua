@@ -73,6 +73,7 @@ local scheduler = require "verilua.scheduler.LuaScheduler"
 ---@field hier string
 ---@field prefix string
 ---@field name string
+---@field packed? boolean
 ---@field [string] string|number
 
 ---@class (exact) string.bdl.params
@@ -81,6 +82,7 @@ local scheduler = require "verilua.scheduler.LuaScheduler"
 ---@field is_decoupled? boolean Default is `true`
 ---@field name? string
 ---@field optional_signals? table<integer, string>
+---@field packed? boolean Register the signals as one handle group, `get_all()` fills a struct. Default is `false`
 
 ---@class (exact) string.tcc_compile.sym_ptr_tbl
 ---@field sym string
@@ -533,6 +535,7 @@ local process_bundle = function(str, params_table)
     local prefix = ""
     local is_decoupled = true
     local name = "Unknown"
+    local packed = false
 
     ---@type table<integer, string>?
     local optional_signals
@@ -553,6 +556,9 @@ local process_bundle = function(str, params_table)
                 assert(type(value[1]) == "string")
             end
             optional_signals = value
+        elseif key == "packed" then
+            assert(type(value) == "boolean")
+            packed = value
         elseif key == "hier" then
             -- pass
         else
@@ -560,7 +566,8 @@ local process_bundle = function(str, params_table)
                 "[bundle] unkonwn key => " ..
                 tostring(key) ..
                 " value => " ..
-                tostring(value) .. ", available keys: `prefix`, `is_decoupled`, `name`, `optional_signals`, `hier`")
+                tostring(value) ..
+                ", available keys: `prefix`, `is_decoupled`, `name`, `optional_signals`, `packed`, `hier`")
         end
     end
 
@@ -575,7 +582,7 @@ local process_bundle = function(str, params_table)
         end
     end
 
-    return Bundle(_signals_table, prefix, hier, name, is_decoupled, optional_signals)
+    return Bundle(_signals_table, prefix, hier, name, is_decoupled, optional_signals, packed)
 end
 string.bundle = process_bundle
 string.bdl = process_bundle
@@ -732,6 +739,7 @@ string.abdl = function(str, params_table)
 
     local prefix = ""
     local name = "Unknown"
+    local packed = false
 
     ---@type tablelib<integer, string>?
     local optional_signals
@@ -743,6 +751,9 @@ string.abdl = function(str, params_table)
         elseif key == "name" then
             assert(type(value) == "string", "[abdl] invalid type for the `name` field, valid type: `string`")
             name = value
+        elseif key == "packed" then
+            assert(type(value) == "boolean", "[abdl] invalid type for the `packed` field, valid type: `boolean`")
+            packed = value
         elseif key == "optional_signals" then
             assert(type(value) == "table")
             if #value > 0 then
@@ -765,7 +776,7 @@ string.abdl = function(str, params_table)
         end
     end
 
-    return AliasBundle(alias_tbl, prefix, hier, name, optional_signals)
+    return AliasBundle(alias_tbl, prefix, hier, name, optional_signals, packed)
 end
 
 --- Create an event handle from a string identifier.
@@ -1,8 +1,10 @@
+local ffi = require "ffi"
 local vpiml = require "verilua.vpiml.vpiml"
 local texpect = require "verilua.TypeExpect"
 local table_new = require "table.new"
 local table_clear = require "table.clear"
 local CallableHDL = require "verilua.handles.LuaCallableHDL"
+local HandleGroup = require "verilua.handles.LuaHandleGroup"
 
 ---@diagnostic disable-next-line
 local tablex = require "pl.tablex"
@@ -10,9 +12,11 @@ local tablex = require "pl.tablex"
 local class = require "pl.class"
 
 local type = type
+local rawget = rawget
 local rawset = rawset
 local assert = assert
 local f = string.format
+local ffi_istype = ffi.istype
 local table_insert = table.insert
 local table_concat = table.concat
 
@@ -28,12 +32,18 @@ local verilua_debug = _G.verilua_debug
 ---@field [integer] string other alias name
 
 ---@class (exact) verilua.handles.AliasBundle
----@overload fun(alias_signal_tbl: verilua.handles.AliasBundle.alias_signal_pair[], prefix: string, hierarchy: string, name: string, optional_signals: table<integer, string>?): verilua.handles.AliasBundle
+---@overload fun(alias_signal_tbl: verilua.handles.AliasBundle.alias_signal_pair[], prefix: string, hierarchy: string, name: string, optional_signals: table<integer, string>?, packed: boolean?): verilua.handles.AliasBundle
 ---@field __type string
 ---@field prefix string
 ---@field hierarchy string
 ---@field name string
 ---@field fields verilua.handles.AliasBundle.Field[] field list for iterating primary alias names and CHDL handles
+---@field packed boolean
+---@field packed_t ffi.ctype? Packed mode only: struct type filled by `get_all()`, one field per primary alias name
+---@field get_all? fun(self: verilua.handles.AliasBundle, out?: ffi.cdata*): ffi.cdata* Packed mode only
+---@field set_all? fun(self: verilua.handles.AliasBundle, values: ffi.cdata*|table<integer, integer|integer[]>) Packed mode only
+---@field fire? fun(self: verilua.handles.AliasBundle): boolean Packed mode only, needs a `valid` field
+---@field handle_group? fun(self: verilua.handles.AliasBundle): verilua.handles.HandleGroup Packed mode only
 ---@field private signals_tbl table<integer, string>
 ---@field private alias_tbl table<integer, table<integer, string>>
 ---@field private __dump_parts table<integer, string>
@@ -58,6 +68,7 @@ local AliasBundle = class()
 -- @hierarchy :
 --      signal_name => <hierarchy>.<prefix>_<org_name>
 -- @name: bundle name
+-- @packed: register every field as one handle group, see `AliasBundle:_init_packed()`
 --
 --
 -- Example:
@@ -79,7 +90,8 @@ local AliasBundle = class()
 ---@param hierarchy string
 ---@param name string
 ---@param optional_signals? table<integer, string>
-function AliasBundle:_init(alias_signal_tbl, prefix, hierarchy, name, optional_signals)
+---@param packed? boolean
+function AliasBundle:_init(alias_signal_tbl, prefix, hierarchy, name, optional_signals, packed)
     texpect.expect_table(alias_signal_tbl, "alias_signal_tbl")
     texpect.expect_table(alias_signal_tbl[1] --[[@as table]], "alias_signal_tbl[1]")
     texpect.expect_string(prefix, "prefix")
@@ -89,6 +101,7 @@ function AliasBundle:_init(alias_signal_tbl, prefix, hierarchy, name, optional_s
     self.prefix = prefix
     self.hierarchy = hierarchy
     self.name = name or "Unknown"
+    self.packed = packed or false
 
     self.signals_tbl = table_new(#alias_signal_tbl, 0) --[[@as table<integer, string>]]
     for _, x in ipairs(alias_signal_tbl) do
@@ -240,6 +253,73 @@ function AliasBundle:_init(alias_signal_tbl, prefix, hierarchy, name, optional_s
     self.format_dump = function(this, format_func)
         print(this:format_dump_str(format_func))
     end
+
+    if self.packed then
+        self:_init_packed()
+    end
+end
+
+--- Packed mode: the fields are registered as one handle group at construction. `get_all(out?)`
+--- fills a struct of `packed_t` (one field per primary alias name, in `fields` order, typed by
+--- the signal width) in one native call, `set_all` takes such a struct (or a table of values in
+--- `fields` order) and `fire()` evaluates valid && ready natively.
+function AliasBundle:_init_packed()
+    assert(HandleGroup.is_supported, "[AliasBundle] packed mode is not supported by the current vpiml backend")
+    assert(#self.fields > 0, f("[AliasBundle] %s: packed mode needs at least one signal", self.name))
+
+    local chdls = table_new(#self.fields, 0)
+    local names = table_new(#self.fields, 0)
+    local valid_idx, ready_idx
+    for i, field in ipairs(self.fields) do
+        chdls[i] = field.chdl
+        names[i] = field.name
+        if field.chdl == rawget(self, "valid") then
+            valid_idx = i
+        elseif field.chdl == rawget(self, "ready") then
+            ready_idx = i
+        end
+    end
+
+    local group = HandleGroup(chdls)
+    local packed_t = group:make_struct(names)
+    local default_out = packed_t()
+    self.packed_t = packed_t
+
+    self.handle_group = function(this)
+        return group
+    end
+
+    -- The returned struct is `out`, or a struct owned by the bundle that the next call overwrites
+    self.get_all = function(this, out)
+        if out == nil then
+            return group:get_struct(default_out)
+        end
+        if not ffi_istype(packed_t, out) then
+            assert(false, f("[AliasBundle] %s: get_all() expects a `packed_t` struct as `out`, got %s", this.name, tostring(out)))
+        end
+        return group:get_struct(out)
+    end
+
+    self.set_all = function(this, values)
+        if type(values) == "cdata" then
+            -- The struct is read field by field natively, a foreign layout would be read out of bounds
+            if not ffi_istype(packed_t, values) then
+                assert(false, f("[AliasBundle] %s: set_all() expects a `packed_t` struct or a table, got %s", this.name, tostring(values)))
+            end
+            group:set_struct(values)
+        elseif not group:set_all(values) then
+            for i, chdl in ipairs(chdls) do
+                chdl:set(values[i])
+            end
+        end
+    end
+
+    if valid_idx then
+        group:set_fire(valid_idx, ready_idx)
+        self.fire = function(this)
+            return group:fire()
+        end
+    end
 end
 
 return AliasBundle
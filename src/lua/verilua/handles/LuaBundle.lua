@@ -1,3 +1,4 @@
+local ffi = require "ffi"
 local class = require "pl.class"
 local tablex = require "pl.tablex"
 local table_new = require "table.new"
@@ -5,30 +6,41 @@ local table_clear = require "table.clear"
 local vpiml = require "verilua.vpiml.vpiml"
 local texpect = require "verilua.TypeExpect"
 local CallableHDL = require "verilua.handles.LuaCallableHDL"
+local HandleGroup = require "verilua.handles.LuaHandleGroup"
 
+local type = type
 local assert = assert
+local rawget = rawget
 local rawset = rawset
 local ipairs = ipairs
 local f = string.format
+local ffi_istype = ffi.istype
 local table_concat = table.concat
 local table_insert = table.insert
 
 local verilua_debug = _G.verilua_debug
 
 ---@class (exact) verilua.handles.Bundle
----@overload fun(signals_table: table<integer, string>, prefix: string, hierarchy: string, name: string, is_decoupled: boolean, optional_signals?: table<integer, string>): verilua.handles.Bundle
+---@overload fun(signals_table: table<integer, string>, prefix: string, hierarchy: string, name: string, is_decoupled: boolean, optional_signals?: table<integer, string>, packed?: boolean): verilua.handles.Bundle
 ---@field __type string
 ---@field signals_table table<integer, string>
 ---@field prefix string
 ---@field hierarchy string
 ---@field name string
 ---@field is_decoupled boolean
+---@field packed boolean
+---@field packed_t ffi.ctype? Packed mode only: struct type filled by `get_all()`, one field per signal
 ---@field bits table<string, verilua.handles.CallableHDL>
 ---@field valid verilua.handles.CallableHDL
 ---@field ready verilua.handles.CallableHDL
 ---@field fire fun(self: verilua.handles.Bundle): boolean
----@field get_all fun(self: verilua.handles.Bundle): table<integer, integer|verilua.handles.MultiBeatData>
----@field set_all fun(self: verilua.handles.Bundle, values_tbl: table<integer, integer|integer[]>)
+---@field get_all fun(self: verilua.handles.Bundle, out?: ffi.cdata*): table<integer, integer|verilua.handles.MultiBeatData>|ffi.cdata*
+---@field set_all fun(self: verilua.handles.Bundle, values_tbl: table<integer, integer|integer[]>|ffi.cdata*)
+---@field get_all_packed fun(self: verilua.handles.Bundle): ffi.cdata*
+---@field set_all_packed fun(self: verilua.handles.Bundle, buf: ffi.cdata*)
+---@field handle_group fun(self: verilua.handles.Bundle): verilua.handles.HandleGroup
+---@field private __handle_group verilua.handles.HandleGroup?
+---@field private __packed ffi.cdata*?
 ---@field private __dump_parts table<integer, string>
 ---@field dump_str fun(self: verilua.handles.Bundle): string
 ---@field format_dump_str fun(self: verilua.handles.Bundle, format_func: fun(chdl: verilua.handles.CallableHDL, name: string): string): string
@@ -37,7 +49,7 @@ local verilua_debug = _G.verilua_debug
 ---@field [string] verilua.handles.CallableHDL
 local Bundle = class()
 
-function Bundle:_init(signals_table, prefix, hierarchy, name, is_decoupled, optional_signals)
+function Bundle:_init(signals_table, prefix, hierarchy, name, is_decoupled, optional_signals, packed)
     texpect.expect_table(signals_table, "signals_table")
     texpect.expect_string(prefix, "prefix")
     texpect.expect_string(hierarchy, "hierarchy")
@@ -48,6 +60,7 @@ function Bundle:_init(signals_table, prefix, hierarchy, name, is_decoupled, opti
     self.hierarchy = hierarchy
     self.name = name or "Unknown"
     self.is_decoupled = is_decoupled or false
+    self.packed = packed or false
 
     local valid_index = tablex.find(signals_table, "valid")
     if optional_signals then
@@ -149,17 +162,55 @@ function Bundle:_init(signals_table, prefix, hierarchy, name, is_decoupled, opti
     end
 
     if not self.is_decoupled then
-        self.get_all = function(this)
-            local ret = {}
-            for i, sig in ipairs(this.signals_table) do
-                table_insert(ret, this[sig]:get())
+        -- All signals are moved through one FFI call per get_all/set_all (see LuaHandleGroup),
+        -- the group is created on first use.
+        self.handle_group = function(this)
+            local group = this.__handle_group
+            if group == nil then
+                local chdls = table_new(#this.signals_table, 0)
+                for i, sig in ipairs(this.signals_table) do
+                    chdls[i] = this[sig]
+                end
+                group = HandleGroup(chdls)
+                this.__handle_group = group
             end
-            return ret
+            return group
         end
 
-        self.set_all = function(this, values_tbl)
-            for i, sig in ipairs(this.signals_table) do
-                self[sig]:set(values_tbl[i])
+        self.get_all_packed = function(this)
+            return this:handle_group():get_all_packed()
+        end
+
+        self.set_all_packed = function(this, buf)
+            this:handle_group():set_all_packed(buf)
+        end
+
+        if HandleGroup.is_supported and #self.signals_table > 0 then
+            self.get_all = function(this)
+                return this:handle_group():get_all()
+            end
+
+            self.set_all = function(this, values_tbl)
+                if not this:handle_group():set_all(values_tbl) then
+                    -- Value types the packed path does not handle (e.g. strings), let each signal decide
+                    for i, sig in ipairs(this.signals_table) do
+                        this[sig]:set(values_tbl[i])
+                    end
+                end
+            end
+        else
+            self.get_all = function(this)
+                local ret = {}
+                for i, sig in ipairs(this.signals_table) do
+                    table_insert(ret, this[sig]:get())
+                end
+                return ret
+            end
+
+            self.set_all = function(this, values_tbl)
+                for i, sig in ipairs(this.signals_table) do
+                    self[sig]:set(values_tbl[i])
+                end
             end
         end
     else
@@ -289,6 +340,91 @@ function Bundle:_init(signals_table, prefix, hierarchy, name, is_decoupled, opti
     self.format_dump = function(this, format_func)
         print(this:format_dump_str(format_func))
     end
+
+    if self.packed then
+        self:_init_packed()
+    end
+end
+
+--- Packed mode: every signal (decoupled `bits` included, in `signals_table` order) is registered
+--- as one handle group at construction. `get_all(out?)` fills a struct of `packed_t` (one field per
+--- signal, typed by its width) in one native call, `set_all` takes such a struct (or the usual
+--- value table) and `fire()` evaluates valid && ready natively.
+function Bundle:_init_packed()
+    assert(HandleGroup.is_supported, "[Bundle] packed mode is not supported by the current vpiml backend")
+
+    local chdls, names = {}, {}
+    local valid_idx, ready_idx
+    for _, sig in ipairs(self.signals_table) do
+        local chdl
+        if self.is_decoupled and sig ~= "valid" and sig ~= "ready" then
+            chdl = self.bits[sig]
+        else
+            chdl = rawget(self, sig)
+        end
+
+        -- Optional signals that do not exist are skipped
+        if chdl ~= nil then
+            table_insert(chdls, chdl)
+            table_insert(names, sig)
+            if sig == "valid" then
+                valid_idx = #chdls
+            elseif sig == "ready" then
+                ready_idx = #chdls
+            end
+        end
+    end
+    assert(#chdls > 0, f("[Bundle] %s: packed mode needs at least one signal", self.name))
+
+    local group = HandleGroup(chdls)
+    local packed_t = group:make_struct(names)
+    self.__handle_group = group
+    self.__packed = packed_t()
+    self.packed_t = packed_t
+
+    self.handle_group = function(this)
+        return group
+    end
+
+    self.get_all_packed = function(this)
+        return group:get_all_packed()
+    end
+
+    self.set_all_packed = function(this, buf)
+        group:set_all_packed(buf)
+    end
+
+    -- The returned struct is `out`, or a struct owned by the bundle that the next call overwrites
+    self.get_all = function(this, out)
+        if out == nil then
+            return group:get_struct(this.__packed)
+        end
+        if not ffi_istype(packed_t, out) then
+            assert(false, f("[Bundle] %s: get_all() expects a `packed_t` struct as `out`, got %s", this.name, tostring(out)))
+        end
+        return group:get_struct(out)
+    end
+
+    self.set_all = function(this, values)
+        if type(values) == "cdata" then
+            -- The struct is read field by field natively, a foreign layout would be read out of bounds
+            if not ffi_istype(packed_t, values) then
+                assert(false, f("[Bundle] %s: set_all() expects a `packed_t` struct or a table, got %s", this.name, tostring(values)))
+            end
+            group:set_struct(values)
+        elseif not group:set_all(values) then
+            for i, chdl in ipairs(group.chdls) do
+                chdl:set(values[i])
+            end
+        end
+    end
+
+    if valid_idx then
+        group:set_fire(valid_idx, ready_idx)
+        self.fire = function(this)
+            return group:fire()
+        end
+    end
 end
 
 function Bundle:__tostring()
@@ -156,7 +156,7 @@ local post_init_mt = setmetatable({
 ---
 ---@field set_shuffled fun(self: verilua.handles.CallableHDL) Randomly set the value according to the shuffled range(if shuffled range is set) or bitwidth
 ---@field set_imm_shuffled fun(self: verilua.handles.CallableHDL)
----@field shuffled_range_u32 fun(self: verilua.handles.CallableHDL, u32_vec: table<integer, integer>)
+---@field shuffled_range_u32 fun(self: verilua.handles.CallableHDL, u32_vec: table<integer, integer>|verilua.utils.BitVec|ffi.cdata*, u32_vec_len: integer?)
 ---@field shuffled_range_u64 fun(self: verilua.handles.CallableHDL, u64_vec: table<integer, integer|uint64_t>)
 ---@field shuffled_range_hex_str fun(self: verilua.handles.CallableHDL, hex_str_vec: table<integer, string>)
 ---@field reset_shuffled_range fun(self: verilua.handles.CallableHDL)
@@ -253,10 +253,12 @@ function CallableHDL:_init(fullpath, name, hdl)
     else
         local tmp_hdl = hdl or vpiml.vpiml_handle_by_name_safe(fullpath)
         if tmp_hdl == -1 then
+            local hint = vpiml.vpiml_access_profile_hint(fullpath)
             local err = f(
-                "[CallableHDL:_init] No handle found! fullpath: %s name: %s\t\n%s\n",
+                "[CallableHDL:_init] No handle found! fullpath: %s name: %s\t\n%s%s\n",
                 fullpath,
                 self.name == "" and "Unknown" or self.name,
+                hint == "" and "" or (hint .. "\n"),
                 debug.traceback()
             )
             verilua_debug(err)
@@ -392,9 +394,24 @@ function CallableHDL:_init(fullpath, name, hdl)
         vpiml.vpiml_set_imm_freeze(this.hdl)
     end
 
-    self.shuffled_range_u32 = function(this, u32_vec)
+    self.shuffled_range_u32 = function(this, u32_vec, u32_vec_len)
+        if type(u32_vec) == "cdata" then
+            -- 1-based `uint32_t *` view (BitVec.u32_vec), the length cannot be inferred
+            assert(ffi.istype("uint32_t*", u32_vec), "`u32_vec` must be a table, a BitVec or a `uint32_t *`")
+            assert(type(u32_vec_len) == "number" and u32_vec_len > 0,
+                "`u32_vec_len` is required when `u32_vec` is a `uint32_t *`")
+            vpiml.vpiml_shuffled_range_u32(this.hdl, u32_vec + 1, u32_vec_len)
+            return
+        end
+
         assert(type(u32_vec) == "table", "`u32_vec` must be a table")
 
+        if u32_vec.__type == "BitVec" then
+            ---@cast u32_vec verilua.utils.BitVec
+            vpiml.vpiml_shuffled_range_u32(this.hdl, u32_vec.u32_vec + 1, u32_vec.nr_u32_vec)
+            return
+        end
+
         local v_type = type(u32_vec[1])
         assert(v_type == "number", "`u32_vec` must be a table of `number` type")
 
@@ -871,7 +888,7 @@ end
 --      - number
 --      - string(with prefix)
 --      - table(u32_vec)
---      - cdata (uint64_t or uint32_t[])
+--      - cdata (uint64_t, uint32_t[] or the 1-based `uint32_t *` of BitVec.u32_vec)
 --      - boolean
 -- Auto-type-based value assignment.
 --
@@ -883,6 +900,7 @@ end
 --      <chdl>.value = "0b01011"
 --      <chdl>.value = "123"
 --      <chdl>.value = {0x123, 0x456}
+--      <chdl>.value = bv.u32_vec -- must hold at least <chdl>.beat_num words
 --      <chdl>.value = true
 --      <chdl>.value = false
 --
@@ -909,7 +927,7 @@ function CallableHDL:__newindex(k, v)
         elseif v_type == "cdata" then
             if ffi.istype("uint64_t", v) then
                 self:set_unsafe(v)
-            elseif ffi.istype("uint32_t[]", v) then
+            elseif ffi.istype("uint32_t[]", v) or ffi.istype("uint32_t*", v) then
                 if self.beat_num == 1 then
                     self:set_unsafe(v[1])
                 else
@@ -949,7 +967,7 @@ function CallableHDL:__newindex(k, v)
         elseif v_type == "cdata" then
             if ffi.istype("uint64_t", v) then
                 self:set_imm_unsafe(v)
-            elseif ffi.istype("uint32_t[]", v) then
+            elseif ffi.istype("uint32_t[]", v) or ffi.istype("uint32_t*", v) then
                 if self.beat_num == 1 then
                     self:set_imm_unsafe(v[1])
                 else
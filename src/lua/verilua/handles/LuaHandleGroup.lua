@@ -0,0 +1,249 @@
+--- HandleGroup - Read / write a fixed list of signals with one FFI call
+---
+--- The member handles are registered once in libverilua together with a packed
+--- layout. `get_all` / `set_all` then move every member value through a single
+--- `uint32_t` buffer in one FFI crossing, instead of one `vpiml_get_value*` /
+--- `vpiml_set_value*` call per member.
+---
+--- Buffer layout: member `i` starts at word `offsets[i]`, the slot has the same
+--- layout as `MultiBeatData` (`[0]` = beat_num, `[1..beat_num]` = words, LSB first).
+---
+--- Example usage:
+--- ```lua
+--- local HandleGroup = require "verilua.handles.LuaHandleGroup"
+---
+--- local group = HandleGroup({ dut.opcode:chdl(), dut.data:chdl() })
+--- local values = group:get_all()        -- { <opcode>, <data> }
+--- group:set_all({ 0x1, 0x1234 })
+---
+--- local buf = group:get_all_packed()    -- no per-member conversion
+--- local opcode = buf[group.offsets[1] + 1]
+---
+--- -- Struct layout: one field per member, typed by its width
+--- local packed_t = group:make_struct({ "opcode", "data" })
+--- local s = group:get_struct(packed_t())  -- s.opcode, s.data
+--- group:set_struct(s)
+--- ```
+
+local ffi = require "ffi"
+local class = require "pl.class"
+local table_new = require "table.new"
+local vpiml = require "verilua.vpiml.vpiml"
+
+local type = type
+local ipairs = ipairs
+local assert = assert
+local ffi_new = ffi.new
+local ffi_gc = ffi.gc
+local ffi_istype = ffi.istype
+local ffi_typeof = ffi.typeof
+local ffi_offsetof = ffi.offsetof
+local f = string.format
+local table_concat = table.concat
+local bit_band = bit.band
+local bit_rshift = bit.rshift
+local tonumber = tonumber
+
+local U32_RANGE = 4294967296
+
+---@class (exact) verilua.handles.HandleGroup
+---@overload fun(chdls: verilua.handles.CallableHDL[]): verilua.handles.HandleGroup
+---@field chdls verilua.handles.CallableHDL[]
+---@field offsets integer[] Word offset of every member slot in the packed buffer
+---@field word_num integer Number of `uint32_t` words of the packed buffer
+---@field struct_t ffi.ctype? Struct type set by `make_struct()`
+---@field private _group ffi.cdata*
+---@field private _get_buf ffi.cdata*
+---@field private _set_buf ffi.cdata*
+local HandleGroup = class()
+
+--- Whether the current backend implements handle groups
+HandleGroup.is_supported = vpiml.vpiml_handle_group_new ~= nil
+
+---@param chdls verilua.handles.CallableHDL[]
+function HandleGroup:_init(chdls)
+    assert(HandleGroup.is_supported, "[HandleGroup] not supported by the current vpiml backend")
+    assert(#chdls > 0, "[HandleGroup] expects at least one signal")
+
+    local n = #chdls
+    local handles = ffi_new("int64_t[?]", n)
+    for i, chdl in ipairs(chdls) do
+        assert(not chdl.is_array, "[HandleGroup] array signals are not supported: " .. chdl.fullpath)
+        handles[i - 1] = chdl.hdl
+    end
+
+    ---@diagnostic disable-next-line: param-type-mismatch
+    self._group = ffi_gc(vpiml.vpiml_handle_group_new(handles, n), vpiml.vpiml_handle_group_destroy)
+    self.chdls = chdls
+    self.word_num = vpiml.vpiml_handle_group_word_num(self._group)
+
+    self.offsets = table_new(n, 0)
+    for i = 1, n do
+        self.offsets[i] = vpiml.vpiml_handle_group_offset(self._group, i - 1)
+    end
+
+    self._get_buf = ffi_new("uint32_t[?]", self.word_num)
+    self._set_buf = ffi_new("uint32_t[?]", self.word_num)
+end
+
+--- Read every member into the packed buffer and return it. The buffer is
+--- reused (overwritten) by the next call.
+---@return ffi.cdata*
+function HandleGroup:get_all_packed()
+    vpiml.vpiml_handle_group_get_all(self._group, self._get_buf)
+    return self._get_buf
+end
+
+--- Write every member from a packed buffer (same layout as `get_all_packed()`).
+--- Writes are deferred like `<chdl>:set()`.
+---@param buf ffi.cdata*
+function HandleGroup:set_all_packed(buf)
+    vpiml.vpiml_handle_group_set_all(self._group, buf)
+end
+
+--- C type of a struct field holding a signal of `width` bits: the smallest
+--- unsigned integer up to 64 bits, an array of 32-bit words (LSB first) above.
+---@param name string
+---@param width integer
+---@return string
+local function struct_field(name, width)
+    if width <= 8 then
+        return "uint8_t " .. name
+    elseif width <= 16 then
+        return "uint16_t " .. name
+    elseif width <= 32 then
+        return "uint32_t " .. name
+    elseif width <= 64 then
+        return "uint64_t " .. name
+    end
+    return f("uint32_t %s[%d]", name, math.ceil(width / 32))
+end
+
+--- Generate a struct type with one field per member (named `names[i]`, typed
+--- by the member width, see `struct_field`) and register its layout in
+--- libverilua, so that `get_struct` / `set_struct` convert in native code.
+---@param names string[] Field name of every member, valid C identifiers
+---@return ffi.ctype
+function HandleGroup:make_struct(names)
+    local n = #self.chdls
+    assert(#names == n, f("[HandleGroup] make_struct expects %d field names, got %d", n, #names))
+
+    local fields = table_new(n, 0)
+    for i, chdl in ipairs(self.chdls) do
+        assert(names[i]:match("^[%a_][%w_]*$"), "[HandleGroup] invalid struct field name: " .. tostring(names[i]))
+        fields[i] = struct_field(names[i], chdl.width)
+    end
+    local struct_t = ffi_typeof("struct { " .. table_concat(fields, "; ") .. "; }")
+
+    local byte_offsets = ffi_new("uint32_t[?]", n)
+    local byte_sizes = ffi_new("uint32_t[?]", n)
+    for i, chdl in ipairs(self.chdls) do
+        local width = chdl.width
+        byte_offsets[i - 1] = ffi_offsetof(struct_t, names[i])
+        byte_sizes[i - 1] = width <= 8 and 1 or width <= 16 and 2 or width <= 32 and 4 or width <= 64 and 8 or
+            chdl.beat_num * 4
+    end
+    vpiml.vpiml_handle_group_set_layout(self._group, byte_offsets, byte_sizes)
+
+    self.struct_t = struct_t
+    return struct_t
+end
+
+--- Read every member into `out` (an instance of `struct_t`, see `make_struct`).
+---@param out ffi.cdata*
+---@return ffi.cdata* out
+function HandleGroup:get_struct(out)
+    vpiml.vpiml_handle_group_get_struct(self._group, out)
+    return out
+end
+
+--- Write every member from `inp` (an instance of `struct_t`). Writes are
+--- deferred like `<chdl>:set()`.
+---@param inp ffi.cdata*
+function HandleGroup:set_struct(inp)
+    vpiml.vpiml_handle_group_set_struct(self._group, inp)
+end
+
+--- Select the members checked by `fire()`, by index (1-based), nil if absent
+---@param valid_idx integer?
+---@param ready_idx integer?
+function HandleGroup:set_fire(valid_idx, ready_idx)
+    vpiml.vpiml_handle_group_set_fire(self._group, (valid_idx or 0) - 1, (ready_idx or 0) - 1)
+end
+
+--- Whether every member selected by `set_fire` is 1, in one FFI call
+---@return boolean
+function HandleGroup:fire()
+    return vpiml.vpiml_handle_group_fire(self._group) == 1
+end
+
+--- Read every member, values are converted like `<chdl>:get()`: a number for
+--- signals up to 32 bits, `uint64_t` up to 64 bits and `MultiBeatData` (a view
+--- into the packed buffer, valid until the next call) above.
+---@param ret? table Table to fill, a new one is created if nil
+---@return table<integer, integer|uint64_t|verilua.handles.MultiBeatData>
+function HandleGroup:get_all(ret)
+    local buf = self:get_all_packed()
+    local offsets = self.offsets
+    ret = ret or table_new(#offsets, 0)
+
+    for i, chdl in ipairs(self.chdls) do
+        local off = offsets[i]
+        local beat_num = chdl.beat_num
+        if beat_num == 1 then
+            ret[i] = buf[off + 1]
+        elseif beat_num == 2 then
+            ret[i] = buf[off + 2] * 0x100000000ULL + buf[off + 1]
+        else
+            ret[i] = buf + off --[[@as verilua.handles.MultiBeatData]]
+        end
+    end
+
+    return ret
+end
+
+--- Write every member, `values` accepts the same value types as `<chdl>:set()`
+--- (number / `uint64_t` / table of beats). Returns false, without writing
+--- anything, if a value of another type is found.
+---@param values table<integer, integer|uint64_t|integer[]>
+---@return boolean
+function HandleGroup:set_all(values)
+    local buf = self._set_buf
+    local offsets = self.offsets
+
+    for i, chdl in ipairs(self.chdls) do
+        local v = values[i]
+        local t = type(v)
+        local off = offsets[i]
+        local beat_num = chdl.beat_num
+
+        for j = off + 1, off + beat_num do
+            buf[j] = 0
+        end
+
+        if t == "number" then
+            local lo = v % U32_RANGE
+            buf[off + 1] = lo
+            if beat_num > 1 then
+                buf[off + 2] = (v - lo) / U32_RANGE
+            end
+        elseif t == "cdata" and ffi_istype("uint64_t", v) then
+            buf[off + 1] = tonumber(bit_band(v, 0xFFFFFFFFULL))
+            if beat_num > 1 then
+                buf[off + 2] = tonumber(bit_rshift(v, 32))
+            end
+        elseif t == "table" and beat_num > 1 then
+            assert(#v == beat_num, "len: " .. #v .. " =/= " .. beat_num .. ", fullpath => " .. chdl.fullpath)
+            for j = 1, beat_num do
+                buf[off + j] = v[j]
+            end
+        else
+            return false
+        end
+    end
+
+    vpiml.vpiml_handle_group_set_all(self._group, buf)
+    return true
+end
+
+return HandleGroup
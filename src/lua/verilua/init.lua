@@ -548,7 +548,7 @@ do
                         verilua_debug(f("[verilua/%s]", cmd), "get task name => ", name)
                     end
 
-                    scheduler:append_task(nil, name, func, true) -- (<task_id>, <task_name>, <task_func>, <start_now>)
+                    scheduler:append_task(nil, name, func, true, true) -- (<task_id>, <task_name>, <task_func>, <start_now>, <detached>)
                 end
             end
 
@@ -609,6 +609,23 @@ do
                     vl.append_start_callback(func)
                 end
             end
+            --
+            -- Example (needs `testbench_gen --clock-domain clk_a:10 --domain-step`):
+            --      verilua "domainStep" {
+            --          clk_a = function ()
+            --              -- body, called on every posedge of `clk_a`
+            --          end
+            --      }
+            --
+        elseif cmd == "domainStep" then
+            return function(task_table)
+                assert(type(task_table) == "table")
+                for clock_name, func in pairs(task_table) do
+                    assert(type(clock_name) == "string")
+                    assert(type(func) == "function")
+                    vl.register_domain_step(clock_name, func)
+                end
+            end
         elseif cmd == "showTasks" then
             scheduler:list_tasks()
         else
@@ -618,6 +635,7 @@ do
                 "finishTask",
                 "appendStartTasks",
                 "appendFinishTasks",
+                "domainStep",
                 "showTasks",
             }
             assert(false, "Unknown cmd => " .. cmd .. ", available cmds: " .. _G.inspect(available_cmds))
@@ -650,7 +668,7 @@ do
                 verilua_debug("[fork] get task name => ", name)
             end
 
-            scheduler:append_task(nil, name, func, true) -- (<task_id>, <task_name>, <task_func>, <start_now>)
+            scheduler:append_task(nil, name, func, true, true) -- (<task_id>, <task_name>, <task_func>, <start_now>, <detached>)
         end
     end
 
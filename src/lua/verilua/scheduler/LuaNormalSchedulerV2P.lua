@@ -5,25 +5,25 @@
 
 --[[luajit-pro, {ACC_TIME = 1, EDGE_STEP = 0, NORMAL = 1, SAFETY = 0, STEP = 0}]] 
 
+---@diagnostic disable: need-check-nil, unnecessary-assert
 
+do
 
+end
 
+do
 
+end
 
+local safety_assert
+do
 
 
 
 
 
 
-
-
-
-
-
-
-
-
+end
 
 local debug = require "debug"
 local class = require "pl.class"
@@ -43,41 +43,80 @@ local coro_create = coroutine.create
 ---@cast coro_yield verilua.scheduler.CoroYieldFunc
 
 ---@type fun(): number
-local os_clock
-do    
-os_clock = os.clock
+local perf_now_ns
+do
+    perf_now_ns = require("verilua.utils.PerfCounter").now_ns
 end
 
 local EarlyExit = 4444
 local NOOP = 5555
 
+--
+-- Task table layout
+--
+-- Every task lives in a slot of a dense structure-of-arrays indexed by its task id
+-- (`task_state`, `task_fired`, `task_exec_cnt`, `task_coroutines`, ...), all of them
+-- preallocated Lua arrays. These are plain tables rather than FFI arrays on purpose:
+-- `schedule_task` resumes coroutines, which LuaJIT does not compile, and indexing cdata
+-- from the interpreter is much slower than indexing the array part of a table.
+-- Running tasks are additionally linked into an intrusive doubly-linked ready list
+-- (`ready_next`/`ready_prev`, slot 0 is the list head), so adding or removing a task
+-- is O(1) and iterating the running tasks does not allocate.
+--
+-- Slots of finished *detached* tasks (tasks nobody holds the id of, e.g. `fork`)
+-- go back to a free list and are reused by `_alloc_task_id`. Other ids are never
+-- recycled since a finished task can still be woken up with `wakeup_task(id)`.
+--
+
+-- Values of `task_state`
+local TASK_FREE = 0     -- Never registered (or recycled)
+local TASK_IDLE = 1     -- Registered but not running, can be woken up
+local TASK_RUNNING = 2  -- Running, linked into the ready list
+local TASK_FINISHED = 3 -- Coroutine returned, unlinked by the next `schedule_task`
+local TASK_REMOVING = 4 -- Removed by `remove_task`, unlinked on its next `schedule_task`
+
+local INITIAL_TASK_CAPACITY = 1024
+
 ---@class (exact) verilua.LuaScheduler_gen_LuaNormalSchedulerV2P
 ---@overload fun(): verilua.LuaScheduler_gen_LuaNormalSchedulerV2P
----@field private task_coroutine_map table<verilua.scheduler.TaskID, thread> Map of task IDs to coroutine threads
----@field private task_body_map table<verilua.scheduler.TaskID, verilua.scheduler.CoroutineTaskBody> Map of task IDs to coroutine task bodies
----@field private task_name_map_running table<verilua.scheduler.TaskID, string> Map of running task IDs to task names
----@field private task_name_map_archived table<verilua.scheduler.TaskID, string> Map of archived task IDs to task names
----@field private task_fired_status_map table<verilua.scheduler.TaskID, boolean> Map of task IDs to their fired status
----@field private task_execution_count_map table<verilua.scheduler.TaskID, integer> Map of task IDs to their execution count
----@field private pending_removal_tasks table<integer, verilua.scheduler.TaskID> List of task IDs pending removal
+---@field private task_capacity integer Number of task slots, valid task ids in the slot arrays are `1 .. task_capacity - 1`
+---@field private task_state integer[] State of each task slot(TASK_FREE, TASK_IDLE, ...)
+---@field private task_fired integer[] Whether a task has been fired
+---@field private task_detached integer[] Whether the slot of a task is recycled once it finishes
+---@field private task_exec_cnt integer[] Execution count of each task
+---@field private ready_next integer[] Next task in the ready list(slot 0 is the list head)
+---@field private ready_prev integer[] Previous task in the ready list(slot 0 is the list head)
+---@field private ready_snapshot integer[] Scratch buffer used to iterate the ready list
+---@field private nr_ready_tasks integer Number of tasks in the ready list
+---@field private task_coroutines table<verilua.scheduler.TaskID, thread> Coroutine of each task slot
+---@field private task_bodies table<verilua.scheduler.TaskID, verilua.scheduler.CoroutineTaskBody> Coroutine task body of each task slot
+---@field private task_names table<verilua.scheduler.TaskID, string> Name of each task slot
+---@field private free_task_ids verilua.scheduler.TaskID[] Stack of recycled task ids
+---@field private nr_free_task_ids integer Number of recycled task ids
+---@field private pending_removal_tasks table<integer, verilua.scheduler.TaskID> List of finished task IDs to be unlinked from the ready list
 ---@field private nr_pending_removal_tasks integer Number of tasks pending removal
----@field private nr_user_removal_tasks integer Number of user specified task IDs to be removed
----@field private user_removal_tasks_set table<verilua.scheduler.TaskID, boolean> Set of user specified task IDs to be removed
+---@field private nr_user_removal_tasks integer Number of tasks in TASK_REMOVING state
 ---@field private posedge_tasks table<verilua.scheduler.TaskID, boolean> Set of task IDs triggered on posedge (available only when EDGE_STEP is enabled)
 ---@field private negedge_tasks table<verilua.scheduler.TaskID, boolean> Set of task IDs triggered on negedge (available only when EDGE_STEP is enabled)
----@field private next_task_id verilua.scheduler.TaskID Next available task ID
+---@field private next_task_id verilua.scheduler.TaskID Next never used task ID
 ---@field private next_event_id verilua.scheduler.EventID Next available event ID
 ---@field event_task_id_list_map table<verilua.scheduler.EventID, verilua.scheduler.TaskID[]> Map of event IDs to lists of task IDs
 ---@field event_name_map table<verilua.scheduler.EventID, string> Map of event IDs to event names
 ---@field private task_id_to_event_id_map table<verilua.scheduler.TaskID, verilua.scheduler.EventID> Map of task IDs to event IDs
+---@field native_cond_tasks table<verilua.scheduler.TaskID, boolean> Set of task IDs parked in a `NativeCond` wait (maintained by `await_native_cond`)
 ---@field private has_wakeup_event boolean Indicates if there is a wakeup event
 ---@field private pending_wakeup_event table<verilua.scheduler.EventID, any> List of pending wakeup event IDs
----@field private acc_time_table table<string, number> Accumulated time table
+---@field private acc_time_table table<string, number> Accumulated time(seconds) of each `<task_id>@<task_name>`
+---@field private acc_max_table table<string, number> Longest single resume(seconds) of each `<task_id>@<task_name>`
+---@field private task_acc_ns table<verilua.scheduler.TaskID, number> Time(ns) spent resuming each task slot, not yet folded into `acc_time_table`
+---@field private task_max_ns table<verilua.scheduler.TaskID, number> Longest single resume(ns) of each task slot, not yet folded into `acc_max_table`
 ---@field private _is_valid_task_id fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID): boolean Checks if a task ID is valid
 ---@field private _is_valid_event_id fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, event_id: verilua.scheduler.EventID): boolean Checks if an event ID is valid
----@field private _alloc_task_id fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P): verilua.scheduler.TaskID Allocates a new task ID
+---@field private _get_task_state fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID): integer State of a task, TASK_FREE for ids out of the task table
+---@field private _reserve_task_slot fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID) Grows the task table to hold `task_id`
+---@field private _alloc_task_id fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P): verilua.scheduler.TaskID Allocates a new task ID, reusing recycled ones first
 ---@field private _alloc_event_id fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P): verilua.scheduler.EventID Allocates a new event ID
----@field private _remove_task fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID) Removes a task by ID
+---@field private _remove_task fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID) Marks a task whose coroutine returned as finished
 ---@field register_event fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, event_id: verilua.scheduler.EventID, task_id: verilua.scheduler.TaskID) Registers an event for a task
 ---@field NULL_TASK_ID verilua.scheduler.TaskID Constant representing an invalid task ID(0)
 ---@field curr_task_id verilua.scheduler.TaskID Current task ID
@@ -87,7 +126,8 @@ local NOOP = 5555
 ---@field private send_event fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, event_id: verilua.scheduler.EventID) Sends an event
 ---@field remove_task fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID) Removes a task by ID
 ---@field check_task_exists fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID): boolean Checks if a task exists
----@field append_task fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id?: verilua.scheduler.TaskID, task_name: string, task_body: verilua.scheduler.CoroutineTaskBody, start_now?: boolean): verilua.scheduler.TaskID Appends or registers a new task
+---@field append_task fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id?: verilua.scheduler.TaskID, task_name: string, task_body: verilua.scheduler.CoroutineTaskBody, start_now?: boolean, detached?: boolean): verilua.scheduler.TaskID Appends or registers a new task, the id of a `detached` task is recycled once it finishes
+---@field keep_task_id fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID) Never recycle the id of a detached task(e.g. it is held by a permanent callback)
 ---@field wakeup_task fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID) Wakes up a registered task
 ---@field try_wakeup_task fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID) Tries to wake up a registered task, does nothing if the task is still running
 ---@field schedule_task fun(self: verilua.LuaScheduler_gen_LuaNormalSchedulerV2P, task_id: verilua.scheduler.TaskID) Schedules a specific task
@@ -110,50 +150,152 @@ local SCHEDULER_MAX_TASK_ID = 0xFFFFFFF -- 268435455
 local SCHEDULER_MIN_EVENT_ID = 1
 local SCHEDULER_MAX_EVENT_ID = 0xFFFFFFF -- 268435455
 
+-- Zero fill `arr`(created if nil) from `old_size` up to `size`, indexes start from 0
+local function grow_array(arr, old_size, size)
+    arr = arr or table_new(size, 1)
+    for i = old_size, size - 1 do
+        arr[i] = 0
+    end
+    return arr
+end
+
+local function ready_list_push(self, id)
+    local ready_next = self.ready_next
+    local ready_prev = self.ready_prev
+    local tail = ready_prev[0]
+    ready_next[tail] = id
+    ready_prev[id] = tail
+    ready_next[id] = 0
+    ready_prev[0] = id
+    self.nr_ready_tasks = self.nr_ready_tasks + 1
+end
+
+-- Unlink a task from the ready list, recycling its slot if it is a finished detached task
+local function unlink_task(self, id)
+    local ready_next = self.ready_next
+    local ready_prev = self.ready_prev
+    local next_id = ready_next[id]
+    local prev_id = ready_prev[id]
+    ready_next[prev_id] = next_id
+    ready_prev[next_id] = prev_id
+    self.nr_ready_tasks = self.nr_ready_tasks - 1
+
+    self.task_exec_cnt[id] = 0
+    self.task_fired[id] = 0
+
+    local task_state = self.task_state
+    local task_detached = self.task_detached
+    if task_state[id] == TASK_FINISHED and task_detached[id] ~= 0 then
+        -- Nobody holds the id of a finished detached task and no callback refers to it anymore
+        task_state[id] = TASK_FREE
+        task_detached[id] = 0
+        self.task_coroutines[id] = nil
+        self.task_bodies[id] = nil
+        self.task_id_to_event_id_map[id] = nil
+
+        local nr_free_task_ids = self.nr_free_task_ids + 1
+        self.free_task_ids[nr_free_task_ids] = id
+        self.nr_free_task_ids = nr_free_task_ids
+    else
+        -- A removed task may still be referenced by a pending callback or event, never recycle it
+        task_state[id] = TASK_IDLE
+        task_detached[id] = 0
+    end
+end
+
+-- Move the time accumulated by the task in slot `id` to its `<task_id>@<task_name>` entry, before
+-- the slot gets another name (`append_task`) and when reporting. Keeps string keys off `schedule_task`.
+local fold_task_time
+do
+    fold_task_time = function(self, id)
+        local acc_ns = self.task_acc_ns[id]
+        if not acc_ns then
+            return
+        end
+
+        local name = self.task_names[id]
+        do
+
+
+
+
+        end
+
+        local key = f("%d@%s", id, name)
+        self.acc_time_table[key] = (self.acc_time_table[key] or 0) + acc_ns * 1e-9
+        local max_s = (self.task_max_ns[id] or 0) * 1e-9
+        if max_s > (self.acc_max_table[key] or 0) then
+            self.acc_max_table[key] = max_s
+        end
+        self.task_acc_ns[id] = nil
+        self.task_max_ns[id] = nil
+    end
+end
+
+-- Copy the ready list into `ready_snapshot`, so that `schedule_all_tasks` can iterate it while tasks come and go
+local function ready_list_snapshot(self)
+    local nr_ready_tasks = self.nr_ready_tasks
+    local ready_next = self.ready_next
+    local snapshot = self.ready_snapshot
+    local id = ready_next[0]
+    for i = 0, nr_ready_tasks - 1 do
+        snapshot[i] = id
+        id = ready_next[id]
+    end
+    return snapshot, nr_ready_tasks
+end
+
 function Scheduler:_init()
-    self.task_coroutine_map = {}
-    self.task_body_map = {}
-    self.task_name_map_running = {}
-    self.task_name_map_archived = {}
-    self.task_fired_status_map = {} -- Used to check if a task has been fired
-    self.task_execution_count_map = {}
+    self.task_capacity = 0
+    self:_reserve_task_slot(INITIAL_TASK_CAPACITY - 1)
+    self.nr_ready_tasks = 0
+
+    self.task_coroutines = table_new(INITIAL_TASK_CAPACITY, 0)
+    self.task_bodies = table_new(INITIAL_TASK_CAPACITY, 0)
+    self.task_names = table_new(INITIAL_TASK_CAPACITY, 0)
+
+    self.free_task_ids = {}
+    self.nr_free_task_ids = 0
 
     self.nr_user_removal_tasks = 0
-    self.user_removal_tasks_set = {}
 
     self.pending_removal_tasks = {}
     self.nr_pending_removal_tasks = 0
 
-    
-
-
+    ---@diagnostic disable-next-line: undefined-global
+    do
 
 
+    end
 
-self.next_task_id = SCHEDULER_MIN_TASK_ID
+    self.next_task_id = SCHEDULER_MIN_TASK_ID
     self.next_event_id = SCHEDULER_MIN_EVENT_ID
 
     self.event_task_id_list_map = {}
     self.event_name_map = {}
     self.task_id_to_event_id_map = {}
+    self.native_cond_tasks = {}
     self.has_wakeup_event = false
     self.pending_wakeup_event = {}
 
     self.NULL_TASK_ID = NULL_TASK_ID
     self.curr_task_id = NULL_TASK_ID
-do        
-
-
-self.acc_time_table = {}
-end do        
 
+    ---@diagnostic disable-next-line: undefined-global
+    do
+        self.acc_time_table = {}
+        self.acc_max_table = {}
+        self.task_acc_ns = {}
+        self.task_max_ns = {}
+    end
 
-
-verilua_debug("[Scheduler]", "Using NORMAL scheduler")
-end
-
+    ---@diagnostic disable-next-line: undefined-global
+    do
+        verilua_debug("[Scheduler]", "Using NORMAL scheduler")
+        ---@diagnostic disable-next-line: undefined-global
 
 
+    end
 end
 
 function Scheduler:_is_valid_task_id(id)
@@ -164,31 +306,75 @@ function Scheduler:_is_valid_event_id(id)
     return id <= SCHEDULER_MAX_EVENT_ID and id >= SCHEDULER_MIN_EVENT_ID
 end
 
+function Scheduler:_get_task_state(id)
+    if id < SCHEDULER_MIN_TASK_ID or id >= self.task_capacity then
+        return TASK_FREE
+    end
+    return self.task_state[id]
+end
+
+function Scheduler:_reserve_task_slot(id)
+    local capacity = self.task_capacity
+    if id < capacity then
+        return
+    end
+
+    local new_capacity = capacity > 0 and capacity or INITIAL_TASK_CAPACITY
+    while new_capacity <= id do
+        new_capacity = new_capacity * 2
+    end
+
+    self.task_state = grow_array(self.task_state, capacity, new_capacity)
+    self.task_fired = grow_array(self.task_fired, capacity, new_capacity)
+    self.task_detached = grow_array(self.task_detached, capacity, new_capacity)
+    self.task_exec_cnt = grow_array(self.task_exec_cnt, capacity, new_capacity)
+    self.ready_next = grow_array(self.ready_next, capacity, new_capacity)
+    self.ready_prev = grow_array(self.ready_prev, capacity, new_capacity)
+    self.ready_snapshot = grow_array(self.ready_snapshot, capacity, new_capacity)
+    self.task_capacity = new_capacity
+end
+
 function Scheduler:check_task_exists(id)
-    return self.task_name_map_running[id] ~= nil
+    return self:_get_task_state(id) >= TASK_RUNNING
 end
 
 function Scheduler:_alloc_task_id()
-    while self.task_name_map_archived[self.next_task_id] ~= nil do
-        self.next_task_id = self.next_task_id + 1
-        if self.next_task_id > SCHEDULER_MAX_TASK_ID then
-            assert(
-                false,
-                "[Scheduler] Failed to allocate task id! There are no available task id!"
-            )
-        end
+    local task_state = self.task_state
+
+    -- Reuse the slot of a finished detached task first
+    local nr_free_task_ids = self.nr_free_task_ids
+    if nr_free_task_ids > 0 then
+        local free_task_ids = self.free_task_ids
+        repeat
+            local id = free_task_ids[nr_free_task_ids]
+            nr_free_task_ids = nr_free_task_ids - 1
+
+            -- The slot may have been taken by `append_task` with an explicit id in the meantime
+            if task_state[id] == TASK_FREE then
+                self.nr_free_task_ids = nr_free_task_ids
+                return id
+            end
+        until nr_free_task_ids == 0
+        self.nr_free_task_ids = 0
     end
 
-    -- TODO: How to recycle task id?
     local id = self.next_task_id
-    self.next_task_id = self.next_task_id + 1
-    if self.next_task_id > SCHEDULER_MAX_TASK_ID then
+    local task_capacity = self.task_capacity
+    while id < task_capacity and task_state[id] ~= TASK_FREE do
+        id = id + 1
+    end
+
+    if id >= SCHEDULER_MAX_TASK_ID then
         assert(
             false,
             "[Scheduler] Failed to allocate task id! There are no available task id!"
         )
     end
+    self.next_task_id = id + 1
 
+    if id >= task_capacity then
+        self:_reserve_task_slot(id)
+    end
     return id
 end
 
@@ -216,21 +402,30 @@ function Scheduler:_alloc_event_id()
 end
 
 function Scheduler:_remove_task(id)
-    table_insert(self.pending_removal_tasks, id)
-    self.nr_pending_removal_tasks = self.nr_pending_removal_tasks + 1
-
-
+    local task_state = self.task_state
+    if task_state[id] == TASK_REMOVING then
+        -- Removed by `remove_task` and returned before its next `schedule_task`
+        self.nr_user_removal_tasks = self.nr_user_removal_tasks - 1
+    end
+    task_state[id] = TASK_FINISHED
 
+    local nr_pending_removal_tasks = self.nr_pending_removal_tasks + 1
+    self.pending_removal_tasks[nr_pending_removal_tasks] = id
+    self.nr_pending_removal_tasks = nr_pending_removal_tasks
 
+    ---@diagnostic disable-next-line: undefined-global
+    do
 
 
 
 
 
+    end
 end
 
 function Scheduler:remove_task(id)
-    if not self.task_name_map_archived[id] then
+    local state = self:_get_task_state(id)
+    if state == TASK_FREE then
         if id == 0 then
             assert(
                 false,
@@ -244,8 +439,9 @@ function Scheduler:remove_task(id)
 
     ---@cast id -0
 
-    if self.task_name_map_running[id] ~= nil then
-        self.user_removal_tasks_set[id] = true
+    -- A finished task is unlinked by the next `schedule_task` anyway
+    if state == TASK_RUNNING then
+        self.task_state[id] = TASK_REMOVING
         self.nr_user_removal_tasks = self.nr_user_removal_tasks + 1
     end
 
@@ -270,6 +466,17 @@ function Scheduler:remove_task(id)
             table_remove(m, idx)
         end
     end
+
+    -- A task parked in a `NativeCond` wait is only referenced by the clock's
+    -- waiter list: take it out of there, nothing resumes the task anymore
+    if self.native_cond_tasks[id] then
+        self.native_cond_tasks[id] = nil
+        local vpiml = require "verilua.vpiml.vpiml"
+        if vpiml.vpiml_native_cond_cancel(id) ~= 0 and self.task_state[id] == TASK_REMOVING then
+            self.nr_user_removal_tasks = self.nr_user_removal_tasks - 1
+            unlink_task(self, id)
+        end
+    end
 end
 
 function Scheduler:register_event(event_id, task_id)
@@ -281,9 +488,10 @@ function Scheduler:register_event(event_id, task_id)
 end
 
 -- Used for creating a new coroutine task
-function Scheduler:append_task(id, name, task_body, start_now)
+function Scheduler:append_task(id, name, task_body, start_now, detached)
+    ---@diagnostic disable: undefined-global
+    do
 
-    
 
 
 
@@ -306,110 +514,118 @@ function Scheduler:append_task(id, name, task_body, start_now)
 
 
 
-local task_id = id
+
+
+    end
+
+    local task_id = id
     if id then
         if not self:_is_valid_task_id(id) then
             assert(false, "[Scheduler] Invalid coroutine task id!")
         end
 
-        if self:check_task_exists(id) and not self.user_removal_tasks_set[id] then
-            local task_name = self.task_name_map_running[id]
+        local state = self:_get_task_state(id)
+        if state == TASK_RUNNING or state == TASK_FINISHED then
+            local task_name = self.task_names[id]
             assert(false, "[Scheduler] Task already exists! task_id: " .. id .. ", task_name: " .. task_name)
         end
+
+        self:_reserve_task_slot(id)
     else
         task_id = self:_alloc_task_id()
     end
     ---@cast task_id verilua.scheduler.TaskID
 
-    self.task_name_map_running[task_id] = name
-    self.task_name_map_archived[task_id] = name
-    self.task_fired_status_map[task_id] = false
-    self.task_coroutine_map[task_id] = coro_create(task_body)
-    self.task_body_map[task_id] = task_body
-    self.task_execution_count_map[task_id] = 0
-
-    -- Clear any pending user_removal flag for this task ID. This happens when
-    -- remove_task() was called followed by append_task() with the same ID.
-    -- Clear it so the new task's schedule_task is not skipped.
-    if self.user_removal_tasks_set[task_id] then
-        self.user_removal_tasks_set[task_id] = nil
+    local task_state = self.task_state
+    if task_state[task_id] == TASK_REMOVING then
+        -- remove_task() followed by append_task() with the same ID: the task is still
+        -- linked, drop the removal so the new task's schedule_task is not skipped.
         self.nr_user_removal_tasks = self.nr_user_removal_tasks - 1
+        self.task_detached[task_id] = 0
+        self.task_fired[task_id] = 0
+        self.task_exec_cnt[task_id] = 0
+    else
+        -- Link at the tail of the ready list, the other attributes of an unlinked slot are already zero
+        local ready_next = self.ready_next
+        local ready_prev = self.ready_prev
+        local tail = ready_prev[0]
+        ready_next[tail] = task_id
+        ready_prev[task_id] = tail
+        ready_next[task_id] = 0
+        ready_prev[0] = task_id
+        self.nr_ready_tasks = self.nr_ready_tasks + 1
     end
-do        
 
+    task_state[task_id] = TASK_RUNNING
+    if detached then
+        self.task_detached[task_id] = 1
+    end
+    do
+        fold_task_time(self, task_id)
+    end
+    self.task_names[task_id] = name
+    self.task_coroutines[task_id] = coro_create(task_body)
+    self.task_bodies[task_id] = task_body
 
+    -- print("[Scheduler] Task registered! task_id: " .. task_id .. ", task_name: " .. name)
 
-if start_now then
-            self.task_fired_status_map[task_id] = true
+    do
+        if start_now then
+            self.task_fired[task_id] = 1
             self:schedule_task(task_id)
         end
+    end
+
+    return task_id
 end
-    
-return task_id
+
+function Scheduler:keep_task_id(id)
+    if self:_get_task_state(id) ~= TASK_FREE then
+        self.task_detached[id] = 0
+    end
 end
 
 function Scheduler:wakeup_task(id)
-    local task_name = self.task_name_map_archived[id]
-    if task_name == nil then
+    local state = self:_get_task_state(id)
+    if state == TASK_FREE then
         assert(false, "[Scheduler] Task not registered! task_id: " .. id)
     end
 
-    local removal_task_id = 1
-    local found_in_removal_tasks = false
-    local found_in_user_removal = false
-    if self.task_name_map_running[id] ~= nil then
-        -- Check user_removal first (set by remove_task)
-        if self.user_removal_tasks_set[id] then
-            found_in_user_removal = true
-        else
-            -- Check pending_removal (set by _remove_task when coroutine exits)
-            for i, r_id in ipairs(self.pending_removal_tasks) do
-                if r_id == id then
-                    removal_task_id = i
-                    found_in_removal_tasks = true
-                    break
-                end
-            end
-
-            if not found_in_removal_tasks then
-                assert(false, "[Scheduler] Task already running! task_id: " .. id .. ", task_name: " .. task_name)
-            end
-        end
-    end
-
-    if found_in_user_removal then
-        self.user_removal_tasks_set[id] = nil
+    if state == TASK_RUNNING then
+        assert(false, "[Scheduler] Task already running! task_id: " .. id .. ", task_name: " .. self.task_names[id])
+    elseif state == TASK_REMOVING then
         self.nr_user_removal_tasks = self.nr_user_removal_tasks - 1
-        self.task_name_map_running[id] = nil
-    elseif found_in_removal_tasks then
-        table_remove(self.pending_removal_tasks, removal_task_id)
-        self.nr_pending_removal_tasks = self.nr_pending_removal_tasks - 1
+    elseif state == TASK_IDLE then
+        ready_list_push(self, id)
     end
+    -- A TASK_FINISHED task is still linked, its pending removal is skipped once it is running again
 
-    self.task_name_map_running[id] = task_name
-    self.task_fired_status_map[id] = true
-    self.task_coroutine_map[id] = coro_create(self.task_body_map[id])
+    self.task_state[id] = TASK_RUNNING
+    self.task_fired[id] = 1
+    self.task_coroutines[id] = coro_create(self.task_bodies[id])
     self:schedule_task(id)
 end
 
 function Scheduler:try_wakeup_task(id)
-    if self:check_task_exists(id) and not self.user_removal_tasks_set[id] then
+    local state = self:_get_task_state(id)
+    if state == TASK_RUNNING or state == TASK_FINISHED then
         return
     else
-        local task_name = self.task_name_map_archived[id]
-        if task_name == nil then
+        if state == TASK_FREE then
             assert(false, "[Scheduler] Task not registered! task_id: " .. id)
         end
 
-        self.task_name_map_running[id] = task_name
-        self.task_fired_status_map[id] = true
-        self.task_coroutine_map[id] = coro_create(self.task_body_map[id])
-        -- Clear any stale user_removal flag so the new coroutine is not
-        -- immediately skipped by schedule_task's user_removal check.
-        if self.user_removal_tasks_set[id] then
-            self.user_removal_tasks_set[id] = nil
+        -- Clear any stale user removal so the new coroutine is not
+        -- immediately skipped by schedule_task's user removal check.
+        if state == TASK_REMOVING then
             self.nr_user_removal_tasks = self.nr_user_removal_tasks - 1
+        else
+            ready_list_push(self, id)
         end
+
+        self.task_state[id] = TASK_RUNNING
+        self.task_fired[id] = 1
+        self.task_coroutines[id] = coro_create(self.task_bodies[id])
         self:schedule_task(id)
     end
 end
@@ -418,49 +634,53 @@ function Scheduler:schedule_task(id)
     local nr_pending_removal_tasks = self.nr_pending_removal_tasks
     if nr_pending_removal_tasks > 0 then
         local pending_removal_tasks = self.pending_removal_tasks
+        local task_state = self.task_state
         for i = 1, nr_pending_removal_tasks do
             local remove_id = pending_removal_tasks[i]
 
-            self.task_name_map_running[remove_id] = nil
-            self.task_execution_count_map[remove_id] = 0
-            self.task_fired_status_map[remove_id] = false
-        
-
+            -- Tasks woken up again after they finished are running, keep them
+            if task_state[remove_id] == TASK_FINISHED then
+                do
 
 
 
+                end
 
-end
+                unlink_task(self, remove_id)
+            end
+        end
         self.nr_pending_removal_tasks = 0
-        table_clear(pending_removal_tasks)
+    end
+
+    do
+
+
+
+
     end
 
     if self.nr_user_removal_tasks > 0 then
-        if self.user_removal_tasks_set[id] then
-            self.user_removal_tasks_set[id] = nil
+        if self.task_state[id] == TASK_REMOVING then
             self.nr_user_removal_tasks = self.nr_user_removal_tasks - 1
-
-            self.task_name_map_running[id] = nil
-            self.task_execution_count_map[id] = 0
-            self.task_fired_status_map[id] = false
+            unlink_task(self, id)
             return
         end
     end
 
-    local task_cnt = self.task_execution_count_map[id]
-    self.task_execution_count_map[id] = task_cnt + 1
+    local task_exec_cnt = self.task_exec_cnt
+    task_exec_cnt[id] = task_exec_cnt[id] + 1
 
-    local s, e
-do        
-s = os_clock()
-end
-    
-local old_curr_task_id            = self.curr_task_id
+    local s
+    do
+        s = perf_now_ns()
+    end
+
+    local old_curr_task_id            = self.curr_task_id
     self.curr_task_id                 = id
 
     local ok
     local cb_type_or_err
-    ok, cb_type_or_err = coro_resume(self.task_coroutine_map[id])
+    ok, cb_type_or_err = coro_resume(self.task_coroutines[id])
 
     ---@cast ok boolean
     ---@cast cb_type_or_err verilua.scheduler.TaskCallbackType
@@ -470,8 +690,8 @@ local old_curr_task_id            = self.curr_task_id
         print(f(
             "[Scheduler] Error while executing task(id: %d, name: %s)\n\t%s",
             id,
-            self.task_name_map_running[id],
-            debug.traceback(self.task_coroutine_map[id], cb_type_or_err)
+            self.task_names[id],
+            debug.traceback(self.task_coroutines[id], cb_type_or_err)
         ))
         io.flush()
 
@@ -484,22 +704,17 @@ local old_curr_task_id            = self.curr_task_id
     elseif cb_type_or_err ~= NOOP then
         assert(false, "Unknown callback type yielded by task! callback type: " .. tostring(cb_type_or_err))
     end
-do        
-
-e = os_clock()
-        local name = self.task_name_map_running[id]
-
-        
-
-
-
 
+    do
+        local dt = perf_now_ns() - s
+        local task_acc_ns = self.task_acc_ns
+        task_acc_ns[id] = (task_acc_ns[id] or 0) + dt
+        if dt > (self.task_max_ns[id] or 0) then
+            self.task_max_ns[id] = dt
+        end
+    end
 
-local key = f("%d@%s", id, name)
-        self.acc_time_table[key] = (self.acc_time_table[key] or 0) + (e - s)
-end
-    
-if self.has_wakeup_event then
+    if self.has_wakeup_event then
         self.has_wakeup_event = false
         for _, event_id in ipairs(self.pending_wakeup_event) do
             self.curr_wakeup_event_id = event_id
@@ -528,62 +743,77 @@ function Scheduler:schedule_tasks(id)
 end
 
 function Scheduler:schedule_all_tasks()
-    for id, _ in pairs(self.task_name_map_running) do
-do            
-local fired = self.task_fired_status_map[id]
-            if not fired then
-                self:schedule_task(id)
-                self.task_fired_status_map[id] = true
-            end
-end    
+    -- Tasks finish, wake up or append other tasks while we iterate, walk a snapshot of the ready list
+    local snapshot, nr_ready_tasks = ready_list_snapshot(self)
+    for i = 0, nr_ready_tasks - 1 do
+        local id = snapshot[i]
+
+        -- Skip tasks unlinked by a previous iteration
+        if self.task_state[id] >= TASK_RUNNING then
+            do
+                if self.task_fired[id] == 0 then
+                    self:schedule_task(id)
+                    self.task_fired[id] = 1
+                end
 
 
-end
+            end
+        end
+    end
 end
 
 function Scheduler:schedule_posedge_tasks()
-do        
+    do
 
 
 
 
-assert(false, "[Scheduler] schedule_posedge_tasks() is only available in EDGE_STEP mode!")
-end
+        assert(false, "[Scheduler] schedule_posedge_tasks() is only available in EDGE_STEP mode!")
+    end
 end
 
 function Scheduler:schedule_negedge_tasks()
-do        
+    do
 
 
 
 
-assert(false, "[Scheduler] schedule_negedge_tasks() is only available in EDGE_STEP mode!")
-end
+        assert(false, "[Scheduler] schedule_negedge_tasks() is only available in EDGE_STEP mode!")
+    end
 end
 
 function Scheduler:list_tasks()
     local logger = Logger.new("Scheduler")
     logger:section_start("Task Statistics", 74)
-do        
-local total_time = 0 --[[@as number]]
+    do
+        for id, _ in pairs(self.task_acc_ns) do
+            fold_task_time(self, id)
+        end
+
+        local total_time = 0 --[[@as number]]
         local max_key_str_len = 0 --[[@as integer]]
 
         local task_name_count = {} --[[@as table<string, integer>]]
         for key, _time in pairs(self.acc_time_table) do
-local _task_id, task_name =key:match("([^@]+)@(.*)")
+            local _task_id, task_name = key:match("([^@]+)@(.*)")
             task_name_count[task_name] = (task_name_count[task_name] or 0) + 1
         end
 
         -- Merge task names with more than 20 occurrence into one key
         local filtered_acc_time_table = {} --[[@as table<string, number>]]
+        local filtered_acc_max_table = {} --[[@as table<string, number>]]
         for key, time in pairs(self.acc_time_table) do
-local _task_id, task_name =key:match("([^@]+)@(.*)")
+            local max_time = self.acc_max_table[key] or 0
+            local _task_id, task_name = key:match("([^@]+)@(.*)")
             if task_name_count[task_name] >= 20 then
                 key = f("<...>@%s", task_name)
                 filtered_acc_time_table[key] = (filtered_acc_time_table[key] or 0) + time
             else
                 filtered_acc_time_table[key] = time
             end
+            if max_time > (filtered_acc_max_table[key] or 0) then
+                filtered_acc_max_table[key] = max_time
+            end
 
             total_time = total_time + time
 
@@ -593,6 +823,7 @@ local _task_id, task_name =key:match("([^@]+)@(.*)")
             end
         end
         self.acc_time_table = filtered_acc_time_table
+        self.acc_max_table = filtered_acc_max_table
 
         -- Sort the accumulated time table from small to large
         local sorted_keys = {} --[[@as table<integer, string>]]
@@ -608,28 +839,35 @@ local _task_id, task_name =key:match("([^@]+)@(.*)")
         for _, key in ipairs(sorted_keys) do
             local time = self.acc_time_table[key]
             local percent = time / total_time * 100
-            local info = f("[%-" .. max_key_str_len .. "s] %7.2f ms  %s", key, time * 1000,
-                logger:progress_bar(percent / 100, 25, true))
+            local info = f("[%-" .. max_key_str_len .. "s] %7.2f ms  max %8.1f us  %s", key, time * 1000,
+                (self.acc_max_table[key] or 0) * 1e6, logger:progress_bar(percent / 100, 20, true))
             logger:section_line(info, 74)
         end
 
         logger:section_line(f("total_time: %.2f s / %.2f ms", total_time, total_time * 1000), 74)
         logger:section_line(string.rep("─", 70), 74)
-end
-    
-local max_name_str_len = 0 --[[@as integer]]
-    for _, name in pairs(self.task_name_map_running) do
-        local len = #name
+    end
+
+    local task_names = self.task_names
+    local ready_next = self.ready_next
+
+    local max_name_str_len = 0 --[[@as integer]]
+    local id = ready_next[0]
+    while id ~= 0 do
+        local len = #task_names[id]
         if len > max_name_str_len then
             max_name_str_len = len
         end
+        id = ready_next[id]
     end
 
     local idx = 0
-    for id, name in pairs(self.task_name_map_running) do
-        logger:section_line(f("[%2d] name: %-" .. max_name_str_len .. "s  id: %5d  cnt: %8d", idx, name, id,
-            self.task_execution_count_map[id]), 74)
+    id = ready_next[0]
+    while id ~= 0 do
+        logger:section_line(f("[%2d] name: %-" .. max_name_str_len .. "s  id: %5d  cnt: %8d", idx, task_names[id], id,
+            self.task_exec_cnt[id]), 74)
         idx = idx + 1
+        id = ready_next[id]
     end
     logger:section_end(74)
     print()
@@ -637,25 +875,19 @@ end
 
 function Scheduler:get_running_tasks()
     local tasks = {}
-    for id, name in pairs(self.task_name_map_running) do
-        if not self.user_removal_tasks_set[id] then
-            local is_pending_remove = false
-            for _, pending_id in ipairs(self.pending_removal_tasks) do
-                if pending_id == id then
-                    is_pending_remove = true
-                    break
-                end
-            end
-
-            if not is_pending_remove then
-                ---@type verilua.scheduler.TaskInfo
-                local task_info = {
-                    id = id,
-                    name = name,
-                }
-                table_insert(tasks, task_info)
-            end
+    local task_state = self.task_state
+    local ready_next = self.ready_next
+    local id = ready_next[0]
+    while id ~= 0 do
+        if task_state[id] == TASK_RUNNING then
+            ---@type verilua.scheduler.TaskInfo
+            local task_info = {
+                id = id,
+                name = self.task_names[id],
+            }
+            table_insert(tasks, task_info)
         end
+        id = ready_next[id]
     end
     return tasks
 end
@@ -670,12 +902,11 @@ function Scheduler:get_curr_task_name()
         assert(false, "[Scheduler] Current task id is NULL_TASK_ID(0), which means you are not in a task context!")
     end
 
-    local task_name = self.task_name_map_running[curr_task_id]
-    if not task_name then
-        assert(false, "[Scheduler] Current task id " .. curr_task_id .. " is not in task_name_map_running!")
+    if not self:check_task_exists(curr_task_id) then
+        assert(false, "[Scheduler] Current task id " .. curr_task_id .. " is not a running task!")
     end
 
-    return task_name
+    return self.task_names[curr_task_id]
 end
 
 function Scheduler:send_event(event_id)
@@ -696,11 +927,11 @@ end
 --
 --
 function Scheduler:new_event_hdl(name, user_event_id)
+    do
 
-    
-
+    end
 
-local event_id = user_event_id
+    local event_id = user_event_id
     if not event_id then
         event_id = self:_alloc_event_id()
     else
@@ -136,6 +136,8 @@ end
 
 ---@param signal_hdl verilua.handles.ComplexHandleRaw
 function M.always_await_posedge_hdl(signal_hdl)
+    -- The callback keeps firing with this task id, which must not be handed to another task
+    scheduler:keep_task_id(scheduler.curr_task_id)
     ---@diagnostic disable-next-line
     vpiml.vpiml_register_posedge_callback_always(signal_hdl, scheduler.curr_task_id)
     coro_yield(NOOP)
@@ -155,6 +157,25 @@ function M.await_edge_hdl(signal_hdl)
     coro_yield(NOOP)
 end
 
+--- Wait until the native predicate `cond_handle` holds at an edge of `clock_hdl` (see `verilua.utils.NativeCond`)
+---@param cond_handle ffi.cdata* Compiled predicate from `vpiml_native_cond_new`
+---@param clock_hdl verilua.handles.ComplexHandleRaw
+---@param edge_type integer 0: posedge, 1: negedge, 2: any edge
+---@param max_cycles integer Maximum number of edges to wait, 0 means no limit
+---@return integer result Number of edges waited, negated if `max_cycles` was reached
+function M.await_native_cond(cond_handle, clock_hdl, edge_type, max_cycles)
+    local task_id = scheduler.curr_task_id
+    ---@diagnostic disable-next-line
+    vpiml.vpiml_native_cond_wait(cond_handle, clock_hdl, edge_type, max_cycles, task_id)
+    -- `remove_task` cancels the wait of a parked task
+    local native_cond_tasks = scheduler.native_cond_tasks
+    native_cond_tasks[task_id] = true
+    coro_yield(NOOP)
+    native_cond_tasks[task_id] = nil
+    ---@diagnostic disable-next-line
+    return vpiml.vpiml_native_cond_result(task_id)
+end
+
 ---@param event_id_integer integer
 function M.await_event(event_id_integer)
     scheduler:register_event(event_id_integer, scheduler.curr_task_id)
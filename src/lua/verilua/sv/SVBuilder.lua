@@ -44,11 +44,15 @@ local setmetatable = setmetatable
 ---@field private _covergroup_names {name: string, inst_name: string}[] Metadata for final-block coverage report generation.
 ---@field private coverage_report_enabled boolean Whether the final block coverage report is generated.
 ---@field private lint_enabled boolean Whether automatic sv_lint checking is active on each `add` call.
+---@field private lint_ctx ffi.cdata*? libsv_lint context holding the sources registered by `lint_preload`, created on the first preload. While it exists every lint of this builder goes through it.
 ---@field with_global_envs fun(self: verilua.sv.SVBuilder, envs: table<string, any>): verilua.sv.SVBuilder Register global template variables for all subsequent `add` calls.
 ---@field add fun(self: verilua.sv.SVBuilder, typ: "cover" | "assert" | "property" | "sequence" | "covergroup" | "raw"): fun(params: verilua.sv.SVBuilder.add.params): verilua.sv.SVBuilder.property | verilua.sv.SVBuilder.sequence | nil Curried entry point: select type, then pass params.
 ---@field default_clocking fun(self: verilua.sv.SVBuilder, signal: string|verilua.handles.CallableHDL|verilua.handles.ProxyTableHandle, edge_type: "posedge" | "negedge", overwrite: boolean?): verilua.sv.SVBuilder Set the default sampling clock for SVA and covergroups.
 ---@field clean fun(self: verilua.sv.SVBuilder): verilua.sv.SVBuilder Reset all internal state to empty.
 ---@field set_lint fun(self: verilua.sv.SVBuilder, enable: boolean): verilua.sv.SVBuilder Enable or disable automatic sv_lint checking on each `add` call.
+---@field lint_preload fun(self: verilua.sv.SVBuilder, name: string, text: string): verilua.sv.SVBuilder Register shared SV sources (packages / macro headers) parsed once and seen by every later lint.
+---@field lint_clear_preload fun(self: verilua.sv.SVBuilder): verilua.sv.SVBuilder Drop every source registered by `lint_preload`.
+---@field lint_batch fun(self: verilua.sv.SVBuilder, texts: string[], params?: { names?: string[], jobs?: integer }): table<integer, verilua.sv.SVBuilder.lint_diag[]> Lint many texts in parallel, one diagnostics list (or nil) per text.
 ---@field set_coverage_report fun(self: verilua.sv.SVBuilder, enable: boolean): verilua.sv.SVBuilder Enable or disable the `final` block coverage report for covergroups.
 ---@field generate fun(self: verilua.sv.SVBuilder): string Return the full generated SV text. Equivalent to `tostring(ctx)`.
 local SVBuilder = {
@@ -154,6 +158,26 @@ end
 
 pcall(ffi.cdef, [[
     int sv_lint_text(const char* sv_text, char* out_diag, int out_diag_size);
+
+    typedef struct sv_lint_ctx sv_lint_ctx;
+    typedef struct sv_lint_result sv_lint_result;
+    typedef struct {
+        int unit;
+        int line;
+        int column;
+        int is_error;
+        const char *file;
+        const char *code;
+        const char *message;
+    } sv_lint_diag;
+
+    sv_lint_ctx *sv_lint_ctx_new(void);
+    void sv_lint_ctx_free(sv_lint_ctx *ctx);
+    sv_lint_result *sv_lint_ctx_preload(sv_lint_ctx *ctx, const char *name, const char *text);
+    sv_lint_result *sv_lint_batch(const char **texts, const char **names, int n, sv_lint_ctx *ctx, int jobs);
+    int sv_lint_result_count(const sv_lint_result *res);
+    const sv_lint_diag *sv_lint_result_get(const sv_lint_result *res, int i);
+    void sv_lint_result_free(sv_lint_result *res);
 ]])
 
 local sv_lint_lib ---@type any?
@@ -224,39 +248,70 @@ end
 
 local diag_buf = ffi.new("char[4096]")
 
--- Build a module shell containing all existing context + the new statement,
--- then invoke sv_lint (FFI or subprocess). Returns nil on success, or the
--- first diagnostic string on failure.
--- `as_preamble`: when true (add "raw"), insert new_statement with other
--- preamble chunks before default_clocking so bare clock decls resolve.
----@param as_preamble boolean?
-local function run_sv_lint(self, new_statement, _stmt_name, as_preamble)
-    -- Assemble the full SV text for lint (match generate() order).
-    local parts = { "module __sva_lint;" }
-    for _, v in ipairs(self.preamble_vec) do
-        parts[#parts + 1] = tostring(v)
-    end
-    if as_preamble then
-        parts[#parts + 1] = new_statement
-    end
-    if self.default_clocking_expr ~= "" then
-        parts[#parts + 1] = self.default_clocking_expr
-    end
-    for _, v in ipairs(self.sequence_vec) do
-        parts[#parts + 1] = tostring(v)
-    end
-    for _, v in ipairs(self.property_vec) do
-        parts[#parts + 1] = tostring(v)
+--- One error or warning returned by `lint_batch` / `lint_preload`.
+---@class (exact) verilua.sv.SVBuilder.lint_diag
+---@field file string Unit (or preload) name the diagnostic points into
+---@field line integer
+---@field column integer
+---@field severity "error" | "warning"
+---@field code string slang diagnostic code, e.g. "UndeclaredIdentifier"
+---@field message string
+
+-- Convert (and free) a `sv_lint_result`: one list of diagnostics per unit,
+-- nil for units without any.
+---@param lib any
+---@param res ffi.cdata*
+---@return table<integer, verilua.sv.SVBuilder.lint_diag[]>
+local function collect_lint_diags(lib, res)
+    local ret = {}
+    for i = 0, lib.sv_lint_result_count(res) - 1 do
+        local d = lib.sv_lint_result_get(res, i)
+        local unit = d.unit + 1
+        local diags = ret[unit]
+        if not diags then
+            diags = {}
+            ret[unit] = diags
+        end
+        diags[#diags + 1] = {
+            file = ffi.string(d.file),
+            line = d.line,
+            column = d.column,
+            severity = d.is_error ~= 0 and "error" or "warning",
+            code = ffi.string(d.code),
+            message = ffi.string(d.message),
+        }
     end
-    if not as_preamble then
-        parts[#parts + 1] = new_statement
+    lib.sv_lint_result_free(res)
+    return ret
+end
+
+---@param diags verilua.sv.SVBuilder.lint_diag[]
+---@return string
+local function format_lint_diags(diags)
+    local lines = {}
+    for i, d in ipairs(diags) do
+        lines[i] = f("%s:%d:%d: %s: %s [%s]", d.file, d.line, d.column, d.severity, d.message, d.code)
     end
-    parts[#parts + 1] = "endmodule"
-    local sv_text = table.concat(parts, "\n")
+    return table.concat(lines, "\n")
+end
 
+-- Lint one SV text through `lint_ctx` (the builder's preload context, if
+-- any), the shared library or the sv_lint binary, in that order. Returns nil
+-- on success (or when sv_lint is not available), or the diagnostic string on
+-- failure.
+---@param sv_text string
+---@param lint_ctx ffi.cdata*?
+---@return string?
+local function run_sv_lint_text(sv_text, lint_ctx)
     -- Try FFI first
     local lib = get_sv_lint_lib()
-    if lib then
+    if lib and lint_ctx then
+        local texts = ffi.new("const char*[1]", sv_text)
+        local res = lib.sv_lint_batch(texts, nil, 1, lint_ctx, 1)
+        assert(res ~= nil, "[SVBuilder] sv_lint_batch failed")
+        local diags = collect_lint_diags(lib, res)[1]
+        return diags and format_lint_diags(diags) or nil
+    elseif lib then
         local call_ok, rc = pcall(lib.sv_lint_text, sv_text, diag_buf, 4096)
         if call_ok then
             if rc == 0 then
@@ -292,6 +347,38 @@ local function run_sv_lint(self, new_statement, _stmt_name, as_preamble)
     return nil
 end
 
+-- Build a module shell containing all existing context + the new statement,
+-- then invoke sv_lint (FFI or subprocess). Returns nil on success, or the
+-- first diagnostic string on failure.
+-- `as_preamble`: when true (add "raw"), insert new_statement with other
+-- preamble chunks before default_clocking so bare clock decls resolve.
+---@param as_preamble boolean?
+local function run_sv_lint(self, new_statement, _stmt_name, as_preamble)
+    -- Assemble the full SV text for lint (match generate() order).
+    local parts = { "module __sva_lint;" }
+    for _, v in ipairs(self.preamble_vec) do
+        parts[#parts + 1] = tostring(v)
+    end
+    if as_preamble then
+        parts[#parts + 1] = new_statement
+    end
+    if self.default_clocking_expr ~= "" then
+        parts[#parts + 1] = self.default_clocking_expr
+    end
+    for _, v in ipairs(self.sequence_vec) do
+        parts[#parts + 1] = tostring(v)
+    end
+    for _, v in ipairs(self.property_vec) do
+        parts[#parts + 1] = tostring(v)
+    end
+    if not as_preamble then
+        parts[#parts + 1] = new_statement
+    end
+    parts[#parts + 1] = "endmodule"
+    local sv_text = table.concat(parts, "\n")
+    return run_sv_lint_text(sv_text, self.lint_ctx)
+end
+
 --- Enable or disable automatic sv_lint checking on each add() call.
 ---@param enable boolean
 ---@return verilua.sv.SVBuilder
@@ -300,6 +387,84 @@ function SVBuilder:set_lint(enable)
     return self
 end
 
+--- Register shared SV sources (packages, interfaces, headers defining
+--- macros) for every later lint, including the automatic `add` checks. The
+--- source is parsed once; later texts can import its packages and use its
+--- macros without `include. The sources are kept on this builder
+--- (`self.lint_ctx`). Raises an error if the source itself fails lint or
+--- libsv_lint is not available.
+---@param name string Name used in diagnostics
+---@param text string
+---@return verilua.sv.SVBuilder
+function SVBuilder:lint_preload(name, text)
+    local lib = get_sv_lint_lib()
+    assert(lib, "[SVBuilder] lint_preload requires libsv_lint, build it with `xmake build libsv_lint`")
+    if not self.lint_ctx then
+        local lint_ctx = lib.sv_lint_ctx_new()
+        assert(lint_ctx ~= nil, "[SVBuilder] lint_preload error: sv_lint_ctx_new failed")
+        self.lint_ctx = ffi.gc(lint_ctx, lib.sv_lint_ctx_free)
+    end
+    local res = lib.sv_lint_ctx_preload(self.lint_ctx, name, text)
+    assert(res ~= nil, f("[SVBuilder] lint_preload error: sv_lint_ctx_preload failed for '%s'", name))
+    local diags = collect_lint_diags(lib, res)[1]
+    if diags then
+        assert(false, f("[SVBuilder] lint error in preload '%s': %s", name, format_lint_diags(diags)))
+    end
+    return self
+end
+
+--- Drop every source registered by `lint_preload`, later lints (including
+--- the automatic `add` checks) no longer see them.
+---@return verilua.sv.SVBuilder
+function SVBuilder:lint_clear_preload()
+    self.lint_ctx = nil
+    return self
+end
+
+--- Lint many independent SV texts (e.g. generated modules) in one call on a
+--- thread pool, against the sources registered by `lint_preload`. Returns
+--- one entry per text: nil if it is clean, otherwise its diagnostics. Falls
+--- back to linting the texts one by one with the sv_lint binary (one
+--- diagnostic string per failed text, line/column 0) if libsv_lint is not
+--- available; every entry is nil if neither is.
+---@param texts string[]
+---@param params? { names?: string[], jobs?: integer } `names`: per-text names used in diagnostics (default "sv_lint_input"); `jobs`: worker threads (default: one per hardware thread)
+---@return table<integer, verilua.sv.SVBuilder.lint_diag[]>
+function SVBuilder:lint_batch(texts, params)
+    assert(type(texts) == "table", "[SVBuilder] lint_batch error: `texts` should be a table")
+    params = params or {}
+    local names = params.names
+    local n = #texts
+
+    local lib = get_sv_lint_lib()
+    if lib then
+        local c_texts = ffi.new("const char*[?]", n, texts)
+        local c_names = names and ffi.new("const char*[?]", n, names) or nil
+        -- `texts` / `names` keep the strings alive during the call
+        local res = lib.sv_lint_batch(c_texts, c_names, n, self.lint_ctx, params.jobs or 0)
+        assert(res ~= nil, "[SVBuilder] lint_batch error: sv_lint_batch failed")
+        return collect_lint_diags(lib, res)
+    end
+
+    local ret = {}
+    for i = 1, n do
+        local diag = run_sv_lint_text(texts[i], self.lint_ctx)
+        if diag then
+            ret[i] = {
+                {
+                    file = names and names[i] or "sv_lint_input",
+                    line = 0,
+                    column = 0,
+                    severity = "error",
+                    code = "",
+                    message = diag,
+                },
+            }
+        end
+    end
+    return ret
+end
+
 --- Enable or disable the final-block coverage report for covergroups.
 ---@param enable boolean
 ---@return verilua.sv.SVBuilder
@@ -6,6 +6,7 @@ local math = require "math"
 local class = require "pl.class"
 local table_new = require "table.new"
 local string_buffer = require "string.buffer"
+local StrBitsNative = require "verilua.utils.StrBitsNative"
 
 local type = type
 local print = print
@@ -19,12 +20,30 @@ local bit_rshift = bit.rshift
 local bit_lshift = bit.lshift
 local math_floor = math.floor
 local math_max = math.max
-local string_rep = string.rep
-local string_sub = string.sub
+local math_min = math.min
+local string_byte = string.byte
+local ffi_new = ffi.new
+local ffi_cast = ffi.cast
+local ffi_copy = ffi.copy
+local ffi_fill = ffi.fill
+local ffi_istype = ffi.istype
 local setmetatable = setmetatable
 
+local str_bits = StrBitsNative.lib
+local u32_ptr_t = ffi.typeof("uint32_t *")
+
 -- Lookup tables for to_hex_str optimization
-local hex_digits = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "a", "b", "c", "d", "e", "f" }
+local hex_bytes = {}  -- nibble value => ASCII code of its lower case hex digit
+local hex_values = {} -- ASCII code => nibble value, -1 for non hex digits
+for i = 0, 255 do
+    hex_values[i] = -1
+end
+for i = 0, 15 do
+    local c = string_byte("0123456789abcdef", i + 1)
+    hex_bytes[i] = c
+    hex_values[c] = i
+    hex_values[string_byte("0123456789ABCDEF", i + 1)] = i
+end
 local nibble_masks = { 0x1, 0x3, 0x7 } -- valid_bits: 1, 2, 3
 
 ---@class (exact) verilua.utils.SubBitVec
@@ -48,12 +67,14 @@ local nibble_masks = { 0x1, 0x3, 0x7 } -- valid_bits: 1, 2, 3
 ---@field private to_hex_str_buffer string.buffer
 ---@field __type string
 ---@field _call_cache table<string, verilua.utils.SubBitVec>
----@field u32_vec table<integer, integer>
+---@field limbs ffi.cdata* `uint64_t[nr_limbs]`, the storage of the value (limb 0 holds bits 0..63)
+---@field nr_limbs integer
+---@field u32_vec ffi.cdata* 1-based `uint32_t *` view of `limbs`, valid as long as the BitVec is alive
 ---@field nr_u32_vec integer
 ---@field bit_width integer
 ---@field beat_size integer
 ---@field hex_str_len integer
----@field _update_u32_vec fun(self: verilua.utils.BitVec, data: integer|integer[])
+---@field _update_u32_vec fun(self: verilua.utils.BitVec, data: integer|integer[]|ffi.cdata*)
 ---@field update_value fun(self: verilua.utils.BitVec, data: integer[]|integer|uint64_t|verilua.utils.BitVec.HexStr)
 ---@field get_bitfield fun(self: verilua.utils.BitVec, s: integer, e: integer): uint64_t
 ---@field get_bitfield_hex_str fun(self: verilua.utils.BitVec, s: integer, e: integer): string
@@ -74,42 +95,88 @@ local BitVec = class()
 ---@class (exact) verilua.utils.BitVecInst: verilua.utils.BitVec
 ---@overload fun(s: integer, e: integer): verilua.utils.SubBitVec
 
-local function hex_str_to_u32_vec(hex_str)
-    local hex_length = #hex_str
-    local full_beats = math_floor(hex_length / 8)
-    local u32_vec = table_new(full_beats, 0)
+local function get_hex_str_len(bit_width)
+    return math_floor((bit_width + 3) / 4)
+end
+
+local function get_beat_size(bit_width)
+    return math_floor((bit_width + 31) / 32)
+end
+
+local function get_nr_limbs(bit_width)
+    return math_max(1, math_floor((bit_width + 63) / 64))
+end
+
+-- Scratch limbs shared by every BitVec for the hex string bitfield accessors, grown on demand
+local scratch_cap = 0
+local scratch ---@type ffi.cdata*
 
-    for i = 0, full_beats - 1 do
-        local start_index = hex_length - (i + 1) * 8 + 1
-        -- local hex_part = hex_str:sub(start_index, start_index + 7)
-        u32_vec[i + 1] = tonumber(hex_str:sub(start_index, start_index + 7), 16)
+local function reserve_scratch(nlimbs)
+    if nlimbs > scratch_cap then
+        scratch_cap = math_max(nlimbs, scratch_cap * 2, 4)
+        scratch = ffi_new("uint64_t[?]", scratch_cap)
     end
+    return scratch
+end
 
-    local remaining_chars = hex_length % 8
-    if remaining_chars > 0 then
-        -- local start_index = 1
-        -- local hex_part = hex_str:sub(start_index, remaining_chars)
-        u32_vec[full_beats + 1] = tonumber(hex_str:sub(1, remaining_chars), 16)
+--- Parse `hex_str` (MSB first) into `nlimbs` limbs of `buf`, zero extended.
+local function parse_hex(hex_str, buf, nlimbs)
+    local len = #hex_str
+
+    if str_bits then
+        if str_bits.str_bits_parse_hex(hex_str, len, buf, nlimbs) ~= 0 then
+            assert(false, "[BitVec] Invalid hex string: " .. hex_str)
+        end
+        return
     end
 
-    return u32_vec
-end
+    ffi_fill(buf, nlimbs * 8)
+    local words = ffi_cast(u32_ptr_t, buf)
+    local nr_words = nlimbs * 2
+    for k = 0, len - 1 do
+        -- k-th nibble counted from the LSB
+        local d = hex_values[string_byte(hex_str, len - k)]
+        if d < 0 then
+            assert(false, "[BitVec] Invalid hex string: " .. hex_str)
+        end
 
-local function get_hex_str_len(bit_width)
-    return math_floor((bit_width + 3) / 4)
+        local w = bit_rshift(k, 3)
+        if w < nr_words then
+            words[w] = bit_bor(words[w], bit_lshift(d, bit_band(k, 7) * 4))
+        end
+    end
 end
 
-local function get_beat_size(bit_width)
-    return math_floor((bit_width + 31) / 32)
+--- Write the low `nchars` nibbles of `buf` (`nlimbs` limbs) to `p` as lower case hex, MSB first.
+local function format_hex(buf, nlimbs, nchars, p)
+    if str_bits then
+        str_bits.str_bits_format_hex(buf, nlimbs, nchars, p)
+        return
+    end
+
+    local words = ffi_cast(u32_ptr_t, buf)
+    local nr_words = nlimbs * 2
+    for i = 0, nchars - 1 do
+        local k = nchars - 1 - i
+        local w = bit_rshift(k, 3)
+        local d = 0
+        if w < nr_words then
+            d = bit_band(bit_rshift(words[w], bit_band(k, 7) * 4), 0xF)
+        end
+        p[i] = hex_bytes[d]
+    end
 end
 
 --
 -- Little Endian:
---  u32_vec: LSB {u32_0, u32_1, u32_2, u32_3, ...} MSB
+--  limbs:   LSB {u64_0, u64_1, ...} MSB
+--  u32_vec: LSB {u32_0, u32_1, u32_2, u32_3, ...} MSB (u32_vec[1] is the low half of limbs[0])
+--
+-- The value lives in a single `uint64_t[]` sized from bit_width when the BitVec is created,
+-- every update afterwards is done in place.
 --
 function BitVec:_init(data, bit_width)
     local typ = type(data)
-    local auto_bit_width
 
     self.__type = "BitVec"
     -- Cache for SubBitVec instances created via __call(s, e)
@@ -119,217 +186,126 @@ function BitVec:_init(data, bit_width)
     -- 3. Repeated calls with the same (s, e) will reuse cached SubBitVec instances
     self._call_cache = {}
 
-    if typ == "table" then
-        auto_bit_width = #data * 32
-        if bit_width then
-            local data_len = #data
-            local beat_size = math_floor(math_floor(bit_width + 31) / 32)
-            self.u32_vec = table_new(beat_size, 0)
-
-            for i = 1, data_len do
-                self.u32_vec[i] = data[i]
-            end
-
-            for i = data_len + 1, beat_size do
-                self.u32_vec[i] = 0
-            end
-
-            if data_len > beat_size then
-                assert(false, "Input u32_vec length: " .. data_len .. " must not exceed " .. beat_size)
-            end
-
-            self.bit_width = bit_width
+    local is_u64 = typ == "cdata" and ffi_istype("uint64_t", data)
+
+    if not bit_width then
+        if typ == "table" then
+            bit_width = #data * 32
+        elseif is_u64 then
+            bit_width = 64
+        elseif typ == "cdata" then
+            bit_width = tonumber(data[0]) * 32
+        elseif typ == "number" then
+            bit_width = 32
+        elseif typ == "string" then
+            bit_width = #data * 4
         else
-            self.u32_vec = data
-            self.bit_width = auto_bit_width
+            assert(false, "Unsupported type: " .. typ)
         end
-    elseif typ == "cdata" then
-        if ffi.istype("uint64_t", data) then
-            auto_bit_width = 64
-            if bit_width then
-                local beat_size = get_beat_size(bit_width)
-                self.u32_vec = table_new(beat_size, 0) --[[@as table<integer, integer>]]
-
-                self.u32_vec[1] = tonumber(bit_band(data, 0x00000000FFFFFFFFULL))
-                if beat_size > 1 then
-                    self.u32_vec[2] = tonumber(bit_rshift(data, 32))
-                    for i = 3, beat_size do
-                        self.u32_vec[i] = 0
-                    end
-                end
-
-                self.bit_width = bit_width
-            else
-                self.u32_vec = table_new(2, 0) --[[@as table<integer, integer>]]
-                self.u32_vec[1] = tonumber(bit_band(data, 0x00000000FFFFFFFFULL))
-                self.u32_vec[2] = tonumber(bit_rshift(data, 32))
-                self.bit_width = auto_bit_width
-            end
-
-            self.beat_size = get_beat_size(self.bit_width)
-            if self.beat_size == 1 then
-                self._update_u32_vec = function(t, data1)
-                    ---@cast data1 integer
-                    t.u32_vec[1] = data1
-                end
-            elseif self.beat_size > 1 then
-                self._update_u32_vec = function(t, data1)
-                    for i = 1, t.beat_size do
-                        t.u32_vec[i] = data1[i]
-                    end
-                end
-            end
-
-            self.nr_u32_vec = #self.u32_vec
-            self.to_hex_str_buffer = string_buffer.new()
-            self.hex_str_len = get_hex_str_len(self.bit_width)
-
-            self:_mask_unused_high_bits()
+    end
 
-            self.tonumber = function(this)
-                return tonumber(this.u32_vec[1]) --[[@as integer]]
-            end
+    local nr_limbs = get_nr_limbs(bit_width)
+    self.bit_width = bit_width
+    self.beat_size = get_beat_size(bit_width)
+    self.nr_u32_vec = self.beat_size
+    self.hex_str_len = get_hex_str_len(bit_width)
+    self.nr_limbs = nr_limbs
+    self.limbs = ffi_new("uint64_t[?]", nr_limbs)
+    self.u32_vec = ffi_cast(u32_ptr_t, self.limbs) - 1
+    self.to_hex_str_buffer = string_buffer.new()
 
-            if self.beat_size > 1 then
-                self.tonumber64 = function(this)
-                    return bit_lshift(this.u32_vec[2] + 0ULL, 32) + this.u32_vec[1]
-                end
-            else
-                self.tonumber64 = function(this)
-                    return this.u32_vec[1] + 0ULL
-                end
-            end
+    local u32_vec = self.u32_vec
+    local beat_size = self.beat_size
 
-            return
+    if typ == "table" then
+        local data_len = #data
+        if data_len > beat_size then
+            assert(false, "Input u32_vec length: " .. data_len .. " must not exceed " .. beat_size)
         end
 
+        for i = 1, data_len do
+            u32_vec[i] = data[i]
+        end
+    elseif is_u64 then
+        self.limbs[0] = data
+    elseif typ == "cdata" then
         local data_len = tonumber(data[0]) --[[@as integer]]
-        auto_bit_width = data_len * 32
-
-        if bit_width then
-            local beat_size = get_beat_size(bit_width)
-            self.u32_vec = table_new(beat_size, 0)
-
-            for i = 1, data_len do
-                self.u32_vec[i] = data[i]
-            end
-
-            for i = data_len + 1, beat_size do
-                self.u32_vec[i] = 0
-            end
-
-            if data_len > beat_size then
-                assert(false, "Input u32_vec length: " .. data_len .. " must not exceed " .. beat_size)
-            end
+        if data_len > beat_size then
+            assert(false, "Input u32_vec length: " .. data_len .. " must not exceed " .. beat_size)
+        end
 
-            self.bit_width = bit_width
-        else
-            self.u32_vec = table_new(tonumber(data[0]) --[[@as integer]], 0)
-            for i = 1, data_len do
-                self.u32_vec[i] = data[i]
-            end
-            self.bit_width = auto_bit_width
+        for i = 1, data_len do
+            u32_vec[i] = data[i]
         end
     elseif typ == "number" then
         ---@cast data integer
-        auto_bit_width = 32
-        if bit_width then
-            local beat_size = get_beat_size(bit_width)
-
-            self.u32_vec = table_new(beat_size, 0) --[[@as table<integer, integer>]]
-            self.u32_vec[1] = data
-            for i = 2, beat_size do
-                self.u32_vec[i] = 0
-            end
-
-            self.bit_width = bit_width
-        else
-            self.u32_vec = { data }
-            self.bit_width = auto_bit_width
-        end
+        u32_vec[1] = data
     elseif typ == "string" then
-        auto_bit_width = #data * 4
-        if bit_width then
-            local hex_str = data
-            local hex_str_len = get_hex_str_len(bit_width)
-
-            if #hex_str > hex_str_len then
-                assert(false, "Input hex_str length: " .. #hex_str .. " must not exceed " .. hex_str_len)
-            end
-
-            if hex_str_len > #hex_str then
-                hex_str = string_rep("0", hex_str_len - #hex_str) .. hex_str
-            end
-
-            self.u32_vec = hex_str_to_u32_vec(hex_str)
-            self.bit_width = bit_width
-        else
-            self.u32_vec = hex_str_to_u32_vec(data)
-            self.bit_width = auto_bit_width
+        local hex_str_len = self.hex_str_len
+        if #data > hex_str_len then
+            assert(false, "Input hex_str length: " .. #data .. " must not exceed " .. hex_str_len)
         end
+
+        parse_hex(data, self.limbs, nr_limbs)
     else
         assert(false, "Unsupported type: " .. typ)
     end
 
-    self.nr_u32_vec = #self.u32_vec
-    self.to_hex_str_buffer = string_buffer.new()
-    self.hex_str_len = get_hex_str_len(self.bit_width)
+    self:_mask_unused_high_bits()
+end
 
-    self.beat_size = get_beat_size(self.bit_width)
-    if self.beat_size == 1 then
-        self._update_u32_vec = function(t, data1)
-            ---@cast data1 integer
-            t.u32_vec[1] = data1
-        end
-    elseif self.beat_size > 1 then
-        self._update_u32_vec = function(t, data1)
-            for i = 1, t.beat_size do
-                t.u32_vec[i] = data1[i]
-            end
-        end
+--- Ensure unused high bits above `bit_width` are always zero.
+--- This keeps bit-precise semantics consistent for all constructors and updates.
+function BitVec:_mask_unused_high_bits()
+    local limbs = self.limbs
+    local top = math_floor(self.bit_width / 64)
+    local valid_bits_in_top = self.bit_width % 64
+
+    if valid_bits_in_top ~= 0 then
+        limbs[top] = bit_band(limbs[top], bit_lshift(1ULL, valid_bits_in_top) - 1)
+        top = top + 1
     end
 
-    self.tonumber = function(this)
-        return tonumber(this.u32_vec[1]) --[[@as integer]]
+    for i = top, self.nr_limbs - 1 do
+        limbs[i] = 0ULL
     end
+end
 
-    if self.beat_size > 1 then
-        self.tonumber64 = function(this)
-            return bit_lshift(this.u32_vec[2] + 0ULL, 32) + this.u32_vec[1]
+--- Fast path of the Chdl `get_bitvec()`: copy a freshly read value into place.
+--- `data` is the value of a single beat signal (number), or a `vpiml_get_value_multi`
+--- result (`uint32_t[]` with the beat count at index 0 and the beats from index 1).
+function BitVec:_update_u32_vec(data)
+    local beat_size = self.beat_size
+    if beat_size == 1 then
+        ---@cast data integer
+        self.u32_vec[1] = data
+    elseif beat_size <= 8 or type(data) == "table" then
+        local u32_vec = self.u32_vec
+        for i = 1, beat_size do
+            u32_vec[i] = data[i]
         end
     else
-        self.tonumber64 = function(this)
-            return this.u32_vec[1] + 0ULL
-        end
+        -- Wide values: a single memcpy of the beats, `data` is a `uint32_t[]`
+        ffi_copy(self.limbs, data + 1, beat_size * 4)
     end
-
-    self:_mask_unused_high_bits()
 end
 
---- Ensure unused high bits above `bit_width` are always zero.
---- This keeps bit-precise semantics consistent for all constructors and updates.
-function BitVec:_mask_unused_high_bits()
-    local beat_size = self.beat_size or #self.u32_vec
-    if beat_size <= 0 then
-        return
-    end
-
-    local valid_bits_in_top = self.bit_width % 32
-    if valid_bits_in_top == 0 then
-        return
-    end
+function BitVec:tonumber()
+    return self.u32_vec[1] --[[@as integer]]
+end
 
-    local top_index = beat_size
-    local mask = bit_lshift(1ULL, valid_bits_in_top) - 1
-    self.u32_vec[top_index] = tonumber(bit_band((self.u32_vec[top_index] or 0) + 0ULL, mask))
+function BitVec:tonumber64()
+    return self.limbs[0]
 end
 
 function BitVec:update_value(data)
     local typ = type(data)
+    local limbs = self.limbs
+    local u32_vec = self.u32_vec
 
     if typ == "table" then
         local data_len = #data
-        local beat_size = #self.u32_vec
+        local beat_size = self.nr_u32_vec
 
         local t = type(data[1])
         if t ~= "number" then
@@ -340,102 +316,55 @@ function BitVec:update_value(data)
             assert(false, "Input u32_vec length: " .. data_len .. " must not exceed " .. beat_size)
         end
 
+        ffi_fill(limbs, self.nr_limbs * 8)
         for i = 1, data_len do
-            self.u32_vec[i] = data[i]
-        end
-
-        for i = data_len + 1, beat_size do
-            self.u32_vec[i] = 0
+            u32_vec[i] = data[i]
         end
     elseif typ == "cdata" then
-        if ffi.istype("uint64_t", data) then
-            ---@cast data integer
-            local beat_size = #self.u32_vec
-
-            self.u32_vec[1] = tonumber(bit_band(data, 0x00000000FFFFFFFFULL))
-
-            if beat_size > 1 then
-                self.u32_vec[2] = tonumber(bit_rshift(data, 32))
-
-                for i = 3, beat_size do
-                    self.u32_vec[i] = 0
-                end
-            end
+        if ffi_istype("uint64_t", data) then
+            ffi_fill(limbs, self.nr_limbs * 8)
+            limbs[0] = data
         else
             assert(false, "Unsupported type: " .. typ .. ", cdata must be uint64_t")
         end
     elseif typ == "number" then
-        local beat_size = #self.u32_vec
-
-        self.u32_vec[1] = data
-
-        for i = 2, beat_size do
-            self.u32_vec[i] = 0
-        end
+        ffi_fill(limbs, self.nr_limbs * 8)
+        u32_vec[1] = data
     elseif typ == "string" then
-        local hex_str = data
-        local hex_str_len = get_hex_str_len(self.bit_width)
-
-        if #hex_str > hex_str_len then
-            assert(false, "Input hex_str length: " .. #hex_str .. " must not exceed " .. hex_str_len)
-        end
-
-        if hex_str_len > #hex_str then
-            hex_str = string_rep("0", hex_str_len - #hex_str) .. hex_str
+        local hex_str_len = self.hex_str_len
+        if #data > hex_str_len then
+            assert(false, "Input hex_str length: " .. #data .. " must not exceed " .. hex_str_len)
         end
 
-        self.u32_vec = hex_str_to_u32_vec(hex_str)
+        parse_hex(data, limbs, self.nr_limbs)
     else
         assert(false, "Unsupported type: " .. typ)
     end
 
     self:_mask_unused_high_bits()
-    self.nr_u32_vec = #self.u32_vec
 end
 
 function BitVec:get_bitfield(s, e)
     assert((e - s) <= 63, "Bitfield size must not exceed 64 bits")
 
-    local start_beat_id = math_floor(s / 32) + 1
-    local end_beat_id = math_floor(e / 32) + 1
-
-    local start_bit = s % 32
-    local end_bit = e % 32
-
-    local u32_vec = self.u32_vec
-    local value = 0ULL
-    local mask = 0ULL
-
-    for i = start_beat_id, end_beat_id do
-        local u32 = u32_vec[i] or 0
-
-        if i == start_beat_id then
-            if start_beat_id == end_beat_id then
-                -- mask = 0xFFFFFFFFULL >> (31 - end_bit)
-                -- value = (u32 & mask) >> start_bit
+    local limbs = self.limbs
+    local nr_limbs = self.nr_limbs
+    local idx = math_floor(s / 64)
+    local off = s % 64
+    local width = e - s + 1
 
-                mask = bit_rshift(0xFFFFFFFFULL, 31 - end_bit)
-                value = bit_rshift(bit_band(u32, mask), start_bit)
-            else
-                -- mask = 0xFFFFFFFFULL >> start_bit
-                -- value = (((u32 + 0ULL) >> start_bit) & mask) | value
+    if idx >= nr_limbs then
+        return 0ULL
+    end
 
-                mask = bit_rshift(0xFFFFFFFFULL, start_bit)
-                value = bit_bor(value, bit_band(bit_rshift(u32 + 0ULL, start_bit), mask))
-            end
-        elseif i == end_beat_id then
-            -- mask = (1ULL << (end_bit + 1)) - 1
-            -- mask = mask & 0xFFFFFFFFULL
-            -- value = (((u32 + 0ULL) & mask) << ((i - 1) * 32 - s)) | value
-
-            mask = bit_lshift(1ULL, end_bit + 1) - 1
-            mask = bit_band(mask, 0xFFFFFFFFULL)
-            value = bit_bor(value, bit_lshift(bit_band(u32 + 0ULL, mask), (i - 1) * 32 - s))
-        else
-            -- value = ((u32 + 0ULL) << ((i - 1) * 32 - s)) | value
+    -- value = (limbs[idx] >> off) | (limbs[idx + 1] << (64 - off))
+    local value = bit_rshift(limbs[idx], off)
+    if off + width > 64 and idx + 1 < nr_limbs then
+        value = bit_bor(value, bit_lshift(limbs[idx + 1], 64 - off))
+    end
 
-            value = bit_bor(value, bit_lshift(u32 + 0ULL, ((i - 1) * 32 - s)))
-        end
+    if width < 64 then
+        value = bit_band(value, bit_lshift(1ULL, width) - 1)
     end
 
     return value --[[@as uint64_t]]
@@ -443,22 +372,25 @@ end
 
 function BitVec:get_bitfield_hex_str(s, e)
     local beat_size = math_floor((e - s) / 32) + 1
+    local nchars = beat_size * 8
 
-    local result = ""
     if beat_size == 1 then
-        result = bit_tohex(tonumber(self:get_bitfield(s, e)) --[[@as integer]])
-    else
-        local ss = s
-        local ee = s + 31
-        for _i = 1, beat_size - 1 do
-            result = bit_tohex(tonumber(self:get_bitfield(ss, ee)) --[[@as integer]]) .. result
-            ss = ee + 1
-            ee = ee + 32
-        end
-        result = bit_tohex(tonumber(self:get_bitfield(ss, e)) --[[@as integer]]) .. result
+        return bit_tohex(tonumber(self:get_bitfield(s, e)) --[[@as integer]])
     end
 
-    return result
+    -- Extract 64 bits at a time into the scratch limbs, then format them straight into the string buffer
+    local nlimbs = math_floor((beat_size + 1) / 2)
+    local buf = reserve_scratch(nlimbs)
+    local ss = s
+    for i = 0, nlimbs - 1 do
+        buf[i] = self:get_bitfield(ss, math_min(e, ss + 63))
+        ss = ss + 64
+    end
+
+    local buffer = self.to_hex_str_buffer
+    format_hex(buf, nlimbs, nchars, (buffer:reserve(nchars)))
+    buffer:commit(nchars)
+    return buffer:get()
 end
 
 function BitVec:get_bitfield_vec(s, e)
@@ -484,66 +416,52 @@ end
 function BitVec:set_bitfield(s, e, v)
     assert((e - s) <= 63, "Bitfield size must not exceed 64 bits")
 
-    local start_beat_id = math_floor(s / 32) + 1
-    local end_beat_id = math_floor(e / 32) + 1
-
-    local start_bit = s % 32
-    local end_bit = e % 32
+    local limbs = self.limbs
+    local nr_limbs = self.nr_limbs
+    local idx = math_floor(s / 64)
+    local off = s % 64
+    local width = e - s + 1
 
-    local u32_vec = self.u32_vec
-    local mask = 0ULL
-    local vmask = 0ULL
-    local masked_v = 0ULL
-
-    for i = start_beat_id, end_beat_id do
-        local u32 = u32_vec[i] or 0
-
-        if i == start_beat_id then
-            if start_beat_id == end_beat_id then
-                -- mask = ~(((1ULL << (end_bit - start_bit + 1)) - 1) << start_bit)
-                -- vmask = (1ULL << (end_bit - start_bit + 1)) - 1
-                -- masked_v = (v + 0ULL) & vmask
-                -- u32 = (u32 & mask) | (masked_v << start_bit)
-
-                mask = bit_bnot(bit_lshift(bit_lshift(1ULL, end_bit - start_bit + 1) - 1, start_bit))
-                vmask = bit_lshift(1ULL, end_bit - start_bit + 1) - 1
-                masked_v = bit_band((v + 0ULL) --[[@as integer]], vmask)
-                u32 = bit_bor(bit_band(u32, mask), bit_lshift(masked_v, start_bit))
-            else
-                -- mask = ~(((1ULL << (31 - start_bit)) - 1) << start_bit)
-                -- vmask = (1ULL << (32 - start_bit)) - 1
-                -- masked_v = (v + 0ULL) & vmask
-                -- u32 = (u32 & mask) | (masked_v << start_bit)
-
-                mask = bit_bnot(bit_lshift(bit_lshift(1ULL, 31 - start_bit) - 1, start_bit))
-                vmask = bit_lshift(1ULL, 32 - start_bit) - 1
-                masked_v = bit_band((v + 0ULL) --[[@as integer]], vmask)
-                u32 = bit_bor(bit_band(u32, mask), bit_lshift(masked_v, start_bit))
-            end
-        elseif i == end_beat_id then
-            -- mask = ~((1ULL << (end_bit + 1)) - 1)
-            -- vmask = (1ULL << (end_bit + 1)) - 1
-            -- masked_v = ((v + 0ULL) >> ((i - 1) * 32 - s)) & vmask
-            -- u32 = (u32 & mask) | masked_v
-
-            mask = bit_bnot(bit_lshift(1ULL, end_bit + 1) - 1)
-            vmask = bit_lshift(1ULL, end_bit + 1) - 1
-            masked_v = bit_band(bit_rshift((v + 0ULL) --[[@as integer]], (i - 1) * 32 - s), vmask)
-            u32 = bit_bor(bit_band(u32, mask), masked_v)
-        else
-            -- masked_v = ((v + 0ULL) >> (32 - start_bit)) & 0xFFFFFFFFULL
-            -- u32 = (u32 & 0ULL) | masked_v
+    if idx >= nr_limbs then
+        return
+    end
 
-            masked_v = bit_band(bit_rshift((v + 0ULL) --[[@as integer]], 32 - start_bit), 0xFFFFFFFFULL)
-            u32 = bit_bor(bit_band(u32, 0ULL), masked_v)
-        end
+    -- vmask = (1ULL << width) - 1
+    -- limbs[idx] = (limbs[idx] & ~(vmask << off)) | ((v & vmask) << off)
+    local vmask = width < 64 and bit_lshift(1ULL, width) - 1 or 0xFFFFFFFFFFFFFFFFULL
+    local masked_v = bit_band((v + 0ULL) --[[@as integer]], vmask)
+    limbs[idx] = bit_bor(bit_band(limbs[idx], bit_bnot(bit_lshift(vmask, off))), bit_lshift(masked_v, off))
+
+    -- The field crosses into the next limb:
+    -- limbs[idx + 1] = (limbs[idx + 1] & ~((1ULL << rest) - 1)) | (v >> (64 - off))
+    local rest = off + width - 64
+    if rest > 0 and idx + 1 < nr_limbs then
+        local hmask = bit_lshift(1ULL, rest) - 1
+        limbs[idx + 1] = bit_bor(bit_band(limbs[idx + 1], bit_bnot(hmask)), bit_rshift(masked_v, 64 - off))
+    end
 
-        u32_vec[i] = tonumber(u32)
+    if e >= self.bit_width then
+        self:_mask_unused_high_bits()
     end
 end
 
 function BitVec:set_bitfield_hex_str(s, e, hex_str)
-    self:set_bitfield_vec(s, e, hex_str_to_u32_vec(hex_str))
+    local beat_size = math_floor((e - s) / 32) + 1
+    assert(beat_size == math_floor((#hex_str + 7) / 8))
+
+    -- Parse into the scratch limbs and insert them 64 bits at a time, no intermediate table
+    local nlimbs = math_floor((#hex_str + 15) / 16)
+    local buf = reserve_scratch(nlimbs)
+    parse_hex(hex_str, buf, nlimbs)
+
+    local ss = s
+    for i = 0, nlimbs - 1 do
+        if ss > e then
+            break
+        end
+        self:set_bitfield(ss, math_min(e, ss + 63), buf[i])
+        ss = ss + 64
+    end
 end
 
 function BitVec:set_bitfield_vec(s, e, u32_vec)
@@ -645,42 +563,44 @@ end
 ---@nodiscard Return value should not be discarded
 ---@return verilua.utils.BitVec.HexStr Hexadecimal string (MSB first)
 function BitVec:to_hex_str()
-    local hex_str = self:to_hex_str_1()
-    local hex_str_len = self.hex_str_len
-
-    if #hex_str > hex_str_len then
-        hex_str = string_sub(hex_str, #hex_str - hex_str_len + 1)
+    local nchars = self.hex_str_len
+    if nchars == 0 then
+        return ""
     end
 
+    -- Format the limbs straight into the string buffer, the only allocation is the result string
+    local buffer = self.to_hex_str_buffer
+    local p = buffer:reserve(nchars)
+    format_hex(self.limbs, self.nr_limbs, nchars, p)
+
     local valid_bits = self.bit_width % 4
-    if valid_bits ~= 0 and #hex_str > 0 then
-        -- Use lookup tables to avoid string.format and bit_lshift + tonumber overhead
-        local top_nibble = tonumber(string_sub(hex_str, 1, 1), 16) or 0
+    if valid_bits ~= 0 then
         ---@cast valid_bits 1|2|3
-        top_nibble = bit_band(top_nibble, nibble_masks[valid_bits])
-        hex_str = hex_digits[top_nibble + 1] .. string_sub(hex_str, 2)
+        p[0] = hex_bytes[bit_band(hex_values[p[0]], nibble_masks[valid_bits])]
     end
 
-    return hex_str
+    buffer:commit(nchars)
+    return buffer:get()
 end
 
 --- Converts BitVec to hexadecimal string without trimming to bit_width.
 --- Note: This always returns full 32-bit aligned hex (may include leading zeros).
 ---
 --- Performance note:
---- - to_hex_str_1 is faster than to_hex_str because it writes fixed-width 32-bit chunks
----   directly into the string buffer and returns the result as-is.
---- - to_hex_str performs extra work (trimming to bit_width, top-nibble masking and string
----   slicing), which adds branching, string operations and small allocations.
+--- - to_hex_str_1 skips the top-nibble masking of to_hex_str, both format the limbs
+---   directly into the string buffer.
 ---
 ---@nodiscard Return value should not be discarded
 ---@return verilua.utils.BitVec.HexStr Hexadecimal string (MSB first, full 32-bit aligned)
 function BitVec:to_hex_str_1()
-    local buffer = self.to_hex_str_buffer
-    local nr_u32_vec = self.nr_u32_vec or #self.u32_vec
-    for i = nr_u32_vec, 1, -1 do
-        buffer:putf("%08x", self.u32_vec[i])
+    local nchars = self.nr_u32_vec * 8
+    if nchars == 0 then
+        return ""
     end
+
+    local buffer = self.to_hex_str_buffer
+    format_hex(self.limbs, self.nr_limbs, nchars, (buffer:reserve(nchars)))
+    buffer:commit(nchars)
     return buffer:get()
 end
 
@@ -689,10 +609,11 @@ function BitVec:__concat(other)
 end
 
 function BitVec:__eq(other)
-    local max_len = math_max(#self.u32_vec, #other.u32_vec)
-    for i = 1, max_len do
-        local self_val = self.u32_vec[i] or 0
-        local other_val = other.u32_vec[i] or 0
+    local self_vec, other_vec = self.u32_vec, other.u32_vec
+    local self_len, other_len = self.nr_u32_vec, other.nr_u32_vec
+    for i = 1, math_max(self_len, other_len) do
+        local self_val = i <= self_len and self_vec[i] or 0
+        local other_val = i <= other_len and other_vec[i] or 0
         if self_val ~= other_val then
             return false
         end
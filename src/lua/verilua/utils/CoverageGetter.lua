@@ -27,6 +27,12 @@ local getCondCoverage
 local resetCoverage
 local showCoverageCount
 
+--- `getToggleBitmap` and `getToggleCounters` only exist when `cov_exporter` runs with `--packed-toggle`,
+--- so they are resolved lazily on first use.
+local getToggleBitmap
+local getToggleCounters
+local resolve_packed_toggle_funcs
+
 if simulator == "verilator" then
     --- In `Verilator`, we can't get DPI functions directly by `ffi.cdef` and `ffi.C`, so we use
     --- `SymbolHelper` to get them as a workaround.
@@ -43,6 +49,12 @@ if simulator == "verilator" then
     getCondCoverage = SymbolHelper.ffi_cast("void (*)(double *)", "getCondCoverage");
     resetCoverage = SymbolHelper.ffi_cast("void (*)(void)", "resetCoverage");
     showCoverageCount = SymbolHelper.ffi_cast("void (*)(void)", "showCoverageCount");
+
+    --- Make sure `-LDFLAGS "-u getToggleBitmap -u getToggleCounters"` is added as well.
+    resolve_packed_toggle_funcs = function()
+        getToggleBitmap = SymbolHelper.ffi_cast("void (*)(void *, int *)", "getToggleBitmap");
+        getToggleCounters = SymbolHelper.ffi_cast("void (*)(void *, int *)", "getToggleCounters");
+    end
 elseif simulator == "vcs" or simulator == "xcelium" then
     ffi.cdef [[
         void *svGetScopeFromName(const char *str);
@@ -53,6 +65,8 @@ elseif simulator == "vcs" or simulator == "xcelium" then
         void getCondCoverage(double *value);
         void resetCoverage(void);
         void showCoverageCount(void);
+        void getToggleBitmap(void *dst, int *nbits);
+        void getToggleCounters(void *dst, int *ncounters);
     ]]
     svSetScope = C.svSetScope
     svGetScopeFromName = C.svGetScopeFromName
@@ -62,6 +76,10 @@ elseif simulator == "vcs" or simulator == "xcelium" then
     getCondCoverage = C.getCondCoverage
     resetCoverage = C.resetCoverage
     showCoverageCount = C.showCoverageCount
+    resolve_packed_toggle_funcs = function()
+        getToggleBitmap = C.getToggleBitmap
+        getToggleCounters = C.getToggleCounters
+    end
 else
     assert(false, "[CoverageGetter] For now, only support `Verilator` and `VCS`")
 end
@@ -83,10 +101,26 @@ end
 ---@alias HierPath string
 ---@alias ModuleName string
 
+---@class (exact) PackedToggleInfo
+---@field signals string[] Signal name of each bitmap bit(bit i <-> signals[i + 1])
+---@field counterWidth integer Width of the saturating toggle counters, 0 if disabled
+
 ---@class (exact) ExportedModule
 ---@field hierPaths HierPath[]
 ---@field statistics {binExprCount: integer, netCount: integer, varCount: integer}
 ---@field subModules ModuleName[]
+---@field packedToggle PackedToggleInfo? Only available when `cov_exporter` runs with `--packed-toggle`
+
+---@class (exact) verilua.utils.ToggleBitmapEntry
+---@field hier HierPath
+---@field module_name ModuleName
+---@field offset integer Word offset of this instance inside `ToggleBitmapDump.words`
+---@field nbits integer Number of valid bits(toggle points) of this instance
+
+---@class (exact) verilua.utils.ToggleBitmapDump
+---@field words ffi.cdata* `uint32_t[total_words]`, bit i of an instance is `words[offset + i / 32] >> (i % 32) & 1`
+---@field total_words integer
+---@field entries verilua.utils.ToggleBitmapEntry[]
 
 ---@class (exact) verilua.utils.CovExporterMetaInfo
 ---@field exportedModules table<ModuleName, ExportedModule>
@@ -105,6 +139,10 @@ end
 ---@field private has_cov_meta_info boolean
 ---@field private cov_meta_info verilua.utils.CovExporterMetaInfo?
 ---@field private module_to_percent_cache table<ModuleName, table<ModuleName, number>>
+---@field private toggle_nbits ffi.cdata*
+---@field private toggle_bitmap_cache table<HierPath, ffi.cdata*>
+---@field private toggle_counters_cache table<HierPath, ffi.cdata*>
+---@field private toggle_bitmap_dump verilua.utils.ToggleBitmapDump?
 ---
 --- Read `cov_exporter.meta.json` which is generated by `cov_exporter`.
 --- Path: `outdir`/cov_exporter.meta.json where `outdir` is the output directory of `cov_exporter`.
@@ -123,10 +161,19 @@ end
 ---@field reset_coverage fun(self: verilua.utils.CoverageGetter, hier_or_module: string, recursive?: boolean)
 ---@field show_coverage_count fun(self: verilua.utils.CoverageGetter, hier_or_module: string)
 ---@field module_name_to_hiers fun(self: verilua.utils.CoverageGetter, module_name: string): string[]
+---
+--- Packed toggle coverage(`cov_exporter --packed-toggle`), read back with one DPI call per module instance.
+---@field get_toggle_bitmap fun(self: verilua.utils.CoverageGetter, hier: string): ffi.cdata*, integer
+---@field get_toggle_counters fun(self: verilua.utils.CoverageGetter, hier: string): ffi.cdata*, integer
+---@field dump_toggle_bitmaps fun(self: verilua.utils.CoverageGetter): verilua.utils.ToggleBitmapDump
+---@field get_packed_toggle_coverage fun(self: verilua.utils.CoverageGetter): number, integer, integer
 local CoverageGetter = {
     coverage_value = ffi.new("double[1]"),
     total_count = ffi.new("int[1]"),
     total_bin_expr_count = ffi.new("int[1]"),
+    toggle_nbits = ffi.new("int[1]"),
+    toggle_bitmap_cache = {},
+    toggle_counters_cache = {},
     has_cov_meta_info = false,
     cov_meta_info = nil,
     module_to_percent_cache = {},
@@ -603,4 +650,135 @@ function CoverageGetter:module_name_to_hiers(module_name)
     return hierPaths
 end
 
+---@param hier string Hierarchical path of the target module
+---@return ffi.cdata* words `uint32_t*` toggled-ever bitmap, bit i is signal i of `packedToggle.signals`
+---@return integer nbits Number of valid bits
+function CoverageGetter:get_toggle_bitmap(hier)
+    if not getToggleBitmap then
+        resolve_packed_toggle_funcs()
+    end
+
+    ---@cast getToggleBitmap fun(dst: ffi.cdata*, nbits: ffi.cdata*)
+
+    -- Query the size first(a null `dst` only reports `nbits`), then reuse the buffer.
+    self.setDpiScope(hier)
+    local words = self.toggle_bitmap_cache[hier]
+    if not words then
+        getToggleBitmap(nil, self.toggle_nbits)
+        ---@diagnostic disable-next-line: undefined-field
+        local nbits = tonumber(self.toggle_nbits[0]) --[[@as integer]]
+        words = ffi.new("uint32_t[?]", math.max(1, math.ceil(nbits / 32)))
+        self.toggle_bitmap_cache[hier] = words
+    end
+
+    getToggleBitmap(words, self.toggle_nbits)
+    ---@diagnostic disable-next-line: undefined-field
+    return words, tonumber(self.toggle_nbits[0]) --[[@as integer]]
+end
+
+---@param hier string Hierarchical path of the target module
+---@return ffi.cdata* counters `uint32_t*` saturating toggle counters, one per signal
+---@return integer ncounters Number of counters(0 if `--packed-counter-width` is not set)
+function CoverageGetter:get_toggle_counters(hier)
+    if not getToggleCounters then
+        resolve_packed_toggle_funcs()
+    end
+
+    ---@cast getToggleCounters fun(dst: ffi.cdata*, ncounters: ffi.cdata*)
+
+    self.setDpiScope(hier)
+    local counters = self.toggle_counters_cache[hier]
+    if not counters then
+        getToggleCounters(nil, self.toggle_nbits)
+        ---@diagnostic disable-next-line: undefined-field
+        local n = tonumber(self.toggle_nbits[0]) --[[@as integer]]
+        counters = ffi.new("uint32_t[?]", math.max(1, n))
+        self.toggle_counters_cache[hier] = counters
+    end
+
+    getToggleCounters(counters, self.toggle_nbits)
+    ---@diagnostic disable-next-line: undefined-field
+    return counters, tonumber(self.toggle_nbits[0]) --[[@as integer]]
+end
+
+--- Read the toggle bitmap of every instrumented module instance into one contiguous buffer.
+--- The layout(offsets) is computed once from the meta info and cached, each call only costs
+--- one `getToggleBitmap` DPI call per instance.
+---@return verilua.utils.ToggleBitmapDump
+function CoverageGetter:dump_toggle_bitmaps()
+    if not self.toggle_bitmap_dump then
+        if not self.cov_meta_info then
+            self:read_cov_meta_info()
+        end
+
+        ---@diagnostic disable-next-line: unknown-cast-variable
+        ---@cast self.cov_meta_info verilua.utils.CovExporterMetaInfo
+
+        local module_names = {}
+        for module_name, _ in pairs(self.cov_meta_info.exportedModules) do
+            module_names[#module_names + 1] = module_name
+        end
+        table.sort(module_names)
+
+        local entries = {}
+        local total_words = 0
+        for _, module_name in ipairs(module_names) do
+            local module_info = self.cov_meta_info.exportedModules[module_name]
+            local packed_toggle = module_info.packedToggle
+            assert(packed_toggle,
+                "[CoverageGetter] Module `" .. module_name .. "` is not instrumented with `cov_exporter --packed-toggle`")
+
+            local nbits = #packed_toggle.signals
+            for _, hier in ipairs(module_info.hierPaths) do
+                entries[#entries + 1] = { hier = hier, module_name = module_name, offset = total_words, nbits = nbits }
+                total_words = total_words + math.ceil(nbits / 32)
+            end
+        end
+
+        self.toggle_bitmap_dump = {
+            words = ffi.new("uint32_t[?]", math.max(1, total_words)),
+            total_words = total_words,
+            entries = entries,
+        }
+    end
+
+    if not getToggleBitmap then
+        resolve_packed_toggle_funcs()
+    end
+
+    local dump = self.toggle_bitmap_dump --[[@as verilua.utils.ToggleBitmapDump]]
+    for _, entry in ipairs(dump.entries) do
+        if entry.nbits > 0 then
+            self.setDpiScope(entry.hier)
+            getToggleBitmap(dump.words + entry.offset, self.toggle_nbits)
+        end
+    end
+
+    return dump
+end
+
+--- Toggle coverage of the whole instrumented design, computed from `dump_toggle_bitmaps`.
+---@return number coverage Coverage value(0.0 ~ 1.0)
+---@return integer covered Number of toggled signals
+---@return integer total Number of toggle points
+function CoverageGetter:get_packed_toggle_coverage()
+    local dump = self:dump_toggle_bitmaps()
+    local band = require("bit").band
+
+    local covered = 0
+    local total = 0
+    for i = 0, dump.total_words - 1 do
+        local w = dump.words[i]
+        while w ~= 0 do
+            w = band(w, w - 1)
+            covered = covered + 1
+        end
+    end
+    for _, entry in ipairs(dump.entries) do
+        total = total + entry.nbits
+    end
+
+    return total == 0 and 1.0 or covered / total, covered, total
+end
+
 return CoverageGetter
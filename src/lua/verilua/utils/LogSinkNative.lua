@@ -0,0 +1,126 @@
+local ffi = require "ffi"
+
+local f = string.format
+local ffi_string = ffi.string
+
+-- Native binary log sink behind `verilua.utils.Logger` (`src/log_sink`, built as liblog_sink.so).
+-- Keep in sync with `src/log_sink/log_sink.h`.
+pcall(ffi.cdef, [[
+    const char *log_sink_last_error(void);
+    int log_sink_open(const char *path, int format, size_t ring_bytes, size_t flight_bytes);
+    int log_sink_is_open(void);
+    uint32_t log_sink_intern(const char *str, size_t len);
+    void log_sink_begin(int level, uint32_t logger_id, uint32_t fmt_id);
+    void log_sink_arg_num(double v);
+    void log_sink_arg_int(int64_t v);
+    void log_sink_arg_uint(uint64_t v);
+    void log_sink_arg_str(const char *str, size_t len);
+    void log_sink_arg_strid(uint32_t id);
+    void log_sink_arg_bool(int v);
+    void log_sink_arg_nil(void);
+    void log_sink_end(void);
+    int log_sink_flush(void);
+    int log_sink_dump(void);
+    int log_sink_close(void);
+    uint64_t log_sink_dropped(void);
+]])
+
+--- Distinct strings interned through `M.intern`, later ones are passed by value.
+--- Interned strings live as long as the process.
+local MAX_INTERNED = 64 * 1024
+
+---@class (exact) verilua.utils.LogSinkNative
+---@field lib any? The loaded liblog_sink, nil if it is not available
+---@field DEBUG integer
+---@field INFO integer
+---@field SUCCESS integer
+---@field WARNING integer
+---@field ERROR integer
+---@field BINARY integer
+---@field TEXT integer
+---@field NO_FMT integer
+local M = {
+    lib = nil,
+
+    -- Levels, see `log_sink.h`
+    DEBUG = 0,
+    INFO = 1,
+    SUCCESS = 2,
+    WARNING = 3,
+    ERROR = 4,
+
+    -- Output formats
+    BINARY = 0,
+    TEXT = 1,
+
+    NO_FMT = 0xffffffff,
+}
+
+-- Try $VERILUA_HOME/shared/liblog_sink.so first, then the system LD_LIBRARY_PATH.
+-- `VL_LOG_SINK_NATIVE=0` behaves as if the library was not built.
+local function load_lib()
+    if os.getenv("VL_LOG_SINK_NATIVE") == "0" then
+        return nil
+    end
+
+    local verilua_home = os.getenv("VERILUA_HOME")
+    if verilua_home then
+        local ok, lib = pcall(ffi.load, verilua_home .. "/shared/liblog_sink.so")
+        if ok then
+            return lib
+        end
+    end
+
+    local ok, lib = pcall(ffi.load, "log_sink")
+    if ok then
+        return lib
+    end
+    return nil
+end
+
+M.lib = load_lib()
+
+--- The loaded library, raises an error naming `who` if it is not available.
+---@param who string
+---@return any
+function M.require_lib(who)
+    local lib = M.lib
+    assert(lib,
+        f("[%s] liblog_sink is not available, build it with `xmake build liblog_sink` (or unset VL_LOG_SINK_NATIVE=0)",
+            who))
+    return lib
+end
+
+--- Message of the last failed liblog_sink call.
+---@return string
+function M.last_error()
+    return ffi_string(M.lib.log_sink_last_error())
+end
+
+---@type table<string, integer>
+local interned = {}
+local nr_interned = 0
+
+--- Id of `str` in the sink string table (logger names, format strings), nil
+--- once `MAX_INTERNED` distinct strings have been interned.
+---@param str string
+---@return integer?
+function M.intern(str)
+    local id = interned[str]
+    if id then
+        return id
+    end
+    if nr_interned >= MAX_INTERNED then
+        return nil
+    end
+
+    id = M.lib.log_sink_intern(str, #str)
+    if id == M.NO_FMT then
+        return nil
+    end
+    interned[str] = id
+    nr_interned = nr_interned + 1
+    return id
+end
+
+return M
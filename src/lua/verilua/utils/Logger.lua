@@ -14,6 +14,9 @@
 --- - NO_COLOR or VL_NO_COLOR: Disable colors
 --- - VL_NO_ICONS: Disable Unicode icons
 --- - VL_NO_UNICODE: Disable Unicode box characters
+--- - VL_LOG_SINK: Send log messages to the native sink writing this file (see `Logger.set_sink`)
+--- - VL_LOG_SINK_TEXT=1: The sink writes text instead of binary records
+--- - VL_LOG_SINK_FLIGHT_MB: Flight recorder, keep the last N MB per thread and dump them on error / at finish
 ---
 --- Usage:
 --- ```lua
@@ -23,16 +26,22 @@
 ---     log:success("Operation completed!")
 ---     log:warning("This is a warning")
 ---     log:error("This is an error")
+---     log:debugf("addr=0x%x data=%d", addr, data) -- formatted like string.format
 --- ```
 
+local ffi = require "ffi"
 local os = require "os"
 local string = require "string"
 local table = require "table"
 local math = require "math"
 
+local type = type
+local tonumber = tonumber
+local select = select
 local tostring = tostring
 local setmetatable = setmetatable
 local ipairs = ipairs
+local pairs = pairs
 local f = string.format
 local rep = string.rep
 local concat = table.concat
@@ -222,11 +231,127 @@ local function noop() end
 ---@field success fun(self: verilua.utils.Logger, ...)
 ---@field warning fun(self: verilua.utils.Logger, ...)
 ---@field error fun(self: verilua.utils.Logger, ...)
+---@field debugf fun(self: verilua.utils.Logger, fmt: string, ...)
+---@field infof fun(self: verilua.utils.Logger, fmt: string, ...)
+---@field successf fun(self: verilua.utils.Logger, fmt: string, ...)
+---@field warningf fun(self: verilua.utils.Logger, fmt: string, ...)
+---@field errorf fun(self: verilua.utils.Logger, fmt: string, ...)
 ---@field new fun(logger_name: string?, config: verilua.utils.Logger.config?): verilua.utils.Logger
 ---@field set_logger_name fun(self: verilua.utils.Logger, name: string): verilua.utils.Logger
+---@field set_sink fun(params: verilua.utils.Logger.sink_params)
+---@field close_sink fun(): boolean
+---@field flush_sink fun(): boolean
+---@field dump_sink fun(): integer
 local Logger = {}
 Logger.__index = Logger
 
+--------------------------------------------------------------------------------
+-- Native sink (`verilua.utils.LogSinkNative`)
+--------------------------------------------------------------------------------
+
+---@class verilua.utils.Logger.sink_params
+---@field path string Output file
+---@field text boolean? Write text lines instead of binary records (decoded by `log_decode`)
+---@field flight_mb number? Flight recorder: keep the last `flight_mb` MB per thread, dump them on error / at finish
+---@field ring_kb integer? Ring size of every logging thread when streaming (default: 4096)
+
+---@type verilua.utils.LogSinkNative?
+local sink = nil
+local sink_flight = false
+local sink_path = ""
+
+-- Every live logger, their log functions are regenerated when the sink changes
+---@type table<verilua.utils.Logger, boolean>
+local loggers = setmetatable({}, { __mode = "k" })
+
+local istype = ffi.istype
+local int64_t = ffi.typeof("int64_t")
+local uint64_t = ffi.typeof("uint64_t")
+
+local function push_arg(lib, v)
+    local t = type(v)
+    if t == "number" then
+        lib.log_sink_arg_num(v)
+    elseif t == "string" then
+        lib.log_sink_arg_str(v, #v)
+    elseif t == "boolean" then
+        lib.log_sink_arg_bool(v and 1 or 0)
+    elseif t == "nil" then
+        lib.log_sink_arg_nil()
+    elseif t == "cdata" and istype(int64_t, v) then
+        lib.log_sink_arg_int(v)
+    elseif t == "cdata" and istype(uint64_t, v) then
+        lib.log_sink_arg_uint(v)
+    else
+        local str = tostring(v)
+        lib.log_sink_arg_str(str, #str)
+    end
+end
+
+local function on_sink_error()
+    if sink_flight and sink then
+        local n = sink.lib.log_sink_dump()
+        if n >= 0 then
+            print(f(">> [Logger] flight recorder: %d records dumped to `%s`", n, sink_path))
+        else
+            print(f(">> [Logger] flight recorder dump failed: %s", sink.last_error()))
+        end
+    end
+end
+
+--- Log function recording into the native sink: the logger name id, the
+--- format string id (`has_fmt`) and the raw arguments, no formatting on the
+--- calling thread. Errors are also printed through `console_func`.
+---@param self verilua.utils.Logger
+---@param sink_level integer
+---@param console_func function
+---@param has_fmt boolean
+---@return function
+local function make_sink_func(self, sink_level, console_func, has_fmt)
+    ---@cast sink -?
+    local lib = sink.lib
+    local intern = sink.intern
+    local NO_FMT = sink.NO_FMT
+    local logger_id = intern(self.logger_name) or NO_FMT
+    local is_error = sink_level == sink.ERROR
+
+    if has_fmt then
+        return function(this, fmt, ...)
+            local fmt_id = intern(fmt)
+            if fmt_id then
+                lib.log_sink_begin(sink_level, logger_id, fmt_id)
+                for i = 1, select("#", ...) do
+                    push_arg(lib, (select(i, ...)))
+                end
+            else
+                -- Out of string ids, format on this thread
+                local msg = f(fmt, ...)
+                lib.log_sink_begin(sink_level, logger_id, NO_FMT)
+                lib.log_sink_arg_str(msg, #msg)
+            end
+            lib.log_sink_end()
+
+            if is_error then
+                console_func(this, fmt, ...)
+                on_sink_error()
+            end
+        end
+    end
+
+    return function(this, ...)
+        lib.log_sink_begin(sink_level, logger_id, NO_FMT)
+        for i = 1, select("#", ...) do
+            push_arg(lib, (select(i, ...)))
+        end
+        lib.log_sink_end()
+
+        if is_error then
+            console_func(this, ...)
+            on_sink_error()
+        end
+    end
+end
+
 --- Create log function for a specific level
 ---@param self verilua.utils.Logger
 ---@param level integer
@@ -234,8 +359,10 @@ Logger.__index = Logger
 ---@param use_colors boolean
 ---@param color string
 ---@param icon_key string
+---@param sink_level integer Level in the native sink
+---@param has_fmt boolean The first argument is a `string.format` format string
 ---@return function
-local function make_log_func(self, level, min_level, use_colors, color, icon_key)
+local function make_log_func(self, level, min_level, use_colors, color, icon_key, sink_level, has_fmt)
     -- If level is below minimum, return no-op (zero runtime cost)
     if level < min_level then
         return noop
@@ -247,20 +374,57 @@ local function make_log_func(self, level, min_level, use_colors, color, icon_key
     local icon_str = icon ~= "" and (icon .. " ") or ""
 
     -- Return optimized log function
+    local console_func
     if use_colors then
         local arrow = FG_BRIGHT_BLACK .. ">>" .. RESET .. " "
-        return function(_, ...)
-            local args = { ... }
-            local msg = #args == 1 and tostring(args[1]) or concat(args, " ")
-            print(arrow .. prefix .. icon_str .. color .. msg .. RESET)
+        if has_fmt then
+            console_func = function(_, fmt, ...)
+                print(arrow .. prefix .. icon_str .. color .. f(fmt, ...) .. RESET)
+            end
+        else
+            console_func = function(_, ...)
+                local args = { ... }
+                local msg = #args == 1 and tostring(args[1]) or concat(args, " ")
+                print(arrow .. prefix .. icon_str .. color .. msg .. RESET)
+            end
         end
     else
-        return function(_, ...)
-            local args = { ... }
-            local msg = #args == 1 and tostring(args[1]) or concat(args, " ")
-            print(">> " .. prefix .. icon_str .. msg)
+        if has_fmt then
+            console_func = function(_, fmt, ...)
+                print(">> " .. prefix .. icon_str .. f(fmt, ...))
+            end
+        else
+            console_func = function(_, ...)
+                local args = { ... }
+                local msg = #args == 1 and tostring(args[1]) or concat(args, " ")
+                print(">> " .. prefix .. icon_str .. msg)
+            end
         end
     end
+
+    if sink then
+        return make_sink_func(self, sink_level, console_func, has_fmt)
+    end
+    return console_func
+end
+
+--- (Re)generate every log function of `self` for its prefix, config and the current sink
+---@param self verilua.utils.Logger
+---@param min_level integer
+---@param use_colors boolean
+local function gen_log_funcs(self, min_level, use_colors)
+    -- These functions have zero branching overhead for disabled levels
+    self.debug = make_log_func(self, 0, min_level, use_colors, FG_BRIGHT_BLACK, "DEBUG", 0, false)
+    self.info = make_log_func(self, 1, min_level, use_colors, FG_CYAN, "", 1, false)
+    self.success = make_log_func(self, 1, min_level, use_colors, FG_GREEN, "SUCCESS", 2, false)
+    self.warning = make_log_func(self, 2, min_level, use_colors, FG_YELLOW, "WARNING", 3, false)
+    self.error = make_log_func(self, 3, min_level, use_colors, FG_RED, "ERROR", 4, false)
+
+    self.debugf = make_log_func(self, 0, min_level, use_colors, FG_BRIGHT_BLACK, "DEBUG", 0, true)
+    self.infof = make_log_func(self, 1, min_level, use_colors, FG_CYAN, "", 1, true)
+    self.successf = make_log_func(self, 1, min_level, use_colors, FG_GREEN, "SUCCESS", 2, true)
+    self.warningf = make_log_func(self, 2, min_level, use_colors, FG_YELLOW, "WARNING", 3, true)
+    self.errorf = make_log_func(self, 3, min_level, use_colors, FG_RED, "ERROR", 4, true)
 end
 
 --- Create a new Logger instance with compile-time optimized methods
@@ -292,12 +456,8 @@ function Logger.new(logger_name, config)
     end
 
     -- Generate optimized log functions at creation time
-    -- These functions have zero branching overhead for disabled levels
-    self.debug = make_log_func(self, 0, min_level, use_colors, FG_BRIGHT_BLACK, "DEBUG")
-    self.info = make_log_func(self, 1, min_level, use_colors, FG_CYAN, "")
-    self.success = make_log_func(self, 1, min_level, use_colors, FG_GREEN, "SUCCESS")
-    self.warning = make_log_func(self, 2, min_level, use_colors, FG_YELLOW, "WARNING")
-    self.error = make_log_func(self, 3, min_level, use_colors, FG_RED, "ERROR")
+    gen_log_funcs(self, min_level, use_colors)
+    loggers[self] = true
 
     return self
 end
@@ -316,15 +476,93 @@ function Logger:set_logger_name(name)
 
     -- Regenerate log functions with new prefix
     local min_level = self._min_level or CFG_MIN_LEVEL
-    self.debug = make_log_func(self, 0, min_level, use_colors, FG_BRIGHT_BLACK, "DEBUG")
-    self.info = make_log_func(self, 1, min_level, use_colors, FG_CYAN, "")
-    self.success = make_log_func(self, 1, min_level, use_colors, FG_GREEN, "SUCCESS")
-    self.warning = make_log_func(self, 2, min_level, use_colors, FG_YELLOW, "WARNING")
-    self.error = make_log_func(self, 3, min_level, use_colors, FG_RED, "ERROR")
+    gen_log_funcs(self, min_level, use_colors)
 
     return self
 end
 
+local function regenerate_all()
+    for logger, _ in pairs(loggers) do
+        gen_log_funcs(logger, logger._min_level, logger._use_colors)
+    end
+end
+
+--- Send the messages of every logger (existing and future ones) to the native
+--- sink (liblog_sink) instead of printing them. A log call only records the
+--- raw arguments (and the format string id for `*f` methods) into a ring of
+--- the calling thread, a background thread formats / writes them. Errors are
+--- still printed. Binary output is rendered by `log_decode <file>`.
+---
+--- With `flight_mb`, nothing is written while logging: the last `flight_mb`
+--- MB of records per thread are kept in memory and written to `path` on every
+--- error message and at `close_sink` (called at the end of the simulation).
+---
+--- Usage:
+--- ```lua
+--- Logger.set_sink({ path = "debug.vllog" })
+--- Logger.set_sink({ path = "flight.txt", text = true, flight_mb = 16 })
+--- ```
+---@param params verilua.utils.Logger.sink_params
+function Logger.set_sink(params)
+    assert(type(params) == "table" and type(params.path) == "string", "[Logger] [set_sink] `params.path` must be a string")
+
+    local lsn = require "verilua.utils.LogSinkNative"
+    local lib = lsn.require_lib("Logger.set_sink")
+
+    Logger.close_sink()
+
+    local flight_bytes = params.flight_mb and floor(params.flight_mb * 1024 * 1024) or 0
+    local ret = lib.log_sink_open(params.path, params.text and lsn.TEXT or lsn.BINARY, (params.ring_kb or 0) * 1024,
+        flight_bytes)
+    assert(ret == 0, f("[Logger] [set_sink] %s", ret ~= 0 and lsn.last_error() or ""))
+
+    sink = lsn
+    sink_flight = flight_bytes > 0
+    sink_path = params.path
+    regenerate_all()
+end
+
+--- Stop using the native sink: flush it (or dump the flight recorder) and
+--- print again. Returns false if the output could not be written.
+---@return boolean
+function Logger.close_sink()
+    if not sink then
+        return true
+    end
+
+    local lsn = sink
+    sink = nil
+    regenerate_all()
+
+    local dropped = tonumber(lsn.lib.log_sink_dropped())
+    local ok = lsn.lib.log_sink_close() == 0
+    if not ok then
+        print(f(">> [Logger] failed to close the log sink: %s", lsn.last_error()))
+    elseif dropped > 0 then
+        print(f(">> [Logger] log sink `%s`: %d records or arguments were dropped or cut", sink_path, dropped))
+    end
+    return ok
+end
+
+--- Wait until everything logged so far is written (streaming sink). Returns
+--- false once the output could not be written, later records are dropped.
+---@return boolean
+function Logger.flush_sink()
+    if sink then
+        return sink.lib.log_sink_flush() == 0
+    end
+    return true
+end
+
+--- Write the records kept by the flight recorder now, returns how many (-1 without flight recorder).
+---@return integer
+function Logger.dump_sink()
+    if not (sink and sink_flight) then
+        return -1
+    end
+    return sink.lib.log_sink_dump()
+end
+
 --------------------------------------------------------------------------------
 -- Formatting Methods (used less frequently, normal implementation)
 --------------------------------------------------------------------------------
@@ -516,6 +754,19 @@ Logger.colorize = colorize
 Logger.get_box = get_box
 Logger.get_icon = get_icon
 
+-- Sink requested through the environment, falls back to printing if liblog_sink is missing
+local env_sink_path = os.getenv("VL_LOG_SINK")
+if env_sink_path and env_sink_path ~= "" then
+    local ok, err = pcall(Logger.set_sink, {
+        path = env_sink_path,
+        text = os.getenv("VL_LOG_SINK_TEXT") == "1",
+        flight_mb = tonumber(os.getenv("VL_LOG_SINK_FLIGHT_MB") or ""),
+    })
+    if not ok then
+        print(f(">> [Logger] VL_LOG_SINK is ignored: %s", tostring(err)))
+    end
+end
+
 -- Default logger instance (created once)
 local default_logger = Logger.new("VERILUA")
 Logger.default = default_logger
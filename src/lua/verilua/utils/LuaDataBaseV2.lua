@@ -39,8 +39,47 @@ local verilua_warning = _G.verilua_warning
 ffi.cdef [[
     typedef int pid_t;
     pid_t getpid(void);
+
+    typedef struct {
+        int64_t *values;
+        uint8_t *text;
+        uint32_t row_num;
+        uint32_t text_len;
+        uint32_t row_cap;
+        uint32_t text_cap;
+    } verilua_db_batch;
+
+    void *verilua_db_writer_open(uint32_t backend, void *conn, void **funcs, uint32_t func_num, const char *insert_sql, const uint8_t *col_types, uint32_t col_num, uint32_t batch_rows, uint32_t text_bytes, uint32_t batch_num, uint64_t txn_rows);
+    verilua_db_batch *verilua_db_writer_acquire(void *writer);
+    bool verilua_db_writer_submit(void *writer, verilua_db_batch *batch);
+    bool verilua_db_writer_close(void *writer);
+    const char *verilua_db_writer_error(void *writer);
+    void verilua_db_writer_free(void *writer);
 ]]
 
+--- Backend ids of the async writer, must match `BACKEND_*` in libverilua/src/db_writer.rs
+local ASYNC_BACKENDS = { sqlite3 = 0, turso = 1, duckdb = 2 }
+
+---@type any
+local async_clib
+
+--- The async writer lives in libverilua: use the already loaded one inside a
+--- simulation, `$VERILUA_HOME/shared/libverilua_nosim.so` otherwise.
+local function load_async_clib()
+    if async_clib then
+        return async_clib
+    end
+
+    if pcall(function() return ffi.C.verilua_db_writer_open end) then
+        async_clib = ffi.C
+    else
+        local verilua_home = os.getenv("VERILUA_HOME")
+        assert(verilua_home, "[LuaDataBaseV2] `async` needs libverilua, environment variable `VERILUA_HOME` is not set!")
+        async_clib = ffi.load(verilua_home .. "/shared/libverilua_nosim.so")
+    end
+    return async_clib
+end
+
 -- sqlite3 backend: bind numbers as double (53-bit exact integers), matching the
 -- original lsqlite3-based LuaDataBase and the no_check_bind_value fast path.
 -- sqlite3_bind_int would truncate values above 2^31 (C int); INTEGER column
@@ -103,6 +142,10 @@ end
 ---@field lib_name? string Default: sqlite3/duckdb (unused by the turso backend)
 ---@field lib_path? string Default: nil
 ---@field pragmas? verilua.utils.LuaDataBase.pragmas
+---@field async? boolean Default: false, insert rows on a worker thread of libverilua (see `LuaDataBaseV2:_init_async`)
+---@field async_batch_num? integer Default: 4, number of `save_cnt_max`-row batches in flight (bounds the memory)
+---@field async_text_bytes? integer Default: 1 MiB, TEXT bytes per batch
+---@field async_txn_rows? integer Default: 1000000, rows per transaction (duckdb: per appender flush)
 
 ---@class (exact) verilua.utils.LuaDataBase
 ---@overload fun(params: verilua.utils.LuaDataBase.params): verilua.utils.LuaDataBase
@@ -137,6 +180,9 @@ end
 ---@field private table_cnt integer
 ---@field private table_idx integer
 ---@field private cache table
+---@field private async boolean
+---@field private async_writer? ffi.cdata*
+---@field private async_batch? ffi.cdata*
 ---@field private _log fun(self: verilua.utils.LuaDataBase, ...)
 ---@field private create_db fun(self: verilua.utils.LuaDataBase)
 ---@field private create_table fun(self: verilua.utils.LuaDataBase)
@@ -225,6 +271,10 @@ function LuaDataBaseV2:_init(params)
         "backend",
         "lib_name",
         "lib_path",
+        "async",
+        "async_batch_num",
+        "async_text_bytes",
+        "async_txn_rows",
     })
 
     local save_cnt_max  = params.save_cnt_max or 10000
@@ -303,6 +353,13 @@ function LuaDataBaseV2:_init(params)
     self.stmt = nil
     self.finished = false
     self.verbose = verbose or false
+    self.async = params.async or false
+    if self.async then
+        assert(
+            not size_limit and not table_cnt_max,
+            "[LuaDataBaseV2] `async` cannot be combined with `size_limit` / `table_cnt_max`"
+        )
+    end
 
     -- Used for type check(TypeExpect)
     self.__type = "LuaDataBase"
@@ -457,8 +514,10 @@ function LuaDataBaseV2:_init(params)
     -- Pre-allocate memory
     self.save_cnt_max = save_cnt_max
     self.save_cnt = 1
-    self.cache = table_new(save_cnt_max, 0) -- TODO: using FFI data structure
-    for _ = 1, save_cnt_max do
+    -- The async writer keeps its rows in native batches instead
+    local cache_size = self.async and 0 or save_cnt_max
+    self.cache = table_new(cache_size, 0) -- TODO: using FFI data structure
+    for _ = 1, cache_size do
         table_insert(self.cache, pre_alloc_entry)
     end
 
@@ -759,6 +818,10 @@ function LuaDataBaseV2:_init(params)
         "LuaDataBaseV2:commit()"
     )
 
+    if self.async then
+        self:_init_async(params)
+    end
+
     final {
         function()
             -- Mark as finished
@@ -779,6 +842,245 @@ function LuaDataBaseV2:_init(params)
     }
 end
 
+--- Async mode: the connection (duckdb: the appender) is handed to a writer
+--- thread in libverilua. `save` stores rows into a native batch of
+--- `save_cnt_max` rows; a full batch (or `commit()`) is submitted to the worker,
+--- which binds and steps them with one prepared statement inside large
+--- transactions. Only `async_batch_num` batches exist: when all of them are
+--- queued, `commit()` blocks until the worker returns one.
+--- INTEGER values are stored as int64, so `save` rejects numbers that are not
+--- integral or do not fit (NaN, inf, 1.5, 2^63) instead of truncating them;
+--- with `no_check_bind_value` they are converted unchecked.
+---@private
+---@param params verilua.utils.LuaDataBase.params
+function LuaDataBaseV2:_init_async(params)
+    local clib = load_async_clib()
+    local backend = self.backend
+
+    local funcs, conn
+    if backend == "sqlite3" then
+        funcs = {
+            sqlite3_clib.sqlite3_exec,
+            sqlite3_clib.sqlite3_prepare_v2,
+            sqlite3_clib.sqlite3_bind_int64,
+            sqlite3_clib.sqlite3_bind_text,
+            sqlite3_clib.sqlite3_step,
+            sqlite3_clib.sqlite3_reset,
+            sqlite3_clib.sqlite3_finalize,
+            sqlite3_clib.sqlite3_errmsg,
+        }
+        conn = self.db
+    elseif backend == "turso" then
+        local turso_clib = turso.clib
+        funcs = {
+            turso_clib.turso_ffi_exec,
+            turso_clib.turso_ffi_prepare,
+            turso_clib.turso_ffi_bind_int,
+            turso_clib.turso_ffi_bind_text,
+            turso_clib.turso_ffi_step,
+            turso_clib.turso_ffi_reset,
+            turso_clib.turso_ffi_finalize,
+            turso_clib.turso_ffi_errmsg,
+        }
+        conn = self.db
+    else
+        local duckdb_clib = duckdb.clib
+        funcs = {
+            duckdb_clib.duckdb_append_int64,
+            duckdb_clib.duckdb_append_varchar,
+            duckdb_clib.duckdb_appender_end_row,
+            duckdb_clib.duckdb_appender_flush,
+        }
+        conn = self.duckdb_appd
+    end
+
+    local c_funcs = ffi.new("void *[?]", #funcs)
+    for i, func in ipairs(funcs) do
+        c_funcs[i - 1] = ffi.cast("void *", func)
+    end
+
+    local ncol = #self.entries
+    local col_types = ffi.new("uint8_t[?]", ncol)
+    local is_text = table_new(ncol, 0)
+    for i, entry in ipairs(self.entries) do
+        is_text[i] = entry.type == "TEXT" or entry.type == "VARCHAR"
+        col_types[i - 1] = is_text[i] and 1 or 0
+    end
+
+    local text_cap = params.async_text_bytes or (1024 * 1024)
+    local writer = clib.verilua_db_writer_open(
+        ASYNC_BACKENDS[backend],
+        ffi.cast("void *", conn),
+        c_funcs,
+        #funcs,
+        backend ~= "duckdb" and self.prepare_cmd or nil,
+        col_types,
+        ncol,
+        self.save_cnt_max,
+        text_cap,
+        params.async_batch_num or 4,
+        params.async_txn_rows or 1000000
+    )
+    if writer == nil then
+        assert(false, f("[LuaDataBaseV2] [%s] cannot start the async writer => %s", self.fullpath_name, self.db:errmsg()))
+    end
+    self.async_writer = ffi.gc(writer, clib.verilua_db_writer_free)
+    self.async_batch = clib.verilua_db_writer_acquire(writer)
+
+    -- e.g. (v2 is TEXT)
+    --      save = function(this, v1, v2)
+    --          local batch = this.async_batch
+    --          local len2 = #v2
+    --          if batch.text_len + band(len2 + 8, -4) > 1048576 then
+    --              this:commit()
+    --              batch = this.async_batch
+    --          end
+    --          local row = batch.row_num
+    --          local values = batch.values + row * 2
+    --          local text, text_len = batch.text, batch.text_len
+    --          values[0] = v1
+    --          ffi_cast(u32_ptr, text + text_len)[0] = len2
+    --          ffi_copy(text + text_len + 4, v2, len2 + 1)
+    --          values[1] = text_len
+    --          text_len = text_len + band(len2 + 8, -4)
+    --          batch.text_len = text_len
+    --          batch.row_num = row + 1
+    --          if row + 1 >= 10000 then
+    --              this:commit()
+    --          end
+    --      end
+    local args = table_new(ncol, 0)
+    local checks = {}
+    local text_need = {}
+    local stores = table_new(ncol, 0)
+    for i = 1, ncol do
+        local v = "v" .. i
+        args[i] = v
+        if is_text[i] then
+            if not params.no_check_bind_value then
+                checks[#checks + 1] = f("if type(%s) ~= \"string\" then %s = tostring(%s) end", v, v, v)
+            end
+            checks[#checks + 1] = f("local len%d = #%s", i, v)
+            text_need[#text_need + 1] = f("band(len%d + 8, -4)", i)
+            stores[i] = subst([[
+            ffi_cast(u32_ptr, text + text_len)[0] = len$(i)
+            ffi_copy(text + text_len + 4, v$(i), len$(i) + 1)
+            values[$(k)] = text_len
+            text_len = text_len + band(len$(i) + 8, -4)]], { i = i, k = i - 1 })
+        else
+            if not params.no_check_bind_value then
+                checks[#checks + 1] = subst([[
+            local t$(i) = type(v$(i))
+            if t$(i) == "number" then
+                if v$(i) % 1 ~= 0 or v$(i) >= 0x1p63 or v$(i) < -0x1p63 then
+                    assert(false, "[LuaDataBaseV2] [save] INTEGER column `$(name)` got a non-integral or out of range number: " .. tostring(v$(i)))
+                end
+            elseif t$(i) ~= "cdata" then
+                assert(false, "[LuaDataBaseV2] [save] Unsupported data type: " .. t$(i))
+            end]], { i = i, name = self.entries[i].name })
+            end
+            stores[i] = f("values[%d] = %s", i - 1, v)
+        end
+    end
+
+    local save_func_code = subst([[
+        return function(this, $(args))
+            local batch = this.async_batch
+            $(checks)
+|> if #text_need > 0 then
+            local text_need = $(text_need)
+            if batch.text_len + text_need > $(text_cap) then
+                if text_need > $(text_cap) then
+                    assert(false, "[LuaDataBaseV2] [save] row larger than `async_text_bytes`: " .. text_need)
+                end
+                this:commit()
+                batch = this.async_batch
+            end
+            local text, text_len = batch.text, batch.text_len
+|> end
+            local row = batch.row_num
+            local values = batch.values + row * $(ncol)
+            $(stores)
+|> if #text_need > 0 then
+            batch.text_len = text_len
+|> end
+            batch.row_num = row + 1
+            if row + 1 >= $(row_cap) then
+                this:commit()
+            end
+        end
+    ]], {
+        _escape = "|>",
+        args = table.concat(args, ", "),
+        checks = table.concat(checks, "\n            "),
+        text_need = table.concat(text_need, " + "),
+        text_cap = text_cap,
+        ncol = ncol,
+        stores = table.concat(stores, "\n            "),
+        row_cap = self.save_cnt_max,
+    })
+
+    local commit_func_code = subst([[
+        return function(this)
+            local batch = this.async_batch
+            if batch.row_num == 0 then
+                return
+            end
+
+            -- This is used when `LightSSS` is enabled.
+            -- A forked child has no writer thread, its rows are dropped like in the sync mode
+            if ffi.C.getpid() ~= $(pid) then
+                batch.row_num = 0
+                batch.text_len = 0
+                return
+            end
+
+            local writer = this.async_writer
+            if not clib.verilua_db_writer_submit(writer, batch) then
+                this:_async_error()
+            end
+            batch = clib.verilua_db_writer_acquire(writer)
+            if batch == nil then
+                this:_async_error()
+            end
+            this.async_batch = batch
+
+            $(verbose_print)
+        end
+    ]], {
+        pid = self.pid,
+        verbose_print = self.verbose and "this:_log('commit!')" or "",
+    })
+
+    self.save = utils.loadcode(
+        save_func_code,
+        {
+            type = type,
+            tostring = tostring,
+            assert = assert,
+            band = bit.band,
+            ffi_cast = ffi.cast,
+            ffi_copy = ffi.copy,
+            u32_ptr = ffi.typeof("uint32_t *"),
+        },
+        "LuaDataBaseV2:save()"
+    )
+    self.commit = utils.loadcode(commit_func_code, { ffi = ffi, clib = clib }, "LuaDataBaseV2:commit()")
+end
+
+---@private
+function LuaDataBaseV2:_async_error()
+    local err = async_clib.verilua_db_writer_error(self.async_writer)
+    assert(
+        false,
+        f(
+            "[LuaDataBaseV2] [%s] async writer error: %s",
+            self.fullpath_name,
+            err ~= nil and ffi.string(err) or "writer is closed (save() after clean_up()?)"
+        )
+    )
+end
+
 function LuaDataBaseV2:_log(...)
     print(f("[LuaDataBaseV2] [%s]", self.file_name), ...)
     io.flush()
@@ -863,6 +1165,13 @@ function LuaDataBaseV2:clean_up()
 
     self:commit()
 
+    if self.async_writer and ffi.C.getpid() == self.pid then
+        -- Waits for the worker to drain every submitted batch and commit
+        if not async_clib.verilua_db_writer_close(self.async_writer) then
+            self:_async_error()
+        end
+    end
+
     if self.backend == "duckdb" then
         print(f(
             "[LuaDataBaseV2] [%s] [%s => %s] [%s] flush appender...\n",
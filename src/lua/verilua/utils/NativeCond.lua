@@ -0,0 +1,243 @@
+--- NativeCond - Wait for a signal predicate without resuming Lua on every edge
+---
+--- `repeat clock:posedge() until dut.valid:is(1) and dut.ready:is(1)` resumes
+--- the task on every clock edge only to evaluate the condition. NativeCond
+--- compiles the condition once into a small bytecode that libverilua evaluates
+--- on every edge in native code; the task is resumed only when the condition
+--- holds or when the cycle limit is reached.
+---
+--- Conditions compare the lower 64 bits of a signal (`(value & mask) == v`)
+--- and combine them with `all` / `any` / `inv`.
+---
+--- Example usage:
+--- ```lua
+--- local NativeCond = require "verilua.utils.NativeCond"
+--- local eq, all = NativeCond.eq, NativeCond.all
+---
+--- local fire = NativeCond(all { eq(dut.valid:chdl(), 1), eq(dut.ready:chdl(), 1) })
+---
+--- local ok, cycles = fire:posedge(dut.clock:chdl(), 1000) -- at most 1000 posedges
+--- fire:posedge(dut.clock:chdl())                            -- no limit
+---
+--- local idle = NativeCond(NativeCond.eq(dut.state:chdl(), 0, 0x3)) -- state[1:0] == 0
+--- ```
+
+local ffi = require "ffi"
+local class = require "pl.class"
+local texpect = require "verilua.TypeExpect"
+local vpiml = require "verilua.vpiml.vpiml"
+
+local f = string.format
+local ffi_new = ffi.new
+
+local OP_EQ = 0
+local OP_NE = 1
+local OP_AND = 2
+local OP_OR = 3
+local OP_NOT = 4
+
+local EDGE_POSEDGE = 0
+local EDGE_NEGEDGE = 1
+local EDGE_ANY = 2
+
+---@class verilua.utils.NativeCond.Expr
+---@field op integer
+---@field chdl? verilua.handles.CallableHDL
+---@field mask? integer|ffi.cdata*
+---@field value? integer|ffi.cdata*
+---@field args? verilua.utils.NativeCond.Expr[]
+
+---@class verilua.utils.NativeCond
+---@overload fun(expr: verilua.utils.NativeCond.Expr): verilua.utils.NativeCond
+---@field private _handle ffi.cdata* Opaque handle to the compiled Rust predicate
+---@field private _chdls verilua.handles.CallableHDL[] Signals read by the predicate
+local NativeCond = class()
+
+---@param op integer
+---@param chdl verilua.handles.CallableHDL
+---@param value integer|ffi.cdata*
+---@param mask? integer|ffi.cdata*
+---@return verilua.utils.NativeCond.Expr
+local function leaf(op, chdl, value, mask)
+    texpect.expect_chdl(chdl, "chdl")
+    assert(chdl.width <= 64, f("[NativeCond] `%s` is %d bits wide, only signals up to 64 bits are supported", chdl.fullpath, chdl.width))
+
+    if mask == nil then
+        mask = chdl.width == 64 and 0xFFFFFFFFFFFFFFFFULL or (bit.lshift(1ULL, chdl.width) - 1)
+    end
+    return { op = op, chdl = chdl, value = value, mask = mask }
+end
+
+--- `(chdl & mask) == value`, `mask` defaults to all bits of the signal
+---@param chdl verilua.handles.CallableHDL
+---@param value integer|ffi.cdata*
+---@param mask? integer|ffi.cdata*
+---@return verilua.utils.NativeCond.Expr
+function NativeCond.eq(chdl, value, mask)
+    return leaf(OP_EQ, chdl, value, mask)
+end
+
+--- `(chdl & mask) ~= value`, `mask` defaults to all bits of the signal
+---@param chdl verilua.handles.CallableHDL
+---@param value integer|ffi.cdata*
+---@param mask? integer|ffi.cdata*
+---@return verilua.utils.NativeCond.Expr
+function NativeCond.ne(chdl, value, mask)
+    return leaf(OP_NE, chdl, value, mask)
+end
+
+--- All of `exprs` hold
+---@param exprs verilua.utils.NativeCond.Expr[]
+---@return verilua.utils.NativeCond.Expr
+function NativeCond.all(exprs)
+    assert(type(exprs) == "table" and #exprs >= 1, "[NativeCond] all() expects a non-empty list of conditions")
+    return { op = OP_AND, args = exprs }
+end
+
+--- Any of `exprs` holds
+---@param exprs verilua.utils.NativeCond.Expr[]
+---@return verilua.utils.NativeCond.Expr
+function NativeCond.any(exprs)
+    assert(type(exprs) == "table" and #exprs >= 1, "[NativeCond] any() expects a non-empty list of conditions")
+    return { op = OP_OR, args = exprs }
+end
+
+--- `expr` does not hold
+---@param expr verilua.utils.NativeCond.Expr
+---@return verilua.utils.NativeCond.Expr
+function NativeCond.inv(expr)
+    return { op = OP_NOT, args = { expr } }
+end
+
+--- Emit `expr` in postfix order into `ops` (`{op, hdl, mask, value}` entries)
+---@param expr verilua.utils.NativeCond.Expr
+---@param ops table
+---@param chdls verilua.handles.CallableHDL[]
+local function emit(expr, ops, chdls)
+    assert(type(expr) == "table" and type(expr.op) == "number", "[NativeCond] invalid condition expression")
+
+    local op = expr.op
+    if op == OP_EQ or op == OP_NE then
+        ops[#ops + 1] = { op, expr.chdl.hdl, expr.mask, expr.value }
+        chdls[#chdls + 1] = expr.chdl
+    elseif op == OP_NOT then
+        emit(expr.args[1], ops, chdls)
+        ops[#ops + 1] = { OP_NOT, 0, 0, 0 }
+    else
+        emit(expr.args[1], ops, chdls)
+        for i = 2, #expr.args do
+            emit(expr.args[i], ops, chdls)
+            ops[#ops + 1] = { op, 0, 0, 0 }
+        end
+    end
+end
+
+--- Compile `expr` into a native predicate
+---@param expr verilua.utils.NativeCond.Expr
+function NativeCond:_init(expr)
+    local ops = {}
+    local chdls = {}
+    emit(expr, ops, chdls)
+
+    local words = ffi_new("uint64_t[?]", #ops * 4)
+    for i, op in ipairs(ops) do
+        local base = (i - 1) * 4
+        for j = 1, 4 do
+            words[base + j - 1] = op[j]
+        end
+    end
+
+    ---@diagnostic disable-next-line: param-type-mismatch
+    local handle = vpiml.vpiml_native_cond_new(words, #ops)
+    assert(handle ~= nil, "[NativeCond] failed to compile condition (stack depth exceeds 64?)")
+
+    self._handle = handle
+    self._chdls = chdls
+end
+
+--- Evaluate the condition now
+---@return boolean
+function NativeCond:eval()
+    assert(self._handle, "[NativeCond] eval() called on destroyed instance")
+    ---@diagnostic disable-next-line: param-type-mismatch
+    return vpiml.vpiml_native_cond_eval(self._handle) ~= 0
+end
+
+---@param clock verilua.handles.CallableHDL
+---@param edge_type integer
+---@param max_cycles? integer
+---@return boolean ok, integer cycles
+function NativeCond:_wait(clock, edge_type, max_cycles)
+    assert(self._handle, "[NativeCond] wait called on destroyed instance")
+    texpect.expect_chdl(clock, "clock")
+    assert(clock.width == 1, f("[NativeCond] clock `%s` must be a 1-bit signal", clock.fullpath))
+    max_cycles = max_cycles or 0
+    assert(max_cycles >= 0, "[NativeCond] max_cycles must be >= 0")
+
+    if cfg.mode ~= "normal" then
+        -- Step schedulers have no edge callbacks, evaluate from Lua instead
+        local cycles = 0
+        repeat
+            if edge_type == EDGE_NEGEDGE then
+                clock:negedge()
+            else
+                clock:posedge()
+            end
+            cycles = cycles + 1
+            if self:eval() then
+                return true, cycles
+            end
+        until max_cycles ~= 0 and cycles >= max_cycles
+        return false, cycles
+    end
+
+    ---@diagnostic disable-next-line: param-type-mismatch
+    local result = await_native_cond(self._handle, clock.hdl, edge_type, max_cycles)
+    if result > 0 then
+        return true, result
+    end
+    return false, -result
+end
+
+--- Wait for the first posedge of `clock` at which the condition holds
+---@param clock verilua.handles.CallableHDL 1-bit clock signal
+---@param max_cycles? integer Maximum number of posedges to wait, nil/0 means no limit
+---@return boolean ok Whether the condition held (false: `max_cycles` reached)
+---@return integer cycles Number of posedges waited
+function NativeCond:posedge(clock, max_cycles)
+    return self:_wait(clock, EDGE_POSEDGE, max_cycles)
+end
+
+--- Wait for the first negedge of `clock` at which the condition holds
+---@param clock verilua.handles.CallableHDL 1-bit clock signal
+---@param max_cycles? integer Maximum number of negedges to wait, nil/0 means no limit
+---@return boolean ok Whether the condition held (false: `max_cycles` reached)
+---@return integer cycles Number of negedges waited
+function NativeCond:negedge(clock, max_cycles)
+    return self:_wait(clock, EDGE_NEGEDGE, max_cycles)
+end
+
+--- Wait for the first edge (either direction) of `signal` at which the condition holds
+---@param signal verilua.handles.CallableHDL 1-bit signal
+---@param max_cycles? integer Maximum number of edges to wait, nil/0 means no limit
+---@return boolean ok Whether the condition held (false: `max_cycles` reached)
+---@return integer cycles Number of edges waited
+function NativeCond:edge(signal, max_cycles)
+    return self:_wait(signal, EDGE_ANY, max_cycles)
+end
+
+--- Free the compiled predicate. Must not be called while a task is waiting on it
+--- (a task removed by `scheduler:remove_task` no longer waits).
+function NativeCond:destroy()
+    if self._handle then
+        vpiml.vpiml_native_cond_destroy(self._handle)
+        self._handle = nil
+    end
+end
+
+--- Destructor - automatically called when instance is garbage collected
+function NativeCond:__gc()
+    self:destroy()
+end
+
+return NativeCond
@@ -1,45 +1,254 @@
----@class (exact) verilua.utils.PerfCounter.state
+local ffi = require "ffi"
+local math = require "math"
+
+local f = string.format
+local floor = math.floor
+local log = math.log
+local tonumber = tonumber
+
+-- Same declaration as `verilua/init.lua` (already defined when running inside verilua)
+pcall(ffi.cdef, [[
+    typedef struct timespec {
+        long sec;
+        long nsec;
+    } timespec;
+    int clock_gettime(int clk_id, struct timespec *tp);
+]])
+
+pcall(ffi.cdef, [[
+    typedef struct {
+        double calls;
+        double total_ns;
+        double min_ns;
+        double max_ns;
+        uint32_t hist[32];
+    } vl_perf_slot_t;
+]])
+
+local C = ffi.C
+local CLOCK_MONOTONIC = 1
+
+--- Histogram bucket `b` counts calls taking [2^b, 2^(b+1)) ns, the last one everything above ~2 s
+local NR_BUCKETS = 32
+local INV_LN2 = 1 / log(2)
+
+local ts = ffi.new("timespec[1]")
+C.clock_gettime(CLOCK_MONOTONIC, ts)
+local base_sec = tonumber(ts[0].sec)
+
+--- Nanoseconds of CLOCK_MONOTONIC since this module was loaded. A vDSO call, ~20 ns.
+---@return number
+local function now_ns()
+    C.clock_gettime(CLOCK_MONOTONIC, ts)
+    return (tonumber(ts[0].sec) - base_sec) * 1e9 + tonumber(ts[0].nsec)
+end
+
+---@class (exact) verilua.utils.PerfCounter.stats
 ---@field calls integer
----@field total number
+---@field total number Total time in seconds
+---@field min number Fastest call in seconds
+---@field max number Slowest call in seconds
+---@field avg number Average time in seconds
+---@field hist integer[] `hist[b + 1]` calls that took [2^b, 2^(b+1)) ns
 
 ---@class (exact) verilua.utils.PerfCounter
----@field private perf_map table<string, verilua.utils.PerfCounter.state>
+---@field private slot_ids table<string, integer> Slot index of each counter name
+---@field private slot_names string[] Counter name of each slot (1-based)
+---@field private nr_slots integer
+---@field now_ns fun(): number Nanoseconds of CLOCK_MONOTONIC since the module was loaded
+---@field slot fun(self: verilua.utils.PerfCounter, name: string): integer
+---@field record fun(self: verilua.utils.PerfCounter, slot: integer, ns: number)
 ---@field wrap_func fun(self: verilua.utils.PerfCounter, name: string, func: function): function
+---@field get_stats fun(self: verilua.utils.PerfCounter, name: string): verilua.utils.PerfCounter.stats?
+---@field reset fun(self: verilua.utils.PerfCounter, name: string?)
 ---@field print_perf fun(self: verilua.utils.PerfCounter, name: string?)
 local PerfCounter = {
-    perf_map = {},
+    slot_ids = {},
+    slot_names = {},
+    nr_slots = 0,
+    now_ns = now_ns,
 }
 
-function PerfCounter:wrap_func(name, func)
-    assert(self.perf_map[name] == nil, "PerfCounter:wrap_func: name already exists")
-    self.perf_map[name] = { calls = 0, total = 0.0 }
+-- Fixed size counters, 0-based and indexed by slot id. Closures read the upvalue
+-- on every call, so growing the array only swaps it.
+local capacity = 64
+local slots = ffi.new("vl_perf_slot_t[?]", capacity)
+
+local function init_slot(slot)
+    ffi.fill(slot, ffi.sizeof("vl_perf_slot_t"))
+    slot.min_ns = math.huge
+end
+
+for i = 0, capacity - 1 do
+    init_slot(slots[i])
+end
+
+---@param slot_id integer
+---@param ns number
+local function record(slot_id, ns)
+    local slot = slots[slot_id]
+    slot.calls = slot.calls + 1
+    slot.total_ns = slot.total_ns + ns
+    if ns < slot.min_ns then
+        slot.min_ns = ns
+    end
+    if ns > slot.max_ns then
+        slot.max_ns = ns
+    end
+
+    local b = 0
+    if ns >= 2 then
+        b = floor(log(ns) * INV_LN2)
+        if b >= NR_BUCKETS then
+            b = NR_BUCKETS - 1
+        end
+    end
+    slot.hist[b] = slot.hist[b] + 1
+end
+
+--- Slot of the counter `name`, created on first use. Pass it to `record` to
+--- time code that is not a single function call:
+--- ```lua
+---     local slot = PerfCounter:slot("decode")
+---     local s = PerfCounter.now_ns()
+---     -- ...
+---     PerfCounter:record(slot, PerfCounter.now_ns() - s)
+--- ```
+---@param name string
+---@return integer
+function PerfCounter:slot(name)
+    local id = self.slot_ids[name]
+    if id then
+        return id
+    end
+
+    id = self.nr_slots
+    if id >= capacity then
+        local new_slots = ffi.new("vl_perf_slot_t[?]", capacity * 2)
+        ffi.copy(new_slots, slots, ffi.sizeof("vl_perf_slot_t") * capacity)
+        for i = capacity, capacity * 2 - 1 do
+            init_slot(new_slots[i])
+        end
+        slots = new_slots
+        capacity = capacity * 2
+    end
 
-    local state = self.perf_map[name]
+    self.nr_slots = id + 1
+    self.slot_ids[name] = id
+    self.slot_names[id + 1] = name
+    return id
+end
+
+--- Add one call of `ns` nanoseconds to the counter `slot`
+---@param slot integer
+---@param ns number
+function PerfCounter:record(slot, ns)
+    record(slot, ns)
+end
+
+function PerfCounter:wrap_func(name, func)
+    assert(self.slot_ids[name] == nil, "PerfCounter:wrap_func: name already exists")
+    local slot_id = self:slot(name)
 
     local wrapped_func = function(...)
-        local s = os.clock()
+        local s = now_ns()
         -- Support at most 4 return values
         local r0, r1, r2, r3 = func(...)
-        local e = os.clock()
-        state.calls = state.calls + 1
-        state.total = state.total + (e - s)
+        record(slot_id, now_ns() - s)
         return r0, r1, r2, r3
     end
     return wrapped_func
 end
 
+--- Statistics of the counter `name`, nil if it does not exist
+---@param name string
+---@return verilua.utils.PerfCounter.stats?
+function PerfCounter:get_stats(name)
+    local id = self.slot_ids[name]
+    if not id then
+        return nil
+    end
+
+    local slot = slots[id]
+    local calls = tonumber(slot.calls) --[[@as integer]]
+    local hist = {}
+    for b = 0, NR_BUCKETS - 1 do
+        hist[b + 1] = tonumber(slot.hist[b])
+    end
+
+    return {
+        calls = calls,
+        total = slot.total_ns * 1e-9,
+        min = calls > 0 and slot.min_ns * 1e-9 or 0,
+        max = slot.max_ns * 1e-9,
+        avg = calls > 0 and slot.total_ns / calls * 1e-9 or 0,
+        hist = hist,
+    }
+end
+
+--- Clear the counter `name` (every counter if nil), slots stay allocated
+---@param name string?
+function PerfCounter:reset(name)
+    if name then
+        local id = self.slot_ids[name]
+        if id then
+            init_slot(slots[id])
+        end
+        return
+    end
+
+    for id = 0, self.nr_slots - 1 do
+        init_slot(slots[id])
+    end
+end
+
+---@param ns number
+---@return string
+local function fmt_ns(ns)
+    if ns < 1e3 then
+        return f("%.0f ns", ns)
+    elseif ns < 1e6 then
+        return f("%.2f us", ns * 1e-3)
+    elseif ns < 1e9 then
+        return f("%.2f ms", ns * 1e-6)
+    end
+    return f("%.2f s", ns * 1e-9)
+end
+
 function PerfCounter:print_perf(name)
     -- Branch 1: Print a detailed report for a single function.
     if name then
-        local stats = self.perf_map[name]
+        local stats = self:get_stats(name)
         if not stats or stats.calls == 0 then
             assert(false, string.format("Performance counter for '%s' not found or was never called.", name))
         end
-        local avg_time_ms = (stats.total / stats.calls) * 1000
+        ---@cast stats -?
+
+        local avg_time_ms = stats.avg * 1000
         print(string.format("---- Performance Report for: %s ----", name))
         print(string.format("  Total Time : %.4f s", stats.total))
         print(string.format("  Calls      : %d", stats.calls))
         print(string.format("  Avg Time   : %.4f ms/call", avg_time_ms))
+        print(string.format("  Min / Max  : %s / %s", fmt_ns(stats.min * 1e9), fmt_ns(stats.max * 1e9)))
+
+        -- Histogram of the non-empty buckets, bars relative to the largest one
+        local first, last, largest = nil, 0, 0
+        for b = 1, NR_BUCKETS do
+            local count = stats.hist[b]
+            if count > 0 then
+                first = first or b
+                last = b
+                if count > largest then
+                    largest = count
+                end
+            end
+        end
+        for b = first, last do
+            local count = stats.hist[b]
+            local lower = b == 1 and 0 or 2 ^ (b - 1)
+            print(string.format("  %9s ~ %-9s %10d %s", fmt_ns(lower), fmt_ns(2 ^ b), count,
+                string.rep("#", math.ceil(count / largest * 40))))
+        end
         print("------------------------------------------")
         return
     end
@@ -49,7 +258,8 @@ function PerfCounter:print_perf(name)
     -- Step 1: Prepare the data for printing.
     local entries = {}
     local grand_total_time = 0.0
-    for n, stats in pairs(self.perf_map) do
+    for _, n in ipairs(self.slot_names) do
+        local stats = self:get_stats(n) --[[@as verilua.utils.PerfCounter.stats]]
         if stats.calls > 0 then
             table.insert(entries, { name = n, stats = stats })
             grand_total_time = grand_total_time + stats.total
@@ -67,7 +277,7 @@ function PerfCounter:print_perf(name)
     end)
 
     -- Step 2: Calculate dynamic column widths for a clean table layout.
-    local col_widths = { name = 8, total = 14, calls = 14, avg = 10, percent = 8 }
+    local col_widths = { name = 8, total = 14, calls = 14, avg = 13, min = 10, max = 10, percent = 8 }
     for _, entry in ipairs(entries) do
         if #entry.name > col_widths.name then
             col_widths.name = #entry.name
@@ -84,6 +294,8 @@ function PerfCounter:print_perf(name)
             c:rep(col_widths.total + 2), m,
             c:rep(col_widths.calls + 2), m,
             c:rep(col_widths.avg + 2), m,
+            c:rep(col_widths.min + 2), m,
+            c:rep(col_widths.max + 2), m,
             c:rep(col_widths.percent + 2), r
         }
         print(table.concat(parts))
@@ -91,32 +303,35 @@ function PerfCounter:print_perf(name)
 
     -- Pre-build the format strings for the header and data rows.
     local header_format = string.format(
-        "│ %%-%ds │ %%%ds │ %%%ds │ %%%ds │ %%%ds │",
-        col_widths.name, col_widths.total, col_widths.calls, col_widths.avg, col_widths.percent
+        "│ %%-%ds │ %%%ds │ %%%ds │ %%%ds │ %%%ds │ %%%ds │ %%%ds │",
+        col_widths.name, col_widths.total, col_widths.calls, col_widths.avg, col_widths.min, col_widths.max,
+        col_widths.percent
     )
 
     -- Correctly construct the row format string using table.concat to avoid errors.
-    -- This creates a valid format string like: "│ %-20s │ %14.4f │ %8d │ %15.4f │ %8s │"
+    -- This creates a valid format string like: "│ %-20s │ %14.4f │ %8d │ %15.4f │ %10s │ %10s │ %8s │"
     local row_format = table.concat({
         "│ %-", col_widths.name, "s │ %", col_widths.total, ".4f │ %", col_widths.calls,
-        "d │ %", col_widths.avg, ".4f │ %", col_widths.percent, "s │"
+        "d │ %", col_widths.avg, ".4f │ %", col_widths.min, "s │ %", col_widths.max, "s │ %",
+        col_widths.percent, "s │"
     })
 
     -- Step 4: Print the final table.
     draw_line("┌", "┬", "┐")
-    print(string.format(header_format, "Function", "Total Time (s)", "Calls", "Avg Time (ms)", "Percent"))
+    print(string.format(header_format, "Function", "Total Time (s)", "Calls", "Avg Time (ms)", "Min", "Max", "Percent"))
     draw_line("├", "┼", "┤")
 
     for _, entry in ipairs(entries) do
         local stats = entry.stats
-        local avg_time_ms = (stats.total / stats.calls) * 1000
+        local avg_time_ms = stats.avg * 1000
 
         local percentage_str = "0.00%"
         if grand_total_time > 1e-9 then -- Avoid division by zero
             percentage_str = string.format("%.2f%%", (stats.total / grand_total_time) * 100)
         end
 
-        print(string.format(row_format, entry.name, stats.total, stats.calls, avg_time_ms, percentage_str))
+        print(string.format(row_format, entry.name, stats.total, stats.calls, avg_time_ms, fmt_ns(stats.min * 1e9),
+            fmt_ns(stats.max * 1e9), percentage_str))
     end
 
     draw_line("└", "┴", "┘")
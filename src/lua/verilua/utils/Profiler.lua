@@ -0,0 +1,133 @@
+--- Sampling profiler built on LuaJIT's `jit.profile` (a SIGPROF interval timer).
+---
+--- Every sample records the Lua call stack of the running coroutine, prefixed
+--- by the name of the scheduler task it belongs to, and `stop()` writes them as
+--- folded stacks (`task:<name>;caller;callee <count>`), the input format of
+--- flamegraph.pl / inferno / speedscope.
+---
+--- Environment Variables:
+--- - VL_PROF: Profile the whole simulation and write the folded stacks to this file
+--- - VL_PROF_INTERVAL_MS: Sampling interval in milliseconds (default: 1)
+---
+--- Usage:
+--- ```lua
+---     local Profiler = require "verilua.utils.Profiler"
+---     Profiler.start({ output = "sim.folded", interval_ms = 1 })
+---     -- ...
+---     Profiler.stop()
+--- ```
+--- then `flamegraph.pl sim.folded > sim.svg`.
+
+local f = string.format
+
+---@class (exact) verilua.utils.Profiler.params
+---@field output string Folded stacks file written by `stop()`
+---@field interval_ms integer? Sampling interval in milliseconds (default: 1)
+---@field depth integer? Maximum number of frames per stack (default: 64)
+---@field line boolean? Keep the line number of each frame (`func:line`), more precise but more stacks
+---@field task_name (fun(): string?)? Name of the current task (default: the scheduler task being resumed)
+
+---@class (exact) verilua.utils.Profiler
+---@field private running boolean
+---@field private output string
+---@field private counts table<string, integer> Samples of each folded stack
+---@field private nr_samples integer
+---@field start fun(params: verilua.utils.Profiler.params)
+---@field stop fun(): integer
+---@field is_running fun(): boolean
+local Profiler = {
+    running = false,
+    output = "",
+    counts = {},
+    nr_samples = 0,
+}
+
+-- Extra leaf frame for samples taken outside Lua code, see `jit.profile` vmstate
+local VMSTATE_FRAMES = {
+    G = ";[GC]",
+    J = ";[JIT compiler]",
+}
+
+--- Name of the scheduler task being resumed, nil outside of any task. The
+--- scheduler is not required here, profiling must not change what is loaded.
+---@return string?
+local function scheduler_task_name()
+    local scheduler = package.loaded["verilua.scheduler.LuaScheduler"]
+    if type(scheduler) ~= "table" then
+        return nil
+    end
+
+    local id = scheduler.curr_task_id
+    if not id or id == 0 then
+        return nil
+    end
+    ---@diagnostic disable-next-line: invisible
+    return scheduler.task_names[id]
+end
+
+function Profiler.start(params)
+    assert(type(params) == "table" and type(params.output) == "string",
+        "[Profiler] [start] `params.output` must be a string")
+    assert(not Profiler.running, "[Profiler] [start] the profiler is already running")
+
+    local ok, profile = pcall(require, "jit.profile")
+    assert(ok, "[Profiler] [start] jit.profile is not available, LuaJIT 2.1 is required")
+
+    local interval_ms = params.interval_ms or 1
+    assert(interval_ms >= 1 and math.floor(interval_ms) == interval_ms,
+        "[Profiler] [start] `params.interval_ms` must be a positive integer")
+
+    local depth = params.depth or 64
+    local dump_fmt = params.line and "plZ;" or "pFZ;"
+    local task_name = params.task_name or scheduler_task_name
+    local dumpstack = profile.dumpstack
+    local counts = {}
+
+    Profiler.running = true
+    Profiler.output = params.output
+    Profiler.counts = counts
+    Profiler.nr_samples = 0
+
+    -- Runs in the sampled coroutine at the next safe point, keep it short
+    profile.start("i" .. interval_ms, function(thread, samples, vmstate)
+        local name = task_name()
+        local stack = (name and ("task:" .. name) or "<main>") .. ";" ..
+            dumpstack(thread, dump_fmt, -depth) .. (VMSTATE_FRAMES[vmstate] or "")
+        counts[stack] = (counts[stack] or 0) + samples
+        Profiler.nr_samples = Profiler.nr_samples + samples
+    end)
+end
+
+--- Stop sampling and write the folded stacks, returns the number of samples
+---@return integer
+function Profiler.stop()
+    if not Profiler.running then
+        return 0
+    end
+
+    require("jit.profile").stop()
+    Profiler.running = false
+
+    -- Sorted, so that two runs can be diffed
+    local stacks = {}
+    for stack, _ in pairs(Profiler.counts) do
+        stacks[#stacks + 1] = stack
+    end
+    table.sort(stacks)
+
+    local file = io.open(Profiler.output, "w")
+    assert(file, f("[Profiler] [stop] cannot write `%s`", Profiler.output))
+    for _, stack in ipairs(stacks) do
+        file:write(stack, " ", Profiler.counts[stack], "\n")
+    end
+    file:close()
+
+    Profiler.counts = {}
+    return Profiler.nr_samples
+end
+
+function Profiler.is_running()
+    return Profiler.running
+end
+
+return Profiler
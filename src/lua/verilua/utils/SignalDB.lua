@@ -94,6 +94,9 @@ local cfg = _G.cfg
 ---@field prefix? string
 ---@field use_signal_db? boolean Force using SignalDB instead of VPI hierarchy API
 
+---@class (exact) verilua.utils.SignalDB.init.params
+---@field lazy_load? boolean Only generate the database, decode it on first use of `get_db_data`
+
 ---@class (exact) verilua.utils.SignalDB
 --- SignalDB is a singleton class that manages RTL signal information database.
 --- It provides methods to initialize, query, and search signals in the design hierarchy.
@@ -105,8 +108,10 @@ local cfg = _G.cfg
 ---@field private rtl_filelist string Path to the RTL filelist (default: "dut_file.f")
 ---@field private extra_signal_db_gen_args string Additional arguments for signal_db_gen tool
 ---@field private initialized boolean Whether the database has been initialized
+---@field private loaded boolean Whether `db_data` has been decoded from `target_file`
 ---@field private regenerate boolean Force regeneration of the database
----@field init fun(self: verilua.utils.SignalDB, params?: table): verilua.utils.SignalDB Initialize the database (generates if needed)
+---@field init fun(self: verilua.utils.SignalDB, params?: verilua.utils.SignalDB.init.params): verilua.utils.SignalDB Initialize the database (generates if needed)
+---@field get_target_file fun(self: verilua.utils.SignalDB): string Get the path of the generated database file
 ---@field set_extra_args fun(self: verilua.utils.SignalDB, args_str: string): verilua.utils.SignalDB Set extra arguments for signal_db_gen (replaces existing)
 ---@field add_extra_args fun(self: verilua.utils.SignalDB, args_str: string): verilua.utils.SignalDB Add extra arguments for signal_db_gen (appends to existing)
 ---@field set_regenerate fun(self: verilua.utils.SignalDB, regenerate: boolean): verilua.utils.SignalDB Set whether to force regenerate the database
@@ -123,6 +128,7 @@ local cfg = _G.cfg
 ---@field find_all fun(self: verilua.utils.SignalDB, pattern: string): string[] Find all signals and hierarchies matching wildcard pattern
 ---@field find_hier fun(self: verilua.utils.SignalDB, hier_pattern: string): string[] Find all hierarchies matching wildcard pattern
 ---@field find_signal fun(self: verilua.utils.SignalDB, signal_pattern: string, hier_pattern?: string, full_info?: boolean): string[] | verilua.utils.SignalInfo[] Find signals matching pattern, optionally filtered by hierarchy
+---@field record_access_profile fun(self: verilua.utils.SignalDB, signal_pattern: string, hier_pattern?: string): integer Add matching signals to the access profile being recorded (`VL_ACCESS_PROFILE`)
 ---@field auto_bundle fun(self: verilua.utils.SignalDB, hier_path: string, params: verilua.utils.SignalDB.auto_bundle.params): verilua.handles.Bundle Automatically create a Bundle from signals matching criteria
 local SignalDB = {
     db_data = {},
@@ -132,6 +138,7 @@ local SignalDB = {
     rtl_filelist = "dut_file.f",
     extra_signal_db_gen_args = "",
     initialized = false,
+    loaded = false,
     regenerate = false,
 }
 
@@ -160,14 +167,20 @@ end
 --- This method will generate the database if it doesn't exist or if regenerate is set.
 --- The database is generated using the signal_db_gen tool from RTL files.
 ---
---- @param _params table? Optional parameters (currently unused, reserved for future use)
+--- With `lazy_load = true` the database is only generated (or found up to
+--- date), decoding it into Lua tables is deferred to the first `get_db_data`.
+--- nosim uses this to resolve handles through the `<target_file>.idx` index
+--- without ever decoding the database.
+---
+--- @param params verilua.utils.SignalDB.init.params? Optional parameters
 --- @return verilua.utils.SignalDB Returns self for method chaining
 ---
 --- Usage:
 --- ```lua
 --- SignalDB:set_rtl_filelist("my_rtl.f"):init()
+--- SignalDB:init({ lazy_load = true })
 --- ```
-function SignalDB:init(_params)
+function SignalDB:init(params)
     if self.initialized and not self.regenerate then
         return self
     end
@@ -212,7 +225,10 @@ function SignalDB:init(_params)
         self:generate_db(nosim_cmdline_args)
     end
 
-    self:load_db(self.target_file)
+    self.loaded = false
+    if not (params and params.lazy_load) then
+        self:load_db(self.target_file)
+    end
 
     self.initialized = true
 
@@ -367,6 +383,7 @@ function SignalDB:load_db(file_path)
         local data = file:read("*a")
         file:close()
         self.db_data = sb.decode(data) --[[@as table]]
+        self.loaded = true
     else
         error("[SignalDB] [load_db] Failed to open `" .. file_path .. "`")
     end
@@ -389,9 +406,21 @@ function SignalDB:get_db_data()
         self:init()
     end
 
+    if not self.loaded then
+        self:load_db(self.target_file)
+    end
+
     return self.db_data
 end
 
+--- Get the path of the generated database file.
+--- The lookup index used by nosim is written next to it as `<target_file>.idx`.
+---
+--- @return string The database file path
+function SignalDB:get_target_file()
+    return self.target_file
+end
+
 local SIGNALDB_SUCCESS = 0
 local SIGNALDB_NO_NEED_GEN = 1
 local SIGNALDB_EXCEPTION_OCCURRED = 2
@@ -700,6 +729,25 @@ function SignalDB:find_signal(signal_pattern, hier_pattern, full_info)
     return ret
 end
 
+---Add all signals matching the pattern to the access profile being recorded (`VL_ACCESS_PROFILE`),
+---e.g. signals only reached through a debug path that a profiling run does not exercise.
+---`vl-gen-vlt` then makes them public together with the signals the run accessed.
+---Does nothing if no access profile is being recorded.
+---
+---@param signal_pattern string Wildcard pattern to match signal names (supports * and ? wildcards)
+---@param hier_pattern? string Optional wildcard pattern to filter by hierarchy path
+---@return integer count Number of matched signals
+function SignalDB:record_access_profile(signal_pattern, hier_pattern)
+    -- Required here, `VpimlNosim` requires SignalDB
+    local vpiml = require "verilua.vpiml.vpiml"
+
+    local paths = self:find_signal(signal_pattern, hier_pattern) --[[@as string[] ]]
+    for _, path in ipairs(paths) do
+        vpiml.vpiml_access_profile_add(path)
+    end
+    return #paths
+end
+
 --- Default filter function for auto_bundle that accepts all signals.
 ---@param _signal_name string The signal name (unused)
 ---@param _signal_bitwidth number The signal bit width (unused)
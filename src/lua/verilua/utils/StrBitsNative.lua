@@ -0,0 +1,115 @@
+local ffi = require "ffi"
+
+local math_max = math.max
+local math_floor = math.floor
+local ffi_new = ffi.new
+local ffi_string = ffi.string
+
+-- Native kernels of `verilua.utils.StrBitsUtils` (`src/str_bits`, built as libstr_bits.so).
+-- Keep in sync with `src/str_bits/str_bits.h`.
+pcall(ffi.cdef, [[
+    int str_bits_parse_hex(const char *s, size_t len, uint64_t *out, size_t nlimbs);
+    size_t str_bits_format_hex(const uint64_t *a, size_t n, size_t nchars, char *out);
+    void str_bits_and(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+    void str_bits_or(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+    void str_bits_xor(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+    void str_bits_not(uint64_t *dst, const uint64_t *a, size_t n);
+    uint64_t str_bits_add(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+    void str_bits_shl(uint64_t *dst, const uint64_t *a, size_t n, size_t shift);
+    void str_bits_shr(uint64_t *dst, const uint64_t *a, size_t n, size_t shift);
+    void str_bits_mask(uint64_t *a, size_t n, size_t nbits);
+    void str_bits_extract(uint64_t *dst, size_t dn, const uint64_t *a, size_t n, size_t s, size_t width);
+    void str_bits_insert(uint64_t *a, size_t n, size_t s, size_t width, const uint64_t *v, size_t vn);
+    size_t str_bits_popcount(const uint64_t *a, size_t n);
+]])
+
+--- Values wider than this many limbs (64 Mbit) are left to the pure-Lua implementations
+--- instead of growing the scratch buffers without bound.
+local MAX_LIMBS = 1024 * 1024
+
+---@class (exact) verilua.utils.StrBitsNative
+---@field lib any? The loaded libstr_bits, nil if it is not available
+---@field MAX_LIMBS integer
+---@field a ffi.cdata* Scratch limb buffers, at least `cap` limbs each
+---@field b ffi.cdata*
+---@field r ffi.cdata*
+---@field cap integer
+---@field chars ffi.cdata* Scratch character buffer, at least `cap * 16` characters
+local M = {
+    lib = nil,
+    MAX_LIMBS = MAX_LIMBS,
+    cap = 0,
+}
+
+-- Try $VERILUA_HOME/shared/libstr_bits.so first, then the system LD_LIBRARY_PATH.
+-- `VL_STR_BITS_NATIVE=0` keeps StrBitsUtils on its pure-Lua implementations.
+local function load_lib()
+    if os.getenv("VL_STR_BITS_NATIVE") == "0" then
+        return nil
+    end
+
+    local verilua_home = os.getenv("VERILUA_HOME")
+    if verilua_home then
+        local ok, lib = pcall(ffi.load, verilua_home .. "/shared/libstr_bits.so")
+        if ok then
+            return lib
+        end
+    end
+
+    local ok, lib = pcall(ffi.load, "str_bits")
+    if ok then
+        return lib
+    end
+    return nil
+end
+
+M.lib = load_lib()
+
+--- Number of limbs holding `nbits` bits, at least one.
+---@param nbits integer
+---@return integer
+function M.nlimbs(nbits)
+    return math_max(1, math_floor((nbits + 63) / 64))
+end
+
+--- Make sure the scratch buffers hold at least `nlimbs` limbs. Returns false if
+--- `nlimbs` is beyond `MAX_LIMBS`.
+---@param nlimbs integer
+---@return boolean
+function M.reserve(nlimbs)
+    if nlimbs <= M.cap then
+        return true
+    end
+    if nlimbs > MAX_LIMBS then
+        return false
+    end
+
+    local cap = math_max(nlimbs, M.cap * 2, 16)
+    M.a = ffi_new("uint64_t[?]", cap)
+    M.b = ffi_new("uint64_t[?]", cap)
+    M.r = ffi_new("uint64_t[?]", cap)
+    M.chars = ffi_new("char[?]", cap * 16)
+    M.cap = cap
+    return true
+end
+
+--- Parse `hex_str` into `buf` (`nlimbs` limbs), false if it holds a non hex digit.
+---@param hex_str string
+---@param buf ffi.cdata*
+---@param nlimbs integer
+---@return boolean
+function M.parse(hex_str, buf, nlimbs)
+    return M.lib.str_bits_parse_hex(hex_str, #hex_str, buf, nlimbs) == 0
+end
+
+--- Format `buf` (`nlimbs` limbs) as a hex string, `nchars` == 0 for the shortest form.
+---@param buf ffi.cdata*
+---@param nlimbs integer
+---@param nchars integer
+---@return string
+function M.format(buf, nlimbs, nchars)
+    local chars = M.chars
+    return ffi_string(chars, M.lib.str_bits_format_hex(buf, nlimbs, nchars, chars))
+end
+
+return M
@@ -16,6 +16,7 @@ local bit_bxor = bit.bxor
 local bit_bnot = bit.bnot
 local bit_band = bit.band
 local bit_lshift = bit.lshift
+local bit_rshift = bit.rshift
 
 local srep = string.rep
 local ssub = string.sub
@@ -1106,4 +1107,281 @@ function M.init_use_libgmp(_self)
     return M
 end
 
+--- The pure-Lua implementations. The native ones fall back to them for inputs the
+--- kernels do not take (non hex digits, non integer widths, ...), so errors and
+--- corner cases stay the same whichever implementation is in use.
+M.lua = {
+    bitfield_hex_str = M.bitfield_hex_str,
+    set_bitfield_hex_str = M.set_bitfield_hex_str,
+    lshift_hex_str = M.lshift_hex_str,
+    rshift_hex_str = M.rshift_hex_str,
+    bor_hex_str = M.bor_hex_str,
+    bxor_hex_str = M.bxor_hex_str,
+    band_hex_str = M.band_hex_str,
+    bnot_hex_str = M.bnot_hex_str,
+    add_hex_str = M.add_hex_str,
+    popcount_hex_str = M.popcount_hex_str,
+}
+
+local use_native = false
+
+---@param v any
+---@return boolean
+local function is_int(v)
+    return type(v) == "number" and v % 1 == 0
+end
+
+-- Initialize the module to use libstr_bits (`src/str_bits`) for the hex string
+-- operations. Called when the module is loaded, returns false if the library is
+-- not available (or disabled with `VL_STR_BITS_NATIVE=0`) and keeps the pure-Lua
+-- implementations in that case.
+---@param _self verilua.utils.StrBitsUtils?
+---@return boolean
+function M.init_use_native(_self)
+    if use_native then
+        return true
+    end
+
+    local sbn = require "verilua.utils.StrBitsNative"
+    local lib = sbn.lib
+    if not lib then
+        return false
+    end
+
+    use_native = true
+
+    local L = M.lua
+    local nlimbs = sbn.nlimbs
+    local reserve = sbn.reserve
+    local parse = sbn.parse
+    local format = sbn.format
+    local math_max = math.max
+
+    ---@param kernel fun(dst: ffi.cdata*, a: ffi.cdata*, b: ffi.cdata*, n: integer)
+    ---@param lua_impl fun(hex_str1: string, hex_str2: string, bitwidth: integer?): string
+    ---@return fun(hex_str1: string, hex_str2: string, bitwidth: integer?): string
+    local function native_bitwise(kernel, lua_impl)
+        return function(hex_str1, hex_str2, bitwidth)
+            local nbits
+            if bitwidth then
+                nbits = tonumber(bitwidth)
+                if not is_int(nbits) or nbits < 1 then
+                    return lua_impl(hex_str1, hex_str2, bitwidth)
+                end
+            else
+                local len1, len2 = #hex_str1, #hex_str2
+                nbits = 4 * (len1 > len2 and len1 or len2)
+            end
+
+            local nl = nlimbs(nbits)
+            if not reserve(nl) or not parse(hex_str1, sbn.a, nl) or not parse(hex_str2, sbn.b, nl) then
+                return lua_impl(hex_str1, hex_str2, bitwidth)
+            end
+
+            local r = sbn.r
+            kernel(r, sbn.a, sbn.b, nl)
+            if bitwidth then
+                lib.str_bits_mask(r, nl, nbits)
+                return format(r, nl, math_ceil(nbits / 4))
+            end
+            return format(r, nl, 0)
+        end
+    end
+
+    M.bor_hex_str = native_bitwise(lib.str_bits_or, L.bor_hex_str)
+    M.bxor_hex_str = native_bitwise(lib.str_bits_xor, L.bxor_hex_str)
+    M.band_hex_str = native_bitwise(lib.str_bits_and, L.band_hex_str)
+
+    M.bnot_hex_str = function(hex_str, bitwidth)
+        local nbits
+        if bitwidth then
+            nbits = tonumber(bitwidth)
+            if not is_int(nbits) or nbits < 1 then
+                return L.bnot_hex_str(hex_str, bitwidth)
+            end
+        else
+            nbits = 4 * #hex_str
+        end
+
+        local nl = nlimbs(nbits)
+        if not reserve(nl) or not parse(hex_str, sbn.a, nl) then
+            return L.bnot_hex_str(hex_str, bitwidth)
+        end
+
+        local r = sbn.r
+        lib.str_bits_not(r, sbn.a, nl)
+        lib.str_bits_mask(r, nl, nbits)
+        return format(r, nl, bitwidth and math_ceil(nbits / 4) or 0)
+    end
+
+    M.add_hex_str = function(hex_str1, hex_str2, bitwidth)
+        local nbits
+        if bitwidth then
+            nbits = tonumber(bitwidth)
+            if not is_int(nbits) or nbits < 1 then
+                return L.add_hex_str(hex_str1, hex_str2, bitwidth)
+            end
+        else
+            -- One more bit for the carry, the result is never truncated
+            local len1, len2 = #hex_str1, #hex_str2
+            nbits = 4 * (len1 > len2 and len1 or len2) + 1
+        end
+
+        local nl = nlimbs(nbits)
+        if not reserve(nl) or not parse(hex_str1, sbn.a, nl) or not parse(hex_str2, sbn.b, nl) then
+            return L.add_hex_str(hex_str1, hex_str2, bitwidth)
+        end
+
+        local a, b, r = sbn.a, sbn.b, sbn.r
+        if not bitwidth then
+            lib.str_bits_add(r, a, b, nl)
+            return format(r, nl, 0), false
+        end
+
+        lib.str_bits_mask(a, nl, nbits)
+        lib.str_bits_mask(b, nl, nbits)
+        local carry_out = lib.str_bits_add(r, a, b, nl)
+
+        -- Both inputs fit in `nbits` bits, so the carry is bit `nbits` of the sum
+        local carry
+        local top_bit = nbits % 64
+        if top_bit == 0 then
+            carry = carry_out ~= 0ULL
+        else
+            carry = bit_band(bit_rshift(r[(nbits - top_bit) / 64], top_bit), 1ULL) ~= 0ULL
+            lib.str_bits_mask(r, nl, nbits)
+        end
+        return format(r, nl, math_ceil(nbits / 4)), carry
+    end
+
+    M.lshift_hex_str = function(hex_str, n, bitwidth)
+        local shift = tonumber(n)
+        if shift == 0 and not bitwidth then
+            return hex_str
+        end
+
+        local nbits
+        if bitwidth then
+            nbits = tonumber(bitwidth)
+        else
+            nbits = 4 * #hex_str + (shift or 0)
+        end
+        if not is_int(shift) or shift < 0 or not is_int(nbits) or nbits < 1 then
+            return L.lshift_hex_str(hex_str, n, bitwidth)
+        end
+
+        -- With a bitwidth the digits above it are shifted out anyway and may be dropped right away
+        local nl = nlimbs(nbits)
+        if not reserve(nl) or not parse(hex_str, sbn.a, nl) then
+            return L.lshift_hex_str(hex_str, n, bitwidth)
+        end
+
+        local r = sbn.r
+        lib.str_bits_shl(r, sbn.a, nl, shift)
+        if bitwidth then
+            lib.str_bits_mask(r, nl, nbits)
+            return format(r, nl, math_ceil(nbits / 4))
+        end
+        return format(r, nl, 0)
+    end
+
+    M.rshift_hex_str = function(hex_str, n, bitwidth)
+        local shift = tonumber(n)
+        local nbits
+        if bitwidth then
+            nbits = tonumber(bitwidth)
+            if not is_int(nbits) or nbits < 1 then
+                return L.rshift_hex_str(hex_str, n, bitwidth)
+            end
+        else
+            nbits = 4 * #hex_str
+        end
+        if not is_int(shift) or shift < 0 then
+            return L.rshift_hex_str(hex_str, n, bitwidth)
+        end
+
+        local nl = nlimbs(nbits)
+        if not reserve(nl) or not parse(hex_str, sbn.a, nl) then
+            return L.rshift_hex_str(hex_str, n, bitwidth)
+        end
+
+        if shift >= nbits then
+            return "0"
+        end
+
+        local a, r = sbn.a, sbn.r
+        lib.str_bits_mask(a, nl, nbits)
+        lib.str_bits_shr(r, a, nl, shift)
+        return format(r, nl, bitwidth and math_ceil(nbits / 4) or 0)
+    end
+
+    M.bitfield_hex_str = function(hex_str, s, e, bitwidth)
+        if not is_int(s) or not is_int(e) or (bitwidth and not is_int(bitwidth)) then
+            return L.bitfield_hex_str(hex_str, s, e, bitwidth)
+        end
+
+        local src_bits = 4 * #hex_str
+        local len = src_bits
+        if bitwidth and bitwidth > len then
+            len = bitwidth
+        end
+
+        local nl = nlimbs(src_bits)
+        local width = (e < len and e or len - 1) - s + 1
+        local dn = nlimbs(width)
+        if s < 0 or e < 0 or s > len or e > len or s > e or not reserve(math_max(nl, dn)) or not parse(hex_str, sbn.a, nl) then
+            -- Raises the same errors as the pure-Lua implementation
+            return L.bitfield_hex_str(hex_str, s, e, bitwidth)
+        end
+
+        if s == len then
+            return "0"
+        end
+
+        local r = sbn.r
+        lib.str_bits_extract(r, dn, sbn.a, nl, s, width)
+        return format(r, dn, math_ceil(width / 4))
+    end
+
+    M.set_bitfield_hex_str = function(hex_str, s, e, val_hex_str, bitwidth)
+        local s_num, e_num = tonumber(s), tonumber(e)
+        if not is_int(s_num) or not is_int(e_num) or (bitwidth and not is_int(bitwidth)) then
+            return L.set_bitfield_hex_str(hex_str, s, e, val_hex_str, bitwidth)
+        end
+        ---@cast s_num integer
+        ---@cast e_num integer
+
+        local len = 4 * #hex_str
+        if bitwidth and bitwidth > len then
+            len = bitwidth
+        end
+        if not bitwidth and e_num >= len then
+            len = e_num + 1
+        end
+
+        local width = e_num - s_num + 1
+        local nl, vn = nlimbs(len), nlimbs(width)
+        if s_num < 0 or e_num < 0 or s_num >= len or e_num >= len or s_num > e_num
+            or not reserve(math_max(nl, vn)) or not parse(hex_str, sbn.a, nl) or not parse(val_hex_str, sbn.b, vn) then
+            return L.set_bitfield_hex_str(hex_str, s, e, val_hex_str, bitwidth)
+        end
+
+        local a = sbn.a
+        lib.str_bits_insert(a, nl, s_num, width, sbn.b, vn)
+        return format(a, nl, math_ceil(len / 4))
+    end
+
+    M.popcount_hex_str = function(hex_str)
+        local nl = nlimbs(4 * #hex_str)
+        if not reserve(nl) or not parse(hex_str, sbn.a, nl) then
+            return L.popcount_hex_str(hex_str)
+        end
+        return tonumber(lib.str_bits_popcount(sbn.a, nl)) --[[@as integer]]
+    end
+
+    return true
+end
+
+M.init_use_native()
+
 return M
@@ -0,0 +1,244 @@
+--- TraceReader - Read trace files written by `verilua.utils.TraceSink`
+---
+--- Decoding (LZ4 decompression, chunk parsing) is done in libverilua. Inside a
+--- simulation the already loaded libverilua is used, offline pass `lib_path`
+--- (default: `$VERILUA_HOME/shared/libverilua_nosim.so`).
+---
+--- Example usage:
+--- ```lua
+--- local TraceReader = require "verilua.utils.TraceReader"
+---
+--- local reader = TraceReader { file = "trace.vltr" }
+--- reader:foreach(function(schema, stamp, row)
+---     print(schema, stamp, row.addr, row.id)
+--- end)
+---
+--- -- One database per schema (trace_axi_aw.db, ...), any LuaDataBaseV2 backend.
+--- -- DuckDB output can be exported to Parquet with `COPY <table> TO 'x.parquet'`.
+--- TraceReader({ file = "trace.vltr" }):to_database { path = "./db", file_name = "trace.db", backend = "duckdb" }
+--- TraceReader({ file = "trace.vltr" }):to_csv "./csv"
+--- ```
+
+local ffi = require "ffi"
+local class = require "pl.class"
+local path = require "pl.path"
+local texpect = require "verilua.TypeExpect"
+
+local io = io
+local pairs = pairs
+local ipairs = ipairs
+local unpack = unpack
+local assert = assert
+local tostring = tostring
+local tonumber = tonumber
+local table_concat = table.concat
+local ffi_cast = ffi.cast
+local ffi_string = ffi.string
+
+ffi.cdef [[
+    void *verilua_trace_reader_open(const char *path);
+    int64_t verilua_trace_reader_next_chunk(void *reader);
+    const char *verilua_trace_reader_schema_name(void *reader, uint32_t id);
+    uint32_t verilua_trace_reader_field_num(void *reader, uint32_t id);
+    const char *verilua_trace_reader_field_name(void *reader, uint32_t id, uint32_t idx);
+    uint8_t verilua_trace_reader_field_type(void *reader, uint32_t id, uint32_t idx);
+    uint32_t verilua_trace_reader_row_num(void *reader);
+    const uint8_t *verilua_trace_reader_column(void *reader, uint32_t idx);
+    void verilua_trace_reader_close(void *reader);
+]]
+
+--- Field type id => pointer type of a column, must match `FieldType` in trace_sink.rs
+local COLUMN_PTR_TYPES = {
+    [0] = ffi.typeof("const uint8_t *"),
+    [1] = ffi.typeof("const uint16_t *"),
+    [2] = ffi.typeof("const uint32_t *"),
+    [3] = ffi.typeof("const uint64_t *"),
+    [4] = ffi.typeof("const double *"),
+}
+local U64_PTR = COLUMN_PTR_TYPES[3]
+
+---@param lib_path? string
+---@return ffi.namespace*
+local function load_clib(lib_path)
+    if not lib_path and pcall(function() return ffi.C.verilua_trace_reader_open end) then
+        return ffi.C
+    end
+
+    if not lib_path then
+        local verilua_home = os.getenv("VERILUA_HOME")
+        assert(verilua_home, "[TraceReader] environment variable `VERILUA_HOME` is not set!")
+        lib_path = verilua_home .. "/shared/libverilua_nosim.so"
+    end
+    return ffi.load(lib_path)
+end
+
+---@class (exact) verilua.utils.TraceReader.params
+---@field file string Trace file path
+---@field lib_path? string libverilua to load when not running inside a simulation
+
+---@class (exact) verilua.utils.TraceReader.Schema
+---@field name string
+---@field fields string[]
+---@field types integer[]
+
+---@class (exact) verilua.utils.TraceReader
+---@overload fun(params: verilua.utils.TraceReader.params): verilua.utils.TraceReader
+---@field file string
+---@field private clib ffi.namespace*
+---@field private schemas table<integer, verilua.utils.TraceReader.Schema>
+local TraceReader = class()
+
+function TraceReader:_init(params)
+    texpect.expect_table(params, "params")
+    texpect.expect_string(params.file, "params.file")
+
+    self.file = params.file
+    self.clib = load_clib(params.lib_path)
+    self.schemas = {}
+end
+
+---@private
+---@param reader ffi.cdata*
+---@param id integer
+---@return verilua.utils.TraceReader.Schema
+function TraceReader:_schema(reader, id)
+    local schema = self.schemas[id]
+    if not schema then
+        local clib = self.clib
+        schema = { name = ffi_string(clib.verilua_trace_reader_schema_name(reader, id)), fields = {}, types = {} }
+        for i = 1, clib.verilua_trace_reader_field_num(reader, id) do
+            schema.fields[i] = ffi_string(clib.verilua_trace_reader_field_name(reader, id, i - 1))
+            schema.types[i] = clib.verilua_trace_reader_field_type(reader, id, i - 1)
+        end
+        self.schemas[id] = schema
+    end
+    return schema
+end
+
+--- Iterate over the chunks of the file. `chunk_func` gets the schema, the row
+--- number and the columns (`columns[0]` = stamps, `columns[i]` = field `i`),
+--- which are only valid during the call.
+---@param chunk_func fun(schema: verilua.utils.TraceReader.Schema, row_num: integer, columns: table<integer, ffi.cdata*>)
+function TraceReader:foreach_chunk(chunk_func)
+    local clib = self.clib
+    local reader = clib.verilua_trace_reader_open(self.file)
+    assert(reader ~= nil, "[TraceReader] cannot open trace file: " .. self.file)
+
+    local columns = {}
+    while true do
+        local id = tonumber(clib.verilua_trace_reader_next_chunk(reader)) --[[@as integer]]
+        if id < 0 then
+            clib.verilua_trace_reader_close(reader)
+            assert(id == -1, "[TraceReader] corrupted trace file: " .. self.file)
+            break
+        end
+
+        local schema = self:_schema(reader, id)
+        columns[0] = ffi_cast(U64_PTR, clib.verilua_trace_reader_column(reader, 0))
+        for i = 1, #schema.fields do
+            columns[i] = ffi_cast(COLUMN_PTR_TYPES[schema.types[i]], clib.verilua_trace_reader_column(reader, i))
+        end
+
+        chunk_func(schema, clib.verilua_trace_reader_row_num(reader), columns)
+    end
+end
+
+--- Iterate over every record in file order within each schema. `row` is reused
+--- between calls, `u64` values are `uint64_t` cdata.
+---@param row_func fun(schema_name: string, stamp: uint64_t, row: table<string, integer|uint64_t|number>)
+function TraceReader:foreach(row_func)
+    local row = {}
+    self:foreach_chunk(function(schema, row_num, columns)
+        local fields = schema.fields
+        for r = 0, row_num - 1 do
+            for i = 1, #fields do
+                row[fields[i]] = columns[i][r]
+            end
+            row_func(schema.name, columns[0][r], row)
+        end
+    end)
+end
+
+--- Convert the trace into one `LuaDataBaseV2` database per schema, named
+--- `<root>_<schema><ext>` after `params.file_name` (table `<schema>`, columns
+--- `stamp` + fields, all INTEGER except `f64` fields which are REAL). `params` are forwarded to
+--- `LuaDataBaseV2` (`path`, `file_name`, `backend`, ...); `u64` values above 2^53
+--- lose precision. Like `LuaDataBaseV2`, this needs the verilua runtime (e.g. a
+--- nosim script or the end of a simulation).
+---@param params table LuaDataBaseV2 params without `table_name` / `elements`
+function TraceReader:to_database(params)
+    local LuaDataBaseV2 = require "verilua.utils.LuaDataBaseV2"
+    local dbs = {}
+
+    self:foreach_chunk(function(schema, row_num, columns)
+        local db = dbs[schema.name]
+        if not db then
+            local elements = { "stamp => INTEGER" }
+            for i, field in ipairs(schema.fields) do
+                elements[i + 1] = field .. (schema.types[i] == 4 and " => REAL" or " => INTEGER")
+            end
+
+            local db_params = {}
+            for k, v in pairs(params) do
+                db_params[k] = v
+            end
+            -- LuaDataBaseV2 recreates its file, so every schema gets its own `<root>_<schema><ext>`
+            local root, ext = path.splitext(params.file_name or "trace.db")
+            db_params.file_name = root .. "_" .. schema.name .. ext
+            db_params.table_name = schema.name
+            db_params.elements = elements
+            db = LuaDataBaseV2(db_params)
+            dbs[schema.name] = db
+        end
+
+        local n = #schema.fields
+        local values = {}
+        for r = 0, row_num - 1 do
+            values[1] = tonumber(columns[0][r])
+            for i = 1, n do
+                values[i + 1] = tonumber(columns[i][r])
+            end
+            db:save(unpack(values, 1, n + 1))
+        end
+    end)
+
+    for _, db in pairs(dbs) do
+        db:clean_up()
+    end
+end
+
+--- Write one `<schema>.csv` per schema into `dir`
+---@param dir string
+function TraceReader:to_csv(dir)
+    texpect.expect_string(dir, "dir")
+    if not path.isdir(dir) then
+        assert(path.mkdir(dir), "[TraceReader] cannot create directory: " .. dir)
+    end
+
+    local files = {}
+    self:foreach_chunk(function(schema, row_num, columns)
+        local file = files[schema.name]
+        if not file then
+            local file_path = path.join(dir, schema.name .. ".csv")
+            file = assert(io.open(file_path, "w"), "[TraceReader] cannot open file: " .. file_path)
+            file:write("stamp,", table_concat(schema.fields, ","), "\n")
+            files[schema.name] = file
+        end
+
+        local n = #schema.fields
+        local parts = {}
+        for r = 0, row_num - 1 do
+            parts[1] = (tostring(columns[0][r]):gsub("ULL$", ""))
+            for i = 1, n do
+                parts[i + 1] = (tostring(columns[i][r]):gsub("ULL$", ""))
+            end
+            file:write(table_concat(parts, ","), "\n")
+        end
+    end)
+
+    for _, file in pairs(files) do
+        file:close()
+    end
+end
+
+return TraceReader
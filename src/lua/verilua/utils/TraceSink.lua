@@ -0,0 +1,182 @@
+--- TraceSink - Binary transaction trace written by a background thread
+---
+--- Logging every transaction through `Logger` or `LuaDataBaseV2` formats a
+--- string or binds a SQL row on the simulation thread. A TraceSink record is a
+--- packed FFI struct copied into a lock-free ring in libverilua; a background
+--- thread splits the records into columns, compresses them (LZ4) and writes
+--- them to a chunked trace file. Use `verilua.utils.TraceReader` to convert the
+--- file to SQLite/DuckDB/CSV after the simulation.
+---
+--- Field types: `u8`, `u16`, `u32`, `u64`, `f64`. Every record carries a `u64`
+--- stamp (e.g. the cycle count) in addition to its fields.
+---
+--- Example usage:
+--- ```lua
+--- local TraceSink = require "verilua.utils.TraceSink"
+---
+--- local sink = TraceSink { file = "trace.vltr" }
+--- local aw = sink:schema("axi_aw", { "addr => u64", "id => u16", "len => u8" })
+---
+--- aw:log(cycles, addr, id, len)
+---
+--- sink:close() -- optional, done automatically at the end of the simulation
+--- ```
+
+local ffi = require "ffi"
+local class = require "pl.class"
+local stringx = require "pl.stringx"
+local table_new = require "table.new"
+local utils = require "verilua.LuaUtils"
+local texpect = require "verilua.TypeExpect"
+
+local C = ffi.C
+local assert = assert
+local ipairs = ipairs
+local f = string.format
+local table_concat = table.concat
+
+ffi.cdef [[
+    void *verilua_trace_open(const char *path, uint64_t ring_size);
+    int32_t verilua_trace_add_schema(void *sink, const char *name, const char **field_names, const uint8_t *field_types, uint32_t field_num);
+    int32_t verilua_trace_append(void *sink, uint32_t id, uint64_t stamp, const void *data);
+    bool verilua_trace_close(void *sink);
+]]
+
+--- Field type name => { type id, C type }, must match `FieldType` in trace_sink.rs
+local FIELD_TYPES = {
+    u8 = { 0, "uint8_t" },
+    u16 = { 1, "uint16_t" },
+    u32 = { 2, "uint32_t" },
+    u64 = { 3, "uint64_t" },
+    f64 = { 4, "double" },
+}
+
+--- Names used by the generated `log()` function
+local RESERVED_NAMES = {
+    this = true, stamp = true, sink = true, sink_ref = true, record = true, append = true, assert = true,
+}
+
+---@class (exact) verilua.utils.TraceSink.params
+---@field file string Trace file path
+---@field ring_size? integer Ring buffer size in bytes, Default: 16 MiB
+
+---@class (exact) verilua.utils.TraceSink.Schema
+---@field name string
+---@field fields string[]
+---@field log fun(self: verilua.utils.TraceSink.Schema, stamp: integer|uint64_t, ...: integer|uint64_t|number)
+
+---@class (exact) verilua.utils.TraceSink
+---@overload fun(params: verilua.utils.TraceSink.params): verilua.utils.TraceSink
+---@field __type string
+---@field file string
+---@field private _sink ffi.cdata*?
+---@field private _schemas table<string, verilua.utils.TraceSink.Schema>
+local TraceSink = class()
+
+function TraceSink:_init(params)
+    texpect.expect_table(params, "params")
+    texpect.expect_string(params.file, "params.file")
+
+    self.__type = "TraceSink"
+    self.file = params.file
+    self._schemas = {}
+
+    local sink = C.verilua_trace_open(self.file, params.ring_size or 0)
+    assert(sink ~= nil, "[TraceSink] cannot open trace file: " .. self.file)
+    self._sink = sink
+
+    final {
+        function()
+            self:close()
+        end
+    }
+end
+
+--- Register a record type. `elements` uses the same syntax as `LuaDataBaseV2`:
+--- `"<name> => <type>"` or `{ name = <name>, type = <type> }`.
+---@param name string
+---@param elements (string|{name: string, type: string})[]
+---@return verilua.utils.TraceSink.Schema
+function TraceSink:schema(name, elements)
+    texpect.expect_string(name, "name")
+    texpect.expect_table(elements, "elements")
+    assert(self._sink, "[TraceSink] schema() called on closed sink: " .. self.file)
+    assert(not self._schemas[name], "[TraceSink] duplicate schema: " .. name)
+
+    local n = #elements
+    assert(n > 0, "[TraceSink] schema `" .. name .. "` has no field")
+
+    local field_names = table_new(n, 0)
+    local c_fields = table_new(n, 0)
+    local c_names = ffi.new("const char *[?]", n)
+    local c_types = ffi.new("uint8_t[?]", n)
+    for i, e in ipairs(elements) do
+        local field_name, field_type
+        if type(e) == "table" then
+            field_name, field_type = e.name, e.type
+        else
+            local parts = stringx.split(e, "=>")
+            assert(#parts == 2, f("[TraceSink] invalid element `%s`, expected `<name> => <type>`", e))
+            field_name, field_type = stringx.strip(parts[1]), stringx.strip(parts[2])
+        end
+
+        local t = FIELD_TYPES[field_type:lower()]
+        assert(t, f("[TraceSink] unknown type `%s` of field `%s`, expected u8/u16/u32/u64/f64", field_type, field_name))
+        assert(field_name:match("^[%a_][%w_]*$"), f("[TraceSink] invalid field name `%s`", field_name))
+        assert(not RESERVED_NAMES[field_name], f("[TraceSink] field name `%s` is reserved", field_name))
+
+        field_names[i] = field_name
+        c_fields[i] = t[2] .. " " .. field_name .. ";"
+        c_names[i - 1] = field_names[i]
+        c_types[i - 1] = t[1]
+    end
+
+    local id = C.verilua_trace_add_schema(self._sink, name, c_names, c_types, n)
+    assert(id >= 0, "[TraceSink] failed to register schema (invalid field type, or a record larger than the ring): " .. name)
+
+    -- One packed record, filled field by field and copied into the ring by `verilua_trace_append`
+    local record = ffi.new(ffi.typeof("struct __attribute__((packed)) { " .. table_concat(c_fields, " ") .. " }"))
+
+    -- e.g.
+    --      log = function(this, stamp, addr, id)
+    --          record.addr = addr
+    --          record.id = id
+    --          if append(sink_ref._sink, 0, stamp, record) ~= 0 then ... end
+    --      end
+    local args = table_concat(field_names, ", ")
+    local assigns = {}
+    for i, field_name in ipairs(field_names) do
+        assigns[i] = f("record.%s = %s", field_name, field_name)
+    end
+    local log_func = utils.loadcode(
+        f([[
+            return function(this, stamp, %s)
+                local sink = sink_ref._sink
+                if sink == nil then
+                    assert(false, "[TraceSink] log() called on closed sink: " .. sink_ref.file)
+                end
+                %s
+                if append(sink, %d, stamp, record) ~= 0 then
+                    assert(false, "[TraceSink] log() failed, the trace writer stopped on an error: " .. sink_ref.file)
+                end
+            end
+        ]], args, table_concat(assigns, "\n                "), id),
+        { record = record, append = C.verilua_trace_append, sink_ref = self, assert = assert },
+        "TraceSink:" .. name .. ":log()"
+    )
+
+    local schema = { name = name, fields = field_names, log = log_func }
+    self._schemas[name] = schema
+    return schema
+end
+
+--- Flush all records and close the trace file
+function TraceSink:close()
+    if self._sink then
+        local ok = C.verilua_trace_close(self._sink)
+        self._sink = nil
+        assert(ok, "[TraceSink] failed to write trace file: " .. self.file)
+    end
+end
+
+return TraceSink
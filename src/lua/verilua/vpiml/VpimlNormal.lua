@@ -24,6 +24,9 @@ ffi.cdef [[
     long long vpiml_handle_by_name_safe(void *env, const char* name);
     long long vpiml_handle_by_index(void *env, long long hdl, int index);
 
+    void vpiml_access_profile_add(const char *path);
+    const char *vpiml_access_profile_hint(const char *path);
+
     const char *vpiml_get_hdl_type(long long handle);
     unsigned int vpiml_get_signal_width(long long handle);
 
@@ -120,6 +123,27 @@ ffi.cdef [[
     void vpiml_native_clock_stop(void *handle);
     uint8_t vpiml_native_clock_is_running(void *handle);
     void vpiml_native_clock_destroy(void *handle);
+
+    // NativeCond functions
+    void* vpiml_native_cond_new(const uint64_t *words, uint32_t op_num);
+    uint8_t vpiml_native_cond_eval(void *env, void *handle);
+    void vpiml_native_cond_wait(void *handle, int64_t clock_raw, uint8_t edge_type, uint64_t max_cycles, int task_id);
+    int64_t vpiml_native_cond_result(int task_id);
+    uint8_t vpiml_native_cond_cancel(int task_id);
+    void vpiml_native_cond_destroy(void *handle);
+
+    // HandleGroup functions
+    void* vpiml_handle_group_new(const int64_t *handles, uint32_t n);
+    uint32_t vpiml_handle_group_word_num(void *group);
+    uint32_t vpiml_handle_group_offset(void *group, uint32_t idx);
+    void vpiml_handle_group_get_all(void *group, uint32_t *buf);
+    void vpiml_handle_group_set_all(void *group, const uint32_t *buf);
+    void vpiml_handle_group_set_layout(void *group, const uint32_t *byte_offsets, const uint32_t *byte_sizes);
+    void vpiml_handle_group_get_struct(void *group, void *out);
+    void vpiml_handle_group_set_struct(void *group, const void *inp);
+    void vpiml_handle_group_set_fire(void *group, int32_t valid_idx, int32_t ready_idx);
+    uint8_t vpiml_handle_group_fire(void *group);
+    void vpiml_handle_group_destroy(void *group);
 ]]
 
 ---@class verilua.vpiml.VpimlNormal
@@ -157,7 +181,8 @@ local vpiml = {
     vpiml_handle_by_name = function(name)
         local hdl = C.vpiml_handle_by_name_safe(env, name)
         if hdl == -1 then
-            assert(false, "[VpimlNormal] No handle found: " .. name)
+            local hint = ffi.string(C.vpiml_access_profile_hint(name))
+            assert(false, "[VpimlNormal] No handle found: " .. name .. (hint == "" and "" or ("\n" .. hint)))
         end
         return hdl
     end,
@@ -165,6 +190,13 @@ local vpiml = {
     ---@type fun(hdl: verilua.handles.ComplexHandleRaw, idx: integer): verilua.handles.ComplexHandleRaw
     vpiml_handle_by_index = function(hdl, idx) return C.vpiml_handle_by_index(env, hdl, idx) end,
 
+    --- Add `path` to the access profile being recorded (`VL_ACCESS_PROFILE`), no-op otherwise.
+    ---@type fun(path: string)
+    vpiml_access_profile_add = C.vpiml_access_profile_add,
+    --- Why `path` may be missing when the model was built from an access profile, `""` if there is nothing to add.
+    ---@type fun(path: string): string
+    vpiml_access_profile_hint = function(path) return ffi.string(C.vpiml_access_profile_hint(path)) end,
+
     ---@type fun(handle: verilua.handles.ComplexHandleRaw): string
     vpiml_get_hdl_type = C.vpiml_get_hdl_type,
     ---@type fun(handle: verilua.handles.ComplexHandleRaw): integer
@@ -359,6 +391,47 @@ local vpiml = {
     vpiml_native_clock_is_running = C.vpiml_native_clock_is_running,
     ---@type fun(handle: ffi.cdata*)
     vpiml_native_clock_destroy = C.vpiml_native_clock_destroy,
+
+    -- NativeCond functions
+    ---@type fun(words: ffi.cdata*, op_num: integer): ffi.cdata*
+    vpiml_native_cond_new = C.vpiml_native_cond_new,
+    ---@type fun(handle: ffi.cdata*): integer
+    vpiml_native_cond_eval = function(handle) return C.vpiml_native_cond_eval(env, handle) end,
+    ---@type fun(handle: ffi.cdata*, clock_raw: verilua.handles.ComplexHandleRaw, edge_type: integer, max_cycles: integer, task_id: integer)
+    vpiml_native_cond_wait = C.vpiml_native_cond_wait,
+    --- Returned as a Lua number (`int64_t` would be boxed)
+    ---@type fun(task_id: integer): integer
+    vpiml_native_cond_result = function(task_id)
+        return tonumber(C.vpiml_native_cond_result(task_id)) --[[@as integer]]
+    end,
+    ---@type fun(task_id: integer): integer
+    vpiml_native_cond_cancel = C.vpiml_native_cond_cancel,
+    ---@type fun(handle: ffi.cdata*)
+    vpiml_native_cond_destroy = C.vpiml_native_cond_destroy,
+
+    -- HandleGroup functions
+    ---@type fun(handles: ffi.cdata*, n: integer): ffi.cdata*
+    vpiml_handle_group_new = C.vpiml_handle_group_new,
+    ---@type fun(group: ffi.cdata*): integer
+    vpiml_handle_group_word_num = C.vpiml_handle_group_word_num,
+    ---@type fun(group: ffi.cdata*, idx: integer): integer
+    vpiml_handle_group_offset = C.vpiml_handle_group_offset,
+    ---@type fun(group: ffi.cdata*, buf: ffi.cdata*)
+    vpiml_handle_group_get_all = C.vpiml_handle_group_get_all,
+    ---@type fun(group: ffi.cdata*, buf: ffi.cdata*)
+    vpiml_handle_group_set_all = C.vpiml_handle_group_set_all,
+    ---@type fun(group: ffi.cdata*, byte_offsets: ffi.cdata*, byte_sizes: ffi.cdata*)
+    vpiml_handle_group_set_layout = C.vpiml_handle_group_set_layout,
+    ---@type fun(group: ffi.cdata*, out: ffi.cdata*)
+    vpiml_handle_group_get_struct = C.vpiml_handle_group_get_struct,
+    ---@type fun(group: ffi.cdata*, inp: ffi.cdata*)
+    vpiml_handle_group_set_struct = C.vpiml_handle_group_set_struct,
+    ---@type fun(group: ffi.cdata*, valid_idx: integer, ready_idx: integer)
+    vpiml_handle_group_set_fire = C.vpiml_handle_group_set_fire,
+    ---@type fun(group: ffi.cdata*): integer
+    vpiml_handle_group_fire = C.vpiml_handle_group_fire,
+    ---@type fun(group: ffi.cdata*)
+    vpiml_handle_group_destroy = C.vpiml_handle_group_destroy,
 }
 
 return vpiml
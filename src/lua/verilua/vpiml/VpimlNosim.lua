@@ -1,10 +1,33 @@
 ---@diagnostic disable: unnecessary-assert
 
+local ffi = require "ffi"
 local SignalDB = require "verilua.utils.SignalDB"
-SignalDB:init()
+
+-- Decoding the DB into Lua tables is the slow part of startup on large
+-- designs, so only generate it here and resolve handles through the
+-- memory-mapped `<target_file>.idx` index inside the nosim binary
+SignalDB:init({ lazy_load = true })
 
 local f = string.format
 
+ffi.cdef [[
+    int nosim_signal_index_open(const char *path);
+    const char *nosim_signal_index_top();
+    void *vpi_handle_by_name(char *name, void *scope);
+    int vpi_get(int property, void *object);
+]]
+
+local vpiType = 1
+local vpiSize = 4
+local vpiReg = 48
+
+-- Falls back to the Lua DB if the index is missing (e.g. a DB generated by an
+-- older signal_db_gen) or the nosim binary does not export the index functions
+local index_ok, index_opened = pcall(function()
+    return ffi.C.nosim_signal_index_open(SignalDB:get_target_file() .. ".idx")
+end)
+local use_index = index_ok and index_opened == 1
+
 local vpiml = {}
 
 ---@type table<integer, verilua.utils.SignalInfo>
@@ -22,6 +45,11 @@ local function alloc_handle(signal_info)
 end
 
 vpiml.vpiml_get_top_module = function()
+    if use_index then
+        local top = ffi.string(ffi.C.nosim_signal_index_top())
+        assert(top ~= "", "[VpimlNosim] [vpiml_get_top_module] No top module found in the signal index")
+        return top
+    end
     return SignalDB:get_top_module()
 end
 
@@ -38,6 +66,14 @@ vpiml.vpiml_handle_by_name = function(name)
 end
 
 vpiml.vpiml_handle_by_name_safe = function(name)
+    if use_index then
+        local handle = ffi.C.vpi_handle_by_name(ffi.cast("char *", name), nil)
+        if handle == nil then
+            return -1
+        end
+        return tonumber(ffi.cast("uintptr_t", handle)) --[[@as integer]]
+    end
+
     local signal_info = SignalDB:get_signal_info(name)
     if not signal_info then
         return -1
@@ -45,13 +81,28 @@ vpiml.vpiml_handle_by_name_safe = function(name)
     return alloc_handle(signal_info)
 end
 
+-- There is no model to make signals public in, access profiles do not apply
+vpiml.vpiml_access_profile_add = function(_path) end
+
+vpiml.vpiml_access_profile_hint = function(_path)
+    return ""
+end
+
 vpiml.vpiml_get_hdl_type = function(handle)
+    if use_index then
+        return ffi.C.vpi_get(vpiType, ffi.cast("void *", handle)) == vpiReg and "vpiReg" or "vpiNet"
+    end
+
     local signal_info = handle_to_signal_info_map[handle]
     assert(signal_info, f("[VpimlNosim] [vpiml_get_hdl_type] No signal info found for handle `%d`", handle))
     return signal_info[3]
 end
 
 vpiml.vpiml_get_signal_width = function(handle)
+    if use_index then
+        return ffi.C.vpi_get(vpiSize, ffi.cast("void *", handle))
+    end
+
     local signal_info = handle_to_signal_info_map[handle]
     assert(signal_info, f("[VpimlNosim] [vpiml_get_signal_width] No signal info found for handle `%d`", handle))
     return signal_info[2]
@@ -1,11 +1,24 @@
 #include "vpi_compat.h"
+#include "signal_db_index.h"
 #include "vpi_user.h"
+#include <cstring>
 #include <memory>
+#include <string>
 
 namespace vpi_compat {
 std::unique_ptr<s_cb_data> startOfSimulationCb = nullptr;
 std::unique_ptr<s_cb_data> endOfSimulationCb   = nullptr;
 
+// Memory-mapped `<signal_db>.idx`, handles are pointers to its entries
+signal_db_index::Reader signalIndex;
+// Top module of `signalIndex`, set whenever the index is (re)opened
+std::string signalIndexTop;
+
+const signal_db_index::Entry *toEntry(vpiHandle object) {
+    ASSERT(signalIndex.owns(object), "Invalid handle, not created by vpi_handle_by_name");
+    return reinterpret_cast<const signal_db_index::Entry *>(object);
+}
+
 void startOfSimulation() {
     if (startOfSimulationCb != nullptr) {
         startOfSimulationCb->cb_rtn(startOfSimulationCb.get());
@@ -25,6 +38,24 @@ void endOfSimulation() {
 
 using namespace vpi_compat;
 
+// Called by VpimlNosim (through ffi.C, the binary is linked with -rdynamic)
+// once the signal DB is up to date. Returns 1 if the index can be used.
+extern "C" int nosim_signal_index_open(const char *path) {
+    signalIndexTop.clear();
+    if (!signalIndex.open(path)) {
+        return 0;
+    }
+    // First component of the (sorted) hierarchical paths
+    if (signalIndex.count() > 0) {
+        auto name      = signalIndex.name(*signalIndex.begin());
+        signalIndexTop = std::string(name.substr(0, name.find('.')));
+    }
+    return 1;
+}
+
+// Top module of the opened index, "" if the index is empty or not opened
+extern "C" const char *nosim_signal_index_top() { return signalIndexTop.c_str(); }
+
 PLI_INT32 vpi_free_object(vpiHandle object) {
     // PANIC("vpi_free_object not implemented");
     return 0;
@@ -65,18 +96,42 @@ vpiHandle vpi_scan(vpiHandle iterator) {
 }
 
 PLI_BYTE8 *vpi_get_str(PLI_INT32 property, vpiHandle object) {
-    PANIC("vpi_get_str not implemented");
+    auto entry = toEntry(object);
+    switch (property) {
+    case vpiFullName:
+        return const_cast<PLI_BYTE8 *>(signalIndex.cname(*entry));
+    case vpiName: {
+        auto name = signalIndex.cname(*entry);
+        auto dot  = std::strrchr(name, '.');
+        return const_cast<PLI_BYTE8 *>(dot ? dot + 1 : name);
+    }
+    case vpiType:
+        return const_cast<PLI_BYTE8 *>(entry->type == vpiReg ? "vpiReg" : "vpiNet");
+    default:
+        PANIC("vpi_get_str property {} not implemented", property);
+    }
     return nullptr;
 }
 
 PLI_INT32 vpi_get(PLI_INT32 property, vpiHandle object) {
-    PANIC("vpi_get not implemented");
+    auto entry = toEntry(object);
+    switch (property) {
+    case vpiSize:
+        return static_cast<PLI_INT32>(entry->width);
+    case vpiType:
+        return static_cast<PLI_INT32>(entry->type);
+    default:
+        PANIC("vpi_get property {} not implemented", property);
+    }
     return 0;
 }
 
 vpiHandle vpi_handle_by_name(PLI_BYTE8 *name, vpiHandle scope) {
-    PANIC("vpi_handle_by_name not implemented");
-    return nullptr;
+    ASSERT(signalIndex.isOpen(), "vpi_handle_by_name: signal index is not opened");
+    ASSERT(scope == nullptr, "vpi_handle_by_name: scope is not supported");
+
+    auto entry = signalIndex.find(name);
+    return reinterpret_cast<vpiHandle>(const_cast<signal_db_index::Entry *>(entry));
 }
 
 void vpi_get_value(vpiHandle expr, p_vpi_value value_p) { PANIC("vpi_get_value not implemented"); }
@@ -37,6 +37,9 @@ target("nosim", function()
         "-Wl,--no-as-needed"
     )
 
+    -- Export `nosim_signal_index_open` / `vpi_*` to LuaJIT `ffi.C`
+    add_ldflags("-rdynamic")
+
     add_links("fmt")
     add_linkdirs(path.join(libs_dir, "lib"))
     add_rpathdirs(path.join(libs_dir, "lib"))
@@ -5,6 +5,18 @@
 int main(int argc, char **argv) {
     try {
         OS::setupConsole();
+
+        // Up to date: skip creating the slang driver and the Lua state
+        std::string argList;
+        for (int i = 0; i < argc; i++) {
+            argList += argv[i];
+            argList += " ";
+        }
+        if (tryReuseSignalDB(argList)) {
+            // SIGNALDB_NO_NEED_GEN = 1
+            return 1;
+        }
+
         WrappedDriver wDriver;
 
         // Parse command line to get `outfile` option
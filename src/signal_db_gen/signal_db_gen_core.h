@@ -15,6 +15,8 @@
 #include "slang/driver/Driver.h"
 #include "slang/syntax/SyntaxTree.h"
 #include "slang/util/Util.h"
+#include "slang/util/VersionInfo.h"
+#include "signal_db_index.h"
 #include "sol/sol.hpp"
 #include "vl_assert.h"
 #include <algorithm>
@@ -25,6 +27,7 @@
 #include <fstream>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -47,18 +50,6 @@ using namespace slang::ast;
 
 using json = nlohmann::json;
 
-inline bool isFileNewer(const std::string &file1, const std::string &file2) {
-    try {
-        auto time1 = std::filesystem::last_write_time(file1);
-        auto time2 = std::filesystem::last_write_time(file2);
-
-        return time1 > time2;
-    } catch (const std::filesystem::filesystem_error &e) {
-        std::cerr << "[isFileNewer] Error: " << e.what() << std::endl;
-        return false;
-    }
-}
-
 inline std::string get_current_time_as_string() {
     auto now = std::chrono::system_clock::now();
 
@@ -94,6 +85,90 @@ inline std::vector<std::string> splitString(std::string_view input, char delimit
     return tokens;
 }
 
+// 64-bit FNV-1a over a file's content, used to validate the signal DB cache.
+// Not cryptographic, only needs to be stable across runs and platforms.
+inline std::optional<uint64_t> hashFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    uint64_t h = 0xcbf29ce484222325ULL;
+    char buf[64 * 1024];
+    while (file) {
+        file.read(buf, sizeof(buf));
+        for (std::streamsize i = 0; i < file.gcount(); i++) {
+            h ^= static_cast<unsigned char>(buf[i]);
+            h *= 0x100000001b3ULL;
+        }
+    }
+    return h;
+}
+
+// Command line without the program name and with single spaces, so that
+// the CLI, the shared library and nosim record the same string.
+inline std::string normalizeCmdLine(std::string_view cmdLine) {
+    std::string ret;
+    bool first = true;
+    for (auto &arg : splitString(cmdLine, ' ')) {
+        if (arg.empty()) {
+            continue;
+        }
+        if (first) {
+            first = false;
+            continue;
+        }
+        if (!ret.empty()) {
+            ret += ' ';
+        }
+        ret += arg;
+    }
+    return ret;
+}
+
+inline std::string hashToString(uint64_t h) { return fmt::format("{:016x}", h); }
+
+inline std::string slangVersionString() { return fmt::format("{}.{}.{}+{}", VersionInfo::getMajor(), VersionInfo::getMinor(), VersionInfo::getPatch(), VersionInfo::getHash()); }
+
+inline std::string signalDBIndexPath(const std::string &outfile) { return outfile + ".idx"; }
+
+inline std::string signalDBMetaPath(const std::string &outfile) { return std::filesystem::path(outfile).parent_path().string() + "/signal_db_gen.meta.json"; }
+
+// Command line arguments that name existing files (sources given directly,
+// `-f` / `-F` / `-C` command files), hashed so that editing a filelist (and
+// the defines / include dirs in it) invalidates the cache.
+inline std::vector<std::string> argFiles(std::string_view cmdLine) {
+    std::vector<std::string> ret;
+    for (auto &arg : splitString(cmdLine, ' ')) {
+        std::error_code ec;
+        if (!arg.empty() && arg[0] != '-' && std::filesystem::is_regular_file(arg, ec)) {
+            ret.push_back(std::filesystem::absolute(arg, ec).string());
+        }
+    }
+    return ret;
+}
+
+// Whether every input recorded in the meta info (see `WrappedDriver::generateSignalDB`)
+// still has the same content hash.
+inline bool inputsUnchanged(const json &metaInfo, bool verbose) {
+    if (!metaInfo.contains("inputs") || !metaInfo["inputs"].is_object()) {
+        if (verbose) {
+            fmt::println("[signal_db_gen] meta info has no content hashes, regenerating...");
+        }
+        return false;
+    }
+    for (auto &[path, hash] : metaInfo["inputs"].items()) {
+        auto current = hashFile(path);
+        if (!current || hashToString(*current) != hash.get<std::string>()) {
+            if (verbose) {
+                fmt::println("[signal_db_gen] `{}` changed, regenerating...", path);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 class FileLock {
   public:
     FileLock(const std::string &path) : lock_path_(path) {
@@ -123,6 +198,64 @@ class FileLock {
     std::string lock_path_;
 };
 
+// `-o` / `--out` of a signal_db_gen command line, DEFAULT_OUTPUT_FILE if absent.
+inline std::string outfileFromCmdLine(std::string_view cmdLine) {
+    std::string outfile = DEFAULT_OUTPUT_FILE;
+    auto args           = splitString(cmdLine, ' ');
+    for (size_t i = 0; i < args.size(); i++) {
+        std::string_view arg = args[i];
+        if ((arg == "-o" || arg == "--out") && i + 1 < args.size()) {
+            outfile = args[i + 1];
+        } else if (arg.starts_with("--out=")) {
+            outfile = std::string(arg.substr(6));
+        }
+    }
+    return outfile;
+}
+
+// Fast path taken before any slang / Lua state is created: the signal DB and
+// its index are reused if the meta info was written by the same command line
+// and slang version and every recorded input still has the same content.
+// Returns false when the full check in `WrappedDriver` has to run.
+inline bool signalDBCacheValid(std::string_view argList) {
+    std::string cmdLine = normalizeCmdLine(argList);
+    for (auto &arg : splitString(cmdLine, ' ')) {
+        if (arg == "--nc" || arg == "--no-cache" || arg == "-h" || arg == "--help" || arg == "-s" || arg == "--signal-db" || arg.starts_with("--signal-db=")) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    auto outfile  = outfileFromCmdLine(cmdLine);
+    auto metaPath = signalDBMetaPath(outfile);
+    if (!std::filesystem::exists(outfile, ec) || !std::filesystem::exists(signalDBIndexPath(outfile), ec) || !std::filesystem::exists(metaPath, ec)) {
+        return false;
+    }
+
+    std::ifstream metaInfoFile(metaPath);
+    json metaInfo = json::parse(metaInfoFile, nullptr, false);
+    if (metaInfo.is_discarded() || metaInfo.value("cmdLine", "") != cmdLine || metaInfo.value("outfile", "") != outfile || metaInfo.value("slangVersion", "") != slangVersionString()) {
+        return false;
+    }
+
+    return inputsUnchanged(metaInfo, false);
+}
+
+// `signalDBCacheValid` under the output lock, so that a concurrent
+// regeneration is never reused half-written.
+inline bool tryReuseSignalDB(std::string_view argList) {
+    try {
+        FileLock lock(outfileFromCmdLine(normalizeCmdLine(argList)) + ".lock");
+        if (signalDBCacheValid(argList)) {
+            fmt::println("[signal_db_gen] up to date (content hashes match), skipping...");
+            return true;
+        }
+    } catch (const std::exception &) {
+        // e.g. the output dir does not exist yet, let the full path create it
+    }
+    return false;
+}
+
 class SignalGetter : public ASTVisitor<SignalGetter, false, false> {
   public:
     std::vector<std::string> hierPathVec;
@@ -308,11 +441,12 @@ class WrappedDriver {
         }
 
         // Get command line into string
-        cmdLineStr.clear();
+        std::string argList;
         for (int i = 0; i < argc; i++) {
-            cmdLineStr += argv[i];
-            cmdLineStr += " ";
+            argList += argv[i];
+            argList += " ";
         }
+        cmdLineStr = normalizeCmdLine(argList);
 
         // Can only have one of `--em` and `--dm`
         if (!enableModules.empty() && !disableModules.empty()) {
@@ -338,7 +472,7 @@ class WrappedDriver {
             return 0;
         }
 
-        cmdLineStr = std::string(argList);
+        cmdLineStr = normalizeCmdLine(argList);
 
         if (!checkForRegenerate()) {
             // Up to date, return 0
@@ -366,14 +500,50 @@ class WrappedDriver {
             PANIC("[signal_db_gen] Failed to call lua function `encode_signal_db", err.what());
         }
 
+        // Lookup index for nosim's `vpi_handle_by_name`, same signals and vpi types as the Lua DB
+        std::vector<signal_db_index::Signal> signals;
+        signals.reserve(getter.hierPathVec.size());
+        for (size_t i = 0; i < getter.hierPathVec.size(); i++) {
+            auto &typeStr = getter.typeStrVec[i];
+            if (typeStr.starts_with("logic") || typeStr.starts_with("bit")) {
+                signals.push_back({getter.hierPathVec[i], static_cast<uint32_t>(getter.bitWidthVec[i]), signal_db_index::TYPE_NET});
+            } else if (typeStr.starts_with("reg")) {
+                signals.push_back({getter.hierPathVec[i], static_cast<uint32_t>(getter.bitWidthVec[i]), signal_db_index::TYPE_REG});
+            }
+        }
+        auto indexPath = signalDBIndexPath(outfile.value_or(DEFAULT_OUTPUT_FILE));
+        ASSERT(signal_db_index::write(indexPath, std::move(signals)), "[signal_db_gen] Failed to write signal db index", indexPath);
+
         auto end      = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         fmt::println("[signal_db_gen] Time taken: {} ms", duration.count());
 
-        metaInfoJson["outfile"]   = outfile.value_or(DEFAULT_OUTPUT_FILE);
-        metaInfoJson["cmdLine"]   = cmdLineStr;
-        metaInfoJson["filelist"]  = files;
-        metaInfoJson["buildTime"] = get_current_time_as_string();
+        // Content hash of every file slang read (sources and included headers)
+        // plus the command files, checked by `signalDBCacheValid`
+        json inputs = json::object();
+        auto addInput = [&](const std::string &path) {
+            if (auto h = hashFile(path)) {
+                inputs[path] = hashToString(*h);
+            }
+        };
+        for (auto id : driver.sourceManager.getAllBuffers()) {
+            auto fullPath = driver.sourceManager.getFullPath(id);
+            if (!fullPath.empty()) {
+                addInput(fullPath.string());
+            }
+        }
+        for (auto &path : argFiles(cmdLineStr)) {
+            addInput(path);
+        }
+
+        metaInfoJson["outfile"]      = outfile.value_or(DEFAULT_OUTPUT_FILE);
+        metaInfoJson["cmdLine"]      = cmdLineStr;
+        metaInfoJson["filelist"]     = files;
+        metaInfoJson["slangVersion"] = slangVersionString();
+        metaInfoJson["defines"]      = driver.options.defines;
+        metaInfoJson["includeDirs"]  = driver.options.includeDirs;
+        metaInfoJson["inputs"]       = inputs;
+        metaInfoJson["buildTime"]    = get_current_time_as_string();
 
         // Write meta info into a json file, which can be used next time to check if the output is up to date
         std::ofstream o(metaInfoFilePath);
@@ -387,7 +557,7 @@ class WrappedDriver {
 
     bool checkForRegenerate() {
         outputDir        = std::filesystem::path(outfile.value_or(DEFAULT_OUTPUT_FILE)).parent_path();
-        metaInfoFilePath = outputDir + "/signal_db_gen.meta.json";
+        metaInfoFilePath = signalDBMetaPath(outfile.value_or(DEFAULT_OUTPUT_FILE));
 
         // Get files
         for (auto buffer : driver.sourceLoader.loadSources()) {
@@ -416,6 +586,11 @@ class WrappedDriver {
             return true;
         }
 
+        if (!std::filesystem::exists(signalDBIndexPath(outfile.value_or(DEFAULT_OUTPUT_FILE)))) {
+            fmt::println("[signal_db_gen] index file not found, regenerating...");
+            return true;
+        }
+
         std::ifstream metaInfoFile(metaInfoFilePath);
         if (!metaInfoFile.is_open()) {
             fmt::println("[signal_db_gen] failed to open meta info file, regenerating...");
@@ -435,11 +610,15 @@ class WrappedDriver {
             return true;
         }
 
-        for (const auto &file : files) {
-            if (isFileNewer(file, outfile.value_or(DEFAULT_OUTPUT_FILE))) {
-                fmt::println("[signal_db_gen] `{}` is newer than `{}`, regenerating...", file, outfile.value_or(DEFAULT_OUTPUT_FILE));
-                return true;
-            }
+        if (metaInfoJson.value("slangVersion", "") != slangVersionString()) {
+            fmt::println("[signal_db_gen] slang version changed, regenerating...");
+            return true;
+        }
+
+        // Content hashes instead of timestamps: touching a file or checking it
+        // out again does not trigger a rebuild, editing it does
+        if (!inputsUnchanged(metaInfoJson, true)) {
+            return true;
         }
 
         if (metaInfoJson["filelist"].get<std::vector<std::string>>() != files) {
@@ -9,6 +9,11 @@
 
 extern "C" int signal_db_gen_main(const char *argList) {
     try {
+        // Up to date: skip creating the slang driver and the Lua state
+        if (tryReuseSignalDB(argList)) {
+            return 1;
+        }
+
         WrappedDriver wDriver;
 
         // Parse command line to get `outfile` option
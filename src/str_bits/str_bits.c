@@ -0,0 +1,345 @@
+// str_bits: multi-word kernels behind `verilua.utils.StrBitsUtils`, see str_bits.h.
+//
+// Hex parse / format move 16 characters (one limb) per step, with SSE2 on
+// x86-64 and SWAR on a uint64_t elsewhere. The limb loops are plain C that the
+// compiler vectorizes, on x86-64 Linux they are also cloned for AVX2 and picked
+// at load time.
+
+#include "str_bits.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__SSE2__) && !defined(STR_BITS_NO_SIMD)
+#include <emmintrin.h>
+#define STR_BITS_SSE2 1
+#endif
+
+#if defined(__x86_64__) && defined(__linux__) && defined(__GNUC__)
+#define STR_BITS_MULTIVERSION __attribute__((target_clones("avx2", "default")))
+#else
+#define STR_BITS_MULTIVERSION
+#endif
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "str_bits assumes a little-endian target"
+#endif
+
+#define LIMB_BITS 64
+#define LIMB_CHARS 16
+
+static const char HEX_CHARS[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+
+static inline int hex_val(unsigned char c) {
+    unsigned d = (unsigned)c - '0';
+    if (d < 10) {
+        return (int)d;
+    }
+    unsigned l = (unsigned)(c | 0x20) - 'a';
+    if (l < 6) {
+        return (int)l + 10;
+    }
+    return -1;
+}
+
+// ─── 16 characters <=> one limb ────────────────────────────────────────────────
+
+#ifdef STR_BITS_SSE2
+
+static inline int parse16(const char *p, uint64_t *out) {
+    const __m128i x  = _mm_loadu_si128((const __m128i *)p);
+    const __m128i lx = _mm_or_si128(x, _mm_set1_epi8(0x20));
+
+    // Signed compares: bytes >= 0x80 are negative and fall out of both ranges
+    const __m128i digit  = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(x, _mm_set1_epi8('9' + 1)));
+    const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lx, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lx, _mm_set1_epi8('f' + 1)));
+    if (_mm_movemask_epi8(_mm_or_si128(digit, letter)) != 0xFFFF) {
+        return 0;
+    }
+
+    const __m128i val = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(x, _mm_set1_epi8('0'))), _mm_and_si128(letter, _mm_sub_epi8(lx, _mm_set1_epi8('a' - 10))));
+
+    // Byte pairs (c[2k], c[2k+1]) => c[2k] << 4 | c[2k+1] in the low byte of 16-bit lane k
+    const __m128i pairs  = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(val, 4), _mm_srli_epi16(val, 8)), _mm_set1_epi16(0x00FF));
+    const __m128i packed = _mm_packus_epi16(pairs, _mm_setzero_si128());
+
+    // Byte 0 is the most significant one
+    *out = __builtin_bswap64((uint64_t)_mm_cvtsi128_si64(packed));
+    return 1;
+}
+
+static inline void format16(uint64_t v, char *p) {
+    const __m128i b   = _mm_cvtsi64_si128((long long)__builtin_bswap64(v));
+    const __m128i lo4 = _mm_set1_epi8(0x0F);
+    const __m128i hi  = _mm_and_si128(_mm_srli_epi16(b, 4), lo4);
+    const __m128i lo  = _mm_and_si128(b, lo4);
+    const __m128i nib = _mm_unpacklo_epi8(hi, lo);
+
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(nib, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+    _mm_storeu_si128((__m128i *)p, _mm_add_epi8(_mm_add_epi8(nib, _mm_set1_epi8('0')), alpha));
+}
+
+#else
+
+#define ONES 0x0101010101010101ULL
+#define HIGHS 0x8080808080808080ULL
+
+// High bit of every byte of `x` that lies strictly between `lo` and `hi`, every byte of `x` must be below 0x80
+static inline uint64_t bytes_between(uint64_t x, uint64_t lo, uint64_t hi) { return (ONES * (127 + hi) - x) & ~x & (x + ONES * (127 - lo)) & HIGHS; }
+
+// 8 characters (first = most significant) to their value, -1 if one is not a hex digit
+static inline int64_t parse8(const char *p) {
+    uint64_t x;
+    memcpy(&x, p, 8);
+    x = __builtin_bswap64(x);
+    if (x & HIGHS) {
+        return -1;
+    }
+
+    const uint64_t digit  = bytes_between(x, '0' - 1, '9' + 1);
+    const uint64_t letter = bytes_between(x | (ONES * 0x20), 'a' - 1, 'f' + 1);
+    if ((digit | letter) != HIGHS) {
+        return -1;
+    }
+
+    uint64_t v = (x & (ONES * 0x0F)) + (letter >> 7) * 9;
+    v          = (v | (v >> 4)) & 0x00FF00FF00FF00FFULL;
+    v          = (v | (v >> 8)) & 0x0000FFFF0000FFFFULL;
+    v          = (v | (v >> 16)) & 0x00000000FFFFFFFFULL;
+    return (int64_t)v;
+}
+
+static inline int parse16(const char *p, uint64_t *out) {
+    const int64_t hi = parse8(p);
+    const int64_t lo = parse8(p + 8);
+    if ((hi | lo) < 0) {
+        return 0;
+    }
+    *out = ((uint64_t)hi << 32) | (uint64_t)lo;
+    return 1;
+}
+
+static inline void format16(uint64_t v, char *p) {
+    for (int i = LIMB_CHARS - 1; i >= 0; i--) {
+        p[i] = HEX_CHARS[v & 0xF];
+        v >>= 4;
+    }
+}
+
+#endif // STR_BITS_SSE2
+
+// ─── Hex strings ───────────────────────────────────────────────────────────────
+
+int str_bits_parse_hex(const char *s, size_t len, uint64_t *out, size_t nlimbs) {
+    size_t i   = 0;
+    size_t end = len;
+
+    while (end >= LIMB_CHARS && i < nlimbs) {
+        if (!parse16(s + end - LIMB_CHARS, &out[i])) {
+            return -1;
+        }
+        end -= LIMB_CHARS;
+        i++;
+    }
+
+    if (end > 0 && end < LIMB_CHARS && i < nlimbs) {
+        uint64_t v = 0;
+        for (size_t k = 0; k < end; k++) {
+            const int d = hex_val((unsigned char)s[k]);
+            if (d < 0) {
+                return -1;
+            }
+            v = (v << 4) | (uint64_t)d;
+        }
+        out[i++] = v;
+    } else {
+        // Digits that do not fit are dropped but still have to be valid
+        for (size_t k = 0; k < end; k++) {
+            if (hex_val((unsigned char)s[k]) < 0) {
+                return -1;
+            }
+        }
+    }
+
+    for (; i < nlimbs; i++) {
+        out[i] = 0;
+    }
+    return 0;
+}
+
+size_t str_bits_format_hex(const uint64_t *a, size_t n, size_t nchars, char *out) {
+    if (nchars == 0) {
+        size_t top = n;
+        while (top > 0 && a[top - 1] == 0) {
+            top--;
+        }
+        if (top == 0) {
+            out[0] = '0';
+            return 1;
+        }
+        const unsigned top_bits = LIMB_BITS - (unsigned)__builtin_clzll(a[top - 1]);
+        nchars                  = (top - 1) * LIMB_CHARS + (top_bits + 3) / 4;
+    }
+
+    const size_t full = nchars / LIMB_CHARS;
+    const size_t rem  = nchars % LIMB_CHARS;
+    char *p           = out;
+
+    if (rem) {
+        uint64_t v = full < n ? a[full] : 0;
+        for (size_t k = rem; k > 0; k--) {
+            p[k - 1] = HEX_CHARS[v & 0xF];
+            v >>= 4;
+        }
+        p += rem;
+    }
+
+    for (size_t i = full; i > 0; i--) {
+        format16(i - 1 < n ? a[i - 1] : 0, p);
+        p += LIMB_CHARS;
+    }
+    return nchars;
+}
+
+// ─── Limb kernels ──────────────────────────────────────────────────────────────
+
+STR_BITS_MULTIVERSION void str_bits_and(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = a[i] & b[i];
+    }
+}
+
+STR_BITS_MULTIVERSION void str_bits_or(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = a[i] | b[i];
+    }
+}
+
+STR_BITS_MULTIVERSION void str_bits_xor(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = a[i] ^ b[i];
+    }
+}
+
+STR_BITS_MULTIVERSION void str_bits_not(uint64_t *dst, const uint64_t *a, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = ~a[i];
+    }
+}
+
+uint64_t str_bits_add(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t x = a[i];
+        uint64_t s       = x + b[i];
+        uint64_t c       = s < x;
+        s += carry;
+        c |= s < carry;
+        dst[i] = s;
+        carry  = c;
+    }
+    return carry;
+}
+
+void str_bits_shl(uint64_t *dst, const uint64_t *a, size_t n, size_t shift) {
+    const size_t limbs  = shift / LIMB_BITS;
+    const unsigned bits = (unsigned)(shift % LIMB_BITS);
+
+    // Top down so that `dst` may alias `a`
+    for (size_t i = n; i > 0; i--) {
+        const size_t d = i - 1;
+        uint64_t v     = 0;
+        if (d >= limbs) {
+            const size_t src = d - limbs;
+            v                = a[src] << bits;
+            if (bits && src > 0) {
+                v |= a[src - 1] >> (LIMB_BITS - bits);
+            }
+        }
+        dst[d] = v;
+    }
+}
+
+void str_bits_shr(uint64_t *dst, const uint64_t *a, size_t n, size_t shift) {
+    const size_t limbs  = shift / LIMB_BITS;
+    const unsigned bits = (unsigned)(shift % LIMB_BITS);
+
+    for (size_t d = 0; d < n; d++) {
+        uint64_t v = 0;
+        if (limbs < n - d) {
+            const size_t src = d + limbs;
+            v                = a[src] >> bits;
+            if (bits && src + 1 < n) {
+                v |= a[src + 1] << (LIMB_BITS - bits);
+            }
+        }
+        dst[d] = v;
+    }
+}
+
+void str_bits_mask(uint64_t *a, size_t n, size_t nbits) {
+    size_t i            = nbits / LIMB_BITS;
+    const unsigned bits = (unsigned)(nbits % LIMB_BITS);
+    if (i >= n) {
+        return;
+    }
+    if (bits) {
+        a[i] &= (1ULL << bits) - 1;
+        i++;
+    }
+    for (; i < n; i++) {
+        a[i] = 0;
+    }
+}
+
+// `count` (1..64) bits of `v` starting at bit `pos`, zero beyond `vn` limbs
+static inline uint64_t get_bits(const uint64_t *v, size_t vn, size_t pos, unsigned count) {
+    const size_t i      = pos / LIMB_BITS;
+    const unsigned bits = (unsigned)(pos % LIMB_BITS);
+    uint64_t x          = i < vn ? v[i] >> bits : 0;
+    if (bits && i + 1 < vn) {
+        x |= v[i + 1] << (LIMB_BITS - bits);
+    }
+    return count < LIMB_BITS ? x & ((1ULL << count) - 1) : x;
+}
+
+void str_bits_extract(uint64_t *dst, size_t dn, const uint64_t *a, size_t n, size_t s, size_t width) {
+    for (size_t i = 0; i < dn; i++) {
+        const size_t off = i * LIMB_BITS;
+        if (off >= width) {
+            dst[i] = 0;
+            continue;
+        }
+        const size_t left = width - off;
+        dst[i]            = get_bits(a, n, s + off, left < LIMB_BITS ? (unsigned)left : LIMB_BITS);
+    }
+}
+
+void str_bits_insert(uint64_t *a, size_t n, size_t s, size_t width, const uint64_t *v, size_t vn) {
+    size_t j = 0;
+    while (j < width) {
+        const size_t pos    = s + j;
+        const size_t i      = pos / LIMB_BITS;
+        const unsigned bits = (unsigned)(pos % LIMB_BITS);
+        if (i >= n) {
+            break;
+        }
+
+        // Up to the end of the destination limb or of the field, whichever comes first
+        size_t count = LIMB_BITS - bits;
+        if (count > width - j) {
+            count = width - j;
+        }
+
+        const uint64_t mask = (count < LIMB_BITS ? (1ULL << count) - 1 : ~0ULL) << bits;
+        a[i]                = (a[i] & ~mask) | ((get_bits(v, vn, j, (unsigned)count) << bits) & mask);
+        j += count;
+    }
+}
+
+size_t str_bits_popcount(const uint64_t *a, size_t n) {
+    size_t cnt = 0;
+    for (size_t i = 0; i < n; i++) {
+        cnt += (size_t)__builtin_popcountll(a[i]);
+    }
+    return cnt;
+}
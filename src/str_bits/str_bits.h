@@ -0,0 +1,56 @@
+// str_bits: multi-word kernels behind `verilua.utils.StrBitsUtils`.
+//
+// Values are little-endian arrays of uint64_t limbs (limb 0 holds bits 0..63).
+// Every kernel works on caller-owned buffers and never allocates, the Lua side
+// keeps a few scratch buffers around and only converts at the string boundary.
+//
+// The declarations below are mirrored by the `ffi.cdef` in
+// `src/lua/verilua/utils/StrBitsNative.lua`, keep them in sync.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parse `len` hex characters (most significant first, no prefix) into `nlimbs`
+// limbs. Digits beyond the limbs are dropped, missing high limbs are zeroed.
+// Returns 0 on success, -1 if any character (dropped ones included) is not a hex digit.
+int str_bits_parse_hex(const char *s, size_t len, uint64_t *out, size_t nlimbs);
+
+// Format the value as lower case hex into `out`. `nchars` == 0 writes the
+// shortest form ("0" for zero), otherwise exactly `nchars` characters, zero
+// padded or truncated to the low `4 * nchars` bits. Returns the number of
+// characters written, `out` is not NUL terminated.
+size_t str_bits_format_hex(const uint64_t *a, size_t n, size_t nchars, char *out);
+
+void str_bits_and(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+void str_bits_or(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+void str_bits_xor(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+void str_bits_not(uint64_t *dst, const uint64_t *a, size_t n);
+
+// dst = a + b over `n` limbs, returns the carry out of the top limb (0 or 1).
+uint64_t str_bits_add(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+
+// dst = a << shift / a >> shift over `n` limbs, bits shifted out are dropped.
+// `dst` may alias `a`.
+void str_bits_shl(uint64_t *dst, const uint64_t *a, size_t n, size_t shift);
+void str_bits_shr(uint64_t *dst, const uint64_t *a, size_t n, size_t shift);
+
+// Clear every bit at or above `nbits`.
+void str_bits_mask(uint64_t *a, size_t n, size_t nbits);
+
+// dst[0..dn) = a[s + width - 1 : s], zero extended.
+void str_bits_extract(uint64_t *dst, size_t dn, const uint64_t *a, size_t n, size_t s, size_t width);
+
+// a[s + width - 1 : s] = v[width - 1 : 0], bits of the field beyond `n` limbs are dropped.
+void str_bits_insert(uint64_t *a, size_t n, size_t s, size_t width, const uint64_t *v, size_t vn);
+
+size_t str_bits_popcount(const uint64_t *a, size_t n);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,32 @@
+---@diagnostic disable
+
+local prj_dir = os.projectdir()
+local curr_dir = os.scriptdir()
+local build_dir = path.join(prj_dir, "build")
+
+target("libstr_bits", function()
+    set_kind("shared")
+    set_basename("str_bits")
+
+    set_languages("c99")
+    set_targetdir(path.join(build_dir, "shared"))
+    set_objectdir(path.join(build_dir, "obj"))
+
+    if is_mode("debug") then
+        set_symbols("debug")
+        set_optimize("none")
+    else
+        set_optimize("fastest")
+    end
+
+    add_files(path.join(curr_dir, "str_bits.c"))
+    add_includedirs(curr_dir)
+
+    after_build(function(target)
+        local shared_dir = path.join(prj_dir, "shared")
+        if not os.isdir(shared_dir) then
+            os.mkdir(shared_dir)
+        end
+        os.cp(target:targetfile(), shared_dir)
+    end)
+end)
@@ -2,22 +2,50 @@
 //
 // Usage:
 //   sv_lint --text '<sv_code>'
+//   sv_lint [--preload <file>]... [-j <jobs>] <file>...
 //
-// Runs slang lint-only on the provided SV text. Exits 0 on success, 1 on
-// lint failure (first diagnostic printed to stderr).
+// `--text` runs slang lint-only on the provided SV text. Exits 0 on success,
+// 1 on lint failure (first diagnostic printed to stderr).
+//
+// With files, every file is linted as its own compilation unit on a thread
+// pool of `-j` workers (default: one per hardware thread). `--preload` files
+// (packages, headers defining macros) are parsed once and seen by every
+// file. All errors and warnings are printed to stderr as
+// `file:line:col: severity: message [code]`; exits 1 if any file has one.
 
 #include "sv_lint_core.h"
 
 #include "fmt/core.h"
 
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+static void printUsage() {
+    fmt::println(stderr, "Usage: sv_lint --text '<sv_code>'");
+    fmt::println(stderr, "       sv_lint [--preload <file>]... [-j <jobs>] <file>...");
+}
 
-static void printUsage() { fmt::println(stderr, "Usage: sv_lint --text '<sv_code>'"); }
+static bool readFile(const std::string &path, std::string &out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    out = ss.str();
+    return true;
+}
 
 int main(int argc, char *argv[]) {
     std::string svText;
+    std::vector<std::string> preloadFiles;
+    std::vector<std::string> files;
+    size_t jobs = 0;
 
-    // Parse arguments: --text '<code>'
+    // Parse arguments: --text '<code>' | [--preload <file>]... [-j <jobs>] <file>...
     for (int i = 1; i < argc; ++i) {
         if (std::strcmp(argv[i], "--text") == 0) {
             if (i + 1 < argc) {
@@ -26,27 +54,99 @@ int main(int argc, char *argv[]) {
                 fmt::println(stderr, "Error: --text requires an argument");
                 return 2;
             }
+        } else if (std::strcmp(argv[i], "--preload") == 0) {
+            if (i + 1 < argc) {
+                preloadFiles.emplace_back(argv[++i]);
+            } else {
+                fmt::println(stderr, "Error: --preload requires an argument");
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "-j") == 0 || std::strcmp(argv[i], "--jobs") == 0) {
+            if (i + 1 < argc) {
+                jobs = std::strtoul(argv[++i], nullptr, 10);
+            } else {
+                fmt::println(stderr, "Error: {} requires an argument", argv[i]);
+                return 2;
+            }
         } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
             printUsage();
             return 0;
-        } else {
+        } else if (argv[i][0] == '-') {
             fmt::println(stderr, "Error: unknown argument '{}'", argv[i]);
             printUsage();
             return 2;
+        } else {
+            files.emplace_back(argv[i]);
         }
     }
 
-    if (svText.empty()) {
-        fmt::println(stderr, "Error: no input provided. Use --text '<sv_code>'");
+    if (svText.empty() && files.empty()) {
+        fmt::println(stderr, "Error: no input provided. Use --text '<sv_code>' or pass files");
         printUsage();
         return 2;
     }
 
-    auto result = sv_lint::lint(svText);
-    if (!result.ok) {
-        fmt::print(stderr, "{}", result.diagnostic);
-        return 1;
+    if (!svText.empty() && !files.empty()) {
+        fmt::println(stderr, "Error: --text cannot be combined with files");
+        return 2;
+    }
+
+    if (!svText.empty() && preloadFiles.empty()) {
+        auto result = sv_lint::lint(svText);
+        if (!result.ok) {
+            fmt::print(stderr, "{}", result.diagnostic);
+            return 1;
+        }
+        return 0;
+    }
+
+    sv_lint::LintContext ctx;
+    for (auto &path : preloadFiles) {
+        std::string text;
+        if (!readFile(path, text)) {
+            fmt::println(stderr, "Error: cannot read preload file '{}'", path);
+            return 2;
+        }
+        auto records = ctx.preload(path, text);
+        if (!records.empty()) {
+            for (auto &record : records) {
+                fmt::println(stderr, "{}", sv_lint::formatRecord(record));
+            }
+            fmt::println(stderr, "Error: preload file '{}' has lint errors", path);
+            return 1;
+        }
+    }
+
+    std::vector<std::string> names;
+    std::vector<std::string> texts;
+    if (!svText.empty()) {
+        names.emplace_back("sv_lint_input");
+        texts.push_back(std::move(svText));
+    }
+    for (auto &path : files) {
+        std::string text;
+        if (!readFile(path, text)) {
+            fmt::println(stderr, "Error: cannot read file '{}'", path);
+            return 2;
+        }
+        names.push_back(path);
+        texts.push_back(std::move(text));
+    }
+
+    std::vector<std::string_view> nameViews(names.begin(), names.end());
+    std::vector<std::string_view> textViews(texts.begin(), texts.end());
+    auto results = sv_lint::lintBatch(ctx, nameViews, textViews, jobs);
+
+    size_t failed = 0;
+    for (auto &records : results) {
+        for (auto &record : records) {
+            fmt::println(stderr, "{}", sv_lint::formatRecord(record));
+        }
+        failed += records.empty() ? 0 : 1;
+    }
+    if (results.size() > 1 && failed > 0) {
+        fmt::println(stderr, "{} of {} files failed lint", failed, results.size());
     }
 
-    return 0;
+    return failed > 0 ? 1 : 0;
 }
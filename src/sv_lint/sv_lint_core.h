@@ -1,7 +1,10 @@
 // sv_lint_core.h — shared lint logic for sv_lint CLI and libsv_lint.so.
 //
 // Provides:
-//   sv_lint_core(text) -> {ok, diagnostic_string}
+//   lint(text)          -> {ok, diagnostic_string}
+//   LintContext         -> shared package / header sources, parsed once
+//   lintUnit(ctx, ...)  -> structured diagnostics of one text
+//   lintBatch(ctx, ...) -> lintUnit over many texts on a thread pool
 //
 // Header-only to avoid an extra compilation unit / link dependency.
 
@@ -11,14 +14,21 @@
 #include "slang/ast/Compilation.h"
 #include "slang/diagnostics/DiagnosticEngine.h"
 #include "slang/diagnostics/TextDiagnosticClient.h"
+#include "slang/syntax/AllSyntax.h"
 #include "slang/syntax/SyntaxTree.h"
 #include "slang/text/SourceManager.h"
 #include "slang/util/Bag.h"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 namespace sv_lint {
 
@@ -31,6 +41,289 @@ struct LintResult {
     std::string diagnostic; // empty when ok == true
 };
 
+/// One error or warning of a linted text.
+struct DiagRecord {
+    std::string file; // unit (or preload) name the diagnostic points into
+    uint32_t line   = 0;
+    uint32_t column = 0;
+    bool isError    = false; // otherwise a warning
+    std::string code;        // slang diagnostic code, e.g. "UndeclaredIdentifier"
+    std::string message;
+};
+
+inline bool isErrorOrWarning(const Diagnostic &diag) {
+    auto sev = getDefaultSeverity(diag.code);
+    return sev == DiagnosticSeverity::Error || sev == DiagnosticSeverity::Warning;
+}
+
+inline CompilationOptions lintCompilationOptions() {
+    CompilationOptions compOptions;
+    compOptions.flags |= CompilationFlags::LintMode;
+    return compOptions;
+}
+
+/// Sources shared by every text linted through the context: packages,
+/// interfaces and headers defining macros. They are parsed once by
+/// `preload()`; every later lint adds the parsed trees to its compilation
+/// and inherits their `define macros, so a generated module can import the
+/// packages and use the macros without `include.
+///
+/// All trees of a compilation must share one SourceManager. The context's
+/// own SourceManager only ever holds the preloaded buffers; each linted text
+/// gets a fresh SourceManager that first replays those buffers (same
+/// BufferIDs, same macro expansions) and then views the preloaded trees
+/// through it, so nothing of a unit outlives its lint. `lintUnit` /
+/// `lintBatch` may run concurrently (the context is only read); `preload`
+/// must not run concurrently with anything else on the same context.
+class LintContext {
+  public:
+    /// Parse and lint `text`, keep it for later lints if it is clean.
+    /// Returns the diagnostics of the preload (empty on success).
+    std::vector<DiagRecord> preload(std::string_view name, std::string_view text);
+
+    std::span<const DefineDirectiveSyntax *const> macros() const { return macros_; }
+
+    /// Replay the preloaded buffers into the empty `sourceManager` and
+    /// return the preloaded trees bound to it.
+    std::vector<std::shared_ptr<SyntaxTree>> layerOnto(SourceManager &sourceManager) const;
+
+    /// Buffer path of a linted text: its name, unless a preloaded buffer
+    /// already uses that path (including the `#<n>` suffixed ones).
+    std::string unitPath(std::string_view name) const {
+        std::string path(name);
+        for (uint32_t n = 0; paths_.contains(path); n++)
+            path = fmt::format("{}#unit{}", name, n);
+        return path;
+    }
+
+  private:
+    /// One buffer of `sourceManager_`: a file buffer (`path`, `text`) or,
+    /// when `isExpansion`, a macro expansion.
+    struct BufferEntry {
+        std::string path;
+        std::string text;
+        bool isExpansion = false;
+        SourceLocation originalLoc;
+        SourceRange expansionRange;
+        bool isMacroArg = false;
+        std::string macroName;
+    };
+
+    /// Preload buffers get a `#<n>` suffix on repeated paths, SourceManager
+    /// rejects assigning the same path twice.
+    std::string uniquePath(std::string_view name) {
+        std::string path(name);
+        for (uint32_t n = 1; paths_.contains(path); n++)
+            path = fmt::format("{}#{}", name, n);
+        paths_.insert(path);
+        return path;
+    }
+
+    /// Record the buffers from `first` up to the end of `sourceManager_`.
+    /// Buffers of a rejected preload are recorded as empty placeholders, they
+    /// only keep the BufferIDs of later preloads in step.
+    void recordBuffers(BufferID first, bool keep);
+
+    SourceManager sourceManager_;
+    std::vector<std::shared_ptr<SyntaxTree>> trees_;
+    std::vector<const DefineDirectiveSyntax *> macros_;
+    std::vector<BufferEntry> buffers_;
+    std::unordered_set<std::string> paths_; // every path assigned in `sourceManager_`
+};
+
+// Where `loc` shows up in `buffer`: its spelling when that is in the buffer,
+// otherwise the point the macro holding it was expanded at (e.g. a preloaded
+// macro used by the text). Invalid if `loc` is in neither.
+inline SourceLocation locationIn(const SourceManager &sourceManager, SourceLocation loc, BufferID buffer) {
+    auto original = sourceManager.getFullyOriginalLoc(loc);
+    if (original.buffer() == buffer)
+        return original;
+    auto expanded = sourceManager.getFullyExpandedLoc(loc);
+    if (expanded.buffer() == buffer)
+        return expanded;
+    return SourceLocation();
+}
+
+inline DiagRecord toRecord(const DiagnosticEngine &engine, const SourceManager &sourceManager, const Diagnostic &diag, SourceLocation loc) {
+    DiagRecord record;
+    if (loc.buffer().valid()) {
+        record.file   = std::string(sourceManager.getFileName(loc));
+        record.line   = static_cast<uint32_t>(sourceManager.getLineNumber(loc));
+        record.column = static_cast<uint32_t>(sourceManager.getColumnNumber(loc));
+    }
+    record.isError = getDefaultSeverity(diag.code) == DiagnosticSeverity::Error;
+    record.code    = std::string(toString(diag.code));
+    record.message = engine.formatMessage(diag);
+    return record;
+}
+
+// Parse `buffer` of `sourceManager` (inheriting `macros`), compile it
+// together with `trees` and collect the errors and warnings that point into
+// the buffer itself, reported where they show up in it. Parse errors are
+// returned alone, without running the compilation on a broken tree.
+inline std::vector<DiagRecord> lintBuffer(SourceManager &sourceManager, std::span<const std::shared_ptr<SyntaxTree>> trees, std::span<const DefineDirectiveSyntax *const> macros, SourceBuffer buffer, std::shared_ptr<SyntaxTree> &tree) {
+    Bag options;
+    tree = SyntaxTree::fromBuffer(buffer, sourceManager, options, macros);
+
+    DiagnosticEngine engine(sourceManager);
+    std::vector<DiagRecord> records;
+    for (auto &diag : tree->diagnostics()) {
+        if (!isErrorOrWarning(diag))
+            continue;
+        auto loc = locationIn(sourceManager, diag.location, buffer.id);
+        records.push_back(toRecord(engine, sourceManager, diag, loc.buffer().valid() ? loc : sourceManager.getFullyOriginalLoc(diag.location)));
+    }
+    if (!records.empty())
+        return records;
+
+    Bag compBag;
+    compBag.set(lintCompilationOptions());
+    Compilation compilation(compBag);
+    for (auto &shared : trees)
+        compilation.addSyntaxTree(shared);
+    compilation.addSyntaxTree(tree);
+
+    // Diagnostics inside the shared trees were reported when they were preloaded
+    for (auto &diag : compilation.getSemanticDiagnostics()) {
+        if (!isErrorOrWarning(diag))
+            continue;
+        auto loc = locationIn(sourceManager, diag.location, buffer.id);
+        if (loc.buffer().valid())
+            records.push_back(toRecord(engine, sourceManager, diag, loc));
+    }
+    return records;
+}
+
+/// An exception thrown while linting `name`, reported as an error of it so
+/// it never escapes through the C API.
+inline DiagRecord internalError(std::string_view name, const std::exception &e) {
+    DiagRecord record;
+    record.file    = std::string(name);
+    record.isError = true;
+    record.code    = "InternalError";
+    record.message = e.what();
+    return record;
+}
+
+/// Lint one text against the preloaded sources of `ctx` and return every
+/// error and warning that points into the text itself.
+inline std::vector<DiagRecord> lintUnit(const LintContext &ctx, std::string_view name, std::string_view sv_text) {
+    try {
+        SourceManager sourceManager;
+        auto trees  = ctx.layerOnto(sourceManager);
+        auto buffer = sourceManager.assignText(ctx.unitPath(name), sv_text);
+        std::shared_ptr<SyntaxTree> tree;
+        return lintBuffer(sourceManager, trees, ctx.macros(), buffer, tree);
+    } catch (const std::exception &e) {
+        return {internalError(name, e)};
+    }
+}
+
+inline std::vector<DiagRecord> LintContext::preload(std::string_view name, std::string_view text) {
+    auto buffer = sourceManager_.assignText(uniquePath(name), text);
+    std::shared_ptr<SyntaxTree> tree;
+    std::vector<DiagRecord> records;
+    try {
+        records = lintBuffer(sourceManager_, trees_, macros_, buffer, tree);
+    } catch (const std::exception &e) {
+        records = {internalError(name, e)};
+    }
+    // Also after a failure, so the BufferIDs of later preloads stay in step
+    recordBuffers(buffer.id, records.empty());
+    if (records.empty()) {
+        auto defined = tree->getDefinedMacros();
+        macros_.insert(macros_.end(), defined.begin(), defined.end());
+        trees_.push_back(std::move(tree));
+    }
+    return records;
+}
+
+inline void LintContext::recordBuffers(BufferID first, bool keep) {
+    // BufferIDs are handed out in order: an empty probe buffer marks the end
+    // of the buffers (text and macro expansions) this preload created
+    auto probe = sourceManager_.assignText(uniquePath(fmt::format("<preload-end#{}>", buffers_.size())), ""sv);
+    for (auto id = first.getId(); id <= probe.id.getId(); id++) {
+        BufferID buffer(id, ""sv);
+        SourceLocation loc(buffer, 0);
+        BufferEntry entry;
+        if (!keep || id == probe.id.getId()) {
+            entry.path = uniquePath(fmt::format("<preload-unused#{}>", id));
+        } else if (sourceManager_.isMacroLoc(loc)) {
+            entry.isExpansion    = true;
+            entry.originalLoc    = sourceManager_.getOriginalLoc(loc);
+            entry.expansionRange = sourceManager_.getExpansionRange(loc);
+            entry.isMacroArg     = sourceManager_.isMacroArgLoc(loc);
+            entry.macroName      = std::string(sourceManager_.getMacroName(loc));
+        } else {
+            entry.path = std::string(sourceManager_.getRawFileName(buffer));
+            entry.text = std::string(sourceManager_.getSourceText(buffer));
+        }
+        buffers_.push_back(std::move(entry));
+    }
+}
+
+inline std::vector<std::shared_ptr<SyntaxTree>> LintContext::layerOnto(SourceManager &sourceManager) const {
+    for (auto &entry : buffers_) {
+        if (!entry.isExpansion)
+            sourceManager.assignText(entry.path, entry.text);
+        else if (entry.isMacroArg)
+            sourceManager.createExpansionLoc(entry.originalLoc, entry.expansionRange, true);
+        else
+            sourceManager.createExpansionLoc(entry.originalLoc, entry.expansionRange, std::string_view(entry.macroName));
+    }
+
+    // Views of the preloaded trees: same syntax nodes, locations resolved
+    // through `sourceManager` (the parent tree keeps the nodes alive)
+    std::vector<std::shared_ptr<SyntaxTree>> trees;
+    trees.reserve(trees_.size());
+    for (auto &tree : trees_)
+        trees.push_back(std::make_shared<SyntaxTree>(&tree->root(), tree->getSourceLibrary(), sourceManager, BumpAllocator(), tree));
+    return trees;
+}
+
+// Run `fn(i)` for every i in [0, n) on up to `jobs` threads. Indices are
+// handed out through an atomic cursor, so callers must write results into
+// per-index slots to keep the output independent of thread scheduling.
+template <typename Fn> void parallelFor(size_t n, size_t jobs, Fn &&fn) {
+    jobs = std::max<size_t>(1, std::min(jobs, n));
+    if (jobs == 1) {
+        for (size_t i = 0; i < n; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> cursor{0};
+    std::vector<std::thread> workers;
+    workers.reserve(jobs);
+    for (size_t t = 0; t < jobs; t++) {
+        workers.emplace_back([&]() {
+            for (size_t i = cursor.fetch_add(1); i < n; i = cursor.fetch_add(1)) {
+                fn(i);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+}
+
+/// Lint `texts[i]` (named `names[i]`) for every i on up to `jobs` threads
+/// (0: one per hardware thread). Result i holds the diagnostics of text i.
+inline std::vector<std::vector<DiagRecord>> lintBatch(const LintContext &ctx, std::span<const std::string_view> names, std::span<const std::string_view> texts, size_t jobs = 0) {
+    if (jobs == 0)
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::vector<DiagRecord>> results(texts.size());
+    parallelFor(texts.size(), jobs, [&](size_t i) { results[i] = lintUnit(ctx, names[i], texts[i]); });
+    return results;
+}
+
+/// `file:line:col: error: message [code]`, one line per record.
+inline std::string formatRecord(const DiagRecord &record) {
+    return fmt::format("{}:{}:{}: {}: {} [{}]", record.file, record.line, record.column, record.isError ? "error" : "warning", record.message, record.code);
+}
+
 /// Run slang lint on the given SystemVerilog text.
 /// Returns {true, ""} on success, or {false, diagnostic_message} on failure.
 inline LintResult lint(std::string_view sv_text) {
@@ -40,10 +333,7 @@ inline LintResult lint(std::string_view sv_text) {
 
     // Helper: extract the first error or warning from a diagnostics collection.
     auto extractFirstDiagnostic = [&](const auto &diagnostics) -> std::string {
-        auto hasDiag = std::any_of(diagnostics.begin(), diagnostics.end(), [](const auto &d) {
-            auto sev = getDefaultSeverity(d.code);
-            return sev == DiagnosticSeverity::Error || sev == DiagnosticSeverity::Warning;
-        });
+        auto hasDiag = std::any_of(diagnostics.begin(), diagnostics.end(), [](const auto &d) { return isErrorOrWarning(d); });
         if (!hasDiag)
             return {};
 
@@ -52,8 +342,7 @@ inline LintResult lint(std::string_view sv_text) {
         auto client = std::make_shared<TextDiagnosticClient>();
         engine.addClient(client);
         for (auto &diag : diagnostics) {
-            auto sev = getDefaultSeverity(diag.code);
-            if (sev == DiagnosticSeverity::Error || sev == DiagnosticSeverity::Warning)
+            if (isErrorOrWarning(diag))
                 engine.issue(diag);
         }
         std::string msg = client->getString();
@@ -71,10 +360,8 @@ inline LintResult lint(std::string_view sv_text) {
     }
 
     // Run lint-mode compilation
-    CompilationOptions compOptions;
-    compOptions.flags |= CompilationFlags::LintMode;
     Bag compBag;
-    compBag.set(compOptions);
+    compBag.set(lintCompilationOptions());
 
     Compilation compilation(compBag);
     compilation.addSyntaxTree(tree);
@@ -1,13 +1,73 @@
 // sv_lint shared library interface for LuaJIT FFI.
 //
-// Exposes a single C function:
+// Exposes:
 //   int sv_lint_text(const char* sv_text, char* out_diag, int out_diag_size)
+//     Returns 0 on success, 1 on lint failure (diagnostic written to out_diag).
 //
-// Returns 0 on success, 1 on lint failure (diagnostic written to out_diag).
+//   sv_lint_ctx* sv_lint_ctx_new() / void sv_lint_ctx_free(ctx)
+//   sv_lint_result* sv_lint_ctx_preload(ctx, name, text)
+//     Shared package / header sources, parsed once and seen by every lint
+//     through `ctx` (see sv_lint::LintContext).
+//
+//   sv_lint_result* sv_lint_batch(texts, names, n, ctx, jobs)
+//     Lint n texts on up to `jobs` threads (0: one per hardware thread),
+//     `names` and `ctx` may be NULL.
+//
+//   The functions above return NULL on invalid arguments or an internal
+//   failure; no C++ exception escapes the library.
+//
+//   int sv_lint_result_count(res) / const sv_lint_diag* sv_lint_result_get(res, i)
+//   void sv_lint_result_free(res)
+//     Structured diagnostics, grouped by unit in input order. The strings
+//     are owned by the result.
 
 #include "sv_lint_core.h"
 
 #include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+struct sv_lint_diag {
+    int unit; // index of the text in the batch
+    int line;
+    int column;
+    int is_error; // 0: warning
+    const char *file;
+    const char *code;
+    const char *message;
+};
+
+struct sv_lint_ctx {
+    sv_lint::LintContext ctx;
+};
+
+struct sv_lint_result {
+    std::vector<sv_lint::DiagRecord> records;
+    std::vector<sv_lint_diag> diags;
+};
+
+static sv_lint_result *makeResult(std::vector<std::vector<sv_lint::DiagRecord>> &&units) {
+    auto res = new sv_lint_result();
+    for (size_t unit = 0; unit < units.size(); unit++) {
+        for (auto &record : units[unit]) {
+            res->records.push_back(std::move(record));
+            res->diags.push_back({static_cast<int>(unit), 0, 0, 0, nullptr, nullptr, nullptr});
+        }
+    }
+    // Fill the pointers once `records` no longer reallocates
+    for (size_t i = 0; i < res->records.size(); i++) {
+        auto &record  = res->records[i];
+        auto &diag    = res->diags[i];
+        diag.line     = static_cast<int>(record.line);
+        diag.column   = static_cast<int>(record.column);
+        diag.is_error = record.isError ? 1 : 0;
+        diag.file     = record.file.c_str();
+        diag.code     = record.code.c_str();
+        diag.message  = record.message.c_str();
+    }
+    return res;
+}
 
 extern "C" {
 
@@ -17,7 +77,12 @@ int sv_lint_text(const char *sv_text, char *out_diag, int out_diag_size) {
     }
     out_diag[0] = '\0';
 
-    auto result = sv_lint::lint(sv_text);
+    sv_lint::LintResult result;
+    try {
+        result = sv_lint::lint(sv_text);
+    } catch (const std::exception &e) {
+        result = {false, fmt::format("sv_lint internal error: {}", e.what())};
+    }
     if (!result.ok) {
         std::strncpy(out_diag, result.diagnostic.c_str(), out_diag_size - 1);
         out_diag[out_diag_size - 1] = '\0';
@@ -27,4 +92,68 @@ int sv_lint_text(const char *sv_text, char *out_diag, int out_diag_size) {
     return 0;
 }
 
+// Exceptions while linting a text come back as its diagnostics (see
+// sv_lint::internalError); anything left (e.g. out of memory) yields nullptr.
+
+sv_lint_ctx *sv_lint_ctx_new() {
+    try {
+        return new sv_lint_ctx();
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+void sv_lint_ctx_free(sv_lint_ctx *ctx) { delete ctx; }
+
+sv_lint_result *sv_lint_ctx_preload(sv_lint_ctx *ctx, const char *name, const char *text) {
+    if (!ctx || !name || !text) {
+        return nullptr;
+    }
+    try {
+        std::vector<std::vector<sv_lint::DiagRecord>> units;
+        units.push_back(ctx->ctx.preload(name, text));
+        return makeResult(std::move(units));
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+sv_lint_result *sv_lint_batch(const char **texts, const char **names, int n, sv_lint_ctx *ctx, int jobs) {
+    if (!texts || n < 0) {
+        return nullptr;
+    }
+
+    try {
+        // Without a context every unit is linted alone: an empty context has
+        // no buffers to replay, each unit only gets its own fresh SourceManager
+        std::unique_ptr<sv_lint_ctx> local;
+        if (!ctx) {
+            local = std::make_unique<sv_lint_ctx>();
+            ctx   = local.get();
+        }
+
+        std::vector<std::string_view> textViews(n);
+        std::vector<std::string_view> nameViews(n);
+        for (int i = 0; i < n; i++) {
+            textViews[i] = texts[i] ? texts[i] : "";
+            nameViews[i] = names && names[i] ? names[i] : "sv_lint_input";
+        }
+
+        return makeResult(sv_lint::lintBatch(ctx->ctx, nameViews, textViews, jobs > 0 ? static_cast<size_t>(jobs) : 0));
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+int sv_lint_result_count(const sv_lint_result *res) { return res ? static_cast<int>(res->diags.size()) : 0; }
+
+const sv_lint_diag *sv_lint_result_get(const sv_lint_result *res, int i) {
+    if (!res || i < 0 || i >= static_cast<int>(res->diags.size())) {
+        return nullptr;
+    }
+    return &res->diags[i];
+}
+
+void sv_lint_result_free(sv_lint_result *res) { delete res; }
+
 } // extern "C"
@@ -30,6 +30,7 @@ target("sv_lint", function()
     )
 
     add_links("svlang", "fmt", "mimalloc")
+    add_syslinks("pthread")
     add_linkdirs(path.join(libs_dir, "lib"))
     add_rpathdirs(path.join(libs_dir, "lib"))
 
@@ -71,6 +72,7 @@ target("libsv_lint", function()
     )
 
     add_links("svlang", "fmt", "mimalloc")
+    add_syslinks("pthread")
     add_linkdirs(path.join(libs_dir, "lib"))
     add_rpathdirs(path.join(libs_dir, "lib"))
 
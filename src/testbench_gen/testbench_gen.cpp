@@ -23,6 +23,9 @@ int main(int argc, const char *argv[]) {
     std::optional<bool> _dryrun;
     std::optional<bool> _regen;
     std::optional<bool> _nodpi;
+    std::optional<bool> _portAccess;
+    std::vector<std::string> _clockDomains;
+    std::optional<bool> _domainStep;
 
     driver.cmdLine.add("--tt,--tbtop", _tbtopName, "testbench top module name", "<top module name>");
     driver.cmdLine.add("--dn,--dut-name", _dutName, "testbench dut inst name", "<dut instance name>");
@@ -35,10 +38,13 @@ int main(int argc, const char *argv[]) {
     driver.cmdLine.add("--ios,--inject-outer-str,--ccso,--custom-code-str-outer", _customCodeStrOuter, "inject code from <string> into the testbench module outer (before module declaration)", "<string>");
     driver.cmdLine.add("--fl,--filelist", _files, "input file or filelist", "<file/filelist>");
     driver.cmdLine.add("-p,--period", _period, "clock period", "<period value>");
+    driver.cmdLine.add("--cd,--clock-domain", _clockDomains, "extra clock domain driven by the testbench (can be repeated), <period>/<phase> use the same unit as --period", "<clock>:<period>[:<phase>]");
+    driver.cmdLine.add("--ds,--domain-step", _domainStep, "call `verilua_domain_step_safe()` on every posedge of each --clock-domain clock (Lua: `verilua.register_domain_step`)");
     driver.cmdLine.add("--vb,--verbose", _verbose, "verbose output");
     driver.cmdLine.add("--co,--check-output", _checkOutput, "check output");
     driver.cmdLine.add("--dr,--dryrun", _dryrun, "do not generate testbench");
     driver.cmdLine.add("-r,--regen", _regen, "force regeneration of testbench");
+    driver.cmdLine.add("--pa,--port-access", _portAccess, "also generate `<tbtop>_port_access.cpp`, a Verilator side-table giving libverilua direct (non-VPI) access to the testbench ports");
 
     // TODO: remove this
     driver.cmdLine.add("--nd,--nodpi", _nodpi, "disable dpi generation");
@@ -98,12 +104,21 @@ int main(int argc, const char *argv[]) {
     bool checkOutput                = _checkOutput.value_or(false);
     bool regen                      = _regen.value_or(false);
     bool nodpi                      = _checkOutput.value_or(true);
+    bool portAccess                 = _portAccess.value_or(false);
+    bool domainStep                 = _domainStep.value_or(false);
+
+    std::vector<ClockDomainInfo> clockDomains;
+    for (const auto &spec : _clockDomains) {
+        clockDomains.push_back(parseClockDomainSpec(spec));
+    }
 
     const std::string tbtopFilePath    = outdir + "/" + tbtopName + ".sv";
     const std::string othersFilePath   = outdir + "/" + "others.sv";
     const std::string metaInfoFilePath = outdir + "/tb_gen.meta.json";
+    const std::string portAccessFilePath = outdir + "/" + tbtopName + "_port_access.cpp";
+    const std::string clockDomainsFilePath = outdir + "/" + tbtopName + "_clock_domains.cpp";
 
-    bool shouldRegen = !fs::exists(tbtopFilePath) || !fs::exists(othersFilePath) || regen;
+    bool shouldRegen = !fs::exists(tbtopFilePath) || !fs::exists(othersFilePath) || regen || (portAccess && !fs::exists(portAccessFilePath)) || (!clockDomains.empty() && !fs::exists(clockDomainsFilePath));
 
     // Get command line into string
     std::string cmdLineStr = "";
@@ -294,6 +309,21 @@ int main(int argc, const char *argv[]) {
         fmt::println("[testbench_gen] reset={}", resetSignalName);
     }
 
+    // Extra clock domains must be plain 1-bit input ports other than the main clock/reset
+    std::set<std::string> clockDomainNames;
+    for (auto &domain : clockDomains) {
+        ASSERT(domain.name != clockSignalName && domain.name != resetSignalName, "Clock domain is already used as the main clock/reset signal", domain.name);
+        ASSERT(clockDomainNames.insert(domain.name).second, "Duplicated clock domain", domain.name);
+
+        auto port = std::find_if(portInfos.begin(), portInfos.end(), [&](PortInfo &p) { return p.name == domain.name; });
+        ASSERT(port != portInfos.end() && port->isInput(), "Clock domain is not an input port", domain.name);
+        ASSERT(port->dimensions.empty() && port->bitWidth <= 1, "Clock domain should be a 1-bit input port", port->toString());
+
+        if (verbose)
+            fmt::println("[testbench_gen] clock domain {}  period={}  phase={}", domain.name, domain.period, domain.phase);
+    }
+    metaInfoJson["clockDomains"] = clockDomains;
+
     { // Generate tbtop file
         auto tbtopFileContent = R"(
 //VCS coverage exclude_file
@@ -386,7 +416,7 @@ assign clock = {{clockSignalName}};
 wire {{resetSignalName}};
 assign {{resetSignalName}} = reset;
 `endif // SIM_VERILATOR
-{% endif %}
+{% endif %}{{clockDomainGen}}
 
 
 reg [63:0] cycles; // A timestamp counter for simulation, start from 0 and never reset
@@ -419,7 +449,7 @@ end
 // -----------------------------------------
 {{topName}} {{dutPortParamDecl}} {{dutName}} (
 {{signalConnect}}
-); // {{dutName}}
+); // {{dutName}}{{domainStepGen}}
 
 
 // -----------------------------------------
@@ -774,6 +804,53 @@ endmodule
         signalConnect = joinStrVec(signalConnVec, ",\n");
         regInitialize = joinStrVec(regInitializeVec, "\n");
 
+        // Extra clock domains: `#` delay generators for event driven simulators. Under
+        // Verilator the clocks are toggled natively by verilator_main.cpp, which reads
+        // the domains from `<tbtop>_clock_domains.cpp`.
+        std::string clockDomainGen = "";
+        std::string domainStepGen  = "";
+        if (!clockDomains.empty()) {
+            std::vector<std::string> clockGenVec;
+            std::vector<std::string> stepGenVec;
+            for (size_t i = 0; i < clockDomains.size(); i++) {
+                auto &domain = clockDomains[i];
+                std::string phaseDelay = domain.phase > 0 ? fmt::format("    #{};\n", domain.phase) : "";
+                clockGenVec.push_back(fmt::format("initial begin // period: {}, phase: {}\n{}    forever #{} {} = ~{};\nend", domain.period, domain.phase, phaseDelay, domain.period / 2.0, domain.name, domain.name));
+                stepGenVec.push_back(fmt::format("always @(posedge {0}) verilua_domain_step_safe({1}, \"{0}\");", domain.name, i));
+            }
+
+            clockDomainGen = fmt::format(R"(
+// -----------------------------------------
+// extra clock domains
+//    use `--clock-domain/--cd <clock>:<period>[:<phase>]`.
+//    Verilator: toggled by verilator_main.cpp
+// -----------------------------------------
+`ifndef SIM_VERILATOR
+`ifndef NO_INTERNAL_CLOCK
+{}
+`endif // NO_INTERNAL_CLOCK
+`endif // SIM_VERILATOR
+)",
+                                         joinStrVec(clockGenVec, "\n"));
+
+            if (domainStep) {
+                domainStepGen = fmt::format(R"(
+
+// -----------------------------------------
+// clock domain step hooks
+//    use `--domain-step/--ds`, register Lua functions
+//    with `verilua.register_domain_step(<clock>, func)`.
+// -----------------------------------------
+`ifndef SIM_IVERILOG
+import "DPI-C" function void verilua_domain_step_safe(input int domain_id, input string name);
+
+{}
+`endif // SIM_IVERILOG
+)",
+                                            joinStrVec(stepGenVec, "\n"));
+            }
+        }
+
         std::string tbtopPortParamDecl = "";
         std::string dutPortParamDecl   = "";
         if (portParamStmts.size() > 0) {
@@ -799,6 +876,8 @@ endmodule
         tbtopData["customCodeFileContent"]      = customCodeFileContent;
         tbtopData["customCodeStrOuter"]         = customCodeStrOuter;
         tbtopData["customCodeOuterFileContent"] = customCodeOuterFileContent;
+        tbtopData["clockDomainGen"]             = clockDomainGen;
+        tbtopData["domainStepGen"]              = domainStepGen;
 
         if (!std::filesystem::is_directory(outdir)) {
             if (verbose)
@@ -833,12 +912,117 @@ endmodule
             othersFile.close();
         }
 
+        if (portAccess) {
+            // Verilator side-table: resolves the storage of every packed port of
+            // `tbtopName` once at startup and registers it with libverilua
+            // (`direct_access.rs`), so `dut.<port>:get()/set()` become plain
+            // loads and stores. Unpacked arrays have no single scalar storage,
+            // they stay on VPI.
+            std::vector<std::string> bindVec;
+            for (auto &port : portInfos) {
+                if (!port.dimensions.empty() || port.bitWidth == 0) {
+                    continue;
+                }
+                bindVec.push_back(fmt::format("    bind(\"{1}\", \"{0}.{1}\", {2}); // {3}", tbtopName, port.name, port.bitWidth, port.toString()));
+            }
+
+            auto portAccessFileContent = fmt::format(R"(// -----------------------------------------
+// Verilator port access table generated by VERILUA (testbench_gen)
+//
+// Compiled together with the Verilated model. `verilua_port_access_init()`
+// is called by verilator_main.cpp before the simulation starts; it resolves
+// the storage of every packed `{0}` port (public via --public-flat-rw) and
+// registers it with libverilua, which then serves reads/writes of these
+// ports as direct loads/stores instead of VPI calls. Ports whose storage
+// cannot be found, or is not writable, are left to libverilua's own resolver.
+// -----------------------------------------
+#include "verilated.h"
+#include "verilated_syms.h"
+#include <cstdint>
+
+extern "C" void verilua_register_direct_signal(const char *path, void *datap, uint32_t width);
+
+extern "C" void verilua_port_access_init(void) {{
+    const VerilatedScope *scope = Verilated::threadContextp()->scopeFind("TOP.{0}");
+    if (scope == nullptr) {{
+        return;
+    }}
+
+    auto bind = [scope](const char *name, const char *path, uint32_t width) {{
+        const VerilatedVar *var = scope->varFind(name);
+        if (var != nullptr && var->isPublicRW()) {{
+            verilua_register_direct_signal(path, var->datap(), width);
+        }}
+    }};
+
+{1}
+}}
+)",
+                                                     tbtopName, joinStrVec(bindVec, "\n"));
+
+            std::ofstream portAccessFile(portAccessFilePath);
+            ASSERT(portAccessFile.is_open(), "Can't open file", portAccessFilePath);
+            portAccessFile << portAccessFileContent;
+            portAccessFile.close();
+
+            if (verbose)
+                fmt::println("[testbench_gen] port access table: {} ports → {}", bindVec.size(), portAccessFilePath);
+        }
+
+        if (!clockDomains.empty()) {
+            // Read by verilator_main.cpp (weak `verilua_clock_domain_*` symbols) to toggle the
+            // extra clocks natively, no VPI or Lua work per edge.
+            std::vector<std::string> domainVec;
+            for (auto &domain : clockDomains) {
+                domainVec.push_back(fmt::format("    {{\"{}\", {}, {}}},", domain.name, domain.period, domain.phase));
+            }
+
+            auto clockDomainsFileContent = fmt::format(R"(// -----------------------------------------
+// Verilator clock domain table generated by VERILUA (testbench_gen)
+//
+// `period` / `phase` are in the time unit of `{0}`, verilator_main.cpp
+// scales them to the time precision and toggles `TOP.{0}.<name>`.
+// -----------------------------------------
+#include <cstddef>
+
+struct {0}_ClockDomain {{
+    const char *name;
+    double period;
+    double phase;
+}};
+
+static const {0}_ClockDomain {0}_clock_domains[] = {{
+{1}
+}};
+
+extern "C" size_t verilua_clock_domain_num(void) {{ return sizeof({0}_clock_domains) / sizeof({0}_clock_domains[0]); }}
+
+extern "C" void verilua_clock_domain_get(size_t idx, const char **name, double *period, double *phase) {{
+    *name   = {0}_clock_domains[idx].name;
+    *period = {0}_clock_domains[idx].period;
+    *phase  = {0}_clock_domains[idx].phase;
+}}
+)",
+                                                       tbtopName, joinStrVec(domainVec, "\n"));
+
+            std::ofstream clockDomainsFile(clockDomainsFilePath);
+            ASSERT(clockDomainsFile.is_open(), "Can't open file", clockDomainsFilePath);
+            clockDomainsFile << clockDomainsFileContent;
+            clockDomainsFile.close();
+        }
+
         // Save othersFileMTime into meta info
         auto othersFileMTime            = std::filesystem::last_write_time(othersFilePath);
         metaInfoJson["othersFileMTime"] = to_time_t(othersFileMTime);
 
         // Save other infos into meta info
         metaInfoJson["outputFiles"] = {tbtopFilePath, othersFilePath};
+        if (portAccess) {
+            metaInfoJson["outputFiles"].push_back(portAccessFilePath);
+        }
+        if (!clockDomains.empty()) {
+            metaInfoJson["outputFiles"].push_back(clockDomainsFilePath);
+        }
         metaInfoJson["buildTime"]   = get_current_time_as_string();
 
         // Write meta info into a json file, which can be used next time to check if the output is up to date
@@ -846,7 +1030,7 @@ endmodule
         o << metaInfoJson.dump(4) << "\n";
         o.close();
 
-        fmt::println("[testbench_gen] generate  top={}  clk={}  rst={}  ports={}  → {}", topName, clockSignalName, resetSignalHasMatch ? resetSignalName : "?", portInfos.size(), tbtopFilePath);
+        fmt::println("[testbench_gen] generate  top={}  clk={}  rst={}  ports={}  domains={}  → {}", topName, clockSignalName, resetSignalHasMatch ? resetSignalName : "?", portInfos.size(), clockDomains.size(), tbtopFilePath);
     }
 
     if (checkOutput) {
@@ -15,6 +15,7 @@
 #include "slang/syntax/AllSyntax.h"
 #include "vl_assert.h"
 #include <array>
+#include <cstdint>
 #include <chrono>
 #include <cstdio>
 #include <filesystem>
@@ -132,6 +133,9 @@ using PortInfo = struct {
     bool isNet;
     int id; // port id
 
+    // Total bit width of the port type (0 if unknown)
+    uint64_t bitWidth = 0;
+
     bool isInput() { return dir == "input"; }
     bool isOutput() { return dir == "output"; }
     bool isInout() { return dir == "inout"; }
@@ -171,9 +175,51 @@ using PortInfo = struct {
     }
 };
 
+// Extra clock domain from `--clock-domain <clock>:<period>[:<phase>]`.
+// `period` and `phase` use the same time unit as `-p,--period`. The clock
+// starts at 0, waits `phase`, then toggles every `period / 2`.
+struct ClockDomainInfo {
+    std::string name;
+    double period = 0;
+    double phase  = 0;
+};
+
+inline ClockDomainInfo parseClockDomainSpec(const std::string &spec) {
+    std::vector<std::string> fields;
+    std::stringstream ss(spec);
+    std::string field;
+    while (std::getline(ss, field, ':')) {
+        fields.push_back(field);
+    }
+    ASSERT(fields.size() == 2 || fields.size() == 3, "Invalid clock domain spec, expected <clock>:<period>[:<phase>]", spec);
+    ASSERT(!fields[0].empty(), "Invalid clock domain spec, empty clock name", spec);
+
+    ClockDomainInfo info;
+    info.name = fields[0];
+    try {
+        info.period = std::stod(fields[1]);
+        info.phase  = fields.size() == 3 ? std::stod(fields[2]) : 0;
+    } catch (const std::exception &e) {
+        PANIC("Invalid clock domain spec, period/phase is not a number", spec);
+    }
+    ASSERT(info.period > 0, "Invalid clock domain spec, period should be positive", spec);
+    ASSERT(info.phase >= 0, "Invalid clock domain spec, phase should not be negative", spec);
+    return info;
+}
+
 namespace nlohmann {
+template <> struct adl_serializer<ClockDomainInfo> {
+    static void to_json(json &j, const ClockDomainInfo &c) { j = json{{"name", c.name}, {"period", c.period}, {"phase", c.phase}}; }
+
+    static void from_json(const json &j, ClockDomainInfo &c) {
+        j.at("name").get_to(c.name);
+        j.at("period").get_to(c.period);
+        j.at("phase").get_to(c.phase);
+    }
+};
+
 template <> struct adl_serializer<PortInfo> {
-    static void to_json(json &j, const PortInfo &p) { j = json{{"dir", p.dir}, {"type", p.type}, {"name", p.name}, {"dimensions", p.dimensions}, {"dimSizes", p.dimSizes}, {"isNet", p.isNet}, {"id", p.id}}; }
+    static void to_json(json &j, const PortInfo &p) { j = json{{"dir", p.dir}, {"type", p.type}, {"name", p.name}, {"dimensions", p.dimensions}, {"dimSizes", p.dimSizes}, {"isNet", p.isNet}, {"id", p.id}, {"bitWidth", p.bitWidth}}; }
 
     static void from_json(const json &j, PortInfo &p) {
         j.at("dir").get_to(p.dir);
@@ -183,6 +229,7 @@ template <> struct adl_serializer<PortInfo> {
         j.at("dimSizes").get_to(p.dimSizes);
         j.at("isNet").get_to(p.isNet);
         j.at("id").get_to(p.id);
+        p.bitWidth = j.value("bitWidth", uint64_t(0));
     }
 };
 } // namespace nlohmann
@@ -190,6 +190,7 @@ void TestbenchGenParser::handle(const InstanceBodySymbol &ast) {
             if (verbose)
                 fmt::println("[testbench_gen] port {}", p.toString());
             lastAnsiPortTypeStr = p.type;
+            p.bitWidth          = getPortSymbol(p.name)->getType().getBitWidth();
             portInfos.push_back(p);
         }));
 
@@ -323,6 +324,10 @@ void TestbenchGenParser::handle(const InstanceBodySymbol &ast) {
 
             lastNonAnsiPortTypeStr = ports[0].type;
 
+            for (auto &p : ports) {
+                p.bitWidth = getPortSymbol(p.name)->getType().getBitWidth();
+            }
+
             portInfos.insert(portInfos.end(), ports.begin(), ports.end());
         }));
     }
@@ -12,12 +12,17 @@
 /// ```lua
 ///     add_defines("NO_INTERNAL_CLOCK")
 /// ```
+///
+/// Extra clock domains (`testbench_gen --clock-domain <clock>:<period>[:<phase>]`) are toggled here as well,
+/// the domain table comes from the generated `<tb_top>_clock_domains.cpp` (also disabled by `NO_INTERNAL_CLOCK`).
 
 #include "Vtb_top.h"
 #include "verilated.h"
+#include "verilated_syms.h"
 #include "verilated_vpi.h"
 
 #include "lightsss.h"
+#include <algorithm>
 #include <cassert>
 #include <csignal>
 #include <cstddef>
@@ -28,6 +33,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #ifndef VERILATOR_STEP_TIME
@@ -106,7 +112,127 @@ extern "C" {
 void verilua_alloc_verilator_func(VerilatorFunc func, const char *name);
 void verilator_next_sim_time_callback(void);
 bool verilator_has_pending_put_values(void);
+bool verilator_take_direct_eval_needed(void);
+void verilua_set_direct_resolver(bool (*resolver)(const char *path, void **datap, uint32_t *width, bool *read_only));
 void vlog_startup_routines_bootstrap(void);
+
+// Defined by the `<tb_top>_port_access.cpp` side-table generated with
+// `testbench_gen --port-access`, absent otherwise.
+__attribute__((weak)) void verilua_port_access_init(void);
+
+// Defined by the `<tb_top>_clock_domains.cpp` table generated with
+// `testbench_gen --clock-domain ...`, absent otherwise.
+__attribute__((weak)) size_t verilua_clock_domain_num(void);
+__attribute__((weak)) void verilua_clock_domain_get(size_t idx, const char **name, double *period, double *phase);
+}
+
+// An extra clock domain, toggled natively without any VPI or Lua work per edge.
+// All times are in units of the time precision (same as `Verilated::time()`).
+struct ClockDomain {
+    std::string name;
+    CData *clk;
+    vluint64_t half_period;
+    vluint64_t next_edge;
+};
+
+static std::vector<ClockDomain> clock_domains;
+
+static void init_clock_domains() {
+    if (verilua_clock_domain_num == nullptr || verilua_clock_domain_get == nullptr) {
+        return;
+    }
+
+    const VerilatedScope *scope = Verilated::threadContextp()->scopeFind("TOP.tb_top");
+    VL_FATAL(scope != nullptr, "[init_clock_domains] scope `TOP.tb_top` not found");
+
+    // testbench_gen periods are in the time unit, Verilated time counts in the time precision
+    double scale = 1;
+    for (int i = Verilated::threadContextp()->timeprecision(); i < Verilated::threadContextp()->timeunit(); i++) {
+        scale *= 10;
+    }
+
+    size_t num = verilua_clock_domain_num();
+    for (size_t i = 0; i < num; i++) {
+        const char *name = nullptr;
+        double period = 0, phase = 0;
+        verilua_clock_domain_get(i, &name, &period, &phase);
+
+        double half_period = period * scale / 2;
+        VL_FATAL(half_period >= 1 && half_period == (vluint64_t)half_period, "[init_clock_domains] half period of `%s` is not a whole number of time precision steps: %f", name, half_period);
+
+        double phase_time = phase * scale;
+        VL_FATAL(phase_time >= 0 && phase_time == (vluint64_t)phase_time, "[init_clock_domains] phase of `%s` is not a whole number of time precision steps: %f", name, phase_time);
+
+        const VerilatedVar *var = scope->varFind(name);
+        VL_FATAL(var != nullptr && var->datap() != nullptr, "[init_clock_domains] clock `%s` not found in `TOP.tb_top`, it should be public (e.g. --public-flat-rw)", name);
+        // Toggled through a `CData *` below, so it has to be a plain 1-bit packed variable
+        VL_FATAL(var->vltype() == VLVT_UINT8, "[init_clock_domains] clock `%s` is not stored as CData (vltype: %d)", name, (int)var->vltype());
+        VL_FATAL(var->udims() == 0 && var->packed().elements() == 1, "[init_clock_domains] clock `%s` should be a 1-bit packed variable", name);
+
+        clock_domains.push_back(ClockDomain{name, static_cast<CData *>(var->datap()), (vluint64_t)half_period, (vluint64_t)phase_time + (vluint64_t)half_period});
+        VL_INFO("clock domain `%s`: half_period=%lu phase=%lu\n", name, (unsigned long)half_period, (unsigned long)phase_time);
+    }
+}
+
+// Toggle every clock domain whose edge falls on the current time
+static inline void toggle_clock_domains() {
+    const vluint64_t now = Verilated::time();
+    for (auto &domain : clock_domains) {
+        if (now >= domain.next_edge) {
+            *domain.clk = !*domain.clk;
+            domain.next_edge += domain.half_period;
+        }
+    }
+}
+
+static inline vluint64_t next_clock_domain_edge() {
+    vluint64_t next = static_cast<vluint64_t>(~0ULL);
+    for (auto &domain : clock_domains) {
+        next = std::min(next, domain.next_edge);
+    }
+    return next;
+}
+
+// Fallback for libverilua's direct signal access: resolve `a.b.c` (as used by
+// `dut.<path>`) to the storage of the public variable `c` in scope `TOP.a.b`.
+// Only packed variables without unpacked dimensions are handed out, anything
+// else (memories, parameters, strings, reals) stays on the VPI path. Variables
+// that are not public_rw (e.g. `public_flat_rd`) are flagged `read_only`:
+// libverilua reads them directly but keeps writes on the VPI path, which
+// rejects them like it does without direct access.
+static bool resolve_direct_signal(const char *path, void **datap, uint32_t *width, bool *read_only) {
+    std::string_view path_sv(path);
+    size_t dot = path_sv.rfind('.');
+    if (dot == std::string_view::npos) {
+        return false;
+    }
+
+    std::string scope_name = "TOP." + std::string(path_sv.substr(0, dot));
+    const VerilatedScope *scope = Verilated::threadContextp()->scopeFind(scope_name.c_str());
+    if (scope == nullptr) {
+        return false;
+    }
+
+    const VerilatedVar *var = scope->varFind(std::string(path_sv.substr(dot + 1)).c_str());
+    if (var == nullptr || var->datap() == nullptr || var->isParam() || var->udims() != 0) {
+        return false;
+    }
+
+    switch (var->vltype()) {
+    case VLVT_UINT8:
+    case VLVT_UINT16:
+    case VLVT_UINT32:
+    case VLVT_UINT64:
+    case VLVT_WDATA:
+        break;
+    default:
+        return false;
+    }
+
+    *datap     = var->datap();
+    *width     = var->packed().elements();
+    *read_only = !var->isPublicRW();
+    return true;
 }
 
 static volatile int got_sigint  = 0;
@@ -371,6 +497,16 @@ void Emulator::fork_child_init() {
 }
 
 void Emulator::start_simulation() {
+    // Register direct port storage before any Lua code creates a handle
+    if (verilua_port_access_init != nullptr) {
+        verilua_port_access_init();
+    }
+    verilua_set_direct_resolver(resolve_direct_signal);
+
+#ifndef NO_INTERNAL_CLOCK
+    init_clock_domains();
+#endif
+
     vlog_startup_routines_bootstrap();
     VerilatedVpi::callCbs(cbStartOfSimulation);
 }
@@ -417,6 +553,7 @@ int Emulator::normal_mode_main() {
         if ((Verilated::time() > 0) && (Verilated::time() % CLK_HALF_PERIOD) == 0) {
             dut_ptr->clock = !dut_ptr->clock;
         }
+        toggle_clock_domains();
 #endif
 
         // Call registered timed callbacks (e.g. clock timer)
@@ -433,7 +570,8 @@ int Emulator::normal_mode_main() {
                 VerilatedVpi::clearEvalNeeded();
                 VerilatedVpi::doInertialPuts();
                 settle_value_callbacks();
-            } while (VerilatedVpi::evalNeeded());
+                // Direct (non-VPI) stores from libverilua also need another eval
+            } while (VerilatedVpi::evalNeeded() || verilator_take_direct_eval_needed());
 
             // Run ReadWrite callback as we are done processing this eval step
             VerilatedVpi::callCbs(cbReadWriteSynch);
@@ -442,7 +580,7 @@ int Emulator::normal_mode_main() {
             // Keep looping while libverilua still has posted set() values queued
             // (writes posted by coroutines resumed inside cbReadWriteSynch are
             // invisible to evalNeeded() until their flush callback commits them).
-        } while (VerilatedVpi::evalNeeded() || verilator_has_pending_put_values());
+        } while (VerilatedVpi::evalNeeded() || verilator_has_pending_put_values() || verilator_take_direct_eval_needed());
 
         dut_ptr->eval_end_step();
 
@@ -455,7 +593,13 @@ int Emulator::normal_mode_main() {
 #endif
 
         // Increse simulation time for 1ps(default) when timescale is 1ns/1ps
-        Verilated::timeInc(VERILATOR_STEP_TIME);
+        if (clock_domains.empty()) {
+            Verilated::timeInc(VERILATOR_STEP_TIME);
+        } else {
+            // Also stop at every clock domain edge, then realign to the regular step
+            vluint64_t next_step = ((Verilated::time() / VERILATOR_STEP_TIME) + 1) * VERILATOR_STEP_TIME;
+            Verilated::time(std::min(next_step, next_clock_domain_edge()));
+        }
 
         // Call registered NextSimTime
         // It should be called in simulation cycle before everything else
@@ -504,6 +648,7 @@ int Emulator::timing_mode_main() {
         if ((Verilated::time() > 0) && (Verilated::time() % CLK_HALF_PERIOD) == 0) {
             dut_ptr->clock = !dut_ptr->clock;
         }
+        toggle_clock_domains();
 #endif
 
         // Call registered timed callbacks (e.g. clock timer)
@@ -523,7 +668,8 @@ int Emulator::timing_mode_main() {
                 VerilatedVpi::clearEvalNeeded();
                 VerilatedVpi::doInertialPuts();
                 settle_value_callbacks();
-            } while (VerilatedVpi::evalNeeded());
+                // Direct (non-VPI) stores from libverilua also need another eval
+            } while (VerilatedVpi::evalNeeded() || verilator_take_direct_eval_needed());
 
             // Run ReadWrite callback as we are done processing this eval step
             VerilatedVpi::callCbs(cbReadWriteSynch);
@@ -531,7 +677,7 @@ int Emulator::timing_mode_main() {
             settle_value_callbacks();
             // Keep looping while libverilua still has posted set() values queued
             // (see normal_mode_main for details).
-        } while (VerilatedVpi::evalNeeded() || verilator_has_pending_put_values());
+        } while (VerilatedVpi::evalNeeded() || verilator_has_pending_put_values() || verilator_take_direct_eval_needed());
 
         dut_ptr->eval_end_step();
 
@@ -562,7 +708,7 @@ int Emulator::timing_mode_main() {
             // value, which would cause the clock to never toggle again.
             vluint64_t current_time      = Verilated::time();
             vluint64_t next_clock_toggle = ((current_time / CLK_HALF_PERIOD) + 1) * CLK_HALF_PERIOD;
-            next_time                    = std::min(next_time, next_clock_toggle);
+            next_time                    = std::min({next_time, next_clock_toggle, next_clock_domain_edge()});
             Verilated::time(next_time);
         }
 #else
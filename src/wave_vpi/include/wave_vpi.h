@@ -52,6 +52,18 @@ inline bool is_hierarchy_only_mode() {
     return cached == 1;
 }
 
+// Check if stream mode is enabled (forward-only VCD reader, see wellen_impl/src/vcd_stream.rs).
+// NOTE: When using --stream CLI flag, setenv("WAVE_VPI_STREAM") must be called before the
+// first invocation of this function.
+inline bool is_stream_mode() {
+    static int cached = -1;
+    if (cached == -1) {
+        const char *val = std::getenv("WAVE_VPI_STREAM");
+        cached          = (val != nullptr && std::string(val) == "1") ? 1 : 0;
+    }
+    return cached == 1;
+}
+
 #define VL_INFO(...)                                                                                                                                                                                                                                                                                                                                                                                           \
     do {                                                                                                                                                                                                                                                                                                                                                                                                       \
         fmt::print("[{}:{}:{}] [{}INFO{}] ", __FILE__, __FUNCTION__, __LINE__, ANSI_COLOR_MAGENTA, ANSI_COLOR_RESET);                                                                                                                                                                                                                                                                                          \
@@ -85,6 +97,7 @@ uint64_t wellen_get_max_index();
 uint64_t wellen_get_time_from_index(uint64_t index);
 uint64_t wellen_get_index_from_time(uint64_t time);
 int32_t wellen_get_time_precision();
+bool wellen_stream_has_index(uint64_t index);
 
 char *wellen_get_value_str(void *handle, uint64_t time_table_idx);
 uint32_t wellen_get_int_value(void *handle, uint64_t time_table_index);
@@ -93,6 +106,7 @@ void wellen_vpi_get_value(void *handle, uint64_t time, p_vpi_value value_p);
 void wellen_vpi_get_value_from_index(void *handle, uint64_t time_table_idx, p_vpi_value value_p);
 
 void *wellen_vpi_handle_by_name(const char *name);
+void *wellen_vpi_scope_by_name(const char *name);
 PLI_INT32 wellen_vpi_get(PLI_INT32 property, void *handle);
 PLI_BYTE8 *wellen_vpi_get_str(PLI_INT32 property, void *object);
 void *wellen_vpi_iterate(PLI_INT32 type, void *refHandle);
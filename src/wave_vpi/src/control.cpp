@@ -19,6 +19,9 @@ extern "C" uint64_t wave_vpi_ctrl_get_max_cursor_time() { return cursor.maxTime;
 extern "C" void wave_vpi_ctrl_set_cursor_index(uint64_t index) { cursor.index = index; }
 
 extern "C" void wave_vpi_ctrl_set_cursor_index_percent(double percent) {
+#ifndef USE_FSDB
+    VL_FATAL(!is_stream_mode(), "set_cursor_index_percent is not supported in stream mode, the waveform length is unknown");
+#endif
     if (percent >= 100) {
         cursor.index = cursor.maxIndex - 1;
     } else {
@@ -66,6 +69,9 @@ extern "C" uint64_t wave_vpi_ctrl_get_jit_options(const char *opt_name) {
 }
 
 extern "C" void wave_vpi_ctrl_set_cursor_time(uint64_t time) {
+#ifndef USE_FSDB
+    VL_FATAL(!is_stream_mode(), "set_cursor_time is not supported in stream mode, use cbAfterDelay to move forward");
+#endif
     uint64_t targetIndex;
 #ifdef USE_FSDB
     targetIndex = fsdb_wave_vpi::fsdbWaveVpi->findNearestTimeIndex(time);
@@ -13,7 +13,8 @@
 //      OK => vpi_get(vpiSize, actual_handle);
 //      OK => vpi_iterate(vpiModule, ...)
 //      OK => vpi_scan(iterator)
-//      OK => vpi_handle_by_name(name)
+//      OK => vpi_handle_by_name(name, scope)
+//      OK => vpi_handle_by_index(object, index)
 //      OK => vpi_release_handle()
 //      OK => vpi_free_object()
 //      vpi_register_cb()
@@ -22,9 +23,6 @@
 //          -> cbValueChange       OK
 //          -> cbAfterDelay        OK
 //      vpi_remove_cb()            OK
-//
-// TODO:
-//      vpi_handle_by_index
 
 extern WaveCursor cursor;
 
@@ -57,6 +55,10 @@ std::unordered_set<void *> moduleHandleSet;
 std::unordered_set<void *> iteratorHandleSet;
 std::unordered_map<void *, PLI_INT32> iteratorTypeMap;
 
+// Full signal name -> interned SignalHandle. Handles are never freed (see vpi_free_object), so repeated
+// lookups of the same name (vpi_handle_by_name / vpi_handle_by_index / vpi_scan) share one SignalHandle.
+boost::unordered_flat_map<std::string, vpiHandle> signalHandleMap;
+
 struct ModuleHandle_t {
     void *wellenModuleHandle;
 };
@@ -84,6 +86,36 @@ void endOfSimulation() {
     }
 }
 
+vpiHandle internSignalHandle(const std::string &name, void *wellenHdl) {
+    if (auto it = signalHandleMap.find(name); it != signalHandleMap.end()) {
+        return it->second;
+    }
+
+    auto _vpiHdl = reinterpret_cast<vpiHandle>(wellenHdl);
+    auto bitSize = wellen_vpi_get(vpiSize, wellenHdl);
+    auto sigHdl  = new SignalHandle{.name = name, .vpiHdl = _vpiHdl, .bitSize = (size_t)bitSize};
+
+    // Only for signals with bitSize <= 32. TODO: Support signals with bitSize > 32.
+    // The JIT prefetches future steps from other threads, a streamed waveform can only be read at the cursor.
+    sigHdl->canOpt = bitSize <= 32 && !is_stream_mode();
+
+    auto vpiHdl = reinterpret_cast<vpiHandle>(sigHdl);
+    signalHandleSet.insert(reinterpret_cast<void *>(vpiHdl));
+    signalHandleMap.emplace(name, vpiHdl);
+    // hdlToNameMap[vpiHdl] = name; // For debug purpose
+    return vpiHdl;
+}
+
+// Full hierarchical name of a module or signal handle, used to resolve scope-relative and indexed lookups.
+std::string getFullName(vpiHandle object) {
+    auto objectRaw = reinterpret_cast<void *>(object);
+    if (moduleHandleSet.contains(objectRaw)) {
+        return std::string(wellen_vpi_get_str(vpiFullName, objectRaw));
+    }
+    VL_FATAL(signalHandleSet.contains(objectRaw), "object is neither a module handle nor a signal handle");
+    return reinterpret_cast<SignalHandlePtr>(object)->name;
+}
+
 std::string _wellen_get_value_str(vpiHandle sigHdl) {
     VL_FATAL(sigHdl != nullptr, "sigHdl is nullptr");
     auto vpiHdl = reinterpret_cast<SignalHandlePtr>(sigHdl)->vpiHdl;
@@ -127,6 +159,12 @@ vpiHandle vpi_register_cb(p_cb_data cb_data_p) {
             break;
         }
 
+        if (is_stream_mode()) {
+            // Keyed by time, resolved against the upcoming steps in wave_vpi_loop()
+            willAppendTimeCbQueue.emplace_back(std::make_pair(targetTime, std::make_shared<t_cb_data>(*cb_data_p)));
+            break;
+        }
+
         uint64_t targetIndex = wellen_get_index_from_time(targetTime);
         // VL_FATAL(targetTime <= cursor.maxTime, "targetTime: {}, cursor.maxTime: {}", targetTime, cursor.maxTime);
 
@@ -183,25 +221,29 @@ vpiHandle vpi_put_value(vpiHandle object, p_vpi_value value_p, p_vpi_time time_p
 }
 
 vpiHandle vpi_handle_by_name(PLI_BYTE8 *name, vpiHandle scope) {
-    // TODO: scope?
-    VL_FATAL(scope == nullptr, "TODO: scope is not supported for now");
-
-    auto _vpiHdl = reinterpret_cast<vpiHandle>(wellen_vpi_handle_by_name(name));
-    if (_vpiHdl == nullptr) {
-        return nullptr;
+    std::string fullName;
+    if (scope != nullptr) {
+        VL_FATAL(moduleHandleSet.contains(reinterpret_cast<void *>(scope)), "scope is not a module handle, name: {}", name);
+        fullName = getFullName(scope) + "." + name;
+    } else {
+        fullName = name;
     }
 
-    auto bitSize = wellen_vpi_get(vpiSize, reinterpret_cast<void *>(_vpiHdl));
-    auto sigHdl  = new SignalHandle{.name = std::string(name), .vpiHdl = _vpiHdl, .bitSize = (size_t)bitSize};
-
-    // Only for signals with bitSize <= 32. TODO: Support signals with bitSize > 32.
-    sigHdl->canOpt = bitSize <= 32;
+    if (auto it = signalHandleMap.find(fullName); it != signalHandleMap.end()) {
+        return it->second;
+    }
 
-    auto vpiHdl = reinterpret_cast<vpiHandle>(sigHdl);
+    auto wellenHdl = wellen_vpi_handle_by_name(fullName.c_str());
+    if (wellenHdl != nullptr) {
+        return internSignalHandle(fullName, wellenHdl);
+    }
 
-    signalHandleSet.insert(reinterpret_cast<void *>(vpiHdl));
-    // hdlToNameMap[vpiHdl] = std::string(name); // For debug purpose
-    return vpiHdl;
+    // Not a signal, maybe a scope (e.g. `top.u_core` or a generate block `top.gen[1]`)
+    auto moduleHdl = wellen_vpi_scope_by_name(fullName.c_str());
+    if (moduleHdl != nullptr) {
+        moduleHandleSet.insert(moduleHdl);
+    }
+    return reinterpret_cast<vpiHandle>(moduleHdl);
 }
 
 PLI_INT32 vpi_control(PLI_INT32 operation, ...) {
@@ -227,8 +269,10 @@ PLI_INT32 vpi_control(PLI_INT32 operation, ...) {
 }
 
 vpiHandle vpi_handle_by_index(vpiHandle object, PLI_INT32 indx) {
-    VL_FATAL(false, "TODO: vpi_handle_by_index is not supported for now");
-    return nullptr;
+    // Waveforms dump array elements / generate blocks as separately named objects, e.g. `mem[3]` or `gen[1]`
+    VL_FATAL(object != nullptr, "object is nullptr");
+    auto fullName = getFullName(object) + "[" + std::to_string(indx) + "]";
+    return vpi_handle_by_name(const_cast<PLI_BYTE8 *>(fullName.c_str()), nullptr);
 }
 
 vpiHandle vpi_iterate(PLI_INT32 type, vpiHandle refHandle) {
@@ -278,16 +322,7 @@ vpiHandle vpi_scan(vpiHandle iterator) {
         if (signalNamePtr == nullptr) {
             continue;
         }
-        auto bitSize = wellen_vpi_get(vpiSize, reinterpret_cast<void *>(next));
-        auto sigHdl  = new SignalHandle{
-             .name    = std::string(reinterpret_cast<char *>(signalNamePtr)),
-             .vpiHdl  = next,
-             .bitSize = static_cast<size_t>(bitSize),
-        };
-        sigHdl->canOpt = bitSize <= 32;
-        auto ret       = reinterpret_cast<vpiHandle>(sigHdl);
-        signalHandleSet.insert(reinterpret_cast<void *>(ret));
-        return ret;
+        return internSignalHandle(std::string(reinterpret_cast<char *>(signalNamePtr)), reinterpret_cast<void *>(next));
     }
 }
 
@@ -387,6 +422,16 @@ PLI_BYTE8 *vpi_get_str(PLI_INT32 property, vpiHandle sigHdl) {
         }
         return nullptr;
     }
+    case vpiFullName: {
+        if (moduleHandleSet.contains(sigHdlRaw)) {
+            return reinterpret_cast<PLI_BYTE8 *>(wellen_vpi_get_str(property, sigHdlRaw));
+        }
+
+        if (signalHandleSet.contains(sigHdlRaw)) {
+            return const_cast<PLI_BYTE8 *>(reinterpret_cast<SignalHandlePtr>(sigHdl)->name.c_str());
+        }
+        return nullptr;
+    }
     case vpiType: {
         if (moduleHandleSet.contains(sigHdlRaw)) {
             return reinterpret_cast<PLI_BYTE8 *>(wellen_vpi_get_str(property, sigHdlRaw));
@@ -48,7 +48,11 @@ void wave_vpi_init(const char *filename) {
 #else
     wellen_initialize(filename);
 
-    if (!is_hierarchy_only_mode()) {
+    if (is_stream_mode()) {
+        // The length of a streamed waveform is unknown until its end, see wave_vpi_loop()
+        cursor.maxIndex = UINT64_MAX;
+        cursor.maxTime  = UINT64_MAX;
+    } else if (!is_hierarchy_only_mode()) {
         cursor.maxIndex = wellen_get_max_index();
         cursor.maxTime  = wellen_get_time_from_index(cursor.maxIndex);
     }
@@ -94,11 +98,36 @@ void wave_vpi_loop() {
         fmt::println("[wave_vpi::loop] START! cursor.maxIndex => {} cursor.maxTime => {}", cursor.maxIndex, cursor.maxTime);
     }
 
-    while (cursor.index < cursor.maxIndex && !vpi_compat::vpiControlTerminate) {
+#ifdef USE_FSDB
+    constexpr bool streamMode = false;
+#else
+    const bool streamMode = is_stream_mode();
+#endif
+
+    // In stream mode the loop runs while the next step exists, which is the same as `cursor.index < cursor.maxIndex`
+    // for a waveform with `cursor.maxIndex + 1` steps.
+    auto hasNextStep = [&]() {
+#ifndef USE_FSDB
+        if (streamMode) {
+            return wellen_stream_has_index(cursor.index + 1);
+        }
+#endif
+        return cursor.index < cursor.maxIndex;
+    };
+
+    while (hasNextStep() && !vpi_compat::vpiControlTerminate) {
         // Deal with cbAfterDelay(time) callbacks
         if (!vpi_compat::timeCbMap.empty()) {
+            // In stream mode timeCbMap is keyed by target time (the target index is unknown ahead of time), a callback
+            // fires on the last step at or before its target time, like `wellen_get_index_from_time` would resolve it.
+            uint64_t nextTime = 0;
+#ifndef USE_FSDB
+            if (streamMode) {
+                nextTime = wellen_get_time_from_index(cursor.index + 1);
+            }
+#endif
             for (auto it = vpi_compat::timeCbMap.begin(); it != vpi_compat::timeCbMap.end();) {
-                if (cursor.index >= it->first) {
+                if (streamMode ? nextTime > it->first : cursor.index >= it->first) {
                     auto cbVec = it->second;
                     for (auto &cb : cbVec) {
                         cb->cb_rtn(cb.get());
@@ -31,11 +31,15 @@ int main(int argc, const char *argv[]) {
         std::cerr << prog << " " << VERILUA_VERSION << "\n"
                   << "  -w, --wave-file FILE   " << waveHelp << "\n"
                   << "  --hierarchy-only       only load hierarchy, skip signal data and time table\n"
+                  << "  --lazy-load            load signal data on first access (WAVE_VPI_LAZY_MEM_BUDGET_MB caps memory)\n"
+                  << "  --stream               read a VCD forward-only with bounded memory (WAVE_VPI_STREAM_WINDOW_MB)\n"
                   << "  -h, --help             show this help\n";
     };
 
     std::string waveFileArg;
     bool hierarchyOnly = false;
+    bool lazyLoad      = false;
+    bool stream        = false;
     for (int i = 1; i < argc; ++i) {
         const char *arg = argv[i];
         if (std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "--help") == 0) {
@@ -46,6 +50,14 @@ int main(int argc, const char *argv[]) {
             hierarchyOnly = true;
             continue;
         }
+        if (std::strcmp(arg, "--lazy-load") == 0) {
+            lazyLoad = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--stream") == 0) {
+            stream = true;
+            continue;
+        }
         if (std::strcmp(arg, "-w") == 0 || std::strcmp(arg, "--wave-file") == 0) {
             if (i + 1 >= argc) {
                 std::cerr << "missing value for " << arg << '\n';
@@ -89,6 +101,16 @@ int main(int argc, const char *argv[]) {
         setenv("WAVE_VPI_HIERARCHY_ONLY", "1", 1);
     }
 
+    // Bridge --lazy-load CLI flag to env var read by wellen_initialize (ignored by the FSDB backend).
+    if (lazyLoad) {
+        setenv("WAVE_VPI_LAZY_LOAD", "1", 1);
+    }
+
+    // Bridge --stream CLI flag to env var so all is_stream_mode() checks work (ignored by the FSDB backend).
+    if (stream) {
+        setenv("WAVE_VPI_STREAM", "1", 1);
+    }
+
     wave_vpi_init(waveFile.c_str());
 
     if (!is_quiet_mode()) {
@@ -0,0 +1,601 @@
+//! Lazy signal store used when `WAVE_VPI_LAZY_LOAD=1`.
+//!
+//! `wellen_vpi_handle_by_name` only registers a signal here, its data is
+//! loaded on the first value access. Every signal registered but not loaded
+//! yet is loaded in the same `load_signals` call (which loads in parallel), so
+//! a checker that resolves 200 handles at startup pays for one batched load.
+//!
+//! Loaded signals count against a memory budget, when it is exceeded the least
+//! recently used signals are dropped and reloaded on their next access.
+//!
+//! ## Read path
+//!
+//! Keys are dense indices (`SignalRef::index`), every key owns a slot in a
+//! table of fixed size chunks that are allocated on registration and never
+//! moved. Reading a loaded signal is two atomic loads and pinning a reader
+//! slot, no lock, no hashing and no reference count per value.
+//!
+//! Eviction only unlinks the data from its slot and retires it with the
+//! current epoch, which it then advances. Every `Loaded` guard publishes the
+//! epoch it started in in a reader slot of its own; retired data is freed (on
+//! the next load and on drop) once every pinned reader started after it was
+//! retired. A JIT thread still reading an evicted signal through its guard is
+//! safe, and readers that keep overlapping do not hold back what was retired
+//! before they started.
+//!
+//! ## LRU
+//!
+//! Readers stamp the slot with a global tick. Loaded slots are kept in a
+//! min-heap on the tick they had when they were pushed; an entry whose slot
+//! was read since is pushed again with the new tick instead of being evicted,
+//! so the victim is always the least recently used signal, without a scan.
+
+use std::cell::Cell;
+use std::cmp::Reverse;
+use std::collections::BinaryHeap;
+use std::ops::Deref;
+use std::ptr;
+use std::sync::atomic::{AtomicPtr, AtomicU64, AtomicUsize, Ordering};
+use std::sync::{Mutex, OnceLock};
+
+/// Keys of a `LazyStore`: dense indices below the capacity given to `new`.
+pub trait SlotKey: Copy + Eq {
+    fn slot(self) -> usize;
+}
+
+impl SlotKey for u32 {
+    fn slot(self) -> usize {
+        self as usize
+    }
+}
+
+const CHUNK: usize = 1024;
+
+/// `heap_tick` of a slot without entry in the LRU heap
+const NOT_IN_HEAP: u64 = u64::MAX;
+
+/// Guards that can be alive at once with a reader slot of their own, the
+/// others share `LazyStore::overflow_readers`
+const READER_SLOTS: usize = 64;
+
+/// Epoch of a reader slot without guard
+const IDLE: u64 = u64::MAX;
+
+/// Epoch a guard started in, on its own cache line
+#[repr(align(64))]
+struct ReaderSlot {
+    epoch: AtomicU64,
+}
+
+static NEXT_READER_HINT: AtomicUsize = AtomicUsize::new(0);
+
+thread_local! {
+    /// Reader slot this thread tries first, spreads the threads over the slots
+    static READER_HINT: Cell<usize> =
+        Cell::new(NEXT_READER_HINT.fetch_add(1, Ordering::Relaxed) % READER_SLOTS);
+}
+
+struct Slot<T, M> {
+    meta: OnceLock<M>,
+    /// `Box<T>` of the loaded data, null when not loaded
+    data: AtomicPtr<T>,
+    last_use: AtomicU64,
+    // Only accessed with the store lock held
+    bytes: AtomicUsize,
+    heap_tick: AtomicU64,
+}
+
+impl<T, M> Slot<T, M> {
+    fn new() -> Self {
+        Self {
+            meta: OnceLock::new(),
+            data: AtomicPtr::new(ptr::null_mut()),
+            last_use: AtomicU64::new(0),
+            bytes: AtomicUsize::new(0),
+            heap_tick: AtomicU64::new(NOT_IN_HEAP),
+        }
+    }
+}
+
+struct Inner<K, T> {
+    pending: Vec<K>,
+    lru: BinaryHeap<Reverse<(u64, usize)>>,
+    /// Evicted data that a reader may still use, with the epoch it was retired in
+    retired: Vec<(u64, *mut T)>,
+    signals: usize,
+    used_bytes: usize,
+    peak_bytes: usize,
+    load_calls: usize,
+    loaded: usize,
+    evicted: usize,
+}
+
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct LazyStats {
+    pub signals: usize,
+    pub load_calls: usize,
+    pub loaded: usize,
+    pub evicted: usize,
+    pub used_bytes: usize,
+    pub peak_bytes: usize,
+    /// Evicted but not yet freed
+    pub retired: usize,
+}
+
+/// Data of a loaded signal, valid as long as the guard lives even if the
+/// signal is evicted in the meantime.
+pub struct Loaded<'a, T> {
+    data: *const T,
+    pin: Pin<'a>,
+}
+
+/// What a guard holds to keep retired data alive
+enum Pin<'a> {
+    /// Its own reader slot, set to the epoch it started in
+    Slot(&'a AtomicU64),
+    /// No free reader slot: nothing is freed while it lives
+    Overflow(&'a AtomicUsize),
+}
+
+impl<T> Deref for Loaded<'_, T> {
+    type Target = T;
+
+    fn deref(&self) -> &T {
+        unsafe { &*self.data }
+    }
+}
+
+impl<T> Drop for Loaded<'_, T> {
+    fn drop(&mut self) {
+        match self.pin {
+            Pin::Slot(epoch) => epoch.store(IDLE, Ordering::SeqCst),
+            Pin::Overflow(readers) => {
+                readers.fetch_sub(1, Ordering::SeqCst);
+            }
+        }
+    }
+}
+
+pub struct LazyStore<K, T, M> {
+    chunks: Box<[AtomicPtr<Slot<T, M>>]>,
+    inner: Mutex<Inner<K, T>>,
+    reader_slots: Box<[ReaderSlot]>,
+    /// Guards alive without reader slot, evicted data is not freed while non-zero
+    overflow_readers: AtomicUsize,
+    /// Advanced by every eviction
+    epoch: AtomicU64,
+    tick: AtomicU64,
+    /// 0 means unlimited
+    budget_bytes: usize,
+    size_of: fn(&T) -> usize,
+}
+
+// The raw pointers are owned by the store, data is only shared through `Loaded`.
+unsafe impl<K: Send, T: Send + Sync, M: Send + Sync> Send for LazyStore<K, T, M> {}
+unsafe impl<K: Send, T: Send + Sync, M: Send + Sync> Sync for LazyStore<K, T, M> {}
+
+impl<K: SlotKey, T, M: Copy> LazyStore<K, T, M> {
+    /// A store for keys below `capacity`.
+    pub fn new(capacity: usize, budget_bytes: usize, size_of: fn(&T) -> usize) -> Self {
+        Self {
+            chunks: (0..capacity.div_ceil(CHUNK))
+                .map(|_| AtomicPtr::new(ptr::null_mut()))
+                .collect(),
+            inner: Mutex::new(Inner {
+                pending: Vec::new(),
+                lru: BinaryHeap::new(),
+                retired: Vec::new(),
+                signals: 0,
+                used_bytes: 0,
+                peak_bytes: 0,
+                load_calls: 0,
+                loaded: 0,
+                evicted: 0,
+            }),
+            reader_slots: (0..READER_SLOTS)
+                .map(|_| ReaderSlot {
+                    epoch: AtomicU64::new(IDLE),
+                })
+                .collect(),
+            overflow_readers: AtomicUsize::new(0),
+            epoch: AtomicU64::new(0),
+            tick: AtomicU64::new(0),
+            budget_bytes,
+            size_of,
+        }
+    }
+
+    #[inline(always)]
+    fn slot(&self, key: K) -> Option<&Slot<T, M>> {
+        let index = key.slot();
+        let chunk = self.chunks.get(index / CHUNK)?.load(Ordering::Acquire);
+        if chunk.is_null() {
+            return None;
+        }
+        Some(unsafe { &*chunk.add(index % CHUNK) })
+    }
+
+    /// Register `key` for loading on the next access of any pending signal.
+    /// Registering a known key is a no-op.
+    ///
+    /// # Panics
+    /// If `key` is not below the capacity of the store.
+    pub fn register(&self, key: K, meta: M) {
+        let mut inner = self.inner.lock().unwrap();
+        let index = key.slot();
+        let chunk = self
+            .chunks
+            .get(index / CHUNK)
+            .expect("[LazyStore] signal index is out of range");
+        if chunk.load(Ordering::Acquire).is_null() {
+            let slots: Box<[Slot<T, M>]> = (0..CHUNK).map(|_| Slot::new()).collect();
+            chunk.store(Box::into_raw(slots) as *mut Slot<T, M>, Ordering::Release);
+        }
+
+        if self.slot(key).unwrap().meta.set(meta).is_ok() {
+            inner.pending.push(key);
+            inner.signals += 1;
+        }
+    }
+
+    pub fn meta(&self, key: K) -> Option<M> {
+        self.slot(key).and_then(|slot| slot.meta.get().copied())
+    }
+
+    /// Data of `key`, loading it together with all pending keys if needed.
+    /// `load` gets the keys to load and returns them with their data, it is
+    /// called with the store lock held.
+    ///
+    /// # Panics
+    /// If `key` was never registered or `load` does not return it.
+    #[inline(always)]
+    pub fn get(&self, key: K, load: impl FnOnce(&[K]) -> Vec<(K, T)>) -> Loaded<'_, T> {
+        let slot = self
+            .slot(key)
+            .filter(|slot| slot.meta.get().is_some())
+            .expect("[LazyStore] signal is not registered");
+
+        // Pinned before the data is read: `evict` unlinks before it advances
+        // the epoch, so either this reader started no later than the data was
+        // retired (and keeps it alive) or it sees null.
+        let pin = self.pin();
+        let mut loaded = Loaded {
+            data: slot.data.load(Ordering::SeqCst),
+            pin,
+        };
+        slot.last_use.store(
+            self.tick.fetch_add(1, Ordering::Relaxed) + 1,
+            Ordering::Relaxed,
+        );
+        if loaded.data.is_null() {
+            loaded.data = self.load_slow(key, slot, load);
+        }
+        loaded
+    }
+
+    /// Publish the current epoch in a free reader slot, preferably the one
+    /// this thread used last.
+    #[inline(always)]
+    fn pin(&self) -> Pin<'_> {
+        let epoch = self.epoch.load(Ordering::SeqCst);
+        let hint = READER_HINT.with(Cell::get);
+        for i in 0..READER_SLOTS {
+            let index = (hint + i) % READER_SLOTS;
+            let slot = &self.reader_slots[index].epoch;
+            if slot
+                .compare_exchange(IDLE, epoch, Ordering::SeqCst, Ordering::Relaxed)
+                .is_ok()
+            {
+                if i != 0 {
+                    READER_HINT.with(|h| h.set(index));
+                }
+                return Pin::Slot(slot);
+            }
+        }
+        self.overflow_readers.fetch_add(1, Ordering::SeqCst);
+        Pin::Overflow(&self.overflow_readers)
+    }
+
+    /// Free the retired data no pinned reader can still use: everything
+    /// retired before the oldest pinned reader started.
+    fn reclaim(&self, inner: &mut Inner<K, T>) {
+        if inner.retired.is_empty() || self.overflow_readers.load(Ordering::SeqCst) != 0 {
+            return;
+        }
+        let oldest = self
+            .reader_slots
+            .iter()
+            .map(|slot| slot.epoch.load(Ordering::SeqCst))
+            .min()
+            .unwrap_or(IDLE);
+        inner.retired.retain(|&(epoch, data)| {
+            if epoch < oldest {
+                drop(unsafe { Box::from_raw(data) });
+                false
+            } else {
+                true
+            }
+        });
+    }
+
+    #[cold]
+    fn load_slow(
+        &self,
+        key: K,
+        slot: &Slot<T, M>,
+        load: impl FnOnce(&[K]) -> Vec<(K, T)>,
+    ) -> *const T {
+        let mut guard = self.inner.lock().unwrap();
+        let inner = &mut *guard;
+
+        // Another thread may have loaded it while this one was waiting for the lock
+        let mut data = slot.data.load(Ordering::Acquire);
+        if data.is_null() {
+            // Evicted signals are not in `pending`, load them along with the pending ones.
+            let mut keys = std::mem::take(&mut inner.pending);
+            if !keys.contains(&key) {
+                keys.push(key);
+            }
+
+            inner.load_calls += 1;
+            let tick = slot.last_use.load(Ordering::Relaxed);
+            for (k, signal) in load(&keys) {
+                let Some(s) = self.slot(k) else {
+                    continue;
+                };
+                if s.meta.get().is_none() || !s.data.load(Ordering::Relaxed).is_null() {
+                    continue;
+                }
+
+                let bytes = (self.size_of)(&signal);
+                let last_use = if k == key {
+                    tick
+                } else {
+                    s.last_use.load(Ordering::Relaxed).max(tick - 1)
+                };
+                s.last_use.store(last_use, Ordering::Relaxed);
+                s.bytes.store(bytes, Ordering::Relaxed);
+                s.heap_tick.store(last_use, Ordering::Relaxed);
+                inner.lru.push(Reverse((last_use, k.slot())));
+                inner.used_bytes += bytes;
+                inner.loaded += 1;
+                s.data
+                    .store(Box::into_raw(Box::new(signal)), Ordering::Release);
+            }
+            inner.peak_bytes = inner.peak_bytes.max(inner.used_bytes);
+
+            data = slot.data.load(Ordering::Relaxed);
+            assert!(
+                !data.is_null(),
+                "[LazyStore] signal is missing from the loaded batch"
+            );
+            self.evict(inner, key.slot());
+        }
+
+        self.reclaim(inner);
+        data
+    }
+
+    /// Drop least recently used signals until the budget is met, `keep` is never dropped.
+    fn evict(&self, inner: &mut Inner<K, T>, keep: usize) {
+        if self.budget_bytes == 0 {
+            return;
+        }
+
+        let mut kept = None;
+        while inner.used_bytes > self.budget_bytes {
+            let Some(Reverse((tick, index))) = inner.lru.pop() else {
+                break;
+            };
+            let slot = unsafe {
+                &*self.chunks[index / CHUNK]
+                    .load(Ordering::Relaxed)
+                    .add(index % CHUNK)
+            };
+            // Stale entry of a slot evicted (and maybe reloaded) since
+            if slot.heap_tick.load(Ordering::Relaxed) != tick {
+                continue;
+            }
+            if index == keep {
+                kept = Some(tick);
+                continue;
+            }
+            // Read since it was pushed: not the least recently used anymore
+            let last_use = slot.last_use.load(Ordering::Relaxed);
+            if last_use != tick {
+                slot.heap_tick.store(last_use, Ordering::Relaxed);
+                inner.lru.push(Reverse((last_use, index)));
+                continue;
+            }
+
+            slot.heap_tick.store(NOT_IN_HEAP, Ordering::Relaxed);
+            let data = slot.data.swap(ptr::null_mut(), Ordering::SeqCst);
+            let epoch = self.epoch.fetch_add(1, Ordering::SeqCst);
+            inner.retired.push((epoch, data));
+            inner.used_bytes -= slot.bytes.swap(0, Ordering::Relaxed);
+            inner.evicted += 1;
+        }
+        if let Some(tick) = kept {
+            inner.lru.push(Reverse((tick, keep)));
+        }
+    }
+
+    pub fn stats(&self) -> LazyStats {
+        let inner = self.inner.lock().unwrap();
+        LazyStats {
+            signals: inner.signals,
+            load_calls: inner.load_calls,
+            loaded: inner.loaded,
+            evicted: inner.evicted,
+            used_bytes: inner.used_bytes,
+            peak_bytes: inner.peak_bytes,
+            retired: inner.retired.len(),
+        }
+    }
+}
+
+impl<K, T, M> Drop for LazyStore<K, T, M> {
+    fn drop(&mut self) {
+        for (_, data) in self.inner.get_mut().unwrap().retired.drain(..) {
+            drop(unsafe { Box::from_raw(data) });
+        }
+        for chunk in self.chunks.iter() {
+            let chunk = chunk.load(Ordering::Relaxed);
+            if chunk.is_null() {
+                continue;
+            }
+            let slots = unsafe { Box::from_raw(ptr::slice_from_raw_parts_mut(chunk, CHUNK)) };
+            for slot in slots.iter() {
+                let data = slot.data.load(Ordering::Relaxed);
+                if !data.is_null() {
+                    drop(unsafe { Box::from_raw(data) });
+                }
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::cell::RefCell;
+
+    fn load_bytes(keys: &[u32]) -> Vec<(u32, Vec<u8>)> {
+        keys.iter().map(|&k| (k, vec![k as u8; 100])).collect()
+    }
+
+    #[test]
+    fn test_lazy_store_batches_pending_loads() {
+        let store = LazyStore::<u32, Vec<u8>, char>::new(16, 0, |v| v.len());
+        for k in 0..4 {
+            store.register(k, 'a');
+        }
+        store.register(0, 'b'); // already registered
+        assert_eq!(store.meta(0), Some('a'));
+        assert_eq!(store.meta(5), None);
+        assert_eq!(store.stats().load_calls, 0);
+
+        let batches = RefCell::new(Vec::new());
+        let load = |keys: &[u32]| {
+            batches.borrow_mut().push(keys.to_vec());
+            load_bytes(keys)
+        };
+        assert_eq!(store.get(2, load)[0], 2);
+        assert_eq!(store.get(3, load)[0], 3);
+        assert_eq!(*batches.borrow(), vec![vec![0, 1, 2, 3]]);
+
+        let stats = store.stats();
+        assert_eq!((stats.load_calls, stats.loaded, stats.evicted), (1, 4, 0));
+        assert_eq!(stats.used_bytes, 400);
+    }
+
+    #[test]
+    fn test_lazy_store_evicts_lru_under_budget() {
+        let store = LazyStore::<u32, Vec<u8>, ()>::new(16, 250, |v| v.len());
+        store.register(0, ());
+        store.register(1, ());
+        let held = store.get(0, load_bytes); // loads 0 and 1
+        store.register(2, ());
+        store.get(1, load_bytes);
+        store.get(2, load_bytes); // 300 bytes > 250, drops 0 (least recently used)
+
+        let stats = store.stats();
+        assert_eq!((stats.loaded, stats.evicted, stats.used_bytes), (3, 1, 200));
+        assert_eq!(stats.peak_bytes, 300);
+        assert_eq!(held[0], 0, "evicted data stays valid for holders");
+        drop(held);
+
+        // Reloading 0 drops 1 (now the least recently used) but never 0 itself
+        let batches = RefCell::new(Vec::new());
+        store.get(0, |keys: &[u32]| {
+            batches.borrow_mut().push(keys.to_vec());
+            load_bytes(keys)
+        });
+        assert_eq!(*batches.borrow(), vec![vec![0]]);
+        let stats = store.stats();
+        assert_eq!(
+            (stats.load_calls, stats.evicted, stats.used_bytes),
+            (3, 2, 200)
+        );
+        store.get(2, |_: &[u32]| panic!("2 must still be loaded"));
+    }
+
+    #[test]
+    fn test_lazy_store_single_signal_over_budget() {
+        let store = LazyStore::<u32, Vec<u8>, ()>::new(16, 50, |v| v.len());
+        store.register(7, ());
+        assert_eq!(store.get(7, load_bytes).len(), 100);
+        assert_eq!(store.stats().used_bytes, 100);
+    }
+
+    #[test]
+    #[should_panic(expected = "not registered")]
+    fn test_lazy_store_unregistered_key() {
+        let store = LazyStore::<u32, Vec<u8>, ()>::new(4096, 0, |v| v.len());
+        store.register(1, ());
+        store.get(2000, load_bytes);
+    }
+
+    #[test]
+    fn test_lazy_store_reclaims_under_overlapping_readers() {
+        // There is always a guard alive, the previous one is only dropped once
+        // the next is taken: what was retired before the older guard started
+        // must still be freed
+        let store = LazyStore::<u32, Vec<u8>, ()>::new(64, 200, |v| v.len());
+        for k in 0..64 {
+            store.register(k, ());
+        }
+        let mut prev = store.get(0, load_bytes);
+        for i in 1..2000u32 {
+            let cur = store.get(i % 64, load_bytes);
+            assert_eq!(cur[0], (i % 64) as u8);
+            assert_eq!(prev[0], ((i - 1) % 64) as u8);
+            prev = cur;
+            // The first load evicted all but two of the batch while `prev` was alive
+            if i > 1 {
+                assert!(store.stats().retired <= 4, "retired data is not reclaimed");
+            }
+        }
+        assert!(store.stats().evicted > 1000);
+        drop(prev);
+
+        // More guards than reader slots: the rest share the overflow count
+        let held: Vec<_> = (0..READER_SLOTS as u32 + 8)
+            .map(|i| store.get(i % 2, load_bytes))
+            .collect();
+        assert!(held.iter().enumerate().all(|(i, d)| d[0] == (i % 2) as u8));
+        drop(held);
+        assert_eq!(store.overflow_readers.load(Ordering::SeqCst), 0);
+        assert!(
+            store
+                .reader_slots
+                .iter()
+                .all(|slot| slot.epoch.load(Ordering::SeqCst) == IDLE)
+        );
+    }
+
+    #[test]
+    fn test_lazy_store_concurrent_reads_while_evicting() {
+        // Room for 4 of 64 signals: nearly every slow path evicts one that
+        // another thread may be reading
+        let store = LazyStore::<u32, Vec<u8>, ()>::new(64, 400, |v| v.len());
+        for k in 0..64 {
+            store.register(k, ());
+        }
+        std::thread::scope(|s| {
+            for t in 0..4u32 {
+                let store = &store;
+                s.spawn(move || {
+                    for i in 0..20000u32 {
+                        let k = (i * 7 + t * 13) % 64;
+                        let data = store.get(k, load_bytes);
+                        assert!(data.iter().all(|&b| b == k as u8));
+                    }
+                });
+            }
+        });
+        let stats = store.stats();
+        assert!(stats.evicted > 0);
+        assert!(stats.used_bytes <= 400);
+    }
+}
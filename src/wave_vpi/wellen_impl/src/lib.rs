@@ -3,20 +3,27 @@
 
 use byteorder::{BigEndian, ByteOrder};
 use serde::{Deserialize, Serialize};
-use std::borrow::Borrow;
+use std::borrow::Cow;
 use std::cell::{RefCell, UnsafeCell};
 use std::collections::{HashMap, HashSet};
 use std::ffi::{CStr, CString};
 use std::fs;
 use std::fs::File;
 use std::io::{BufReader, BufWriter};
+use std::ops::Deref;
 use std::os::raw::{c_char, c_void};
 use std::os::unix::fs::MetadataExt;
 use std::ptr::addr_of;
 use std::time::{Instant, UNIX_EPOCH};
 use wellen::*;
 
+mod lazy_signals;
+mod path_index;
+mod vcd_stream;
 mod vpi_user;
+use lazy_signals::{LazyStore, Loaded, SlotKey};
+use path_index::PathIndex;
+use vcd_stream::VcdStream;
 use vpi_user::*;
 
 #[allow(non_camel_case_types)]
@@ -43,6 +50,21 @@ struct SignalInfo {
     pub var_type: VarType,
 }
 
+/// What the lazy store needs to answer `vpiSize` / `vpiType` without loading the signal.
+#[derive(Debug, Clone, Copy)]
+struct LazySignalMeta {
+    var_type: VarType,
+    width: Option<u32>,
+}
+
+type LazySignals = LazyStore<SignalRef, Signal, LazySignalMeta>;
+
+impl SlotKey for SignalRef {
+    fn slot(self) -> usize {
+        self.index()
+    }
+}
+
 const LOAD_OPTS: LoadOptions = LoadOptions {
     multi_thread: true,
     remove_scopes_with_empty_name: false,
@@ -56,6 +78,8 @@ const SIGNAL_CACHE_FILE: &str = ".wave_vpi.signal.bin";
 
 static mut TIME_TABLE: Option<UnsafeCell<Vec<u64>>> = None;
 static mut HIERARCHY: Option<UnsafeCell<Hierarchy>> = None;
+// Dotted path -> scope / var, built once from HIERARCHY.
+static mut PATH_INDEX: Option<PathIndex> = None;
 static mut WAVE_SOURCE: Option<UnsafeCell<SignalSource>> = None;
 static mut WAVE_FILE_MODIFIED: Option<FileModifiedInfo> = None;
 
@@ -64,6 +88,10 @@ static mut SIGNAL_REF_CACHE_NULL: Option<UnsafeCell<HashSet<String>>> = None;
 static mut SIGNAL_CACHE: Option<UnsafeCell<HashMap<SignalRef, SignalInfo>>> = None;
 static mut SIGNAL_NAME_CACHE: Option<UnsafeCell<HashMap<SignalRef, CString>>> = None;
 static mut HAS_NEWLY_ADD_SIGNAL_REF: bool = false;
+// Only set in lazy mode (WAVE_VPI_LAZY_LOAD=1), replaces SIGNAL_CACHE for signal data.
+static mut LAZY_SIGNALS: Option<LazySignals> = None;
+// Only set in stream mode (WAVE_VPI_STREAM=1), serves every signal/time query instead of wellen.
+static mut VCD_STREAM: Option<UnsafeCell<VcdStream>> = None;
 // ScopeRef -> stable C handle storage.
 // We keep module handles stable across scans to avoid returning dangling pointers.
 static mut MODULE_HANDLE_CACHE: Option<UnsafeCell<HashMap<ScopeRef, *mut WellenModuleHandle>>> =
@@ -93,6 +121,7 @@ fn store_value_str(value: &str) -> *mut c_char {
 
 struct WellenModuleHandle {
     name: CString,
+    full_name: CString,
 }
 
 #[derive(Clone, Copy)]
@@ -139,6 +168,197 @@ fn get_hierarchy() -> &'static Hierarchy {
     }
 }
 
+#[inline(always)]
+fn try_get_lazy_signals() -> Option<&'static LazySignals> {
+    unsafe { (*addr_of!(LAZY_SIGNALS)).as_ref() }
+}
+
+#[inline(always)]
+fn try_get_vcd_stream() -> Option<&'static mut VcdStream> {
+    unsafe {
+        match *addr_of!(VCD_STREAM) {
+            Some(ref stream) => Some(&mut *stream.get()),
+            None => None,
+        }
+    }
+}
+
+/// Signal handles of stream mode point to the index of the var in `VcdStream::vars`.
+#[inline(always)]
+fn stream_var(handle: *mut c_void) -> u32 {
+    unsafe { *(handle as *const u32) }
+}
+
+/// Stream mode value of `var` at `time_table_idx` as a bit string. A real var reads as its value
+/// rounded to a 64-bit integer, like assigning it to a `longint`; `vpiRealVal` reads it unrounded.
+fn stream_bits(stream: &mut VcdStream, var: u32, time_table_idx: u64) -> Cow<'_, str> {
+    let is_real = stream.is_real(var);
+    let value = stream.value(var, time_table_idx);
+    if is_real {
+        return Cow::Owned(format!("{:064b}", parse_real(value).round() as i64));
+    }
+    // Bit strings only hold 0/1/x/z
+    Cow::Borrowed(unsafe { std::str::from_utf8_unchecked(value) })
+}
+
+/// Stream mode value of `var` at `time_table_idx` for `vpiRealVal`.
+/// Values with X/Z read as 0, like the integer formats.
+fn stream_real(stream: &mut VcdStream, var: u32, time_table_idx: u64) -> f64 {
+    let is_real = stream.is_real(var);
+    let value = stream.value(var, time_table_idx);
+    if is_real {
+        return parse_real(value);
+    }
+    let bits = &value[value.len().saturating_sub(64)..];
+    if bits.iter().all(|&b| b == b'0' || b == b'1') {
+        let bits = unsafe { std::str::from_utf8_unchecked(bits) };
+        u64::from_str_radix(bits, 2).unwrap_or(0) as f64
+    } else {
+        0.0
+    }
+}
+
+/// Value of a VCD `r` change, `1.25` / `-3e-9` / `nan` ...; malformed text reads as 0.
+fn parse_real(text: &[u8]) -> f64 {
+    std::str::from_utf8(text)
+        .ok()
+        .and_then(|text| text.parse().ok())
+        .unwrap_or(0.0)
+}
+
+/// Fill `value_p` from a bit string (`0`/`1`/`x`/`z`, MSB first) in the format it asks for.
+/// Values with X/Z read as 0 for the integer formats, like the wellen path.
+unsafe fn fill_vpi_value_from_bits(bits: &str, value_p: p_vpi_value) {
+    let v_format = unsafe { value_p.read().format };
+    let two_state = bits.bytes().all(|b| b == b'0' || b == b'1');
+    let low_u32 = || {
+        if two_state {
+            u32::from_str_radix(&bits[bits.len().saturating_sub(32)..], 2).unwrap_or(0)
+        } else {
+            0
+        }
+    };
+
+    match v_format as u32 {
+        vpiVectorVal => {
+            // vecvals[0] holds the least significant 32 bits
+            let mut vecvals = Vec::with_capacity(cover_with_32(bits.len()).max(1));
+            let mut end = bits.len();
+            loop {
+                let start = end.saturating_sub(32);
+                let aval = if two_state && end > start {
+                    u32::from_str_radix(&bits[start..end], 2).unwrap()
+                } else {
+                    0
+                };
+                vecvals.push(t_vpi_vecval {
+                    aval: aval as i32,
+                    bval: 0,
+                });
+                if start == 0 {
+                    break;
+                }
+                end = start;
+            }
+            let vecvals_box = vecvals.into_boxed_slice();
+            let vecvals_ptr = vecvals_box.as_ptr() as *mut t_vpi_vecval;
+            let _ = Box::into_raw(vecvals_box);
+            unsafe {
+                (*value_p).value.vector = vecvals_ptr;
+            }
+        }
+        vpiIntVal => unsafe {
+            (*value_p).value.integer = low_u32() as i32;
+        },
+        vpiHexStrVal => unsafe {
+            (*value_p).value.str_ =
+                store_value_str(&bit_string_to_hex_with_xz(bits)) as *mut PLI_BYTE8;
+        },
+        vpiBinStrVal => unsafe {
+            (*value_p).value.str_ = store_value_str(bits) as *mut PLI_BYTE8;
+        },
+        vpiDecStrVal => {
+            let dec_string = if two_state {
+                u128::from_str_radix(bits, 2)
+                    .map(|v| v.to_string())
+                    .unwrap_or_else(|_| "x".to_string())
+            } else {
+                "x".to_string()
+            };
+            unsafe {
+                (*value_p).value.str_ = store_value_str(&dec_string) as *mut PLI_BYTE8;
+            }
+        }
+        _ => {
+            todo!("v_format => {}", v_format)
+        }
+    }
+}
+
+/// Signal data of a handle, borrowed from `SIGNAL_CACHE` or from the lazy store.
+enum LoadedSignal {
+    Cached(&'static Signal),
+    Lazy(Loaded<'static, Signal>),
+}
+
+impl Deref for LoadedSignal {
+    type Target = Signal;
+
+    fn deref(&self) -> &Signal {
+        match self {
+            LoadedSignal::Cached(signal) => signal,
+            LoadedSignal::Lazy(signal) => signal,
+        }
+    }
+}
+
+#[inline(always)]
+fn get_loaded_signal(handle: vpiHandle) -> LoadedSignal {
+    match try_get_lazy_signals() {
+        Some(lazy) => LoadedSignal::Lazy(lazy.get(handle, load_signal_batch)),
+        None => LoadedSignal::Cached(&get_signal_cache().get(&handle).unwrap().signal),
+    }
+}
+
+/// Load callback of the lazy store, called with its lock held.
+fn load_signal_batch(ids: &[SignalRef]) -> Vec<(SignalRef, Signal)> {
+    let t0 = Instant::now();
+    let loaded = get_wave_source().load_signals(ids, get_hierarchy(), LOAD_OPTS.multi_thread);
+    log::info!(
+        "[wave_vpi::load_signal_batch] loaded {} signals in {:.3}s",
+        ids.len(),
+        t0.elapsed().as_secs_f64()
+    );
+    loaded.into_iter().map(|s| (s.signal_ref(), s)).collect()
+}
+
+#[inline(always)]
+fn get_path_index() -> &'static PathIndex {
+    unsafe {
+        match *addr_of!(PATH_INDEX) {
+            Some(ref path_index) => path_index,
+            None => {
+                panic!(
+                    "PATH_INDEX is not initialized! Please call `wave_vpi::wellen_initialize` first."
+                )
+            }
+        }
+    }
+}
+
+fn init_path_index() {
+    let t0 = Instant::now();
+    let path_index = PathIndex::build(get_hierarchy());
+    log::info!(
+        "[wave_vpi::wellen_initialize] path index: {} nodes in {:.3}s",
+        path_index.len(),
+        t0.elapsed().as_secs_f64()
+    );
+    unsafe {
+        PATH_INDEX = Some(path_index);
+    }
+}
+
 #[inline(always)]
 fn get_signal_ref_cache() -> &'static mut HashMap<String, SignalRef> {
     unsafe {
@@ -323,6 +543,7 @@ fn get_or_create_module_handle(scope_ref: ScopeRef) -> *mut WellenModuleHandle {
     let scope = &hierarchy[scope_ref];
     let handle = Box::new(WellenModuleHandle {
         name: CString::new(scope.name(hierarchy)).expect("scope name contains NUL"),
+        full_name: CString::new(scope.full_name(hierarchy)).expect("scope name contains NUL"),
     });
     let handle_ptr = Box::into_raw(handle);
     get_module_handle_cache().insert(scope_ref, handle_ptr);
@@ -372,6 +593,36 @@ pub unsafe extern "C" fn wellen_initialize(filename: *const c_char) {
     let r_str = c_str.to_str().unwrap();
     let filename = r_str;
 
+    // In stream mode, the VCD is parsed forward by a producer thread and wellen is not used at all.
+    if std::env::var("WAVE_VPI_STREAM").is_ok_and(|v| v == "1") {
+        assert!(
+            filename.ends_with(".vcd"),
+            "[wave_vpi::wellen_initialize] stream mode only supports VCD files, got: {}",
+            filename
+        );
+        let window_mb: usize = std::env::var("WAVE_VPI_STREAM_WINDOW_MB")
+            .ok()
+            .and_then(|v| v.parse().ok())
+            .unwrap_or(64);
+        // Two chunks (current + lookahead) live outside the channel
+        let window_chunks = 4;
+        let chunk_bytes = window_mb * 1024 * 1024 / (window_chunks + 2);
+
+        let t0 = Instant::now();
+        let stream = VcdStream::open(filename, chunk_bytes, window_chunks)
+            .unwrap_or_else(|e| panic!("[wave_vpi::wellen_initialize] {}", e));
+        log::info!(
+            "[wave_vpi::wellen_initialize] stream mode: {} vars, window {} MiB, header parsed in {:.3}s",
+            stream.vars.len(),
+            window_mb,
+            t0.elapsed().as_secs_f64()
+        );
+        unsafe {
+            VCD_STREAM = Some(UnsafeCell::new(stream));
+        }
+        return;
+    }
+
     let header =
         viewers::read_header_from_file(filename, &LOAD_OPTS).expect("Failed to load file!");
     let hierarchy = header.hierarchy;
@@ -393,11 +644,62 @@ pub unsafe extern "C" fn wellen_initialize(filename: *const c_char) {
             MODULE_HANDLE_PTR_MAP = Some(UnsafeCell::new(HashMap::new()));
             ITERATOR_HANDLE_PTR_SET = Some(UnsafeCell::new(HashSet::new()));
         }
+        init_path_index();
 
         log::info!("[wave_vpi::wellen_initialize] hierarchy-only init finish...");
         return;
     }
 
+    // In lazy mode, signal data is loaded on first access and may be evicted again (see lazy_signals.rs).
+    let lazy_load = std::env::var("WAVE_VPI_LAZY_LOAD").is_ok_and(|v| v == "1");
+
+    if lazy_load {
+        let budget_mb: usize = std::env::var("WAVE_VPI_LAZY_MEM_BUDGET_MB")
+            .ok()
+            .and_then(|v| v.parse().ok())
+            .unwrap_or(0);
+        log::info!(
+            "[wave_vpi::wellen_initialize] lazy mode: memory budget {}",
+            if budget_mb == 0 {
+                "unlimited".to_string()
+            } else {
+                format!("{} MiB", budget_mb)
+            }
+        );
+
+        // Only the time table is read here, signal data and statistics are skipped.
+        let t0 = Instant::now();
+        let body = viewers::read_body(header.body, &hierarchy, None).expect("Failed to load body!");
+        log::info!(
+            "[wave_vpi::wellen_initialize] Time table size: {} ({:.3}s)",
+            body.time_table.len(),
+            t0.elapsed().as_secs_f64()
+        );
+
+        let num_signals = hierarchy.num_unique_signals();
+        unsafe {
+            TIME_TABLE = Some(UnsafeCell::new(body.time_table));
+            HIERARCHY = Some(UnsafeCell::new(hierarchy));
+            WAVE_SOURCE = Some(UnsafeCell::new(body.source));
+            LAZY_SIGNALS = Some(LazySignals::new(
+                num_signals,
+                budget_mb * 1024 * 1024,
+                Signal::size_in_memory,
+            ));
+            SIGNAL_REF_CACHE = Some(UnsafeCell::new(HashMap::new()));
+            SIGNAL_REF_CACHE_NULL = Some(UnsafeCell::new(HashSet::new()));
+            SIGNAL_CACHE = Some(UnsafeCell::new(HashMap::new()));
+            SIGNAL_NAME_CACHE = Some(UnsafeCell::new(HashMap::new()));
+            MODULE_HANDLE_CACHE = Some(UnsafeCell::new(HashMap::new()));
+            MODULE_HANDLE_PTR_MAP = Some(UnsafeCell::new(HashMap::new()));
+            ITERATOR_HANDLE_PTR_SET = Some(UnsafeCell::new(HashSet::new()));
+        }
+        init_path_index();
+
+        log::info!("[wave_vpi::wellen_initialize] lazy init finish...");
+        return;
+    }
+
     let body = viewers::read_body(header.body, &hierarchy, None).expect("Failed to load body!");
     let wave_source = body.source;
     wave_source.print_statistics();
@@ -413,6 +715,7 @@ pub unsafe extern "C" fn wellen_initialize(filename: *const c_char) {
             time_table_len
         );
     }
+    init_path_index();
 
     // Load meta file and check wave file freshness.
     let mut use_cached_data = false;
@@ -574,8 +877,31 @@ pub unsafe extern "C" fn wellen_initialize(filename: *const c_char) {
 pub unsafe extern "C" fn wellen_finalize() {
     log::info!("[wave_vpi::wellen_finalize] ... ");
 
+    if let Some(stream) = try_get_vcd_stream() {
+        let stats = stream.stats();
+        log::info!(
+            "[wave_vpi::wellen_finalize] stream mode: steps: {} chunks: {} peak window: {:.1} MiB",
+            stats.steps,
+            stats.chunks,
+            stats.peak_window_bytes as f64 / (1024.0 * 1024.0)
+        );
+        return;
+    }
+
     let signal_ref_cache = get_signal_ref_cache();
-    if signal_ref_cache.len() >= SIGNAL_REF_COUNT_THRESHOLD {
+    if let Some(lazy) = try_get_lazy_signals() {
+        // No cache files: `.wave_vpi.signal.bin` would need the data of every signal in memory.
+        let stats = lazy.stats();
+        log::info!(
+            "[wave_vpi::wellen_finalize] lazy mode: signals: {} load_calls: {} loaded: {} evicted: {} used: {:.1} MiB peak: {:.1} MiB",
+            stats.signals,
+            stats.load_calls,
+            stats.loaded,
+            stats.evicted,
+            stats.used_bytes as f64 / (1024.0 * 1024.0),
+            stats.peak_bytes as f64 / (1024.0 * 1024.0)
+        );
+    } else if signal_ref_cache.len() >= SIGNAL_REF_COUNT_THRESHOLD {
         unsafe {
             if HAS_NEWLY_ADD_SIGNAL_REF {
                 log::info!("[wave_vpi::wellen_finalize] saving cache files");
@@ -665,6 +991,13 @@ pub unsafe extern "C" fn wellen_vpi_handle_by_name(name: *const c_char) -> *mut
     .to_str()
     .unwrap();
 
+    if let Some(stream) = try_get_vcd_stream() {
+        return match stream.var_by_name(name) {
+            Some(var) => Box::into_raw(Box::new(var)) as *mut c_void,
+            None => std::ptr::null_mut(),
+        };
+    }
+
     let id_opt = get_signal_ref_cache().get(&name.to_string());
     if let Some(id) = id_opt {
         log::debug!("find vpiHandle in cache => name: {} id: {:?}", name, id);
@@ -682,20 +1015,26 @@ pub unsafe extern "C" fn wellen_vpi_handle_by_name(name: *const c_char) -> *mut
     }
 
     let id = if let Some((path_str, signal_name)) = name.rsplit_once(".") {
-        let path_vec: Vec<&str> = path_str.split(".").collect();
-        let path_slice: &[&str] = &path_vec;
-
         let hierarchy = get_hierarchy();
-        let var_ref_opt = &hierarchy.lookup_var(path_slice, signal_name);
+        // Path index first, `lookup_var` (a walk from the root) only for names the index does not know
+        let var_ref_opt = &get_path_index().lookup_var(name).or_else(|| {
+            let path_vec: Vec<&str> = path_str.split(".").collect();
+            hierarchy.lookup_var(&path_vec, signal_name)
+        });
         if var_ref_opt.is_none() {
-            let v = get_most_likely_signal_name(name, 5);
-            log::debug!(
-                "Failed to lookup var, name: {}, path: {}, siangl: {}\nMost likely signal names: {:#?}",
-                name,
-                path_str,
-                signal_name,
-                v
-            );
+            // Scope paths (e.g. a scope-relative `vpi_handle_by_name`) end up here before the caller
+            // tries `wellen_vpi_scope_by_name`, the suggestions below scan every var of the design.
+            if get_path_index().lookup_scope(name).is_none() && log::log_enabled!(log::Level::Debug)
+            {
+                let v = get_most_likely_signal_name(name, 5);
+                log::debug!(
+                    "Failed to lookup var, name: {}, path: {}, siangl: {}\nMost likely signal names: {:#?}",
+                    name,
+                    path_str,
+                    signal_name,
+                    v
+                );
+            }
             // panic!(
             //     "Failed to lookup var, name: {}, path: {}, siangl: {}\nMost likely signal names: {:#?}",
             //     name, path_str, signal_name, v
@@ -713,19 +1052,32 @@ pub unsafe extern "C" fn wellen_vpi_handle_by_name(name: *const c_char) -> *mut
         let var_ref = &var_ref_opt.unwrap();
 
         let var = &hierarchy[*var_ref];
-        let ids = [var.signal_ref(); 1];
-        let loaded = get_wave_source().load_signals(&ids, hierarchy, LOAD_OPTS.multi_thread);
-        let loaded_signal = loaded.into_iter().next().unwrap();
-        let loaded_id = loaded_signal.signal_ref();
-        assert_eq!(loaded_id, ids[0], "Failed to load signal, name: {}", name);
-
-        get_signal_cache().insert(
-            loaded_id,
-            SignalInfo {
-                signal: loaded_signal,
-                var_type: var.var_type(),
-            },
-        );
+        let loaded_id = if let Some(lazy) = try_get_lazy_signals() {
+            // Loaded on first access, together with every other signal registered until then
+            lazy.register(
+                var.signal_ref(),
+                LazySignalMeta {
+                    var_type: var.var_type(),
+                    width: var.length(),
+                },
+            );
+            var.signal_ref()
+        } else {
+            let ids = [var.signal_ref(); 1];
+            let loaded = get_wave_source().load_signals(&ids, hierarchy, LOAD_OPTS.multi_thread);
+            let loaded_signal = loaded.into_iter().next().unwrap();
+            let loaded_id = loaded_signal.signal_ref();
+            assert_eq!(loaded_id, ids[0], "Failed to load signal, name: {}", name);
+
+            get_signal_cache().insert(
+                loaded_id,
+                SignalInfo {
+                    signal: loaded_signal,
+                    var_type: var.var_type(),
+                },
+            );
+            loaded_id
+        };
         get_signal_name_cache().insert(
             loaded_id,
             CString::new(name).expect("signal name contains NUL"),
@@ -753,6 +1105,31 @@ pub unsafe extern "C" fn wellen_vpi_handle_by_name(name: *const c_char) -> *mut
     Box::into_raw(value) as *mut c_void
 }
 
+/// Module handle of the scope `name` (full dotted path), null if `name` is not
+/// a scope. The handle is stable, see `get_or_create_module_handle`.
+///
+/// # Safety
+/// `name` must be a valid, non-null, null-terminated C string.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wellen_vpi_scope_by_name(name: *const c_char) -> *mut c_void {
+    let name = unsafe {
+        assert!(!name.is_null());
+        CStr::from_ptr(name)
+    }
+    .to_str()
+    .unwrap();
+
+    // Scopes are not tracked in stream mode
+    if try_get_vcd_stream().is_some() {
+        return std::ptr::null_mut();
+    }
+
+    match get_path_index().lookup_scope(name) {
+        Some(scope_ref) => get_or_create_module_handle(scope_ref) as *mut c_void,
+        None => std::ptr::null_mut(),
+    }
+}
+
 #[inline]
 fn bytes_to_u32s_be(bytes: &[u8]) -> Vec<u32> {
     let len = bytes.len();
@@ -854,12 +1231,16 @@ fn find_nearest_time_index(time_table: &[u64], time: u64) -> usize {
 /// `handle` must be a valid pointer obtained from `wellen_vpi_handle_by_name`.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wellen_get_int_value(handle: *mut c_void, time_table_idx: u64) -> u32 {
+    if let Some(stream) = try_get_vcd_stream() {
+        let bits = stream_bits(stream, stream_var(handle), time_table_idx);
+        if bits.bytes().all(|b| b == b'0' || b == b'1') {
+            return u32::from_str_radix(&bits[bits.len().saturating_sub(32)..], 2).unwrap_or(0);
+        }
+        return 0;
+    }
+
     let handle = unsafe { *{ handle as *mut vpiHandle } };
-    let loaded_signal = get_signal_cache()
-        .get(&(handle as vpiHandle))
-        .unwrap()
-        .signal
-        .borrow();
+    let loaded_signal = get_loaded_signal(handle as vpiHandle);
 
     if let Some(off) = loaded_signal.get_offset(time_table_idx as u32) {
         let signal_v = loaded_signal.get_value_at(&off, 0);
@@ -892,14 +1273,21 @@ pub unsafe extern "C" fn wellen_vpi_get_value_from_index(
     time_table_idx: u64,
     value_p: p_vpi_value,
 ) {
+    if let Some(stream) = try_get_vcd_stream() {
+        if unsafe { value_p.read().format } as u32 == vpiRealVal {
+            let real = stream_real(stream, stream_var(handle), time_table_idx);
+            unsafe { (*value_p).value.real = real };
+            return;
+        }
+        let bits = stream_bits(stream, stream_var(handle), time_table_idx);
+        unsafe { fill_vpi_value_from_bits(&bits, value_p) };
+        return;
+    }
+
     let handle = unsafe { *{ handle as *mut vpiHandle } };
     let v_format = unsafe { value_p.read().format };
 
-    let loaded_signal = get_signal_cache()
-        .get(&(handle as vpiHandle))
-        .unwrap()
-        .signal
-        .borrow();
+    let loaded_signal = get_loaded_signal(handle as vpiHandle);
 
     if let Some(off) = loaded_signal.get_offset(time_table_idx as u32) {
         let signal_v = loaded_signal.get_value_at(&off, 0);
@@ -1125,6 +1513,10 @@ pub unsafe extern "C" fn wellen_vpi_get_value(
     time: u64,
     value_p: p_vpi_value,
 ) {
+    assert!(
+        try_get_vcd_stream().is_none(),
+        "[wellen_vpi_get_value] lookups by time are not supported in stream mode"
+    );
     let time_table_idx = find_nearest_time_index(get_time_table(), time);
     unsafe {
         wellen_vpi_get_value_from_index(handle, time_table_idx as u64, value_p);
@@ -1138,12 +1530,13 @@ pub unsafe extern "C" fn wellen_get_value_str(
     handle: *mut c_void,
     time_table_idx: u64,
 ) -> *mut c_char {
+    if let Some(stream) = try_get_vcd_stream() {
+        let bits = stream_bits(stream, stream_var(handle), time_table_idx);
+        return store_value_str(&bits);
+    }
+
     let handle = unsafe { *{ handle as *mut vpiHandle } };
-    let loaded_signal = get_signal_cache()
-        .get(&(handle as vpiHandle))
-        .unwrap()
-        .signal
-        .borrow();
+    let loaded_signal = get_loaded_signal(handle as vpiHandle);
     let off = loaded_signal.get_offset(time_table_idx as u32);
 
     if let Some(off) = off {
@@ -1161,16 +1554,30 @@ pub unsafe extern "C" fn wellen_get_value_str(
 /// `handle` must be a valid pointer obtained from `wellen_vpi_handle_by_name`.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wellen_vpi_get(property: PLI_INT32, handle: *mut c_void) -> PLI_INT32 {
+    if let Some(stream) = try_get_vcd_stream() {
+        return match property as u32 {
+            vpiSize => stream.vars[stream_var(handle) as usize].width as PLI_INT32,
+            _ => todo!("property => {}", property),
+        };
+    }
+
     let handle = unsafe { *{ handle as *mut vpiHandle } };
-    let loaded_signal = get_signal_cache()
-        .get(&(handle as vpiHandle))
-        .unwrap()
-        .signal
-        .borrow();
+
+    // Lazy mode: answer from the hierarchy so that resolving a handle does not load its data
+    if property as u32 == vpiSize {
+        let lazy_width = try_get_lazy_signals()
+            .and_then(|lazy| lazy.meta(handle as vpiHandle))
+            .and_then(|meta| meta.width);
+        if let Some(width) = lazy_width {
+            return width as PLI_INT32;
+        }
+    }
+
+    let loaded_signal = get_loaded_signal(handle as vpiHandle);
     let first_indx = loaded_signal.get_first_time_idx().unwrap();
     let off = loaded_signal
         .get_offset(first_indx)
-        .unwrap_or_else(|| panic!("failed to get offset, signal => {:?}", loaded_signal));
+        .unwrap_or_else(|| panic!("failed to get offset, signal => {:?}", *loaded_signal));
     let signal_v = loaded_signal.get_value_at(&off, 0);
 
     match property as u32 {
@@ -1188,12 +1595,25 @@ pub unsafe extern "C" fn wellen_vpi_get_str(
     property: PLI_INT32,
     handle: *mut c_void,
 ) -> *mut c_void {
+    if let Some(stream) = try_get_vcd_stream() {
+        let var = &stream.vars[stream_var(handle) as usize];
+        return match property as u32 {
+            vpiName | vpiFullName => store_value_str(&var.name) as *mut c_void,
+            vpiType => match var.kind.as_str() {
+                "wire" => c"vpiNet".as_ptr() as *mut c_void,
+                _ => c"vpiReg".as_ptr() as *mut c_void,
+            },
+            _ => std::ptr::null_mut(),
+        };
+    }
+
     let handle_addr = handle as usize;
     // First check module handle registry. Signal handles and module handles are both opaque pointers.
     if get_module_handle_ptr_map().contains_key(&handle_addr) {
         let module_handle = unsafe { &*(handle as *const WellenModuleHandle) };
         match property as u32 {
             vpiName => module_handle.name.as_ptr() as *mut c_void,
+            vpiFullName => module_handle.full_name.as_ptr() as *mut c_void,
             // Def-name is intentionally FSDB-only in current policy.
             vpiDefName => std::ptr::null_mut(),
             vpiType => c"vpiModule".as_ptr() as *mut c_void,
@@ -1207,11 +1627,15 @@ pub unsafe extern "C" fn wellen_vpi_get_str(
                 .map(|name| name.as_ptr() as *mut c_void)
                 .unwrap_or(std::ptr::null_mut()),
             vpiType => {
-                let var_type = get_signal_cache()
-                    .get(&(handle as vpiHandle))
-                    .unwrap()
-                    .var_type
-                    .borrow();
+                let var_type = match try_get_lazy_signals() {
+                    Some(lazy) => lazy.meta(handle as vpiHandle).unwrap().var_type,
+                    None => {
+                        get_signal_cache()
+                            .get(&(handle as vpiHandle))
+                            .unwrap()
+                            .var_type
+                    }
+                };
                 match var_type {
                     VarType::Wire => c"vpiNet".as_ptr() as *mut c_void,
                     VarType::Reg | VarType::Logic => c"vpiReg".as_ptr() as *mut c_void,
@@ -1318,6 +1742,11 @@ pub unsafe extern "C" fn wellen_vpi_iterate(
     _type: PLI_INT32,
     refHandle: *mut c_void,
 ) -> *mut c_void {
+    if try_get_vcd_stream().is_some() {
+        log::warn!("[wellen_vpi_iterate] hierarchy iteration is not supported in stream mode");
+        return std::ptr::null_mut();
+    }
+
     let items = if _type as u32 == vpiModule {
         collect_module_scopes(_type, refHandle)
             .into_iter()
@@ -1377,12 +1806,19 @@ pub unsafe extern "C" fn wellen_vpi_scan(iterator: *mut c_void) -> *mut c_void {
 
 #[unsafe(no_mangle)]
 pub extern "C" fn wellen_get_time_from_index(index: u64) -> u64 {
+    if let Some(stream) = try_get_vcd_stream() {
+        return stream.time(index);
+    }
     let time_table = get_time_table();
     time_table[index as usize]
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn wellen_get_index_from_time(time: u64) -> u64 {
+    assert!(
+        try_get_vcd_stream().is_none(),
+        "[wellen_get_index_from_time] lookups by time are not supported in stream mode"
+    );
     let time_table = get_time_table();
     find_nearest_time_index(time_table, time) as u64
 }
@@ -1391,14 +1827,34 @@ pub extern "C" fn wellen_get_index_from_time(time: u64) -> u64 {
 /// Must be called after `wellen_initialize`.
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wellen_get_max_index() -> u64 {
+    // Unknown until the producer reaches the end of the file, see `wellen_stream_has_index`
+    if try_get_vcd_stream().is_some() {
+        return u64::MAX;
+    }
     let time_table = get_time_table();
     time_table.len().saturating_sub(1) as u64
 }
 
+/// Stream mode: whether time step `index` exists, waits for the producer thread if needed.
+/// Always true in the other modes for indices up to `wellen_get_max_index`.
+#[unsafe(no_mangle)]
+pub extern "C" fn wellen_stream_has_index(index: u64) -> bool {
+    match try_get_vcd_stream() {
+        Some(stream) => stream.has_step(index),
+        None => (index as usize) < get_time_table().len(),
+    }
+}
+
 /// Get time precision from waveform file
 /// Returns the exponent (e.g., -9 for ns, -12 for ps)
 #[unsafe(no_mangle)]
 pub extern "C" fn wellen_get_time_precision() -> i32 {
+    if let Some(stream) = try_get_vcd_stream() {
+        return stream.timescale_exp.unwrap_or_else(|| {
+            log::warn!("[wave_vpi] Wave file has no timescale info, defaulting to ns (-9)");
+            -9
+        });
+    }
     let hierarchy = get_hierarchy();
     if let Some(timescale) = hierarchy.timescale() {
         let base_exp = timescale.unit.to_exponent().unwrap_or(-9) as i32;
@@ -1447,4 +1903,23 @@ mod tests {
             );
         }
     }
+
+    #[test]
+    fn test_stream_real_values() {
+        let vcd = "$scope module top $end\n$var real 64 # ratio $end\n$var wire 4 $ w $end\n\
+                   $upscope $end\n$enddefinitions $end\n#0\nr2.5 #\nb1010 $\n#5\nr-1.5 #\n";
+        let mut stream =
+            VcdStream::from_reader(std::io::Cursor::new(vcd.as_bytes().to_vec()), 1, 1).unwrap();
+        let ratio = stream.var_by_name("top.ratio").unwrap();
+        let w = stream.var_by_name("top.w").unwrap();
+
+        assert_eq!(stream_real(&mut stream, ratio, 0), 2.5);
+        assert_eq!(stream_bits(&mut stream, ratio, 0), format!("{:064b}", 3));
+        assert_eq!(stream_real(&mut stream, w, 0), 10.0);
+        assert_eq!(stream_bits(&mut stream, w, 0), "1010");
+
+        // Rounded away from zero, two's complement like a `longint`
+        assert_eq!(stream_real(&mut stream, ratio, 1), -1.5);
+        assert_eq!(stream_bits(&mut stream, ratio, 1), "1".repeat(63) + "0");
+    }
 }
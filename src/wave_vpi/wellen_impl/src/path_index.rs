@@ -0,0 +1,153 @@
+//! Path trie over the waveform hierarchy, built once in `wellen_initialize`.
+//!
+//! `Hierarchy::lookup_var` walks the scopes from the root and compares the
+//! names of all children on every level, so resolving N handles costs
+//! O(N * hierarchy width). The trie maps every dotted path component to its
+//! children with a hash map, a lookup costs one hash probe per component.
+//!
+//! Nodes are keyed by the same dotted names `var.full_name()` produces, so a
+//! name returned by `vpi_get_str(vpiName, ...)` always resolves to its var.
+
+use std::collections::HashMap;
+use wellen::{Hierarchy, ScopeRef, VarRef};
+
+const ROOT: u32 = 0;
+
+struct PathNode<S, V> {
+    children: HashMap<Box<str>, u32>,
+    scope: Option<S>,
+    var: Option<V>,
+}
+
+impl<S, V> Default for PathNode<S, V> {
+    fn default() -> Self {
+        Self {
+            children: HashMap::new(),
+            scope: None,
+            var: None,
+        }
+    }
+}
+
+/// A node may hold both a scope and a var of the same name (e.g. an
+/// interface instance that is also dumped as a signal).
+pub struct PathTrie<S, V> {
+    nodes: Vec<PathNode<S, V>>,
+}
+
+pub type PathIndex = PathTrie<ScopeRef, VarRef>;
+
+impl<S: Copy, V: Copy> PathTrie<S, V> {
+    pub fn new() -> Self {
+        Self {
+            nodes: vec![PathNode::default()],
+        }
+    }
+
+    /// Number of nodes (scopes + vars) in the trie
+    pub fn len(&self) -> usize {
+        self.nodes.len() - 1
+    }
+
+    fn child_or_insert(&mut self, parent: u32, name: &str) -> u32 {
+        if let Some(&child) = self.nodes[parent as usize].children.get(name) {
+            return child;
+        }
+        let child = self.nodes.len() as u32;
+        self.nodes.push(PathNode::default());
+        self.nodes[parent as usize]
+            .children
+            .insert(name.into(), child);
+        child
+    }
+
+    /// Add a scope named `name` below node `parent`, returns its node.
+    fn insert_scope(&mut self, parent: u32, name: &str, scope: S) -> u32 {
+        let node = self.child_or_insert(parent, name);
+        self.nodes[node as usize].scope.get_or_insert(scope);
+        node
+    }
+
+    /// Add a var named `name` below node `parent`. The first var wins when
+    /// several vars share a name (aliases).
+    fn insert_var(&mut self, parent: u32, name: &str, var: V) {
+        let node = self.child_or_insert(parent, name);
+        self.nodes[node as usize].var.get_or_insert(var);
+    }
+
+    fn lookup(&self, path: &str) -> Option<&PathNode<S, V>> {
+        let mut node = ROOT;
+        for part in path.split('.') {
+            node = *self.nodes[node as usize].children.get(part)?;
+        }
+        Some(&self.nodes[node as usize])
+    }
+
+    pub fn lookup_var(&self, path: &str) -> Option<V> {
+        self.lookup(path)?.var
+    }
+
+    pub fn lookup_scope(&self, path: &str) -> Option<S> {
+        self.lookup(path)?.scope
+    }
+}
+
+impl PathIndex {
+    pub fn build(hierarchy: &Hierarchy) -> Self {
+        let mut trie = Self::new();
+        let mut stack: Vec<(ScopeRef, u32)> = hierarchy.scopes().map(|s| (s, ROOT)).collect();
+
+        while let Some((scope_ref, parent)) = stack.pop() {
+            let scope = &hierarchy[scope_ref];
+            let node = trie.insert_scope(parent, scope.name(hierarchy), scope_ref);
+
+            for var_ref in scope.vars(hierarchy) {
+                let full_name = hierarchy[var_ref].full_name(hierarchy);
+                let name = full_name
+                    .rsplit_once('.')
+                    .map_or(full_name.as_str(), |(_, name)| name);
+                trie.insert_var(node, name, var_ref);
+            }
+
+            stack.extend(scope.scopes(hierarchy).map(|s| (s, node)));
+        }
+
+        trie
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_path_trie_lookup() {
+        let mut trie = PathTrie::<u32, u32>::new();
+        let top = trie.insert_scope(ROOT, "top", 0);
+        let u_core = trie.insert_scope(top, "u_core", 1);
+        let gen_1 = trie.insert_scope(top, "gen[1]", 2);
+        trie.insert_var(top, "clock", 10);
+        trie.insert_var(u_core, "valid", 11);
+        trie.insert_var(u_core, "valid", 99); // alias, first one wins
+        trie.insert_var(gen_1, "data", 12);
+        trie.insert_var(top, "mem[3]", 13);
+        trie.insert_scope(top, "intf", 3);
+        trie.insert_var(top, "intf", 14);
+
+        assert_eq!(trie.len(), 8);
+        assert_eq!(trie.lookup_var("top.clock"), Some(10));
+        assert_eq!(trie.lookup_var("top.u_core.valid"), Some(11));
+        assert_eq!(trie.lookup_var("top.gen[1].data"), Some(12));
+        assert_eq!(trie.lookup_var("top.mem[3]"), Some(13));
+        assert_eq!(trie.lookup_scope("top.u_core"), Some(1));
+        assert_eq!(trie.lookup_scope("top.gen[1]"), Some(2));
+        assert_eq!(trie.lookup_scope("top.intf"), Some(3));
+        assert_eq!(trie.lookup_var("top.intf"), Some(14));
+
+        assert_eq!(trie.lookup_var("top.u_core"), None);
+        assert_eq!(trie.lookup_scope("top.clock"), None);
+        assert_eq!(trie.lookup_var("top.u_core.ready"), None);
+        assert_eq!(trie.lookup_var("other.clock"), None);
+        assert_eq!(trie.lookup_var(""), None);
+    }
+}
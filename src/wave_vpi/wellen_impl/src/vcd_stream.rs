@@ -0,0 +1,720 @@
+//! Forward-only VCD reader used when `WAVE_VPI_STREAM=1`.
+//!
+//! wellen needs random access to the whole waveform, which does not work for
+//! VCDs larger than memory. `wave_vpi_loop` only ever moves the cursor
+//! forward, so this reader parses the VCD body in a producer thread and sends
+//! it as chunks of time steps through a bounded channel. The simulation thread
+//! applies the steps to a table holding the current value of every signal, so
+//! memory is bounded by the chunk window plus the design size, not by the file
+//! size. Values are decoded into VPI formats only for the handles that are read.
+//!
+//! Time step `i` is the i-th distinct timestamp in the file. Values before
+//! the first change of a signal read as `0`, like the wellen backend.
+
+use std::collections::{HashMap, VecDeque};
+use std::fs::File;
+use std::io::{self, BufRead, BufReader};
+use std::ops::Range;
+use std::sync::mpsc::{Receiver, SyncSender, sync_channel};
+
+/// A signal of the VCD header, `code` indexes the value table (aliases share it).
+#[derive(Debug, Clone)]
+pub struct VcdVar {
+    pub name: String,
+    pub kind: String,
+    pub width: u32,
+    pub code: u32,
+}
+
+#[derive(Debug, Default)]
+pub struct VcdHeader {
+    pub vars: Vec<VcdVar>,
+    /// Exponent of the time unit, e.g. -12 for `1ps`, -11 for `10ps`
+    pub timescale_exp: Option<i32>,
+    codes: HashMap<Vec<u8>, u32>,
+    code_widths: Vec<u32>,
+    code_is_real: Vec<bool>,
+}
+
+/// Consecutive time steps, changes of step `i` are
+/// `changes[step_starts[i]..step_starts[i + 1]]` (or up to the end).
+#[derive(Debug, Default)]
+struct Chunk {
+    times: Vec<u64>,
+    step_starts: Vec<u32>,
+    /// (code, start, len) into `data`
+    changes: Vec<(u32, u32, u32)>,
+    data: Vec<u8>,
+}
+
+impl Chunk {
+    fn len(&self) -> u64 {
+        self.times.len() as u64
+    }
+
+    fn size_in_memory(&self) -> usize {
+        self.times.len() * 8
+            + self.step_starts.len() * 4
+            + self.changes.len() * 12
+            + self.data.len()
+    }
+
+    fn step_changes(&self, step: usize) -> &[(u32, u32, u32)] {
+        let start = self.step_starts[step] as usize;
+        let end = self
+            .step_starts
+            .get(step + 1)
+            .map_or(self.changes.len(), |&e| e as usize);
+        &self.changes[start..end]
+    }
+}
+
+/// Whitespace separated tokens of a VCD file, read line by line.
+struct Tokenizer<R> {
+    reader: R,
+    buf: Vec<u8>,
+    pos: usize,
+    line: u64,
+}
+
+impl<R: BufRead> Tokenizer<R> {
+    fn new(reader: R) -> Self {
+        Self {
+            reader,
+            buf: Vec::new(),
+            pos: 0,
+            line: 0,
+        }
+    }
+
+    fn next_range(&mut self) -> io::Result<Option<Range<usize>>> {
+        loop {
+            let buf = &self.buf;
+            let mut pos = self.pos;
+            while pos < buf.len() && buf[pos].is_ascii_whitespace() {
+                pos += 1;
+            }
+            if pos < buf.len() {
+                let start = pos;
+                while pos < buf.len() && !buf[pos].is_ascii_whitespace() {
+                    pos += 1;
+                }
+                self.pos = pos;
+                return Ok(Some(start..pos));
+            }
+
+            self.buf.clear();
+            self.pos = 0;
+            if self.reader.read_until(b'\n', &mut self.buf)? == 0 {
+                return Ok(None);
+            }
+            self.line += 1;
+        }
+    }
+
+    fn next(&mut self) -> Result<Option<&[u8]>, String> {
+        match self.next_range() {
+            Ok(Some(range)) => Ok(Some(&self.buf[range])),
+            Ok(None) => Ok(None),
+            Err(e) => Err(format!("read error at line {}: {}", self.line, e)),
+        }
+    }
+
+    fn expect(&mut self, what: &str) -> Result<&[u8], String> {
+        let line = self.line;
+        self.next()?
+            .ok_or_else(|| format!("unexpected end of file at line {}, expected {}", line, what))
+    }
+
+    /// Tokens up to the next `$end`
+    fn until_end(&mut self) -> Result<Vec<String>, String> {
+        let mut tokens = Vec::new();
+        loop {
+            let token = self.expect("$end")?;
+            if token == b"$end" {
+                return Ok(tokens);
+            }
+            tokens.push(String::from_utf8_lossy(token).into_owned());
+        }
+    }
+}
+
+fn parse_timescale(tokens: &[String]) -> Option<i32> {
+    let text: String = tokens.concat();
+    let digits = text.bytes().take_while(|b| b.is_ascii_digit()).count();
+    let factor_exp = match &text[..digits] {
+        "1" => 0,
+        "10" => 1,
+        "100" => 2,
+        _ => return None,
+    };
+    let unit_exp = match &text[digits..] {
+        "s" => 0,
+        "ms" => -3,
+        "us" => -6,
+        "ns" => -9,
+        "ps" => -12,
+        "fs" => -15,
+        _ => return None,
+    };
+    Some(unit_exp + factor_exp)
+}
+
+fn parse_header<R: BufRead>(tok: &mut Tokenizer<R>) -> Result<VcdHeader, String> {
+    let mut header = VcdHeader::default();
+    let mut scopes: Vec<String> = Vec::new();
+
+    loop {
+        let line = tok.line;
+        let command = match tok.next()? {
+            Some(token) => token.to_vec(),
+            None => return Err("unexpected end of file in the VCD header".to_string()),
+        };
+        match command.as_slice() {
+            b"$enddefinitions" => {
+                tok.until_end()?;
+                return Ok(header);
+            }
+            b"$timescale" => {
+                let tokens = tok.until_end()?;
+                header.timescale_exp = parse_timescale(&tokens);
+            }
+            b"$scope" => {
+                let tokens = tok.until_end()?;
+                let name = tokens
+                    .get(1)
+                    .ok_or_else(|| format!("invalid $scope at line {}", line))?;
+                scopes.push(name.clone());
+            }
+            b"$upscope" => {
+                tok.until_end()?;
+                scopes.pop();
+            }
+            b"$var" => {
+                // $var <kind> <width> <code> <reference> [<index>] $end
+                let tokens = tok.until_end()?;
+                if tokens.len() < 4 {
+                    return Err(format!("invalid $var at line {}", line));
+                }
+                let width: u32 = tokens[1]
+                    .parse()
+                    .map_err(|_| format!("invalid $var width at line {}", line))?;
+
+                let mut reference = tokens[3].clone();
+                // A bit range (`[7:0]`) is not part of the name, a single index (`[3]`) is
+                if let Some(pos) = reference.find('[') {
+                    if reference[pos..].contains(':') {
+                        reference.truncate(pos);
+                    }
+                }
+                for index in &tokens[4..] {
+                    if !index.contains(':') {
+                        reference.push_str(index);
+                    }
+                }
+
+                let is_real = tokens[0] == "real" || tokens[0] == "realtime";
+                let next_code = header.codes.len() as u32;
+                let code = *header
+                    .codes
+                    .entry(tokens[2].as_bytes().to_vec())
+                    .or_insert(next_code);
+                if code == next_code {
+                    header.code_widths.push(width);
+                    header.code_is_real.push(is_real);
+                }
+
+                let mut name = scopes.join(".");
+                if !name.is_empty() {
+                    name.push('.');
+                }
+                name.push_str(&reference);
+                header.vars.push(VcdVar {
+                    name,
+                    kind: tokens[0].clone(),
+                    width,
+                    code,
+                });
+            }
+            _ if command.starts_with(b"$") => {
+                tok.until_end()?;
+            }
+            _ => {
+                return Err(format!(
+                    "unexpected token `{}` at line {} in the VCD header",
+                    String::from_utf8_lossy(&command),
+                    line
+                ));
+            }
+        }
+    }
+}
+
+#[inline]
+fn normalize_bit(b: u8) -> u8 {
+    match b {
+        b'0' | b'1' | b'x' | b'z' => b,
+        b'X' => b'x',
+        b'Z' => b'z',
+        b'h' | b'H' => b'1',
+        b'l' | b'L' => b'0',
+        _ => b'x',
+    }
+}
+
+/// Append `value` as a bit string of exactly `width` characters, extended on
+/// the left like Verilog does (`0` for `0`/`1`, `x`/`z` for `x`/`z`).
+fn push_bits(data: &mut Vec<u8>, value: &[u8], width: usize) {
+    let value = &value[value.len().saturating_sub(width)..];
+    let fill = match value.first().map(|&b| normalize_bit(b)) {
+        Some(b'x') => b'x',
+        Some(b'z') => b'z',
+        _ => b'0',
+    };
+    data.extend(std::iter::repeat_n(fill, width - value.len()));
+    data.extend(value.iter().map(|&b| normalize_bit(b)));
+}
+
+struct Producer<R> {
+    tok: Tokenizer<R>,
+    codes: HashMap<Vec<u8>, u32>,
+    code_widths: Vec<u32>,
+    code_is_real: Vec<bool>,
+    chunk_bytes: usize,
+    tx: SyncSender<Result<Chunk, String>>,
+}
+
+impl<R: BufRead> Producer<R> {
+    /// Returns false once the consumer is gone.
+    fn send(&self, chunk: Chunk) -> bool {
+        self.tx.send(Ok(chunk)).is_ok()
+    }
+
+    fn run(mut self) {
+        if let Err(e) = self.parse_body() {
+            let _ = self.tx.send(Err(e));
+        }
+    }
+
+    fn parse_body(&mut self) -> Result<(), String> {
+        let mut chunk = Chunk::default();
+        let mut value = Vec::new();
+
+        loop {
+            let line = self.tok.line;
+            let Some(token) = self.tok.next()? else {
+                break;
+            };
+
+            let (code_token, is_text) = match token[0] {
+                b'#' => {
+                    let time: u64 = std::str::from_utf8(&token[1..])
+                        .ok()
+                        .and_then(|t| t.parse().ok())
+                        .ok_or_else(|| format!("invalid timestamp at line {}", line))?;
+                    if chunk.times.last() == Some(&time) {
+                        continue;
+                    }
+                    if chunk.size_in_memory() >= self.chunk_bytes {
+                        if !self.send(std::mem::take(&mut chunk)) {
+                            return Ok(());
+                        }
+                    }
+                    chunk.times.push(time);
+                    chunk.step_starts.push(chunk.changes.len() as u32);
+                    continue;
+                }
+                b'$' => {
+                    if token == b"$comment" {
+                        self.tok.until_end()?;
+                    }
+                    // $dumpvars / $dumpall / $dumpon / $dumpoff / $end only wrap value changes
+                    continue;
+                }
+                b'b' | b'B' | b'r' | b'R' | b's' | b'S' => {
+                    let is_text = !matches!(token[0], b'b' | b'B');
+                    value.clear();
+                    value.extend_from_slice(&token[1..]);
+                    (self.tok.expect("identifier code")?.to_vec(), is_text)
+                }
+                _ => {
+                    value.clear();
+                    value.push(token[0]);
+                    (token[1..].to_vec(), false)
+                }
+            };
+
+            let Some(&code) = self.codes.get(&code_token) else {
+                return Err(format!(
+                    "unknown identifier code `{}` at line {}",
+                    String::from_utf8_lossy(&code_token),
+                    line
+                ));
+            };
+
+            // Changes before the first timestamp belong to time 0
+            if chunk.times.is_empty() && chunk.step_starts.is_empty() {
+                chunk.times.push(0);
+                chunk.step_starts.push(0);
+            }
+
+            let start = chunk.data.len();
+            if is_text || self.code_is_real[code as usize] {
+                chunk.data.extend_from_slice(&value);
+            } else {
+                push_bits(
+                    &mut chunk.data,
+                    &value,
+                    self.code_widths[code as usize] as usize,
+                );
+            }
+            chunk
+                .changes
+                .push((code, start as u32, (chunk.data.len() - start) as u32));
+        }
+
+        if !chunk.times.is_empty() {
+            self.send(chunk);
+        }
+        Ok(())
+    }
+}
+
+#[derive(Debug, Default, Clone, Copy)]
+pub struct VcdStreamStats {
+    pub steps: u64,
+    pub chunks: u64,
+    pub peak_window_bytes: usize,
+}
+
+pub struct VcdStream {
+    pub vars: Vec<VcdVar>,
+    pub timescale_exp: Option<i32>,
+    names: HashMap<String, u32>,
+    code_is_real: Vec<bool>,
+    rx: Receiver<Result<Chunk, String>>,
+    /// Received chunks, `window[0]` holds the current step
+    window: VecDeque<Chunk>,
+    /// Step index of `window[0].times[0]`
+    window_base: u64,
+    window_len: u64,
+    window_bytes: usize,
+    finished: bool,
+    /// Number of steps applied to `values`, the current step is `applied - 1`
+    applied: u64,
+    values: Vec<Vec<u8>>,
+    stats: VcdStreamStats,
+}
+
+impl VcdStream {
+    /// `chunk_bytes` is the approximate size of one chunk, at most `window_chunks`
+    /// chunks are buffered between the producer and the simulation.
+    pub fn open(path: &str, chunk_bytes: usize, window_chunks: usize) -> Result<Self, String> {
+        let file = File::open(path).map_err(|e| format!("cannot open {}: {}", path, e))?;
+        Self::from_reader(
+            BufReader::with_capacity(1 << 20, file),
+            chunk_bytes,
+            window_chunks,
+        )
+    }
+
+    pub fn from_reader<R: BufRead + Send + 'static>(
+        reader: R,
+        chunk_bytes: usize,
+        window_chunks: usize,
+    ) -> Result<Self, String> {
+        let mut tok = Tokenizer::new(reader);
+        let header = parse_header(&mut tok)?;
+
+        let mut names = HashMap::with_capacity(header.vars.len());
+        for (idx, var) in header.vars.iter().enumerate() {
+            names.entry(var.name.clone()).or_insert(idx as u32);
+        }
+        let values = header
+            .code_widths
+            .iter()
+            .zip(&header.code_is_real)
+            .map(|(&w, &is_real)| {
+                if is_real {
+                    b"0".to_vec()
+                } else {
+                    vec![b'0'; w as usize]
+                }
+            })
+            .collect();
+
+        let (tx, rx) = sync_channel(window_chunks.max(1));
+        let producer = Producer {
+            tok,
+            codes: header.codes,
+            code_widths: header.code_widths,
+            code_is_real: header.code_is_real.clone(),
+            chunk_bytes: chunk_bytes.max(1),
+            tx,
+        };
+        std::thread::Builder::new()
+            .name("vcd_stream".to_string())
+            .spawn(move || producer.run())
+            .map_err(|e| format!("cannot spawn the VCD producer thread: {}", e))?;
+
+        Ok(Self {
+            vars: header.vars,
+            timescale_exp: header.timescale_exp,
+            names,
+            code_is_real: header.code_is_real,
+            rx,
+            window: VecDeque::new(),
+            window_base: 0,
+            window_len: 0,
+            window_bytes: 0,
+            finished: false,
+            applied: 0,
+            values,
+            stats: VcdStreamStats::default(),
+        })
+    }
+
+    pub fn var_by_name(&self, name: &str) -> Option<u32> {
+        self.names.get(name).copied()
+    }
+
+    pub fn is_real(&self, var: u32) -> bool {
+        self.code_is_real[self.vars[var as usize].code as usize]
+    }
+
+    fn fetch(&mut self) -> bool {
+        if self.finished {
+            return false;
+        }
+        match self.rx.recv() {
+            Ok(Ok(chunk)) => {
+                self.window_len += chunk.len();
+                self.window_bytes += chunk.size_in_memory();
+                self.stats.chunks += 1;
+                self.stats.steps += chunk.len();
+                self.stats.peak_window_bytes = self.stats.peak_window_bytes.max(self.window_bytes);
+                self.window.push_back(chunk);
+                true
+            }
+            Ok(Err(e)) => panic!("[VcdStream] {}", e),
+            Err(_) => {
+                self.finished = true;
+                false
+            }
+        }
+    }
+
+    /// Whether step `index` exists, waits for the producer if needed.
+    pub fn has_step(&mut self, index: u64) -> bool {
+        while self.window_base + self.window_len <= index {
+            if !self.fetch() {
+                return false;
+            }
+        }
+        true
+    }
+
+    fn locate(&mut self, index: u64) -> (usize, usize) {
+        assert!(
+            index >= self.window_base,
+            "[VcdStream] step {} was already dropped (current window starts at {}), the stream can only move forward",
+            index,
+            self.window_base
+        );
+        assert!(
+            self.has_step(index),
+            "[VcdStream] step {} is beyond the end of the waveform",
+            index
+        );
+        let mut offset = index - self.window_base;
+        for (i, chunk) in self.window.iter().enumerate() {
+            if offset < chunk.len() {
+                return (i, offset as usize);
+            }
+            offset -= chunk.len();
+        }
+        unreachable!()
+    }
+
+    pub fn time(&mut self, index: u64) -> u64 {
+        let (chunk, step) = self.locate(index);
+        self.window[chunk].times[step]
+    }
+
+    /// Apply all steps up to and including `index`.
+    pub fn seek(&mut self, index: u64) {
+        assert!(
+            index + 1 >= self.applied,
+            "[VcdStream] cannot go back from step {} to step {}, the stream can only move forward",
+            self.applied.saturating_sub(1),
+            index
+        );
+
+        while self.applied <= index {
+            let (chunk_idx, step) = self.locate(self.applied);
+            let chunk = &self.window[chunk_idx];
+            for &(code, start, len) in chunk.step_changes(step) {
+                let value = &mut self.values[code as usize];
+                value.clear();
+                value.extend_from_slice(&chunk.data[start as usize..(start + len) as usize]);
+            }
+            self.applied += 1;
+
+            // Drop chunks that end before the current step
+            while let Some(front) = self.window.front() {
+                if self.window_base + front.len() >= self.applied {
+                    break;
+                }
+                self.window_base += front.len();
+                self.window_len -= front.len();
+                self.window_bytes -= front.size_in_memory();
+                self.window.pop_front();
+            }
+        }
+    }
+
+    /// Bit string (or real text) of `var` at step `index`
+    pub fn value(&mut self, var: u32, index: u64) -> &[u8] {
+        self.seek(index);
+        &self.values[self.vars[var as usize].code as usize]
+    }
+
+    pub fn stats(&self) -> VcdStreamStats {
+        self.stats
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::io::Cursor;
+
+    const VCD: &str = r#"
+$date today $end
+$timescale 10ps $end
+$scope module top $end
+$var wire 1 ! clock $end
+$var reg 8 " data [7:0] $end
+$scope module u_core $end
+$var wire 8 " data_alias $end
+$var real 64 # ratio $end
+$var wire 4 $ mem [3] $end
+$upscope $end
+$upscope $end
+$enddefinitions $end
+#0
+$dumpvars
+0!
+bx "
+r0.5 #
+b1 $
+$end
+#10
+1!
+b101 "
+#10
+bz $
+#20
+0!
+$comment ignored $end
+b11111111 "
+r1.25 #
+#30
+1!
+#40
+"#;
+
+    fn open(chunk_bytes: usize) -> VcdStream {
+        VcdStream::from_reader(Cursor::new(VCD.as_bytes().to_vec()), chunk_bytes, 1).unwrap()
+    }
+
+    fn value(stream: &mut VcdStream, name: &str, index: u64) -> String {
+        let var = stream.var_by_name(name).unwrap();
+        String::from_utf8(stream.value(var, index).to_vec()).unwrap()
+    }
+
+    #[test]
+    fn test_vcd_stream_header() {
+        let stream = open(1 << 20);
+        assert_eq!(stream.timescale_exp, Some(-11));
+        let names: Vec<&str> = stream.vars.iter().map(|v| v.name.as_str()).collect();
+        assert_eq!(
+            names,
+            [
+                "top.clock",
+                "top.data",
+                "top.u_core.data_alias",
+                "top.u_core.ratio",
+                "top.u_core.mem[3]"
+            ]
+        );
+        assert_eq!(stream.vars[1].code, stream.vars[2].code);
+        assert_eq!(stream.vars[1].width, 8);
+        assert!(stream.is_real(3));
+        assert_eq!(stream.var_by_name("top.missing"), None);
+    }
+
+    #[test]
+    fn test_vcd_stream_values() {
+        // Tiny chunks: every step is sent on its own and dropped once passed
+        for chunk_bytes in [1, 1 << 20] {
+            let mut stream = open(chunk_bytes);
+            let times: Vec<u64> = (0..5).map(|i| stream.time(i)).collect();
+            assert_eq!(times, [0, 10, 20, 30, 40]);
+            assert!(!stream.has_step(5));
+
+            assert_eq!(value(&mut stream, "top.clock", 0), "0");
+            assert_eq!(value(&mut stream, "top.data", 0), "xxxxxxxx");
+            assert_eq!(value(&mut stream, "top.u_core.ratio", 0), "0.5");
+            assert_eq!(value(&mut stream, "top.u_core.mem[3]", 0), "0001");
+
+            assert_eq!(value(&mut stream, "top.clock", 1), "1");
+            assert_eq!(value(&mut stream, "top.data", 1), "00000101");
+            assert_eq!(value(&mut stream, "top.u_core.data_alias", 1), "00000101");
+            assert_eq!(value(&mut stream, "top.u_core.mem[3]", 1), "zzzz");
+
+            assert_eq!(value(&mut stream, "top.data", 3), "11111111");
+            assert_eq!(value(&mut stream, "top.u_core.ratio", 3), "1.25");
+            assert_eq!(value(&mut stream, "top.clock", 3), "1");
+            assert_eq!(value(&mut stream, "top.clock", 4), "1");
+            assert_eq!(stream.time(4), 40);
+        }
+    }
+
+    #[test]
+    fn test_vcd_stream_bounded_window() {
+        let mut stream = open(1);
+        stream.seek(3);
+        assert_eq!(stream.window_base, 3, "passed chunks must be dropped");
+        assert_eq!(stream.time(3), 30);
+        let stats = stream.stats();
+        assert!(stats.chunks >= 4);
+    }
+
+    #[test]
+    #[should_panic(expected = "can only move forward")]
+    fn test_vcd_stream_no_rewind() {
+        let mut stream = open(1);
+        stream.seek(3);
+        stream.seek(1);
+    }
+
+    #[test]
+    fn test_push_bits() {
+        let mut data = Vec::new();
+        push_bits(&mut data, b"1", 4);
+        push_bits(&mut data, b"X1", 4);
+        push_bits(&mut data, b"110011", 4);
+        assert_eq!(data, b"0001xxx10011");
+    }
+
+    #[test]
+    fn test_parse_timescale() {
+        assert_eq!(parse_timescale(&["1ps".to_string()]), Some(-12));
+        assert_eq!(
+            parse_timescale(&["100".to_string(), "ns".to_string()]),
+            Some(-7)
+        );
+        assert_eq!(parse_timescale(&["3ns".to_string()]), None);
+    }
+}
@@ -0,0 +1,105 @@
+--
+-- Micro-benchmark of the BitVec hot paths: time and bytes allocated per operation, at widths
+-- from 32 to 4096 bits. Runs without a simulator:
+--
+--   luajit tests/benchmarks/cases/bitvec.lua
+--
+-- BITVEC_BENCH_OPS: operations per measurement (default 20000, scaled down for wide values)
+-- BITVEC_BENCH_BASELINE: path of another BitVec.lua to compare against, e.g. one taken from an
+--                        older revision with `git show <rev>:src/lua/verilua/utils/BitVec.lua`
+--
+
+if os.getenv("JIT_V") == "off" then
+    jit.off()
+end
+
+local ffi = require "ffi"
+local BitVec = require "verilua.utils.BitVec"
+
+local f = string.format
+local random = math.random
+
+local nr_ops = tonumber(os.getenv("BITVEC_BENCH_OPS") or "20000")
+local baseline_path = os.getenv("BITVEC_BENCH_BASELINE")
+local WIDTHS = { 32, 64, 128, 512, 4096 }
+
+math.randomseed(1)
+
+local impls = { { "current", BitVec } }
+if baseline_path then
+    table.insert(impls, 1, { "baseline", dofile(baseline_path) })
+end
+
+---@param bitwidth integer
+---@return string
+local function rand_hex(bitwidth)
+    local t = {}
+    for i = 1, math.ceil(bitwidth / 4) do
+        t[i] = f("%x", random(0, 15))
+    end
+    return table.concat(t)
+end
+
+--- A `vpiml_get_value_multi` style result: beat count at index 0, beats from index 1
+---@param bitwidth integer
+---@return ffi.cdata*
+local function rand_c_results(bitwidth)
+    local beat_num = math.floor((bitwidth + 31) / 32)
+    local c_results = ffi.new("uint32_t[?]", beat_num + 1)
+    c_results[0] = beat_num
+    for i = 1, beat_num do
+        c_results[i] = random(0, 0x7fffffff)
+    end
+    return c_results
+end
+
+local CASES = {
+    {
+        "update (get_bitvec)",
+        function(bv, w, c_results)
+            bv:_update_u32_vec(w <= 32 and c_results[1] or c_results)
+        end,
+    },
+    { "get_bitfield",         function(bv, w) return bv:get_bitfield(w - 20, w - 1) end },
+    { "set_bitfield",         function(bv, w) bv:set_bitfield(w - 20, w - 1, 0x12345) end },
+    { "get_bitfield_hex_str", function(bv, w) return bv:get_bitfield_hex_str(0, w - 1) end },
+    { "set_bitfield_hex_str", function(bv, w, _, hex) bv:set_bitfield_hex_str(0, w - 1, hex) end },
+    { "update_value(hex)",    function(bv, _, _, hex) bv:update_value(hex) end },
+    { "to_hex_str",           function(bv) return bv:to_hex_str() end },
+}
+
+---@return number seconds, number bytes
+local function measure(run, bv, w, c_results, hex, n)
+    collectgarbage("collect")
+    collectgarbage("stop")
+    local kb = collectgarbage("count")
+    local s = os.clock()
+    for _ = 1, n do
+        run(bv, w, c_results, hex)
+    end
+    local t = os.clock() - s
+    local bytes = (collectgarbage("count") - kb) * 1024
+    collectgarbage("restart")
+    return t, bytes
+end
+
+print(f("[bitvec bench] jit: %s, ns and bytes allocated per operation", os.getenv("JIT_V") or "on"))
+print(f("%-22s %6s %-9s %10s %10s", "operation", "width", "impl", "ns/op", "bytes/op"))
+for _, case in ipairs(CASES) do
+    local name, run = case[1], case[2]
+    for _, w in ipairs(WIDTHS) do
+        local init, hex = rand_hex(w), rand_hex(w)
+        local c_results = rand_c_results(w)
+        local n = math.max(100, math.floor(nr_ops * 64 / math.max(w, 64)))
+
+        for _, impl in ipairs(impls) do
+            local bv = impl[2](init, w)
+
+            -- Warm up so that the JIT has compiled the loop before measuring
+            measure(run, bv, w, c_results, hex, 100)
+
+            local t, bytes = measure(run, bv, w, c_results, hex, n)
+            print(f("%-22s %6d %-9s %10.1f %10.1f", name, w, impl[1], t / n * 1e9, bytes / n))
+        end
+    end
+end
@@ -4,10 +4,181 @@ end
 
 local clock = dut.clock:chdl()
 
+--
+-- SCHED_LAYOUT_BENCH=1: compare the task table layouts of the V2 schedulers without
+-- going through the simulator. `HashMapLayout` is the bookkeeping the schedulers used
+-- before the structure-of-arrays task table (one hash map per task attribute plus a
+-- pending removal list), the other one is a fresh instance of the running scheduler.
+-- Both see the same workload: `nr_task` live tasks, each scheduled once per round like
+-- an edge callback would do, finishing after 1 ~ 16 rounds and replaced by a new
+-- `fork`ed task so that the number of live tasks stays constant.
+--
+local function sched_layout_bench()
+    local coro_yield = coroutine.yield
+    local coro_resume = coroutine.resume
+    local coro_create = coroutine.create
+    local table_insert = table.insert
+    local table_clear = require "table.clear"
+
+    local EarlyExit = 4444
+    local NOOP = 5555
+
+    local HashMapLayout = {}
+    HashMapLayout.__index = HashMapLayout
+
+    function HashMapLayout.new()
+        return setmetatable({
+            task_coroutine_map = {},
+            task_body_map = {},
+            task_name_map_running = {},
+            task_name_map_archived = {},
+            task_fired_status_map = {},
+            task_execution_count_map = {},
+            user_removal_tasks_set = {},
+            nr_user_removal_tasks = 0,
+            pending_removal_tasks = {},
+            nr_pending_removal_tasks = 0,
+            next_task_id = 1,
+            curr_task_id = 0,
+        }, HashMapLayout)
+    end
+
+    function HashMapLayout:_alloc_task_id()
+        while self.task_name_map_archived[self.next_task_id] ~= nil do
+            self.next_task_id = self.next_task_id + 1
+        end
+        local id = self.next_task_id
+        self.next_task_id = self.next_task_id + 1
+        return id
+    end
+
+    function HashMapLayout:append_task(_, name, task_body, start_now)
+        local task_id = self:_alloc_task_id()
+        self.task_name_map_running[task_id] = name
+        self.task_name_map_archived[task_id] = name
+        self.task_fired_status_map[task_id] = false
+        self.task_coroutine_map[task_id] = coro_create(task_body)
+        self.task_body_map[task_id] = task_body
+        self.task_execution_count_map[task_id] = 0
+        if start_now then
+            self.task_fired_status_map[task_id] = true
+            self:schedule_task(task_id)
+        end
+        return task_id
+    end
+
+    function HashMapLayout:schedule_task(id)
+        local nr_pending_removal_tasks = self.nr_pending_removal_tasks
+        if nr_pending_removal_tasks > 0 then
+            local pending_removal_tasks = self.pending_removal_tasks
+            for i = 1, nr_pending_removal_tasks do
+                local remove_id = pending_removal_tasks[i]
+                self.task_name_map_running[remove_id] = nil
+                self.task_execution_count_map[remove_id] = 0
+                self.task_fired_status_map[remove_id] = false
+            end
+            self.nr_pending_removal_tasks = 0
+            table_clear(pending_removal_tasks)
+        end
+
+        if self.nr_user_removal_tasks > 0 and self.user_removal_tasks_set[id] then
+            return
+        end
+
+        self.task_execution_count_map[id] = self.task_execution_count_map[id] + 1
+
+        local old_curr_task_id = self.curr_task_id
+        self.curr_task_id = id
+        local ok, cb_type_or_err = coro_resume(self.task_coroutine_map[id])
+        self.curr_task_id = old_curr_task_id
+        assert(ok, cb_type_or_err)
+
+        if cb_type_or_err == nil or cb_type_or_err == EarlyExit then
+            table_insert(self.pending_removal_tasks, id)
+            self.nr_pending_removal_tasks = self.nr_pending_removal_tasks + 1
+        end
+    end
+
+    local nr_rounds = tonumber(os.getenv("SCHED_BENCH_ROUNDS") or "20")
+    local nr_repeats = tonumber(os.getenv("SCHED_BENCH_REPEATS") or "3")
+
+    ---@param sched any
+    ---@param nr_task integer
+    ---@return number seconds, number retained_kb
+    local function run(sched, nr_task)
+        local live_ids = {}
+        local finished = {}
+        local nr_finished = 0
+
+        local function spawn(slot)
+            local life = 1 + slot % 16
+            live_ids[slot] = sched:append_task(nil, "bench_task", function()
+                for _ = 1, life do
+                    coro_yield(NOOP)
+                end
+                nr_finished = nr_finished + 1
+                finished[nr_finished] = slot
+            end, true, true)
+        end
+
+        -- Both layouts create the same coroutines, keep the collector out of the timing and
+        -- report what each layout still holds afterwards instead.
+        collectgarbage()
+        collectgarbage()
+        local base_kb = collectgarbage("count")
+        collectgarbage("stop")
+
+        local s = os.clock()
+        for slot = 1, nr_task do
+            spawn(slot)
+        end
+        for _ = 1, nr_rounds do
+            for slot = 1, nr_task do
+                sched:schedule_task(live_ids[slot])
+            end
+            for i = 1, nr_finished do
+                spawn(finished[i])
+            end
+            nr_finished = 0
+        end
+        local t = os.clock() - s
+
+        collectgarbage("restart")
+        collectgarbage()
+        collectgarbage()
+        return t, collectgarbage("count") - base_kb
+    end
+
+    local soa_layout_class = getmetatable(scheduler)
+    print(("[sched_layout_bench] rounds: %d, best of %d, jit: %s"):format(nr_rounds, nr_repeats, os.getenv("JIT_V") or "on"))
+    print(("%8s %14s %12s %14s %12s %8s"):format("tasks", "hash map (ms)", "(MB held)", "SoA (ms)", "(MB held)", "speedup"))
+    for _, nr_task in ipairs({ 1000, 10000, 100000 }) do
+        -- Alternate the layouts so that neither one always runs on the heap the other left behind
+        local t_hash, t_soa = math.huge, math.huge
+        local kb_hash, kb_soa
+        for _ = 1, nr_repeats do
+            local t
+            t, kb_hash = run(HashMapLayout.new(), nr_task)
+            t_hash = math.min(t_hash, t)
+            t, kb_soa = run(soa_layout_class(), nr_task)
+            t_soa = math.min(t_soa, t)
+        end
+        print(("%8d %14.2f %12.1f %14.2f %12.1f %7.2fx"):format(
+            nr_task, t_hash * 1000, kb_hash / 1024, t_soa * 1000, kb_soa / 1024, t_hash / t_soa
+        ))
+    end
+end
+
 fork {
     function()
         clock:posedge()
 
+        if os.getenv("SCHED_LAYOUT_BENCH") == "1" then
+            sched_layout_bench()
+            sim.finish()
+            return
+        end
+
         local cycles = 10000 * 10
         local _nr_task = os.getenv("NR_TASK") or "100"
         local nr_task = tonumber(_nr_task)
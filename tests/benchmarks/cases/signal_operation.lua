@@ -9,6 +9,13 @@ local reg32 = top.reg32:chdl()
 local reg64 = top.reg64:chdl()
 local reg128 = top.reg128:chdl()
 
+-- The same signals as a regular bundle and as a packed one (get_all fills a struct, set_all and
+-- fire are one native call each)
+local bdl = ("reg8 | reg16 | reg32 | reg64 | reg128"):bdl { hier = top:name(), is_decoupled = false }
+local packed_bdl = ("reg8 | reg16 | reg32 | reg64 | reg128"):bdl { hier = top:name(), is_decoupled = false, packed = true }
+local hs_bdl = ("valid | ready | data"):bdl { hier = top:name(), prefix = "i_", is_decoupled = false }
+local packed_hs_bdl = ("valid | ready | data"):bdl { hier = top:name(), prefix = "i_", is_decoupled = false, packed = true }
+
 fork {
     function()
         clock:posedge()
@@ -90,6 +97,64 @@ fork {
             end
         end
 
+        -- Bundle: regular vs packed
+        do
+            local times = 10000 * 10
+
+            local function report(name, start)
+                print(string.format("[signal_operation] %-24s %.3f s", name, os.clock() - start))
+            end
+
+            local t = os.clock()
+            for _ = 1, times do
+                local values = bdl:get_all()
+                assert(values[3])
+            end
+            report("bundle get_all", t)
+
+            t = os.clock()
+            local out = packed_bdl.packed_t()
+            for _ = 1, times do
+                local values = packed_bdl:get_all(out)
+                assert(values.reg32)
+            end
+            report("packed get_all", t)
+
+            local nr_fire = 0
+            t = os.clock()
+            for _ = 1, times do
+                if hs_bdl:fire() then
+                    nr_fire = nr_fire + 1
+                end
+            end
+            report("bundle fire", t)
+
+            t = os.clock()
+            for _ = 1, times do
+                if packed_hs_bdl:fire() then
+                    nr_fire = nr_fire - 1
+                end
+            end
+            report("packed fire", t)
+            assert(nr_fire == 0)
+
+            local set_values = { 8, 16, 32, 64ULL, 128 }
+            t = os.clock()
+            for _ = 1, times / 10 do
+                bdl:set_all(set_values)
+                clock:posedge()
+            end
+            report("bundle set_all", t)
+
+            t = os.clock()
+            packed_bdl:get_all(out)
+            for _ = 1, times / 10 do
+                packed_bdl:set_all(out)
+                clock:posedge()
+            end
+            report("packed set_all", t)
+        end
+
         local e = os.clock()
         -- TODO: without startup time
         print(e - s)
@@ -0,0 +1,79 @@
+--
+-- Micro-benchmark of the StrBitsUtils hex string operations: pure-Lua implementations
+-- against the libstr_bits kernels, at widths from 8 to 8192 bits. Runs without a
+-- simulator:
+--
+--   luajit tests/benchmarks/cases/str_bits_utils.lua
+--
+-- STR_BITS_BENCH_OPS: operations per measurement (default 20000, scaled down for wide values)
+--
+
+if os.getenv("JIT_V") == "off" then
+    jit.off()
+end
+
+local sbu = require "verilua.utils.StrBitsUtils"
+
+local f = string.format
+local random = math.random
+
+if not sbu.init_use_native() then
+    print("[str_bits_utils bench] libstr_bits is not available, build it with `xmake build libstr_bits`")
+    return
+end
+
+local L = sbu.lua
+local nr_ops = tonumber(os.getenv("STR_BITS_BENCH_OPS") or "20000")
+local WIDTHS = { 8, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 }
+
+math.randomseed(1)
+
+---@param bitwidth integer
+---@return string
+local function rand_hex(bitwidth)
+    local t = {}
+    for i = 1, math.ceil(bitwidth / 4) do
+        t[i] = f("%x", random(0, 15))
+    end
+    return table.concat(t)
+end
+
+local CASES = {
+    { "bor_hex_str",          function(impl, a, b, w) return impl(a, b, w) end },
+    { "bxor_hex_str",         function(impl, a, b, w) return impl(a, b, w) end },
+    { "band_hex_str",         function(impl, a, b, w) return impl(a, b, w) end },
+    { "bnot_hex_str",         function(impl, a, _, w) return impl(a, w) end },
+    { "add_hex_str",          function(impl, a, b, w) return impl(a, b, w) end },
+    { "lshift_hex_str",       function(impl, a, _, w) return impl(a, 5, w) end },
+    { "rshift_hex_str",       function(impl, a, _, w) return impl(a, 5, w) end },
+    { "bitfield_hex_str",     function(impl, a, _, w) return impl(a, 1, w - 2, w) end },
+    { "set_bitfield_hex_str", function(impl, a, b, w) return impl(a, 1, w - 2, b, w) end },
+    { "popcount_hex_str",     function(impl, a) return impl(a) end },
+}
+
+---@return number seconds
+local function measure(impl, run, a, b, w, n)
+    local s = os.clock()
+    for _ = 1, n do
+        run(impl, a, b, w)
+    end
+    return os.clock() - s
+end
+
+print(f("[str_bits_utils bench] jit: %s, ns per operation", os.getenv("JIT_V") or "on"))
+print(f("%-22s %6s %12s %12s %8s", "operation", "width", "pure Lua", "native", "speedup"))
+for _, case in ipairs(CASES) do
+    local name, run = case[1], case[2]
+    for _, w in ipairs(WIDTHS) do
+        local a, b = rand_hex(w), rand_hex(w)
+        local n = math.max(100, math.floor(nr_ops * 64 / math.max(w, 64)))
+
+        -- Warm up both so that the JIT has compiled them before timing
+        measure(L[name], run, a, b, w, 10)
+        measure(sbu[name], run, a, b, w, 10)
+
+        local t_lua = measure(L[name], run, a, b, w, n)
+        local t_native = measure(sbu[name], run, a, b, w, n)
+        print(f("%-22s %6d %12.1f %12.1f %7.1fx", name, w, t_lua / n * 1e9, t_native / n * 1e9, t_lua / t_native))
+    end
+end
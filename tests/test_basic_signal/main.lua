@@ -140,6 +140,19 @@ fork {
             assert(table.nkeys(values) == 1)
             local v, _ = next(values)
             assert(v == full_mask)
+
+            -- shuffled range from the `uint32_t *` view of a BitVec, length passed explicitly
+            local BitVec = require "verilua.utils.BitVec"
+            local bv = BitVec({ 2, 7, 9 }, 96)
+            reg4:shuffled_range_u32(bv.u32_vec, bv.nr_u32_vec)
+            table.clear(values)
+            for _ = 1, 100 do
+                reg4:set_shuffled()
+                clock:posedge()
+                values[reg4:get()] = true
+            end
+            assert(table.nkeys(values) == 3)
+            assert(values[2] and values[7] and values[9])
         end
         test_set_shuffled_with_shuffle_range_u32()
         test_set_shuffled_with_shuffle_range_u32(true)
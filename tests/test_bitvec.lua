@@ -72,6 +72,7 @@ describe("BitVec test", function()
             { data = { 0x01010101, 0x00000123, 0x00000456, 0x00001789 },             s = 0,   e = 63,  value = 0xFFFFFFFFFFFFFFFFULL, expected = { 0xFFFFFFFF, 0xFFFFFFFF, 0x00000456, 0x00001789 } },
             { data = { 0x01010101, 0xdeadbeef, 0xff000456, 0x00001789 },             s = 93,  e = 120, value = 0xFFFF,                expected = { 0x01010101, 0xdeadbeef, 0xff000456, 0x00001FFF } },
             { data = { 0x01010101, 0xdeadbeef, 0xff000456, 0x00001789 },             s = 40,  e = 103, value = 0xdeadbeefaabbccddULL, expected = { 0x01010101, 0xbbccddef, 0xadbeefaa, 0x000017de } },
+            { data = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF },             s = 16,  e = 79,  value = 0,                     expected = { 0x0000FFFF, 0x00000000, 0xFFFF0000, 0xFFFFFFFF } },
 
             -- 0 ~ 31, 32 ~ 63, 64 ~ 95, 96 ~ 127, 128 ~ 159
             { data = { 0x01010101, 0xdeadbeef, 0xff000456, 0xdeadbeef, 0x12345678 }, s = 80,  e = 140, value = 0xFFFFFFFFFFFFFFFFULL, expected = { 0x01010101, 0xdeadbeef, 0xffff0456, 0xffffffff, 0x12345fff } },
@@ -82,7 +83,8 @@ describe("BitVec test", function()
             local bitvec = BitVec(test.data)
             bitvec:set_bitfield(test.s, test.e, test.value --[[@as integer|uint64_t]])
             local result = bitvec.u32_vec
-            for i, val in ipairs(result) do
+            for i = 1, bitvec.nr_u32_vec do
+                local val = result[i]
                 assert(val == test.expected[i],
                     f("Failed for s=%d, e=%d: expected 0x%x at index %d, got 0x%x", test.s, test.e, test.expected[i], i,
                         val))
@@ -211,7 +213,7 @@ describe("BitVec test", function()
             local result = bitvec.u32_vec
             bitvec:set_bitfield_vec(test.s, test.e, test.value)
 
-            for i, _ in ipairs(result) do
+            for i = 1, bitvec.nr_u32_vec do
                 assert(result[i] == test.expected[i],
                     f("Failed for s=%d, e=%d: expected 0x%x at index %d, got 0x%x", test.s, test.e, test.expected[i], i,
                         result[i]))
@@ -243,7 +245,7 @@ describe("BitVec test", function()
             local result = bitvec.u32_vec
             bitvec:set_bitfield_hex_str(test.s, test.e, test.value)
 
-            for i, _ in ipairs(result) do
+            for i = 1, bitvec.nr_u32_vec do
                 assert(result[i] == test.expected[i],
                     f("Failed for s=%d, e=%d: expected 0x%x at index %d, got 0x%x", test.s, test.e, test.expected[i], i,
                         result[i]))
@@ -284,12 +286,12 @@ describe("BitVec test", function()
     it("should work properly for creating BitVec using number", function()
         local bitvec = BitVec(0)
         expect.equal(#bitvec, 32)
-        expect.equal(#(bitvec.u32_vec), 1)
+        expect.equal(bitvec.nr_u32_vec, 1)
         expect.equal(tostring(bitvec), "00000000")
 
         local bitvec = BitVec(0x12345678, 128)
         expect.equal(#bitvec, 128)
-        expect.equal(#(bitvec.u32_vec), 4)
+        expect.equal(bitvec.nr_u32_vec, 4)
         expect.equal(tostring(bitvec), "00000000000000000000000012345678")
     end)
 
@@ -437,7 +439,7 @@ describe("BitVec test", function()
         -- Test ULL with bit_width parameter
         local bitvec = BitVec(0x123456789ABCDEFULL, 128)
         expect.equal(#bitvec, 128)
-        expect.equal(#(bitvec.u32_vec), 4)
+        expect.equal(bitvec.nr_u32_vec, 4)
         expect.equal(bitvec.u32_vec[1], 0x89abcdef)
         expect.equal(bitvec.u32_vec[2], 0x01234567)
         expect.equal(bitvec.u32_vec[3], 0)
@@ -447,7 +449,7 @@ describe("BitVec test", function()
         -- Test ULL with smaller bit_width
         local bitvec = BitVec(ffi.new("uint64_t", 0xFFFFFFFFFFFFFFFFULL), 32)
         expect.equal(#bitvec, 32)
-        expect.equal(#(bitvec.u32_vec), 1)
+        expect.equal(bitvec.nr_u32_vec, 1)
         expect.equal(bitvec.u32_vec[1], 0xFFFFFFFF)
         expect.equal(tostring(bitvec), "ffffffff")
 
@@ -466,7 +468,7 @@ describe("BitVec test", function()
         -- Test ULL with 32-bit value
         local bitvec = BitVec(0x12345678ULL, 32)
         expect.equal(#bitvec, 32)
-        expect.equal(#(bitvec.u32_vec), 1)
+        expect.equal(bitvec.nr_u32_vec, 1)
         expect.equal(bitvec.u32_vec[1], 0x12345678)
         expect.equal(tostring(bitvec), "12345678")
         expect.equal(bitvec:tonumber(), 0x12345678)
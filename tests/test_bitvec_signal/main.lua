@@ -163,6 +163,24 @@ fork {
             value128.value = bv
             clock:negedge()
             value128:expect_hex_str("048d0000000000000000000000000000")
+
+            -- `u32_vec` is a 1-based `uint32_t *` view of the BitVec limbs
+            clock:negedge()
+            bv:set_bitfield_hex_str(0, 31, "deadbeef")
+            value128.value = bv.u32_vec
+            clock:negedge()
+            value128:expect_hex_str("048d00000000000000000000deadbeef")
+
+            clock:negedge()
+            local bv32 = BitVec("cafe", 32)
+            value32.value = bv32.u32_vec
+            clock:negedge()
+            value32:expect_hex_str("0000cafe")
+
+            clock:negedge()
+            bv:set_bitfield_hex_str(64, 95, "12345678")
+            value128.value_imm = bv.u32_vec
+            value128:expect_hex_str("048d00001234567800000000deadbeef")
         end
 
         do
@@ -222,6 +240,24 @@ fork {
             assert(value128 == v(t))
         end
 
+        do
+            -- A narrow put after a wide string put must not keep its upper words
+            clock:negedge()
+            value128:set_hex_str("ffffffffffffffffffffffffffffffff")
+            clock:negedge()
+            expect.equal(value128:get_hex_str(), "ffffffffffffffffffffffffffffffff")
+            dut.value128:set(0x5a)
+            clock:negedge()
+            expect.equal(value128:get_hex_str(), "0000000000000000000000000000005a")
+
+            clock:negedge()
+            value128:set_hex_str("ffffffffffffffffffffffffffffffff")
+            clock:negedge()
+            value128:set({ 1, 2, 3, 4 })
+            clock:negedge()
+            expect.equal(value128:get_hex_str(), "00000004000000030000000200000001")
+        end
+
         print("Finish")
         sim.finish()
     end
@@ -0,0 +1,57 @@
+local lester = require "lester"
+local expect = lester.expect
+
+-- Time of every posedge of each extra clock domain, recorded by the per-domain step hooks
+local edges = { clk_a = {}, clk_b = {} }
+
+verilua "domainStep" {
+    clk_a = function()
+        table.insert(edges.clk_a, tonumber(sim.get_sim_time()))
+    end,
+    clk_b = function()
+        table.insert(edges.clk_b, tonumber(sim.get_sim_time()))
+    end,
+}
+
+---@param times integer[]
+---@return integer interval between consecutive edges, asserted to be constant
+local function edge_interval(times)
+    local interval = times[2] - times[1]
+    for i = 3, #times do
+        expect.equal(times[i] - times[i - 1], interval)
+    end
+    return interval
+end
+
+fork {
+    function()
+        local clock = dut.clock:chdl()
+
+        dut.reset:set(1)
+        clock:posedge(10)
+        dut.reset:set(0)
+        clock:posedge(50)
+
+        -- The domains are toggled by the testbench (natively under Verilator), the RTL sees every edge
+        local cnt_a = dut.cnt_a:get()
+        local cnt_b = dut.cnt_b:get()
+        assert(cnt_b >= 10, "clk_b did not toggle: cnt_b = " .. cnt_b)
+        assert(math.abs(cnt_a - 3 * cnt_b) <= 3, string.format("unexpected clk_a / clk_b ratio: %d / %d", cnt_a, cnt_b))
+
+        -- iverilog has no DPI-C, so no step hooks
+        if cfg.simulator ~= "iverilog" then
+            local a, b = edges.clk_a, edges.clk_b
+            assert(math.abs(#a - cnt_a) <= 1, string.format("clk_a steps: %d, clk_a edges: %d", #a, cnt_a))
+            assert(math.abs(#b - cnt_b) <= 1, string.format("clk_b steps: %d, clk_b edges: %d", #b, cnt_b))
+
+            -- clk_a: first posedge after half a period; clk_b: after its phase plus half a period (4x later)
+            local period_a = edge_interval(a)
+            expect.equal(edge_interval(b), 3 * period_a)
+            expect.equal(a[1] * 2, period_a)
+            expect.equal(b[1], 4 * a[1])
+        end
+
+        print("Finish")
+        sim.finish()
+    end,
+}
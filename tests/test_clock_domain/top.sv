@@ -0,0 +1,18 @@
+module top(
+    input  wire        clock,
+    input  wire        reset,
+    input  wire        clk_a,
+    input  wire        clk_b,
+    output reg  [31:0] cnt_a,
+    output reg  [31:0] cnt_b
+);
+
+initial begin
+    cnt_a = 0;
+    cnt_b = 0;
+end
+
+always @(posedge clk_a) cnt_a <= cnt_a + 1;
+always @(posedge clk_b) cnt_b <= cnt_b + 1;
+
+endmodule
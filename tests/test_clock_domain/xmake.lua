@@ -0,0 +1,30 @@
+---@diagnostic disable
+
+target("test", function()
+    add_rules("verilua")
+
+    on_config(function(target)
+        local sim = os.getenv("SIM") or "verilator"
+        if sim == "iverilog" then
+            target:set("toolchains", "@iverilog")
+        elseif sim == "vcs" then
+            target:set("toolchains", "@vcs")
+        elseif sim == "xcelium" then
+            target:set("toolchains", "@xcelium")
+        elseif sim == "verilator" then
+            target:set("toolchains", "@verilator")
+        else
+            raise("unknown simulator: %s", sim)
+        end
+    end)
+
+    add_files("top.sv")
+
+    set_values("verilua.top", "top")
+    set_values("verilua.lua_main", "./main.lua")
+
+    -- Two extra domains next to the main clock: clk_b is 3x slower than clk_a and
+    -- starts half a clk_a period late
+    set_values("verilua.clock_domains", "clk_a:10", "clk_b:30:5")
+    set_values("verilua.domain_step", "1")
+end)
@@ -0,0 +1,398 @@
+--- Tests of the libcov_bins backed BinCoverPoint / BinCross / CoverGroup.
+--- Run with: luajit tests/test_cov_bins.lua (needs $VERILUA_HOME/shared/libcov_bins.so,
+--- built by `xmake build libcov_bins`).
+
+_G.verilua_debug = _G.verilua_debug or function() end
+_G.verilua_warning = _G.verilua_warning or function() end
+_G.printf = _G.printf or function(...) io.write(string.format(...)) end
+_G.cfg = _G.cfg or { simulator = "none" }
+
+local ffi = require "ffi"
+local native = require "verilua.coverage.CovBinsNative"
+local lester = require "lester"
+
+local describe, it, expect = lester.describe, lester.it, lester.expect
+
+if not native.lib then
+    print("[test_cov_bins] libcov_bins is not available, skipped")
+    return
+end
+
+local CoverGroup = require "verilua.coverage.CoverGroup"
+local BinCoverPoint = require "verilua.coverage.BinCoverPoint"
+local BinCross = require "verilua.coverage.BinCross"
+local BitVec = require "verilua.utils.BitVec"
+
+local tmp_dir = os.getenv("TMPDIR") or "/tmp"
+local tmp_id = 0
+
+---@return string
+local function tmp_path(suffix)
+    tmp_id = tmp_id + 1
+    return string.format("%s/test_cov_bins_%d_%d%s", tmp_dir, os.time(), tmp_id, suffix)
+end
+
+---@return string
+local function read_file(path)
+    local file = assert(io.open(path, "r"))
+    local content = file:read("*a")
+    file:close()
+    return content
+end
+
+--- A group with an `opcode` point (values, ranges, ignore, illegal, default) and a `size` point
+local function new_alu_group(name)
+    local cg = CoverGroup(name)
+    local opcode = BinCoverPoint("opcode", cg, {
+        width = 8,
+        on_illegal = "count",
+        bins = {
+            { name = "nop",      value = 0 },
+            { name = "alu",      range = { 1, 15 } },
+            { name = "mem",      range = { 16, 31 } },
+            { name = "debug",    value = 0x40,           ignore = true },
+            { name = "reserved", range = { 0xf0, 0xff }, illegal = true },
+            { name = "others",   default = true },
+        },
+    })
+    local size = BinCoverPoint("size", cg, {
+        width = 2,
+        bins = {
+            { name = "b", value = 0 },
+            { name = "h", value = 1 },
+            { name = "w", value = 2 },
+        },
+    })
+    return cg, opcode, size
+end
+
+describe("BinCoverPoint", function()
+    it("should count value and range bins", function()
+        local _, opcode = new_alu_group("values")
+        for _, v in ipairs({ 0, 1, 5, 15, 16, 31, 0 }) do
+            opcode:sample(v)
+        end
+        expect.equal(opcode:hits("nop"), 2)
+        expect.equal(opcode:hits("alu"), 3)
+        expect.equal(opcode:hits("mem"), 2)
+        expect.equal(opcode:hits("others"), 0)
+        expect.equal(opcode:samples(), 7)
+        expect.equal(opcode:coverage(), 100)
+    end)
+
+    it("should handle ignore, illegal and default bins", function()
+        local _, opcode = new_alu_group("kinds")
+        opcode:sample(0x40)
+        opcode:sample(0xf3)
+        opcode:sample(0x80)
+        opcode:sample(0x20)
+        expect.equal(opcode:hits("debug"), 1)
+        expect.equal(opcode:hits("reserved"), 1)
+        expect.equal(opcode:hits("others"), 2)
+        expect.equal(opcode:hits("nop") + opcode:hits("alu") + opcode:hits("mem"), 0)
+        expect.equal(opcode:coverage(), 0)
+    end)
+
+    it("should raise on illegal values by default", function()
+        local cg = CoverGroup("illegal")
+        local cp = BinCoverPoint("cp", cg, {
+            width = 4,
+            bins = { { name = "ok", range = { 0, 7 } }, { name = "bad", range = { 8, 15 }, illegal = true } },
+        })
+        cp:sample(3)
+        local ok, err = pcall(cp.sample, cp, 9)
+        expect.falsy(ok)
+        expect.truthy(tostring(err):find("illegal bin `bad`", 1, true))
+    end)
+
+    it("should exclude a value hitting an ignore bin from overlapping bins", function()
+        local cg = CoverGroup("overlap")
+        local cp = BinCoverPoint("cp", cg, {
+            width = 8,
+            bins = {
+                { name = "all",  range = { 0, 255 } },
+                { name = "low",  range = { 0, 127 } },
+                { name = "skip", range = { 100, 110 }, ignore = true },
+            },
+        })
+        cp:sample(50)
+        cp:sample(105)
+        cp:sample(200)
+        expect.equal(cp:hits("all"), 2)
+        expect.equal(cp:hits("low"), 1)
+        expect.equal(cp:hits("skip"), 1)
+    end)
+
+    it("should match wildcards", function()
+        local cg = CoverGroup("wildcard")
+        local cp = BinCoverPoint("cp", cg, {
+            width = 4,
+            bins = {
+                { name = "odd",  wildcard = "???1" },
+                { name = "top",  wildcard = "1x_x0" },
+            },
+        })
+        for v = 0, 15 do
+            cp:sample(v)
+        end
+        expect.equal(cp:hits("odd"), 8)
+        expect.equal(cp:hits("top"), 4)
+    end)
+
+    it("should match transitions", function()
+        local cg = CoverGroup("transition")
+        local cp = BinCoverPoint("state", cg, {
+            width = 3,
+            bins = {
+                { name = "idle_busy_done", transition = { 0, { 1, 3 }, 4 } },
+                { name = "busy_idle",      transition = { { 1, 3 }, 0 } },
+            },
+        })
+        for _, v in ipairs({ 0, 2, 4, 0, 1, 1, 4, 3, 0, 3, 4 }) do
+            cp:sample(v)
+        end
+        expect.equal(cp:hits("idle_busy_done"), 2)
+        expect.equal(cp:hits("busy_idle"), 1)
+    end)
+
+    it("should create auto bins", function()
+        local cg = CoverGroup("auto")
+        local small = BinCoverPoint("small", cg, { width = 3 })
+        local wide = BinCoverPoint("wide", cg, { width = 64, auto_bins = 4 })
+        expect.equal(#small.bin_names, 8)
+        expect.equal(small.bin_names[1], "auto[0]")
+        expect.equal(#wide.bin_names, 4)
+        expect.equal(wide.bin_names[4], "auto[13835058055282163712:18446744073709551615]")
+
+        wide:sample(0xFFFFFFFFFFFFFFFFULL)
+        wide:sample(0)
+        expect.equal(wide:hits(wide.bin_names[4]), 1)
+        expect.equal(wide:hits(wide.bin_names[1]), 1)
+        expect.equal(wide:coverage(), 50)
+    end)
+
+    it("should sample uint64 cdata and BitVec values", function()
+        local cg = CoverGroup("wide_values")
+        local cp = BinCoverPoint("cp", cg, {
+            width = 128,
+            bins = {
+                { name = "high", range = { 0x8000000000000000ULL, 0xFFFFFFFFFFFFFFFFULL } },
+                { name = "low",  range = { 0, 0xFF } },
+                { name = "wide", default = true },
+            },
+        })
+        cp:sample(0x8000000000000001ULL)
+        cp:sample(BitVec("ff", 128))
+        cp:sample(BitVec("10000000000000000", 128))
+
+        local limbs = ffi.new("uint64_t[2]", 0xFFFFFFFFFFFFFFFFULL, 0)
+        cp:sample_limbs(limbs, 2)
+
+        expect.equal(cp:hits("high"), 2)
+        expect.equal(cp:hits("low"), 1)
+        expect.equal(cp:hits("wide"), 1)
+    end)
+
+    it("should reject a structure change after the first sample", function()
+        local cg = CoverGroup("frozen")
+        local cp = BinCoverPoint("a", cg, { width = 1 })
+        cp:sample(1)
+        expect.fail(function() BinCoverPoint("b", cg, { width = 1 }) end)
+    end)
+
+    it("should reject invalid bins", function()
+        local cg = CoverGroup("invalid")
+        expect.fail(function()
+            BinCoverPoint("a", cg, { width = 4, bins = { { name = "x", range = { 5, 1 } } } })
+        end)
+        expect.fail(function()
+            BinCoverPoint("b", cg, { width = 4, bins = { { name = "x", value = 1, range = { 1, 2 } } } })
+        end)
+        expect.fail(function()
+            BinCoverPoint("c", cg, { width = 4, bins = { { name = "x", wildcard = "1?2" } } })
+        end)
+    end)
+end)
+
+describe("BinCross", function()
+    it("should count the cells of sampled combinations", function()
+        local cg, opcode, size = new_alu_group("cross")
+        local cross = BinCross("opcode_x_size", cg, { opcode, "size" })
+        expect.equal(cross:num_cells(), 9)
+
+        cg:sample(0, 0)
+        cg:sample(3, 1)
+        cg:sample(5, 1)
+        cg:sample(0x40, 2) -- ignored opcode, no cell
+        cg:sample(20, 3)   -- size 3 has no bin, no cell
+
+        expect.equal(cross:hits({ "nop", "b" }), 1)
+        expect.equal(cross:hits({ "alu", "h" }), 2)
+        expect.equal(cross:hits({ "mem", "w" }), 0)
+        expect.equal(cross:covered_cells(), 2)
+        expect.equal(size:hits("w"), 1)
+        expect.truthy(math.abs(cross:coverage() - 200 / 9) < 1e-9)
+        expect.truthy(math.abs(cg:coverage() - (opcode:coverage() + size:coverage() + cross:coverage()) / 3) < 1e-9)
+    end)
+
+    it("should only see points sampled since the last commit", function()
+        local cg, opcode, size = new_alu_group("commit")
+        local cross = BinCross("x", cg, { "opcode", "size" })
+        opcode:sample(1)
+        cg:commit()
+        size:sample(0)
+        cg:commit()
+        expect.equal(cross:covered_cells(), 0)
+        opcode:sample(1)
+        size:sample(0)
+        cg:commit()
+        expect.equal(cross:hits({ "alu", "b" }), 1)
+    end)
+
+    it("should count large sparse crosses", function()
+        local cg = CoverGroup("sparse")
+        local a = BinCoverPoint("a", cg, { width = 16, auto_bins = 4096 })
+        local b = BinCoverPoint("b", cg, { width = 16, auto_bins = 4096 })
+        local cross = BinCross("ab", cg, { a, b })
+        expect.equal(cross:num_cells(), 4096 * 4096)
+        for i = 0, 999 do
+            cg:sample(i * 16, (i * 7) % 65536)
+            cg:sample(i * 16, (i * 7) % 65536)
+        end
+        expect.equal(cross:covered_cells(), 1000)
+        expect.equal(cross:hits({ a.bin_names[11], b.bin_names[5] }), 2) -- 160, 70
+    end)
+end)
+
+describe("CoverGroup save", function()
+    it("should write JSON and a database that round trips and merges", function()
+        local cg, _, _ = new_alu_group("save")
+        BinCross("opcode_x_size", cg, { "opcode", "size" })
+        cg:sample(0, 0)
+        cg:sample(3, 1)
+        cg:sample(0xf0, 1)
+
+        local json_path = tmp_path(".coverage.json")
+        cg:save(json_path)
+        local db_path = json_path:gsub("%.json$", "") .. ".covdb"
+
+        local json = read_file(json_path)
+        expect.truthy(json:find('"simulator": "none"', 1, true))
+        expect.truthy(json:find('"name": "save"', 1, true))
+        expect.truthy(json:find('{ "name": "reserved", "kind": "illegal", "range": [240, 255], "hits": 1 }', 1, true))
+        expect.truthy(json:find('["alu", "h", 1]', 1, true))
+
+        local lib = native.lib
+        local db = native.load_db(db_path)
+        expect.equal(ffi.string(lib.cov_db_name(db)), "save")
+        expect.equal(tonumber(lib.cov_db_samples(db)), 3)
+        expect.equal(tostring(lib.cov_db_shape_hash(db)), tostring(lib.cov_db_shape_hash(cg.db)))
+        expect.equal(tonumber(lib.cov_bin_hits(db, 0, 4)), 1)
+
+        expect.equal(lib.cov_db_merge(db, cg.db), 0)
+        expect.equal(tonumber(lib.cov_db_samples(db)), 6)
+        expect.equal(tonumber(lib.cov_bin_hits(db, 0, 1)), 2)
+        local bins = ffi.new("uint32_t[2]", 1, 1)
+        expect.equal(tonumber(lib.cov_cross_hits(db, 0, bins)), 2)
+
+        local other = CoverGroup("save")
+        BinCoverPoint("opcode", other, { width = 8 })
+        expect.equal(lib.cov_db_merge(db, other.db), -1)
+        expect.truthy(native.last_error():find("different bins", 1, true))
+
+        os.remove(json_path)
+        os.remove(db_path)
+    end)
+end)
+
+describe("cov_merge", function()
+    it("should match cov_db_merge for many inputs on several threads", function()
+        -- Built by `xmake build cov_merge`
+        local tool = (os.getenv("VERILUA_HOME") or ".") .. "/tools/cov_merge"
+        if not io.open(tool, "r") then
+            print("[test_cov_bins] " .. tool .. " is not available, skipped")
+            return
+        end
+
+        -- Every input samples a different slice of the values, so the merged counters depend on every file
+        local json_paths, db_paths = {}, {}
+        for i = 1, 7 do
+            local cg, _, _ = new_alu_group("merged")
+            BinCross("opcode_x_size", cg, { "opcode", "size" })
+            for v = 0, i * 5 do
+                cg:sample((v * 7 + i) % 256, v % 4)
+            end
+            json_paths[i] = tmp_path(".coverage.json")
+            cg:save(json_paths[i])
+            db_paths[i] = json_paths[i]:gsub("%.json$", "") .. ".covdb"
+        end
+
+        local out_path = tmp_path(".covdb")
+        assert(os.execute(string.format("%s -o %s -j 3 %s > /dev/null", tool, out_path, table.concat(db_paths, " "))) == 0)
+
+        local lib = native.lib
+        local expected = native.load_db(db_paths[1])
+        for i = 2, #db_paths do
+            expect.equal(lib.cov_db_merge(expected, native.load_db(db_paths[i])), 0)
+        end
+        local merged = native.load_db(out_path)
+
+        expect.equal(ffi.string(lib.cov_db_name(merged)), "merged")
+        expect.equal(tostring(lib.cov_db_shape_hash(merged)), tostring(lib.cov_db_shape_hash(expected)))
+        expect.equal(tonumber(lib.cov_db_samples(merged)), tonumber(lib.cov_db_samples(expected)))
+        for point = 0, lib.cov_db_num_points(expected) - 1 do
+            for b = 0, lib.cov_point_num_bins(expected, point) - 1 do
+                expect.equal(tonumber(lib.cov_bin_hits(merged, point, b)), tonumber(lib.cov_bin_hits(expected, point, b)))
+            end
+        end
+        local bins = ffi.new("uint32_t[2]")
+        for op = 0, lib.cov_point_num_bins(expected, 0) - 1 do
+            for size = 0, lib.cov_point_num_bins(expected, 1) - 1 do
+                bins[0], bins[1] = op, size
+                expect.equal(tonumber(lib.cov_cross_hits(merged, 0, bins)), tonumber(lib.cov_cross_hits(expected, 0, bins)))
+            end
+        end
+        expect.equal(tonumber(lib.cov_cross_covered_cells(merged, 0)), tonumber(lib.cov_cross_covered_cells(expected, 0)))
+
+        for i = 1, #db_paths do
+            os.remove(json_paths[i])
+            os.remove(db_paths[i])
+        end
+        os.remove(out_path)
+    end)
+
+    it("should write the merged groups in name order", function()
+        local tool = (os.getenv("VERILUA_HOME") or ".") .. "/tools/cov_merge"
+        if not io.open(tool, "r") then
+            print("[test_cov_bins] " .. tool .. " is not available, skipped")
+            return
+        end
+
+        -- Every thread sees the groups in a different order
+        local names = { "g_c", "g_a", "g_b" }
+        local json_paths, db_paths = {}, {}
+        for i = 1, 6 do
+            local name = names[(i - 1) % #names + 1]
+            local cg, _, _ = new_alu_group(name)
+            cg:sample(i, i % 4)
+            json_paths[i] = tmp_path(".coverage.json")
+            cg:save(json_paths[i])
+            db_paths[i] = json_paths[i]:gsub("%.json$", "") .. ".covdb"
+        end
+
+        local out_path = tmp_path(".covdb")
+        local pipe = assert(io.popen(string.format("%s -o %s -j 3 %s", tool, out_path, table.concat(db_paths, " "))))
+        local merged_names = {}
+        for line in pipe:lines() do
+            merged_names[#merged_names + 1] = line:match("^%s+(g_%a)%s")
+        end
+        pipe:close()
+        expect.equal(merged_names, { "g_a", "g_b", "g_c" })
+
+        for i = 1, #db_paths do
+            os.remove(json_paths[i])
+            os.remove(db_paths[i])
+        end
+        os.remove(out_path)
+    end)
+end)
@@ -0,0 +1,250 @@
+module top(
+    input wire clock,
+    input wire reset,
+    output reg [7:0] value,
+    output reg [63:0] value64
+);
+`ifndef NO_COVERAGE
+bit _COV_EN = 1;
+int _0__COV_BIN_EXPR_CNT = 0; // guard: (reset)
+int _1__COV_BIN_EXPR_CNT = 0; // guard: (!(reset)) && (counter[0] & counter[1])
+int _2__COV_BIN_EXPR_CNT = 0; // guard: (!(reset)) && (!(counter[0] & counter[1])) && (counter[2] | counter[3])
+int _3__COV_BIN_EXPR_CNT = 0; // guard: (!(reset)) && (enable) && (state == 4'd5)
+int _4__COV_BIN_EXPR_CNT = 0; // guard: (!(reset)) && (enable) && (!(state == 4'd5))
+int _5__COV_BIN_EXPR_CNT = 0; // guard: (!(reset)) && (enable)
+int _6__COV_BIN_EXPR_CNT = 0; // guard: (!(reset))
+`endif // NO_COVERAGE
+
+
+reg [7:0] counter;
+reg [7:0] accumulator;
+wire valid;
+wire [7:0] result;
+
+// Test literal equal net (should be excluded)
+wire literal_net = 1'b1;
+
+// Test identifier equal net (should be excluded)
+wire ident_net = valid;
+
+// Test continuous assignment (not literal equal)
+wire assign_net;
+assign assign_net = counter[0] & counter[1];
+
+// Test variable
+reg [3:0] state;
+reg enable;
+
+// Test conditional statement with binary expression
+always @(posedge clock) begin
+if (reset) begin
+`ifndef NO_COVERAGE
+if(_COV_EN) _0__COV_BIN_EXPR_CNT++;
+`endif
+ 
+        counter <= 0;
+
+        accumulator <= 0;
+
+        state <= 0;
+
+        enable <= 0;
+  end
+else begin
+`ifndef NO_COVERAGE
+if(_COV_EN) _6__COV_BIN_EXPR_CNT++;
+`endif
+ 
+        counter <= counter + 1;
+if (counter[0] & counter[1]) begin
+`ifndef NO_COVERAGE
+if(_COV_EN) _1__COV_BIN_EXPR_CNT++;
+`endif
+ 
+            accumulator <= accumulator + 1;  end
+else if (counter[2] | counter[3]) begin
+`ifndef NO_COVERAGE
+if(_COV_EN) _2__COV_BIN_EXPR_CNT++;
+`endif
+ 
+            accumulator <= accumulator - 1;  end
+
+if (enable) begin
+`ifndef NO_COVERAGE
+if(_COV_EN) _5__COV_BIN_EXPR_CNT++;
+`endif
+ if (state == 4'd5) begin
+`ifndef NO_COVERAGE
+if(_COV_EN) _3__COV_BIN_EXPR_CNT++;
+`endif
+ 
+                state <= 0;  end
+else begin
+`ifndef NO_COVERAGE
+if(_COV_EN) _4__COV_BIN_EXPR_CNT++;
+`endif
+ 
+                state <= state + 1;  end
+  end
+
+
+        
+        enable <= ~enable;
+  end
+end
+
+// Output assignment
+assign valid = (counter > 8'd10);
+assign result = accumulator + counter;
+
+always @(posedge clock) begin
+    value <= result;
+    value64 <= {56'b0, counter};
+end
+
+`ifndef NO_COVERAGE
+
+// packed toggle coverage: 9 signals, 103 bits
+wire [102:0] _COV_TOGGLE_CUR = {value64, value, valid, state, result, enable, counter, assign_net, accumulator};
+bit [102:0] _COV_TOGGLE_LAST;
+wire [102:0] _COV_TOGGLE_DIFF = _COV_TOGGLE_CUR ^ _COV_TOGGLE_LAST;
+wire [8:0] _COV_TOGGLE_HIT = {|_COV_TOGGLE_DIFF[102:39], |_COV_TOGGLE_DIFF[38:31], _COV_TOGGLE_DIFF[30], |_COV_TOGGLE_DIFF[29:26], |_COV_TOGGLE_DIFF[25:18], _COV_TOGGLE_DIFF[17], |_COV_TOGGLE_DIFF[16:9], _COV_TOGGLE_DIFF[8], |_COV_TOGGLE_DIFF[7:0]};
+bit [31:0] _COV_TOGGLE_MAP;
+bit [31:0] _COV_TOGGLE_WORDS [1];
+bit [7:0] _COV_TOGGLE_CNT [9];
+bit [31:0] _COV_TOGGLE_CNT_WORDS [9];
+
+always @(posedge clock) begin
+if(_COV_EN) begin
+_COV_TOGGLE_MAP[8:0] <= _COV_TOGGLE_MAP[8:0] | _COV_TOGGLE_HIT;
+_COV_TOGGLE_LAST <= _COV_TOGGLE_CUR;
+for (int i = 0; i < 9; i++) if (_COV_TOGGLE_HIT[i] && _COV_TOGGLE_CNT[i] != '1) _COV_TOGGLE_CNT[i] <= _COV_TOGGLE_CNT[i] + 1'b1;
+end
+end
+
+
+function void coverageCtrl(input bit enable);
+    _COV_EN = enable;
+endfunction
+
+export "DPI-C" function coverageCtrl;
+
+
+function void getCoverageCount(output int totalCount, output int totalBinExprCount);
+    totalCount = int'((_0__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_1__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_2__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_3__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_4__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_5__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_6__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + $countones(_COV_TOGGLE_MAP));
+    totalBinExprCount = int'((_0__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_1__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_2__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_3__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_4__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_5__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_6__COV_BIN_EXPR_CNT >= 1 ? 1 : 0));
+endfunction
+
+export "DPI-C" function getCoverageCount;
+
+
+
+// scopes:
+//   top
+function void getCoverage(output real value);
+    value = real'((_0__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_1__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_2__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_3__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_4__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_5__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_6__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + $countones(_COV_TOGGLE_MAP)) / 16.0;
+endfunction
+
+export "DPI-C" function getCoverage;
+
+
+
+// scopes:
+//   top
+function void getCondCoverage(output real value);
+    value = real'((_0__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_1__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_2__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_3__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_4__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_5__COV_BIN_EXPR_CNT >= 1 ? 1 : 0) + (_6__COV_BIN_EXPR_CNT >= 1 ? 1 : 0)) / 7.0;
+endfunction
+
+export "DPI-C" function getCondCoverage;
+
+
+
+import "DPI-C" function void vl_cov_toggle_copy(input chandle dst, input bit [31:0] words[]);
+
+// Copy the toggled-ever bitmap (9 bits, 1 words) into `dst`.
+function void getToggleBitmap(input chandle dst, output int nbits);
+    nbits = 9;
+for (int i = 0; i < 1; i++) _COV_TOGGLE_WORDS[i] = _COV_TOGGLE_MAP[i*32 +: 32];
+vl_cov_toggle_copy(dst, _COV_TOGGLE_WORDS);
+endfunction
+
+export "DPI-C" function getToggleBitmap;
+
+// Copy the saturating toggle counters (one 32-bit word per signal) into `dst`.
+function void getToggleCounters(input chandle dst, output int ncounters);
+    ncounters = 9;
+for (int i = 0; i < 9; i++) _COV_TOGGLE_CNT_WORDS[i] = 32'(_COV_TOGGLE_CNT[i]);
+vl_cov_toggle_copy(dst, _COV_TOGGLE_CNT_WORDS);
+endfunction
+
+export "DPI-C" function getToggleCounters;
+
+
+
+function void resetCoverage();
+_0__COV_BIN_EXPR_CNT = 0; _1__COV_BIN_EXPR_CNT = 0; _2__COV_BIN_EXPR_CNT = 0; _3__COV_BIN_EXPR_CNT = 0; _4__COV_BIN_EXPR_CNT = 0; _5__COV_BIN_EXPR_CNT = 0; _6__COV_BIN_EXPR_CNT = 0; _COV_TOGGLE_MAP = '0; foreach (_COV_TOGGLE_CNT[i]) _COV_TOGGLE_CNT[i] = '0;
+endfunction
+
+export "DPI-C" function resetCoverage;
+
+
+
+function void showCoverageCount();
+$display("// ----------------------------------------");
+$display("// Show Coverage Count[top]");
+$display("// ----------------------------------------");
+$display("// Column description:");
+$display("//   Module    - module name where the coverage point resides");
+$display("//   Line      - source line number of the coverage point");
+$display("//   Count     - number of times the point was hit during simulation");
+$display("//   SignalType - Net (wire toggle), Var (reg toggle), or CondPath {branch entry}");
+$display("//   Status    - COVERED {count > 0} or MISSED {count == 0}");
+$display("//   Source    - source file path and line");
+$display("//   Guard     - {CondPath only} the path condition required to enter this branch");
+$display("// ----------------------------------------");
+$display("| Module | Line | Count | SignalType | Status | Source | Guard |");
+$display("[top]      3: %6d\t`Var`\t%s	.cov_exporter_packed_toggle/top.sv:3", _COV_TOGGLE_CNT[7], _COV_TOGGLE_MAP[7] ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]      4: %6d\t`Var`\t%s	.cov_exporter_packed_toggle/top.sv:4", _COV_TOGGLE_CNT[8], _COV_TOGGLE_MAP[8] ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]      7: %6d\t`Var`\t%s	.cov_exporter_packed_toggle/top.sv:7", _COV_TOGGLE_CNT[2], _COV_TOGGLE_MAP[2] ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]      8: %6d\t`Var`\t%s	.cov_exporter_packed_toggle/top.sv:8", _COV_TOGGLE_CNT[0], _COV_TOGGLE_MAP[0] ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]      9: %6d\t`Net`\t%s	.cov_exporter_packed_toggle/top.sv:9", _COV_TOGGLE_CNT[6], _COV_TOGGLE_MAP[6] ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     10: %6d\t`Net`\t%s	.cov_exporter_packed_toggle/top.sv:10", _COV_TOGGLE_CNT[4], _COV_TOGGLE_MAP[4] ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     19: %6d\t`Net`\t%s	.cov_exporter_packed_toggle/top.sv:19", _COV_TOGGLE_CNT[1], _COV_TOGGLE_MAP[1] ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     23: %6d\t`Var`\t%s	.cov_exporter_packed_toggle/top.sv:23", _COV_TOGGLE_CNT[5], _COV_TOGGLE_MAP[5] ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     24: %6d\t`Var`\t%s	.cov_exporter_packed_toggle/top.sv:24", _COV_TOGGLE_CNT[3], _COV_TOGGLE_MAP[3] ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     28: %6d\t`CondPath`\t%s	.cov_exporter_packed_toggle/top.sv:28\t(reset)", _0__COV_BIN_EXPR_CNT, _0__COV_BIN_EXPR_CNT > 0 ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     33: %6d\t`CondPath`\t%s	.cov_exporter_packed_toggle/top.sv:33\t(!(reset))", _6__COV_BIN_EXPR_CNT, _6__COV_BIN_EXPR_CNT > 0 ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     36: %6d\t`CondPath`\t%s	.cov_exporter_packed_toggle/top.sv:36\t(!(reset)) && (counter[0] & counter[1])", _1__COV_BIN_EXPR_CNT, _1__COV_BIN_EXPR_CNT > 0 ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     38: %6d\t`CondPath`\t%s	.cov_exporter_packed_toggle/top.sv:38\t(!(reset)) && (!(counter[0] & counter[1])) && (counter[2] | counter[3])", _2__COV_BIN_EXPR_CNT, _2__COV_BIN_EXPR_CNT > 0 ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     42: %6d\t`CondPath`\t%s	.cov_exporter_packed_toggle/top.sv:42\t(!(reset)) && (enable)", _5__COV_BIN_EXPR_CNT, _5__COV_BIN_EXPR_CNT > 0 ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     43: %6d\t`CondPath`\t%s	.cov_exporter_packed_toggle/top.sv:43\t(!(reset)) && (enable) && (state == 4'd5)", _3__COV_BIN_EXPR_CNT, _3__COV_BIN_EXPR_CNT > 0 ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("[top]     45: %6d\t`CondPath`\t%s	.cov_exporter_packed_toggle/top.sv:45\t(!(reset)) && (enable) && (!(state == 4'd5))", _4__COV_BIN_EXPR_CNT, _4__COV_BIN_EXPR_CNT > 0 ? "\x1b[32mCOVERED\x1b[0m" : "\x1b[31mMISSED\x1b[0m");
+$display("| Module | Line | Count | SignalType | Status | Source | Guard |");
+$display("");
+endfunction
+
+export "DPI-C" function showCoverageCount;
+
+
+
+// ==========================================================
+//  cov_exporter Statistic
+// ----------------------------------------------------------
+//   net coverage points    : 3
+//   var coverage points    : 6
+//   cond-path points       : 7
+//   duplicate nets removed : 0
+//   unsupported cond stmts : 0
+// ----------------------------------------------------------
+//   literalEqualNet (excluded):
+//       literal_net
+//   identifierEqualNet (excluded):
+//       ident_net
+//   unsupportedCondStmts:
+//       (none)
+// ==========================================================
+
+`endif // NO_COVERAGE
+
+endmodule
+
@@ -216,7 +216,146 @@ target("test", function()
         end
 
         -- ----------------------------------------------------------------------
-        -- Test 6: lint check — verilator --lint-only on every generated output,
+        -- Test 6: packed toggle layout (bitmap + saturating counters)
+        -- ----------------------------------------------------------------------
+        test_count = test_count + 1
+        test_name = "packed_toggle"
+        output_dir = path.join(test_dir, ".cov_exporter_" .. test_name)
+
+        print(string.format("\n[%s] Running cov_exporter...", test_name))
+        cmd = format("cov_exporter %s -m top --packed-toggle --pcw 8 --od %s --wd %s -q --relative-file-path", rtl,
+            output_dir, output_dir)
+        ok = try { function()
+            os.exec(cmd); return true
+        end }
+        if not ok then
+            print(string.format("[%s] FAILED: cov_exporter execution failed", test_name))
+            all_passed = false
+        else
+            local top_sv_output = path.join(output_dir, "top.sv")
+            local top_sv_golden = path.join(golden_dir, test_name .. "_top.sv")
+
+            local passed = compare_file(top_sv_output, top_sv_golden, test_name .. "_top_sv")
+
+            -- The bitmap layout must be recorded in the meta file
+            local meta = io.readfile(path.join(output_dir, "cov_exporter.meta.json")) or ""
+            if not meta:find("\"packedToggle\"", 1, true) then
+                print(string.format("[%s] FAILED: `packedToggle` not found in meta file", test_name))
+                passed = false
+            end
+
+            if passed then
+                pass_count = pass_count + 1
+            else
+                all_passed = false
+            end
+        end
+
+        -- ----------------------------------------------------------------------
+        -- Test 7: output cache — an unchanged rerun is skipped, and a forced
+        -- rerun (`--no-cache`) does not touch output files whose content is
+        -- the same, so their mtime is preserved, and leaves a cache that the
+        -- next plain rerun reuses.
+        -- ----------------------------------------------------------------------
+        test_count = test_count + 1
+        test_name = "cache"
+        output_dir = path.join(test_dir, ".cov_exporter_" .. test_name)
+        os.tryrm(output_dir)
+
+        print(string.format("\n[%s] Running cov_exporter...", test_name))
+        cmd = format("cov_exporter %s -m top --od %s --wd %s -q --relative-file-path", rtl, output_dir, output_dir)
+        local cache_out = nil
+        local nocache_out = nil
+        local recache_out = nil
+        local mtime0, mtime1, mtime2
+        ok = try { function()
+            os.exec(cmd)
+            mtime0 = os.mtime(path.join(output_dir, "top.sv"))
+            os.sleep(1100)
+            cache_out = os.iorun(cmd)
+            mtime1 = os.mtime(path.join(output_dir, "top.sv"))
+            nocache_out = os.iorun(cmd .. " --no-cache")
+            mtime2 = os.mtime(path.join(output_dir, "top.sv"))
+            recache_out = os.iorun(cmd)
+            return true
+        end }
+        if not ok then
+            print(string.format("[%s] FAILED: cov_exporter execution failed", test_name))
+            all_passed = false
+        else
+            local passed = true
+            if not cache_out:find("No need to regenerate", 1, true) then
+                print(string.format("[%s] FAILED: unchanged rerun was not skipped", test_name))
+                passed = false
+            end
+            if not nocache_out:find("0 rewritten", 1, true) then
+                print(string.format("[%s] FAILED: `--no-cache` rerun rewrote unchanged output files", test_name))
+                passed = false
+            end
+            if not recache_out:find("No need to regenerate", 1, true) then
+                print(string.format("[%s] FAILED: rerun after `--no-cache` did not reuse the cache", test_name))
+                passed = false
+            end
+            if mtime0 ~= mtime1 or mtime0 ~= mtime2 then
+                print(string.format("[%s] FAILED: top.sv mtime changed (%s, %s, %s)", test_name, mtime0, mtime1, mtime2))
+                passed = false
+            end
+
+            if passed then
+                print(string.format("[%s] PASSED", test_name))
+                pass_count = pass_count + 1
+            else
+                all_passed = false
+            end
+        end
+
+        -- ----------------------------------------------------------------------
+        -- Test 8: determinism — collection, rendering and file output run on
+        -- a thread pool, the output must not depend on `--num-jobs`.
+        -- ----------------------------------------------------------------------
+        test_count = test_count + 1
+        test_name = "num_jobs"
+        local jobs_rtls = {
+            rtl,
+            path.join(test_dir, "cond_path_top.sv"),
+            path.join(test_dir, "cond_path_unsupported_top.sv"),
+            path.join(test_dir, "cov_bench_top.sv"),
+        }
+        local jobs_outputs = { "top.sv", "cond_path_top.sv", "cond_path_unsupported_top.sv", "cov_bench_top.sv" }
+        local jobs_dirs = {}
+        print(string.format("\n[%s] Running cov_exporter with --num-jobs 1 and 8...", test_name))
+        ok = try { function()
+            for _, nj in ipairs({ 1, 8 }) do
+                local dir = path.join(test_dir, format(".cov_exporter_%s_%d", test_name, nj))
+                os.tryrm(dir)
+                os.exec(format(
+                    "cov_exporter %s -m top -m cond_path_top -m cond_path_unsupported_top -m cov_bench_top --od %s --wd %s -q --relative-file-path --nj %d",
+                    table.concat(jobs_rtls, " "), dir, dir, nj))
+                table.insert(jobs_dirs, dir)
+            end
+            return true
+        end }
+        if not ok then
+            print(string.format("[%s] FAILED: cov_exporter execution failed", test_name))
+            all_passed = false
+        else
+            local passed = true
+            for _, file in ipairs(jobs_outputs) do
+                -- The serial output is the reference
+                if not compare_file(path.join(jobs_dirs[2], file), path.join(jobs_dirs[1], file), test_name .. "_" .. file) then
+                    passed = false
+                end
+            end
+
+            if passed then
+                pass_count = pass_count + 1
+            else
+                all_passed = false
+            end
+        end
+
+        -- ----------------------------------------------------------------------
+        -- Test 9: lint check — verilator --lint-only on every generated output,
         -- both with and without +define+NO_COVERAGE. A golden text-compare only
         -- proves the output is stable, not that it compiles; this catches
         -- malformed instrumentation (unbalanced `ifndef/`endif, missing decls,
@@ -241,6 +380,7 @@ target("test", function()
                 { ".cov_exporter_no_sep_always",  "top.sv" },
                 { ".cov_exporter_cond_path",      "cond_path_top.sv" },
                 { ".cov_exporter_unsupported",    "cond_path_unsupported_top.sv" },
+                { ".cov_exporter_packed_toggle",  "top.sv" },
             }
 
             print("\n[lint] Running verilator --lint-only on every generated output...")
@@ -277,7 +417,7 @@ target("test", function()
         end -- has_verilator
 
         -- ----------------------------------------------------------------------
-        -- Test 7: cov_exporter runtime overhead — instrumented vs baseline
+        -- Test 10: cov_exporter runtime overhead — instrumented vs baseline
         -- ----------------------------------------------------------------------
         -- iverilog does not support VPI the way these targets need, so it is
         -- excluded. Other simulators (verilator / vcs / xcelium) are timed.
@@ -417,6 +557,15 @@ target("regen_golden", function()
         os.exec(cmd)
         os.cp(path.join(output_dir, "cond_path_unsupported_top.sv"), path.join(golden_dir, test_name .. "_top.sv"))
 
+        -- Test 6: packed toggle layout
+        test_name = "packed_toggle"
+        output_dir = path.join(test_dir, ".cov_exporter_" .. test_name)
+        print(string.format("[%s] Generating golden file...", test_name))
+        cmd = format("cov_exporter %s -m top --packed-toggle --pcw 8 --od %s --wd %s -q --relative-file-path", rtl,
+            output_dir, output_dir)
+        os.exec(cmd)
+        os.cp(path.join(output_dir, "top.sv"), path.join(golden_dir, test_name .. "_top.sv"))
+
         print("\nGolden files regenerated successfully!")
         print("Golden files location: " .. golden_dir)
     end)
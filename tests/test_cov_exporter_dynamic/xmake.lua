@@ -33,3 +33,41 @@ target("test", function()
         }
     end)
 end)
+
+-- Same DUT with `--packed-toggle`: the toggle state is read back at runtime
+-- through getToggleBitmap / getToggleCounters (vl_cov_toggle_copy).
+target("test_packed_toggle", function()
+    add_rules("verilua")
+    set_default(false)
+
+    on_config(function(target)
+        local sim = os.getenv("SIM") or "verilator"
+        if sim == "verilator" then
+            target:set("toolchains", "@verilator")
+        elseif sim == "vcs" then
+            target:set("toolchains", "@vcs")
+        elseif sim == "xcelium" then
+            target:set("toolchains", "@xcelium")
+        else
+            raise("unknown simulator: %s", sim)
+        end
+    end)
+
+    add_files("cond_path_top.sv")
+    set_values("verilua.top", "cond_path_top")
+    set_values("verilua.build_dir_name", "cond_path_top_packed_toggle")
+    set_values("verilua.lua_main", "main_packed_toggle.lua")
+    set_values("verilator.flags", "--Wno-MULTIDRIVEN")
+
+    set_values("verilua.instrument", function()
+        return {
+            {
+                type = "cov_exporter",
+                extra_args = { "--packed-toggle", "--pcw", "4" },
+                config = {
+                    { module = "cond_path_top" }
+                },
+            },
+        }
+    end)
+end)
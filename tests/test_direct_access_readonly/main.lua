@@ -0,0 +1,32 @@
+fork {
+    function()
+        local clock = dut.clock:chdl()
+        local ro_reg = dut.u_top.ro_reg:chdl()
+        local ro_wide = dut.u_top.ro_wide:chdl()
+        local rw_reg = dut.u_top.rw_reg:chdl()
+
+        clock:posedge()
+
+        -- Reads of read-only signals still work
+        ro_reg:expect_hex_str("5a")
+        ro_wide:expect_hex_str("123456789abcdef013579bdf")
+
+        -- Writes are rejected by VerilatedVpi instead of being stored directly
+        ro_reg:set(0x11)
+        ro_wide:set_hex_str("ffffffffffffffffffffffff")
+        rw_reg:set(0x22)
+        clock:posedge()
+        clock:posedge()
+        ro_reg:expect_hex_str("5a")
+        ro_wide:expect_hex_str("123456789abcdef013579bdf")
+        rw_reg:expect_hex_str("22")
+
+        ro_reg:set_imm(0x33)
+        rw_reg:set_imm(0x44)
+        ro_reg:expect_hex_str("5a")
+        rw_reg:expect_hex_str("44")
+
+        print("Finish")
+        sim.finish()
+    end,
+}
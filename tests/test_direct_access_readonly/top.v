@@ -0,0 +1,9 @@
+module top (
+    input wire clock,
+    input wire reset
+);
+    // Only initialized, never driven again: a write that reaches the storage sticks
+    reg [7:0] ro_reg = 8'h5a;
+    reg [7:0] rw_reg = 8'h00;
+    reg [95:0] ro_wide = 96'h1234_5678_9abc_def0_1357_9bdf;
+endmodule
@@ -0,0 +1,20 @@
+---@diagnostic disable: undefined-field, undefined-global
+
+-- Verilator only: `ro_*` are `public_flat_rd`, so the direct access resolver
+-- hands them out read-only and writes must keep going through VPI (which
+-- rejects them) instead of landing in the Verilated storage.
+target("test", function()
+    add_rules("verilua")
+    add_toolchains("@verilator")
+
+    add_files("top.v")
+    set_values("verilua.top", "top")
+    set_values("verilua.lua_main", "main.lua")
+    set_values("verilua.verilator_no_public_flat_rw", "1")
+    set_values("verilua.verilator_config", [[
+public_flat_rw -module "tb_top" -var "*"
+public_flat_rw -module "top" -var "rw_reg"
+public_flat_rd -module "top" -var "ro_reg"
+public_flat_rd -module "top" -var "ro_wide"
+]])
+end)
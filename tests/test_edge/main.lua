@@ -24,6 +24,78 @@ fork {
         end
     end,
 
+    function()
+        -- NativeCond: predicate evaluated natively on every posedge, woken once
+        local NativeCond = require "verilua.utils.NativeCond"
+
+        local target = cycles:get() + 3
+        local reached = NativeCond(NativeCond.eq(cycles, target))
+        local ok, n = reached:posedge(clock, 8)
+        assert(ok and n >= 1 and n <= 4, ("ok: %s, n: %d"):format(tostring(ok), n))
+        cycles:expect(target)
+        assert(reached:eval())
+
+        local never = NativeCond(NativeCond.all { NativeCond.eq(cycles, 0), NativeCond.ne(cycles, 0) })
+        local ok2, n2 = never:posedge(clock, 3)
+        assert(not ok2 and n2 == 3, ("ok2: %s, n2: %d"):format(tostring(ok2), n2))
+
+        local any = NativeCond(NativeCond.any { NativeCond.eq(cycles, 0), NativeCond.inv(NativeCond.eq(cycles, 0)) })
+        local ok3, n3 = any:posedge(clock, 2)
+        assert(ok3 and n3 == 1)
+    end,
+
+    function()
+        -- A task removed while parked in a NativeCond wait leaves the clock's waiter list at once:
+        -- it is not resumed (nor its freed predicate evaluated) when the condition holds later
+        local NativeCond = require "verilua.utils.NativeCond"
+        local scheduler = require "verilua.scheduler.LuaScheduler"
+
+        local target = cycles:get() + 3
+        local cond = NativeCond(NativeCond.eq(cycles, target))
+        local resumed = false
+        local _, waiter_id = jfork {
+            function()
+                cond:posedge(clock)
+                resumed = true
+            end
+        }
+
+        clock:posedge()
+        scheduler:remove_task(waiter_id)
+        if cfg.mode == "normal" then
+            -- Step schedulers evaluate NativeCond from Lua, that task is unlinked at its next edge
+            assert(not scheduler:check_task_exists(waiter_id), "removed NativeCond waiter should be unlinked")
+        end
+        cond:destroy()
+
+        clock:posedge(4)
+        assert(cycles:get() > target, "the condition should have held by now")
+        assert(not resumed, "removed NativeCond waiter was resumed")
+    end,
+
+    function()
+        -- Many waiters on the same edge (more than one `sim_event_chunk_N` batch): every waiter is
+        -- woken exactly once per posedge, also when it waits again right after being woken
+        local waiter_num = 40
+        local counts = {}
+        for i = 1, waiter_num do
+            counts[i] = 0
+            fork {
+                function()
+                    for _ = 1, 5 do
+                        clock:posedge()
+                        counts[i] = counts[i] + 1
+                    end
+                end
+            }
+        end
+
+        clock:posedge(6)
+        for i = 1, waiter_num do
+            assert(counts[i] == 5, ("waiter %d woken %d times, expected 5"):format(i, counts[i]))
+        end
+    end,
+
     function()
         clock:negedge()
         local valid = dut.valid:chdl()
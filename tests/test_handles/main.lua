@@ -387,6 +387,86 @@ fork {
         bdl3:set_all({ 0x11, 0x22, 0x33 })
         clock:posedge()
 
+        -- get_all/set_all move the whole bundle through one packed buffer
+        local bulk_bdl = ("data_8 | data_48 | data_96"):bdl {
+            hier = "tb_top.u_top",
+            prefix = "bulk_",
+            is_decoupled = false
+        }
+        bulk_bdl:set_all({ 0x5A, 0x123456789ABCULL, { 0x11111111, 0x22222222, 0x33333333 } })
+        clock:posedge()
+
+        local bulk_values = bulk_bdl:get_all()
+        assert(#bulk_values == 3)
+        assert(bulk_values[1] == 0x5A, "Got: " .. tostring(bulk_values[1]))
+        assert(bulk_values[2] == 0x123456789ABCULL, "Got: " .. tostring(bulk_values[2]))
+        assert(bulk_values[3][0] == 3)
+        assert(bulk_values[3][1] == 0x11111111 and bulk_values[3][2] == 0x22222222 and bulk_values[3][3] == 0x33333333)
+        assert(bulk_bdl.data_48:get() == 0x123456789ABCULL)
+        assert(bulk_bdl.data_96:get_hex_str() == "333333332222222211111111")
+
+        -- Plain numbers up to 2^53 are split into 32-bit words
+        bulk_bdl:set_all({ 0x1, 0x10000000F, 0x200000001 })
+        clock:posedge()
+        assert(bulk_bdl.data_48:get() == 0x10000000FULL)
+        assert(bulk_bdl.data_96:get_hex_str() == "000000000000000200000001")
+
+        -- Packed access, every slot is laid out like MultiBeatData
+        local group = bulk_bdl:handle_group()
+        local buf = bulk_bdl:get_all_packed()
+        assert(buf[group.offsets[1]] == 1 and buf[group.offsets[1] + 1] == 0x1)
+        assert(buf[group.offsets[2]] == 2 and buf[group.offsets[2] + 2] == 0x1)
+        buf[group.offsets[1] + 1] = 0xA5
+        bulk_bdl:set_all_packed(buf)
+        clock:posedge()
+        assert(bulk_bdl.data_8:get() == 0xA5)
+
+        -- Packed mode: get_all fills a struct, set_all takes one and fire() is evaluated natively
+        local packed_bdl = ("data_8 | data_48 | data_96"):bdl {
+            hier = "tb_top.u_top",
+            prefix = "bulk_",
+            is_decoupled = false,
+            packed = true
+        }
+        local pv = packed_bdl.packed_t()
+        pv.data_8 = 0x3C
+        pv.data_48 = 0xABCDEF012345ULL
+        pv.data_96[0], pv.data_96[1], pv.data_96[2] = 0x1, 0x2, 0x3
+        packed_bdl:set_all(pv)
+        clock:posedge()
+        assert(bulk_bdl.data_48:get() == 0xABCDEF012345ULL)
+        assert(bulk_bdl.data_96:get_hex_str() == "000000030000000200000001")
+
+        local pout = packed_bdl:get_all(packed_bdl.packed_t())
+        assert(pout.data_8 == 0x3C and pout.data_48 == 0xABCDEF012345ULL and pout.data_96[2] == 0x3)
+
+        packed_bdl:set_all({ 0x1, 0x2, 0x3 })
+        clock:posedge()
+        assert(packed_bdl:get_all().data_96[0] == 0x3 and packed_bdl:get_all().data_8 == 0x1)
+
+        -- A struct of another type is rejected instead of being read with the wrong layout
+        local foreign = require("ffi").new("uint8_t[4]")
+        assert(not pcall(packed_bdl.set_all, packed_bdl, foreign))
+        assert(not pcall(packed_bdl.get_all, packed_bdl, foreign))
+
+        local packed_hs = ("valid | ready | data | addr"):bdl {
+            hier = "tb_top.u_top",
+            prefix = "prefix_",
+            packed = true
+        }
+        packed_hs.valid:set(1)
+        packed_hs.ready:set(0)
+        clock:posedge()
+        assert(not packed_hs:fire())
+        packed_hs.ready:set(1)
+        clock:posedge()
+        assert(packed_hs:fire())
+        packed_hs.bits.addr:set(0x42)
+        clock:posedge()
+        assert(packed_hs:get_all().addr == 0x42)
+        packed_hs.valid:set(0)
+        packed_hs.ready:set(0)
+
         -- ========================================================================
         -- Test: Bundle - Optional signals (old and new syntax)
         -- ========================================================================
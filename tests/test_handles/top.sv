@@ -43,6 +43,11 @@ module top (
     logic [63:0] wide_signal_64;
     logic [7:0]  narrow_signal_8;
 
+    // Signals for Bundle bulk get_all/set_all testing
+    logic [7:0]  bulk_data_8;
+    logic [47:0] bulk_data_48;
+    logic [95:0] bulk_data_96;
+
     // Array signals for testing array operations
     logic [7:0]  array_signal [0:3];
 
@@ -95,6 +100,10 @@ module top (
         wide_signal_64 = 64'hCAFEBABEDEADBEEF;
         narrow_signal_8 = 8'h42;
 
+        bulk_data_8 = 8'h00;
+        bulk_data_48 = 48'h0;
+        bulk_data_96 = 96'h0;
+
         array_signal[0] = 8'h10;
         array_signal[1] = 8'h20;
         array_signal[2] = 8'h30;
@@ -0,0 +1,174 @@
+--- Tests of the liblog_sink backed Logger sink (`Logger.set_sink`).
+--- Run with: luajit tests/test_log_sink.lua (needs $VERILUA_HOME/shared/liblog_sink.so,
+--- built by `xmake build liblog_sink`; the binary output is checked with
+--- $VERILUA_HOME/tools/log_decode when it is built).
+
+local native = require "verilua.utils.LogSinkNative"
+local lester = require "lester"
+
+local describe, it, expect = lester.describe, lester.it, lester.expect
+
+if not native.lib then
+    print("[test_log_sink] liblog_sink is not available, skipped")
+    return
+end
+
+local Logger = require "verilua.utils.Logger"
+
+local tmp_dir = os.getenv("TMPDIR") or "/tmp"
+local tmp_id = 0
+
+---@return string
+local function tmp_path(suffix)
+    tmp_id = tmp_id + 1
+    return string.format("%s/test_log_sink_%d_%d%s", tmp_dir, os.time(), tmp_id, suffix)
+end
+
+---@return string
+local function read_file(path)
+    local file = assert(io.open(path, "r"))
+    local content = file:read("*a")
+    file:close()
+    return content
+end
+
+---@return string[]
+local function read_lines(path)
+    local lines = {}
+    for line in read_file(path):gmatch("[^\n]+") do
+        lines[#lines + 1] = line
+    end
+    return lines
+end
+
+--- `log_decode` output of `path`, nil if the tool is not built
+---@return string[]?
+local function decode(path)
+    local tool = (os.getenv("VERILUA_HOME") or ".") .. "/tools/log_decode"
+    if not io.open(tool, "r") then
+        return nil
+    end
+    local out = tmp_path(".txt")
+    assert(os.execute(string.format("%s -s -o %s %s", tool, out, path)) == 0)
+    local lines = read_lines(out)
+    os.remove(out)
+    return lines
+end
+
+describe("Logger native sink", function()
+    lester.after(function()
+        Logger.close_sink()
+    end)
+
+    it("writes text records with the level, logger name and joined arguments", function()
+        local path = tmp_path(".txt")
+        local log = Logger.new("SinkText")
+
+        Logger.set_sink({ path = path, text = true })
+        log:info("value", 1, 2.5, true, nil, 10LL, 20ULL)
+        log:warning("careful")
+        log:debug("dbg")
+        expect.truthy(Logger.close_sink())
+
+        local lines = read_lines(path)
+        expect.equal(#lines, 3)
+        expect.truthy(lines[1]:find(" INFO    [SinkText] value 1 2.5 true nil 10LL 20ULL", 1, true))
+        expect.truthy(lines[2]:find(" WARNING [SinkText] careful", 1, true))
+        expect.truthy(lines[3]:find(" DEBUG   [SinkText] dbg", 1, true))
+        os.remove(path)
+    end)
+
+    it("formats the *f methods like string.format", function()
+        local path = tmp_path(".txt")
+        local log = Logger.new("SinkFmt")
+
+        Logger.set_sink({ path = path, text = true })
+        log:infof("addr=0x%08x data=%d name=%s", 0xbeef, -42, "abc")
+        log:successf("%5.2f%% %q", 99.5, "q")
+        Logger.close_sink()
+
+        local lines = read_lines(path)
+        expect.equal(#lines, 2)
+        expect.truthy(lines[1]:find(" [SinkFmt] addr=0x0000beef data=-42 name=abc", 1, true))
+        expect.truthy(lines[2]:find(" SUCCESS [SinkFmt] " .. string.format("%5.2f%% %q", 99.5, "q"), 1, true))
+        os.remove(path)
+    end)
+
+    it("regenerates existing loggers and restores printing when closed", function()
+        local log = Logger.new("SinkSwitch")
+        local console_info = log.info
+        local path = tmp_path(".vllog")
+
+        Logger.set_sink({ path = path })
+        expect.not_equal(log.info, console_info)
+        Logger.close_sink()
+
+        -- The console function is generated again, the sink function is gone
+        expect.equal(native.lib.log_sink_is_open(), 0)
+        log:info("back on the console")
+        os.remove(path)
+    end)
+
+    it("streams binary records from many calls", function()
+        local path = tmp_path(".vllog")
+        local log = Logger.new("SinkBin")
+        local n = 20000
+
+        Logger.set_sink({ path = path, ring_kb = 64 })
+        for i = 1, n do
+            log:debugf("iter %d of %d", i, n)
+        end
+        Logger.flush_sink()
+        Logger.close_sink()
+
+        expect.equal(read_file(path):sub(1, 8), "VLLOG001")
+
+        local lines = decode(path)
+        if lines then
+            expect.equal(#lines, n)
+            expect.truthy(lines[1]:find("[SinkBin] iter 1 of " .. n, 1, true))
+            expect.truthy(lines[n]:find("[SinkBin] iter " .. n .. " of " .. n, 1, true))
+        end
+        os.remove(path)
+    end)
+
+    it("drops records instead of blocking once the output cannot be written", function()
+        if not io.open("/dev/full", "w") then
+            return
+        end
+        local log = Logger.new("SinkFull")
+
+        -- Much more than the ring and the stdio buffer: producers would wait
+        -- forever on a full ring if the writer stopped consuming it
+        Logger.set_sink({ path = "/dev/full", text = true, ring_kb = 64 })
+        for i = 1, 100000 do
+            log:info("lost", i)
+        end
+        expect.falsy(Logger.flush_sink())
+        expect.truthy(native.lib.log_sink_dropped() > 0)
+        expect.falsy(Logger.close_sink())
+    end)
+
+    it("keeps only the latest records in flight recorder mode", function()
+        local path = tmp_path(".txt")
+        local log = Logger.new("SinkFlight")
+
+        Logger.set_sink({ path = path, text = true, flight_mb = 0.01 })
+        for i = 1, 5000 do
+            log:info("flight", i)
+        end
+
+        -- Nothing is written before a dump
+        expect.equal(read_file(path), "")
+
+        local dumped = Logger.dump_sink()
+        expect.truthy(dumped > 0 and dumped < 5000)
+        Logger.close_sink()
+
+        local lines = read_lines(path)
+        expect.equal(#lines, dumped)
+        expect.truthy(lines[#lines]:find("[SinkFlight] flight 5000", 1, true))
+        expect.truthy(lines[1]:find("[SinkFlight] flight " .. (5000 - dumped + 1), 1, true))
+        os.remove(path)
+    end)
+end)
@@ -0,0 +1,94 @@
+-- LuaDataBaseV2 `async = true`: rows are inserted by the libverilua writer
+-- thread (needs `$VERILUA_HOME/shared/libverilua_nosim.so`).
+-- 1) Every saved row ends up in the database after clean_up(), including the
+--    partial last batch, with small batches and few batches in flight so the
+--    producer hits backpressure.
+-- 2) Numbers above 2^31 and TEXT values survive exactly.
+-- 3) INTEGER columns reject non-integral / out of range numbers instead of
+--    truncating them to int64, and the rejected row is not stored.
+-- 4) save() after clean_up() fails loudly instead of dropping rows.
+
+_G.verilua_debug = function() end
+_G.enable_verilua_debug = false
+_G.verilua_warning = function() end
+
+local final_cbs = {}
+_G.final = function(tasks)
+    for _, fn in ipairs(tasks) do
+        final_cbs[#final_cbs + 1] = fn
+    end
+end
+
+local os = require "os"
+---@diagnostic disable-next-line: unresolved-require
+local lfs = require "lfs"
+---@diagnostic disable-next-line: unresolved-require
+local path = require "pl.path"
+
+local workdir = os.tmpname()
+os.remove(workdir)
+assert(lfs.mkdir(workdir))
+
+local function sqlite_row(db_path, sql)
+    ---@diagnostic disable-next-line: unresolved-require
+    local sqlite3 = require "lsqlite3"
+    local db = sqlite3.open(db_path)
+    local ret
+    for a, b, c in db:urows(sql) do
+        ret = { a, b, c }
+    end
+    db:close()
+    return ret
+end
+
+local LuaDB = require "verilua.utils.LuaDataBaseV2"
+
+do
+    local db = LuaDB {
+        table_name = "t",
+        elements = { "id => INTEGER", "msg => TEXT", "addr => INTEGER" },
+        path = workdir,
+        file_name = "async.db",
+        save_cnt_max = 100,
+        async = true,
+        async_batch_num = 2,
+        async_text_bytes = 4096,
+        async_txn_rows = 1000,
+    }
+
+    local n = 50007
+    local big = 2 ^ 40
+    for i = 1, n do
+        db:save(i, "row-" .. i, big + i)
+    end
+    db:commit()
+
+    for _, bad in ipairs({ 1.5, -0.25, 0 / 0, math.huge, 2 ^ 63 }) do
+        local ok, err = pcall(function() db:save(n + 1, "bad", bad) end)
+        assert(not ok and tostring(err):find("INTEGER column `addr`", 1, true),
+            "save() must reject " .. tostring(bad) .. ": " .. tostring(err))
+    end
+    db:commit()
+    print("[ok] INTEGER columns reject non-integral numbers")
+
+    for _, fn in ipairs(final_cbs) do
+        fn()
+    end
+
+    ---@diagnostic disable-next-line: access-invisible
+    db.db:close() -- release EXCLUSIVE lock for readback
+    local db_path = path.join(workdir, "async.db")
+    local row = sqlite_row(db_path, "SELECT COUNT(*), SUM(id), MAX(addr) FROM t")
+    assert(row[1] == n, "expected " .. n .. " rows, got " .. tostring(row[1]))
+    assert(row[2] == n * (n + 1) / 2, "wrong SUM(id): " .. tostring(row[2]))
+    assert(row[3] == big + n, "expected " .. (big + n) .. ", got " .. tostring(row[3]))
+    row = sqlite_row(db_path, "SELECT msg FROM t WHERE id = 4242")
+    assert(row[1] == "row-4242", "wrong TEXT value: " .. tostring(row[1]))
+    print("[ok] async writer inserts every row exactly")
+
+    local ok, err = pcall(function() db:save(1, "late", 1) db:commit() end)
+    assert(not ok and tostring(err):find("writer is closed"), "save() after clean_up() must fail: " .. tostring(err))
+    print("[ok] save() after clean_up() fails loudly")
+end
+
+print("ALL PASS")
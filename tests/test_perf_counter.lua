@@ -0,0 +1,108 @@
+--- Tests of PerfCounter (FFI counter slots) and the jit.profile based Profiler.
+--- Run with: luajit tests/test_perf_counter.lua
+
+local PerfCounter = require "verilua.utils.PerfCounter"
+local Profiler = require "verilua.utils.Profiler"
+local lester = require "lester"
+
+local describe, it, expect = lester.describe, lester.it, lester.expect
+
+local tmp_dir = os.getenv("TMPDIR") or "/tmp"
+
+---@param n integer
+---@return number
+local function busy(n)
+    local s = 0
+    for i = 1, n do
+        s = s + math.sin(i)
+    end
+    return s
+end
+
+describe("PerfCounter", function()
+    it("has a monotonic nanosecond clock", function()
+        local a = PerfCounter.now_ns()
+        busy(10000)
+        local b = PerfCounter.now_ns()
+        expect.truthy(b > a)
+        expect.truthy(b - a < 1e9)
+    end)
+
+    it("counts calls, total, min, max and histogram buckets of a wrapped function", function()
+        local wrapped = PerfCounter:wrap_func("test_busy", busy)
+        for i = 1, 200 do
+            expect.equal(wrapped(i), busy(i))
+        end
+
+        local stats = PerfCounter:get_stats("test_busy") --[[@as verilua.utils.PerfCounter.stats]]
+        expect.equal(stats.calls, 200)
+        expect.truthy(stats.min > 0 and stats.min <= stats.avg and stats.avg <= stats.max)
+        expect.truthy(math.abs(stats.avg * stats.calls - stats.total) < 1e-9)
+
+        local nr_hist = 0
+        for _, count in ipairs(stats.hist) do
+            nr_hist = nr_hist + count
+        end
+        expect.equal(nr_hist, 200)
+
+        expect.fail(function() PerfCounter:wrap_func("test_busy", busy) end, "name already exists")
+    end)
+
+    it("records explicit durations into the matching log2 bucket", function()
+        local slot = PerfCounter:slot("test_manual")
+        expect.equal(PerfCounter:slot("test_manual"), slot)
+
+        PerfCounter:record(slot, 1000) -- [512, 1024) ns
+        PerfCounter:record(slot, 3000) -- [2048, 4096) ns
+        PerfCounter:record(slot, 1e12) -- clamped to the last bucket
+
+        local stats = PerfCounter:get_stats("test_manual") --[[@as verilua.utils.PerfCounter.stats]]
+        expect.equal(stats.calls, 3)
+        expect.equal(stats.hist[10], 1)
+        expect.equal(stats.hist[12], 1)
+        expect.equal(stats.hist[32], 1)
+        expect.equal(stats.min, 1000 * 1e-9)
+        expect.equal(stats.max, 1e12 * 1e-9)
+
+        PerfCounter:reset("test_manual")
+        expect.equal(PerfCounter:get_stats("test_manual").calls, 0)
+    end)
+
+    it("keeps counters when more slots are allocated", function()
+        local first = PerfCounter:slot("test_grow_0")
+        PerfCounter:record(first, 42)
+        for i = 1, 200 do
+            PerfCounter:slot("test_grow_" .. i)
+        end
+        expect.equal(PerfCounter:get_stats("test_grow_0").calls, 1)
+        expect.equal(PerfCounter:get_stats("test_grow_0").max, 42 * 1e-9)
+        expect.equal(PerfCounter:get_stats("test_grow_200").calls, 0)
+    end)
+end)
+
+describe("Profiler", function()
+    it("writes folded stacks attributed to the current task", function()
+        local output = string.format("%s/test_perf_counter_%d.folded", tmp_dir, os.time())
+        local curr_task = "task_a"
+        Profiler.start({ output = output, task_name = function() return curr_task end })
+        expect.truthy(Profiler.is_running())
+
+        local deadline = PerfCounter.now_ns() + 100e6
+        while PerfCounter.now_ns() < deadline do
+            curr_task = busy(1000) > 1e9 and "never" or "task_a"
+        end
+        local nr_samples = Profiler.stop()
+        expect.falsy(Profiler.is_running())
+        expect.truthy(nr_samples > 0)
+
+        local total = 0
+        for line in io.lines(output) do
+            local stack, count = line:match("^(.*) (%d+)$")
+            expect.truthy(stack)
+            expect.truthy(stack:find("^task:task_a;"))
+            total = total + tonumber(count)
+        end
+        expect.equal(total, nr_samples)
+        os.remove(output)
+    end)
+end)
@@ -136,11 +136,16 @@ fork {
         -- Verify return type and content
         assert(type(running_tasks) == "table", "get_running_tasks should return a table")
 
-        -- Count running tasks accurately (using pairs since task IDs may not be consecutive)
+        -- Count running tasks accurately (walking the ready list since task IDs may not be consecutive)
         local running_task_count = 0
         ---@diagnostic disable-next-line: access-invisible
-        for _ in pairs(scheduler.task_name_map_running) do
-            running_task_count = running_task_count + 1
+        local ready_next = scheduler.ready_next
+        local ready_task_id = ready_next[0]
+        while ready_task_id ~= 0 do
+            if scheduler:check_task_exists(ready_task_id) then
+                running_task_count = running_task_count + 1
+            end
+            ready_task_id = ready_next[ready_task_id]
         end
 
         -- Count returned tasks
@@ -0,0 +1,67 @@
+-- Startup cost of the nosim backend on top_large.sv: the memory-mapped signal
+-- index against the Lua table DB, each timed as loading the DB plus looking up
+-- every signal. The uncached / cached DB generation is timed by the
+-- `test_signal_db/nosim` case in tests/xmake.lua.
+
+local ffi = require "ffi"
+local SignalDB = require "verilua.utils.SignalDB"
+local vpiml = require "verilua.vpiml.vpiml"
+
+local f = string.format
+
+fork {
+    function()
+        local names = {}
+        for a = 0, 7 do
+            for b = 0, 7 do
+                for c = 0, 7 do
+                    local hier = f("top_large.u%d.u%d.u%d", a, b, c)
+                    for i = 0, 15 do
+                        table.insert(names, hier .. ".r" .. i)
+                        table.insert(names, hier .. ".w" .. i)
+                    end
+                end
+            end
+        end
+
+        assert(vpiml.vpiml_get_top_module() == "top_large")
+        assert(vpiml.vpiml_handle_by_name_safe("top_large.u0.u0.u0.not_exist") == -1)
+
+        -- VpimlNosim opened the index when it was loaded, reopen it to time the load
+        local start = os.clock()
+        assert(ffi.C.nosim_signal_index_open(SignalDB:get_target_file() .. ".idx") == 1)
+        local index_load_time = os.clock() - start
+        assert(vpiml.vpiml_get_top_module() == "top_large")
+
+        start = os.clock()
+        for _, name in ipairs(names) do
+            local handle = vpiml.vpiml_handle_by_name(name)
+            assert(vpiml.vpiml_get_signal_width(handle) == 8)
+        end
+        local index_lookup_time = os.clock() - start
+
+        assert(vpiml.vpiml_get_hdl_type(vpiml.vpiml_handle_by_name("top_large.u7.u7.u7.r15")) == "vpiReg")
+        assert(vpiml.vpiml_get_hdl_type(vpiml.vpiml_handle_by_name("top_large.u7.u7.u7.w15")) == "vpiNet")
+
+        start = os.clock()
+        SignalDB:get_db_data()
+        local table_load_time = os.clock() - start
+
+        start = os.clock()
+        for _, name in ipairs(names) do
+            local signal_info = SignalDB:get_signal_info(name)
+            assert(signal_info and signal_info[2] == 8)
+        end
+        local table_lookup_time = os.clock() - start
+
+        local function report(what, load_time, lookup_time)
+            print(f("[test_nosim] %-14s load: %8.3f ms, lookup: %8.3f ms, total: %8.3f ms", what, load_time * 1000,
+                lookup_time * 1000, (load_time + lookup_time) * 1000))
+        end
+        print(f("[test_nosim] %d signals", #names))
+        report("signal index", index_load_time, index_lookup_time)
+        report("Lua DB", table_load_time, table_lookup_time)
+
+        sim.finish()
+    end
+}
@@ -0,0 +1,79 @@
+// Large hierarchy for the nosim startup benchmark in main_nosim.lua:
+// 8 x 8 x 8 leaves with 16 regs and 16 wires each (16384 signals).
+
+module top_large;
+
+Mid u0();
+Mid u1();
+Mid u2();
+Mid u3();
+Mid u4();
+Mid u5();
+Mid u6();
+Mid u7();
+
+endmodule
+
+module Mid;
+
+Inner u0();
+Inner u1();
+Inner u2();
+Inner u3();
+Inner u4();
+Inner u5();
+Inner u6();
+Inner u7();
+
+endmodule
+
+module Inner;
+
+Leaf u0();
+Leaf u1();
+Leaf u2();
+Leaf u3();
+Leaf u4();
+Leaf u5();
+Leaf u6();
+Leaf u7();
+
+endmodule
+
+module Leaf;
+
+reg [7:0] r0;
+reg [7:0] r1;
+reg [7:0] r2;
+reg [7:0] r3;
+reg [7:0] r4;
+reg [7:0] r5;
+reg [7:0] r6;
+reg [7:0] r7;
+reg [7:0] r8;
+reg [7:0] r9;
+reg [7:0] r10;
+reg [7:0] r11;
+reg [7:0] r12;
+reg [7:0] r13;
+reg [7:0] r14;
+reg [7:0] r15;
+
+wire [7:0] w0 = r0 + 8'd0;
+wire [7:0] w1 = r1 + 8'd1;
+wire [7:0] w2 = r2 + 8'd2;
+wire [7:0] w3 = r3 + 8'd3;
+wire [7:0] w4 = r4 + 8'd4;
+wire [7:0] w5 = r5 + 8'd5;
+wire [7:0] w6 = r6 + 8'd6;
+wire [7:0] w7 = r7 + 8'd7;
+wire [7:0] w8 = r8 + 8'd8;
+wire [7:0] w9 = r9 + 8'd9;
+wire [7:0] w10 = r10 + 8'd10;
+wire [7:0] w11 = r11 + 8'd11;
+wire [7:0] w12 = r12 + 8'd12;
+wire [7:0] w13 = r13 + 8'd13;
+wire [7:0] w14 = r14 + 8'd14;
+wire [7:0] w15 = r15 + 8'd15;
+
+endmodule
@@ -8,3 +8,14 @@ target("test", function()
     set_values("verilua.top", "top")
     set_values("verilua.lua_main", "./main.lua")
 end)
+
+-- nosim startup on a large design, see `test-signal-db` in tests/xmake.lua
+target("test_nosim", function()
+    add_rules("verilua")
+    set_default(false)
+    add_toolchains("@nosim")
+    add_files("./top_large.sv")
+    set_values("verilua.top", "top_large")
+    set_values("verilua.lua_main", "./main_nosim.lua")
+    set_values("verilua.build_dir", path.join(os.scriptdir(), "build", "nosim"))
+end)
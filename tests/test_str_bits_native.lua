@@ -0,0 +1,161 @@
+--- Differential test of the libstr_bits backed StrBitsUtils against its pure-Lua implementations.
+--- Run with: luajit tests/test_str_bits_native.lua (needs $VERILUA_HOME/shared/libstr_bits.so,
+--- built by `xmake build libstr_bits`).
+
+local sbu = require "verilua.utils.StrBitsUtils"
+local lester = require "lester"
+
+local describe, it, expect = lester.describe, lester.it, lester.expect
+local f = string.format
+local random = math.random
+local table_concat = table.concat
+
+if not sbu.init_use_native() then
+    print("[test_str_bits_native] libstr_bits is not available, skipped")
+    return
+end
+
+local L = sbu.lua
+local HEX = "0123456789abcdefABCDEF"
+local WIDTHS = { 1, 3, 4, 8, 13, 31, 32, 33, 63, 64, 65, 100, 127, 128, 129, 255, 256, 1000, 1024, 4095, 4096, 8191, 8192 }
+local ROUNDS = tonumber(os.getenv("STR_BITS_TEST_ROUNDS") or "20")
+
+math.randomseed(tonumber(os.getenv("SEED") or "1234"))
+
+--- Random hex string of `nchars` digits, mixed case, sometimes with leading zeros
+---@param nchars integer
+---@return string
+local function rand_hex(nchars)
+    local t = {}
+    local zeros = random(0, 3) == 0 and random(0, nchars) or 0
+    for i = 1, nchars do
+        if i <= zeros then
+            t[i] = "0"
+        else
+            local k = random(1, #HEX)
+            t[i] = HEX:sub(k, k)
+        end
+    end
+    return table_concat(t)
+end
+
+--- Operand length around `bitwidth`: shorter, exact, longer, or empty
+---@param bitwidth integer
+---@return integer
+local function rand_len(bitwidth)
+    local nchars = math.ceil(bitwidth / 4)
+    local r = random(0, 9)
+    if r == 0 then
+        return 0
+    elseif r <= 3 then
+        return random(1, nchars)
+    elseif r <= 6 then
+        return nchars
+    else
+        return nchars + random(1, 20)
+    end
+end
+
+---@param name string
+---@param ... any
+local function check(name, ...)
+    local args = { ... }
+    local n = select("#", ...)
+    local ok1, r1, c1 = pcall(sbu[name], unpack(args, 1, n))
+    local ok2, r2, c2 = pcall(L[name], unpack(args, 1, n))
+
+    local desc = {}
+    for i = 1, n do
+        desc[i] = tostring(args[i])
+    end
+    local what = f("%s(%s)", name, table_concat(desc, ", "))
+
+    expect.equal(ok1, ok2, what)
+    if ok1 then
+        expect.equal(r1, r2, what)
+        expect.equal(c1, c2, what)
+    end
+end
+
+describe("StrBitsUtils native kernels", function()
+    it("should match the pure-Lua bitwise operations", function()
+        for _, w in ipairs(WIDTHS) do
+            for _ = 1, ROUNDS do
+                local a, b = rand_hex(rand_len(w)), rand_hex(rand_len(w))
+                for _, op in ipairs({ "bor_hex_str", "bxor_hex_str", "band_hex_str" }) do
+                    check(op, a, b)
+                    check(op, a, b, w)
+                end
+                check("bnot_hex_str", a)
+                check("bnot_hex_str", a, w)
+            end
+        end
+    end)
+
+    it("should match the pure-Lua add_hex_str", function()
+        for _, w in ipairs(WIDTHS) do
+            for _ = 1, ROUNDS do
+                local a, b = rand_hex(rand_len(w)), rand_hex(rand_len(w))
+                check("add_hex_str", a, b)
+                check("add_hex_str", a, b, w)
+            end
+            -- Carry out of the full width and out of a partial nibble
+            local ones = string.rep("f", math.ceil(w / 4))
+            check("add_hex_str", ones, "1", w)
+            check("add_hex_str", ones, "0", w)
+            check("add_hex_str", ones, ones)
+        end
+    end)
+
+    it("should match the pure-Lua shifts", function()
+        for _, w in ipairs(WIDTHS) do
+            for _ = 1, ROUNDS do
+                local a = rand_hex(rand_len(w))
+                local n = random(0, 3) == 0 and 0 or random(0, w + 70)
+                check("lshift_hex_str", a, n)
+                check("lshift_hex_str", a, n, w)
+                check("rshift_hex_str", a, n)
+                check("rshift_hex_str", a, n, w)
+            end
+        end
+    end)
+
+    it("should match the pure-Lua bitfield operations", function()
+        for _, w in ipairs(WIDTHS) do
+            for _ = 1, ROUNDS do
+                local a = rand_hex(rand_len(w))
+                local len = math.max(#a * 4, w)
+                local s = random(0, len)
+                local e = random(s, len)
+                check("bitfield_hex_str", a, s, e)
+                check("bitfield_hex_str", a, s, e, w)
+
+                local v = rand_hex(random(0, math.ceil((e - s + 1) / 4) + 2))
+                s = random(0, len - 1)
+                e = random(s, len + 8)
+                check("set_bitfield_hex_str", a, s, e, v)
+                check("set_bitfield_hex_str", a, s, e, v, w)
+
+                check("popcount_hex_str", a)
+            end
+        end
+    end)
+
+    it("should fall back to the pure-Lua implementations for unusual inputs", function()
+        check("bor_hex_str", "12g4", "1")
+        check("bor_hex_str", "1234", "1", "16")
+        check("bnot_hex_str", "ff", 0)
+        check("add_hex_str", "0x12", "1", 8)
+        check("lshift_hex_str", "ABcd", 0)
+        check("lshift_hex_str", "1234", -4)
+        check("rshift_hex_str", "1234", 2.5)
+        check("rshift_hex_str", "12z4", 100)
+        check("bitfield_hex_str", "1234", 4, 20)
+        check("bitfield_hex_str", "1234", 8, 4)
+        check("bitfield_hex_str", "1234", 16, 16)
+        check("set_bitfield_hex_str", "1234", 4, 7, "x")
+        check("set_bitfield_hex_str", "1234", "4", "7", "a")
+        check("set_bitfield_hex_str", "1234", 4, 20, "a", 16)
+        check("popcount_hex_str", "1 2")
+    end)
+end)
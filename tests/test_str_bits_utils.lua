@@ -1639,12 +1639,28 @@ local function run_tests()
     end)
 end -- run_tests
 
--- Run tests without libgmp
+-- Run tests with the pure-Lua implementations
+local native_impls = {}
+for name, lua_impl in pairs(sbu.lua) do
+    native_impls[name] = sbu[name]
+    sbu[name] = lua_impl
+end
 print("\n" .. string.rep("=", 80))
-print("Running tests WITHOUT libgmp...")
+print("Running tests WITHOUT libgmp (pure Lua)...")
 print(string.rep("=", 80))
 run_tests()
 
+-- Run tests with libstr_bits (the default when it is available)
+for name, impl in pairs(native_impls) do
+    sbu[name] = impl
+end
+if sbu.init_use_native() then
+    print("\n" .. string.rep("=", 80))
+    print("Running tests WITHOUT libgmp (libstr_bits)...")
+    print(string.rep("=", 80))
+    run_tests()
+end
+
 -- Run tests with libgmp
 print("\n" .. string.rep("=", 80))
 print("Running tests WITH libgmp...")
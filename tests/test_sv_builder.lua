@@ -1433,4 +1433,65 @@ end]],
         ctx:clean()
         ctx:set_lint(false)
     end)
+
+    it("sv_lint lints batches against preloaded packages", function()
+        ctx:lint_clear_preload()
+        local results = ctx:lint_batch({
+            "module m_ok(input logic a, output logic b); assign b = a; endmodule",
+            "module m_bad(input logic a); assign c = a; endmodule",
+            "module m_syntax(; endmodule",
+        }, { names = { "m_ok.sv", "m_bad.sv", "m_syntax.sv" }, jobs = 2 })
+
+        expect.equal(results[1], nil)
+        assert(results[2] and #results[2] >= 1, "expected diagnostics for m_bad")
+        local d = results[2][1]
+        expect.equal(d.severity, "error")
+        expect.equal(d.line, 1)
+        assert(d.file:find("m_bad.sv", 1, true), "unexpected file: " .. d.file)
+        assert(d.message:find("c", 1, true), "unexpected message: " .. d.message)
+        assert(results[3] and results[3][1].severity == "error", "expected a syntax error for m_syntax")
+
+        ctx:lint_preload("defs_pkg.sv", [[
+            `define WIDTH 8
+            package defs_pkg;
+                typedef logic [`WIDTH-1:0] byte_t;
+            endpackage
+        ]])
+        results = ctx:lint_batch({
+            "module m_pkg import defs_pkg::*; (input byte_t a, output logic [`WIDTH-1:0] b); assign b = a; endmodule",
+            "module m_pkg2(input defs_pkg::byte_t a, output logic b); assign b = a[0]; endmodule",
+        })
+        expect.equal(results[1], nil)
+        expect.equal(results[2], nil)
+
+        -- An error inside a preloaded macro is reported where the text expands it
+        ctx:lint_preload("defs_macros.svh", "`define DRIVE_UNDECLARED(x) assign x = undeclared_sig;")
+        results = ctx:lint_batch({
+            "module m_mac(output logic o);\n`DRIVE_UNDECLARED(o)\nendmodule",
+        }, { names = { "m_mac.sv" } })
+        assert(results[1] and #results[1] >= 1, "expected diagnostics for m_mac")
+        expect.equal(results[1][1].file, "m_mac.sv")
+        expect.equal(results[1][1].line, 2)
+
+        -- Units named like a preload, or like its `#<n>` suffixed repeat, do
+        -- not clash with the preloaded buffers
+        ctx:lint_preload("defs_pkg.sv", "package defs_pkg2; typedef logic [3:0] nib_t; endpackage")
+        results = ctx:lint_batch({
+            "module m_name1(input defs_pkg2::nib_t a); endmodule",
+            "module m_name2(input logic a); assign c = a; endmodule",
+        }, { names = { "defs_pkg.sv", "defs_pkg.sv#1" } })
+        expect.equal(results[1], nil)
+        assert(results[2], "expected diagnostics for m_name2")
+        expect.equal(results[2][1].code, "UndeclaredIdentifier")
+
+        local ok, err = pcall(function()
+            ctx:lint_preload("bad_pkg.sv", "package bad_pkg; typedef undefined_t foo_t; endpackage")
+        end)
+        expect.equal(ok, false)
+        assert(tostring(err):find("[SVBuilder] lint error in preload 'bad_pkg.sv'", 1, true), tostring(err))
+
+        ctx:lint_clear_preload()
+        results = ctx:lint_batch({ "module m_pkg3(input defs_pkg::byte_t a); endmodule" })
+        assert(results[1], "defs_pkg must be gone after lint_clear_preload")
+    end)
 end)
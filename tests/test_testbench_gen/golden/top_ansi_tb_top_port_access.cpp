@@ -0,0 +1,63 @@
+// -----------------------------------------
+// Verilator port access table generated by VERILUA (testbench_gen)
+//
+// Compiled together with the Verilated model. `verilua_port_access_init()`
+// is called by verilator_main.cpp before the simulation starts; it resolves
+// the storage of every packed `tb_top` port (public via --public-flat-rw) and
+// registers it with libverilua, which then serves reads/writes of these
+// ports as direct loads/stores instead of VPI calls. Ports whose storage
+// cannot be found, or is not writable, are left to libverilua's own resolver.
+// -----------------------------------------
+#include "verilated.h"
+#include "verilated_syms.h"
+#include <cstdint>
+
+extern "C" void verilua_register_direct_signal(const char *path, void *datap, uint32_t width);
+
+extern "C" void verilua_port_access_init(void) {
+    const VerilatedScope *scope = Verilated::threadContextp()->scopeFind("TOP.tb_top");
+    if (scope == nullptr) {
+        return;
+    }
+
+    auto bind = [scope](const char *name, const char *path, uint32_t width) {
+        const VerilatedVar *var = scope->varFind(name);
+        if (var != nullptr && var->isPublicRW()) {
+            verilua_register_direct_signal(path, var->datap(), width);
+        }
+    };
+
+    bind("clk", "tb_top.clk", 1); // input wire clk
+    bind("reset", "tb_top.reset", 1); // input wire reset
+    bind("count0", "tb_top.count0", 8); // output reg [7:0] count0
+    bind("count1", "tb_top.count1", 8); // output reg [7:0] count1
+    bind("count2", "tb_top.count2", 11); // output reg [VAL-1:0] count2
+    bind("oo1", "tb_top.oo1", 1); // output reg oo1
+    bind("oo2", "tb_top.oo2", 1); // output reg oo2
+    bind("oo3", "tb_top.oo3", 8); // output reg [7:0] oo3
+    bind("oo4", "tb_top.oo4", 8); // output reg [7:0] oo4
+    bind("oo5", "tb_top.oo5", 1); // output wire oo5
+    bind("o", "tb_top.o", 1); // output logic o
+    bind("o3", "tb_top.o3", 1); // output reg o3
+    bind("o4", "tb_top.o4", 1); // output wire o4
+    bind("o5", "tb_top.o5", 8); // output logic [7:0] o5
+    bind("o6", "tb_top.o6", 8); // output reg [7:0] o6
+    bind("o7", "tb_top.o7", 8); // output wire [7:0] o7
+    bind("ii1", "tb_top.ii1", 1); // input wire ii1
+    bind("ii2", "tb_top.ii2", 1); // input wire ii2
+    bind("ii3", "tb_top.ii3", 1); // input wire ii3
+    bind("ii4", "tb_top.ii4", 8); // input wire [7:0] ii4
+    bind("ii5", "tb_top.ii5", 8); // input wire [7:0] ii5
+    bind("ii6", "tb_top.ii6", 8); // input wire [7:0] ii6
+    bind("ii7", "tb_top.ii7", 1); // input wire ii7
+    bind("i", "tb_top.i", 1); // input logic i
+    bind("i4", "tb_top.i4", 1); // input bit i4
+    bind("i5", "tb_top.i5", 1); // input wire i5
+    bind("i6", "tb_top.i6", 8); // input wire [7:0] i6
+    bind("io_axi_cfg_awregion", "tb_top.io_axi_cfg_awregion", 4); // input wire [3:0] io_axi_cfg_awregion
+    bind("i10", "tb_top.i10", 1); // input bit i10
+    bind("sda", "tb_top.sda", 1); // inout wire sda
+    bind("scl", "tb_top.scl", 1); // inout wire scl
+    bind("bidir_data", "tb_top.bidir_data", 8); // inout wire [7:0] bidir_data
+    bind("bidir_bus", "tb_top.bidir_bus", 16); // inout wire [15:0] bidir_bus
+}
@@ -271,6 +271,70 @@ target("test", function()
             all_passed = false
         end
 
+        -- Extra clock domains: `#` delay generators, step hooks and the Verilator domain table
+        test_count = test_count + 1
+        local clock_domain_build_dir = path.join(build_dir, "clock_domain")
+        local clock_domain_output = path.join(clock_domain_build_dir, "tb_top.sv")
+        local clock_domain_table = path.join(clock_domain_build_dir, "tb_top_clock_domains.cpp")
+
+        print("\n[clock_domain] Running testbench_gen with --clock-domain...")
+        local ok_cd = try { function()
+            os.exec(
+                "testbench_gen %s --out-dir %s --regen --verbose --check-output --clock-signal sys_clk --reset-signal sys_rst_n --clock-domain clk_core:8:2 --clock-domain main_clock:6 --domain-step",
+                clock_variants_rtl, clock_domain_build_dir)
+            return true
+        end }
+        if ok_cd then
+            local results = {
+                compare_snippet(clock_domain_output, [[initial begin // period: 8, phase: 2
+    #2;
+    forever #4 clk_core = ~clk_core;
+end]], "clock_domain_generator_phase"),
+                compare_snippet(clock_domain_output, [[initial begin // period: 6, phase: 0
+    forever #3 main_clock = ~main_clock;
+end]], "clock_domain_generator"),
+                compare_snippet(clock_domain_output, [[always @(posedge main_clock) verilua_domain_step_safe(1, "main_clock");]],
+                    "clock_domain_step"),
+                compare_snippet(clock_domain_table, [[{"clk_core", 8, 2},]], "clock_domain_table"),
+            }
+            local cd_passed = true
+            for _, r in ipairs(results) do
+                cd_passed = cd_passed and r
+            end
+            if cd_passed then
+                pass_count = pass_count + 1
+            else
+                all_passed = false
+            end
+        else
+            print("[clock_domain] FAILED: testbench_gen execution failed")
+            all_passed = false
+        end
+
+        -- Verilator port access side-table: one direct binding per packed port,
+        -- unpacked array ports (o8, o9, o10, i2, i3, i7) are left out
+        test_count = test_count + 1
+        local port_access_build_dir = path.join(build_dir, "port_access")
+        local port_access_output = path.join(port_access_build_dir, "tb_top_port_access.cpp")
+        local port_access_golden = path.join(golden_dir, "top_ansi_tb_top_port_access.cpp")
+
+        print("\n[port_access] Running testbench_gen with --port-access...")
+        local ok_pa = try { function()
+            os.exec("testbench_gen %s --out-dir %s --regen --verbose --check-output --port-access", ansi_rtl,
+                port_access_build_dir)
+            return true
+        end }
+        if ok_pa then
+            if compare_testbench(port_access_output, port_access_golden, "port_access_golden") then
+                pass_count = pass_count + 1
+            else
+                all_passed = false
+            end
+        else
+            print("[port_access] FAILED: testbench_gen execution failed")
+            all_passed = false
+        end
+
         -- Test cfg.tb_gen_flags preserves multiline custom code strings in xmake rule
         test_count = test_count + 1
         local custom_code_build_dir = path.join(build_dir, "custom_code_str")
@@ -350,9 +414,15 @@ target("regen_golden", function()
             clock_variants_rtl, build_dir)
         os.cp(path.join(build_dir, "tb_top.sv"), path.join(golden_dir, "top_clock_variants_tb_top.sv"))
 
+        -- Generate golden for the --port-access side-table of top_ansi.sv
+        print("[port_access] Generating golden file...")
+        os.exec("testbench_gen %s --out-dir %s --regen --check-output --port-access", ansi_rtl, build_dir)
+        os.cp(path.join(build_dir, "tb_top_port_access.cpp"), path.join(golden_dir, "top_ansi_tb_top_port_access.cpp"))
+
         print("\nGolden files regenerated successfully!")
         print("  - " .. path.join(golden_dir, "top_ansi_tb_top.sv"))
         print("  - " .. path.join(golden_dir, "top_non_ansi_tb_top.sv"))
         print("  - " .. path.join(golden_dir, "top_clock_variants_tb_top.sv"))
+        print("  - " .. path.join(golden_dir, "top_ansi_tb_top_port_access.cpp"))
     end)
 end)
@@ -0,0 +1,52 @@
+local TraceSink = require "verilua.utils.TraceSink"
+local TraceReader = require "verilua.utils.TraceReader"
+
+local clock = dut.clock:chdl()
+
+fork {
+    function()
+        local trace_file = "./test_trace_sink.vltr"
+
+        -- Small ring: the producer has to wait for the writer thread and the ring wraps around
+        local sink = TraceSink { file = trace_file, ring_size = 4096 }
+        local req = sink:schema("req", { "addr => u64", "id => u16", "last => u8" })
+        local rsp = sink:schema("rsp", {
+            { name = "data",    type = "u32" },
+            { name = "latency", type = "f64" },
+        })
+
+        local record_num = 20000
+        for i = 1, record_num do
+            req:log(i, 0x100000000ULL + i, i % 65536, i % 2)
+            if i % 4 == 0 then
+                rsp:log(i, i * 3, i / 8)
+            end
+        end
+        clock:posedge()
+        sink:close()
+
+        local req_num, rsp_num = 0, 0
+        TraceReader({ file = trace_file }):foreach(function(schema, stamp, row)
+            if schema == "req" then
+                req_num = req_num + 1
+                assert(stamp == req_num, ("req stamp %s, expected %d"):format(tostring(stamp), req_num))
+                assert(row.addr == 0x100000000ULL + req_num)
+                assert(row.id == req_num % 65536)
+                assert(row.last == req_num % 2)
+            else
+                assert(schema == "rsp")
+                rsp_num = rsp_num + 1
+                local i = rsp_num * 4
+                assert(stamp == i)
+                assert(row.data == i * 3)
+                assert(row.latency == i / 8)
+            end
+        end)
+        assert(req_num == record_num, "req records: " .. req_num)
+        assert(rsp_num == record_num / 4, "rsp records: " .. rsp_num)
+
+        os.remove(trace_file)
+        print("PASS: TraceSink")
+        sim.finish()
+    end,
+}
@@ -0,0 +1,24 @@
+---@diagnostic disable: undefined-field, undefined-global
+
+target("test", function()
+    add_rules("verilua")
+
+    on_config(function(target)
+        local sim = os.getenv("SIM") or "verilator"
+        if sim == "iverilog" then
+            target:set("toolchains", "@iverilog")
+        elseif sim == "vcs" then
+            target:set("toolchains", "@vcs")
+        elseif sim == "xcelium" then
+            target:set("toolchains", "@xcelium")
+        elseif sim == "verilator" then
+            target:set("toolchains", "@verilator")
+        else
+            raise("unknown simulator: %s", sim)
+        end
+    end)
+
+    add_files(path.join(os.scriptdir(), "..", "rtl", "top.sv"))
+    set_values("verilua.top", "top")
+    set_values("verilua.lua_main", "main.lua")
+end)
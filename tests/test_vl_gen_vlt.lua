@@ -0,0 +1,118 @@
+--- Tests of tools/vl-gen-vlt, which turns access profiles (`VL_ACCESS_PROFILE=<file>`)
+--- into the Verilator control file used by `vl-verilator-p --access-profile`.
+--- Run with: luajit tests/test_vl_gen_vlt.lua (needs python3).
+
+local lester = require "lester"
+
+local describe, it, expect = lester.describe, lester.it, lester.expect
+
+local tool = (os.getenv("VERILUA_HOME") or ".") .. "/tools/vl-gen-vlt"
+
+local tmp_dir = os.getenv("TMPDIR") or "/tmp"
+local tmp_id = 0
+
+---@return string
+local function tmp_path(suffix)
+    tmp_id = tmp_id + 1
+    return string.format("%s/test_vl_gen_vlt_%d_%d%s", tmp_dir, os.time(), tmp_id, suffix)
+end
+
+---@param path string
+---@param content string
+local function write_file(path, content)
+    local file = assert(io.open(path, "w"))
+    file:write(content)
+    file:close()
+end
+
+---@return string[]
+local function read_lines(path)
+    local lines = {}
+    for line in io.lines(path) do
+        lines[#lines + 1] = line
+    end
+    return lines
+end
+
+--- Lines of the control file generated from `profiles` with the extra `flags`
+---@param profiles string[]
+---@param flags? string
+---@return string[]
+local function gen_vlt(profiles, flags)
+    local out = tmp_path(".vlt")
+    local cmd = string.format("python3 %s %s -o %s %s > /dev/null 2>&1", tool, table.concat(profiles, " "), out, flags or "")
+    assert(os.execute(cmd) == 0, cmd)
+    local lines = read_lines(out)
+    os.remove(out)
+    return lines
+end
+
+-- Recorded paths with and without a module, a select, a top-level signal, an
+-- unresolved path and a malformed one
+local profile_a = [[
+# verilua access profile
+tb_top.clock	tb_top
+tb_top.u_core.valid	Core
+tb_top.u_core.mem[3]	Core
+tb_top.u_core.u_alu.result
+?tb_top.u_core.debug
+bogus
+]]
+
+-- A second run of the same testbench, merged with the first
+local profile_b = [[
+tb_top.u_core.ready	Core
+tb_top.u_core.mem[7]	Core
+tb_top.u_core.u_alu.result	Alu
+]]
+
+describe("vl-gen-vlt", function()
+    local has_python = os.execute("python3 --version > /dev/null 2>&1") == 0
+    if not has_python then
+        print("[test_vl_gen_vlt] python3 is not available, skipped")
+        return
+    end
+
+    local prof_a, prof_b = tmp_path(".prof"), tmp_path(".prof")
+    write_file(prof_a, profile_a)
+    write_file(prof_b, profile_b)
+
+    it("should make public only the recorded signals", function()
+        expect.equal(gen_vlt({ prof_a }), {
+            "`verilator_config",
+            "// Generated by vl-gen-vlt, do not edit",
+            "// profile: " .. prof_a,
+            "",
+            'public_flat_rw -module "Core" -var "mem"',
+            'public_flat_rw -module "Core" -var "valid"',
+            'public_flat_rw -module "tb_top" -var "clock"',
+            'public_flat_rw -module "*" -var "result"',
+            "// not found when recorded: tb_top.u_core.debug",
+        })
+    end)
+
+    it("should merge profiles and name every one for the unknown signal hint", function()
+        -- libverilua reads the `// profile: ` lines back to explain a signal missing from the model
+        expect.equal(gen_vlt({ prof_a, prof_b }, "--rd --include-unresolved"), {
+            "`verilator_config",
+            "// Generated by vl-gen-vlt, do not edit",
+            "// profile: " .. prof_a,
+            "// profile: " .. prof_b,
+            "",
+            'public_flat_rd -module "Alu" -var "result"',
+            'public_flat_rd -module "Core" -var "mem"',
+            'public_flat_rd -module "Core" -var "ready"',
+            'public_flat_rd -module "Core" -var "valid"',
+            'public_flat_rd -module "tb_top" -var "clock"',
+            'public_flat_rd -module "*" -var "debug"',
+        })
+    end)
+
+    it("should fail on a missing profile", function()
+        local cmd = string.format("python3 %s %s -o %s > /dev/null 2>&1", tool, tmp_path(".prof"), tmp_path(".vlt"))
+        expect.truthy(os.execute(cmd) ~= 0)
+    end)
+
+    os.remove(prof_a)
+    os.remove(prof_b)
+end)
@@ -102,5 +102,17 @@ target("run_test", function()
                 os.exec("xmake r -P . sim_wave")
             end
         end
+
+        -- Same cases with the wellen backend loading signals on first access
+        -- (lazy_signals.rs); the 1 MiB budget keeps the eviction path enabled.
+        os.setenv("WTYPE", "fst")
+        os.setenv("WAVE_VPI_LAZY_LOAD", "1")
+        os.setenv("WAVE_VPI_LAZY_MEM_BUDGET_MB", "1")
+        os.exec("xmake b -P . sim_wave")
+        for _, tc in ipairs(test_cases) do
+            os.setenv("TC_NAME", tc)
+            os.exec("xmake r -P . sim_wave")
+        end
+        os.setenv("WAVE_VPI_LAZY_LOAD", "0")
     end)
 end)
@@ -0,0 +1,80 @@
+local ffi = require "ffi"
+
+ffi.cdef [[
+    void *vpi_handle_by_name(char *name, void *scope);
+    void *vpi_handle_by_index(void *object, int indx);
+    char *vpi_get_str(int property, void *object);
+]]
+
+local C = ffi.C
+local vpiFullName = 3
+
+-- Signal and module handles of wave_vpi are interned, the same object is always the same pointer
+local function by_name(name, scope)
+    return C.vpi_handle_by_name(ffi.cast("char *", name), scope)
+end
+
+local function same(a, b)
+    return a ~= nil and b ~= nil and ffi.cast("uintptr_t", a) == ffi.cast("uintptr_t", b)
+end
+
+local function full_name(hdl)
+    return ffi.string(C.vpi_get_str(vpiFullName, hdl))
+end
+
+-- Scopes are not tracked in stream mode (WAVE_VPI_STREAM=1), only the signal lookups run there
+local stream_mode = os.getenv("WAVE_VPI_STREAM") == "1"
+
+local clock = dut.clock:chdl()
+
+fork {
+    function()
+        local bus = by_name("tb_top.u_top.bus")
+        assert(bus ~= nil, "tb_top.u_top.bus not found")
+        assert(same(bus, by_name("tb_top.u_top.bus")), "repeated lookups must return the same handle")
+        assert(full_name(bus) == "tb_top.u_top.bus", "unexpected vpiFullName: " .. full_name(bus))
+        assert(by_name("tb_top.u_top.missing") == nil, "a missing signal must resolve to NULL")
+
+        -- `vpi_handle_by_index` resolves `<full name>[idx]`, the bit-blasted `bus [3]` / `bus [0]` vars
+        local bus_3 = C.vpi_handle_by_index(bus, 3)
+        assert(bus_3 ~= nil, "tb_top.u_top.bus[3] not found by index")
+        assert(same(bus_3, by_name("tb_top.u_top.bus[3]")), "by index and by name must share one handle")
+        assert(full_name(bus_3) == "tb_top.u_top.bus[3]", "unexpected vpiFullName: " .. full_name(bus_3))
+        assert(same(C.vpi_handle_by_index(bus, 0), by_name("tb_top.u_top.bus[0]")))
+        assert(C.vpi_handle_by_index(bus, 2) == nil, "bus[2] is not dumped")
+
+        if not stream_mode then
+            local u_top = by_name("tb_top.u_top")
+            assert(u_top ~= nil, "scope tb_top.u_top not found")
+            assert(same(u_top, by_name("tb_top.u_top")), "module handles must be stable")
+            assert(full_name(u_top) == "tb_top.u_top", "unexpected vpiFullName: " .. full_name(u_top))
+
+            -- Scope-relative lookups resolve to the handles of the full names
+            assert(same(by_name("bus", u_top), bus), "scoped lookup of bus")
+            assert(same(by_name("bus[3]", u_top), bus_3), "scoped lookup of bus[3]")
+            local u_core = by_name("u_core", u_top)
+            assert(same(u_core, by_name("tb_top.u_top.u_core")), "scoped lookup of a sub-scope")
+            local data = by_name("tb_top.u_top.u_core.data")
+            assert(data ~= nil, "tb_top.u_top.u_core.data not found")
+            assert(same(by_name("data", u_core), data), "scoped lookup from a sub-scope")
+            assert(same(by_name("u_core.data", u_top), data), "scoped lookup of a dotted path")
+            assert(same(by_name("u_top.u_core.data", by_name("tb_top")), data), "scoped lookup from the root")
+            assert(by_name("missing", u_top) == nil, "a missing scoped name must resolve to NULL")
+        end
+
+        -- The element handles read the bits of the vector
+        local bus_chdl = dut.u_top.bus:chdl()
+        local bus_3_chdl = ("tb_top.u_top.bus[3]"):chdl()
+        local bus_0_chdl = ("tb_top.u_top.bus[0]"):chdl()
+        for _ = 1, 8 do
+            clock:posedge()
+            local value = bus_chdl:get()
+            assert(bus_3_chdl:get() == bit.band(bit.rshift(value, 3), 1), "bus[3] does not match bus")
+            assert(bus_0_chdl:get() == bit.band(value, 1), "bus[0] does not match bus")
+        end
+        dut.u_top.bus:expect(15)
+
+        print("[test_wave_vpi_handle] PASS")
+        sim.finish()
+    end
+}
@@ -0,0 +1,32 @@
+---@diagnostic disable: undefined-global, undefined-field
+
+target("sim_wave", function()
+    set_default(false)
+    add_rules("verilua")
+    add_toolchains("@wave_vpi")
+
+    -- Hand-written VCD: a vector dumped together with some of its bits (`bus [3:0]`, `bus [3]`, `bus [0]`)
+    -- and a nested scope, enough to cover scoped, indexed and repeated handle lookups
+    add_files("./handle.vcd")
+
+    set_values("verilua.top", "tb_top")
+    set_values("verilua.lua_main", "main.lua")
+end)
+
+target("run_test", function()
+    set_default(true)
+    set_kind("phony")
+
+    on_build(function()
+    end)
+
+    on_run(function()
+        os.exec("xmake b -P . sim_wave")
+        os.exec("xmake r -P . sim_wave")
+
+        -- Signal lookups through the forward-only VCD reader
+        os.setenv("WAVE_VPI_STREAM", "1")
+        os.exec("xmake r -P . sim_wave")
+        os.setenv("WAVE_VPI_STREAM", "0")
+    end)
+end)
@@ -1,4 +1,5 @@
 local clock = dut.clock:chdl()
+local data_a = dut.data_a:chdl()
 local data_b = dut.data_b:chdl()
 local data_wide = dut.data_wide:chdl()
 
@@ -70,6 +71,37 @@ fork {
             string.format("Expected no X-state in data_wide bin_str after reset deassert, got: %s", bin_wide)
         )
 
+        -- cbAfterDelay: `await_time` resumes on the step at the target time. Stream mode
+        -- (WAVE_VPI_STREAM=1) keys these callbacks by time instead of by step index.
+        local t0 = sim.get_sim_time()
+        clock:posedge()
+        local period = sim.get_sim_time() - t0
+        assert(period > 0, string.format("Expected the clock period to be positive, got: %d", period))
+        local data_a_value = tonumber(data_a:get_hex_str(), 16)
+
+        await_time(period)
+        assert(
+            sim.get_sim_time() == t0 + 2 * period,
+            string.format("Expected await_time to resume at %d, got: %d", t0 + 2 * period, sim.get_sim_time())
+        )
+        local data_a_next = tonumber(data_a:get_hex_str(), 16)
+        assert(
+            data_a_next == (data_a_value + 1) % 256,
+            string.format("Expected data_a %x one period later, got: %x", (data_a_value + 1) % 256, data_a_next)
+        )
+
+        -- The clock toggles every half period, data_a only changes on posedge
+        await_time(period / 2)
+        assert(
+            sim.get_sim_time() == t0 + 2 * period + period / 2,
+            string.format("Expected await_time to resume at the negedge, got: %d", sim.get_sim_time())
+        )
+        assert(clock:get() == 0, "Expected clock to be 0 at the negedge")
+        assert(
+            tonumber(data_a:get_hex_str(), 16) == data_a_next,
+            string.format("Expected data_a to hold %x until the next posedge", data_a_next)
+        )
+
         print("All X-state tests passed!")
         sim.finish()
     end
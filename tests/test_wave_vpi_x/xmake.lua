@@ -76,6 +76,11 @@ target("run_test", function()
         os.exec("xmake b -P . sim_wave")
         os.exec("xmake r -P . sim_wave")
 
+        -- Same VCD read forward-only by the stream reader (wellen_impl/src/vcd_stream.rs)
+        os.setenv("WAVE_VPI_STREAM", "1")
+        os.exec("xmake r -P . sim_wave")
+        os.setenv("WAVE_VPI_STREAM", "0")
+
         -- Generate FSDB wave using VCS (if available)
         import("lib.detect.find_file")
         if find_file("vcs", { "$(env PATH)" }) then
@@ -257,6 +257,8 @@ local sim_test_cases = {
     -- Entire case is force/release coalesce; needs Verilator >= 5.050 + forceable
     { dir = "test_force_release_coalesce", name = "test_force_release_coalesce", min_verilator_version = 5.050 },
     { dir = "test_native_clock", name = "test_native_clock" },
+    { dir = "test_clock_domain", name = "test_clock_domain" },
+    { dir = "test_trace_sink", name = "test_trace_sink" },
     { dir = "test_queue_waitable", name = "test_queue_waitable" },
     { dir = "test_dpic", name = "test_dpic" },
     { dir = "test_rw_reflush_panic", name = "test_rw_reflush_panic" },
@@ -343,6 +345,20 @@ add_group_target("test-readonly-write-error", function(ctx)
     end
 end)
 
+-- Verilator only: direct access must not store into `public_flat_rd` signals
+add_group_target("test-direct-access-readonly", function(ctx)
+    if not ctx.has_verilator then
+        return
+    end
+
+    local cwd = path.join(ctx.tests_dir, "test_direct_access_readonly")
+    ctx.run_case(join_case_parts("test_direct_access_readonly", "verilator"), function()
+        ctx.clean(path.join(cwd, "build"))
+        ctx.run_cmd(cwd, "xmake build -v -P .", { SIM = "verilator" })
+        ctx.run_cmd(cwd, "xmake run -v -P .", { SIM = "verilator" })
+    end)
+end)
+
 add_group_target("test-post-init-script", function(ctx)
     local cwd = path.join(ctx.tests_dir, "test_post_init_script")
 
@@ -382,6 +398,7 @@ for _, dir in ipairs({
     "test_wave_vpi_x",
     "test_wave_vpi_print_hier",
     "test_wave_vpi_module_name",
+    "test_wave_vpi_handle",
 }) do
     add_group_target(dir:gsub("_", "-"), function(ctx)
         ctx.run_case(dir, function()
@@ -536,14 +553,56 @@ add_group_target("test-cov-exporter-dynamic", function(ctx)
         ctx.run_cmd(cwd, "xmake build -P .")
         ctx.run_cmd(cwd, "xmake run -P .")
     end)
+
+    ctx.run_case("test_cov_exporter_dynamic/packed_toggle", function()
+        local cwd = path.join(ctx.tests_dir, "test_cov_exporter_dynamic")
+        ctx.run_cmd(cwd, "xmake build -P . test_packed_toggle")
+        ctx.run_cmd(cwd, "xmake run -P . test_packed_toggle")
+    end)
 end)
 
 add_group_target("test-signal-db", function(ctx)
+    local cwd = path.join(ctx.tests_dir, "test_signal_db")
     ctx.run_case("test_signal_db", function()
-        local cwd = path.join(ctx.tests_dir, "test_signal_db")
         ctx.run_cmd(cwd, "xmake build -P .")
         ctx.run_cmd(cwd, "xmake run -P .")
     end)
+
+    -- A run without a signal DB generates it with slang, the next one reuses it
+    -- through the content hash check without creating a slang driver. Both
+    -- startups are timed the same way, as a whole `xmake run`.
+    ctx.run_case("test_signal_db/nosim", function()
+        local build_dir = path.join(cwd, "build", "nosim")
+        ctx.clean(build_dir)
+        ctx.run_cmd(cwd, "xmake build -P . test_nosim")
+
+        ---@return string output, integer elapsed_ms
+        local function timed_run(name)
+            local run_log = path.join(build_dir, name .. ".log")
+            local start = os.mclock()
+            local ok = ctx.run_cmd(cwd, "xmake run -P . test_nosim > " .. run_log .. " 2>&1", nil, { allow_fail = true })
+            local elapsed_ms = os.mclock() - start
+            local output = io.readfile(run_log) or ""
+            io.write(output)
+            assert(ok, "[test_signal_db/nosim] xmake run failed (" .. name .. ")")
+            return output, elapsed_ms
+        end
+
+        -- Dropping the meta file invalidates the DB generated by the build
+        for _, meta in ipairs(os.files(path.join(build_dir, "**", "signal_db_gen.meta.json"))) do
+            os.rm(meta)
+        end
+        local uncached_output, uncached_ms = timed_run("run_uncached")
+        assert(not uncached_output:find("[signal_db_gen] up to date (content hashes match)", 1, true),
+            "[test_signal_db/nosim] the uncached run reused a stale signal DB")
+
+        local cached_output, cached_ms = timed_run("run_cached")
+        assert(cached_output:find("[signal_db_gen] up to date (content hashes match)", 1, true),
+            "[test_signal_db/nosim] the cached run did not reuse the signal DB")
+
+        print(string.format("[test_signal_db/nosim] startup uncached: %d ms, cached: %d ms, delta: %d ms",
+            uncached_ms, cached_ms, uncached_ms - cached_ms))
+    end)
 end)
 
 add_group_target("test-slang-common", function(ctx)
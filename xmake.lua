@@ -11,6 +11,9 @@ includes(path.join(prj_dir, "src", "testbench_gen", "xmake.lua"))
 includes(path.join(prj_dir, "src", "wave_vpi", "xmake.lua"))
 includes(path.join(prj_dir, "src", "nosim", "xmake.lua"))
 includes(path.join(prj_dir, "src", "sv_lint", "xmake.lua"))
+includes(path.join(prj_dir, "src", "str_bits", "xmake.lua"))
+includes(path.join(prj_dir, "src", "cov_bins", "xmake.lua"))
+includes(path.join(prj_dir, "src", "log_sink", "xmake.lua"))
 includes(path.join(prj_dir, "src", "turso_ffi", "xmake.lua"))
 
 local CC = os.getenv("CC")
@@ -264,7 +267,9 @@ target("build_all_tools", function()
             "signal_db_gen",
             "sv_lint",
             "wave_vpi_main",
-            "nosim"
+            "nosim",
+            "cov_merge",
+            "log_decode"
         }
         for _, target in ipairs(tools_target) do
             os.exec("xmake build -P %s -y -v %s", prj_dir, target)
@@ -476,6 +481,9 @@ target("setup_verilua", function()
         os.exec("xmake run -P %s -y -v build_libverilua", prj_dir)
         os.exec("xmake build -P %s -y -v libsignal_db_gen", prj_dir)
         os.exec("xmake build -P %s -y -v libsv_lint", prj_dir)
+        os.exec("xmake build -P %s -y -v libstr_bits", prj_dir)
+        os.exec("xmake build -P %s -y -v libcov_bins", prj_dir)
+        os.exec("xmake build -P %s -y -v liblog_sink", prj_dir)
         os.exec("xmake build -P %s -y -v turso_ffi", prj_dir)
         os.exec("xmake run -P %s -y -v build_all_tools", prj_dir)
 
@@ -988,6 +996,7 @@ target("test", function()
             "test-rw-flush",
             "test-rw-reflush-panic",
             "test-readonly-write-error",
+            "test-direct-access-readonly",
             "test-comb-1",
             "test-bitvec-signal",
             "test-no-internal-clock",
@@ -1001,6 +1010,7 @@ target("test", function()
             "test-wave-vpi-x",
             "test-wave-vpi-print-hier",
             "test-wave-vpi-module-name",
+            "test-wave-vpi-handle",
             -- Benchmarks
             "test-benchmarks",
             "test-benchmarks-wave-vpi",